@@ -25,6 +25,7 @@
 
 #include <unistd.h>
 #include <stdint.h>
+#include <sys/uio.h>
 #include <vector>
 #include <map>
 #include <string>
@@ -111,6 +112,8 @@ const char* ErrorNum2ErrorName(LIBCURVE_ERROR err);
 typedef enum LIBCURVE_OP {
     LIBCURVE_OP_READ,
     LIBCURVE_OP_WRITE,
+    LIBCURVE_OP_FLUSH,
+    LIBCURVE_OP_DISCARD,
     LIBCURVE_OP_MAX,
 } LIBCURVE_OP;
 
@@ -231,6 +234,48 @@ int AioRead(int fd, CurveAioContext* aioctx);
  */
 int AioWrite(int fd, CurveAioContext* aioctx);
 
+/**
+ * 异步模式读，读到的数据按顺序填充到iov的各段buffer中，无需先读到连续的buffer
+ * @param: fd为当前open返回的文件描述符
+ * @param: aioctx为异步读写的io上下文，保存基本的io信息，不使用其中的buf
+ * @param: iov为用户的buffer数组，各段长度之和需要等于aioctx中的length，
+ *         回调之前需要保证各段buffer有效，数组本身在调用返回后即可释放
+ * @param: iovcnt为iov数组的长度
+ * @return: 成功返回 0,否则-LIBCURVE_ERROR::FAILED等
+ */
+int AioReadv(int fd, CurveAioContext* aioctx,
+             const struct iovec* iov, int iovcnt);
+
+/**
+ * 异步模式写，iov中的各段buffer直接作为rpc的数据发送，无需先拷贝到连续的buffer
+ * @param: fd为当前open返回的文件描述符
+ * @param: aioctx为异步读写的io上下文，保存基本的io信息，不使用其中的buf
+ * @param: iov为用户的buffer数组，各段长度之和需要等于aioctx中的length，
+ *         回调之前需要保证各段buffer有效，数组本身在调用返回后即可释放
+ * @param: iovcnt为iov数组的长度
+ * @return: 成功返回 0,否则-LIBCURVE_ERROR::FAILED等
+ */
+int AioWritev(int fd, CurveAioContext* aioctx,
+              const struct iovec* iov, int iovcnt);
+
+/**
+ * 异步模式flush，在此之前返回的写请求全部持久化到chunkserver后回调
+ * 未开启写缓存时写请求返回即已持久化，flush直接回调
+ * @param: fd为当前open返回的文件描述符
+ * @param: aioctx为异步io上下文，只使用其中的op和cb
+ * @return: 成功返回 0,否则-LIBCURVE_ERROR::FAILED
+ */
+int AioFlush(int fd, CurveAioContext* aioctx);
+
+/**
+ * 异步模式discard，被完全覆盖的chunk会被删除，再读时返回全0
+ * 未开启discard时直接回调，被快照或克隆使用的数据会保留
+ * @param: fd为当前open返回的文件描述符
+ * @param: aioctx为异步io上下文，保存discard的offset和length
+ * @return: 成功返回 0,否则-LIBCURVE_ERROR::FAILED
+ */
+int AioDiscard(int fd, CurveAioContext* aioctx);
+
 /**
  * 重命名文件
  * @param: userinfo是用户信息
@@ -375,6 +420,10 @@ int GetClusterId(char* buf, int len);
 }
 #endif
 
+namespace butil {
+class IOBuf;
+}  // namespace butil
+
 namespace curve {
 namespace client {
 
@@ -465,6 +514,27 @@ class CurveClient {
      */
     virtual int AioRead(int fd, CurveAioContext* aioctx);
 
+    /**
+     * 异步读，数据以IOBuf的形式返回，直接引用rpc返回的数据，不拷贝到用户buffer
+     * @param fd 文件fd
+     * @param aioctx 异步读写的io上下文，不使用其中的buf
+     * @param data 读到的数据，回调时读成功的数据已追加到其中
+     * @return 返回错误码
+     */
+    virtual int AioReadIOBuf(int fd, CurveAioContext* aioctx,
+                             butil::IOBuf* data);
+
+    /**
+     * 异步读，读到的数据按顺序填充到iov的各段buffer中
+     * @param fd 文件fd
+     * @param aioctx 异步读写的io上下文，不使用其中的buf
+     * @param iov 用户的buffer数组，各段长度之和需要等于aioctx中的length
+     * @param iovcnt iov数组的长度
+     * @return 返回错误码
+     */
+    virtual int AioReadv(int fd, CurveAioContext* aioctx,
+                         const struct iovec* iov, int iovcnt);
+
     /**
      * 异步写
      * @param fd 文件fd
@@ -473,6 +543,40 @@ class CurveClient {
      */
     virtual int AioWrite(int fd, CurveAioContext* aioctx);
 
+    /**
+     * 异步写，iov中的各段buffer直接作为rpc的数据发送，不拷贝
+     * @param fd 文件fd
+     * @param aioctx 异步读写的io上下文，不使用其中的buf
+     * @param iov 用户的buffer数组，各段长度之和需要等于aioctx中的length
+     * @param iovcnt iov数组的长度
+     * @return 返回错误码
+     */
+    virtual int AioWritev(int fd, CurveAioContext* aioctx,
+                          const struct iovec* iov, int iovcnt);
+
+    /**
+     * 异步flush
+     * @param fd 文件fd
+     * @param aioctx 异步io上下文
+     * @return 返回错误码
+     */
+    virtual int AioFlush(int fd, CurveAioContext* aioctx);
+
+    /**
+     * 异步discard
+     * @param fd 文件fd
+     * @param aioctx 异步io上下文
+     * @return 返回错误码
+     */
+    virtual int AioDiscard(int fd, CurveAioContext* aioctx);
+
+    /**
+     * 清空文件的client读缓存
+     * @param fd 文件fd
+     * @return 返回错误码
+     */
+    virtual int InvalidCache(int fd);
+
     /**
      * 测试使用，设置fileclient
      * @param client 需要设置的fileclient
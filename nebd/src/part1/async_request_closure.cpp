@@ -54,8 +54,7 @@ void AsyncRequestClosure::Run() {
 
             // 读请求复制数据
             if (aioCtx->op == LIBAIO_OP::LIBAIO_OP_READ) {
-                cntl.response_attachment().copy_to(
-                    aioCtx->buf, cntl.response_attachment().size());
+                CopyReadData();
             }
 
             aioCtx->ret = 0;
@@ -89,13 +88,35 @@ int64_t AsyncRequestClosure::GetRpcRetryIntervalUs(int64_t retryCount) const {
                  requestOption_.rpcRetryMaxIntervalUs));
 }
 
+void AsyncRequestClosure::CopyReadData() {
+    butil::IOBuf& data = cntl.response_attachment();
+    if (iov.empty()) {
+        data.copy_to(aioCtx->buf, data.size());
+        return;
+    }
+
+    for (const iovec& vec : iov) {
+        data.cutn(vec.iov_base, vec.iov_len);
+    }
+}
+
 void AsyncRequestClosure::Retry() const {
     switch (aioCtx->op) {
         case LIBAIO_OP::LIBAIO_OP_WRITE:
-            nebdClient.AioWrite(fd, aioCtx);
+            if (iov.empty()) {
+                nebdClient.AioWrite(fd, aioCtx);
+            } else {
+                nebdClient.AioWritev(fd, aioCtx, iov.data(),
+                                     static_cast<int>(iov.size()));
+            }
             break;
         case LIBAIO_OP::LIBAIO_OP_READ:
-            nebdClient.AioRead(fd, aioCtx);
+            if (iov.empty()) {
+                nebdClient.AioRead(fd, aioCtx);
+            } else {
+                nebdClient.AioReadv(fd, aioCtx, iov.data(),
+                                    static_cast<int>(iov.size()));
+            }
             break;
         case LIBAIO_OP::LIBAIO_OP_FLUSH:
             nebdClient.Flush(fd, aioCtx);
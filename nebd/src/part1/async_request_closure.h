@@ -24,6 +24,9 @@
 #define NEBD_SRC_PART1_ASYNC_REQUEST_CLOSURE_H_
 
 #include <brpc/controller.h>
+#include <sys/uio.h>
+
+#include <vector>
 
 #include "nebd/src/part1/nebd_client.h"
 #include "nebd/src/part1/nebd_common.h"
@@ -47,6 +50,11 @@ struct AsyncRequestClosure : public google::protobuf::Closure {
 
     void Retry() const;
 
+    /**
+     * 读请求成功时把返回的数据拷贝到用户的buf或者iov中
+     */
+    void CopyReadData();
+
     // 请求fd
     int fd;
 
@@ -57,6 +65,9 @@ struct AsyncRequestClosure : public google::protobuf::Closure {
     brpc::Controller cntl;
 
     RequestOption requestOption_;
+
+    // 读写请求的数据来自iov时保存用户的buffer数组，为空时使用aioCtx中的buf
+    std::vector<iovec> iov;
 };
 
 struct AioWriteClosure : public AsyncRequestClosure {
@@ -82,6 +82,16 @@ int nebd_lib_aio_pwrite(int fd, NebdClientAioContext* context) {
     return AioWrite4Nebd(fd, context);
 }
 
+int nebd_lib_aio_preadv(int fd, NebdClientAioContext* context,
+                        const struct iovec* iov, int iovcnt) {
+    return AioReadv4Nebd(fd, context, iov, iovcnt);
+}
+
+int nebd_lib_aio_pwritev(int fd, NebdClientAioContext* context,
+                         const struct iovec* iov, int iovcnt) {
+    return AioWritev4Nebd(fd, context, iov, iovcnt);
+}
+
 int nebd_lib_sync(int fd) {
     return 0;
 }
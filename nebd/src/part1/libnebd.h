@@ -35,6 +35,7 @@ extern "C" {
 #include <fcntl.h>
 #include <unistd.h>
 #include <aio.h>
+#include <sys/uio.h>
 
 // 文件路径最大的长度，单位字节
 #define NEBD_MAX_FILE_PATH_LEN   1024
@@ -135,6 +136,30 @@ int nebd_lib_aio_pread(int fd, NebdClientAioContext* context);
  */
 int nebd_lib_aio_pwrite(int fd, NebdClientAioContext* context);
 
+/**
+ *  @brief 读文件，读到的数据按顺序填充到iov的各段buffer中，异步函数
+ *  @param fd：文件的fd
+ *         context：异步请求的上下文，不使用其中的buf，
+ *                  length需要等于iov各段长度之和
+ *         iov：存放读取data的buffer数组，回调之前需要保证各段buffer有效
+ *         iovcnt：iov数组的长度
+ *  @return 成功返回0，失败返回错误码
+ */
+int nebd_lib_aio_preadv(int fd, NebdClientAioContext* context,
+                        const struct iovec* iov, int iovcnt);
+
+/**
+ *  @brief 写文件，iov的各段buffer直接作为rpc的数据发送，异步函数
+ *  @param fd：文件的fd
+ *         context：异步请求的上下文，不使用其中的buf，
+ *                  length需要等于iov各段长度之和
+ *         iov：存放写入data的buffer数组，回调之前需要保证各段buffer有效
+ *         iovcnt：iov数组的长度
+ *  @return 成功返回0，失败返回错误码
+ */
+int nebd_lib_aio_pwritev(int fd, NebdClientAioContext* context,
+                         const struct iovec* iov, int iovcnt);
+
 /**
  *  @brief sync文件
  *  @param fd：文件的fd
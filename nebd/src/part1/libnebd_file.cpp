@@ -63,6 +63,16 @@ int AioWrite4Nebd(int fd, NebdClientAioContext* aioctx) {
     return nebd::client::nebdClient.AioWrite(fd, aioctx);
 }
 
+int AioReadv4Nebd(int fd, NebdClientAioContext* aioctx,
+                  const struct iovec* iov, int iovcnt) {
+    return nebd::client::nebdClient.AioReadv(fd, aioctx, iov, iovcnt);
+}
+
+int AioWritev4Nebd(int fd, NebdClientAioContext* aioctx,
+                   const struct iovec* iov, int iovcnt) {
+    return nebd::client::nebdClient.AioWritev(fd, aioctx, iov, iovcnt);
+}
+
 int Flush4Nebd(int fd, NebdClientAioContext* aioctx) {
     return nebd::client::nebdClient.Flush(fd, aioctx);
 }
@@ -83,6 +83,26 @@ int AioRead4Nebd(int fd, NebdClientAioContext* aioctx);
  *  @return 成功返回0，失败返回错误码
  */
 int AioWrite4Nebd(int fd, NebdClientAioContext* aioctx);
+/**
+ *  @brief 读文件，读到的数据按顺序填充到iov的各段buffer中，异步函数
+ *  @param fd：文件的fd
+ *         context：异步请求的上下文，包含请求所需的信息以及回调
+ *         iov：存放读取data的buffer数组
+ *         iovcnt：iov数组的长度
+ *  @return 成功返回0，失败返回错误码
+ */
+int AioReadv4Nebd(int fd, NebdClientAioContext* aioctx,
+                  const struct iovec* iov, int iovcnt);
+/**
+ *  @brief 写文件，写入iov各段buffer拼接而成的数据，异步函数
+ *  @param fd：文件的fd
+ *         context：异步请求的上下文，包含请求所需的信息以及回调
+ *         iov：存放写入data的buffer数组
+ *         iovcnt：iov数组的长度
+ *  @return 成功返回0，失败返回错误码
+ */
+int AioWritev4Nebd(int fd, NebdClientAioContext* aioctx,
+                   const struct iovec* iov, int iovcnt);
 /**
  *  @brief flush文件，异步函数
  *  @param fd：文件的fd
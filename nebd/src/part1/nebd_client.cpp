@@ -30,6 +30,8 @@
 #include <gflags/gflags.h>
 #include <bthread/bthread.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "nebd/src/part1/async_request_closure.h"
 #include "nebd/src/common/configuration.h"
@@ -340,6 +342,58 @@ int NebdClient::AioWrite(int fd, NebdClientAioContext* aioctx) {
     return 0;
 }
 
+int NebdClient::AioReadv(int fd, NebdClientAioContext* aioctx,
+                         const struct iovec* iov, int iovcnt) {
+    std::vector<iovec> vecs;
+    if (!CheckIovec(iov, iovcnt, aioctx->length, &vecs)) {
+        return -1;
+    }
+
+    nebd::client::NebdFileService_Stub stub(&channel_);
+    nebd::client::ReadRequest request;
+    request.set_fd(fd);
+    request.set_offset(aioctx->offset);
+    request.set_size(aioctx->length);
+
+    AioReadClosure* done = new(std::nothrow) AioReadClosure(
+        fd, aioctx, option_.requestOption);
+    // 返回时把读到的数据依次拷贝到各段buffer中
+    done->iov = std::move(vecs);
+    done->cntl.set_timeout_ms(-1);
+    done->cntl.set_log_id(logId_.fetch_add(1, std::memory_order_relaxed));
+    stub.Read(&done->cntl, &request, &done->response, done);
+    return 0;
+}
+
+int NebdClient::AioWritev(int fd, NebdClientAioContext* aioctx,
+                          const struct iovec* iov, int iovcnt) {
+    std::vector<iovec> vecs;
+    if (!CheckIovec(iov, iovcnt, aioctx->length, &vecs)) {
+        return -1;
+    }
+
+    nebd::client::NebdFileService_Stub stub(&channel_);
+    nebd::client::WriteRequest request;
+    request.set_fd(fd);
+    request.set_offset(aioctx->offset);
+    request.set_size(aioctx->length);
+
+    AioWriteClosure* done = new(std::nothrow) AioWriteClosure(
+        fd, aioctx, option_.requestOption);
+
+    done->cntl.set_timeout_ms(-1);
+    done->cntl.set_log_id(logId_.fetch_add(1, std::memory_order_relaxed));
+    // 各段buffer以引用的形式放入attachment，不拼接成连续的buffer
+    for (const iovec& vec : vecs) {
+        done->cntl.request_attachment().append_user_data(
+            vec.iov_base, vec.iov_len, EmptyDeleter);
+    }
+    done->iov = std::move(vecs);
+    stub.Write(&done->cntl, &request, &done->response, done);
+
+    return 0;
+}
+
 int NebdClient::Flush(int fd, NebdClientAioContext* aioctx) {
     nebd::client::NebdFileService_Stub stub(&channel_);
     nebd::client::FlushRequest request;
@@ -518,6 +572,31 @@ int NebdClient::InitChannel() {
     return 0;
 }
 
+bool NebdClient::CheckIovec(const struct iovec* iov, int iovcnt,
+                            size_t length, std::vector<iovec>* out) {
+    if (iov == nullptr || iovcnt <= 0) {
+        LOG(ERROR) << "Invalid iov, iovcnt = " << iovcnt;
+        return false;
+    }
+
+    size_t total = 0;
+    out->reserve(iovcnt);
+    for (int i = 0; i < iovcnt; ++i) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+        total += iov[i].iov_len;
+        out->push_back(iov[i]);
+    }
+
+    if (total != length) {
+        LOG(ERROR) << "Iov length mismatch, iov length = " << total
+                   << ", request length = " << length;
+        return false;
+    }
+    return true;
+}
+
 int64_t NebdClient::ExecuteSyncRpc(RpcTask task) {
     int64_t retryTimes = 0;
     int64_t ret = 0;
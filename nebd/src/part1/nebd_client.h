@@ -24,10 +24,12 @@
 #define NEBD_SRC_PART1_NEBD_CLIENT_H_
 
 #include <brpc/channel.h>
+#include <sys/uio.h>
 
 #include <functional>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "nebd/src/part1/nebd_common.h"
 #include "nebd/src/common/configuration.h"
@@ -120,6 +122,28 @@ class NebdClient {
      */
     int AioWrite(int fd, NebdClientAioContext* aioctx);
 
+    /**
+     *  @brief 读文件，读到的数据按顺序填充到iov的各段buffer中，异步函数
+     *  @param fd：文件的fd
+     *         context：异步请求的上下文，不使用其中的buf
+     *         iov：存放读取data的buffer数组，各段长度之和需要等于length
+     *         iovcnt：iov数组的长度
+     *  @return 成功返回0，失败返回错误码
+     */
+    int AioReadv(int fd, NebdClientAioContext* aioctx,
+                 const struct iovec* iov, int iovcnt);
+
+    /**
+     *  @brief 写文件，iov的各段buffer直接放入rpc的attachment，不拷贝，异步函数
+     *  @param fd：文件的fd
+     *         context：异步请求的上下文，不使用其中的buf
+     *         iov：存放写入data的buffer数组，各段长度之和需要等于length
+     *         iovcnt：iov数组的长度
+     *  @return 成功返回0，失败返回错误码
+     */
+    int AioWritev(int fd, NebdClientAioContext* aioctx,
+                  const struct iovec* iov, int iovcnt);
+
     /**
      *  @brief flush文件，异步函数
      *  @param fd：文件的fd
@@ -161,6 +185,19 @@ class NebdClient {
     std::string ReplaceSlash(const std::string& str);
 
     int64_t ExecuteSyncRpc(RpcTask task);
+
+    /**
+     * @brief 检查iov各段长度之和是否等于length，并跳过长度为0的段
+     *
+     * @param iov 用户的buffer数组
+     * @param iovcnt iov数组的长度
+     * @param length 请求的长度
+     * @param[out] out 长度不为0的各段buffer
+     * @return 检查通过返回true
+     */
+    static bool CheckIovec(const struct iovec* iov, int iovcnt,
+                           size_t length, std::vector<iovec>* out);
+
     // 心跳管理模块
     std::shared_ptr<HeartbeatManager> heartbeatMgr_;
     // 缓存模块
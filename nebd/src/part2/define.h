@@ -23,6 +23,7 @@
 #ifndef NEBD_SRC_PART2_DEFINE_H_
 #define NEBD_SRC_PART2_DEFINE_H_
 
+#include <butil/iobuf.h>
 #include <google/protobuf/message.h>
 #include <google/protobuf/service.h>
 #include <string>
@@ -86,8 +87,10 @@ struct NebdServerAioContext {
     LIBAIO_OP op = LIBAIO_OP::LIBAIO_OP_UNKNOWN;
     // 异步请求结束时调用的回调函数
     NebdAioCallBack cb;
-    // 请求的buf
+    // 请求的buf，读请求的buf为空时读到的数据保存在readData中
     void* buf = nullptr;
+    // 读请求的数据，直接引用curve client返回的数据块，不拷贝
+    butil::IOBuf readData;
     // rpc请求的相应内容
     Message* response = nullptr;
     // rpc请求的回调函数
@@ -44,8 +44,12 @@ void NebdFileServiceCallback(NebdServerAioContext* context) {
             nebd::client::ReadResponse* response =
                 dynamic_cast<nebd::client::ReadResponse*>(context->response);
             butil::IOBuf readBuf;
-            readBuf.append_user_data(
-                context->buf, context->size, AioReadDeleter);
+            if (context->buf != nullptr) {
+                readBuf.append_user_data(
+                    context->buf, context->size, AioReadDeleter);
+            } else {
+                readBuf.swap(context->readData);
+            }
             if (context->ret < 0) {
                 response->set_retcode(RetCode::kNoOK);
                 LOG(ERROR) << "Read file failed. "
@@ -184,7 +188,8 @@ void NebdFileServiceImpl::Read(
     aioContext->size = request->size();
     aioContext->op = LIBAIO_OP::LIBAIO_OP_READ;
     aioContext->cb = NebdFileServiceCallback;
-    aioContext->buf = new char[request->size()];
+    // 不分配buf，读到的数据以IOBuf返回，直接作为rpc的attachment
+    aioContext->buf = nullptr;
     aioContext->response = response;
     aioContext->done = done;
     aioContext->cntl = cntl_base;
@@ -195,7 +200,6 @@ void NebdFileServiceImpl::Read(
                    << ", offset: " << request->offset()
                    << ", size: " << request->size()
                    << ", return code: " << rc;
-        delete[] reinterpret_cast<char*>(aioContext->buf);
     } else {
         doneGuard.release();
     }
@@ -154,9 +154,24 @@ int CurveRequestExecutor::GetInfo(
 
 int CurveRequestExecutor::Discard(
     NebdFileInstance* fd, NebdServerAioContext* aioctx) {
+    int curveFd = GetCurveFdFromNebdFileInstance(fd);
+    if (curveFd < 0) {
+        return -1;
+    }
 
-    aioctx->ret = 0;
-    aioctx->cb(aioctx);
+    CurveAioCombineContext *curveCombineCtx = new CurveAioCombineContext();
+    curveCombineCtx->nebdCtx = aioctx;
+    int ret = FromNebdCtxToCurveCtx(aioctx, &curveCombineCtx->curveCtx);
+    if (ret < 0) {
+        delete curveCombineCtx;
+        return -1;
+    }
+
+    ret = client_->AioDiscard(curveFd, &curveCombineCtx->curveCtx);
+    if (ret != LIBCURVE_ERROR::OK) {
+        delete curveCombineCtx;
+        return -1;
+    }
 
     return 0;
 }
@@ -176,7 +191,13 @@ int CurveRequestExecutor::AioRead(
         return -1;
     }
 
-    ret = client_->AioRead(curveFd,  &curveCombineCtx->curveCtx);
+    // 没有buf时读到的数据直接以IOBuf返回，避免拷贝
+    if (aioctx->buf == nullptr) {
+        ret = client_->AioReadIOBuf(curveFd, &curveCombineCtx->curveCtx,
+                                    &aioctx->readData);
+    } else {
+        ret = client_->AioRead(curveFd,  &curveCombineCtx->curveCtx);
+    }
     if (ret !=  LIBCURVE_ERROR::OK) {
         delete curveCombineCtx;
         return -1;
@@ -211,9 +232,24 @@ int CurveRequestExecutor::AioWrite(
 
 int CurveRequestExecutor::Flush(
     NebdFileInstance* fd, NebdServerAioContext* aioctx) {
+    int curveFd = GetCurveFdFromNebdFileInstance(fd);
+    if (curveFd < 0) {
+        return -1;
+    }
 
-    aioctx->ret = 0;
-    aioctx->cb(aioctx);
+    CurveAioCombineContext *curveCombineCtx = new CurveAioCombineContext();
+    curveCombineCtx->nebdCtx = aioctx;
+    int ret = FromNebdCtxToCurveCtx(aioctx, &curveCombineCtx->curveCtx);
+    if (ret < 0) {
+        delete curveCombineCtx;
+        return -1;
+    }
+
+    ret = client_->AioFlush(curveFd,  &curveCombineCtx->curveCtx);
+    if (ret !=  LIBCURVE_ERROR::OK) {
+        delete curveCombineCtx;
+        return -1;
+    }
 
     return 0;
 }
@@ -226,6 +262,11 @@ int CurveRequestExecutor::InvalidCache(NebdFileInstance* fd) {
         return -1;
     }
 
+    int res = client_->InvalidCache(curveFileInstance->fd);
+    if (res != LIBCURVE_ERROR::OK) {
+        return -1;
+    }
+
     return 0;
 }
 
@@ -269,6 +310,12 @@ int CurveRequestExecutor::FromNebdOpToCurveOp(LIBAIO_OP op, LIBCURVE_OP *out) {
     case LIBAIO_OP::LIBAIO_OP_WRITE:
         *out = LIBCURVE_OP_WRITE;
         return 0;
+    case LIBAIO_OP::LIBAIO_OP_FLUSH:
+        *out = LIBCURVE_OP_FLUSH;
+        return 0;
+    case LIBAIO_OP::LIBAIO_OP_DISCARD:
+        *out = LIBCURVE_OP_DISCARD;
+        return 0;
 
     default:
         return -1;
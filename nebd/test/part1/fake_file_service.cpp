@@ -89,9 +89,8 @@ void FakeNebdFileService::Write(::google::protobuf::RpcController* controller,
 
     LOG(INFO) << "logid = " << cntl->log_id() << ", Write.";
 
-    // memcpy(buffer + request->offset(),
-    //        cntl->request_attachment().to_string().c_str(),
-    //        request->size());
+    cntl->request_attachment().copy_to(buffer + request->offset(),
+                                       request->size());
     response->set_retcode(RetCode::kOK);
     response->set_retmsg("Write OK");
 
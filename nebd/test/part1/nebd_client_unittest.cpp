@@ -27,6 +27,7 @@
 #include <mutex>  // NOLINT
 #include <condition_variable>  // NOLINT
 #include <atomic>
+#include <string>
 
 #include "nebd/src/part1/nebd_client.h"
 #include "nebd/src/part1/libnebd.h"
@@ -369,6 +370,86 @@ TEST_F(NebdFileClientTest, CommonTest) {
     StopServer();
 }
 
+TEST_F(NebdFileClientTest, VectoredIOTest) {
+    AddFakeService();
+    StartServer();
+
+    ASSERT_EQ(0, Init4Nebd(kNebdClientConf));
+
+    int fd = Open4Nebd(kFileName);
+    ASSERT_GE(fd, 0);
+
+    // 写入不连续的两段buffer
+    char head[kBufSize / 4];
+    char tail[kBufSize - kBufSize / 4];
+    memset(head, 'a', sizeof(head));
+    memset(tail, 'b', sizeof(tail));
+    struct iovec writeIov[3] = {
+        {head, sizeof(head)}, {nullptr, 0}, {tail, sizeof(tail)}};
+
+    {
+        NebdClientAioContext* ctx = new NebdClientAioContext();
+        ctx->buf = nullptr;
+        ctx->offset = 0;
+        ctx->length = kBufSize;
+        ctx->ret = 0;
+        ctx->op = LIBAIO_OP_WRITE;
+        ctx->cb = AioCallBack;
+        ctx->retryCount = 0;
+
+        aioOpReturn = false;
+        ASSERT_EQ(0, AioWritev4Nebd(fd, ctx, writeIov, 3));
+        std::unique_lock<std::mutex> ulk(mtx);
+        cond.wait(ulk, []() { return aioOpReturn.load(); });
+        ASSERT_TRUE(aioOpReturn.load());
+    }
+
+    // 按不同的分段读回
+    char first[kBufSize / 2];
+    char second[kBufSize / 2];
+    struct iovec readIov[2] = {
+        {first, sizeof(first)}, {second, sizeof(second)}};
+
+    {
+        NebdClientAioContext* ctx = new NebdClientAioContext();
+        ctx->buf = nullptr;
+        ctx->offset = 0;
+        ctx->length = kBufSize;
+        ctx->ret = 0;
+        ctx->op = LIBAIO_OP_READ;
+        ctx->cb = AioCallBack;
+        ctx->retryCount = 0;
+
+        aioOpReturn = false;
+        ASSERT_EQ(0, AioReadv4Nebd(fd, ctx, readIov, 2));
+        std::unique_lock<std::mutex> ulk(mtx);
+        cond.wait(ulk, []() { return aioOpReturn.load(); });
+        ASSERT_TRUE(aioOpReturn.load());
+    }
+
+    std::string expected = std::string(sizeof(head), 'a') +
+                           std::string(sizeof(tail), 'b');
+    ASSERT_EQ(expected.substr(0, sizeof(first)),
+              std::string(first, sizeof(first)));
+    ASSERT_EQ(expected.substr(sizeof(first)),
+              std::string(second, sizeof(second)));
+
+    // iov的总长度与请求长度不一致
+    {
+        NebdClientAioContext ctx;
+        ctx.offset = 0;
+        ctx.length = kBufSize;
+        ctx.op = LIBAIO_OP_READ;
+        ASSERT_EQ(-1, AioReadv4Nebd(fd, &ctx, readIov, 1));
+        ASSERT_EQ(-1, AioWritev4Nebd(fd, &ctx, writeIov, 2));
+        ASSERT_EQ(-1, AioWritev4Nebd(fd, &ctx, nullptr, 0));
+    }
+
+    ASSERT_EQ(0, Close4Nebd(fd));
+    ASSERT_NO_THROW(Uninit4Nebd());
+    StopServer();
+}
+
 TEST_F(NebdFileClientTest, ReOpenTest) {
     AddFakeService();
     StartServer();
@@ -348,6 +348,26 @@ TEST_F(FileServiceTest, CallbackTest) {
         ASSERT_TRUE(done.IsRunned());
         ASSERT_EQ(response.retcode(), RetCode::kOK);
     }
+    // read success, data in iobuf
+    {
+        brpc::Controller cntl;
+        nebd::client::ReadResponse response;
+        FileServiceTestClosure done;
+        NebdServerAioContext* context = new NebdServerAioContext;
+        context->op = LIBAIO_OP::LIBAIO_OP_READ;
+        context->cntl = &cntl;
+        context->response = &response;
+        context->offset = 0;
+        context->size = 4096;
+        context->done = &done;
+        context->readData.append(std::string(4096, 'a'));
+        context->ret = 0;
+        NebdFileServiceCallback(context);
+        ASSERT_TRUE(done.IsRunned());
+        ASSERT_EQ(response.retcode(), RetCode::kOK);
+        ASSERT_EQ(std::string(4096, 'a'),
+                  cntl.response_attachment().to_string());
+    }
     // read failed
     {
         brpc::Controller cntl;
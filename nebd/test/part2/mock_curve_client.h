@@ -42,7 +42,15 @@ class MockCurveClient : public ::curve::client::CurveClient {
     MOCK_METHOD2(Extend, int(const std::string&, int64_t));
     MOCK_METHOD1(StatFile, int64_t(const std::string&));
     MOCK_METHOD2(AioRead, int(int, CurveAioContext*));
+    MOCK_METHOD3(AioReadIOBuf, int(int, CurveAioContext*, butil::IOBuf*));
+    MOCK_METHOD4(AioReadv, int(int, CurveAioContext*,
+                               const struct iovec*, int));
     MOCK_METHOD2(AioWrite, int(int, CurveAioContext*));
+    MOCK_METHOD4(AioWritev, int(int, CurveAioContext*,
+                                const struct iovec*, int));
+    MOCK_METHOD2(AioFlush, int(int, CurveAioContext*));
+    MOCK_METHOD2(AioDiscard, int(int, CurveAioContext*));
+    MOCK_METHOD1(InvalidCache, int(int));
 };
 
 }  // namespace server
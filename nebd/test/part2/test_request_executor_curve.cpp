@@ -178,7 +178,7 @@ TEST_F(TestReuqestExecutorCurve, test_Close) {
         auto curveFileIns = new CurveFileInstance();
         curveFileIns->fd = 1;
         EXPECT_CALL(*curveClient_, Close(1))
-            .WillOnce(Return(LIBCURVE_ERROR::OK));
+            .WillOnce(Return(0));
         ASSERT_EQ(0, executor.Close(curveFileIns));
     }
 }
@@ -215,7 +215,7 @@ TEST_F(TestReuqestExecutorCurve, test_Extend) {
         auto curveFileIns = new CurveFileInstance();
         curveFileIns->fileName = curveFilename;
         EXPECT_CALL(*curveClient_, Extend(curveFilename, 1))
-            .WillOnce(Return(LIBCURVE_ERROR::OK));
+            .WillOnce(Return(0));
         ASSERT_EQ(0, executor.Extend(curveFileIns, 1));
     }
 }
@@ -305,6 +305,25 @@ TEST_F(TestReuqestExecutorCurve, test_AioRead) {
         ASSERT_EQ(0, executor.AioRead(curveFileIns, &aiotcx));
         curveCtx->cb(curveCtx);
     }
+
+    // 5. 没有buf时数据以IOBuf返回
+    {
+        auto curveFileIns = new CurveFileInstance();
+        curveFileIns->fd = 1;
+        curveFileIns->fileName = curveFilename;
+        aiotcx.buf = nullptr;
+        CurveAioContext* curveCtx;
+        EXPECT_CALL(*curveClient_, AioRead(_, _)).Times(0);
+        EXPECT_CALL(*curveClient_, AioReadIOBuf(1, _, &aiotcx.readData))
+            .WillOnce(DoAll(SaveArg<1>(&curveCtx),
+                            Return(LIBCURVE_ERROR::OK)));
+        ASSERT_EQ(0, executor.AioRead(curveFileIns, &aiotcx));
+        curveCtx->cb(curveCtx);
+
+        EXPECT_CALL(*curveClient_, AioReadIOBuf(1, _, _))
+            .WillOnce(Return(LIBCURVE_ERROR::FAILED));
+        ASSERT_EQ(-1, executor.AioRead(curveFileIns, &aiotcx));
+    }
 }
 
 TEST_F(TestReuqestExecutorCurve, test_AioWrite) {
@@ -359,25 +378,60 @@ TEST_F(TestReuqestExecutorCurve, test_AioWrite) {
 TEST_F(TestReuqestExecutorCurve, test_Discard) {
     auto executor = CurveRequestExecutor::GetInstance();
     std::string curveFilename("/cinder/volume-1234_cinder_");
-    std::unique_ptr<CurveFileInstance> curveFileIns(new CurveFileInstance());
     NebdServerAioContext* aioctx = new NebdServerAioContext();
     nebd::client::DiscardResponse response;
     TestReuqestExecutorCurveClosure done;
 
     aioctx->op = LIBAIO_OP::LIBAIO_OP_DISCARD;
+    aioctx->offset = 0;
+    aioctx->size = 4096;
     aioctx->cb = NebdFileServiceCallback;
     aioctx->response = &response;
     aioctx->done = &done;
 
-    ASSERT_EQ(0, executor.Discard(curveFileIns.get(), aioctx));
-    ASSERT_TRUE(done.IsRunned());
-    ASSERT_EQ(response.retcode(), nebd::client::RetCode::kOK);
+    // 1. nebdFileIns中的fd<0, discard失败
+    {
+        std::unique_ptr<CurveFileInstance> curveFileIns(
+            new CurveFileInstance());
+        EXPECT_CALL(*curveClient_, AioDiscard(_, _)).Times(0);
+        ASSERT_EQ(-1, executor.Discard(curveFileIns.get(), aioctx));
+    }
+
+    // 2. 调用curveclient的AioDiscard接口失败
+    {
+        std::unique_ptr<CurveFileInstance> curveFileIns(
+            new CurveFileInstance());
+        curveFileIns->fd = 1;
+        curveFileIns->fileName = curveFilename;
+        EXPECT_CALL(*curveClient_, AioDiscard(1, _))
+            .WillOnce(Return(-LIBCURVE_ERROR::FAILED));
+        ASSERT_EQ(-1, executor.Discard(curveFileIns.get(), aioctx));
+    }
+
+    // 3. discard成功
+    {
+        std::unique_ptr<CurveFileInstance> curveFileIns(
+            new CurveFileInstance());
+        curveFileIns->fd = 1;
+        curveFileIns->fileName = curveFilename;
+        CurveAioContext* curveCtx;
+        EXPECT_CALL(*curveClient_, AioDiscard(1, _))
+            .WillOnce(DoAll(SaveArg<1>(&curveCtx),
+                            Return(LIBCURVE_ERROR::OK)));
+        ASSERT_EQ(0, executor.Discard(curveFileIns.get(), aioctx));
+        ASSERT_EQ(LIBCURVE_OP_DISCARD, curveCtx->op);
+        ASSERT_EQ(0, curveCtx->offset);
+        ASSERT_EQ(4096, curveCtx->length);
+        curveCtx->ret = 4096;
+        curveCtx->cb(curveCtx);
+        ASSERT_TRUE(done.IsRunned());
+        ASSERT_EQ(response.retcode(), nebd::client::RetCode::kOK);
+    }
 }
 
 TEST_F(TestReuqestExecutorCurve, test_Flush) {
     auto executor = CurveRequestExecutor::GetInstance();
     std::string curveFilename("/cinder/volume-1234_cinder_");
-    std::unique_ptr<CurveFileInstance> curveFileIns(new CurveFileInstance());
     NebdServerAioContext* aioctx = new NebdServerAioContext();
     nebd::client::FlushResponse response;
     TestReuqestExecutorCurveClosure done;
@@ -387,9 +441,42 @@ TEST_F(TestReuqestExecutorCurve, test_Flush) {
     aioctx->response = &response;
     aioctx->done = &done;
 
-    ASSERT_EQ(0, executor.Flush(curveFileIns.get(), aioctx));
-    ASSERT_TRUE(done.IsRunned());
-    ASSERT_EQ(response.retcode(), nebd::client::RetCode::kOK);
+    // 1. nebdFileIns中的fd<0, flush失败
+    {
+        std::unique_ptr<CurveFileInstance> curveFileIns(
+            new CurveFileInstance());
+        EXPECT_CALL(*curveClient_, AioFlush(_, _)).Times(0);
+        ASSERT_EQ(-1, executor.Flush(curveFileIns.get(), aioctx));
+    }
+
+    // 2. 调用curveclient的AioFlush接口失败
+    {
+        std::unique_ptr<CurveFileInstance> curveFileIns(
+            new CurveFileInstance());
+        curveFileIns->fd = 1;
+        curveFileIns->fileName = curveFilename;
+        EXPECT_CALL(*curveClient_, AioFlush(1, _))
+            .WillOnce(Return(-LIBCURVE_ERROR::FAILED));
+        ASSERT_EQ(-1, executor.Flush(curveFileIns.get(), aioctx));
+    }
+
+    // 3. flush成功
+    {
+        std::unique_ptr<CurveFileInstance> curveFileIns(
+            new CurveFileInstance());
+        curveFileIns->fd = 1;
+        curveFileIns->fileName = curveFilename;
+        CurveAioContext* curveCtx;
+        EXPECT_CALL(*curveClient_, AioFlush(1, _))
+            .WillOnce(DoAll(SaveArg<1>(&curveCtx),
+                            Return(LIBCURVE_ERROR::OK)));
+        ASSERT_EQ(0, executor.Flush(curveFileIns.get(), aioctx));
+        ASSERT_EQ(LIBCURVE_OP_FLUSH, curveCtx->op);
+        curveCtx->ret = 0;
+        curveCtx->cb(curveCtx);
+        ASSERT_TRUE(done.IsRunned());
+        ASSERT_EQ(response.retcode(), nebd::client::RetCode::kOK);
+    }
 }
 
 TEST_F(TestReuqestExecutorCurve, test_InvalidCache) {
@@ -417,11 +504,23 @@ TEST_F(TestReuqestExecutorCurve, test_InvalidCache) {
         ASSERT_EQ(-1, executor.InvalidCache(curveFileIns));
     }
 
-    // 4. 合法
+    // 4. curve client失效缓存失败
+    {
+        auto curveFileIns = new CurveFileInstance();
+        curveFileIns->fd = 1;
+        curveFileIns->fileName = curveFilename;
+        EXPECT_CALL(*curveClient_, InvalidCache(1))
+            .WillOnce(Return(-1));
+        ASSERT_EQ(-1, executor.InvalidCache(curveFileIns));
+    }
+
+    // 5. 合法
     {
         auto curveFileIns = new CurveFileInstance();
         curveFileIns->fd = 1;
         curveFileIns->fileName = curveFilename;
+        EXPECT_CALL(*curveClient_, InvalidCache(1))
+            .WillOnce(Return(0));
         ASSERT_EQ(0, executor.InvalidCache(curveFileIns));
     }
 }
@@ -35,6 +35,7 @@
 #include "src/chunkserver/chunkserver_metrics.h"
 #include "src/chunkserver/op_request.h"
 #include "src/chunkserver/chunk_service_closure.h"
+#include "src/common/crc32.h"
 
 namespace curve {
 namespace chunkserver {
@@ -86,6 +87,95 @@ void ChunkServiceImpl::DeleteChunk(RpcController *controller,
     req->Process();
 }
 
+void ChunkServiceImpl::DiscardChunk(RpcController *controller,
+                                    const ChunkRequest *request,
+                                    ChunkResponse *response,
+                                    Closure *done) {
+    ChunkServiceClosure* closure =
+        new (std::nothrow) ChunkServiceClosure(inflightThrottle_,
+                                               request,
+                                               response,
+                                               done);
+    CHECK(nullptr != closure) << "new chunk service closure failed";
+
+    brpc::ClosureGuard doneGuard(closure);
+
+    if (inflightThrottle_->IsOverLoad()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD);
+        LOG_EVERY_N(WARNING, 100)
+            << "DiscardChunk: "
+            << "too many inflight requests to process in chunkserver";
+        return;
+    }
+
+    // 判断copyset是否存在
+    auto nodePtr = copysetNodeManager_->GetCopysetNode(request->logicpoolid(),
+                                                       request->copysetid());
+    if (nullptr == nodePtr) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST);
+        LOG(WARNING) << "discard chunk failed, copyset node is not found:"
+                     << request->logicpoolid() << "," << request->copysetid();
+        return;
+    }
+
+    std::shared_ptr<DiscardChunkRequest>
+        req = std::make_shared<DiscardChunkRequest>(nodePtr,
+                                                    controller,
+                                                    request,
+                                                    response,
+                                                    doneGuard.release());
+    req->Process();
+}
+
+void ChunkServiceImpl::DeleteChunks(RpcController *controller,
+                                    const ChunkRequest *request,
+                                    ChunkResponse *response,
+                                    Closure *done) {
+    ChunkServiceClosure* closure =
+        new (std::nothrow) ChunkServiceClosure(inflightThrottle_,
+                                               request,
+                                               response,
+                                               done);
+    CHECK(nullptr != closure) << "new chunk service closure failed";
+
+    brpc::ClosureGuard doneGuard(closure);
+
+    if (inflightThrottle_->IsOverLoad()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD);
+        LOG_EVERY_N(WARNING, 100)
+            << "DeleteChunks: "
+            << "too many inflight requests to process in chunkserver";
+        return;
+    }
+
+    if (request->chunkids_size() == 0) {
+        response->set_status(
+            CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST);
+        LOG(ERROR) << "delete chunks failed, no chunk to delete: "
+                   << request->logicpoolid() << ","
+                   << request->copysetid();
+        return;
+    }
+
+    // 判断copyset是否存在
+    auto nodePtr = copysetNodeManager_->GetCopysetNode(request->logicpoolid(),
+                                                       request->copysetid());
+    if (nullptr == nodePtr) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST);
+        LOG(WARNING) << "delete chunks failed, copyset node is not found:"
+                     << request->logicpoolid() << "," << request->copysetid();
+        return;
+    }
+
+    std::shared_ptr<DeleteChunksRequest>
+        req = std::make_shared<DeleteChunksRequest>(nodePtr,
+                                                    controller,
+                                                    request,
+                                                    response,
+                                                    doneGuard.release());
+    req->Process();
+}
+
 void ChunkServiceImpl::WriteChunk(RpcController *controller,
                                   const ChunkRequest *request,
                                   ChunkResponse *response,
@@ -124,6 +214,25 @@ void ChunkServiceImpl::WriteChunk(RpcController *controller,
         return;
     }
 
+    // 请求带了数据的CRC时，在写入raft日志之前校验，
+    // 数据在传输过程中损坏时返回CRC_FAIL，由client重新发送
+    if (request->has_crc32()) {
+        uint32_t crc = curve::common::CRC32(cntl->request_attachment());
+        if (crc != request->crc32()) {
+            response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_CRC_FAIL);
+            LOG(ERROR) << "write chunk failed, crc mismatch: "
+                       << " logic pool id: " << request->logicpoolid()
+                       << " copyset id: " << request->copysetid()
+                       << " chunkid: " << request->chunkid()
+                       << " offset: " << request->offset()
+                       << " size: " << request->size()
+                       << " request crc: " << request->crc32()
+                       << " data crc: " << crc
+                       << " remote side: " << cntl->remote_side();
+            return;
+        }
+    }
+
     // 判断copyset是否存在
     auto nodePtr = copysetNodeManager_->GetCopysetNode(request->logicpoolid(),
                                                        request->copysetid());
@@ -48,6 +48,16 @@ class ChunkServiceImpl : public ChunkService {
                      ChunkResponse *response,
                      Closure *done);
 
+    void DiscardChunk(RpcController *controller,
+                      const ChunkRequest *request,
+                      ChunkResponse *response,
+                      Closure *done);
+
+    void DeleteChunks(RpcController *controller,
+                      const ChunkRequest *request,
+                      ChunkResponse *response,
+                      Closure *done);
+
     void ReadChunk(RpcController *controller,
                    const ChunkRequest *request,
                    ChunkResponse *response,
@@ -473,6 +473,10 @@ void ChunkServer::InitHeartbeatOptions(
         &heartbeatOptions->intervalSec));
     LOG_IF(FATAL, !conf->GetUInt32Value("mds.heartbeat_timeout",
         &heartbeatOptions->timeout));
+    LOG_IF(FATAL, !conf->GetBoolValue("mds.heartbeat_enable_delta",
+        &heartbeatOptions->enableDelta));
+    LOG_IF(FATAL, !conf->GetUInt32Value("mds.heartbeat_full_interval",
+        &heartbeatOptions->fullInterval));
 }
 
 void ChunkServer::InitRegisterOptions(
@@ -30,6 +30,7 @@
 #include "src/chunkserver/chunk_service_closure.h"
 #include "src/chunkserver/datastore/chunkserver_datastore.h"
 #include "src/common/timeutility.h"
+#include "src/common/crc32.h"
 
 namespace curve {
 namespace chunkserver {
@@ -287,6 +288,10 @@ int CloneCore::ReadChunk(std::shared_ptr<ReadChunkRequest> readRequest) {
     // 读成功后需要更新 apply index
     readRequest->node_->UpdateAppliedIndex(readRequest->applyIndex);
     // Return 完成数据读取后可以将结果返回给用户
+    if (request->needcrc()) {
+        readRequest->response_->set_crc32(
+            curve::common::CRC32(chunkData.get(), length));
+    }
     readRequest->cntl_->response_attachment().append(
         chunkData.get(), length);
     SetResponse(readRequest, CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
@@ -340,6 +345,10 @@ int CloneCore::SetReadChunkResponse(
     } else {
         responseData = *cloneData;
     }
+    if (request->needcrc()) {
+        readRequest->response_->set_crc32(
+            curve::common::CRC32(responseData));
+    }
     readRequest->cntl_->response_attachment().append(responseData);
 
     // 读成功后需要更新 apply index
@@ -219,50 +219,60 @@ void CopysetNode::Fini() {
 
 void CopysetNode::on_apply(::braft::Iterator &iter) {
     for (; iter.valid(); iter.next()) {
-        // 放在bthread中异步执行，避免阻塞当前状态机的执行
-        braft::AsyncClosureGuard doneGuard(iter.done());
+        ApplyEntry(iter.index(), iter.data(), iter.done());
+    }
+}
 
+void CopysetNode::ApplyEntry(int64_t index, const butil::IOBuf &log,
+                             ::braft::Closure *closure) {
+    // 放在bthread中异步执行，避免阻塞当前状态机的执行
+    braft::AsyncClosureGuard doneGuard(closure);
+
+    if (nullptr != closure) {
         /**
-         * 获取向braft提交任务时候传递的ChunkClosure，里面包含了
-         * Op的所有上下文 ChunkOpRequest
+         * 1.closure不是null，那么说明当前节点正常，直接从内存中拿到Op
+         * context进行apply
          */
-        braft::Closure *closure = iter.done();
-
-        if (nullptr != closure) {
-            /**
-             * 1.closure不是null，那么说明当前节点正常，直接从内存中拿到Op
-             * context进行apply
-             */
-            ChunkClosure
-                *chunkClosure = dynamic_cast<ChunkClosure *>(iter.done());
-            CHECK(nullptr != chunkClosure)
-                << "ChunkClosure dynamic cast failed";
-            std::shared_ptr<ChunkOpRequest> opRequest = chunkClosure->request_;
-            auto task = std::bind(&ChunkOpRequest::OnApply,
-                                  opRequest,
-                                  iter.index(),
-                                  doneGuard.release());
-            concurrentapply_->Push(opRequest->ChunkId(), task);
-        } else {
-            // 获取log entry
-            butil::IOBuf log = iter.data();
-            /**
-             * 2.closure是null，有两种情况：
-             * 2.1. 节点重启，回放apply，这里会将Op log entry进行反序列化，
-             * 然后获取Op信息进行apply
-             * 2.2. follower apply
-             */
-            ChunkRequest request;
-            butil::IOBuf data;
-            auto opReq = ChunkOpRequest::Decode(log, &request, &data);
-            auto chunkId = request.chunkid();
-            auto task = std::bind(&ChunkOpRequest::OnApplyFromLog,
-                                  opReq,
-                                  dataStore_,
-                                  std::move(request),
-                                  data);
-            concurrentapply_->Push(chunkId, task);
+        ChunkClosure
+            *chunkClosure = dynamic_cast<ChunkClosure *>(closure);
+        CHECK(nullptr != chunkClosure)
+            << "ChunkClosure dynamic cast failed";
+        std::shared_ptr<ChunkOpRequest> opRequest = chunkClosure->request_;
+        if (CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH == opRequest->OpType()) {
+            // 批量删除涉及多个chunk，不能按单个chunk放入队列，
+            // 等之前的op全部apply完成后直接执行，作为所有chunk的屏障
+            concurrentapply_->Flush();
+            opRequest->OnApply(index, doneGuard.release());
+            return;
+        }
+        auto task = std::bind(&ChunkOpRequest::OnApply,
+                              opRequest,
+                              index,
+                              doneGuard.release());
+        concurrentapply_->Push(opRequest->ChunkId(), task);
+    } else {
+        /**
+         * 2.closure是null，有两种情况：
+         * 2.1. 节点重启，回放apply，这里会将Op log entry进行反序列化，
+         * 然后获取Op信息进行apply
+         * 2.2. follower apply
+         */
+        ChunkRequest request;
+        butil::IOBuf data;
+        auto opReq = ChunkOpRequest::Decode(log, &request, &data);
+        if (CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH == request.optype()) {
+            // 同上，批量删除作为屏障执行
+            concurrentapply_->Flush();
+            opReq->OnApplyFromLog(dataStore_, request, data);
+            return;
         }
+        auto chunkId = request.chunkid();
+        auto task = std::bind(&ChunkOpRequest::OnApplyFromLog,
+                              opReq,
+                              dataStore_,
+                              std::move(request),
+                              data);
+        concurrentapply_->Push(chunkId, task);
     }
 }
 
@@ -376,6 +376,16 @@ class CopysetNode : public braft::StateMachine,
      */
     int SaveConfEpoch(const std::string &filePath);
 
+    /**
+     * apply一条op log entry，on_apply中逐条调用
+     * @param index:此op log entry的index
+     * @param log:op log entry的数据，closure不为空时不使用
+     * @param closure:leader上propose时传入的ChunkClosure，
+     *                回放日志和follower apply时为空
+     */
+    void ApplyEntry(int64_t index, const butil::IOBuf &log,
+                    ::braft::Closure *closure);
+
  private:
     inline std::string GroupId() {
         return ToGroupId(logicPoolId_, copysetId_);
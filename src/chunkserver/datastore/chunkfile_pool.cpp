@@ -402,35 +402,10 @@ int ChunkfilePool::RecycleChunk(const std::string& chunkpath) {
         }
     } else {
         // 检查该待回收的文件大小是否符合要求，不符合就直接删掉
-        uint64_t chunklen = chunkPoolOpt_.chunkSize+chunkPoolOpt_.metaPageSize;
-        int fd = fsptr_->Open(chunkpath.c_str(), O_RDWR);
-        if (fd < 0) {
-            LOG(ERROR) << "file open failed! delete file dirctly"
-                       << ", filename = " << chunkpath.c_str();
-            return fsptr_->Delete(chunkpath.c_str());
-        }
-
-        struct stat info;
-        int ret = fsptr_->Fstat(fd, &info);
-        if (ret != 0) {
-            LOG(ERROR)  << "Fstat file " << chunkpath.c_str()
-                        << "failed, ret = " << ret
-                        << ", delete file dirctly";
-            fsptr_->Close(fd);
+        if (!IsValidRecycleChunk(chunkpath)) {
             return fsptr_->Delete(chunkpath.c_str());
         }
 
-        if (info.st_size != chunklen) {
-            LOG(ERROR) << "file size illegal, " << chunkpath.c_str()
-                          << ", delete file dirctly"
-                          << ", standard size = " << chunklen
-                          << ", current file size = " << info.st_size;
-            fsptr_->Close(fd);
-            return fsptr_->Delete(chunkpath.c_str());
-        }
-
-        fsptr_->Close(fd);
-
         uint64_t newfilenum = 0;
         std::string newfilename;
         {
@@ -441,7 +416,7 @@ int ChunkfilePool::RecycleChunk(const std::string& chunkpath) {
         }
         std::string targetpath = currentdir_ + "/" + newfilename;
 
-        ret = fsptr_->Rename(chunkpath.c_str(), targetpath.c_str());
+        int ret = fsptr_->Rename(chunkpath.c_str(), targetpath.c_str());
         if (ret < 0) {
             LOG(ERROR) << "file rename failed, " << chunkpath.c_str();
             return -1;
@@ -456,6 +431,96 @@ int ChunkfilePool::RecycleChunk(const std::string& chunkpath) {
     return 0;
 }
 
+int ChunkfilePool::RecycleChunks(const std::vector<std::string>& chunkpaths) {
+    int result = 0;
+    if (!chunkPoolOpt_.getChunkFromPool) {
+        for (auto& chunkpath : chunkpaths) {
+            if (fsptr_->Delete(chunkpath.c_str()) < 0) {
+                LOG(ERROR) << "Recycle chunk failed, " << chunkpath;
+                result = -1;
+            }
+        }
+        return result;
+    }
+
+    std::vector<const std::string*> recycles;
+    recycles.reserve(chunkpaths.size());
+    for (auto& chunkpath : chunkpaths) {
+        // 不符合要求的文件直接删掉
+        if (!IsValidRecycleChunk(chunkpath)) {
+            if (fsptr_->Delete(chunkpath.c_str()) < 0) {
+                result = -1;
+            }
+            continue;
+        }
+        recycles.push_back(&chunkpath);
+    }
+    if (recycles.empty()) {
+        return result;
+    }
+
+    // 一次分配所有的文件名
+    uint64_t firstnum = 0;
+    {
+        std::unique_lock<std::mutex> lk(mtx_);
+        firstnum = currentmaxfilenum_.fetch_add(recycles.size()) + 1;
+    }
+
+    std::vector<uint64_t> recycled;
+    recycled.reserve(recycles.size());
+    for (size_t i = 0; i < recycles.size(); ++i) {
+        uint64_t newfilenum = firstnum + i;
+        std::string targetpath = currentdir_ + "/" +
+                                 std::to_string(newfilenum);
+        int ret = fsptr_->Rename(recycles[i]->c_str(), targetpath.c_str());
+        if (ret < 0) {
+            LOG(ERROR) << "file rename failed, " << *recycles[i];
+            result = -1;
+            continue;
+        }
+        recycled.push_back(newfilenum);
+    }
+
+    std::unique_lock<std::mutex> lk(mtx_);
+    tmpChunkvec_.insert(tmpChunkvec_.end(), recycled.begin(), recycled.end());
+    currentState_.preallocatedChunksLeft += recycled.size();
+    LOG(INFO) << "Recycle " << recycled.size() << " chunks"
+              << ", now chunkpool size = " << tmpChunkvec_.size();
+    return result;
+}
+
+bool ChunkfilePool::IsValidRecycleChunk(const std::string& chunkpath) {
+    uint64_t chunklen = chunkPoolOpt_.chunkSize+chunkPoolOpt_.metaPageSize;
+    int fd = fsptr_->Open(chunkpath.c_str(), O_RDWR);
+    if (fd < 0) {
+        LOG(ERROR) << "file open failed! delete file dirctly"
+                   << ", filename = " << chunkpath.c_str();
+        return false;
+    }
+
+    struct stat info;
+    int ret = fsptr_->Fstat(fd, &info);
+    if (ret != 0) {
+        LOG(ERROR)  << "Fstat file " << chunkpath.c_str()
+                    << "failed, ret = " << ret
+                    << ", delete file dirctly";
+        fsptr_->Close(fd);
+        return false;
+    }
+
+    if (info.st_size != chunklen) {
+        LOG(ERROR) << "file size illegal, " << chunkpath.c_str()
+                      << ", delete file dirctly"
+                      << ", standard size = " << chunklen
+                      << ", current file size = " << info.st_size;
+        fsptr_->Close(fd);
+        return false;
+    }
+
+    fsptr_->Close(fd);
+    return true;
+}
+
 void ChunkfilePool::UnInitialize() {
     currentdir_         = "";
 
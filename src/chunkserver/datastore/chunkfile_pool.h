@@ -168,6 +168,12 @@ class CURVE_CACHELINE_ALIGNMENT ChunkfilePool {
      * @param: chunkpath是需要回收的chunk路径
      */
     virtual int RecycleChunk(const std::string& chunkpath);
+    /**
+     * 批量回收chunk，一次分配所有文件名并一次加入chunkfile pool
+     * @param: chunkpaths是需要回收的chunk路径
+     * @return: 全部回收成功返回0，否则返回-1
+     */
+    virtual int RecycleChunks(const std::vector<std::string>& chunkpaths);
     /**
      * 获取当前chunkfile pool大小
      */
@@ -212,6 +218,12 @@ class CURVE_CACHELINE_ALIGNMENT ChunkfilePool {
      * @return: 成功返回0，否则返回小于0
      */
     int AllocateChunk(const std::string& chunkpath);
+    /**
+     * 检查待回收的文件大小是否符合要求
+     * @param: chunkpath为待回收的chunk文件路径
+     * @return: 符合要求返回true，否则返回false
+     */
+    bool IsValidRecycleChunk(const std::string& chunkpath);
 
  private:
     // 保护tmpChunkvec_
@@ -550,6 +550,34 @@ CSErrorCode CSChunkFile::ReadSpecifiedChunk(SequenceNum sn,
 
 CSErrorCode CSChunkFile::Delete(SequenceNum sn)  {
     WriteLockGuard writeGuard(rwLock_);
+    CSErrorCode errorCode = prepareDelete(sn);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
+
+    int ret = chunkfilePool_->RecycleChunk(path());
+    if (ret < 0)
+        return CSErrorCode::InternalError;
+
+    LOG(INFO) << "Chunk deleted."
+              << "ChunkID: " << chunkId_
+              << ", request sn: " << sn
+              << ", chunk sn: " << metaPage_.sn;
+    return CSErrorCode::Success;
+}
+
+CSErrorCode CSChunkFile::DeleteWithoutRecycle(SequenceNum sn,
+                                              string* chunkPath)  {
+    WriteLockGuard writeGuard(rwLock_);
+    CSErrorCode errorCode = prepareDelete(sn);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
+    *chunkPath = path();
+    return CSErrorCode::Success;
+}
+
+CSErrorCode CSChunkFile::prepareDelete(SequenceNum sn) {
     // 如果 sn 小于当前chunk的版本号，不允许删除
     if (sn < metaPage_.sn) {
         LOG(WARNING) << "Delete chunk failed, backward request."
@@ -577,6 +605,37 @@ CSErrorCode CSChunkFile::Delete(SequenceNum sn)  {
         snapshot_ = nullptr;
     }
 
+    if (fd_ >= 0) {
+        lfs_->Close(fd_);
+        fd_ = -1;
+    }
+    return CSErrorCode::Success;
+}
+
+CSErrorCode CSChunkFile::Discard(SequenceNum sn)  {
+    WriteLockGuard writeGuard(rwLock_);
+    // correctSn_和sn_中最大值可以表示chunk文件的真实版本号
+    SequenceNum chunkSn = std::max(metaPage_.correctedSn, metaPage_.sn);
+    if (sn < chunkSn) {
+        LOG(WARNING) << "Discard chunk failed, backward request."
+                     << "ChunkID: " << chunkId_
+                     << ", request sn: " << sn
+                     << ", chunk sn: " << chunkSn;
+        return CSErrorCode::BackwardRequestError;
+    }
+
+    // 请求版本大于chunk版本说明文件打过快照且chunk还未转储，
+    // 快照和clone chunk未写过的部分都还需要读取chunk的数据
+    if (snapshot_ != nullptr || sn > chunkSn || isCloneChunk_) {
+        DVLOG(3) << "Chunk is referenced, skip discard."
+                 << "ChunkID: " << chunkId_
+                 << ", request sn: " << sn
+                 << ", chunk sn: " << chunkSn
+                 << ", has snapshot: " << (snapshot_ != nullptr)
+                 << ", is clone chunk: " << isCloneChunk_;
+        return CSErrorCode::SnapshotExistError;
+    }
+
     if (fd_ >= 0) {
         lfs_->Close(fd_);
         fd_ = -1;
@@ -585,7 +644,7 @@ CSErrorCode CSChunkFile::Delete(SequenceNum sn)  {
     if (ret < 0)
         return CSErrorCode::InternalError;
 
-    LOG(INFO) << "Chunk deleted."
+    LOG(INFO) << "Chunk discarded."
               << "ChunkID: " << chunkId_
               << ", request sn: " << sn
               << ", chunk sn: " << metaPage_.sn;
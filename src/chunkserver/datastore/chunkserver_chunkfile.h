@@ -190,6 +190,23 @@ class CSChunkFile {
      * @return: 返回错误码
      */
     CSErrorCode Delete(SequenceNum sn);
+    /**
+     * 批量删除chunk时使用，与Delete相同但不回收chunk文件，
+     * 由调用方将返回的文件路径批量回收到chunkfilepool
+     * @param: 调用DeleteChunks接口时的文件版本号
+     * @param: chunkPath返回chunk文件的路径
+     * @return: 返回错误码
+     */
+    CSErrorCode DeleteWithoutRecycle(SequenceNum sn, string* chunkPath);
+    /**
+     * discard chunk文件，chunk的数据不再被使用时将其删除并回收到chunkfilepool
+     * 存在快照、快照转储尚未完成或者是clone chunk时chunk的数据仍可能被读取，
+     * 此时保留chunk并返回SnapshotExistError
+     * 正常不存在并发，与其他操作互斥，加写锁
+     * @param: 调用DiscardChunk接口时的文件版本号
+     * @return: 返回错误码
+     */
+    CSErrorCode Discard(SequenceNum sn);
     /**
      * 删除此次转储时产生的或者历史遗留的快照
      * 如果转储过程中没有产生快照，则修改chunk的correctedSn
@@ -248,6 +265,12 @@ class CSChunkFile {
      * 如果所有的page都已写过，则将clone chunk转成普通chunk
      */
     CSErrorCode flush();
+    /**
+     * 检查版本号并删除快照、关闭chunk文件，调用方需要持有写锁
+     * @param sn: 删除请求的版本号
+     * @return: 返回错误码
+     */
+    CSErrorCode prepareDelete(SequenceNum sn);
 
     inline string path() {
         return baseDir_ + "/" +
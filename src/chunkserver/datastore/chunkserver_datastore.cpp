@@ -126,6 +126,53 @@ CSErrorCode CSDataStore::DeleteChunk(ChunkID id, SequenceNum sn) {
     return CSErrorCode::Success;
 }
 
+CSErrorCode CSDataStore::DeleteChunks(const std::vector<ChunkID>& ids,
+                                      SequenceNum sn) {
+    CSErrorCode result = CSErrorCode::Success;
+    std::vector<std::string> chunkPaths;
+    chunkPaths.reserve(ids.size());
+    for (auto id : ids) {
+        auto chunkFile = metaCache_.Get(id);
+        if (chunkFile == nullptr) {
+            continue;
+        }
+        std::string chunkPath;
+        CSErrorCode errorCode = chunkFile->DeleteWithoutRecycle(sn,
+                                                                &chunkPath);
+        if (errorCode != CSErrorCode::Success) {
+            LOG(WARNING) << "Delete chunk file failed."
+                         << "ChunkID = " << id;
+            if (result == CSErrorCode::Success ||
+                errorCode == CSErrorCode::InternalError) {
+                result = errorCode;
+            }
+            continue;
+        }
+        metaCache_.Remove(id);
+        chunkPaths.push_back(chunkPath);
+    }
+
+    if (!chunkPaths.empty() &&
+        chunkfilePool_->RecycleChunks(chunkPaths) < 0) {
+        LOG(ERROR) << "Recycle chunk files failed, count = "
+                   << chunkPaths.size();
+        return CSErrorCode::InternalError;
+    }
+    return result;
+}
+
+CSErrorCode CSDataStore::DiscardChunk(ChunkID id, SequenceNum sn) {
+    auto chunkFile = metaCache_.Get(id);
+    if (chunkFile != nullptr) {
+        CSErrorCode errorCode = chunkFile->Discard(sn);
+        if (errorCode != CSErrorCode::Success) {
+            return errorCode;
+        }
+        metaCache_.Remove(id);
+    }
+    return CSErrorCode::Success;
+}
+
 CSErrorCode CSDataStore::DeleteSnapshotChunkOrCorrectSn(
     ChunkID id, SequenceNum correctedSn) {
     auto chunkFile = metaCache_.Get(id);
@@ -154,6 +154,23 @@ class CSDataStore {
      * @return：返回错误码
      */
     virtual CSErrorCode DeleteChunk(ChunkID id, SequenceNum sn);
+    /**
+     * 批量删除chunk文件，删除的chunk文件一次回收到chunkfilepool
+     * 不存在的chunk视为删除成功，某个chunk删除失败时继续删除其余的chunk
+     * @param ids：要删除的chunk的id列表
+     * @param sn：用于记录trace，如果sn<chunk的sn，则不允许删除
+     * @return：全部成功返回Success，否则返回第一个失败的错误码，
+     *          回收失败或者存在InternalError时返回InternalError
+     */
+    virtual CSErrorCode DeleteChunks(const std::vector<ChunkID>& ids,
+                                     SequenceNum sn);
+    /**
+     * discard当前chunk文件，chunk不存在时返回成功
+     * @param id：要discard的chunk的id
+     * @param sn：当前用户文件的版本号，如果sn<chunk的sn，则不允许discard
+     * @return：返回错误码，chunk被快照或clone使用时返回SnapshotExistError
+     */
+    virtual CSErrorCode DiscardChunk(ChunkID id, SequenceNum sn);
     /**
      * 删除此次转储时产生的或者历史遗留的快照
      * 如果转储过程中没有产生快照，则修改chunk的correctedSn
@@ -92,6 +92,11 @@ int Heartbeat::Init(const HeartbeatOptions &options) {
 
     // 获取当前unix时间戳
     startUpTime_ = ::curve::common::TimeUtility::GetTimeofDaySec();
+
+    heartbeatSeq_ = 0;
+    needFullHeartbeat_ = true;
+    heartbeatsSinceFull_ = 0;
+    lastReportedCopysets_.clear();
     return 0;
 }
 
@@ -279,6 +284,17 @@ int Heartbeat::BuildRequest(HeartbeatRequest* req) {
     }
     req->set_leadercount(leaders);
 
+    if (options_.enableDelta) {
+        req->set_heartbeatseq(++heartbeatSeq_);
+        bool forceFull = needFullHeartbeat_ ||
+                         heartbeatsSinceFull_ + 1 >= options_.fullInterval;
+        bool isDelta = HeartbeatHelper::BuildDeltaCopysets(
+            req, forceFull, &lastReportedCopysets_);
+        req->set_isdelta(isDelta);
+        needFullHeartbeat_ = false;
+        heartbeatsSinceFull_ = isDelta ? heartbeatsSinceFull_ + 1 : 0;
+    }
+
     return 0;
 }
 
@@ -287,7 +303,10 @@ void Heartbeat::DumpHeartbeatRequest(const HeartbeatRequest& request) {
              << request.chunkserverid()
              << ", IP: " << request.ip() << ", port: " << request.port()
              << ", copyset count: " << request.copysetcount()
-             << ", leader count: " << request.leadercount();
+             << ", leader count: " << request.leadercount()
+             << ", seq: " << request.heartbeatseq()
+             << ", delta: " << request.isdelta()
+             << ", reported copyset count: " << request.copysetinfos_size();
     for (int i = 0; i < request.copysetinfos_size(); i ++) {
         const curve::mds::heartbeat::CopySetInfo& info =
             request.copysetinfos(i);
@@ -519,10 +538,18 @@ void Heartbeat::HeartbeatWorker() {
         ret = SendHeartbeat(req, &resp);
         if (ret != 0) {
             LOG(WARNING) << "Failed to send heartbeat to MDS";
+            // mds不一定收到了本次心跳，下一次发送全量心跳
+            needFullHeartbeat_ = true;
             ::sleep(errorIntervalSec);
             continue;
         }
 
+        // mds要求全量心跳，或者有copyset没有处理成功
+        if (resp.needfullheartbeat() ||
+            resp.statuscode() != curve::mds::heartbeat::hbOK) {
+            needFullHeartbeat_ = true;
+        }
+
         LOG(INFO) << "executing heartbeat info";
         ret = ExecTask(resp);
         if (ret != 0) {
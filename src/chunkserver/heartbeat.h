@@ -70,6 +70,10 @@ struct HeartbeatOptions {
     uint32_t                port;
     uint32_t                intervalSec;
     uint32_t                timeout;
+    // 是否开启增量心跳，开启后只上报发生变化的copyset
+    bool                    enableDelta;
+    // 开启增量心跳时，每隔多少次心跳发送一次全量心跳
+    uint32_t                fullInterval;
     CopysetNodeManager*     copysetNodeManager;
 
     std::shared_ptr<LocalFileSystem> fs;
@@ -186,6 +190,16 @@ class Heartbeat {
 
     // 模块初始化时间, unix时间
     uint64_t startUpTime_;
+
+    // 以下用于增量心跳，只在心跳线程中访问
+    // 心跳序号
+    uint64_t heartbeatSeq_;
+    // 下一次是否需要发送全量心跳
+    bool needFullHeartbeat_;
+    // 距离上一次全量心跳发送的心跳次数
+    uint32_t heartbeatsSinceFull_;
+    // 上一次上报的copyset信息
+    std::map<GroupNid, std::string> lastReportedCopysets_;
 };
 
 }  // namespace chunkserver
@@ -23,7 +23,9 @@
 #include <butil/endpoint.h>
 #include <brpc/channel.h>
 #include <brpc/controller.h>
+#include <algorithm>
 #include <string>
+#include <utility>
 #include "src/chunkserver/heartbeat_helper.h"
 #include "include/chunkserver/chunkserver_common.h"
 #include "proto/chunkserver.pb.h"
@@ -139,6 +141,39 @@ bool HeartbeatHelper::ChunkServerLoadCopySetFin(const std::string peerId) {
     return rep.copysetloadfin();
 }
 
+bool HeartbeatHelper::BuildDeltaCopysets(ChunkServerHeartbeatRequest *request,
+    bool forceFull, std::map<GroupNid, std::string> *lastReported) {
+    std::map<GroupNid, std::string> reported;
+    for (const auto &info : request->copysetinfos()) {
+        reported.emplace(ToGroupNid(info.logicalpoolid(), info.copysetid()),
+                         info.SerializeAsString());
+    }
+
+    // copyset集合变化时发送全量心跳，不需要单独上报删除的copyset
+    bool isDelta = !forceFull && reported.size() == lastReported->size() &&
+        std::equal(reported.begin(), reported.end(), lastReported->begin(),
+            [](const std::pair<const GroupNid, std::string> &a,
+               const std::pair<const GroupNid, std::string> &b) {
+                return a.first == b.first;
+            });
+    if (isDelta) {
+        auto *infos = request->mutable_copysetinfos();
+        int changed = 0;
+        for (int i = 0; i < infos->size(); ++i) {
+            const auto &info = infos->Get(i);
+            GroupNid nid = ToGroupNid(info.logicalpoolid(), info.copysetid());
+            if (reported[nid] != (*lastReported)[nid]) {
+                infos->SwapElements(i, changed++);
+            }
+        }
+        while (infos->size() > changed) {
+            infos->RemoveLast();
+        }
+    }
+    lastReported->swap(reported);
+    return isDelta;
+}
+
 }  // namespace chunkserver
 }  // namespace curve
 
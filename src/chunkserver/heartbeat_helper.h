@@ -24,6 +24,7 @@
 #define SRC_CHUNKSERVER_HEARTBEAT_HELPER_H_
 
 #include <braft/node_manager.h>
+#include <map>
 #include <vector>
 #include <memory>
 #include <string>
@@ -33,6 +34,7 @@
 namespace curve {
 namespace chunkserver {
 using ::curve::mds::heartbeat::CopySetConf;
+using ::curve::mds::heartbeat::ChunkServerHeartbeatRequest;
 using ::curve::common::Peer;
 using CopysetNodePtr = std::shared_ptr<CopysetNode>;
 
@@ -90,6 +92,22 @@ class HeartbeatHelper {
      * @return false-copyset加载完毕 true-copyset未加载完成
      */
     static bool ChunkServerLoadCopySetFin(const std::string ipPort);
+
+    /**
+     * 把心跳请求中的copyset信息过滤为增量信息，只保留与上一次上报相比
+     * epoch、leader、peers、配置变更或统计信息发生变化的copyset
+     * chunkserver上的copyset集合发生变化(创建或删除了copyset)时不过滤
+     *
+     * @param[in,out] request 心跳请求，调用前copysetInfos为全量信息
+     * @param[in] forceFull 为true时不过滤，只记录本次上报的信息
+     * @param[in,out] lastReported 上一次上报的copyset信息，key为copyset的
+     *                GroupNid，value为序列化后的CopySetInfo，返回时更新为
+     *                本次的全量信息
+     *
+     * @return true-request已过滤为增量信息 false-request为全量信息
+     */
+    static bool BuildDeltaCopysets(ChunkServerHeartbeatRequest *request,
+        bool forceFull, std::map<GroupNid, std::string> *lastReported);
 };
 }  // namespace chunkserver
 }  // namespace curve
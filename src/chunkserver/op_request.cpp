@@ -29,11 +29,13 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "src/chunkserver/copyset_node.h"
 #include "src/chunkserver/chunk_closure.h"
 #include "src/chunkserver/clone_manager.h"
 #include "src/chunkserver/clone_task.h"
+#include "src/common/crc32.h"
 
 namespace curve {
 namespace chunkserver {
@@ -159,6 +161,10 @@ std::shared_ptr<ChunkOpRequest> ChunkOpRequest::Decode(butil::IOBuf log,
             return std::make_shared<WriteChunkRequest>();
         case CHUNK_OP_TYPE::CHUNK_OP_DELETE:
             return std::make_shared<DeleteChunkRequest>();
+        case CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH:
+            return std::make_shared<DeleteChunksRequest>();
+        case CHUNK_OP_TYPE::CHUNK_OP_DISCARD:
+            return std::make_shared<DiscardChunkRequest>();
         case CHUNK_OP_TYPE::CHUNK_OP_READ_SNAP:
             return std::make_shared<ReadSnapshotRequest>();
         case CHUNK_OP_TYPE::CHUNK_OP_DELETE_SNAP:
@@ -225,6 +231,125 @@ void DeleteChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
     }
 }
 
+void DeleteChunksRequest::OnApply(uint64_t index,
+                                  ::google::protobuf::Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
+
+    std::vector<ChunkID> ids(request_->chunkids().begin(),
+                             request_->chunkids().end());
+    auto ret = datastore_->DeleteChunks(ids, request_->sn());
+    if (CSErrorCode::Success == ret) {
+        response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        node_->UpdateAppliedIndex(index);
+    } else if (CSErrorCode::InternalError == ret) {
+        LOG(FATAL) << "delete chunks failed: "
+                   << " logic pool id: " << request_->logicpoolid()
+                   << " copyset id: " << request_->copysetid()
+                   << " chunk count: " << ids.size()
+                   << " data store return: " << ret;
+    } else {
+        // 其余的chunk已经删除，重试时不存在的chunk视为删除成功
+        LOG(ERROR) << "delete chunks failed: "
+                   << " logic pool id: " << request_->logicpoolid()
+                   << " copyset id: " << request_->copysetid()
+                   << " chunk count: " << ids.size()
+                   << " data store return: " << ret;
+        response_->set_status(
+            CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
+    }
+    auto maxIndex =
+        (index > node_->GetAppliedIndex() ? index : node_->GetAppliedIndex());
+    response_->set_appliedindex(maxIndex);
+}
+
+void DeleteChunksRequest::OnApplyFromLog(
+    std::shared_ptr<CSDataStore> datastore,
+    const ChunkRequest &request,
+    const butil::IOBuf &data) {
+    // NOTE: 处理过程中优先使用参数传入的datastore/request
+    std::vector<ChunkID> ids(request.chunkids().begin(),
+                             request.chunkids().end());
+    auto ret = datastore->DeleteChunks(ids, request.sn());
+    if (CSErrorCode::Success == ret)
+        return;
+
+    if (CSErrorCode::InternalError == ret) {
+        LOG(FATAL) << "delete chunks failed: "
+                   << request.logicpoolid() << ", "
+                   << request.copysetid()
+                   << " chunk count: " << ids.size()
+                   << " data store return: " << ret;
+    } else {
+        LOG(ERROR) << "delete chunks failed: "
+                   << request.logicpoolid() << ", "
+                   << request.copysetid()
+                   << " chunk count: " << ids.size()
+                   << " data store return: " << ret;
+    }
+}
+
+void DiscardChunkRequest::OnApply(uint64_t index,
+                                  ::google::protobuf::Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
+
+    auto ret = datastore_->DiscardChunk(request_->chunkid(),
+                                        request_->sn());
+    if (CSErrorCode::Success == ret) {
+        response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        node_->UpdateAppliedIndex(index);
+    } else if (CSErrorCode::SnapshotExistError == ret) {
+        // chunk仍被快照或clone使用，保留chunk
+        response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_EXIST);
+        node_->UpdateAppliedIndex(index);
+    } else if (CSErrorCode::BackwardRequestError == ret) {
+        // 返回错误给客户端，让客户端带新版本来重试
+        response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_BACKWARD);
+    } else if (CSErrorCode::InternalError == ret) {
+        LOG(FATAL) << "discard chunk failed: "
+                   << " logic pool id: " << request_->logicpoolid()
+                   << " copyset id: " << request_->copysetid()
+                   << " chunkid: " << request_->chunkid()
+                   << " data store return: " << ret;
+    } else {
+        LOG(ERROR) << "discard chunk failed: "
+                   << " logic pool id: " << request_->logicpoolid()
+                   << " copyset id: " << request_->copysetid()
+                   << " chunkid: " << request_->chunkid()
+                   << " data store return: " << ret;
+        response_->set_status(
+            CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
+    }
+    auto maxIndex =
+        (index > node_->GetAppliedIndex() ? index : node_->GetAppliedIndex());
+    response_->set_appliedindex(maxIndex);
+}
+
+void DiscardChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
+                                         const ChunkRequest &request,
+                                         const butil::IOBuf &data) {
+    // NOTE: 处理过程中优先使用参数传入的datastore/request
+    auto ret = datastore->DiscardChunk(request.chunkid(),
+                                       request.sn());
+    if (CSErrorCode::Success == ret ||
+        CSErrorCode::SnapshotExistError == ret ||
+        CSErrorCode::BackwardRequestError == ret)
+        return;
+
+    if (CSErrorCode::InternalError == ret) {
+        LOG(FATAL) << "discard failed: "
+                   << request.logicpoolid() << ", "
+                   << request.copysetid()
+                   << " chunkid: " << request.chunkid()
+                   << " data store return: " << ret;
+    } else {
+        LOG(ERROR) << "discard failed: "
+                   << request.logicpoolid() << ", "
+                   << request.copysetid()
+                   << " chunkid: " << request.chunkid()
+                   << " data store return: " << ret;
+    }
+}
+
 ReadChunkRequest::ReadChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
                                    CloneManager* cloneMgr,
                                    RpcController *cntl,
@@ -234,15 +359,30 @@ ReadChunkRequest::ReadChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
     ChunkOpRequest(nodePtr, cntl, request, response, done),
     cloneMgr_(cloneMgr),
     concurrentApplyModule_(nodePtr->GetConcurrentApplyModule()),
-    applyIndex(0) {
+    applyIndex(0),
+    followerRead_(false) {
+}
+
+bool ReadChunkRequest::CanFollowerRead() {
+    /**
+     * client的对冲读会发往follower，applied index不小于client携带的
+     * applied index时，follower上已经有client之前写入的全部数据，可以直接读
+     */
+    return request_->allowfollowerread()
+        && request_->optype() == CHUNK_OP_TYPE::CHUNK_OP_READ
+        && request_->has_appliedindex()
+        && node_->GetAppliedIndex() >= request_->appliedindex();
 }
 
 void ReadChunkRequest::Process() {
     brpc::ClosureGuard doneGuard(done_);
 
     if (!node_->IsLeaderTerm()) {
-        RedirectChunkRequest();
-        return;
+        if (!CanFollowerRead()) {
+            RedirectChunkRequest();
+            return;
+        }
+        followerRead_ = true;
     }
 
     /**
@@ -325,6 +465,11 @@ void ReadChunkRequest::OnApply(uint64_t index,
         }
         // 如果需要从源端拷贝数据，需要将请求转发给clone manager处理
         if ( needLazyClone || NeedClone(chunkInfo) ) {
+            // 拷贝的数据需要由leader写入chunk，follower上的读让client去leader读
+            if (followerRead_) {
+                RedirectChunkRequest();
+                break;
+            }
             applyIndex = index;
             std::shared_ptr<CloneTask> cloneTask =
             cloneMgr_->GenerateCloneTask(
@@ -408,6 +553,9 @@ void ReadChunkRequest::ReadChunk() {
     butil::IOBuf wrapper;
     wrapper.append_user_data(readBuffer, size, ReadBufferDeleter);
     if (CSErrorCode::Success == ret) {
+        if (request_->needcrc()) {
+            response_->set_crc32(curve::common::CRC32(readBuffer, size));
+        }
         cntl_->response_attachment().append(wrapper);
         response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
     } else if (CSErrorCode::ChunkNotExistError == ret) {
@@ -199,6 +199,54 @@ class DeleteChunkRequest : public ChunkOpRequest {
                         const butil::IOBuf &data) override;
 };
 
+/**
+ * 批量删除同一个copyset中的多个chunk，不按chunk id放入并发apply的队列，
+ * 由CopysetNode::on_apply等待之前的op全部apply完成后直接执行
+ */
+class DeleteChunksRequest : public ChunkOpRequest {
+ public:
+    DeleteChunksRequest() :
+        ChunkOpRequest() {}
+    DeleteChunksRequest(std::shared_ptr<CopysetNode> nodePtr,
+                        RpcController *cntl,
+                        const ChunkRequest *request,
+                        ChunkResponse *response,
+                        ::google::protobuf::Closure *done) :
+        ChunkOpRequest(nodePtr,
+                       cntl,
+                       request,
+                       response,
+                       done) {}
+    virtual ~DeleteChunksRequest() = default;
+
+    void OnApply(uint64_t index, ::google::protobuf::Closure *done) override;
+    void OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
+                        const ChunkRequest &request,
+                        const butil::IOBuf &data) override;
+};
+
+class DiscardChunkRequest : public ChunkOpRequest {
+ public:
+    DiscardChunkRequest() :
+        ChunkOpRequest() {}
+    DiscardChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
+                        RpcController *cntl,
+                        const ChunkRequest *request,
+                        ChunkResponse *response,
+                        ::google::protobuf::Closure *done) :
+        ChunkOpRequest(nodePtr,
+                       cntl,
+                       request,
+                       response,
+                       done) {}
+    virtual ~DiscardChunkRequest() = default;
+
+    void OnApply(uint64_t index, ::google::protobuf::Closure *done) override;
+    void OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
+                        const ChunkRequest &request,
+                        const butil::IOBuf &data) override;
+};
+
 class ReadChunkRequest : public ChunkOpRequest {
     friend class CloneCore;
     friend class PasteChunkInternalRequest;
@@ -230,6 +278,8 @@ class ReadChunkRequest : public ChunkOpRequest {
     bool NeedClone(const CSChunkInfo& chunkInfo);
     // 从chunk文件中读数据
     void ReadChunk();
+    // 是否可以在follower上直接读
+    bool CanFollowerRead();
 
  private:
     CloneManager* cloneMgr_;
@@ -237,6 +287,8 @@ class ReadChunkRequest : public ChunkOpRequest {
     ConcurrentApplyModule* concurrentApplyModule_;
     // 保存 apply index
     uint64_t applyIndex;
+    // 是否是在follower上直接读
+    bool followerRead_;
 };
 
 class WriteChunkRequest : public ChunkOpRequest {
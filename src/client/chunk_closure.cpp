@@ -36,6 +36,8 @@
 #include "src/client/request_closure.h"
 #include "src/client/request_context.h"
 #include "src/client/io_tracker.h"
+#include "src/client/splitor.h"
+#include "src/common/crc32.h"
 
 // TODO(tongguangxun) :优化重试逻辑，将重试逻辑与RPC返回逻辑拆开
 namespace curve {
@@ -210,6 +212,7 @@ void ClientClosure::Run() {
     fileMetric_ = reqDone_->GetMetric();
     reqCtx_ = reqDone_->GetReqCtx();
     chunkIdInfo_ = reqCtx_->idinfo_;
+    reqCtx_->trace_.OnRpcDone();
     status_ = -1;
     cntlstatus_ = cntl_->ErrorCode();
     remoteAddress_ = butil::endpoint2str(cntl_->remote_side()).c_str();
@@ -226,6 +229,12 @@ void ClientClosure::Run() {
 
         status_ = GetResponseStatus();
 
+        // 返回数据的CRC校验失败时与chunkserver返回CRC_FAIL一样处理
+        if (status_ == CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS &&
+            !CheckResponseCrc()) {
+            status_ = CHUNK_OP_STATUS::CHUNK_OP_STATUS_CRC_FAIL;
+        }
+
         switch (status_) {
         // 1. 请求成功
         case CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS:
@@ -257,7 +266,8 @@ void ClientClosure::Run() {
 
         // 2.5 返回backward
         case CHUNK_OP_STATUS::CHUNK_OP_STATUS_BACKWARD:
-            if (reqCtx_->optype_ == OpType::WRITE) {
+            if (reqCtx_->optype_ == OpType::WRITE ||
+                reqCtx_->optype_ == OpType::DISCARD) {
                 needRetry = true;
                 OnBackward();
             } else {
@@ -277,6 +287,12 @@ void ClientClosure::Run() {
             OnChunkExist();
             break;
 
+        // 2.7 数据CRC校验失败，数据在传输过程中损坏，重试
+        case CHUNK_OP_STATUS::CHUNK_OP_STATUS_CRC_FAIL:
+            needRetry = true;
+            OnCrcFail();
+            break;
+
         default:
             needRetry = true;
             LOG_EVERY_N(ERROR, 10) << OpTypeToString(reqCtx_->optype_)
@@ -363,6 +379,15 @@ void ClientClosure::OnSuccess() {
     MetricHelper::LatencyRecord(fileMetric_, duration, reqCtx_->optype_);
     MetricHelper::IncremRPCQPSCount(
         fileMetric_, reqCtx_->rawlength_, reqCtx_->optype_);
+
+    if (reqCtx_->optype_ == OpType::READ ||
+        reqCtx_->optype_ == OpType::WRITE) {
+        Splitor::RecordRPC(reqCtx_->rawlength_, duration);
+    }
+
+    if (reqCtx_->optype_ == OpType::READ) {
+        HedgeReadHelper::GetInstance().RecordLatency(chunkserverID_, duration);
+    }
 }
 
 void ClientClosure::OnChunkNotExist() {
@@ -452,6 +477,7 @@ void ClientClosure::OnRetry() {
     }
 
     PreProcessBeforeRetry(status_, cntlstatus_);
+    reqCtx_->trace_.OnRetry();
     SendRetryRequest();
 }
 
@@ -501,6 +527,16 @@ void ClientClosure::OnInvalidRequest() {
     MetricHelper::IncremFailRPCCount(fileMetric_, reqCtx_->optype_);
 }
 
+void ClientClosure::OnCrcFail() {
+    LOG(ERROR) << OpTypeToString(reqCtx_->optype_)
+        << " crc check failed, " << *reqCtx_
+        << ", retried times = " << reqDone_->GetRetriedTimes()
+        << ", IO id = " << reqDone_->GetIOTracker()->GetID()
+        << ", request id = " << reqCtx_->id_
+        << ", remote side = " << remoteAddress_;
+    MetricHelper::IncremCrcMismatchCount(fileMetric_, reqCtx_->optype_);
+}
+
 void WriteChunkClosure::SendRetryRequest() {
     client_->WriteChunk(reqCtx_->idinfo_, reqCtx_->seq_,
                         reqCtx_->writeBuffer_,
@@ -528,12 +564,41 @@ void ReadChunkClosure::SendRetryRequest() {
                        done_);
 }
 
+void ReadChunkClosure::Run() {
+    if (hedgeState_ == nullptr || !hedgeState_->HedgeSucceeded()) {
+        ClientClosure::Run();
+        return;
+    }
+
+    // 对冲读成功后当前请求被取消或者不再发送，用对冲读的数据返回
+    std::unique_ptr<ReadChunkClosure> selfGuard(this);
+    std::unique_ptr<brpc::Controller> cntlGuard(cntl_);
+    brpc::ClosureGuard doneGuard(done_);
+
+    RequestClosure* reqDone = static_cast<RequestClosure*>(done_);
+    RequestContext* reqCtx = reqDone->GetReqCtx();
+    FileMetric* fileMetric = reqDone->GetMetric();
+    reqCtx->trace_.OnRpcDone();
+
+    butil::IOBuf data = hedgeState_->GetHedgeData();
+    reqCtx->SetReadData(&data);
+    reqDone->SetFailed(0);
+
+    auto duration = TimeUtility::GetTimeofDayUs() - reqDone->GetStartTime();
+    MetricHelper::LatencyRecord(fileMetric, duration, reqCtx->optype_);
+    MetricHelper::IncremRPCQPSCount(
+        fileMetric, reqCtx->rawlength_, reqCtx->optype_);
+    MetricHelper::IncremHedgeReadWinCount(fileMetric);
+
+    DVLOG(3) << "hedge read win, " << *reqCtx
+             << ", IO id = " << reqDone->GetIOTracker()->GetID()
+             << ", request id = " << reqCtx->id_;
+}
+
 void ReadChunkClosure::OnSuccess() {
     ClientClosure::OnSuccess();
 
-    cntl_->response_attachment().copy_to(
-        reqCtx_->readBuffer_,
-        cntl_->response_attachment().size());
+    reqCtx_->SetReadData(&cntl_->response_attachment());
 
     metaCache_->UpdateAppliedIndex(
         reqCtx_->idinfo_.lpid_,
@@ -541,15 +606,50 @@ void ReadChunkClosure::OnSuccess() {
         response_->appliedindex());
 }
 
+bool ReadChunkClosure::CheckResponseCrc() {
+    if (!response_->has_crc32()) {
+        return true;
+    }
+
+    uint64_t start = TimeUtility::GetTimeofDayUs();
+    uint32_t crc = curve::common::CRC32(cntl_->response_attachment());
+    MetricHelper::CrcComputeRecord(
+        fileMetric_, TimeUtility::GetTimeofDayUs() - start);
+    return crc == response_->crc32();
+}
+
 void ReadChunkClosure::OnChunkNotExist() {
     ClientClosure::OnChunkNotExist();
 
     reqDone_->SetFailed(0);
-    memset(reqCtx_->readBuffer_, 0, reqCtx_->rawlength_);
+    reqCtx_->SetReadZero();
     metaCache_->UpdateAppliedIndex(chunkIdInfo_.lpid_, chunkIdInfo_.cpid_,
                                    response_->appliedindex());
 }
 
+void HedgeReadClosure::Run() {
+    std::unique_ptr<HedgeReadClosure> selfGuard(this);
+
+    if (cntl_.Failed() ||
+        response_.status() != CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS) {
+        DVLOG(3) << "hedge read failed, chunkserver id = " << chunkserverID_
+                 << ", error code = " << cntl_.ErrorCode()
+                 << ", status = " << response_.status();
+        return;
+    }
+
+    if (response_.has_crc32() && response_.crc32() !=
+        curve::common::CRC32(cntl_.response_attachment())) {
+        LOG(ERROR) << "hedge read crc check failed, chunkserver id = "
+                   << chunkserverID_;
+        return;
+    }
+
+    HedgeReadHelper::GetInstance().RecordLatency(
+        chunkserverID_, TimeUtility::GetTimeofDayUs() - startTime_);
+    state_->OnHedgeSuccess(&cntl_.response_attachment());
+}
+
 void ReadChunkSnapClosure::SendRetryRequest() {
     client_->ReadChunkSnapshot(reqCtx_->idinfo_, reqCtx_->seq_,
                                reqCtx_->offset_,
@@ -572,6 +672,34 @@ void DeleteChunkSnapClosure::SendRetryRequest() {
         done_);
 }
 
+void DiscardChunkClosure::SendRetryRequest() {
+    client_->DiscardChunk(reqCtx_->idinfo_, reqCtx_->seq_, done_);
+}
+
+void DiscardChunkClosure::OnSuccess() {
+    ClientClosure::OnSuccess();
+
+    metaCache_->UpdateAppliedIndex(
+        chunkIdInfo_.lpid_,
+        chunkIdInfo_.cpid_,
+        response_->appliedindex());
+}
+
+void DiscardChunkClosure::OnChunkExist() {
+    // chunk被快照或克隆使用而保留，是正常情况，由上层统计
+    reqDone_->SetFailed(status_);
+
+    DVLOG(3) << OpTypeToString(reqCtx_->optype_)
+        << " keep chunk, " << *reqCtx_
+        << ", IO id = " << reqDone_->GetIOTracker()->GetID()
+        << ", request id = " << reqCtx_->id_;
+
+    metaCache_->UpdateAppliedIndex(
+        chunkIdInfo_.lpid_,
+        chunkIdInfo_.cpid_,
+        response_->appliedindex());
+}
+
 void GetChunkInfoClosure::SendRetryRequest() {
     client_->GetChunkInfo(reqCtx_->idinfo_, done_);
 }
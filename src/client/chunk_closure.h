@@ -36,6 +36,7 @@
 #include "src/client/client_config.h"
 #include "src/client/client_common.h"
 #include "src/client/client_metric.h"
+#include "src/client/hedge_read.h"
 #include "src/client/request_closure.h"
 #include "src/common/concurrent/concurrent.h"
 #include "src/client/service_helper.h"
@@ -85,6 +86,29 @@ class UnstableHelper {
         ChunkServerID csId,
         const butil::EndPoint& csEndPoint);
 
+    /**
+     * @brief chunkserver最近是否有超时的请求，或者已经被标记为unstable
+     *
+     * @param: csId chunkserver id
+     * @param: csEndPoint chunkserver的ip:port地址
+     */
+    bool IsSuspect(ChunkServerID csId, const butil::EndPoint& csEndPoint) {
+        std::string ip = butil::ip2str(csEndPoint.ip).c_str();
+
+        lock_.Lock();
+        auto timeoutIter = timeoutTimes_.find(csId);
+        bool suspect = timeoutIter != timeoutTimes_.end() &&
+                       timeoutIter->second > 0;
+        if (!suspect) {
+            auto serverIter = serverUnstabledChunkservers_.find(ip);
+            suspect = serverIter != serverUnstabledChunkservers_.end() &&
+                      serverIter->second.count(csId) > 0;
+        }
+        lock_.UnLock();
+
+        return suspect;
+    }
+
     void ClearTimeout(ChunkServerID csId,
                       const butil::EndPoint& csEndPoint) {
         std::string ip = butil::ip2str(csEndPoint.ip).c_str();
@@ -166,6 +190,14 @@ class ClientClosure : public Closure {
         return chunkserverEndPoint_;
     }
 
+    void SetHedgeReadState(const std::shared_ptr<HedgeReadState>& state) {
+        hedgeState_ = state;
+    }
+
+    const std::shared_ptr<HedgeReadState>& GetHedgeReadState() const {
+        return hedgeState_;
+    }
+
     // 统一Run函数入口
     void Run() override;
 
@@ -191,11 +223,19 @@ class ClientClosure : public Closure {
     virtual void OnChunkNotExist();
 
     // 返回chunk存在 处理函数
-    void OnChunkExist();
+    virtual void OnChunkExist();
 
     // 非法参数
     void OnInvalidRequest();
 
+    // 数据CRC校验失败
+    void OnCrcFail();
+
+    // 校验response中返回数据的CRC，不需要校验或者校验成功时返回true
+    virtual bool CheckResponseCrc() {
+        return true;
+    }
+
     // 发送重试请求
     virtual void SendRetryRequest() = 0;
 
@@ -317,6 +357,9 @@ class ClientClosure : public Closure {
 
     // rpc remote side address
     std::string                         remoteAddress_;
+
+    // 读请求的对冲读状态，没有对冲读时为空
+    std::shared_ptr<HedgeReadState>     hedgeState_;
 };
 
 class WriteChunkClosure : public ClientClosure {
@@ -333,9 +376,44 @@ class ReadChunkClosure : public ClientClosure {
     ReadChunkClosure(CopysetClient *client, Closure *done)
      : ClientClosure(client, done) {}
 
+    // 对冲读已经成功时直接用对冲读的数据返回
+    void Run() override;
     void OnSuccess() override;
     void OnChunkNotExist() override;
     void SendRetryRequest() override;
+    bool CheckResponseCrc() override;
+};
+
+/**
+ * 发往follower的对冲读请求的closure，只操作共享的对冲读状态，不访问上层的
+ * 请求上下文，失败时直接丢弃，由leader读请求继续完成
+ */
+class HedgeReadClosure : public Closure {
+ public:
+    HedgeReadClosure(const std::shared_ptr<HedgeReadState>& state,
+                     ChunkServerID csId)
+        : state_(state), chunkserverID_(csId), startTime_(0) {}
+
+    void Run() override;
+
+    brpc::Controller* GetCntl() {
+        return &cntl_;
+    }
+
+    ChunkResponse* GetResponse() {
+        return &response_;
+    }
+
+    void SetStartTime(uint64_t start) {
+        startTime_ = start;
+    }
+
+ private:
+    std::shared_ptr<HedgeReadState> state_;
+    ChunkServerID chunkserverID_;
+    brpc::Controller cntl_;
+    ChunkResponse response_;
+    uint64_t startTime_;
 };
 
 class ReadChunkSnapClosure : public ClientClosure {
@@ -355,6 +433,16 @@ class DeleteChunkSnapClosure : public ClientClosure {
     void SendRetryRequest() override;
 };
 
+class DiscardChunkClosure : public ClientClosure {
+ public:
+    DiscardChunkClosure(CopysetClient *client, Closure *done)
+     : ClientClosure(client, done) {}
+
+    void OnSuccess() override;
+    void OnChunkExist() override;
+    void SendRetryRequest() override;
+};
+
 class GetChunkInfoClosure : public ClientClosure {
  public:
     GetChunkInfoClosure(CopysetClient *client, Closure *done)
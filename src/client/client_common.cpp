@@ -39,6 +39,8 @@ const char* OpTypeToString(OpType optype) {
         return "RecoverChunk";
     case OpType::GET_CHUNK_INFO:
         return "GetChunkInfo";
+    case OpType::DISCARD:
+        return "Discard";
     case OpType::UNKNOWN:
     default:
         return "Unknown";
@@ -33,6 +33,7 @@
 #include <vector>
 
 #include "include/client/libcurve.h"
+#include "src/client/config_info.h"
 #include "src/common/net_common.h"
 
 namespace curve {
@@ -57,9 +58,23 @@ enum class OpType {
     CREATE_CLONE,
     RECOVER_CHUNK,
     GET_CHUNK_INFO,
+    DISCARD,
     UNKNOWN
 };
 
+/**
+ * 请求在调度队列中的优先级，每个优先级一个队列，按权重轮流出队
+ */
+enum class RequestPriority {
+    // 用户读写请求
+    FOREGROUND = 0,
+    // 重新入队的请求
+    RETRY,
+    // 预读、discard以及快照克隆等后台请求
+    BACKGROUND,
+    PRIORITY_NUM
+};
+
 /**
  * 与nameserver.proto中的FileStatus一一对应
  */
@@ -155,6 +170,9 @@ typedef struct FInfo {
     FileStatus      filestatus;
     std::string     cloneSource;
     uint64_t        cloneLength{0};
+    // mds下发的限流参数，hasThrottleParams为false时使用配置文件中的参数
+    bool            hasThrottleParams{false};
+    FileThrottleParams_t throttleParams;
 
     FInfo() {
         id = 0;
@@ -54,6 +54,24 @@ int ClientConfig::Init(const char* configpath) {
     LOG_IF(ERROR, ret == false) << "config no global.fileIOSplitMaxSizeKB info";           // NOLINT
     RETURN_IF_FALSE(ret)
 
+    ret = conf_.GetBoolValue("global.enableAdaptiveSplit",
+          &fileServiceOption_.ioOpt.ioSplitOpt.enableAdaptiveSplit);
+    LOG_IF(WARNING, ret == false)
+        << "config no global.enableAdaptiveSplit info, using default value "
+        << fileServiceOption_.ioOpt.ioSplitOpt.enableAdaptiveSplit;
+
+    ret = conf_.GetUInt64Value("global.adaptiveSplitMinSizeKB",
+          &fileServiceOption_.ioOpt.ioSplitOpt.adaptiveSplitMinSizeKB);
+    LOG_IF(WARNING, ret == false)
+        << "config no global.adaptiveSplitMinSizeKB info, using default value "
+        << fileServiceOption_.ioOpt.ioSplitOpt.adaptiveSplitMinSizeKB;
+
+    ret = conf_.GetUInt64Value("global.adaptiveSplitMaxSizeKB",
+          &fileServiceOption_.ioOpt.ioSplitOpt.adaptiveSplitMaxSizeKB);
+    LOG_IF(WARNING, ret == false)
+        << "config no global.adaptiveSplitMaxSizeKB info, using default value "
+        << fileServiceOption_.ioOpt.ioSplitOpt.adaptiveSplitMaxSizeKB;
+
     ret = conf_.GetBoolValue("chunkserver.enableAppliedIndexRead",
           &fileServiceOption_.ioOpt.ioSenderOpt.chunkserverEnableAppliedIndexRead);        // NOLINT
     LOG_IF(ERROR, ret == false) << "config no chunkserver.enableAppliedIndexRead info";     // NOLINT
@@ -107,6 +125,70 @@ int ClientConfig::Init(const char* configpath) {
         &fileServiceOption_.ioOpt.ioSenderOpt.failRequestOpt.chunkserverMaxRetryTimesBeforeConsiderSuspend);   // NOLINT
     LOG_IF(ERROR, ret == false) << "config no chunkserver.maxRetryTimesBeforeConsiderSuspend info";             // NOLINT
 
+    ret = conf_.GetBoolValue("chunkserver.hedgeRead.enable",
+        &fileServiceOption_.ioOpt.ioSenderOpt.hedgeReadOpt.enable);
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.hedgeRead.enable info, using default value "
+        << fileServiceOption_.ioOpt.ioSenderOpt.hedgeReadOpt.enable;
+
+    ret = conf_.GetUInt32Value("chunkserver.hedgeRead.latencyPercentile",
+        &fileServiceOption_.ioOpt.ioSenderOpt.hedgeReadOpt.latencyPercentile);
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.hedgeRead.latencyPercentile info, "
+        << "using default value "
+        << fileServiceOption_.ioOpt.ioSenderOpt.hedgeReadOpt.latencyPercentile;
+
+    ret = conf_.GetUInt32Value("chunkserver.hedgeRead.minDelayMS",
+        &fileServiceOption_.ioOpt.ioSenderOpt.hedgeReadOpt.minDelayMS);
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.hedgeRead.minDelayMS info, "
+        << "using default value "
+        << fileServiceOption_.ioOpt.ioSenderOpt.hedgeReadOpt.minDelayMS;
+
+    ret = conf_.GetUInt32Value("chunkserver.hedgeRead.maxHedgePercent",
+        &fileServiceOption_.ioOpt.ioSenderOpt.hedgeReadOpt.maxHedgePercent);
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.hedgeRead.maxHedgePercent info, "
+        << "using default value "
+        << fileServiceOption_.ioOpt.ioSenderOpt.hedgeReadOpt.maxHedgePercent;
+
+    ret = conf_.GetUInt32Value("chunkserver.channelNum",
+        &fileServiceOption_.ioOpt.ioSenderOpt.channelOpt.channelNum);
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.channelNum info, using default value "
+        << fileServiceOption_.ioOpt.ioSenderOpt.channelOpt.channelNum;
+
+    ret = conf_.GetStringValue("chunkserver.connectionType",
+        &fileServiceOption_.ioOpt.ioSenderOpt.channelOpt.connectionType);
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.connectionType info, using default value "
+        << fileServiceOption_.ioOpt.ioSenderOpt.channelOpt.connectionType;
+
+    ret = conf_.GetBoolValue("chunkserver.crc.enable",
+        &fileServiceOption_.ioOpt.ioSenderOpt.crcOpt.enable);
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.crc.enable info, using default value "
+        << fileServiceOption_.ioOpt.ioSenderOpt.crcOpt.enable;
+
+    std::string crcPools;
+    ret = conf_.GetStringValue("chunkserver.crc.logicPoolList", &crcPools);
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.crc.logicPoolList info, "
+        << "enable crc for all logical pools";
+    std::vector<std::string> crcPoolVec;
+    common::SplitString(crcPools, ",", &crcPoolVec);
+    fileServiceOption_.ioOpt.ioSenderOpt.crcOpt.logicPoolIds.clear();
+    for (const auto& pool : crcPoolVec) {
+        uint64_t logicPoolId;
+        if (!common::StringToUll(pool, &logicPoolId)) {
+            LOG(ERROR) << "invalid chunkserver.crc.logicPoolList: "
+                       << crcPools;
+            return -1;
+        }
+        fileServiceOption_.ioOpt.ioSenderOpt.crcOpt.logicPoolIds.insert(
+            logicPoolId);
+    }
+
     ret = conf_.GetUInt64Value("global.fileMaxInFlightRPCNum",
         &fileServiceOption_.ioOpt.ioSenderOpt.inflightOpt.fileMaxInFlightRPCNum);   // NOLINT
     LOG_IF(ERROR, ret == false) << "config no global.fileMaxInFlightRPCNum info";   // NOLINT
@@ -137,6 +219,36 @@ int ClientConfig::Init(const char* configpath) {
     LOG_IF(ERROR, ret == false) << "config no schedule.threadpoolSize info";
     RETURN_IF_FALSE(ret)
 
+    ret = conf_.GetBoolValue("schedule.enableMerge",
+        &fileServiceOption_.ioOpt.reqSchdulerOpt.enableMerge);
+    LOG_IF(WARNING, ret == false)
+        << "config no schedule.enableMerge info, using default value "
+        << fileServiceOption_.ioOpt.reqSchdulerOpt.enableMerge;
+
+    ret = conf_.GetBoolValue("schedule.enablePriority",
+        &fileServiceOption_.ioOpt.reqSchdulerOpt.enablePriority);
+    LOG_IF(WARNING, ret == false)
+        << "config no schedule.enablePriority info, using default value "
+        << fileServiceOption_.ioOpt.reqSchdulerOpt.enablePriority;
+
+    ret = conf_.GetUInt32Value("schedule.foregroundWeight",
+        &fileServiceOption_.ioOpt.reqSchdulerOpt.foregroundWeight);
+    LOG_IF(WARNING, ret == false)
+        << "config no schedule.foregroundWeight info, using default value "
+        << fileServiceOption_.ioOpt.reqSchdulerOpt.foregroundWeight;
+
+    ret = conf_.GetUInt32Value("schedule.retryWeight",
+        &fileServiceOption_.ioOpt.reqSchdulerOpt.retryWeight);
+    LOG_IF(WARNING, ret == false)
+        << "config no schedule.retryWeight info, using default value "
+        << fileServiceOption_.ioOpt.reqSchdulerOpt.retryWeight;
+
+    ret = conf_.GetUInt32Value("schedule.backgroundWeight",
+        &fileServiceOption_.ioOpt.reqSchdulerOpt.backgroundWeight);
+    LOG_IF(WARNING, ret == false)
+        << "config no schedule.backgroundWeight info, using default value "
+        << fileServiceOption_.ioOpt.reqSchdulerOpt.backgroundWeight;
+
     ret = conf_.GetUInt32Value("mds.refreshTimesPerLease",
         &fileServiceOption_.leaseOpt.mdsRefreshTimesPerLease);
     LOG_IF(ERROR, ret == false) << "config no mds.refreshTimesPerLease info";
@@ -156,6 +268,186 @@ int ClientConfig::Init(const char* configpath) {
     LOG_IF(ERROR, ret == false) << "config no isolation.taskThreadPoolSize info";   // NOLINT
     RETURN_IF_FALSE(ret)
 
+    ret = conf_.GetBoolValue("readcache.enable",
+        &fileServiceOption_.ioOpt.readCacheOpt.enable);
+    LOG_IF(WARNING, ret == false)
+        << "config no readcache.enable info, using default value "
+        << fileServiceOption_.ioOpt.readCacheOpt.enable;
+
+    ret = conf_.GetUInt64Value("readcache.capacityMB",
+        &fileServiceOption_.ioOpt.readCacheOpt.capacityMB);
+    LOG_IF(WARNING, ret == false)
+        << "config no readcache.capacityMB info, using default value "
+        << fileServiceOption_.ioOpt.readCacheOpt.capacityMB;
+
+    ret = conf_.GetUInt32Value("readcache.pageSizeKB",
+        &fileServiceOption_.ioOpt.readCacheOpt.pageSizeKB);
+    LOG_IF(WARNING, ret == false)
+        << "config no readcache.pageSizeKB info, using default value "
+        << fileServiceOption_.ioOpt.readCacheOpt.pageSizeKB;
+
+    ret = conf_.GetBoolValue("readahead.enable",
+        &fileServiceOption_.ioOpt.readAheadOpt.enable);
+    LOG_IF(WARNING, ret == false)
+        << "config no readahead.enable info, using default value "
+        << fileServiceOption_.ioOpt.readAheadOpt.enable;
+
+    ret = conf_.GetUInt32Value("readahead.minWindowKB",
+        &fileServiceOption_.ioOpt.readAheadOpt.minWindowKB);
+    LOG_IF(WARNING, ret == false)
+        << "config no readahead.minWindowKB info, using default value "
+        << fileServiceOption_.ioOpt.readAheadOpt.minWindowKB;
+
+    ret = conf_.GetUInt32Value("readahead.maxWindowKB",
+        &fileServiceOption_.ioOpt.readAheadOpt.maxWindowKB);
+    LOG_IF(WARNING, ret == false)
+        << "config no readahead.maxWindowKB info, using default value "
+        << fileServiceOption_.ioOpt.readAheadOpt.maxWindowKB;
+
+    ret = conf_.GetUInt64Value("readahead.maxBufferMB",
+        &fileServiceOption_.ioOpt.readAheadOpt.maxBufferMB);
+    LOG_IF(WARNING, ret == false)
+        << "config no readahead.maxBufferMB info, using default value "
+        << fileServiceOption_.ioOpt.readAheadOpt.maxBufferMB;
+
+    ret = conf_.GetBoolValue("writeback.enable",
+        &fileServiceOption_.ioOpt.writeBackOpt.enable);
+    LOG_IF(WARNING, ret == false)
+        << "config no writeback.enable info, using default value "
+        << fileServiceOption_.ioOpt.writeBackOpt.enable;
+
+    ret = conf_.GetStringValue("writeback.logDir",
+        &fileServiceOption_.ioOpt.writeBackOpt.logDir);
+    LOG_IF(WARNING, ret == false)
+        << "config no writeback.logDir info, using default value "
+        << fileServiceOption_.ioOpt.writeBackOpt.logDir;
+
+    ret = conf_.GetUInt64Value("writeback.maxDirtyMB",
+        &fileServiceOption_.ioOpt.writeBackOpt.maxDirtyMB);
+    LOG_IF(WARNING, ret == false)
+        << "config no writeback.maxDirtyMB info, using default value "
+        << fileServiceOption_.ioOpt.writeBackOpt.maxDirtyMB;
+
+    ret = conf_.GetUInt64Value("writeback.flushThresholdMB",
+        &fileServiceOption_.ioOpt.writeBackOpt.flushThresholdMB);
+    LOG_IF(WARNING, ret == false)
+        << "config no writeback.flushThresholdMB info, using default value "
+        << fileServiceOption_.ioOpt.writeBackOpt.flushThresholdMB;
+
+    ret = conf_.GetUInt64Value("writeback.maxLogSizeMB",
+        &fileServiceOption_.ioOpt.writeBackOpt.maxLogSizeMB);
+    LOG_IF(WARNING, ret == false)
+        << "config no writeback.maxLogSizeMB info, using default value "
+        << fileServiceOption_.ioOpt.writeBackOpt.maxLogSizeMB;
+
+    ret = conf_.GetUInt32Value("writeback.flushIntervalMS",
+        &fileServiceOption_.ioOpt.writeBackOpt.flushIntervalMS);
+    LOG_IF(WARNING, ret == false)
+        << "config no writeback.flushIntervalMS info, using default value "
+        << fileServiceOption_.ioOpt.writeBackOpt.flushIntervalMS;
+
+    ret = conf_.GetUInt32Value("writeback.flushBatchSizeKB",
+        &fileServiceOption_.ioOpt.writeBackOpt.flushBatchSizeKB);
+    LOG_IF(WARNING, ret == false)
+        << "config no writeback.flushBatchSizeKB info, using default value "
+        << fileServiceOption_.ioOpt.writeBackOpt.flushBatchSizeKB;
+
+    ret = conf_.GetBoolValue("discard.enable",
+        &fileServiceOption_.ioOpt.discardOpt.enable);
+    LOG_IF(WARNING, ret == false)
+        << "config no discard.enable info, using default value "
+        << fileServiceOption_.ioOpt.discardOpt.enable;
+
+    ret = conf_.GetUInt32Value("discard.granularityKB",
+        &fileServiceOption_.ioOpt.discardOpt.granularityKB);
+    LOG_IF(WARNING, ret == false)
+        << "config no discard.granularityKB info, using default value "
+        << fileServiceOption_.ioOpt.discardOpt.granularityKB;
+
+    ret = conf_.GetUInt32Value("discard.maxRecordChunkNum",
+        &fileServiceOption_.ioOpt.discardOpt.maxRecordChunkNum);
+    LOG_IF(WARNING, ret == false)
+        << "config no discard.maxRecordChunkNum info, using default value "
+        << fileServiceOption_.ioOpt.discardOpt.maxRecordChunkNum;
+
+    ret = conf_.GetBoolValue("throttle.enable",
+        &fileServiceOption_.ioOpt.throttleOpt.enable);
+    LOG_IF(WARNING, ret == false)
+        << "config no throttle.enable info, using default value "
+        << fileServiceOption_.ioOpt.throttleOpt.enable;
+
+    ret = conf_.GetUInt64Value("throttle.readIOPS",
+        &fileServiceOption_.ioOpt.throttleOpt.params.readIOPS.limit);
+    LOG_IF(WARNING, ret == false)
+        << "config no throttle.readIOPS info, using default value "
+        << fileServiceOption_.ioOpt.throttleOpt.params.readIOPS.limit;
+
+    ret = conf_.GetUInt64Value("throttle.readIOPSBurst",
+        &fileServiceOption_.ioOpt.throttleOpt.params.readIOPS.burst);
+    LOG_IF(WARNING, ret == false)
+        << "config no throttle.readIOPSBurst info, using default value "
+        << fileServiceOption_.ioOpt.throttleOpt.params.readIOPS.burst;
+
+    ret = conf_.GetUInt64Value("throttle.writeIOPS",
+        &fileServiceOption_.ioOpt.throttleOpt.params.writeIOPS.limit);
+    LOG_IF(WARNING, ret == false)
+        << "config no throttle.writeIOPS info, using default value "
+        << fileServiceOption_.ioOpt.throttleOpt.params.writeIOPS.limit;
+
+    ret = conf_.GetUInt64Value("throttle.writeIOPSBurst",
+        &fileServiceOption_.ioOpt.throttleOpt.params.writeIOPS.burst);
+    LOG_IF(WARNING, ret == false)
+        << "config no throttle.writeIOPSBurst info, using default value "
+        << fileServiceOption_.ioOpt.throttleOpt.params.writeIOPS.burst;
+
+    ret = conf_.GetUInt64Value("throttle.readBPS",
+        &fileServiceOption_.ioOpt.throttleOpt.params.readBPS.limit);
+    LOG_IF(WARNING, ret == false)
+        << "config no throttle.readBPS info, using default value "
+        << fileServiceOption_.ioOpt.throttleOpt.params.readBPS.limit;
+
+    ret = conf_.GetUInt64Value("throttle.readBPSBurst",
+        &fileServiceOption_.ioOpt.throttleOpt.params.readBPS.burst);
+    LOG_IF(WARNING, ret == false)
+        << "config no throttle.readBPSBurst info, using default value "
+        << fileServiceOption_.ioOpt.throttleOpt.params.readBPS.burst;
+
+    ret = conf_.GetUInt64Value("throttle.writeBPS",
+        &fileServiceOption_.ioOpt.throttleOpt.params.writeBPS.limit);
+    LOG_IF(WARNING, ret == false)
+        << "config no throttle.writeBPS info, using default value "
+        << fileServiceOption_.ioOpt.throttleOpt.params.writeBPS.limit;
+
+    ret = conf_.GetUInt64Value("throttle.writeBPSBurst",
+        &fileServiceOption_.ioOpt.throttleOpt.params.writeBPS.burst);
+    LOG_IF(WARNING, ret == false)
+        << "config no throttle.writeBPSBurst info, using default value "
+        << fileServiceOption_.ioOpt.throttleOpt.params.writeBPS.burst;
+
+    ret = conf_.GetBoolValue("trace.enable",
+        &fileServiceOption_.ioOpt.ioTraceOpt.enable);
+    LOG_IF(WARNING, ret == false)
+        << "config no trace.enable info, using default value "
+        << fileServiceOption_.ioOpt.ioTraceOpt.enable;
+
+    ret = conf_.GetUInt64Value("trace.slowIOThresholdMS",
+        &fileServiceOption_.ioOpt.ioTraceOpt.slowIOThresholdMS);
+    LOG_IF(WARNING, ret == false)
+        << "config no trace.slowIOThresholdMS info, using default value "
+        << fileServiceOption_.ioOpt.ioTraceOpt.slowIOThresholdMS;
+
+    ret = conf_.GetUInt32Value("trace.slowIOSampleInterval",
+        &fileServiceOption_.ioOpt.ioTraceOpt.slowIOSampleInterval);
+    LOG_IF(WARNING, ret == false)
+        << "config no trace.slowIOSampleInterval info, using default value "
+        << fileServiceOption_.ioOpt.ioTraceOpt.slowIOSampleInterval;
+
+    ret = conf_.GetUInt32Value("trace.slowIORecordNum",
+        &fileServiceOption_.ioOpt.ioTraceOpt.slowIORecordNum);
+    LOG_IF(WARNING, ret == false)
+        << "config no trace.slowIORecordNum info, using default value "
+        << fileServiceOption_.ioOpt.ioTraceOpt.slowIORecordNum;
+
     std::string metaAddr;
     ret = conf_.GetStringValue("mds.listen.addr", &metaAddr);
     LOG_IF(ERROR, ret == false) << "config no mds.listen.addr info";
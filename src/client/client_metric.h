@@ -92,6 +92,171 @@ struct InterfaceMetric {
           latency(prefix, name + "_lat") {}
 };
 
+// 读缓存metric信息统计
+struct ReadCacheMetric {
+    // 读请求命中缓存次数
+    PerSecondMetric hit;
+    // 读请求未命中缓存次数
+    PerSecondMetric miss;
+    // 缓存page被淘汰次数
+    bvar::Adder<uint64_t> evictCount;
+    // 当前缓存占用的内存字节数
+    bvar::Adder<int64_t> cachedBytes;
+
+    ReadCacheMetric(const std::string& prefix, const std::string& name)
+        : hit(prefix, name + "_hit"),
+          miss(prefix, name + "_miss"),
+          evictCount(prefix, name + "_evict_count"),
+          cachedBytes(prefix, name + "_cached_bytes") {}
+};
+
+// 预读metric信息统计
+struct ReadAheadMetric {
+    // 读请求命中预读数据次数
+    PerSecondMetric hit;
+    // 读请求未命中预读数据次数
+    PerSecondMetric miss;
+    // 预读请求的吞吐
+    PerSecondMetric prefetchBps;
+    // 预读数据未被读取就被淘汰的次数
+    bvar::Adder<uint64_t> evictCount;
+    // 当前预读数据占用的内存字节数
+    bvar::Adder<int64_t> bufferBytes;
+
+    ReadAheadMetric(const std::string& prefix, const std::string& name)
+        : hit(prefix, name + "_hit"),
+          miss(prefix, name + "_miss"),
+          prefetchBps(prefix, name + "_prefetch_bps"),
+          evictCount(prefix, name + "_evict_count"),
+          bufferBytes(prefix, name + "_buffer_bytes") {}
+};
+
+// 写缓存metric信息统计
+struct WriteBackMetric {
+    // 当前缓存的脏数据字节数
+    bvar::Adder<int64_t> dirtyBytes;
+    // 因脏数据或日志超限而等待的写请求
+    PerSecondMetric throttle;
+    // 后台刷盘的吞吐
+    PerSecondMetric flushBps;
+    // 后台每个刷盘请求的latency
+    bvar::LatencyRecorder flushLatency;
+    // 用户flush请求的latency
+    bvar::LatencyRecorder userFlushLatency;
+
+    WriteBackMetric(const std::string& prefix, const std::string& name)
+        : dirtyBytes(prefix, name + "_dirty_bytes"),
+          throttle(prefix, name + "_throttle"),
+          flushBps(prefix, name + "_flush_bps"),
+          flushLatency(prefix, name + "_flush_lat"),
+          userFlushLatency(prefix, name + "_user_flush_lat") {}
+};
+
+// discard metric信息统计
+struct DiscardMetric {
+    // 被删除的chunk数量
+    PerSecondMetric deleteChunk;
+    // 只覆盖chunk部分区间、被记录下来的discard字节数
+    bvar::Adder<uint64_t> recordBytes;
+    // 被快照或克隆使用而保留的chunk数量
+    bvar::Adder<uint64_t> keepChunk;
+    // 被释放的segment数量
+    bvar::Adder<uint64_t> releaseSegment;
+
+    DiscardMetric(const std::string& prefix, const std::string& name)
+        : deleteChunk(prefix, name + "_delete_chunk"),
+          recordBytes(prefix, name + "_record_bytes"),
+          keepChunk(prefix, name + "_keep_chunk"),
+          releaseSegment(prefix, name + "_release_segment") {}
+};
+
+// 对冲读metric信息统计
+struct HedgeReadMetric {
+    // 发起的对冲读请求
+    PerSecondMetric hedge;
+    // 对冲读先于leader读请求成功返回的次数
+    PerSecondMetric win;
+
+    HedgeReadMetric(const std::string& prefix, const std::string& name)
+        : hedge(prefix, name + "_hedge"),
+          win(prefix, name + "_win") {}
+};
+
+// QoS限流metric信息统计
+struct ThrottleMetric {
+    // 因令牌不足而排队的读写请求
+    PerSecondMetric readThrottle;
+    PerSecondMetric writeThrottle;
+    // 排队请求的等待时间
+    bvar::LatencyRecorder waitLatency;
+
+    ThrottleMetric(const std::string& prefix, const std::string& name)
+        : readThrottle(prefix, name + "_read"),
+          writeThrottle(prefix, name + "_write"),
+          waitLatency(prefix, name + "_wait_lat") {}
+};
+
+// 调度队列各优先级的排队请求数
+struct ScheduleQueueMetric {
+    bvar::Adder<int64_t> foregroundDepth;
+    bvar::Adder<int64_t> retryDepth;
+    bvar::Adder<int64_t> backgroundDepth;
+
+    ScheduleQueueMetric(const std::string& prefix, const std::string& name)
+        : foregroundDepth(prefix, name + "_foreground_depth"),
+          retryDepth(prefix, name + "_retry_depth"),
+          backgroundDepth(prefix, name + "_background_depth") {}
+};
+
+// chunk数据CRC校验metric信息统计
+struct CrcMetric {
+    // 写请求计算CRC、读请求校验CRC的耗时
+    bvar::LatencyRecorder computeLatency;
+    // chunkserver校验写请求数据CRC失败的次数
+    bvar::Adder<uint64_t> writeMismatch;
+    // client校验读请求返回数据CRC失败的次数
+    bvar::Adder<uint64_t> readMismatch;
+
+    CrcMetric(const std::string& prefix, const std::string& name)
+        : computeLatency(prefix, name + "_compute_lat"),
+          writeMismatch(prefix, name + "_write_mismatch"),
+          readMismatch(prefix, name + "_read_mismatch") {}
+};
+
+// 读写IO分阶段耗时统计
+struct IOTraceMetric {
+    // 在任务队列中等待的时间，包括限流排队的时间
+    bvar::LatencyRecorder taskQueueLatency;
+    // 拆分IO的时间，不包括从mds获取元数据的时间
+    bvar::LatencyRecorder splitLatency;
+    // 拆分时metacache未命中从mds获取segment的时间
+    bvar::LatencyRecorder metadataLatency;
+    // 以下为耗时最长的chunk请求在各个阶段的耗时
+    // 在调度队列中等待的时间
+    bvar::LatencyRecorder scheduleQueueLatency;
+    // 出队到rpc发出的时间，包括等待inflight rpc令牌和获取leader
+    bvar::LatencyRecorder dispatchLatency;
+    // rpc的时间，重试时累加
+    bvar::LatencyRecorder rpcLatency;
+    // 重试之前的睡眠时间
+    bvar::LatencyRecorder backoffLatency;
+    // 请求重试次数
+    bvar::Adder<uint64_t> retryCount;
+    // 慢IO数量
+    bvar::Adder<uint64_t> slowIOCount;
+
+    IOTraceMetric(const std::string& prefix, const std::string& name)
+        : taskQueueLatency(prefix, name + "_task_queue_lat"),
+          splitLatency(prefix, name + "_split_lat"),
+          metadataLatency(prefix, name + "_metadata_lat"),
+          scheduleQueueLatency(prefix, name + "_schedule_queue_lat"),
+          dispatchLatency(prefix, name + "_dispatch_lat"),
+          rpcLatency(prefix, name + "_rpc_lat"),
+          backoffLatency(prefix, name + "_backoff_lat"),
+          retryCount(prefix, name + "_retry_count"),
+          slowIOCount(prefix, name + "_slow_io_count") {}
+};
+
 // 文件级别metric信息统计
 struct FileMetric {
     // 当前metric归属于哪个文件
@@ -119,6 +284,33 @@ struct FileMetric {
     // 当前文件上的悬挂IO数量
     IOSuspendMetric suspendRPCMetric;
 
+    // 读缓存统计信息
+    ReadCacheMetric readCache;
+
+    // 预读统计信息
+    ReadAheadMetric readAhead;
+
+    // 写缓存统计信息
+    WriteBackMetric writeBack;
+
+    // discard统计信息
+    DiscardMetric discard;
+
+    // 对冲读统计信息
+    HedgeReadMetric hedgeRead;
+
+    // QoS限流统计信息
+    ThrottleMetric throttle;
+
+    // IO分阶段耗时统计信息
+    IOTraceMetric ioTrace;
+
+    // 调度队列统计信息
+    ScheduleQueueMetric scheduleQueue;
+
+    // CRC校验统计信息
+    CrcMetric crc;
+
     explicit FileMetric(const std::string& name)
         : filename(name),
           userRead(prefix, filename + "_read"),
@@ -129,7 +321,16 @@ struct FileMetric {
           getLeaderRetryQPS(prefix, filename + "_get_leader_retry_rpc"),
           writeSizeRecorder(prefix, filename + "_write_request_size_recoder"),
           readSizeRecorder(prefix, filename + "_read_request_size_recoder"),
-          suspendRPCMetric(prefix, filename + "_suspend_io_num") {}
+          suspendRPCMetric(prefix, filename + "_suspend_io_num"),
+          readCache(prefix, filename + "_read_cache"),
+          readAhead(prefix, filename + "_read_ahead"),
+          writeBack(prefix, filename + "_write_back"),
+          discard(prefix, filename + "_discard"),
+          hedgeRead(prefix, filename + "_hedge_read"),
+          throttle(prefix, filename + "_throttle"),
+          ioTrace(prefix, filename + "_io_trace"),
+          scheduleQueue(prefix, filename + "_schedule_queue"),
+          crc(prefix, filename + "_crc") {}
 };
 
 // 用于全局mds接口统计信息调用信息统计
@@ -154,6 +355,8 @@ struct MDSClientMetric {
     InterfaceMetric getServerList;
     // GetOrAllocateSegment接口统计信息
     InterfaceMetric getOrAllocateSegment;
+    // DeAllocateSegment接口统计信息
+    InterfaceMetric deAllocateSegment;
     // RenameFile接口统计信息
     InterfaceMetric renameFile;
     // Extend接口统计信息
@@ -185,6 +388,7 @@ struct MDSClientMetric {
           refreshSession(prefix, "refreshSession"),
           getServerList(prefix, "getServerList"),
           getOrAllocateSegment(prefix, "getOrAllocateSegment"),
+          deAllocateSegment(prefix, "deAllocateSegment"),
           renameFile(prefix, "renameFile"),
           extendFile(prefix, "extendFile"),
           deleteFile(prefix, "deleteFile"),
@@ -221,6 +425,282 @@ class MetricHelper {
         }
     }
 
+    /**
+     * 统计读请求命中读缓存次数
+     * @param: fm为当前文件的metric指针
+     */
+    static void IncremReadCacheHitCount(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->readCache.hit.count << 1;
+        }
+    }
+
+    /**
+     * 统计读请求未命中读缓存次数
+     * @param: fm为当前文件的metric指针
+     */
+    static void IncremReadCacheMissCount(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->readCache.miss.count << 1;
+        }
+    }
+
+    /**
+     * 统计读缓存page淘汰次数
+     * @param: fm为当前文件的metric指针
+     */
+    static void IncremReadCacheEvictCount(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->readCache.evictCount << 1;
+        }
+    }
+
+    /**
+     * 更新读缓存占用的内存字节数
+     * @param: fm为当前文件的metric指针
+     * @param: delta为变化的字节数，淘汰或失效时为负数
+     */
+    static void UpdateReadCacheBytes(FileMetric* fm, int64_t delta) {
+        if (fm != nullptr) {
+            fm->readCache.cachedBytes << delta;
+        }
+    }
+
+    /**
+     * 统计读请求命中预读数据次数
+     * @param: fm为当前文件的metric指针
+     */
+    static void IncremReadAheadHitCount(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->readAhead.hit.count << 1;
+        }
+    }
+
+    /**
+     * 统计读请求未命中预读数据次数
+     * @param: fm为当前文件的metric指针
+     */
+    static void IncremReadAheadMissCount(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->readAhead.miss.count << 1;
+        }
+    }
+
+    /**
+     * 统计预读请求的字节数
+     * @param: fm为当前文件的metric指针
+     * @param: length为预读请求的长度
+     */
+    static void IncremReadAheadPrefetchBytes(FileMetric* fm, uint64_t length) {
+        if (fm != nullptr) {
+            fm->readAhead.prefetchBps.count << length;
+        }
+    }
+
+    /**
+     * 统计预读数据未被读取就被淘汰的次数
+     * @param: fm为当前文件的metric指针
+     */
+    static void IncremReadAheadEvictCount(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->readAhead.evictCount << 1;
+        }
+    }
+
+    /**
+     * 更新预读数据占用的内存字节数
+     * @param: fm为当前文件的metric指针
+     * @param: delta为变化的字节数，数据被读取、淘汰或失效时为负数
+     */
+    static void UpdateReadAheadBytes(FileMetric* fm, int64_t delta) {
+        if (fm != nullptr) {
+            fm->readAhead.bufferBytes << delta;
+        }
+    }
+
+    /**
+     * 更新写缓存中的脏数据字节数
+     * @param: fm为当前文件的metric指针
+     * @param: delta为变化的字节数，刷盘或被覆盖时为负数
+     */
+    static void UpdateWriteBackDirtyBytes(FileMetric* fm, int64_t delta) {
+        if (fm != nullptr) {
+            fm->writeBack.dirtyBytes << delta;
+        }
+    }
+
+    /**
+     * 统计写缓存限流次数
+     * @param: fm为当前文件的metric指针
+     */
+    static void IncremWriteBackThrottleCount(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->writeBack.throttle.count << 1;
+        }
+    }
+
+    /**
+     * 统计写缓存后台刷盘请求的latency和吞吐
+     * @param: fm为当前文件的metric指针
+     * @param: length为刷盘请求大小
+     * @param: duration为刷盘请求耗时
+     */
+    static void WriteBackFlushRecord(FileMetric* fm, uint64_t length,
+                                     uint64_t duration) {
+        if (fm != nullptr) {
+            fm->writeBack.flushBps.count << length;
+            fm->writeBack.flushLatency << duration;
+        }
+    }
+
+    /**
+     * 统计用户flush请求的latency
+     * @param: fm为当前文件的metric指针
+     * @param: duration为flush请求耗时
+     */
+    static void WriteBackUserFlushRecord(FileMetric* fm, uint64_t duration) {
+        if (fm != nullptr) {
+            fm->writeBack.userFlushLatency << duration;
+        }
+    }
+
+    /**
+     * 统计discard删除的chunk数量
+     * @param: fm为当前文件的metric指针
+     */
+    static void IncremDiscardDeleteChunkCount(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->discard.deleteChunk.count << 1;
+        }
+    }
+
+    /**
+     * 统计只覆盖chunk部分区间的discard字节数
+     * @param: fm为当前文件的metric指针
+     * @param: length为被记录的字节数
+     */
+    static void IncremDiscardRecordBytes(FileMetric* fm, uint64_t length) {
+        if (fm != nullptr) {
+            fm->discard.recordBytes << length;
+        }
+    }
+
+    /**
+     * 统计discard时被快照或克隆使用而保留的chunk数量
+     * @param: fm为当前文件的metric指针
+     */
+    static void IncremDiscardKeepChunkCount(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->discard.keepChunk << 1;
+        }
+    }
+
+    /**
+     * 统计discard释放的segment数量
+     * @param: fm为当前文件的metric指针
+     */
+    static void IncremDiscardReleaseSegmentCount(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->discard.releaseSegment << 1;
+        }
+    }
+
+    /**
+     * 统计发起的对冲读请求次数
+     * @param: fm为当前文件的metric指针
+     */
+    static void IncremHedgeReadCount(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->hedgeRead.hedge.count << 1;
+        }
+    }
+
+    /**
+     * 统计对冲读先于leader读请求成功返回的次数
+     * @param: fm为当前文件的metric指针
+     */
+    static void IncremHedgeReadWinCount(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->hedgeRead.win.count << 1;
+        }
+    }
+
+    /**
+     * 统计因令牌不足而排队的请求次数
+     * @param: fm为当前文件的metric指针
+     * @param: type为请求类型
+     */
+    static void IncremThrottleCount(FileMetric* fm, OpType type) {
+        if (fm != nullptr) {
+            if (type == OpType::READ) {
+                fm->throttle.readThrottle.count << 1;
+            } else {
+                fm->throttle.writeThrottle.count << 1;
+            }
+        }
+    }
+
+    /**
+     * 统计排队请求的等待时间
+     * @param: fm为当前文件的metric指针
+     * @param: duration为请求排队的时间
+     */
+    static void ThrottleWaitRecord(FileMetric* fm, uint64_t duration) {
+        if (fm != nullptr) {
+            fm->throttle.waitLatency << duration;
+        }
+    }
+
+    /**
+     * 更新调度队列中某个优先级的排队请求数
+     * @param: fm为当前文件的metric指针
+     * @param: priority为请求的优先级
+     * @param: delta为排队请求数的变化量
+     */
+    static void UpdateScheduleQueueDepth(FileMetric* fm,
+                                         RequestPriority priority,
+                                         int64_t delta) {
+        if (fm != nullptr) {
+            switch (priority) {
+            case RequestPriority::FOREGROUND:
+                fm->scheduleQueue.foregroundDepth << delta;
+                break;
+            case RequestPriority::RETRY:
+                fm->scheduleQueue.retryDepth << delta;
+                break;
+            default:
+                fm->scheduleQueue.backgroundDepth << delta;
+                break;
+            }
+        }
+    }
+
+    /**
+     * 统计计算或者校验数据CRC的耗时
+     * @param: fm为当前文件的metric指针
+     * @param: duration为计算CRC的耗时
+     */
+    static void CrcComputeRecord(FileMetric* fm, uint64_t duration) {
+        if (fm != nullptr) {
+            fm->crc.computeLatency << duration;
+        }
+    }
+
+    /**
+     * 统计数据CRC校验失败的次数
+     * @param: fm为当前文件的metric指针
+     * @param: type为请求类型
+     */
+    static void IncremCrcMismatchCount(FileMetric* fm, OpType type) {
+        if (fm != nullptr) {
+            if (type == OpType::READ) {
+                fm->crc.readMismatch << 1;
+            } else {
+                fm->crc.writeMismatch << 1;
+            }
+        }
+    }
+
     /**
      * 统计用户当前读写请求次数，用于qps计算
      * @param: fm为当前文件的metric指针
@@ -24,6 +24,7 @@
 #define SRC_CLIENT_CONFIG_INFO_H_
 
 #include <stdint.h>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -165,31 +166,95 @@ typedef struct FailureRequestOption {
     }
 } FailureRequestOption_t;
 
+/**
+ * 对冲读配置，读请求在leader上超过一定时间未返回时，向applied index满足要求的
+ * 其他副本再发送一次读请求，取先成功返回的结果，依赖appliedindex read
+ * @enable: 是否开启对冲读
+ * @latencyPercentile: 等待时间取leader所在chunkserver读latency的该百分位
+ * @minDelayMS: 对冲读的最小等待时间，latency样本不足时不发起对冲读
+ * @maxHedgePercent: 对冲读请求数最多占读请求数的百分比，避免放大集群负载
+ */
+typedef struct HedgeReadOption {
+    bool enable = false;
+    uint32_t latencyPercentile = 99;
+    uint32_t minDelayMS = 5;
+    uint32_t maxHedgePercent = 5;
+} HedgeReadOption_t;
+
+/**
+ * 与chunkserver之间的链接配置
+ * @channelNum: 每个chunkserver建立的channel数，请求按chunk id分散到各个channel
+ * @connectionType: channel的链接类型，single或者pooled
+ */
+typedef struct ChunkServerChannelOption {
+    uint32_t channelNum = 1;
+    std::string connectionType = "single";
+} ChunkServerChannelOption_t;
+
+/**
+ * chunk数据的端到端CRC校验配置，写请求携带数据的CRC32C由chunkserver校验，
+ * 读请求要求chunkserver返回数据的CRC32C由client校验，校验失败的请求会重试
+ * @enable: 是否开启CRC校验
+ * @logicPoolIds: 开启CRC校验的逻辑池，为空时所有逻辑池都开启
+ */
+typedef struct ChunkCrcOption {
+    bool enable = false;
+    std::set<uint32_t> logicPoolIds;
+
+    bool Enabled(uint32_t logicPoolId) const {
+        return enable && (logicPoolIds.empty() ||
+                          logicPoolIds.count(logicPoolId) != 0);
+    }
+} ChunkCrcOption_t;
+
 /**
  * 发送rpc给chunkserver的配置
  * @chunkserverEnableAppliedIndexRead: 是否开启使用appliedindex read
  * @inflightOpt: 一个文件向chunkserver发送请求时的inflight 请求控制配置
  * @failRequestOpt: rpc发送失败之后，需要进行rpc重试的相关配置
+ * @hedgeReadOpt: 对冲读配置
+ * @channelOpt: 与chunkserver之间的链接配置
+ * @crcOpt: chunk数据的CRC校验配置
  */
 typedef struct IOSenderOption {
     bool chunkserverEnableAppliedIndexRead;
     InFlightIOCntlInfo_t inflightOpt;
     FailureRequestOption_t failRequestOpt;
+    HedgeReadOption_t hedgeReadOpt;
+    ChunkServerChannelOption_t channelOpt;
+    ChunkCrcOption_t crcOpt;
 } IOSenderOption_t;
 
 /**
  * scheduler模块基本配置信息，schedule模块是用于分发用户请求，每个文件有自己的schedule
  * 线程池，线程池中的线程各自配置一个队列
- * @scheduleQueueCapacity: schedule模块配置的队列深度
+ * @scheduleQueueCapacity: schedule模块配置的队列深度，开启优先级时为每个优先级的队列深度
  * @scheduleThreadpoolSize: schedule模块线程池大小
+ * @enableMerge: 是否将队列中同一个chunk上相邻的读写请求合并成一个RPC下发，
+ *               合并后的大小不超过当前的IO拆分大小
+ * @enablePriority: 是否按优先级调度，开启后用户读写、重新入队的请求和后台请求
+ *                  分别排队，按权重轮流出队，关闭时所有请求在一个队列中先进先出
+ * @foregroundWeight: 用户读写请求的出队权重
+ * @retryWeight: 重新入队的请求的出队权重
+ * @backgroundWeight: 后台请求的出队权重
  */
 typedef struct RequestScheduleOption {
     uint32_t scheduleQueueCapacity;
     uint32_t scheduleThreadpoolSize;
+    bool enableMerge;
+    bool enablePriority;
+    uint32_t foregroundWeight;
+    uint32_t retryWeight;
+    uint32_t backgroundWeight;
     IOSenderOption_t ioSenderOpt;
     RequestScheduleOption() {
         scheduleQueueCapacity = 1024;
         scheduleThreadpoolSize = 2;
+        enableMerge = false;
+        enablePriority = false;
+        foregroundWeight = 8;
+        retryWeight = 4;
+        backgroundWeight = 1;
     }
 } RequestScheduleOption_t;
 
@@ -230,11 +295,21 @@ typedef struct MetaCacheOption {
  * IO 拆分模块配置信息
  * @fileIOSplitMaxSizeKB: 用户下发IO大小client没有限制，但是client会将用户的IO进行拆分，
  *                        发向同一个chunkserver的请求锁携带的数据大小不能超过该值。
+ *                        开启自适应拆分时作为拆分大小的初始值。
+ * @enableAdaptiveSplit: 是否根据chunkserver RPC的latency和带宽自适应调整拆分大小
+ * @adaptiveSplitMinSizeKB: 自适应拆分大小的下限
+ * @adaptiveSplitMaxSizeKB: 自适应拆分大小的上限
  */
 typedef struct IOSplitOPtion {
     uint64_t  fileIOSplitMaxSizeKB;
+    bool      enableAdaptiveSplit;
+    uint64_t  adaptiveSplitMinSizeKB;
+    uint64_t  adaptiveSplitMaxSizeKB;
     IOSplitOPtion() {
         fileIOSplitMaxSizeKB = 64;
+        enableAdaptiveSplit = false;
+        adaptiveSplitMinSizeKB = 16;
+        adaptiveSplitMaxSizeKB = 1024;
     }
 } IOSplitOPtion_t;
 
@@ -254,6 +329,146 @@ typedef struct TaskThreadOption {
     }
 } TaskThreadOption_t;
 
+/**
+ * client读缓存配置信息
+ * @enable: 是否开启读缓存，默认关闭
+ * @capacityMB: 每个文件读缓存最多占用的内存
+ * @pageSizeKB: 缓存page大小，只有被读请求完整覆盖的page才会被缓存
+ */
+typedef struct ReadCacheOption {
+    bool        enable;
+    uint64_t    capacityMB;
+    uint32_t    pageSizeKB;
+    ReadCacheOption() {
+        enable = false;
+        capacityMB = 256;
+        pageSizeKB = 4;
+    }
+} ReadCacheOption_t;
+
+/**
+ * client顺序读预读配置信息
+ * @enable: 是否开启预读，默认关闭
+ * @minWindowKB: 检测到顺序读后预读窗口的初始大小
+ * @maxWindowKB: 顺序读持续命中时预读窗口翻倍增长的上限
+ * @maxBufferMB: 每个文件预读数据最多占用的内存
+ */
+typedef struct ReadAheadOption {
+    bool        enable;
+    uint32_t    minWindowKB;
+    uint32_t    maxWindowKB;
+    uint64_t    maxBufferMB;
+    ReadAheadOption() {
+        enable = false;
+        minWindowKB = 128;
+        maxWindowKB = 4096;
+        maxBufferMB = 64;
+    }
+} ReadAheadOption_t;
+
+/**
+ * client写缓存(write-back)配置信息
+ * @enable: 是否开启写缓存，默认关闭
+ * @logDir: 本地持久化日志所在目录，写请求落到日志后即向上返回
+ * @maxDirtyMB: 每个文件最多缓存的脏数据，超过后写请求等待刷盘
+ * @flushThresholdMB: 脏数据超过该值后后台立即开始刷盘
+ * @maxLogSizeMB: 本地日志的最大大小，日志按段回收，超过后写请求等待最早的日志段刷盘
+ * @flushIntervalMS: 后台刷盘的周期
+ * @flushBatchSizeKB: 刷盘时合并连续脏数据的最大请求大小
+ */
+typedef struct WriteBackOption {
+    bool        enable;
+    std::string logDir;
+    uint64_t    maxDirtyMB;
+    uint64_t    flushThresholdMB;
+    uint64_t    maxLogSizeMB;
+    uint32_t    flushIntervalMS;
+    uint32_t    flushBatchSizeKB;
+    WriteBackOption() {
+        enable = false;
+        logDir = "/data/curve/writeback";
+        maxDirtyMB = 256;
+        flushThresholdMB = 64;
+        maxLogSizeMB = 1024;
+        flushIntervalMS = 1000;
+        flushBatchSizeKB = 4096;
+    }
+} WriteBackOption_t;
+
+/**
+ * client discard配置信息
+ * @enable: 是否开启discard，关闭时discard请求直接返回成功
+ * @granularityKB: 记录部分discard区间的粒度，不足一个粒度的部分被忽略
+ * @maxRecordChunkNum: 每个文件最多记录多少个chunk的部分discard区间
+ */
+typedef struct DiscardOption {
+    bool        enable;
+    uint32_t    granularityKB;
+    uint32_t    maxRecordChunkNum;
+    DiscardOption() {
+        enable = false;
+        granularityKB = 4;
+        maxRecordChunkNum = 1024;
+    }
+} DiscardOption_t;
+
+/**
+ * 单个令牌桶的限流参数，0表示不限制
+ * @limit: 每秒的平均限制，IOPS或者字节数
+ * @burst: 空闲时最多积累的额度，用于突发，不大于limit时只允许积累一秒的额度
+ */
+typedef struct ThrottleParams {
+    uint64_t    limit;
+    uint64_t    burst;
+    ThrottleParams() {
+        limit = 0;
+        burst = 0;
+    }
+} ThrottleParams_t;
+
+/**
+ * 文件的读写IOPS和带宽限流参数，可以由配置文件指定，也可以由mds随文件信息下发
+ */
+typedef struct FileThrottleParams {
+    ThrottleParams_t    readIOPS;
+    ThrottleParams_t    writeIOPS;
+    ThrottleParams_t    readBPS;
+    ThrottleParams_t    writeBPS;
+} FileThrottleParams_t;
+
+/**
+ * client QoS限流配置信息，每个文件单独限流
+ * @enable: 是否开启限流，默认关闭，开启后mds下发的参数优先于配置文件
+ * @params: 配置文件中的默认限流参数
+ */
+typedef struct ThrottleOption {
+    bool                    enable;
+    FileThrottleParams_t    params;
+    ThrottleOption() {
+        enable = false;
+    }
+} ThrottleOption_t;
+
+/**
+ * client IO分阶段耗时追踪配置信息
+ * @enable: 是否开启追踪，默认关闭，开启后记录每个用户读写IO在各个阶段的耗时
+ * @slowIOThresholdMS: 总耗时超过该值的IO为慢IO
+ * @slowIOSampleInterval: 每slowIOSampleInterval个慢IO采样一个保存完整耗时信息
+ * @slowIORecordNum: 每个文件最多保存的慢IO数量，超过后覆盖最早的记录
+ */
+typedef struct IOTraceOption {
+    bool        enable;
+    uint64_t    slowIOThresholdMS;
+    uint32_t    slowIOSampleInterval;
+    uint32_t    slowIORecordNum;
+    IOTraceOption() {
+        enable = false;
+        slowIOThresholdMS = 1000;
+        slowIOSampleInterval = 1;
+        slowIORecordNum = 64;
+    }
+} IOTraceOption_t;
+
 /**
  * IOOption存储了当前io 操作所需要的所有配置信息
  */
@@ -263,6 +478,12 @@ typedef struct IOOption {
     MetaCacheOption_t       metaCacheOpt;
     TaskThreadOption_t      taskThreadOpt;
     RequestScheduleOption_t reqSchdulerOpt;
+    ReadCacheOption_t       readCacheOpt;
+    ReadAheadOption_t       readAheadOpt;
+    WriteBackOption_t       writeBackOpt;
+    DiscardOption_t         discardOpt;
+    ThrottleOption_t        throttleOpt;
+    IOTraceOption_t         ioTraceOpt;
 } IOOption_t;
 
 /**
@@ -24,6 +24,9 @@
 
 #include <glog/logging.h>
 #include <unistd.h>
+#include <bthread/unstable.h>
+#include <butil/time.h>
+#include <limits>
 #include <memory>
 #include <utility>
 
@@ -32,6 +35,7 @@
 #include "src/client/client_config.h"
 #include "src/client/request_scheduler.h"
 #include "src/client/request_closure.h"
+#include "src/client/chunk_closure.h"
 
 using google::protobuf::Closure;
 namespace curve {
@@ -52,6 +56,7 @@ int CopysetClient::Init(MetaCache *metaCache,
         return -1;
     }
     iosenderopt_ = ioSenderOpt;
+    HedgeReadHelper::GetInstance().SetOption(iosenderopt_.hedgeReadOpt);
 
     LOG(INFO) << "CopysetClient init success, conf info: "
               << ", chunkserverOPRetryIntervalUS = "
@@ -124,6 +129,9 @@ int CopysetClient::ReadChunk(const ChunkIDInfo& idinfo, uint64_t sn,
 
     auto task = [&](Closure* done, std::shared_ptr<RequestSender> senderPtr) {
         ReadChunkClosure *readDone = new ReadChunkClosure(this, done);
+        readDone->SetHedgeReadState(PrepareHedgeRead(
+            idinfo, sn, offset, length, appliedindex, sourceInfo,
+            static_cast<RequestClosure*>(done), *senderPtr));
         senderPtr->ReadChunk(idinfo, sn, offset, length,
                              appliedindex, sourceInfo, readDone);
     };
@@ -131,6 +139,119 @@ int CopysetClient::ReadChunk(const ChunkIDInfo& idinfo, uint64_t sn,
     return DoRPCTask(idinfo, task, doneGuard.release());
 }
 
+std::shared_ptr<HedgeReadState> CopysetClient::PrepareHedgeRead(
+    const ChunkIDInfo& idinfo, uint64_t sn, off_t offset, size_t length,
+    uint64_t appliedindex, const RequestSourceInfo& sourceInfo,
+    RequestClosure* reqclosure, const RequestSender& sender) {
+    // 重试的请求沿用第一次发送时的对冲读状态
+    std::shared_ptr<HedgeReadState> state = reqclosure->GetHedgeReadState();
+    if (state != nullptr || reqclosure->GetRetriedTimes() > 1) {
+        return state;
+    }
+
+    // follower需要根据applied index判断数据是否足够新，
+    // 克隆数据需要由leader从源端拷贝，这两种情况都不对冲
+    HedgeReadHelper& helper = HedgeReadHelper::GetInstance();
+    if (!helper.Enabled() || !iosenderopt_.chunkserverEnableAppliedIndexRead ||
+        appliedindex == 0 || !sourceInfo.cloneFileSource.empty()) {
+        return nullptr;
+    }
+
+    ChunkServerID leaderId = sender.GetChunkServerID();
+    bool suspect = UnstableHelper::GetInstance().IsSuspect(
+        leaderId, sender.GetChunkServerEndPoint());
+    uint64_t delayUs = helper.GetHedgeDelayUs(leaderId, suspect);
+    if (delayUs == 0) {
+        return nullptr;
+    }
+
+    state = std::make_shared<HedgeReadState>(
+        this, idinfo, sn, offset, length, appliedindex, leaderId);
+
+    auto arg = new std::shared_ptr<HedgeReadState>(state);
+    bthread_timer_t timer;
+    if (bthread_timer_add(&timer, butil::microseconds_from_now(delayUs),
+                          OnHedgeReadTimer, arg) != 0) {
+        LOG(WARNING) << "add hedge read timer failed";
+        delete arg;
+        return nullptr;
+    }
+    state->SetTimer(timer, arg);
+
+    reqclosure->SetHedgeReadState(state);
+    return state;
+}
+
+void CopysetClient::OnHedgeReadTimer(void* arg) {
+    bthread_t tid;
+    if (bthread_start_background(&tid, nullptr, SendHedgeRead, arg) != 0) {
+        LOG(WARNING) << "start hedge read bthread failed";
+        delete static_cast<std::shared_ptr<HedgeReadState>*>(arg);
+    }
+}
+
+void* CopysetClient::SendHedgeRead(void* arg) {
+    std::unique_ptr<std::shared_ptr<HedgeReadState>> guard(
+        static_cast<std::shared_ptr<HedgeReadState>*>(arg));
+    const std::shared_ptr<HedgeReadState>& state = *guard;
+
+    // leader读请求已经返回时不再发起，此时copyset client可能已经释放
+    state->IssueHedge([&state]() {
+        state->GetCopysetClient()->HedgeReadChunk(state);
+    });
+
+    return nullptr;
+}
+
+void CopysetClient::HedgeReadChunk(
+    const std::shared_ptr<HedgeReadState>& state) {
+    const ChunkIDInfo& idinfo = state->GetChunkIDInfo();
+    CopysetInfo_t cpinfo = metaCache_->GetServerList(idinfo.lpid_,
+                                                     idinfo.cpid_);
+
+    // 选择没有超时、读latency最低的副本，没有latency样本的副本排在最后
+    const CopysetPeerInfo_t* target = nullptr;
+    uint64_t targetLatency = std::numeric_limits<uint64_t>::max();
+    for (const auto& peer : cpinfo.csinfos_) {
+        if (peer.chunkserverid_ == state->GetPrimaryID() ||
+            UnstableHelper::GetInstance().IsSuspect(peer.chunkserverid_,
+                                                    peer.csaddr_.addr_)) {
+            continue;
+        }
+
+        uint64_t latency = HedgeReadHelper::GetInstance().GetLatencyPercentile(
+            peer.chunkserverid_);
+        if (latency == 0) {
+            latency = std::numeric_limits<uint64_t>::max();
+        }
+        if (target == nullptr || latency < targetLatency) {
+            target = &peer;
+            targetLatency = latency;
+        }
+    }
+
+    if (target == nullptr ||
+        !HedgeReadHelper::GetInstance().AcquireHedgeQuota()) {
+        return;
+    }
+
+    auto senderPtr = senderManager_->GetOrCreateSender(
+        target->chunkserverid_, target->csaddr_.addr_, iosenderopt_);
+    if (senderPtr == nullptr) {
+        return;
+    }
+
+    DVLOG(3) << "send hedge read to chunkserver " << target->chunkserverid_
+             << ", logicpool id = " << idinfo.lpid_
+             << ", copyset id = " << idinfo.cpid_
+             << ", chunk id = " << idinfo.cid_
+             << ", leader id = " << state->GetPrimaryID();
+
+    MetricHelper::IncremHedgeReadCount(fileMetric_);
+    senderPtr->HedgeReadChunk(
+        *state, new HedgeReadClosure(state, target->chunkserverid_));
+}
+
 int CopysetClient::WriteChunk(const ChunkIDInfo& idinfo, uint64_t sn,
                               const char* buf, off_t offset, size_t length,
                               const RequestSourceInfo& sourceInfo,
@@ -203,6 +324,37 @@ int CopysetClient::DeleteChunkSnapshotOrCorrectSn(const ChunkIDInfo& idinfo,
     return DoRPCTask(idinfo, task, done);
 }
 
+int CopysetClient::DiscardChunk(const ChunkIDInfo& idinfo,
+    uint64_t sn, Closure *done) {
+    RequestClosure* reqclosure = static_cast<RequestClosure*>(done);
+
+    brpc::ClosureGuard doneGuard(done);
+
+    // 与写请求一样，session过期时重新入队等待续约成功，关闭文件时直接返回
+    if (sessionNotValid_ == true) {
+        if (exitFlag_) {
+            LOG(WARNING) << " return directly for session not valid at exit!"
+                        << ", copyset id = " << idinfo.cpid_
+                        << ", logical pool id = " << idinfo.lpid_
+                        << ", chunk id = " << idinfo.cid_;
+            return 0;
+        } else {
+            LOG(WARNING) << "session not valid, discard rpc ReSchedule!";
+            doneGuard.release();
+            reqclosure->ReleaseInflightRPCToken();
+            scheduler_->ReSchedule(reqclosure->GetReqCtx());
+            return 0;
+        }
+    }
+
+    auto task = [&](Closure* done, std::shared_ptr<RequestSender> senderPtr) {
+        DiscardChunkClosure *discardDone = new DiscardChunkClosure(this, done);
+        senderPtr->DiscardChunk(idinfo, sn, discardDone);
+    };
+
+    return DoRPCTask(idinfo, task, doneGuard.release());
+}
+
 int CopysetClient::GetChunkInfo(const ChunkIDInfo& idinfo, Closure *done) {
     auto task = [&](Closure* done, std::shared_ptr<RequestSender> senderPtr) {
         GetChunkInfoClosure *chunkInfoDone = new GetChunkInfoClosure(this, done);   // NOLINT
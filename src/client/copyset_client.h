@@ -40,6 +40,7 @@
 #include "src/client/request_sender_manager.h"
 #include "include/curve_compiler_specific.h"
 #include "src/client/inflight_controller.h"
+#include "src/client/hedge_read.h"
 
 namespace curve {
 namespace client {
@@ -52,6 +53,7 @@ using ::google::protobuf::Closure;
 // TODO(tongguangxun) :后续除了read、write的接口也需要调整重试逻辑
 class MetaCache;
 class RequestScheduler;
+class RequestClosure;
 /**
  * 负责管理 ChunkServer 的链接，向上层提供访问
  * 指定 copyset 的 chunk 的 read/write 等接口
@@ -140,6 +142,16 @@ class CopysetClient : public Uncopyable {
                   uint64_t correctedSn,
                   Closure *done);
 
+    /**
+     * discard整个chunk，chunk被快照或克隆使用时返回CHUNK_EXIST
+     * @param idinfo为chunk相关的id信息
+     * @param sn:文件版本号
+     * @param done:上一层异步回调的closure
+     */
+    int DiscardChunk(const ChunkIDInfo& idinfo,
+                  uint64_t sn,
+                  Closure *done);
+
     /**
      * 获取chunk文件的信息
      * @param idinfo为chunk相关的id信息
@@ -178,6 +190,12 @@ class CopysetClient : public Uncopyable {
                   uint64_t len,
                   Closure *done);
 
+    /**
+     * 向leader之外的副本发送对冲读，调用方持有对冲读状态的锁
+     * @param state:对冲读状态
+     */
+    void HedgeReadChunk(const std::shared_ptr<HedgeReadState>& state);
+
     /**
      * @brief 如果csId对应的RequestSender不健康，就进行重置
      * @param csId chunkserver id
@@ -217,6 +235,20 @@ class CopysetClient : public Uncopyable {
     friend class WriteChunkClosure;
     friend class ReadChunkClosure;
 
+    /**
+     * leader读请求第一次发送时决定是否对冲读，需要对冲时创建对冲读状态并启动定时器
+     * @return: 对冲读状态，不需要对冲时返回空
+     */
+    std::shared_ptr<HedgeReadState> PrepareHedgeRead(
+        const ChunkIDInfo& idinfo, uint64_t sn, off_t offset, size_t length,
+        uint64_t appliedindex, const RequestSourceInfo& sourceInfo,
+        RequestClosure* reqclosure, const RequestSender& sender);
+
+    // 对冲读定时器回调，在定时器线程中执行，另起bthread发送对冲读
+    static void OnHedgeReadTimer(void* arg);
+
+    static void* SendHedgeRead(void* arg);
+
     // 拉取新的leader信息
     bool FetchLeader(LogicPoolID lpid,
                      CopysetID cpid,
@@ -0,0 +1,146 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+#include "src/client/discard_recorder.h"
+
+namespace curve {
+namespace client {
+
+DiscardRecorder::DiscardRecorder()
+    : enable_(false),
+      granularity_(0),
+      maxRecordChunkNum_(0),
+      clock_(0),
+      fileMetric_(nullptr) {}
+
+void DiscardRecorder::Init(const DiscardOption_t& opt,
+                           FileMetric* fileMetric) {
+    fileMetric_ = fileMetric;
+    granularity_ = static_cast<uint64_t>(opt.granularityKB) * 1024;
+    maxRecordChunkNum_ = opt.maxRecordChunkNum;
+    enable_ = opt.enable && granularity_ > 0 && maxRecordChunkNum_ > 0;
+
+    LOG_IF(WARNING, opt.enable && !enable_)
+        << "discard recorder disabled, granularity = " << opt.granularityKB
+        << "KB, max record chunk num = " << opt.maxRecordChunkNum;
+}
+
+bool DiscardRecorder::Record(ChunkIndex index, uint64_t offset,
+                             uint64_t length, uint64_t chunkSize) {
+    if (!enable_ || chunkSize == 0 || chunkSize % granularity_ != 0) {
+        return false;
+    }
+
+    // 只记录被完整覆盖的粒度
+    uint64_t start = (offset + granularity_ - 1) / granularity_;
+    uint64_t end = (offset + length) / granularity_;
+    if (start >= end) {
+        return false;
+    }
+
+    std::lock_guard<Mutex> lk(mtx_);
+    auto iter = records_.find(index);
+    if (iter == records_.end()) {
+        if (records_.size() >= maxRecordChunkNum_) {
+            Evict();
+        }
+        ChunkRecord record;
+        record.bitmap.reset(new Bitmap(chunkSize / granularity_));
+        iter = records_.emplace(index, std::move(record)).first;
+    }
+
+    Bitmap* bitmap = iter->second.bitmap.get();
+    bitmap->Set(start, end - 1);
+    iter->second.lastUpdate = ++clock_;
+    MetricHelper::IncremDiscardRecordBytes(fileMetric_,
+                                           (end - start) * granularity_);
+
+    if (bitmap->NextClearBit(0) != Bitmap::NO_POS) {
+        return false;
+    }
+
+    records_.erase(iter);
+    return true;
+}
+
+void DiscardRecorder::Clear(uint64_t offset, uint64_t length,
+                            uint64_t chunkSize) {
+    if (!enable_ || length == 0 || chunkSize == 0) {
+        return;
+    }
+
+    uint64_t end = offset + length;
+
+    std::lock_guard<Mutex> lk(mtx_);
+    if (records_.empty()) {
+        return;
+    }
+
+    while (offset < end) {
+        ChunkIndex index = offset / chunkSize;
+        uint64_t chunkEnd = (static_cast<uint64_t>(index) + 1) * chunkSize;
+        uint64_t clearEnd = std::min(end, chunkEnd);
+
+        auto iter = records_.find(index);
+        if (iter != records_.end()) {
+            // 部分覆盖的粒度也要清除
+            uint32_t startBit = (offset % chunkSize) / granularity_;
+            uint32_t endBit = (clearEnd - 1 - index * chunkSize) / granularity_;
+            iter->second.bitmap->Clear(startBit, endBit);
+        }
+
+        offset = clearEnd;
+    }
+}
+
+void DiscardRecorder::Clear(ChunkIndex index) {
+    if (!enable_) {
+        return;
+    }
+
+    std::lock_guard<Mutex> lk(mtx_);
+    records_.erase(index);
+}
+
+void DiscardRecorder::Drop() {
+    std::lock_guard<Mutex> lk(mtx_);
+    records_.clear();
+}
+
+uint32_t DiscardRecorder::GetRecordChunkNum() {
+    std::lock_guard<Mutex> lk(mtx_);
+    return records_.size();
+}
+
+void DiscardRecorder::Evict() {
+    auto victim = std::min_element(records_.begin(), records_.end(),
+        [](const std::pair<const ChunkIndex, ChunkRecord>& a,
+           const std::pair<const ChunkIndex, ChunkRecord>& b) {
+            return a.second.lastUpdate < b.second.lastUpdate;
+        });
+    records_.erase(victim);
+}
+
+}   // namespace client
+}   // namespace curve
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_CLIENT_DISCARD_RECORDER_H_
+#define SRC_CLIENT_DISCARD_RECORDER_H_
+
+#include <memory>
+#include <unordered_map>
+
+#include "src/client/client_common.h"
+#include "src/client/client_metric.h"
+#include "src/client/config_info.h"
+#include "src/common/bitmap.h"
+#include "src/common/concurrent/concurrent.h"
+
+namespace curve {
+namespace client {
+
+using curve::common::Bitmap;
+using curve::common::Mutex;
+
+/**
+ * 记录只覆盖chunk部分区间的discard请求
+ * 1. 每个chunk用一个bitmap记录已经被discard的区间，粒度为granularityKB，
+ *    discard区间首尾不足一个粒度的部分被忽略
+ * 2. 一个chunk的全部区间都被discard后返回true，由调用方删除整个chunk，
+ *    并清除该chunk的记录
+ * 3. 写请求覆盖到的区间不再是discard状态，需要在写请求下发前清除
+ * 4. 最多记录maxRecordChunkNum个chunk，超过后淘汰最久未更新的记录，
+ *    被淘汰的区间只是不会被删除，不影响正确性
+ */
+class DiscardRecorder {
+ public:
+    DiscardRecorder();
+
+    /**
+     * 初始化
+     * @param: opt为discard配置信息
+     * @param: fileMetric为文件的metric，可以为空
+     */
+    void Init(const DiscardOption_t& opt, FileMetric* fileMetric);
+
+    bool Enabled() const {
+        return enable_;
+    }
+
+    /**
+     * 记录chunk内[offset, offset + length)区间被discard
+     * @param: index为chunk在文件中的索引
+     * @param: offset为chunk内的偏移
+     * @param: length为discard的长度
+     * @param: chunkSize为文件的chunk大小，需要是粒度的整数倍
+     * @return: chunk的全部区间都已被discard时返回true
+     */
+    bool Record(ChunkIndex index, uint64_t offset, uint64_t length,
+                uint64_t chunkSize);
+
+    /**
+     * 清除文件[offset, offset + length)区间的discard记录
+     */
+    void Clear(uint64_t offset, uint64_t length, uint64_t chunkSize);
+
+    /**
+     * 清除整个chunk的discard记录
+     */
+    void Clear(ChunkIndex index);
+
+    /**
+     * 丢弃所有记录
+     */
+    void Drop();
+
+    /**
+     * 获取当前记录的chunk数量
+     */
+    uint32_t GetRecordChunkNum();
+
+ private:
+    struct ChunkRecord {
+        std::unique_ptr<Bitmap> bitmap;
+        uint64_t lastUpdate;
+    };
+
+    /**
+     * 淘汰最久未更新的记录，调用方持有mtx_
+     */
+    void Evict();
+
+ private:
+    bool enable_;
+    uint64_t granularity_;
+    uint32_t maxRecordChunkNum_;
+
+    // 保护下面的记录
+    Mutex mtx_;
+    std::unordered_map<ChunkIndex, ChunkRecord> records_;
+    uint64_t clock_;
+
+    FileMetric* fileMetric_;
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // SRC_CLIENT_DISCARD_RECORDER_H_
@@ -122,6 +122,15 @@ int FileInstance::AioRead(CurveAioContext* aioctx) {
     return iomanager4file_.AioRead(aioctx, mdsclient_);
 }
 
+int FileInstance::AioReadIOBuf(CurveAioContext* aioctx, butil::IOBuf* data) {
+    return iomanager4file_.AioReadIOBuf(aioctx, data, mdsclient_);
+}
+
+int FileInstance::AioReadv(CurveAioContext* aioctx,
+                           const std::vector<iovec>& iov) {
+    return iomanager4file_.AioReadv(aioctx, iov, mdsclient_);
+}
+
 int FileInstance::AioWrite(CurveAioContext* aioctx) {
     if (readonly_) {
         DVLOG(9) << "open with read only, do not support write!";
@@ -130,6 +139,27 @@ int FileInstance::AioWrite(CurveAioContext* aioctx) {
     return iomanager4file_.AioWrite(aioctx, mdsclient_);
 }
 
+int FileInstance::AioWritev(CurveAioContext* aioctx,
+                            const std::vector<iovec>& iov) {
+    if (readonly_) {
+        DVLOG(9) << "open with read only, do not support write!";
+        return -1;
+    }
+    return iomanager4file_.AioWritev(aioctx, iov, mdsclient_);
+}
+
+int FileInstance::AioFlush(CurveAioContext* aioctx) {
+    return iomanager4file_.AioFlush(aioctx);
+}
+
+int FileInstance::AioDiscard(CurveAioContext* aioctx) {
+    if (readonly_) {
+        DVLOG(9) << "open with read only, do not support discard!";
+        return -1;
+    }
+    return iomanager4file_.AioDiscard(aioctx, mdsclient_);
+}
+
 // 两种场景会造成在Open的时候返回LIBCURVE_ERROR::FILE_OCCUPIED
 // 1. 强制重启qemu不会调用close逻辑，然后启动的时候原来的文件sessio还没过期.
 //    导致再次去发起open的时候，返回被占用，这种情况可以通过load sessionmap
@@ -148,6 +178,13 @@ int FileInstance::Open(const std::string& filename,
     if (ret == LIBCURVE_ERROR::OK) {
         ret = leaseexcutor_->Start(finfo_, lease) ? LIBCURVE_ERROR::OK
                                                   : LIBCURVE_ERROR::FAILED;
+        // 写缓存启动时会回放上次未刷盘的数据，只读打开的文件不启动写缓存
+        if (ret == LIBCURVE_ERROR::OK && !readonly_ &&
+            iomanager4file_.StartWriteBack() != 0) {
+            LOG(ERROR) << "start write back cache failed, filename = "
+                       << filename;
+            ret = LIBCURVE_ERROR::FAILED;
+        }
         if (nullptr != sessionId) {
             sessionId->assign(lease.sessionID);
         }
@@ -173,6 +210,13 @@ int FileInstance::Close() {
         return 0;
     }
 
+    // 关闭文件前需要将写缓存中的脏数据刷到chunkserver
+    if (iomanager4file_.Flush() != 0) {
+        LOG(ERROR) << "flush write back cache failed, filename = "
+                   << finfo_.fullPathName;
+        return -LIBCURVE_ERROR::FAILED;
+    }
+
     LIBCURVE_ERROR ret = mdsclient_->CloseFile(finfo_.fullPathName,
                          finfo_.userinfo, leaseexcutor_->GetLeaseSessionID());
     return -ret;
@@ -105,12 +105,45 @@ class CURVE_CACHELINE_ALIGNMENT FileInstance {
      * @return: 0为成功，小于0为失败
      */
     int AioRead(CurveAioContext* aioctx);
+    /**
+     * 异步模式读，数据以IOBuf的形式返回，不拷贝到用户buffer
+     * @param: aioctx为异步读写的io上下文，保存基本的io信息
+     * @param: data用于保存读到的数据
+     * @return: 0为成功，小于0为失败
+     */
+    int AioReadIOBuf(CurveAioContext* aioctx, butil::IOBuf* data);
+    /**
+     * 异步模式读，读到的数据按顺序填充到iov的各段buffer中
+     * @param: aioctx为异步读写的io上下文，保存基本的io信息，不使用其中的buf
+     * @param: iov为用户的buffer数组
+     * @return: 0为成功，小于0为失败
+     */
+    int AioReadv(CurveAioContext* aioctx, const std::vector<iovec>& iov);
     /**
      * 异步模式写
      * @param: aioctx为异步读写的io上下文，保存基本的io信息
      * @return: 0为成功，小于0为失败
      */
     int AioWrite(CurveAioContext* aioctx);
+    /**
+     * 异步模式写，写入iov中各段buffer拼接而成的数据
+     * @param: aioctx为异步读写的io上下文，保存基本的io信息，不使用其中的buf
+     * @param: iov为用户的buffer数组
+     * @return: 0为成功，小于0为失败
+     */
+    int AioWritev(CurveAioContext* aioctx, const std::vector<iovec>& iov);
+    /**
+     * 异步模式flush
+     * @param: aioctx为异步io上下文
+     * @return: 0为成功，小于0为失败
+     */
+    int AioFlush(CurveAioContext* aioctx);
+    /**
+     * 异步模式discard
+     * @param: aioctx为异步io上下文，保存discard的offset和length
+     * @return: 0为成功，小于0为失败
+     */
+    int AioDiscard(CurveAioContext* aioctx);
 
     int Close();
 
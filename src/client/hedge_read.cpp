@@ -0,0 +1,274 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <glog/logging.h>
+#include <bthread/unstable.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "src/client/hedge_read.h"
+
+using curve::common::ReadLockGuard;
+using curve::common::WriteLockGuard;
+
+namespace curve {
+namespace client {
+
+const uint32_t LatencyHistogram::kMinSampleNum;
+const uint32_t LatencyHistogram::kUpdateInterval;
+const uint32_t LatencyHistogram::kDecayInterval;
+const uint32_t LatencyHistogram::kSubBucketBits;
+const uint32_t LatencyHistogram::kSubBucketNum;
+const uint32_t LatencyHistogram::kBucketNum;
+
+const int64_t HedgeReadHelper::kQuotaPerHedge;
+const int64_t HedgeReadHelper::kMaxBurstHedge;
+
+LatencyHistogram::LatencyHistogram(uint32_t percentile)
+    : percentile_(std::min(percentile, 100u)),
+      total_(0),
+      sinceDecay_(0),
+      sinceUpdate_(0),
+      percentileUs_(0) {
+    memset(buckets_, 0, sizeof(buckets_));
+}
+
+uint32_t LatencyHistogram::BucketIndex(uint64_t value) {
+    if (value < kSubBucketNum) {
+        return value;
+    }
+
+    uint32_t exp = 63 - __builtin_clzll(value);
+    uint32_t sub = (value >> (exp - kSubBucketBits)) & (kSubBucketNum - 1);
+    return (exp - kSubBucketBits + 1) * kSubBucketNum + sub;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(uint32_t index) {
+    if (index < kSubBucketNum) {
+        return index;
+    }
+
+    uint32_t exp = index / kSubBucketNum + kSubBucketBits - 1;
+    uint64_t sub = index % kSubBucketNum;
+    return ((kSubBucketNum + sub + 1) << (exp - kSubBucketBits)) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t latencyUs) {
+    // 样本足够多，丢弃部分样本不影响结果，不让RPC回调等锁
+    std::unique_lock<std::mutex> lk(mtx_, std::try_to_lock);
+    if (!lk.owns_lock()) {
+        return;
+    }
+
+    ++buckets_[BucketIndex(latencyUs)];
+    ++total_;
+
+    if (++sinceDecay_ >= kDecayInterval) {
+        total_ = 0;
+        for (uint32_t i = 0; i < kBucketNum; ++i) {
+            buckets_[i] >>= 1;
+            total_ += buckets_[i];
+        }
+        sinceDecay_ = 0;
+    }
+
+    if (++sinceUpdate_ >= kUpdateInterval) {
+        Update();
+        sinceUpdate_ = 0;
+    }
+}
+
+void LatencyHistogram::Update() {
+    if (total_ < kMinSampleNum || percentile_ == 0) {
+        percentileUs_.store(0, std::memory_order_relaxed);
+        return;
+    }
+
+    uint64_t target = (total_ * percentile_ + 99) / 100;
+    uint64_t count = 0;
+    uint32_t index = 0;
+    for (; index < kBucketNum; ++index) {
+        count += buckets_[index];
+        if (count >= target) {
+            break;
+        }
+    }
+
+    percentileUs_.store(BucketUpperBound(index), std::memory_order_relaxed);
+}
+
+void HedgeReadHelper::SetOption(const HedgeReadOption_t& opt) {
+    option_ = opt;
+    enable_ = opt.enable && opt.latencyPercentile > 0 &&
+              opt.latencyPercentile <= 100 && opt.maxHedgePercent > 0;
+
+    LOG_IF(WARNING, opt.enable && !enable_)
+        << "hedge read disabled, latency percentile = "
+        << opt.latencyPercentile
+        << ", max hedge percent = " << opt.maxHedgePercent;
+}
+
+LatencyHistogram* HedgeReadHelper::GetHistogram(ChunkServerID csId,
+                                                bool create) {
+    {
+        ReadLockGuard lk(rwlock_);
+        auto iter = histograms_.find(csId);
+        if (iter != histograms_.end()) {
+            return iter->second.get();
+        }
+    }
+
+    if (!create) {
+        return nullptr;
+    }
+
+    WriteLockGuard lk(rwlock_);
+    auto& histogram = histograms_[csId];
+    if (histogram == nullptr) {
+        histogram.reset(new LatencyHistogram(option_.latencyPercentile));
+    }
+    return histogram.get();
+}
+
+void HedgeReadHelper::RecordLatency(ChunkServerID csId, uint64_t latencyUs) {
+    if (!enable_) {
+        return;
+    }
+
+    GetHistogram(csId, true)->Record(latencyUs);
+}
+
+uint64_t HedgeReadHelper::GetLatencyPercentile(ChunkServerID csId) {
+    LatencyHistogram* histogram = GetHistogram(csId, false);
+    return histogram == nullptr ? 0 : histogram->GetPercentile();
+}
+
+uint64_t HedgeReadHelper::GetHedgeDelayUs(ChunkServerID csId, bool suspect) {
+    if (!enable_) {
+        return 0;
+    }
+
+    // 额度可能短暂超过上限，不影响限制对冲读的比例
+    const int64_t maxQuota = kMaxBurstHedge * kQuotaPerHedge;
+    int64_t quota = quota_.fetch_add(option_.maxHedgePercent,
+                                     std::memory_order_relaxed);
+    if (quota + option_.maxHedgePercent > maxQuota) {
+        quota_.store(maxQuota, std::memory_order_relaxed);
+    }
+
+    uint64_t minDelayUs = static_cast<uint64_t>(option_.minDelayMS) * 1000;
+    if (suspect) {
+        return std::max<uint64_t>(minDelayUs, 1);
+    }
+
+    uint64_t percentileUs = GetLatencyPercentile(csId);
+    if (percentileUs == 0) {
+        return 0;
+    }
+
+    return std::max(percentileUs, minDelayUs);
+}
+
+bool HedgeReadHelper::AcquireHedgeQuota() {
+    int64_t quota = quota_.load(std::memory_order_relaxed);
+    while (quota >= kQuotaPerHedge) {
+        if (quota_.compare_exchange_weak(quota, quota - kQuotaPerHedge,
+                                         std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void HedgeReadHelper::ResetState() {
+    WriteLockGuard lk(rwlock_);
+    histograms_.clear();
+    quota_.store(0);
+}
+
+bool HedgeReadState::RegisterPrimaryCall(brpc::CallId callId) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (hedgeSucceeded_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    primaryCallId_ = callId;
+    return true;
+}
+
+void HedgeReadState::SetTimer(bthread_timer_t timer,
+                              std::shared_ptr<HedgeReadState>* arg) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    hasTimer_ = true;
+    timer_ = timer;
+    timerArg_ = arg;
+}
+
+void HedgeReadState::MarkDone() {
+    bool hasTimer = false;
+    bthread_timer_t timer;
+    std::shared_ptr<HedgeReadState>* arg = nullptr;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        done_ = true;
+        std::swap(hasTimer, hasTimer_);
+        timer = timer_;
+        arg = timerArg_;
+    }
+
+    // 读请求在等待时间内返回时删除定时器，不再唤醒一个bthread，
+    // 定时器已经触发时由回调释放参数
+    if (hasTimer && bthread_timer_del(timer) == 0) {
+        delete arg;
+    }
+}
+
+bool HedgeReadState::IssueHedge(const std::function<void()>& sendFunc) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (done_ || hedgeSucceeded_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    sendFunc();
+    return true;
+}
+
+bool HedgeReadState::OnHedgeSuccess(butil::IOBuf* data) {
+    brpc::CallId callId;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (done_ || hedgeSucceeded_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        data_.swap(*data);
+        hedgeSucceeded_.store(true, std::memory_order_release);
+        callId = primaryCallId_;
+    }
+
+    // leader读请求已经返回或者正在重试时取消不生效，重试发送前会检查对冲读结果
+    brpc::StartCancel(callId);
+    return true;
+}
+
+}   // namespace client
+}   // namespace curve
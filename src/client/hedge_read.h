@@ -0,0 +1,272 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_CLIENT_HEDGE_READ_H_
+#define SRC_CLIENT_HEDGE_READ_H_
+
+#include <brpc/controller.h>
+#include <bthread/bthread.h>
+#include <butil/iobuf.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>    // NOLINT
+#include <unordered_map>
+
+#include "src/client/client_common.h"
+#include "src/client/config_info.h"
+#include "src/common/concurrent/rw_lock.h"
+
+namespace curve {
+namespace client {
+
+using curve::common::RWLock;
+
+class CopysetClient;
+
+/**
+ * 按对数分桶的latency直方图，用于估计chunkserver读latency的百分位
+ * 1. 每个2的幂次区间再均分为8个桶，相对误差不超过12.5%
+ * 2. 每收集kDecayInterval个样本，所有桶的计数减半，使结果跟随latency的变化
+ * 3. 每收集kUpdateInterval个样本重新计算一次百分位，读取时不用加锁
+ */
+class LatencyHistogram {
+ public:
+    explicit LatencyHistogram(uint32_t percentile);
+
+    /**
+     * 记录一个样本，锁被占用时直接丢弃该样本
+     * @param: latencyUs为读请求的latency
+     */
+    void Record(uint64_t latencyUs);
+
+    /**
+     * 获取latency的百分位，单位为us，样本数不足kMinSampleNum时返回0
+     */
+    uint64_t GetPercentile() const {
+        return percentileUs_.load(std::memory_order_relaxed);
+    }
+
+    // 计算百分位需要的最少样本数
+    static const uint32_t kMinSampleNum = 64;
+
+    // 每收集多少个样本重新计算一次百分位
+    static const uint32_t kUpdateInterval = 16;
+
+    // 每收集多少个样本把历史样本的权重减半
+    static const uint32_t kDecayInterval = 1024;
+
+ private:
+    static uint32_t BucketIndex(uint64_t value);
+    static uint64_t BucketUpperBound(uint32_t index);
+
+    void Update();
+
+ private:
+    // 每个2的幂次区间内的桶数为2^kSubBucketBits
+    static const uint32_t kSubBucketBits = 3;
+    static const uint32_t kSubBucketNum = 1 << kSubBucketBits;
+    static const uint32_t kBucketNum =
+        (64 - kSubBucketBits + 1) * kSubBucketNum;
+
+    const uint32_t percentile_;
+
+    std::mutex mtx_;
+    uint32_t buckets_[kBucketNum];
+    uint64_t total_;
+    uint32_t sinceDecay_;
+    uint32_t sinceUpdate_;
+
+    std::atomic<uint64_t> percentileUs_;
+};
+
+/**
+ * 记录每个chunkserver的读latency，决定对冲读的等待时间和发往哪个副本
+ * chunkserver id在集群内唯一，与UnstableHelper一样所有文件共用一份
+ */
+class HedgeReadHelper {
+ public:
+    static HedgeReadHelper& GetInstance() {
+        static HedgeReadHelper helper;
+        return helper;
+    }
+
+    void SetOption(const HedgeReadOption_t& opt);
+
+    bool Enabled() const {
+        return enable_;
+    }
+
+    /**
+     * 记录发往chunkserver的读请求成功返回的latency
+     */
+    void RecordLatency(ChunkServerID csId, uint64_t latencyUs);
+
+    /**
+     * 获取chunkserver读latency的百分位，没有足够样本时返回0
+     */
+    uint64_t GetLatencyPercentile(ChunkServerID csId);
+
+    /**
+     * 每个可以对冲的读请求发送前调用一次，同时累积对冲读的额度
+     * @param: csId为读请求发往的chunkserver
+     * @param: suspect为chunkserver最近是否有超时的请求，是则用最小等待时间
+     * @return: 发起对冲读前的等待时间，返回0表示不发起对冲读
+     */
+    uint64_t GetHedgeDelayUs(ChunkServerID csId, bool suspect);
+
+    /**
+     * 发起对冲读前获取额度，对冲读请求数最多占读请求数的maxHedgePercent
+     * @return: 额度不足返回false
+     */
+    bool AcquireHedgeQuota();
+
+    // 测试使用，重置状态
+    void ResetState();
+
+    // 每个对冲读消耗的额度，每个读请求累积maxHedgePercent
+    static const int64_t kQuotaPerHedge = 100;
+
+    // 额度最多累积到可以连续发起的对冲读的个数
+    static const int64_t kMaxBurstHedge = 64;
+
+ private:
+    HedgeReadHelper() : enable_(false), quota_(0) {}
+
+    LatencyHistogram* GetHistogram(ChunkServerID csId, bool create);
+
+ private:
+    bool enable_;
+    HedgeReadOption_t option_;
+
+    RWLock rwlock_;
+    std::unordered_map<ChunkServerID, std::unique_ptr<LatencyHistogram>>
+        histograms_;
+
+    std::atomic<int64_t> quota_;
+};
+
+/**
+ * 一个读请求与其对冲读共享的状态
+ * 上层的closure只由发往leader的读请求(包括其重试)调用，对冲读成功后把数据
+ * 暂存在这里，然后取消正在进行的leader读请求，由其回调把数据交给上层。
+ * 这样对冲读不会与leader读请求的重试并发访问上层的请求上下文
+ */
+class HedgeReadState {
+ public:
+    HedgeReadState(CopysetClient* client,
+                   const ChunkIDInfo& idinfo,
+                   uint64_t sn,
+                   off_t offset,
+                   size_t length,
+                   uint64_t appliedIndex,
+                   ChunkServerID primaryId)
+        : client_(client),
+          idinfo_(idinfo),
+          sn_(sn),
+          offset_(offset),
+          length_(length),
+          appliedIndex_(appliedIndex),
+          primaryId_(primaryId),
+          done_(false),
+          hedgeSucceeded_(false),
+          primaryCallId_(brpc::CallId()),
+          hasTimer_(false),
+          timer_(),
+          timerArg_(nullptr) {}
+
+    /**
+     * 登记发起对冲读的定时器，请求结束时定时器还未触发则删除
+     * @param: timer为定时器id
+     * @param: arg为定时器回调的参数，删除定时器时由state释放
+     */
+    void SetTimer(bthread_timer_t timer,
+                  std::shared_ptr<HedgeReadState>* arg);
+
+    /**
+     * 发送leader读请求前登记其call id，用于对冲读成功后取消
+     * @return: 对冲读已经成功时返回false，不用再发送
+     */
+    bool RegisterPrimaryCall(brpc::CallId callId);
+
+    /**
+     * 请求返回给上层前调用，之后不再发起对冲读，并删除还未触发的定时器
+     */
+    void MarkDone();
+
+    /**
+     * 请求未结束时在锁内发送对冲读，防止发送期间文件被关闭
+     * @return: 请求已经结束返回false
+     */
+    bool IssueHedge(const std::function<void()>& sendFunc);
+
+    /**
+     * 对冲读成功，保存数据并取消正在进行的leader读请求
+     * @param: data为读到的数据，会被移走
+     * @return: 请求已经结束或对冲读已经成功过返回false
+     */
+    bool OnHedgeSuccess(butil::IOBuf* data);
+
+    bool HedgeSucceeded() const {
+        return hedgeSucceeded_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * 获取对冲读的数据，与state共享数据块，HedgeSucceeded为true时才能调用
+     */
+    butil::IOBuf GetHedgeData() const {
+        return data_;
+    }
+
+    CopysetClient* GetCopysetClient() const { return client_; }
+    const ChunkIDInfo& GetChunkIDInfo() const { return idinfo_; }
+    uint64_t GetSn() const { return sn_; }
+    off_t GetOffset() const { return offset_; }
+    size_t GetLength() const { return length_; }
+    uint64_t GetAppliedIndex() const { return appliedIndex_; }
+    ChunkServerID GetPrimaryID() const { return primaryId_; }
+
+ private:
+    // 以下请求信息在创建时拷贝，对冲读不访问上层的请求上下文
+    CopysetClient* client_;
+    ChunkIDInfo idinfo_;
+    uint64_t sn_;
+    off_t offset_;
+    size_t length_;
+    uint64_t appliedIndex_;
+    ChunkServerID primaryId_;
+
+    std::mutex mtx_;
+    bool done_;
+    std::atomic<bool> hedgeSucceeded_;
+    brpc::CallId primaryCallId_;
+    butil::IOBuf data_;
+
+    // 发起对冲读的定时器，回调执行后timerArg_由回调释放
+    bool hasTimer_;
+    bthread_timer_t timer_;
+    std::shared_ptr<HedgeReadState>* timerArg_;
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // SRC_CLIENT_HEDGE_READ_H_
@@ -23,6 +23,13 @@
 #ifndef SRC_CLIENT_INFLIGHT_CONTROLLER_H_
 #define SRC_CLIENT_INFLIGHT_CONTROLLER_H_
 
+#include <bthread/condition_variable.h>
+#include <bthread/mutex.h>
+#include <glog/logging.h>
+
+#include <atomic>
+#include <mutex>    // NOLINT
+
 #include "src/common/concurrent/concurrent.h"
 
 using curve::common::Mutex;
@@ -30,24 +37,33 @@ using curve::common::ConditionVariable;
 
 namespace curve {
 namespace client {
+
+/**
+ * inflight请求数的准入控制，类似计数信号量
+ * 1. 获取和释放令牌只操作原子计数，不加锁
+ * 2. 只有inflight数达到上限时，获取令牌的线程才加锁等待，
+ *    释放令牌时发现有等待者才加锁唤醒，正常情况下请求返回的路径上没有锁
+ * 3. 等待使用bthread的锁和条件变量，在bthread和pthread中调用都不会阻塞worker
+ */
 class InflightControl {
  public:
-    InflightControl() {
-        curInflightIONum_.store(0);
-    }
+    InflightControl()
+        : maxInflightNum_(UINT64_MAX),
+          curInflightIONum_(0),
+          waiters_(0) {}
 
     void SetMaxInflightNum(uint64_t maxInflightNum) {
-        maxInflightNum_ = maxInflightNum;
+        maxInflightNum_.store(maxInflightNum, std::memory_order_relaxed);
     }
 
     /**
      * 调用该接口等待inflight全部回来，这段期间是hang的
      */
     void WaitInflightAllComeBack() {
-        LOG(INFO) << "wait inflight to complete, count = " << curInflightIONum_;
-        std::unique_lock<std::mutex> lk(inflightAllComeBackmtx_);
-        inflightAllComeBackcv_.wait(lk, [this]() {
-            return curInflightIONum_.load(std::memory_order_acquire) == 0;
+        LOG(INFO) << "wait inflight to complete, count = "
+                  << curInflightIONum_.load();
+        WaitUntil([this]() {
+            return curInflightIONum_.load() == 0;
         });
         LOG(INFO) << "inflight ALL come back.";
     }
@@ -56,63 +72,90 @@ class InflightControl {
      * 调用该接口等待inflight回来，这段期间是hang的
      */
     void WaitInflightComeBack() {
-        if (curInflightIONum_.load() >= maxInflightNum_) {
-            std::unique_lock<Mutex> lk(inflightComeBackmtx_);
-            inflightComeBackcv_.wait(lk, [this]() {
-                return curInflightIONum_.load() < maxInflightNum_;
-            });
+        if (curInflightIONum_.load(std::memory_order_acquire) <
+            maxInflightNum_.load(std::memory_order_relaxed)) {
+            return;
         }
+
+        WaitUntil([this]() {
+            return curInflightIONum_.load() <
+                   maxInflightNum_.load(std::memory_order_relaxed);
+        });
     }
 
     /**
      * 递增inflight num
      */
     void IncremInflightNum() {
-        curInflightIONum_.fetch_add(1, std::memory_order_release);
+        curInflightIONum_.fetch_add(1, std::memory_order_relaxed);
     }
 
     /**
-     * 递减inflight num
+     * 递减inflight num，没有等待者时不加锁
      */
     void DecremInflightNum() {
-        std::lock_guard<Mutex> lk(inflightComeBackmtx_);
-        {
-            std::lock_guard<Mutex> lk(inflightAllComeBackmtx_);
-            curInflightIONum_.fetch_sub(1, std::memory_order_release);
-            if (curInflightIONum_.load() == 0) {
-                inflightAllComeBackcv_.notify_all();
-            }
+        // 与WaitUntil中的waiters_递增和条件检查都是顺序一致的，
+        // 要么这里看到等待者去唤醒，要么等待者看到递减后的计数，不会丢失唤醒
+        curInflightIONum_.fetch_sub(1);
+        if (waiters_.load() > 0) {
+            std::lock_guard<bthread::Mutex> lk(mtx_);
+            cond_.notify_all();
         }
-        inflightComeBackcv_.notify_one();
     }
 
     /**
-     * WaitInflightComeBack会检查当前未返回的io数量是否超过我们限制的最大未返回inflight数量
-     * 但是真正的inflight数量与上层并发调用的线程数有关。
-     * 假设我们设置的maxinflight=100，上层有三个线程在同时调用GetInflightToken，
-     * 如果这个时候inflight数量为99，那么并发状况下这3个线程在WaitInflightComeBack
-     * 都会通过然后向下并发执行IncremInflightNum，这个时候真正的inflight为102，
-     * 下一个下发的时候需要等到inflight数量小于100才能继续，也就是等至少3个IO回来才能继续
-     * 下发。这个误差是可以接受的，他与scheduler一侧并发度有关，误差有上限。
-     * 如果想要精确控制inflight数量，就需要在接口处加锁，让原本可以并发的逻辑变成了
-     * 串行，这样得不偿失。因此我们这里选择容忍一定误差范围。
+     * 获取令牌，inflight数达到上限时等待
+     * 通过CAS递增计数，并发调用时inflight数也不会超过上限
      */
     void GetInflightToken() {
-        WaitInflightComeBack();
-        IncremInflightNum();
+        uint64_t cur = curInflightIONum_.load(std::memory_order_relaxed);
+        while (true) {
+            if (cur < maxInflightNum_.load(std::memory_order_relaxed)) {
+                if (curInflightIONum_.compare_exchange_weak(
+                        cur, cur + 1, std::memory_order_acq_rel,
+                        std::memory_order_relaxed)) {
+                    return;
+                }
+                continue;
+            }
+
+            WaitInflightComeBack();
+            cur = curInflightIONum_.load(std::memory_order_relaxed);
+        }
     }
 
     void ReleaseInflightToken() {
         DecremInflightNum();
     }
 
+    /**
+     * 获取当前inflight数，测试使用
+     */
+    uint64_t GetInflightNum() const {
+        return curInflightIONum_.load(std::memory_order_relaxed);
+    }
+
+ private:
+    /**
+     * 慢路径，加锁等待直到条件满足
+     */
+    template <typename Pred>
+    void WaitUntil(Pred pred) {
+        std::unique_lock<bthread::Mutex> lk(mtx_);
+        waiters_.fetch_add(1);
+        while (!pred()) {
+            cond_.wait(lk);
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
  private:
-    uint64_t              maxInflightNum_;
-    std::atomic<uint64_t> curInflightIONum_;
-    Mutex                 inflightComeBackmtx_;
-    ConditionVariable     inflightComeBackcv_;
-    Mutex                 inflightAllComeBackmtx_;
-    ConditionVariable     inflightAllComeBackcv_;
+    std::atomic<uint64_t>       maxInflightNum_;
+    std::atomic<uint64_t>       curInflightIONum_;
+    // 正在等待的线程数，为0时释放令牌不用加锁
+    std::atomic<uint32_t>       waiters_;
+    bthread::Mutex              mtx_;
+    bthread::ConditionVariable  cond_;
 };
 
 }   //  namespace client
@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+#include "src/client/io_trace.h"
+
+namespace curve {
+namespace client {
+
+std::ostream& operator<<(std::ostream& os, const IOTraceRecord& record) {
+    const RequestTrace& req = record.slowestRequest;
+    os << "IO id = " << record.ioId
+       << ", type = " << OpTypeToString(record.type)
+       << ", offset = " << record.offset
+       << ", length = " << record.length
+       << ", errcode = " << record.errcode
+       << ", submit time(us) = " << record.submitUs
+       << ", total(us) = " << record.totalUs
+       << ", task queue(us) = " << record.taskQueueUs
+       << ", split(us) = " << record.splitUs
+       << ", metadata(us) = " << record.metadataUs
+       << ", request num = " << record.requestNum
+       << ", slowest request schedule queue(us) = " << req.queueUs
+       << ", dispatch(us) = " << req.dispatchUs
+       << ", rpc(us) = " << req.rpcUs
+       << ", backoff(us) = " << req.backoffUs
+       << ", retry num = " << req.retryNum;
+    return os;
+}
+
+IOTracer::IOTracer()
+    : enable_(false),
+      fileMetric_(nullptr),
+      slowIONum_(0),
+      next_(0) {}
+
+void IOTracer::Init(const IOTraceOption_t& opt, const std::string& filename,
+                    FileMetric* fileMetric) {
+    enable_ = opt.enable;
+    opt_ = opt;
+    fileMetric_ = fileMetric;
+    if (!enable_) {
+        return;
+    }
+
+    opt_.slowIOSampleInterval = std::max<uint32_t>(
+        opt_.slowIOSampleInterval, 1);
+    slowIO_.reserve(opt_.slowIORecordNum);
+    slowIODump_.reset(new bvar::PassiveStatus<std::string>(
+        "curve client", filename + "_slow_io", DumpSlowIO, this));
+
+    LOG(INFO) << "io trace enabled, slow io threshold ms = "
+              << opt_.slowIOThresholdMS
+              << ", slow io sample interval = " << opt_.slowIOSampleInterval
+              << ", slow io record num = " << opt_.slowIORecordNum;
+}
+
+void IOTracer::Record(const IOTraceRecord& record) {
+    if (!enable_) {
+        return;
+    }
+
+    if (fileMetric_ != nullptr) {
+        IOTraceMetric& metric = fileMetric_->ioTrace;
+        const RequestTrace& req = record.slowestRequest;
+        metric.taskQueueLatency << record.taskQueueUs;
+        metric.splitLatency << record.splitUs;
+        if (record.metadataUs != 0) {
+            metric.metadataLatency << record.metadataUs;
+        }
+        if (record.requestNum != 0) {
+            metric.scheduleQueueLatency << req.queueUs;
+            metric.dispatchLatency << req.dispatchUs;
+            metric.rpcLatency << req.rpcUs;
+        }
+        if (req.retryNum != 0) {
+            metric.backoffLatency << req.backoffUs;
+            metric.retryCount << req.retryNum;
+        }
+    }
+
+    if (record.totalUs < opt_.slowIOThresholdMS * 1000) {
+        return;
+    }
+
+    if (fileMetric_ != nullptr) {
+        fileMetric_->ioTrace.slowIOCount << 1;
+    }
+
+    uint64_t num = slowIONum_.fetch_add(1, std::memory_order_relaxed);
+    if (num % opt_.slowIOSampleInterval != 0 || opt_.slowIORecordNum == 0) {
+        return;
+    }
+
+    LOG(WARNING) << "slow io, " << record;
+
+    std::lock_guard<curve::common::Mutex> lk(mtx_);
+    if (slowIO_.size() < opt_.slowIORecordNum) {
+        slowIO_.push_back(record);
+    } else {
+        slowIO_[next_] = record;
+    }
+    next_ = (next_ + 1) % opt_.slowIORecordNum;
+}
+
+std::vector<IOTraceRecord> IOTracer::GetSlowIO() {
+    std::lock_guard<curve::common::Mutex> lk(mtx_);
+    std::vector<IOTraceRecord> result;
+    result.reserve(slowIO_.size());
+    // next_之前的是较新的记录，缓冲区写满之后next_及之后的是较旧的记录
+    for (size_t i = next_; i > 0; --i) {
+        result.push_back(slowIO_[i - 1]);
+    }
+    for (size_t i = slowIO_.size(); i > next_; --i) {
+        result.push_back(slowIO_[i - 1]);
+    }
+    return result;
+}
+
+void IOTracer::Dump(std::ostream& os) {
+    for (const auto& record : GetSlowIO()) {
+        os << record << "\n";
+    }
+}
+
+void IOTracer::DumpSlowIO(std::ostream& os, void* arg) {
+    static_cast<IOTracer*>(arg)->Dump(os);
+}
+
+}   // namespace client
+}   // namespace curve
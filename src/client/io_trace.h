@@ -0,0 +1,202 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_CLIENT_IO_TRACE_H_
+#define SRC_CLIENT_IO_TRACE_H_
+
+#include <bvar/bvar.h>
+
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "src/client/client_common.h"
+#include "src/client/client_metric.h"
+#include "src/client/config_info.h"
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/timeutility.h"
+
+namespace curve {
+namespace client {
+
+/**
+ * chunk请求在client内部各个阶段的耗时
+ * 请求在调度队列、rpc和重试之间依次流转，每个阶段以上一个阶段的结束时间为起点，
+ * 重试时各阶段的耗时累加。未开启追踪时不获取时间
+ */
+struct RequestTrace {
+    bool enable = false;
+    // 当前阶段的起始时间
+    uint64_t lastUs = 0;
+    // 在调度队列中等待的时间
+    uint64_t queueUs = 0;
+    // 出队到rpc发出的时间，包括等待inflight rpc令牌和获取leader
+    uint64_t dispatchUs = 0;
+    // rpc的时间
+    uint64_t rpcUs = 0;
+    // rpc返回到重试之间的时间，主要是重试前的睡眠
+    uint64_t backoffUs = 0;
+    uint32_t retryNum = 0;
+
+    /**
+     * 从当前时间开始计时，请求进入调度队列时调用
+     */
+    void Mark() {
+        if (enable) {
+            lastUs = curve::common::TimeUtility::GetTimeofDayUs();
+        }
+    }
+
+    void OnDequeue() {
+        Advance(&queueUs);
+    }
+
+    void OnRpcSend() {
+        Advance(&dispatchUs);
+    }
+
+    void OnRpcDone() {
+        Advance(&rpcUs);
+    }
+
+    void OnRetry() {
+        if (enable) {
+            Advance(&backoffUs);
+            ++retryNum;
+        }
+    }
+
+    /**
+     * 合并请求返回后，被合并的请求累加合并请求的耗时
+     */
+    void Accumulate(const RequestTrace& other) {
+        queueUs += other.queueUs;
+        dispatchUs += other.dispatchUs;
+        rpcUs += other.rpcUs;
+        backoffUs += other.backoffUs;
+        retryNum += other.retryNum;
+    }
+
+    uint64_t TotalUs() const {
+        return queueUs + dispatchUs + rpcUs + backoffUs;
+    }
+
+ private:
+    void Advance(uint64_t* stageUs) {
+        if (!enable) {
+            return;
+        }
+        uint64_t now = curve::common::TimeUtility::GetTimeofDayUs();
+        *stageUs += now - lastUs;
+        lastUs = now;
+    }
+};
+
+/**
+ * 一个用户读写IO的完整耗时信息
+ * 一个IO拆分出的多个chunk请求并发下发，chunk请求阶段的耗时取耗时最长的请求
+ */
+struct IOTraceRecord {
+    uint64_t ioId = 0;
+    OpType type = OpType::UNKNOWN;
+    off_t offset = 0;
+    uint64_t length = 0;
+    int errcode = 0;
+    // IO提交的时间
+    uint64_t submitUs = 0;
+    uint64_t totalUs = 0;
+    // 在任务队列中等待的时间，包括限流排队的时间
+    uint64_t taskQueueUs = 0;
+    // 开始处理到请求拆分完成的时间，不包括获取元数据的时间
+    uint64_t splitUs = 0;
+    // 拆分时metacache未命中从mds获取segment的时间
+    uint64_t metadataUs = 0;
+    // 拆分出的chunk请求数量
+    uint32_t requestNum = 0;
+    // 耗时最长的chunk请求
+    RequestTrace slowestRequest;
+};
+
+std::ostream& operator<<(std::ostream& os, const IOTraceRecord& record);
+
+/**
+ * 文件级别的IO分阶段耗时追踪
+ * 1. 每个读写IO返回时将各阶段的耗时记录到metric中
+ * 2. 总耗时超过阈值的慢IO按采样间隔保存到环形缓冲区中，
+ *    通过dummy server的 /vars/<prefix>_<file>_slow_io 查看
+ */
+class IOTracer {
+ public:
+    IOTracer();
+    ~IOTracer() = default;
+
+    /**
+     * 初始化，开启追踪时导出慢IO信息
+     * @param: opt为追踪配置信息
+     * @param: filename为文件名，用于导出慢IO信息
+     * @param: fileMetric为文件的metric
+     */
+    void Init(const IOTraceOption_t& opt, const std::string& filename,
+              FileMetric* fileMetric);
+
+    bool Enabled() const {
+        return enable_;
+    }
+
+    /**
+     * 记录一个返回的读写IO
+     */
+    void Record(const IOTraceRecord& record);
+
+    /**
+     * 获取保存的慢IO，按时间从新到旧排列
+     */
+    std::vector<IOTraceRecord> GetSlowIO();
+
+    /**
+     * 输出保存的慢IO，每个IO一行
+     */
+    void Dump(std::ostream& os);
+
+ private:
+    static void DumpSlowIO(std::ostream& os, void* arg);
+
+ private:
+    bool enable_;
+    IOTraceOption_t opt_;
+    FileMetric* fileMetric_;
+
+    // 慢IO计数，用于采样
+    std::atomic<uint64_t> slowIONum_;
+
+    // 保存采样的慢IO的环形缓冲区，next_为下一个写入的位置
+    curve::common::Mutex mtx_;
+    std::vector<IOTraceRecord> slowIO_;
+    size_t next_;
+
+    std::unique_ptr<bvar::PassiveStatus<std::string>> slowIODump_;
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // SRC_CLIENT_IO_TRACE_H_
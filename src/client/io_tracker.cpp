@@ -49,13 +49,27 @@ IOTracker::IOTracker(IOManager* iomanager,
     id_         = tracekerID_.fetch_add(1);
     scc_        = nullptr;
     aioctx_     = nullptr;
+    readCache_  = nullptr;
+    readCacheSeq_ = 0;
+    readAhead_  = nullptr;
+    writeBackCache_ = nullptr;
+    discardRecorder_ = nullptr;
+    segmentReleaser_ = nullptr;
+    ioTracer_   = nullptr;
+    priority_   = RequestPriority::FOREGROUND;
+    startUs_    = 0;
+    splitUs_    = 0;
+    metadataUs_ = 0;
+    fileInfo_   = nullptr;
     data_       = nullptr;
+    readIOBuf_  = nullptr;
     type_       = OpType::UNKNOWN;
     errcode_    = LIBCURVE_ERROR::OK;
     offset_     = 0;
     length_     = 0;
     reqlist_.clear();
     reqcount_.store(0, std::memory_order_release);
+    keepChunkNum_.store(0, std::memory_order_relaxed);
     opStartTimePoint_ = curve::common::TimeUtility::GetTimeofDayUs();
 }
 
@@ -69,14 +83,64 @@ void IOTracker::StartRead(CurveAioContext* aioctx, char* buf,
 
     DVLOG(9)  << "read op, offset = " << offset
               << ", length = " << length;
+    MarkStart();
 
+    if (readAhead_ != nullptr) {
+        readAhead_->Observe(offset_, length_, fi->length);
+    }
+
+    if (readCache_ != nullptr) {
+        // 全部命中时直接返回，否则记录失效序号，读返回后填充缓存
+        if (readCache_->Read(offset_, length_, buf)) {
+            // 数据来自缓存，返回时无需再回填
+            readCache_ = nullptr;
+            Done();
+            return;
+        }
+        readCacheSeq_ = readCache_->GetSequence();
+    }
+
+    if (writeBackCache_ != nullptr &&
+        writeBackCache_->GetDirtyExtents(offset_, length_, &dirtyExtents_)) {
+        // 读范围全部是脏数据，无需从chunkserver读取
+        Done();
+        return;
+    }
+
+    // 预读的数据同样需要在返回时用脏数据覆盖
+    if (readAhead_ != nullptr) {
+        // 预读还未返回时不阻塞当前线程，由预读的回调继续处理
+        auto status = readAhead_->Read(offset_, length_, buf,
+            [this, mdsclient, fi](bool hit) {
+                if (hit) {
+                    Done();
+                } else {
+                    ReadFromChunkServer(mdsclient, fi);
+                }
+            });
+        if (status == ReadAhead::ReadStatus::HIT) {
+            Done();
+            return;
+        }
+        if (status == ReadAhead::ReadStatus::PENDING) {
+            return;
+        }
+    }
+
+    ReadFromChunkServer(mdsclient, fi);
+}
+
+void IOTracker::ReadFromChunkServer(MDSClient* mdsclient, const FInfo_t* fi) {
     int ret = Splitor::IO2ChunkRequests(this, mc_, &reqlist_, data_,
                                         offset_, length_, mdsclient, fi);
+    MarkSplitDone();
     if (ret == 0) {
         reqcount_.store(reqlist_.size(), std::memory_order_release);
         std::for_each(reqlist_.begin(), reqlist_.end(), [&](RequestContext* r) {
             r->done_->SetFileMetric(fileMetric_);
             r->done_->SetIOManager(iomanager_);
+            r->trace_.enable = ioTracer_ != nullptr;
+            r->priority_ = priority_;
         });
         ret = scheduler_->ScheduleRequest(reqlist_);
     } else {
@@ -91,6 +155,39 @@ void IOTracker::StartRead(CurveAioContext* aioctx, char* buf,
     }
 }
 
+void IOTracker::StartReadIOBuf(CurveAioContext* aioctx, butil::IOBuf* data,
+    off_t offset, size_t length, MDSClient* mdsclient, const FInfo_t* fi) {
+    readIOBuf_ = data;
+
+    // 读缓存、预读和脏数据覆盖都需要连续的buffer
+    if (readCache_ != nullptr || readAhead_ != nullptr ||
+        writeBackCache_ != nullptr) {
+        readIOBufBuffer_.reset(new (std::nothrow) char[length]);
+        if (readIOBufBuffer_ == nullptr) {
+            offset_ = offset;
+            length_ = length;
+            aioctx_ = aioctx;
+            type_   = OpType::READ;
+            LOG(ERROR) << "allocate read buffer failed, length = " << length;
+            ReturnOnFail();
+            return;
+        }
+        StartRead(aioctx, readIOBufBuffer_.get(), offset, length,
+                  mdsclient, fi);
+        return;
+    }
+
+    // 拆分后的请求readBuffer为空，读到的数据保存在各自的readData中
+    StartRead(aioctx, nullptr, offset, length, mdsclient, fi);
+}
+
+void IOTracker::StartReadv(CurveAioContext* aioctx,
+    const std::vector<iovec>& iov, off_t offset, size_t length,
+    MDSClient* mdsclient, const FInfo_t* fi) {
+    readIov_ = iov;
+    StartReadIOBuf(aioctx, &readvData_, offset, length, mdsclient, fi);
+}
+
 void IOTracker::StartWrite(CurveAioContext* aioctx, const char* buf,
     off_t offset, size_t length, MDSClient* mdsclient,  const FInfo_t* fi) {
     data_   = buf;
@@ -101,13 +198,45 @@ void IOTracker::StartWrite(CurveAioContext* aioctx, const char* buf,
 
     DVLOG(9) << "write op, offset = " << offset
              << ", length = " << length;
+    MarkStart();
+
+    if (readCache_ != nullptr) {
+        readCache_->Invalidate(offset_, length_);
+    }
+    // 写过的区间不再是discard状态
+    if (discardRecorder_ != nullptr) {
+        discardRecorder_->Clear(offset_, length_, fi->chunksize);
+    }
+    if (readAhead_ != nullptr) {
+        readAhead_->Invalidate(offset_, length_);
+    }
+    WriteToChunkServer(mdsclient, fi);
+}
+
+void IOTracker::WriteToChunkServer(MDSClient* mdsclient, const FInfo_t* fi) {
+    // segment正在释放时不阻塞当前线程，释放完成后重新拆分，从mds重新分配segment
+    if (segmentReleaser_ != nullptr && fi != nullptr) {
+        fileInfo_ = fi;
+        if (!segmentReleaser_->BeginWrite(offset_, length_, fi->segmentsize,
+                [this, mdsclient, fi]() {
+                    WriteToChunkServer(mdsclient, fi);
+                })) {
+            DVLOG(9) << "segment releasing, resume write later, offset = "
+                     << offset_ << ", length = " << length_;
+            return;
+        }
+    }
+
     int ret = Splitor::IO2ChunkRequests(this, mc_, &reqlist_, data_, offset_,
                                         length_, mdsclient, fi);
+    MarkSplitDone();
     if (ret == 0) {
         reqcount_.store(reqlist_.size(), std::memory_order_release);
         std::for_each(reqlist_.begin(), reqlist_.end(), [&](RequestContext* r) {
             r->done_->SetFileMetric(fileMetric_);
             r->done_->SetIOManager(iomanager_);
+            r->trace_.enable = ioTracer_ != nullptr;
+            r->priority_ = priority_;
         });
         ret = scheduler_->ScheduleRequest(reqlist_);
     } else {
@@ -122,6 +251,78 @@ void IOTracker::StartWrite(CurveAioContext* aioctx, const char* buf,
     }
 }
 
+void IOTracker::StartWritev(CurveAioContext* aioctx,
+    const std::vector<iovec>& iov, off_t offset, size_t length,
+    MDSClient* mdsclient, const FInfo_t* fi) {
+    // 只引用用户buffer，回调之前用户需要保证buffer有效
+    for (const iovec& vec : iov) {
+        if (vec.iov_len != 0) {
+            writeIOBuf_.append_user_data(vec.iov_base, vec.iov_len,
+                                         [](void*) {});
+        }
+    }
+
+    StartWrite(aioctx, nullptr, offset, length, mdsclient, fi);
+}
+
+void IOTracker::StartDiscard(CurveAioContext* aioctx, off_t offset,
+    size_t length, MDSClient* mdsclient, const FInfo_t* fi) {
+    offset_ = offset;
+    length_ = length;
+    aioctx_ = aioctx;
+    type_   = OpType::DISCARD;
+
+    DVLOG(9) << "discard op, offset = " << offset
+             << ", length = " << length;
+
+    // 被删除的chunk再读时返回全0
+    if (readCache_ != nullptr) {
+        readCache_->Invalidate(offset_, length_);
+    }
+    if (readAhead_ != nullptr) {
+        readAhead_->Invalidate(offset_, length_);
+    }
+
+    // 在删除chunk之前登记，之后写到这些segment的写请求会阻止其释放
+    if (segmentReleaser_ != nullptr && fi != nullptr) {
+        fileInfo_ = fi;
+        segmentReleaser_->BeginDiscard(offset_, length_, fi->segmentsize);
+    }
+
+    uint32_t keepChunkNum = 0;
+    int ret = Splitor::IO2DiscardRequests(this, mc_, &reqlist_, offset_,
+                                          length_, mdsclient, fi,
+                                          discardRecorder_, &keepChunkNum);
+    if (ret == 0) {
+        keepChunkNum_.store(keepChunkNum, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < keepChunkNum; ++i) {
+            MetricHelper::IncremDiscardKeepChunkCount(fileMetric_);
+        }
+
+        // 没有需要删除的chunk
+        if (reqlist_.empty()) {
+            Done();
+            return;
+        }
+
+        reqcount_.store(reqlist_.size(), std::memory_order_release);
+        std::for_each(reqlist_.begin(), reqlist_.end(), [&](RequestContext* r) {
+            r->done_->SetFileMetric(fileMetric_);
+            r->done_->SetIOManager(iomanager_);
+        });
+        ret = scheduler_->ScheduleRequest(reqlist_);
+    } else {
+        LOG(ERROR) << "splitor discard io failed, "
+                   << "offset = " << offset_
+                   << ", length = " << length_;
+    }
+
+    if (ret == -1) {
+        LOG(ERROR) << "split or schedule failed, return and recyle resource!";
+        ReturnOnFail();
+    }
+}
+
 void IOTracker::ReadSnapChunk(const ChunkIDInfo &cinfo,
     uint64_t seq, uint64_t offset, uint64_t len,
     char *buf, SnapCloneClosure* scc) {
@@ -271,6 +472,17 @@ void IOTracker::FillCommonFields(ChunkIDInfo idinfo, RequestContext* req) {
 
 void IOTracker::HandleResponse(RequestContext* reqctx) {
     int errorcode = reqctx->done_->GetErrorCode();
+    if (type_ == OpType::DISCARD) {
+        // chunk被快照或克隆使用而保留，不是错误
+        if (errorcode == CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_EXIST) {
+            keepChunkNum_.fetch_add(1, std::memory_order_relaxed);
+            MetricHelper::IncremDiscardKeepChunkCount(fileMetric_);
+            errorcode = 0;
+        } else if (errorcode == 0) {
+            MetricHelper::IncremDiscardDeleteChunkCount(fileMetric_);
+        }
+    }
+
     if (errorcode != 0) {
         ChunkServerErr2LibcurveErr(static_cast<CHUNK_OP_STATUS>(errorcode),
                                    &errcode_);
@@ -286,6 +498,42 @@ int IOTracker::Wait() {
 }
 
 void IOTracker::Done() {
+    // 从chunkserver读回的数据可能比写缓存中的脏数据旧
+    if (!dirtyExtents_.empty() && type_ == OpType::READ &&
+        errcode_ == LIBCURVE_ERROR::OK) {
+        WriteBackCache::ApplyDirtyExtents(dirtyExtents_, offset_, length_,
+                                          const_cast<char*>(data_));
+        dirtyExtents_.clear();
+    }
+
+    // 写过程中发起的预读可能读到了旧数据
+    if (readAhead_ != nullptr && type_ == OpType::WRITE) {
+        readAhead_->Invalidate(offset_, length_);
+    }
+
+    // 必须在向上返回之前处理读缓存，返回之后用户buffer可能被复用
+    if (readCache_ != nullptr) {
+        if (type_ == OpType::WRITE) {
+            // 写返回后再失效一次，写过程中并发的读可能已经填充了旧数据
+            readCache_->Invalidate(offset_, length_);
+        } else if (type_ == OpType::READ && errcode_ == LIBCURVE_ERROR::OK) {
+            readCache_->Put(offset_, length_, data_, readCacheSeq_);
+        }
+    }
+
+    if (segmentReleaser_ != nullptr && fileInfo_ != nullptr) {
+        if (type_ == OpType::WRITE) {
+            segmentReleaser_->EndWrite(offset_, length_,
+                                       fileInfo_->segmentsize);
+        } else if (type_ == OpType::DISCARD) {
+            // chunk都被删除后在后台释放segment，不在IO回调中等待mds的RPC
+            bool release = errcode_ == LIBCURVE_ERROR::OK &&
+                keepChunkNum_.load(std::memory_order_relaxed) == 0;
+            segmentReleaser_->EndDiscard(offset_, length_,
+                                         fileInfo_->segmentsize, release);
+        }
+    }
+
     if (errcode_ == LIBCURVE_ERROR::OK) {
         uint64_t duration = TimeUtility::GetTimeofDayUs() - opStartTimePoint_;
         MetricHelper::UserLatencyRecord(fileMetric_, duration, type_);
@@ -302,6 +550,18 @@ void IOTracker::Done() {
         }
     }
 
+    if (readIOBuf_ != nullptr && errcode_ == LIBCURVE_ERROR::OK) {
+        FillReadIOBuf();
+        if (!readIov_.empty()) {
+            FillReadIov();
+        }
+    }
+
+    if (ioTracer_ != nullptr &&
+        (type_ == OpType::READ || type_ == OpType::WRITE)) {
+        RecordTrace();
+    }
+
     DestoryRequestList();
 
     // scc_和aioctx都为空的时候肯定是个同步调用
@@ -325,6 +585,61 @@ void IOTracker::Done() {
     iomanager_->HandleAsyncIOResponse(this);
 }
 
+void IOTracker::FillReadIOBuf() {
+    if (readIOBufBuffer_ != nullptr) {
+        readIOBuf_->append_user_data(readIOBufBuffer_.release(), length_,
+            [](void* buf) { delete[] static_cast<char*>(buf); });
+        return;
+    }
+
+    // 拆分后的请求按offset顺序排列，依次拼接即可，只增加数据块的引用计数
+    for (RequestContext* req : reqlist_) {
+        readIOBuf_->append(req->readData_);
+    }
+}
+
+void IOTracker::FillReadIov() {
+    for (const iovec& vec : readIov_) {
+        readvData_.cutn(vec.iov_base, vec.iov_len);
+    }
+    readvData_.clear();
+}
+
+void IOTracker::MarkStart() {
+    if (ioTracer_ != nullptr) {
+        startUs_ = TimeUtility::GetTimeofDayUs();
+    }
+}
+
+void IOTracker::MarkSplitDone() {
+    if (ioTracer_ != nullptr) {
+        splitUs_ = TimeUtility::GetTimeofDayUs() - startUs_;
+    }
+}
+
+void IOTracker::RecordTrace() {
+    IOTraceRecord record;
+    record.ioId = id_;
+    record.type = type_;
+    record.offset = offset_;
+    record.length = length_;
+    record.errcode = errcode_;
+    record.submitUs = opStartTimePoint_;
+    record.totalUs = TimeUtility::GetTimeofDayUs() - opStartTimePoint_;
+    // 分配内存失败等未开始处理就返回的IO没有开始处理的时间
+    record.taskQueueUs = startUs_ == 0 ? 0 : startUs_ - opStartTimePoint_;
+    record.splitUs = splitUs_ > metadataUs_ ? splitUs_ - metadataUs_ : 0;
+    record.metadataUs = metadataUs_;
+    record.requestNum = reqlist_.size();
+    for (RequestContext* req : reqlist_) {
+        if (req->trace_.TotalUs() >= record.slowestRequest.TotalUs()) {
+            record.slowestRequest = req->trace_;
+        }
+    }
+
+    ioTracer_->Record(record);
+}
+
 void IOTracker::DestoryRequestList() {
     for (auto iter : reqlist_) {
         iter->UnInit();
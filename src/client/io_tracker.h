@@ -22,12 +22,23 @@
 #ifndef SRC_CLIENT_IO_TRACKER_H_
 #define SRC_CLIENT_IO_TRACKER_H_
 
+#include <butil/iobuf.h>
+#include <sys/uio.h>
+
 #include <set>
 #include <list>
 #include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "src/client/metacache.h"
+#include "src/client/read_cache.h"
+#include "src/client/read_ahead.h"
+#include "src/client/write_back_cache.h"
+#include "src/client/discard_recorder.h"
+#include "src/client/segment_releaser.h"
+#include "src/client/io_trace.h"
 #include "src/client/mds_client.h"
 #include "src/client/client_common.h"
 #include "src/client/request_context.h"
@@ -82,6 +93,71 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
                      size_t length,
                      MDSClient* mdsclient,
                      const FInfo_t* fi);
+    /**
+     * 读请求的数据以IOBuf的形式返回，直接引用chunkserver返回的rpc数据块，
+     * 不拷贝到用户buffer。开启了读缓存、预读或者写缓存时需要在连续的buffer上
+     * 处理，先读到内部buffer再交给IOBuf
+     * @param: aioctx异步io上下文，为空的时候代表同步IO
+     * @param: data用于保存读到的数据，读成功时数据追加到其中
+     * @param: offset是读偏移
+     * @param: length是读长度
+     * @param: mdsclient透传给splitor，与mds通信
+     * @param: fi是当前io对应文件的基本信息
+     */
+    void StartReadIOBuf(CurveAioContext* aioctx,
+                     butil::IOBuf* data,
+                     off_t offset,
+                     size_t length,
+                     MDSClient* mdsclient,
+                     const FInfo_t* fi);
+    /**
+     * 读到的数据按顺序填充到iov的各段buffer中，各段长度之和等于length
+     * 读到的数据先以IOBuf的形式保存，返回前再拷贝到iov中，与读到连续的
+     * 用户buffer一样只拷贝一次
+     * @param: aioctx异步io上下文，不使用其中的buf
+     * @param: iov为用户的buffer数组
+     * @param: offset是读偏移
+     * @param: length是读长度
+     * @param: mdsclient透传给splitor，与mds通信
+     * @param: fi是当前io对应文件的基本信息
+     */
+    void StartReadv(CurveAioContext* aioctx,
+                     const std::vector<iovec>& iov,
+                     off_t offset,
+                     size_t length,
+                     MDSClient* mdsclient,
+                     const FInfo_t* fi);
+    /**
+     * 写入iov中各段buffer拼接而成的数据，各段长度之和等于length
+     * 用户buffer以引用的形式放入IOBuf，由splitor切给各个请求后直接作为rpc的
+     * attachment，不拷贝数据
+     * @param: aioctx异步io上下文，不使用其中的buf
+     * @param: iov为用户的buffer数组
+     * @param: offset是写偏移
+     * @param: length是写长度
+     * @param: mdsclient透传给splitor，与mds通信
+     * @param: fi是当前io对应文件的基本信息
+     */
+    void StartWritev(CurveAioContext* aioctx,
+                     const std::vector<iovec>& iov,
+                     off_t offset,
+                     size_t length,
+                     MDSClient* mdsclient,
+                     const FInfo_t* fi);
+    /**
+     * discard文件的[offset, offset + length)区间
+     * 被完全覆盖的chunk会被删除，被完全覆盖且chunk都被删除的segment会被释放
+     * @param: aioctx异步io上下文，为空的时候代表同步IO
+     * @param: offset是discard的偏移
+     * @param: length是discard的长度
+     * @param: mdsclient透传给splitor，与mds通信，并用于释放segment
+     * @param: fi是当前io对应文件的基本信息
+     */
+    void StartDiscard(CurveAioContext* aioctx,
+                     off_t offset,
+                     size_t length,
+                     MDSClient* mdsclient,
+                     const FInfo_t* fi);
     /**
      * chunk相关接口是提供给snapshot使用的，上层的snapshot和file
      * 接口是分开的，在IOTracker这里会将其统一，这样对下层来说不用
@@ -154,9 +230,73 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
      */
     OpType Optype() {return type_;}
 
+    /**
+     * 写请求的数据来自iov时返回尚未拆分的数据，splitor按拆分顺序依次切给
+     * 各个请求，否则返回nullptr
+     */
+    butil::IOBuf* WriteIOBuf() {
+        return writeIOBuf_.empty() ? nullptr : &writeIOBuf_;
+    }
+
     // 设置操作类型，测试使用
     void SetOpType(OpType type) { type_ = type; }
 
+    /**
+     * 设置文件读缓存，读请求优先从缓存读取并在返回后填充缓存，
+     * 写请求会失效覆盖到的缓存，不设置则不使用缓存
+     * @param: cache为当前文件的读缓存
+     */
+    void SetReadCache(ReadCache* cache) { readCache_ = cache; }
+
+    /**
+     * 设置文件预读，读请求会触发顺序读检测并优先从预读数据读取，
+     * 写请求会失效覆盖到的预读数据，不设置则不预读
+     * @param: readAhead为当前文件的预读
+     */
+    void SetReadAhead(ReadAhead* readAhead) { readAhead_ = readAhead; }
+
+    /**
+     * 设置文件写缓存，读请求返回的数据需要用写缓存中的脏数据覆盖
+     * @param: cache为当前文件的写缓存
+     */
+    void SetWriteBackCache(WriteBackCache* cache) { writeBackCache_ = cache; }
+
+    /**
+     * 设置文件的discard记录，只覆盖chunk部分区间的discard请求记录到其中，
+     * 写请求会清除覆盖到的记录，不设置则只删除被discard完全覆盖的chunk
+     * @param: recorder为当前文件的discard记录
+     */
+    void SetDiscardRecorder(DiscardRecorder* recorder) {
+        discardRecorder_ = recorder;
+    }
+
+    /**
+     * 设置文件的segment释放，discard完全覆盖的segment在后台释放，
+     * 写请求与同一segment的释放互斥，不设置则不释放segment
+     * @param: releaser为当前文件的segment释放
+     */
+    void SetSegmentReleaser(SegmentReleaser* releaser) {
+        segmentReleaser_ = releaser;
+    }
+
+    /**
+     * 设置文件的IO耗时追踪，读写请求返回时记录各阶段的耗时，不设置则不追踪
+     * @param: tracer为当前文件的IO耗时追踪
+     */
+    void SetIOTracer(IOTracer* tracer) { ioTracer_ = tracer; }
+
+    /**
+     * 设置拆分出的读写请求在调度队列中的优先级，默认为FOREGROUND
+     * @param: priority为请求的优先级，预读等后台读写设置为BACKGROUND
+     */
+    void SetPriority(RequestPriority priority) { priority_ = priority; }
+
+    /**
+     * 拆分IO时metacache未命中，记录从mds获取元数据的耗时
+     * @param: us为本次获取元数据的耗时
+     */
+    void RecordMetadataTime(uint64_t us) { metadataUs_ += us; }
+
     /**
      * 因为client的IO都是异步发送的，且一个IO被拆分成多个Request，因此在异步
      * IO返回后就应该告诉IOTracker当前request已经返回，这样tracker可以处理
@@ -178,6 +318,38 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
      */
     void Done();
 
+    /**
+     * 未命中缓存和预读的读请求拆分后下发到chunkserver
+     */
+    void ReadFromChunkServer(MDSClient* mdsclient, const FInfo_t* fi);
+
+    /**
+     * 写请求拆分后下发到chunkserver，写到的segment正在释放时挂起，
+     * 释放完成后在后台重新执行
+     */
+    void WriteToChunkServer(MDSClient* mdsclient, const FInfo_t* fi);
+
+    /**
+     * 读请求的数据以IOBuf返回时，把读到的数据追加到用户的IOBuf中
+     */
+    void FillReadIOBuf();
+
+    /**
+     * 读请求的数据以iov返回时，把读到的数据依次拷贝到iov的各段buffer中
+     */
+    void FillReadIov();
+
+    /**
+     * 开启追踪时记录开始处理和拆分完成的时间
+     */
+    void MarkStart();
+    void MarkSplitDone();
+
+    /**
+     * 读写请求返回时汇总各阶段的耗时交给IOTracer记录
+     */
+    void RecordTrace();
+
     /**
      * 在io拆分或者，io分发失败的时候需要调用，设置返回状态，并向上返回
      */
@@ -218,6 +390,19 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
     uint64_t   length_;
     mutable const char*   data_;
 
+    // 读请求的数据以IOBuf返回时，保存读到的数据
+    butil::IOBuf* readIOBuf_;
+
+    // 读请求的数据以IOBuf返回且需要经过缓存时使用的内部buffer
+    std::unique_ptr<char[]> readIOBufBuffer_;
+
+    // 读请求的数据以iov返回时，用户的buffer数组以及读到的数据
+    std::vector<iovec> readIov_;
+    butil::IOBuf readvData_;
+
+    // 写请求的数据来自iov时，引用用户buffer拼接而成的数据
+    butil::IOBuf writeIOBuf_;
+
     // 当用户下发的是同步IO的时候，其需要在上层进行等待，因为client的
     // IO发送流程全部是异步的，因此这里需要用条件变量等待，待异步IO返回
     // 之后才将这个等待的条件变量唤醒，然后向上返回。
@@ -250,6 +435,17 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
     // 发起时间
     uint64_t opStartTimePoint_;
 
+    // 文件的IO耗时追踪，为空时不追踪
+    IOTracer* ioTracer_;
+
+    // 拆分出的读写请求在调度队列中的优先级
+    RequestPriority priority_;
+
+    // 开始处理的时间，拆分耗时，以及拆分时从mds获取元数据的耗时
+    uint64_t startUs_;
+    uint64_t splitUs_;
+    uint64_t metadataUs_;
+
     // client端的metric统计信息
     FileMetric* fileMetric_;
 
@@ -259,6 +455,33 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
     // 快照克隆系统异步调用回调指针
     SnapCloneClosure* scc_;
 
+    // 文件读缓存，为空时不使用缓存
+    ReadCache* readCache_;
+
+    // 读请求发起时读缓存的失效序号
+    uint64_t readCacheSeq_;
+
+    // 文件预读，为空时不预读
+    ReadAhead* readAhead_;
+
+    // 文件写缓存，为空时不使用写缓存
+    WriteBackCache* writeBackCache_;
+
+    // 读请求发起时与其重叠的脏数据
+    std::vector<DirtyExtent> dirtyExtents_;
+
+    // 文件的discard记录，为空时不记录部分discard
+    DiscardRecorder* discardRecorder_;
+
+    // discard时被快照或克隆使用而保留的chunk数量
+    std::atomic<uint32_t> keepChunkNum_;
+
+    // 文件的segment释放，为空时不释放segment
+    SegmentReleaser* segmentReleaser_;
+
+    // 写请求和discard返回时用于获取segment大小
+    const FInfo_t* fileInfo_;
+
     // id生成器
     static std::atomic<uint64_t> tracekerID_;
 };
@@ -24,6 +24,8 @@
 #include <glog/logging.h>
 
 #include <chrono>   // NOLINT
+#include <cstring>
+#include <memory>
 
 #include "src/client/metacache.h"
 #include "src/client/iomanager4file.h"
@@ -34,13 +36,15 @@
 namespace curve {
 namespace client {
 Atomic<uint64_t> IOManager::idRecorder_(1);
-IOManager4File::IOManager4File(): scheduler_(nullptr), exit_(false) {
+IOManager4File::IOManager4File()
+    : scheduler_(nullptr), mdsclient_(nullptr), exit_(false) {
 }
 
 bool IOManager4File::Initialize(const std::string& filename,
                                 const IOOption_t& ioOpt,
                                 MDSClient* mdsclient) {
     ioopt_ = ioOpt;
+    mdsclient_ = mdsclient;
 
     mc_.Init(ioopt_.metaCacheOpt, mdsclient);
     Splitor::Init(ioopt_.ioSplitOpt);
@@ -54,6 +58,26 @@ bool IOManager4File::Initialize(const std::string& filename,
         return false;
     }
 
+    readCache_.Init(ioopt_.readCacheOpt, fileMetric_);
+    readAhead_.Init(ioopt_.readAheadOpt, fileMetric_,
+        [this](CurveAioContext* ctx) {
+            IssuePrefetch(ctx);
+        });
+    discardRecorder_.Init(ioopt_.discardOpt, fileMetric_);
+    segmentReleaser_.Init(
+        [this](uint64_t segoff) {
+            ReleaseSegment(segoff);
+        },
+        [this](const std::function<void()>& task) {
+            // 释放任务计入inflight，关闭文件时等待其完成
+            inflightCntl_.IncremInflightNum();
+            releasePool_.Enqueue([this, task]() {
+                task();
+                inflightCntl_.DecremInflightNum();
+            });
+        });
+    ioTracer_.Init(ioopt_.ioTraceOpt, filename, fileMetric_);
+
     // IO Manager中不控制inflight IO数量，所以传入UINT64_MAX
     // 但是IO Manager需要控制所有inflight IO在关闭的时候都被回收掉
     inflightCntl_.SetMaxInflightNum(UINT64_MAX);
@@ -79,6 +103,21 @@ bool IOManager4File::Initialize(const std::string& filename,
         return false;
     }
 
+    if (ioopt_.discardOpt.enable && releasePool_.Start(1) != 0) {
+        LOG(ERROR) << "segment release thread pool start failed!";
+        return false;
+    }
+
+    writeBackCache_.Init(ioopt_.writeBackOpt, filename, fileMetric_,
+        [this](const char* buf, off_t offset, size_t length) {
+            return DoWrite(buf, offset, length, mdsclient_);
+        });
+
+    throttle_.Init(ioopt_.throttleOpt, fileMetric_,
+        [this](const Throttle::Task& task) {
+            taskPool_.Enqueue(task);
+        });
+
     LOG(INFO) << "iomanager init success! conf info: "
               << "isolationTaskThreadPoolSize = "
               << ioopt_.taskThreadOpt.isolationTaskThreadPoolSize
@@ -88,6 +127,9 @@ bool IOManager4File::Initialize(const std::string& filename,
 }
 
 void IOManager4File::UnInitialize() {
+    // 排队中的请求全部放入任务队列，保证关闭时所有inflight请求都能返回
+    throttle_.Stop();
+
     bool exitFlag = false;
     std::mutex exitMtx;
     std::condition_variable exitCv;
@@ -106,12 +148,17 @@ void IOManager4File::UnInitialize() {
 
     taskPool_.Stop();
 
+    // 写缓存后台刷盘依赖scheduler，需要在scheduler退出前停止
+    writeBackCache_.Stop();
+
     if (scheduler_ != nullptr) {
         scheduler_->WakeupBlockQueueAtExit();
         inflightCntl_.WaitInflightAllComeBack();
         scheduler_->Fini();
     }
 
+    releasePool_.Stop();
+
     {
         // 这个锁保证设置exit_和delete scheduler_是原子的
         // 这样保证在scheduler_被析构的时候lease线程不会使用scheduler_
@@ -129,8 +176,10 @@ int IOManager4File::Read(char* buf, off_t offset,
     size_t length, MDSClient* mdsclient) {
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::READ);
     FlightIOGuard guard(this);
+    throttle_.Wait(OpType::READ, length);
 
     IOTracker temp(this, &mc_, scheduler_, fileMetric_);
+    AttachCache(&temp);
     temp.StartRead(nullptr, buf, offset, length, mdsclient,
                    this->GetFileInfo());
 
@@ -142,8 +191,19 @@ int IOManager4File::Write(const char* buf, off_t offset,
     size_t length, MDSClient* mdsclient) {
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::WRITE);
     FlightIOGuard guard(this);
+    throttle_.Wait(OpType::WRITE, length);
 
+    if (writeBackCache_.Running()) {
+        return WriteToWriteBackCache(buf, offset, length);
+    }
+
+    return DoWrite(buf, offset, length, mdsclient);
+}
+
+int IOManager4File::DoWrite(const char* buf, off_t offset,
+    size_t length, MDSClient* mdsclient) {
     IOTracker temp(this, &mc_, scheduler_, fileMetric_);
+    AttachCache(&temp);
     temp.StartWrite(nullptr, buf, offset, length, mdsclient,
                     this->GetFileInfo());
 
@@ -165,18 +225,81 @@ int IOManager4File::AioRead(CurveAioContext* ctx, MDSClient* mdsclient) {
 
     inflightCntl_.IncremInflightNum();
     auto task = [this, ctx, mdsclient, temp]() {
+        AttachCache(temp);
         temp->StartRead(ctx, static_cast<char*>(ctx->buf),
                         ctx->offset, ctx->length, mdsclient,
                         this->GetFileInfo());
     };
 
-    taskPool_.Enqueue(task);
+    throttle_.Add(OpType::READ, ctx->length, task);
+    return LIBCURVE_ERROR::OK;
+}
+
+int IOManager4File::AioReadIOBuf(CurveAioContext* ctx, butil::IOBuf* data,
+                                 MDSClient* mdsclient) {
+    MetricHelper::IncremUserRPSCount(fileMetric_, OpType::READ);
+
+    IOTracker* temp = new (std::nothrow) IOTracker(this, &mc_,
+                                                   scheduler_, fileMetric_);
+    if (temp == nullptr) {
+        ctx->ret = -LIBCURVE_ERROR::FAILED;
+        ctx->cb(ctx);
+        LOG(ERROR) << "allocate tracker failed!";
+        return LIBCURVE_ERROR::OK;
+    }
+
+    inflightCntl_.IncremInflightNum();
+    auto task = [this, ctx, data, mdsclient, temp]() {
+        AttachCache(temp);
+        temp->StartReadIOBuf(ctx, data, ctx->offset, ctx->length, mdsclient,
+                             this->GetFileInfo());
+    };
+
+    throttle_.Add(OpType::READ, ctx->length, task);
+    return LIBCURVE_ERROR::OK;
+}
+
+int IOManager4File::AioReadv(CurveAioContext* ctx,
+                             const std::vector<iovec>& iov,
+                             MDSClient* mdsclient) {
+    MetricHelper::IncremUserRPSCount(fileMetric_, OpType::READ);
+
+    IOTracker* temp = new (std::nothrow) IOTracker(this, &mc_,
+                                                   scheduler_, fileMetric_);
+    if (temp == nullptr) {
+        ctx->ret = -LIBCURVE_ERROR::FAILED;
+        ctx->cb(ctx);
+        LOG(ERROR) << "allocate tracker failed!";
+        return LIBCURVE_ERROR::OK;
+    }
+
+    inflightCntl_.IncremInflightNum();
+    auto task = [this, ctx, iov, mdsclient, temp]() {
+        AttachCache(temp);
+        temp->StartReadv(ctx, iov, ctx->offset, ctx->length, mdsclient,
+                         this->GetFileInfo());
+    };
+
+    throttle_.Add(OpType::READ, ctx->length, task);
     return LIBCURVE_ERROR::OK;
 }
 
 int IOManager4File::AioWrite(CurveAioContext* ctx, MDSClient* mdsclient) {
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::WRITE);
 
+    if (writeBackCache_.Running()) {
+        inflightCntl_.IncremInflightNum();
+        auto task = [this, ctx]() {
+            ctx->ret = WriteToWriteBackCache(
+                static_cast<const char*>(ctx->buf), ctx->offset, ctx->length);
+            ctx->cb(ctx);
+            inflightCntl_.DecremInflightNum();
+        };
+
+        throttle_.Add(OpType::WRITE, ctx->length, task);
+        return LIBCURVE_ERROR::OK;
+    }
+
     IOTracker* temp = new (std::nothrow) IOTracker(this, &mc_,
                                                    scheduler_, fileMetric_);
     if (temp == nullptr) {
@@ -188,17 +311,202 @@ int IOManager4File::AioWrite(CurveAioContext* ctx, MDSClient* mdsclient) {
 
     inflightCntl_.IncremInflightNum();
     auto task = [this, ctx, mdsclient, temp]() {
+        AttachCache(temp);
         temp->StartWrite(ctx, static_cast<const char*>(ctx->buf),
                          ctx->offset, ctx->length, mdsclient,
                          this->GetFileInfo());
     };
 
+    throttle_.Add(OpType::WRITE, ctx->length, task);
+    return LIBCURVE_ERROR::OK;
+}
+
+int IOManager4File::AioWritev(CurveAioContext* ctx,
+                              const std::vector<iovec>& iov,
+                              MDSClient* mdsclient) {
+    MetricHelper::IncremUserRPSCount(fileMetric_, OpType::WRITE);
+
+    if (writeBackCache_.Running()) {
+        inflightCntl_.IncremInflightNum();
+        auto task = [this, ctx, iov]() {
+            // 写缓存需要连续的数据，拷贝一次后写入写缓存
+            std::unique_ptr<char[]> buf(new (std::nothrow) char[ctx->length]);
+            if (buf == nullptr) {
+                LOG(ERROR) << "allocate write buffer failed, length = "
+                           << ctx->length;
+                ctx->ret = -LIBCURVE_ERROR::FAILED;
+            } else {
+                size_t pos = 0;
+                for (const iovec& vec : iov) {
+                    memcpy(buf.get() + pos, vec.iov_base, vec.iov_len);
+                    pos += vec.iov_len;
+                }
+                ctx->ret = WriteToWriteBackCache(buf.get(), ctx->offset,
+                                                 ctx->length);
+            }
+            ctx->cb(ctx);
+            inflightCntl_.DecremInflightNum();
+        };
+
+        throttle_.Add(OpType::WRITE, ctx->length, task);
+        return LIBCURVE_ERROR::OK;
+    }
+
+    IOTracker* temp = new (std::nothrow) IOTracker(this, &mc_,
+                                                   scheduler_, fileMetric_);
+    if (temp == nullptr) {
+        ctx->ret = -LIBCURVE_ERROR::FAILED;
+        ctx->cb(ctx);
+        LOG(ERROR) << "allocate tracker failed!";
+        return LIBCURVE_ERROR::OK;
+    }
+
+    inflightCntl_.IncremInflightNum();
+    auto task = [this, ctx, iov, mdsclient, temp]() {
+        AttachCache(temp);
+        temp->StartWritev(ctx, iov, ctx->offset, ctx->length, mdsclient,
+                          this->GetFileInfo());
+    };
+
+    throttle_.Add(OpType::WRITE, ctx->length, task);
+    return LIBCURVE_ERROR::OK;
+}
+
+int IOManager4File::AioFlush(CurveAioContext* ctx) {
+    inflightCntl_.IncremInflightNum();
+    // 经过任务队列，保证flush在之前提交的异步写之后处理
+    auto task = [this, ctx]() {
+        writeBackCache_.AioFlush([this, ctx](int ret) {
+            ctx->ret = ret;
+            ctx->cb(ctx);
+            inflightCntl_.DecremInflightNum();
+        });
+    };
+
+    taskPool_.Enqueue(task);
+    return LIBCURVE_ERROR::OK;
+}
+
+int IOManager4File::AioDiscard(CurveAioContext* ctx, MDSClient* mdsclient) {
+    // 未开启discard时与之前的行为一致，直接返回成功
+    if (!ioopt_.discardOpt.enable) {
+        ctx->ret = ctx->length;
+        ctx->cb(ctx);
+        return LIBCURVE_ERROR::OK;
+    }
+
+    IOTracker* temp = new (std::nothrow) IOTracker(this, &mc_,
+                                                   scheduler_, fileMetric_);
+    if (temp == nullptr) {
+        ctx->ret = -LIBCURVE_ERROR::FAILED;
+        ctx->cb(ctx);
+        LOG(ERROR) << "allocate tracker failed!";
+        return LIBCURVE_ERROR::OK;
+    }
+
+    inflightCntl_.IncremInflightNum();
+    auto task = [this, ctx, mdsclient, temp]() {
+        // 写缓存中的脏数据刷盘时会重新创建被删除的chunk，需要先刷完
+        writeBackCache_.AioFlush([this, ctx, mdsclient, temp](int ret) {
+            if (ret < 0) {
+                LOG(ERROR) << "flush before discard failed, offset = "
+                           << ctx->offset << ", length = " << ctx->length;
+                ctx->ret = ret;
+                ctx->cb(ctx);
+                HandleAsyncIOResponse(temp);
+                return;
+            }
+
+            AttachCache(temp);
+            temp->StartDiscard(ctx, ctx->offset, ctx->length, mdsclient,
+                               this->GetFileInfo());
+        });
+    };
+
     taskPool_.Enqueue(task);
     return LIBCURVE_ERROR::OK;
 }
 
+int IOManager4File::Flush() {
+    return writeBackCache_.Flush();
+}
+
+int IOManager4File::StartWriteBack() {
+    return writeBackCache_.Start();
+}
+
+int IOManager4File::WriteToWriteBackCache(const char* buf, off_t offset,
+                                          size_t length) {
+    uint64_t startTime = TimeUtility::GetTimeofDayUs();
+    int ret = writeBackCache_.Write(buf, offset, length);
+
+    // 读缓存中的数据比写缓存中的脏数据旧
+    readCache_.Invalidate(offset, length);
+    discardRecorder_.Clear(offset, length, GetFileInfo()->chunksize);
+
+    if (ret >= 0) {
+        MetricHelper::UserLatencyRecord(fileMetric_,
+            TimeUtility::GetTimeofDayUs() - startTime, OpType::WRITE);
+        MetricHelper::IncremUserQPSCount(fileMetric_, length, OpType::WRITE);
+    } else {
+        MetricHelper::IncremUserEPSCount(fileMetric_, OpType::WRITE);
+    }
+    return ret;
+}
+
+void IOManager4File::IssuePrefetch(CurveAioContext* ctx) {
+    IOTracker* temp = new (std::nothrow) IOTracker(this, &mc_,
+                                                   scheduler_, fileMetric_);
+    if (temp == nullptr) {
+        ctx->ret = -LIBCURVE_ERROR::FAILED;
+        ctx->cb(ctx);
+        LOG(ERROR) << "allocate tracker failed!";
+        return;
+    }
+
+    // 预读请求与异步读一样计入inflight，关闭文件时等待其返回
+    inflightCntl_.IncremInflightNum();
+    // 预读不能影响用户读写的延时
+    temp->SetPriority(RequestPriority::BACKGROUND);
+    temp->StartRead(ctx, static_cast<char*>(ctx->buf), ctx->offset,
+                    ctx->length, mdsclient_, this->GetFileInfo());
+}
+
+void IOManager4File::ReleaseSegment(uint64_t segoff) {
+    const FInfo_t* fi = this->GetFileInfo();
+    uint64_t chunksize = fi->chunksize;
+
+    // 不在metacache中说明segment未分配，已经分配的segment其chunk都已被删除
+    ChunkIDInfo_t chinfo;
+    ChunkIndex first = segoff / chunksize;
+    if (mc_.GetChunkInfoByIndex(first, &chinfo) != MetaCacheErrorType::OK) {
+        return;
+    }
+
+    LIBCURVE_ERROR ret = mdsclient_->DeAllocateSegment(fi, segoff);
+    if (ret != LIBCURVE_ERROR::OK) {
+        // 释放失败不影响discard的结果，segment内的chunk在下次写时重新创建
+        LOG(WARNING) << "release segment failed, file = " << fi->fullPathName
+                     << ", segment offset = " << segoff
+                     << ", ret = " << ret;
+        return;
+    }
+
+    for (ChunkIndex idx = first; idx < (segoff + fi->segmentsize) / chunksize;
+         ++idx) {
+        mc_.ReleaseChunkInfoByIndex(idx);
+    }
+    MetricHelper::IncremDiscardReleaseSegmentCount(fileMetric_);
+}
+
 void IOManager4File::UpdateFileInfo(const FInfo_t& fi) {
     mc_.UpdateFileInfo(fi);
+    UpdateThrottleParams(fi);
+}
+
+void IOManager4File::UpdateThrottleParams(const FInfo_t& fi) {
+    throttle_.UpdateParams(fi.hasThrottleParams ? fi.throttleParams :
+                           ioopt_.throttleOpt.params);
 }
 
 void IOManager4File::HandleAsyncIOResponse(IOTracker* iotracker) {
@@ -207,6 +515,11 @@ void IOManager4File::HandleAsyncIOResponse(IOTracker* iotracker) {
 }
 
 void IOManager4File::LeaseTimeoutBlockIO() {
+    // lease失效期间文件可能被其他client修改，缓存不再可信
+    readCache_.Drop();
+    readAhead_.Drop();
+    discardRecorder_.Drop();
+
     std::unique_lock<std::mutex> lk(exitMtx_);
     if (exit_ == false) {
         scheduler_->LeaseTimeoutBlockIO();
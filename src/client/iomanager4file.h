@@ -23,7 +23,10 @@
 #ifndef SRC_CLIENT_IOMANAGER4FILE_H_
 #define SRC_CLIENT_IOMANAGER4FILE_H_
 
+#include <sys/uio.h>
+
 #include <string>
+#include <vector>
 #include <atomic>
 #include <mutex>  // NOLINT
 #include <condition_variable>   // NOLINT
@@ -37,6 +40,13 @@
 #include "src/client/request_scheduler.h"
 #include "include/curve_compiler_specific.h"
 #include "src/client/inflight_controller.h"
+#include "src/client/read_cache.h"
+#include "src/client/read_ahead.h"
+#include "src/client/write_back_cache.h"
+#include "src/client/discard_recorder.h"
+#include "src/client/segment_releaser.h"
+#include "src/client/throttle.h"
+#include "src/client/io_trace.h"
 
 using curve::common::Atomic;
 
@@ -85,6 +95,26 @@ class IOManager4File : public IOManager {
    */
   int AioRead(CurveAioContext* aioctx,
                       MDSClient* mdsclient);
+  /**
+   * 异步模式读，数据以IOBuf的形式返回，不拷贝到用户buffer
+   * @param: aioctx为异步读写的io上下文，保存基本的io信息，不使用其中的buf
+   * @param: data用于保存读到的数据，回调时读成功的数据已追加到其中
+   * @param: mdsclient透传给底层，在必要的时候与mds通信
+   * @return： 0为成功，小于0为失败
+   */
+  int AioReadIOBuf(CurveAioContext* aioctx,
+                   butil::IOBuf* data,
+                   MDSClient* mdsclient);
+  /**
+   * 异步模式读，读到的数据按顺序填充到iov的各段buffer中
+   * @param: aioctx为异步读写的io上下文，保存基本的io信息，不使用其中的buf
+   * @param: iov为用户的buffer数组，各段长度之和等于aioctx中的length
+   * @param: mdsclient透传给底层，在必要的时候与mds通信
+   * @return： 0为成功，小于0为失败
+   */
+  int AioReadv(CurveAioContext* aioctx,
+               const std::vector<iovec>& iov,
+               MDSClient* mdsclient);
   /**
    * 异步模式写
    * @param: mdsclient透传给底层，在必要的时候与mds通信
@@ -93,6 +123,45 @@ class IOManager4File : public IOManager {
    */
   int AioWrite(CurveAioContext* aioctx,
                       MDSClient* mdsclient);
+  /**
+   * 异步模式写，写入iov中各段buffer拼接而成的数据，不拷贝到连续的buffer
+   * @param: aioctx为异步读写的io上下文，保存基本的io信息，不使用其中的buf
+   * @param: iov为用户的buffer数组，各段长度之和等于aioctx中的length
+   * @param: mdsclient透传给底层，在必要的时候与mds通信
+   * @return： 0为成功，小于0为失败
+   */
+  int AioWritev(CurveAioContext* aioctx,
+                const std::vector<iovec>& iov,
+                MDSClient* mdsclient);
+
+  /**
+   * 异步模式discard，写缓存中的脏数据先刷到chunkserver，再删除被完全覆盖的chunk
+   * 未开启discard时直接返回成功
+   * @param: mdsclient透传给底层，在必要的时候与mds通信
+   * @param: aioctx为异步io上下文，保存基本的io信息
+   * @return： 0为成功，小于0为失败
+   */
+  int AioDiscard(CurveAioContext* aioctx,
+                      MDSClient* mdsclient);
+
+  /**
+   * 异步模式flush，之前返回的写请求全部刷到chunkserver后回调
+   * @param: aioctx为异步io上下文
+   * @return： 0为成功，小于0为失败
+   */
+  int AioFlush(CurveAioContext* aioctx);
+
+  /**
+   * 同步模式flush
+   * @return： 0为成功，小于0为失败
+   */
+  int Flush();
+
+  /**
+   * 启动写缓存，文件以读写方式open成功后调用
+   * @return: 成功返回0，否则返回-1
+   */
+  int StartWriteBack();
 
   /**
    * 析构，回收资源
@@ -145,6 +214,12 @@ class IOManager4File : public IOManager {
    */
   void UpdateFileInfo(const FInfo_t& fi);
 
+  /**
+   * 更新限流参数，mds没有下发限流参数时使用配置文件中的参数
+   * @param: fi为open或者续约时从mds获取的文件信息
+   */
+  void UpdateThrottleParams(const FInfo_t& fi);
+
   const FInfo* GetFileInfo() const {
     return mc_.GetFileInfo();
   }
@@ -160,9 +235,62 @@ class IOManager4File : public IOManager {
    * 更新文件最新版本号
    */
   void SetLatestFileSn(uint64_t newSn) {
+    // 文件版本变化后缓存的数据可能已经失效
+    readCache_.Drop();
+    readAhead_.Drop();
     mc_.SetLatestFileSn(newSn);
   }
 
+  /**
+   * 清空当前文件的读缓存和预读数据，上层感知到文件被其他client修改时调用
+   */
+  void InvalidCache() {
+    readCache_.Drop();
+    readAhead_.Drop();
+  }
+
+  /**
+   * 获取读缓存，测试使用
+   */
+  ReadCache* GetReadCache() {
+    return &readCache_;
+  }
+
+  /**
+   * 获取预读，测试使用
+   */
+  ReadAhead* GetReadAhead() {
+    return &readAhead_;
+  }
+
+  /**
+   * 获取写缓存，测试使用
+   */
+  WriteBackCache* GetWriteBackCache() {
+    return &writeBackCache_;
+  }
+
+  /**
+   * 获取discard记录，测试使用
+   */
+  DiscardRecorder* GetDiscardRecorder() {
+    return &discardRecorder_;
+  }
+
+  /**
+   * 获取限流，测试使用
+   */
+  Throttle* GetThrottle() {
+    return &throttle_;
+  }
+
+  /**
+   * 获取IO耗时追踪，测试使用
+   */
+  IOTracer* GetIOTracer() {
+    return &ioTracer_;
+  }
+
  private:
   friend class LeaseExcutor;
   friend class FlightIOGuard;
@@ -177,6 +305,44 @@ class IOManager4File : public IOManager {
    */
   void RefeshSuccAndResumeIO();
 
+  /**
+   * 为IOTracker设置读缓存、预读、写缓存和耗时追踪，未开启的不设置
+   * @param: tracker为待下发的IOTracker
+   */
+  void AttachCache(IOTracker* tracker) {
+    tracker->SetReadCache(readCache_.Enabled() ? &readCache_ : nullptr);
+    tracker->SetReadAhead(readAhead_.Enabled() ? &readAhead_ : nullptr);
+    tracker->SetWriteBackCache(
+        writeBackCache_.Running() ? &writeBackCache_ : nullptr);
+    tracker->SetDiscardRecorder(
+        discardRecorder_.Enabled() ? &discardRecorder_ : nullptr);
+    tracker->SetSegmentReleaser(
+        ioopt_.discardOpt.enable ? &segmentReleaser_ : nullptr);
+    tracker->SetIOTracer(ioTracer_.Enabled() ? &ioTracer_ : nullptr);
+  }
+
+  /**
+   * 写请求下发到chunkserver，写缓存后台刷盘也通过该接口下发
+   */
+  int DoWrite(const char* buf, off_t offset, size_t length,
+              MDSClient* mdsclient);
+
+  /**
+   * 写请求写入写缓存
+   */
+  int WriteToWriteBackCache(const char* buf, off_t offset, size_t length);
+
+  /**
+   * 下发预读请求，预读请求不经过读缓存和预读
+   */
+  void IssuePrefetch(CurveAioContext* ctx);
+
+  /**
+   * 释放被discard完全覆盖的segment，在后台线程中执行
+   * @param: segoff为segment在文件中的偏移
+   */
+  void ReleaseSegment(uint64_t segoff);
+
   /**
    * 当lesaeexcutor发现版本变更，调用该接口开始等待inflight回来，这段期间IO是hang的
    */
@@ -218,6 +384,33 @@ class IOManager4File : public IOManager {
   // client端metric统计信息
   FileMetric*        fileMetric_;
 
+  // 文件读缓存
+  ReadCache readCache_;
+
+  // 文件顺序读预读
+  ReadAhead readAhead_;
+
+  // 文件写缓存
+  WriteBackCache writeBackCache_;
+
+  // 记录只覆盖chunk部分区间的discard
+  DiscardRecorder discardRecorder_;
+
+  // 在后台释放被discard完全覆盖的segment
+  SegmentReleaser segmentReleaser_;
+
+  // 执行segment释放的后台线程，不占用IO回调和任务队列的线程
+  curve::common::TaskThreadPool releasePool_;
+
+  // 文件QoS限流，限流通过的异步请求再放入任务队列
+  Throttle throttle_;
+
+  // 读写IO分阶段耗时追踪
+  IOTracer ioTracer_;
+
+  // 与mds通信，写缓存后台刷盘和释放segment时使用
+  MDSClient* mdsclient_;
+
   // task thread pool为了将qemu线程与curve线程隔离
   curve::common::TaskThreadPool taskPool_;
 
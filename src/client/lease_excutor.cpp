@@ -99,6 +99,7 @@ void LeaseExcutor::RefreshLease() {
 
     if (response.status == LeaseRefreshResult::Status::OK) {
         CheckNeedUpdateVersion(response.finfo.seqnum);
+        iomanager_->UpdateThrottleParams(response.finfo);
         failedrefreshcount_.store(0);
         isleaseAvaliable_.store(true);
         iomanager_->RefeshSuccAndResumeIO();
@@ -112,10 +112,37 @@ int CurveClient::AioRead(int fd, CurveAioContext* aioctx) {
     return fileClient_->AioRead(fd, aioctx);
 }
 
+int CurveClient::AioReadIOBuf(int fd, CurveAioContext* aioctx,
+                              butil::IOBuf* data) {
+    return fileClient_->AioReadIOBuf(fd, aioctx, data);
+}
+
+int CurveClient::AioReadv(int fd, CurveAioContext* aioctx,
+                          const struct iovec* iov, int iovcnt) {
+    return fileClient_->AioReadv(fd, aioctx, iov, iovcnt);
+}
+
 int CurveClient::AioWrite(int fd, CurveAioContext* aioctx) {
     return fileClient_->AioWrite(fd, aioctx);
 }
 
+int CurveClient::AioWritev(int fd, CurveAioContext* aioctx,
+                           const struct iovec* iov, int iovcnt) {
+    return fileClient_->AioWritev(fd, aioctx, iov, iovcnt);
+}
+
+int CurveClient::AioFlush(int fd, CurveAioContext* aioctx) {
+    return fileClient_->AioFlush(fd, aioctx);
+}
+
+int CurveClient::AioDiscard(int fd, CurveAioContext* aioctx) {
+    return fileClient_->AioDiscard(fd, aioctx);
+}
+
+int CurveClient::InvalidCache(int fd) {
+    return fileClient_->InvalidCache(fd);
+}
+
 void CurveClient::SetFileClient(FileClient* client) {
     delete fileClient_;
     fileClient_ = client;
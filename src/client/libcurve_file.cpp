@@ -325,6 +325,57 @@ int FileClient::AioRead(int fd, CurveAioContext* aioctx) {
     return ret;
 }
 
+int FileClient::AioReadIOBuf(int fd, CurveAioContext* aioctx,
+                             butil::IOBuf* data) {
+    // 长度为0，直接返回，不做任何操作
+    if (aioctx->length == 0) {
+        return -LIBCURVE_ERROR::OK;
+    }
+
+    if (CheckAligned(aioctx->offset, aioctx->length) == false) {
+        return -LIBCURVE_ERROR::NOT_ALIGNED;
+    }
+
+    int ret = -LIBCURVE_ERROR::FAILED;
+    ReadLockGuard lk(rwlock_);
+    if (CURVE_UNLIKELY(fileserviceMap_.find(fd) == fileserviceMap_.end())) {
+        LOG(ERROR) << "invalid fd!";
+        ret = -LIBCURVE_ERROR::BAD_FD;
+    } else {
+        ret = fileserviceMap_[fd]->AioReadIOBuf(aioctx, data);
+    }
+
+    return ret;
+}
+
+int FileClient::AioReadv(int fd, CurveAioContext* aioctx,
+                         const struct iovec* iov, int iovcnt) {
+    // 长度为0，直接返回，不做任何操作
+    if (aioctx->length == 0) {
+        return -LIBCURVE_ERROR::OK;
+    }
+
+    if (CheckAligned(aioctx->offset, aioctx->length) == false) {
+        return -LIBCURVE_ERROR::NOT_ALIGNED;
+    }
+
+    std::vector<iovec> vecs;
+    if (!CheckIovec(iov, iovcnt, aioctx->length, &vecs)) {
+        return -LIBCURVE_ERROR::PARAM_ERROR;
+    }
+
+    int ret = -LIBCURVE_ERROR::FAILED;
+    ReadLockGuard lk(rwlock_);
+    if (CURVE_UNLIKELY(fileserviceMap_.find(fd) == fileserviceMap_.end())) {
+        LOG(ERROR) << "invalid fd!";
+        ret = -LIBCURVE_ERROR::BAD_FD;
+    } else {
+        ret = fileserviceMap_[fd]->AioReadv(aioctx, vecs);
+    }
+
+    return ret;
+}
+
 int FileClient::AioWrite(int fd, CurveAioContext* aioctx) {
     // 长度为0，直接返回，不做任何操作
     if (aioctx->length == 0) {
@@ -347,6 +398,72 @@ int FileClient::AioWrite(int fd, CurveAioContext* aioctx) {
     return ret;
 }
 
+int FileClient::AioWritev(int fd, CurveAioContext* aioctx,
+                          const struct iovec* iov, int iovcnt) {
+    // 长度为0，直接返回，不做任何操作
+    if (aioctx->length == 0) {
+        return -LIBCURVE_ERROR::OK;
+    }
+
+    if (CheckAligned(aioctx->offset, aioctx->length) == false) {
+        return -LIBCURVE_ERROR::NOT_ALIGNED;
+    }
+
+    std::vector<iovec> vecs;
+    if (!CheckIovec(iov, iovcnt, aioctx->length, &vecs)) {
+        return -LIBCURVE_ERROR::PARAM_ERROR;
+    }
+
+    int ret = -LIBCURVE_ERROR::FAILED;
+    ReadLockGuard lk(rwlock_);
+    if (CURVE_UNLIKELY(fileserviceMap_.find(fd) == fileserviceMap_.end())) {
+        LOG(ERROR) << "invalid fd!";
+        ret = -LIBCURVE_ERROR::BAD_FD;
+    } else {
+        ret = fileserviceMap_[fd]->AioWritev(aioctx, vecs);
+    }
+
+    return ret;
+}
+
+int FileClient::AioFlush(int fd, CurveAioContext* aioctx) {
+    int ret = -LIBCURVE_ERROR::FAILED;
+    ReadLockGuard lk(rwlock_);
+    if (CURVE_UNLIKELY(fileserviceMap_.find(fd) == fileserviceMap_.end())) {
+        LOG(ERROR) << "invalid fd!";
+        ret = -LIBCURVE_ERROR::BAD_FD;
+    } else {
+        ret = fileserviceMap_[fd]->AioFlush(aioctx);
+    }
+
+    return ret;
+}
+
+int FileClient::AioDiscard(int fd, CurveAioContext* aioctx) {
+    int ret = -LIBCURVE_ERROR::FAILED;
+    ReadLockGuard lk(rwlock_);
+    if (CURVE_UNLIKELY(fileserviceMap_.find(fd) == fileserviceMap_.end())) {
+        LOG(ERROR) << "invalid fd!";
+        ret = -LIBCURVE_ERROR::BAD_FD;
+    } else {
+        ret = fileserviceMap_[fd]->AioDiscard(aioctx);
+    }
+
+    return ret;
+}
+
+int FileClient::InvalidCache(int fd) {
+    ReadLockGuard lk(rwlock_);
+    auto iter = fileserviceMap_.find(fd);
+    if (CURVE_UNLIKELY(iter == fileserviceMap_.end())) {
+        LOG(ERROR) << "invalid fd!";
+        return -LIBCURVE_ERROR::BAD_FD;
+    }
+
+    iter->second->GetIOManager4File()->InvalidCache();
+    return LIBCURVE_ERROR::OK;
+}
+
 int FileClient::Rename(const UserInfo_t& userinfo,
     const std::string& oldpath, const std::string& newpath) {
     LIBCURVE_ERROR ret;
@@ -495,6 +612,35 @@ bool FileClient::CheckAligned(off_t offset, size_t length) {
            (length % IO_ALIGNED_BLOCK_SIZE == 0);
 }
 
+bool FileClient::CheckIovec(const struct iovec* iov, int iovcnt,
+                            size_t length, std::vector<iovec>* out) {
+    if (iov == nullptr || iovcnt <= 0) {
+        LOG(ERROR) << "invalid iov, iovcnt = " << iovcnt;
+        return false;
+    }
+
+    size_t total = 0;
+    out->reserve(iovcnt);
+    for (int i = 0; i < iovcnt; ++i) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+        if (iov[i].iov_base == nullptr) {
+            LOG(ERROR) << "invalid iov, iov[" << i << "] base is null";
+            return false;
+        }
+        total += iov[i].iov_len;
+        out->push_back(iov[i]);
+    }
+
+    if (total != length) {
+        LOG(ERROR) << "iov length mismatch, iov length = " << total
+                   << ", io length = " << length;
+        return false;
+    }
+    return true;
+}
+
 FileInstance* FileClient::GetInitedFileInstance(const std::string& filename,
     const UserInfo& userinfo, bool readonly) {
     FileInstance* fileserv = new (std::nothrow) FileInstance();
@@ -709,6 +855,50 @@ int AioWrite(int fd, CurveAioContext* aioctx) {
     return globalclient->AioWrite(fd, aioctx);
 }
 
+int AioReadv(int fd, CurveAioContext* aioctx,
+             const struct iovec* iov, int iovcnt) {
+    if (globalclient == nullptr) {
+        LOG(ERROR) << "not inited!";
+        return -LIBCURVE_ERROR::FAILED;
+    }
+
+    DVLOG(9) << "offset: " << aioctx->offset
+        << " length: " << aioctx->length
+        << " iovcnt: " << iovcnt;
+    return globalclient->AioReadv(fd, aioctx, iov, iovcnt);
+}
+
+int AioWritev(int fd, CurveAioContext* aioctx,
+              const struct iovec* iov, int iovcnt) {
+    if (globalclient == nullptr) {
+        LOG(ERROR) << "not inited!";
+        return -LIBCURVE_ERROR::FAILED;
+    }
+
+    DVLOG(9) << "offset: " << aioctx->offset
+        << " length: " << aioctx->length
+        << " iovcnt: " << iovcnt;
+    return globalclient->AioWritev(fd, aioctx, iov, iovcnt);
+}
+
+int AioFlush(int fd, CurveAioContext* aioctx) {
+    if (globalclient == nullptr) {
+        LOG(ERROR) << "not inited!";
+        return -LIBCURVE_ERROR::FAILED;
+    }
+
+    return globalclient->AioFlush(fd, aioctx);
+}
+
+int AioDiscard(int fd, CurveAioContext* aioctx) {
+    if (globalclient == nullptr) {
+        LOG(ERROR) << "not inited!";
+        return -LIBCURVE_ERROR::FAILED;
+    }
+
+    return globalclient->AioDiscard(fd, aioctx);
+}
+
 int Create(const char* filename, const C_UserInfo_t* userinfo, size_t size) {
     if (globalclient == nullptr) {
         LOG(ERROR) << "not inited!";
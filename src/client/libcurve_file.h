@@ -24,6 +24,7 @@
 #define SRC_CLIENT_LIBCURVE_FILE_H_
 
 #include <unistd.h>
+#include <sys/uio.h>
 #include <atomic>
 #include <string>
 #include <unordered_map>
@@ -141,6 +142,27 @@ class FileClient {
      */
     virtual int AioRead(int fd, CurveAioContext* aioctx);
 
+    /**
+     * 异步模式读，数据以IOBuf的形式返回，直接引用rpc返回的数据，不拷贝到用户buffer
+     * @param: fd为当前open返回的文件描述符
+     * @param: aioctx为异步读写的io上下文，保存基本的io信息，不使用其中的buf
+     * @param: data用于保存读到的数据，回调时读成功的数据已追加到其中
+     * @return: 成功返回0,否则返回小于0的错误码
+     */
+    virtual int AioReadIOBuf(int fd, CurveAioContext* aioctx,
+                             butil::IOBuf* data);
+
+    /**
+     * 异步模式读，读到的数据按顺序填充到iov的各段buffer中
+     * @param: fd为当前open返回的文件描述符
+     * @param: aioctx为异步读写的io上下文，保存基本的io信息，不使用其中的buf
+     * @param: iov为用户的buffer数组，各段长度之和需要等于aioctx中的length
+     * @param: iovcnt为iov数组的长度
+     * @return: 成功返回0,否则返回小于0的错误码
+     */
+    virtual int AioReadv(int fd, CurveAioContext* aioctx,
+                         const struct iovec* iov, int iovcnt);
+
     /**
      * 异步模式写
      * @param: fd为当前open返回的文件描述符
@@ -149,6 +171,40 @@ class FileClient {
      */
     virtual int AioWrite(int fd, CurveAioContext* aioctx);
 
+    /**
+     * 异步模式写，写入iov中各段buffer拼接而成的数据，不拷贝到连续的buffer
+     * @param: fd为当前open返回的文件描述符
+     * @param: aioctx为异步读写的io上下文，保存基本的io信息，不使用其中的buf
+     * @param: iov为用户的buffer数组，各段长度之和需要等于aioctx中的length
+     * @param: iovcnt为iov数组的长度
+     * @return: 成功返回0,否则返回小于0的错误码
+     */
+    virtual int AioWritev(int fd, CurveAioContext* aioctx,
+                          const struct iovec* iov, int iovcnt);
+
+    /**
+     * 异步模式flush
+     * @param: fd为当前open返回的文件描述符
+     * @param: aioctx为异步io上下文
+     * @return: 成功返回0,否则返回小于0的错误码
+     */
+    virtual int AioFlush(int fd, CurveAioContext* aioctx);
+
+    /**
+     * 异步模式discard
+     * @param: fd为当前open返回的文件描述符
+     * @param: aioctx为异步io上下文
+     * @return: 成功返回0,否则返回小于0的错误码
+     */
+    virtual int AioDiscard(int fd, CurveAioContext* aioctx);
+
+    /**
+     * 清空文件的读缓存
+     * @param: fd为当前open返回的文件描述符
+     * @return: 成功返回LIBCURVE_ERROR::OK,否则返回小于0的错误码
+     */
+    virtual int InvalidCache(int fd);
+
     /**
      * 重命名文件
      * @param: userinfo是用户信息
@@ -272,6 +328,13 @@ class FileClient {
 
     inline bool CheckAligned(off_t offset, size_t length);
 
+    /**
+     * 检查iov各段长度之和是否等于length，并拷贝到out中
+     * 长度为0的段会被跳过
+     */
+    bool CheckIovec(const struct iovec* iov, int iovcnt, size_t length,
+                    std::vector<iovec>* out);
+
     // 获取一个初始化的FileInstance对象
     // return: 成功返回指向对象的指针,否则返回nullptr
     FileInstance* GetInitedFileInstance(const std::string& filename,
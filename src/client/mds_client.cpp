@@ -49,6 +49,7 @@ using curve::mds::CreateFileResponse;
 using curve::mds::DeleteFileResponse;
 using curve::mds::GetFileInfoResponse;
 using curve::mds::GetOrAllocateSegmentResponse;
+using curve::mds::DeAllocateSegmentResponse;
 using curve::mds::RenameFileResponse;
 using curve::mds::ExtendFileResponse;
 using curve::mds::ChangeOwnerResponse;
@@ -896,6 +897,35 @@ LIBCURVE_ERROR MDSClient::GetOrAllocateSegment(bool allocate, uint64_t offset,
     return rpcExcutor.DoRPCTask(task, IOPathMaxRetryMS);
 }
 
+LIBCURVE_ERROR MDSClient::DeAllocateSegment(const FInfo_t* fi,
+                                            uint64_t offset) {
+    auto task = RPCTaskDefine {
+        DeAllocateSegmentResponse response;
+        mdsClientMetric_.deAllocateSegment.qps.count << 1;
+        LatencyGuard lg(&mdsClientMetric_.deAllocateSegment.latency);
+        mdsClientBase_.DeAllocateSegment(fi, offset, &response, cntl, channel);
+        if (cntl->Failed()) {
+            mdsClientMetric_.deAllocateSegment.eps.count << 1;
+            LOG(WARNING) << "DeAllocateSegment invoke failed, errcorde = "
+                << cntl->ErrorCode() << ", error content:"
+                << cntl->ErrorText() << ", log id = " << cntl->log_id();
+            return -cntl->ErrorCode();
+        }
+
+        LIBCURVE_ERROR retcode;
+        StatusCode stcode = response.statuscode();
+        MDSStatusCode2LibcurveError(stcode, &retcode);
+        LOG_IF(WARNING, retcode != LIBCURVE_ERROR::OK)
+                << "DeAllocateSegment: filename = " << fi->fullPathName
+                << ", offset = " << offset
+                << ", errocde = " << retcode
+                << ", error msg = " << StatusCode_Name(stcode)
+                << ", log id = " << cntl->log_id();
+        return retcode;
+    };
+    return rpcExcutor.DoRPCTask(task, metaServerOpt_.mdsMaxRetryMS);
+}
+
 LIBCURVE_ERROR MDSClient::RenameFile(const UserInfo_t& userinfo,
     const std::string &origin, const std::string &destination,
     uint64_t originId, uint64_t destinationId) {
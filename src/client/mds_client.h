@@ -127,6 +127,14 @@ class MDSClient {
                             uint64_t offset,
                             const FInfo_t* fi,
                             SegmentInfo *segInfo);
+    /**
+     * 释放segment，mds删除segment内的chunk后再删除segment元数据
+     * @param: fi是当前文件的基本信息
+     * @param: offset为segment的起始偏移
+     * @return: 成功返回LIBCURVE_ERROR::OK，segment不存在也返回成功，
+     *          文件有快照或处于克隆状态时返回相应错误码，否则返回LIBCURVE_ERROR::FAILED
+     */
+    LIBCURVE_ERROR DeAllocateSegment(const FInfo_t* fi, uint64_t offset);
     /**
      * 获取文件信息，fi是出参
      * @param: filename是文件名
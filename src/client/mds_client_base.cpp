@@ -359,6 +359,25 @@ void MDSClientBase::GetOrAllocateSegment(bool allocate,
     stub.GetOrAllocateSegment(cntl, &request, response, NULL);
 }
 
+void MDSClientBase::DeAllocateSegment(const FInfo_t* fi,
+                                uint64_t offset,
+                                DeAllocateSegmentResponse* response,
+                                brpc::Controller* cntl,
+                                brpc::Channel* channel) {
+    DeAllocateSegmentRequest request;
+    request.set_filename(fi->fullPathName);
+    request.set_offset(offset);
+    FillUserInfo<DeAllocateSegmentRequest>(&request, fi->userinfo);
+
+    LOG(INFO) << "DeAllocateSegment: filename = " << fi->fullPathName
+                << ", owner = " << fi->owner.c_str()
+                << ", segment offset = " << offset
+                << ", log id = " << cntl->log_id();
+
+    curve::mds::CurveFSService_Stub stub(channel);
+    stub.DeAllocateSegment(cntl, &request, response, NULL);
+}
+
 void MDSClientBase::RenameFile(const UserInfo_t& userinfo,
                                 const std::string &origin,
                                 const std::string &destination,
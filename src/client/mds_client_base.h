@@ -73,6 +73,8 @@ using curve::mds::SetCloneFileStatusRequest;
 using curve::mds::SetCloneFileStatusResponse;
 using curve::mds::GetOrAllocateSegmentRequest;
 using curve::mds::GetOrAllocateSegmentResponse;
+using curve::mds::DeAllocateSegmentRequest;
+using curve::mds::DeAllocateSegmentResponse;
 using curve::mds::CheckSnapShotStatusRequest;
 using curve::mds::CheckSnapShotStatusResponse;
 using curve::mds::ListSnapShotFileInfoRequest;
@@ -325,6 +327,19 @@ class MDSClientBase {
                     GetOrAllocateSegmentResponse* response,
                     brpc::Controller* cntl,
                     brpc::Channel* channel);
+    /**
+     * 释放segment，mds删除segment内的chunk后再删除segment元数据
+     * @param: fi是当前文件的基本信息
+     * @param: offset为segment的起始偏移
+     * @param[out]: response为该rpc的response，提供给外部处理
+     * @param[in|out]: cntl既是入参，也是出参，返回RPC状态
+     * @param[in]:channel是当前与mds建立的通道
+     */
+    void DeAllocateSegment(const FInfo_t* fi,
+                    uint64_t offset,
+                    DeAllocateSegmentResponse* response,
+                    brpc::Controller* cntl,
+                    brpc::Channel* channel);
     /**
      * @brief 重名文件
      * @param:userinfo 用户信息
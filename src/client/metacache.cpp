@@ -54,28 +54,27 @@ void MetaCache::Init(MetaCacheOption_t metaCacheOpt, MDSClient* mdsclient) {
 }
 
 MetaCacheErrorType MetaCache::GetChunkInfoByIndex(ChunkIndex chunkidx, ChunkIDInfo_t* chunxinfo ) {  // NOLINT
-    ReadLockGuard rdlk(rwlock4ChunkInfo_);
-    auto iter = chunkindex2idMap_.find(chunkidx);
-    if (iter != chunkindex2idMap_.end()) {
-        *chunxinfo = iter->second;
+    if (chunkindex2idTable_.Get(chunkidx, chunxinfo)) {
         return MetaCacheErrorType::OK;
     }
     return MetaCacheErrorType::CHUNKINFO_NOT_FOUND;
 }
 
+CopysetInfo_t MetaCache::CopyCopysetInfo(CopysetInfo_t* info) {
+    info->spinlock_.Lock();
+    CopysetInfo_t copy(*info);
+    info->spinlock_.UnLock();
+    return copy;
+}
+
 bool MetaCache::IsLeaderMayChange(LogicPoolID logicPoolId,
                                   CopysetID copysetId) {
-    rwlock4ChunkInfo_.RDLock();
-    auto iter = lpcsid2CopsetInfoMap_.find(
-        LogicPoolCopysetID2Str(logicPoolId, copysetId));
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
-        rwlock4ChunkInfo_.Unlock();
+    CopysetInfo_t* info = FindCopysetInfo(logicPoolId, copysetId);
+    if (info == nullptr) {
         return false;
     }
 
-    bool flag = iter->second.LeaderMayChange();
-    rwlock4ChunkInfo_.Unlock();
-    return flag;
+    return info->LeaderMayChange();
 }
 
 int MetaCache::GetLeader(LogicPoolID logicPoolId,
@@ -84,19 +83,22 @@ int MetaCache::GetLeader(LogicPoolID logicPoolId,
                         EndPoint* serverAddr,
                         bool refresh,
                         FileMetric* fm) {
-    std::string mapkey = LogicPoolCopysetID2Str(logicPoolId, copysetId);
-
-    CopysetInfo_t targetInfo;
-    rwlock4CopysetInfo_.RDLock();
-    auto iter = lpcsid2CopsetInfoMap_.find(mapkey);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
-        rwlock4CopysetInfo_.Unlock();
+    CopysetInfo_t* info = FindCopysetInfo(logicPoolId, copysetId);
+    if (info == nullptr) {
         LOG(ERROR) << "server list not exist, LogicPoolID = " << logicPoolId
                    << ", CopysetID = " << copysetId;
         return -1;
     }
-    targetInfo = iter->second;
-    rwlock4CopysetInfo_.Unlock();
+
+    // 不需要刷新leader时直接读取缓存的leader信息，避免拷贝整个copyset信息
+    if (!refresh && !info->LeaderMayChange()) {
+        info->spinlock_.Lock();
+        int ret = info->GetLeaderInfo(serverId, serverAddr);
+        info->spinlock_.UnLock();
+        return ret;
+    }
+
+    CopysetInfo_t targetInfo = CopyCopysetInfo(info);
 
     int ret = 0;
     if (refresh || targetInfo.LeaderMayChange()) {
@@ -223,16 +225,12 @@ void MetaCache::UpdateCopysetInfoIfMatchCurrentLeader(
 
 CopysetInfo_t MetaCache::GetServerList(LogicPoolID logicPoolId,
                                        CopysetID copysetId) {
-    std::string mapkey = LogicPoolCopysetID2Str(logicPoolId, copysetId);
-    CopysetInfo_t ret;
-
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    auto iter = lpcsid2CopsetInfoMap_.find(mapkey);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
+    CopysetInfo_t* info = FindCopysetInfo(logicPoolId, copysetId);
+    if (info == nullptr) {
         // it's impossible to get here
-        return ret;
+        return CopysetInfo_t();
     }
-    return iter->second;
+    return CopyCopysetInfo(info);
 }
 
 /**
@@ -242,54 +240,59 @@ CopysetInfo_t MetaCache::GetServerList(LogicPoolID logicPoolId,
  */
 int MetaCache::UpdateLeader(LogicPoolID logicPoolId,
     CopysetID copysetId, ChunkServerID* leaderId, const EndPoint &leaderAddr) {
-    std::string mapkey = LogicPoolCopysetID2Str(logicPoolId, copysetId);
-
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    auto iter = lpcsid2CopsetInfoMap_.find(mapkey);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
+    CopysetInfo_t* info = FindCopysetInfo(logicPoolId, copysetId);
+    if (info == nullptr) {
         // it's impossible to get here
         return -1;
     }
 
     ChunkServerAddr csAddr(leaderAddr);
-    return iter->second.UpdateLeaderInfo(*leaderId, csAddr);
+    return info->UpdateLeaderInfo(*leaderId, csAddr);
 }
 
 void MetaCache::UpdateChunkInfoByIndex(ChunkIndex cindex, ChunkIDInfo_t cinfo) {
-    WriteLockGuard wrlk(rwlock4ChunkInfo_);
-    chunkindex2idMap_[cindex] = cinfo;
+    chunkindex2idTable_.Set(cindex, cinfo);
+}
+
+void MetaCache::ReleaseChunkInfoByIndex(ChunkIndex cindex) {
+    chunkindex2idTable_.Erase(cindex);
 }
 
 void MetaCache::UpdateCopysetInfo(LogicPoolID logicPoolid, CopysetID copysetid,
                                   const CopysetInfo& csinfo) {
-    auto key = LogicPoolCopysetID2Str(logicPoolid, copysetid);
-    WriteLockGuard wrlk(rwlock4CopysetInfo_);
-    lpcsid2CopsetInfoMap_[key] = csinfo;
+    // 已存在的copyset直接在其spinlock保护下原地更新，不需要修改映射表
+    CopysetInfo_t* info = FindCopysetInfo(logicPoolid, copysetid);
+    if (info == nullptr) {
+        bool inserted = false;
+        info = lpcsid2CopsetInfoTable_.FindOrInsert(
+            CalcLogicPoolCopysetID(logicPoolid, copysetid), csinfo, &inserted);
+        if (inserted) {
+            return;
+        }
+    }
+
+    info->spinlock_.Lock();
+    *info = csinfo;
+    info->spinlock_.UnLock();
 }
 
 void MetaCache::UpdateAppliedIndex(LogicPoolID logicPoolId,
     CopysetID copysetId, uint64_t appliedindex) {
-    std::string mapkey = LogicPoolCopysetID2Str(logicPoolId, copysetId);
-
-    WriteLockGuard wrlk(rwlock4CopysetInfo_);
-    auto iter = lpcsid2CopsetInfoMap_.find(mapkey);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
+    CopysetInfo_t* info = FindCopysetInfo(logicPoolId, copysetId);
+    if (info == nullptr) {
         return;
     }
-    iter->second.UpdateAppliedIndex(appliedindex);
+    info->UpdateAppliedIndex(appliedindex);
 }
 
 uint64_t MetaCache::GetAppliedIndex(LogicPoolID logicPoolId,
                                     CopysetID copysetId) {
-    std::string mapkey = LogicPoolCopysetID2Str(logicPoolId, copysetId);
-
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    auto iter = lpcsid2CopsetInfoMap_.find(mapkey);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
+    CopysetInfo_t* info = FindCopysetInfo(logicPoolId, copysetId);
+    if (info == nullptr) {
         return 0;
     }
 
-    return iter->second.GetAppliedIndex();
+    return info->GetAppliedIndex();
 }
 
 void MetaCache::UpdateChunkInfoByID(ChunkID cid, ChunkIDInfo cidinfo) {
@@ -326,21 +329,21 @@ void MetaCache::SetChunkserverUnstable(ChunkServerID csid) {
         }
     }
 
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
     for (auto it : copysetIDSet) {
-        std::string mapkey = LogicPoolCopysetID2Str(it.lpid, it.cpid);
-        auto cpinfo = lpcsid2CopsetInfoMap_.find(mapkey);
-        if (cpinfo != lpcsid2CopsetInfoMap_.end()) {
+        CopysetInfo_t* cpinfo = FindCopysetInfo(it.lpid, it.cpid);
+        if (cpinfo != nullptr) {
             ChunkServerID leaderid;
-            if (cpinfo->second.GetCurrentLeaderServerID(&leaderid)) {
+            cpinfo->spinlock_.Lock();
+            if (cpinfo->GetCurrentLeaderServerID(&leaderid)) {
                 if (leaderid == csid) {
                     // 只设置leaderid为当前serverid的Lcopyset
-                    cpinfo->second.SetLeaderUnstableFlag();
+                    cpinfo->SetLeaderUnstableFlag();
                 }
             } else {
                 // 当前copyset集群信息未知，直接设置LeaderUnStable
-                cpinfo->second.SetLeaderUnstableFlag();
+                cpinfo->SetLeaderUnstableFlag();
             }
+            cpinfo->spinlock_.UnLock();
         }
     }
 }
@@ -353,16 +356,14 @@ void MetaCache::AddCopysetIDInfo(ChunkServerID csid,
 
 void MetaCache::UpdateChunkserverCopysetInfo(LogicPoolID lpid,
     const CopysetInfo_t& cpinfo) {
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    std::string mapkey = LogicPoolCopysetID2Str(lpid, cpinfo.cpid_);
     // 先获取原来的chunkserver到copyset映射
-    auto previouscpinfo = lpcsid2CopsetInfoMap_.find(mapkey);
-    if (previouscpinfo != lpcsid2CopsetInfoMap_.end()) {
+    CopysetInfo_t* previouscpinfo = FindCopysetInfo(lpid, cpinfo.cpid_);
+    if (previouscpinfo != nullptr) {
         std::vector<ChunkServerID> newID;
         std::vector<ChunkServerID> changedID;
 
         // 先判断当前copyset有没有变更chunkserverid
-        for (auto iter : previouscpinfo->second.csinfos_) {
+        for (auto iter : CopyCopysetInfo(previouscpinfo).csinfos_) {
             changedID.push_back(iter.chunkserverid_);
         }
 
@@ -396,11 +397,9 @@ void MetaCache::UpdateChunkserverCopysetInfo(LogicPoolID lpid,
 }
 
 CopysetInfo_t MetaCache::GetCopysetinfo(LogicPoolID lpid, CopysetID csid) {
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    std::string mapkey = LogicPoolCopysetID2Str(lpid, csid);
-    auto cpinfo = lpcsid2CopsetInfoMap_.find(mapkey);
-    if (cpinfo != lpcsid2CopsetInfoMap_.end()) {
-        return cpinfo->second;
+    CopysetInfo_t* cpinfo = FindCopysetInfo(lpid, csid);
+    if (cpinfo != nullptr) {
+        return CopyCopysetInfo(cpinfo);
     }
     return CopysetInfo();
 }
@@ -412,9 +411,5 @@ std::string MetaCache::LogicPoolCopysetChunkID2Str(LogicPoolID lpid,
                                 .append("_")
                                 .append(std::to_string(chunkid));
 }
-std::string MetaCache::LogicPoolCopysetID2Str(LogicPoolID lpid,
-    CopysetID csid) {
-    return std::to_string(lpid).append("_").append(std::to_string(csid));
-}
 }   // namespace client
 }   // namespace curve
@@ -51,10 +51,7 @@ enum class MetaCacheErrorType {
 
 class MetaCache {
  public:
-    using CopysetLogicPoolIDStr      = std::string;
     using ChunkInfoMap               = std::unordered_map<ChunkID, ChunkIDInfo_t>;       // NOLINT
-    using CopysetInfoMap             = std::unordered_map<CopysetLogicPoolIDStr, CopysetInfo_t>;            // NOLINT
-    using ChunkIndexInfoMap          = std::map<ChunkIndex, ChunkIDInfo_t>;
 
     MetaCache() = default;
     virtual ~MetaCache() = default;
@@ -138,6 +135,11 @@ class MetaCache {
      */
     virtual void UpdateChunkInfoByIndex(ChunkIndex cindex,
                                 ChunkIDInfo_t chunkinfo);
+    /**
+     * chunk所在的segment被释放后，删除chunk index对应的chunkid信息
+     * @param: cindex为待删除的chunk index
+     */
+    virtual void ReleaseChunkInfoByIndex(ChunkIndex cindex);
     /**
      * 通过chunk id更新chunkid信息
      * @param: cid为chunkid
@@ -172,14 +174,6 @@ class MetaCache {
     virtual CopysetInfo_t GetServerList(LogicPoolID logicPoolId,
                                         CopysetID copysetId);
 
-    /**
-     * 将ID转化为cache的key
-     * @param: lpid逻辑池id
-     * @param: cpid是copysetid
-     * @return: 为当前的key
-     */
-    inline std::string LogicPoolCopysetID2Str(LogicPoolID lpid,
-                                        CopysetID csid);
     /**
      * 将ID转化为cache的key
      * @param: lpid逻辑池id
@@ -279,6 +273,23 @@ class MetaCache {
                              CopysetInfo* toupdateCopyset,
                              FileMetric* fm = nullptr);
 
+    /**
+     * 查找copyset信息，读路径不加锁
+     * @param: logicPoolId 逻辑池id
+     * @param: copysetId 复制组id
+     * @return: 存在返回copyset信息指针，否则返回nullptr
+     */
+    CopysetInfo_t* FindCopysetInfo(LogicPoolID logicPoolId,
+                                   CopysetID copysetId) {
+        return lpcsid2CopsetInfoTable_.Find(
+            CalcLogicPoolCopysetID(logicPoolId, copysetId));
+    }
+
+    /**
+     * 在copyset信息的spinlock保护下拷贝一份copyset信息
+     */
+    static CopysetInfo_t CopyCopysetInfo(CopysetInfo_t* info);
+
     /**
      * 从mds拉去复制组信息，如果当前leader在复制组中
      * 则更新本地缓存，反之则不更新
@@ -295,19 +306,17 @@ class MetaCache {
     MDSClient*          mdsclient_;
     MetaCacheOption_t   metacacheopt_;
 
-    // chunkindex到chunkidinfo的映射表
-    CURVE_CACHELINE_ALIGNMENT ChunkIndexInfoMap     chunkindex2idMap_;
+    // chunkindex到chunkidinfo的稠密映射表，读路径无锁
+    CURVE_CACHELINE_ALIGNMENT ChunkIndexInfoTable   chunkindex2idTable_;
 
-    // logicalpoolid和copysetid到copysetinfo的映射表
-    CURVE_CACHELINE_ALIGNMENT CopysetInfoMap        lpcsid2CopsetInfoMap_;
+    // logicalpoolid和copysetid到copysetinfo的映射表，读路径无锁
+    CURVE_CACHELINE_ALIGNMENT CopysetInfoTable      lpcsid2CopsetInfoTable_;
 
     // chunkid到chunkidinfo的映射表
     CURVE_CACHELINE_ALIGNMENT ChunkInfoMap          chunkid2chunkInfoMap_;
 
-    // 三个读写锁分别保护上述三个映射表
+    // 读写锁保护chunkid2chunkInfoMap_
     CURVE_CACHELINE_ALIGNMENT RWLock    rwlock4chunkInfoMap_;
-    CURVE_CACHELINE_ALIGNMENT RWLock    rwlock4ChunkInfo_;
-    CURVE_CACHELINE_ALIGNMENT RWLock    rwlock4CopysetInfo_;
 
     // chunkserverCopysetIDMap_存放当前chunkserver到copyset的映射
     // 当rpc closure设置SetChunkserverUnstable时，会设置该chunkserver
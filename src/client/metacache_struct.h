@@ -27,6 +27,8 @@
 #include <string>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>   // NOLINT
 #include <vector>
 #include <unordered_map>
 
@@ -333,6 +335,337 @@ operator==(const CopysetIDInfo& cpidinfo1, const CopysetIDInfo& cpidinfo2) {
            cpidinfo1.lpid == cpidinfo2.lpid;
 }
 
+// 逻辑池id和复制组id拼接成的64位key，高32位为逻辑池id，低32位为复制组id
+using LogicPoolCopysetID = uint64_t;
+
+inline LogicPoolCopysetID CalcLogicPoolCopysetID(LogicPoolID lpid,
+                                                 CopysetID cpid) {
+    return (static_cast<uint64_t>(lpid) << 32) | cpid;
+}
+
+/**
+ * 以LogicPoolCopysetID为key的copyset信息表
+ * 开放寻址的扁平哈希表，只插入不删除，copyset信息对象由表持有，生命周期与表相同。
+ * 读路径不加锁：插入时先写key，再以release语义发布value指针，读者看到非空value
+ * 即可保证key可见；扩容时重建新表并以原子指针发布，旧表在析构时才释放。
+ * 已存在的copyset信息在其spinlock保护下原地更新，写路径（插入）通过mutex互斥。
+ */
+class CopysetInfoTable {
+ public:
+    CopysetInfoTable() : table_(new Table(kInitCapacity)) {}
+
+    ~CopysetInfoTable() {
+        Table* table = table_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < table->capacity; ++i) {
+            delete table->slots[i].value.load(std::memory_order_relaxed);
+        }
+        delete table;
+    }
+
+    /**
+     * 查找copyset信息
+     * @param: key为逻辑池id和复制组id拼接成的key
+     * @return: 存在返回copyset信息指针，否则返回nullptr
+     */
+    CopysetInfo* Find(LogicPoolCopysetID key) const {
+        const Table* table = table_.load(std::memory_order_acquire);
+        return table->Find(key);
+    }
+
+    /**
+     * 查找copyset信息，不存在则插入csinfo的拷贝
+     * @param: key为逻辑池id和复制组id拼接成的key
+     * @param: csinfo为待插入的copyset信息
+     * @param: inserted为出参，表示是否新插入
+     * @return: copyset信息指针
+     */
+    CopysetInfo* FindOrInsert(LogicPoolCopysetID key,
+                              const CopysetInfo& csinfo,
+                              bool* inserted) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        Table* table = table_.load(std::memory_order_relaxed);
+        CopysetInfo* info = table->Find(key);
+        if (info != nullptr) {
+            *inserted = false;
+            return info;
+        }
+
+        // 负载因子超过1/2时扩容
+        if ((size_ + 1) * 2 > table->capacity) {
+            Table* newTable = new Table(table->capacity * 2);
+            for (size_t i = 0; i < table->capacity; ++i) {
+                CopysetInfo* value =
+                    table->slots[i].value.load(std::memory_order_relaxed);
+                if (value != nullptr) {
+                    newTable->Insert(
+                        table->slots[i].key.load(std::memory_order_relaxed),
+                        value);
+                }
+            }
+            newTable->prev = table;
+            table_.store(newTable, std::memory_order_release);
+            table = newTable;
+        }
+
+        info = new CopysetInfo(csinfo);
+        table->Insert(key, info);
+        ++size_;
+        *inserted = true;
+        return info;
+    }
+
+ private:
+    static constexpr size_t kInitCapacity = 256;
+
+    struct Slot {
+        std::atomic<uint64_t> key{0};
+        std::atomic<CopysetInfo*> value{nullptr};
+    };
+
+    struct Table {
+        explicit Table(size_t cap)
+          : capacity(cap), slots(new Slot[cap]), prev(nullptr) {}
+
+        ~Table() {
+            delete prev;
+        }
+
+        static uint64_t Hash(uint64_t key) {
+            // 64位整数混淆，避免copyset id连续时探测序列聚集
+            key ^= key >> 33;
+            key *= 0xff51afd7ed558ccdULL;
+            key ^= key >> 33;
+            return key;
+        }
+
+        CopysetInfo* Find(uint64_t key) const {
+            const size_t mask = capacity - 1;
+            for (size_t i = Hash(key) & mask, n = 0; n < capacity;
+                 i = (i + 1) & mask, ++n) {
+                CopysetInfo* value =
+                    slots[i].value.load(std::memory_order_acquire);
+                if (value == nullptr) {
+                    return nullptr;
+                }
+                if (slots[i].key.load(std::memory_order_relaxed) == key) {
+                    return value;
+                }
+            }
+            return nullptr;
+        }
+
+        void Insert(uint64_t key, CopysetInfo* value) {
+            const size_t mask = capacity - 1;
+            for (size_t i = Hash(key) & mask;; i = (i + 1) & mask) {
+                if (slots[i].value.load(std::memory_order_relaxed) ==
+                    nullptr) {
+                    slots[i].key.store(key, std::memory_order_relaxed);
+                    slots[i].value.store(value, std::memory_order_release);
+                    return;
+                }
+            }
+        }
+
+        size_t capacity;
+        std::unique_ptr<Slot[]> slots;
+        // 被替换下来的旧表，读者可能仍在访问，随当前表一起释放
+        Table* prev;
+    };
+
+ private:
+    std::atomic<Table*> table_;
+    size_t size_{0};
+    std::mutex mtx_;
+};
+
+/**
+ * chunk index到chunk id信息的稠密映射表
+ * chunk index对应的信息在segment分配之后基本不再变化，属于读多写少的场景。
+ * 表按block分配，每个block包含kSlotsPerBlock个槽位，block目录按需倍增。
+ * 读路径不加锁：每个槽位通过seqlock保证读到完整的数据，
+ * 目录通过原子指针发布，旧的目录在析构时才释放，保证读者不会访问到已释放的内存。
+ * 写路径通过mutex互斥。
+ */
+class ChunkIndexInfoTable {
+ public:
+    ChunkIndexInfoTable() : dir_(nullptr) {}
+
+    ~ChunkIndexInfoTable() {
+        Directory* dir = dir_.load(std::memory_order_acquire);
+        if (dir != nullptr) {
+            for (size_t i = 0; i < dir->capacity; ++i) {
+                delete dir->blocks[i].load(std::memory_order_relaxed);
+            }
+        }
+        delete dir;
+    }
+
+    /**
+     * 查询chunk index对应的chunk id信息
+     * @param: idx为chunk index
+     * @param: info为出参
+     * @return: 存在返回true，否则返回false
+     */
+    bool Get(ChunkIndex idx, ChunkIDInfo* info) const {
+        const Directory* dir = dir_.load(std::memory_order_acquire);
+        const size_t blockIdx = idx >> kSlotsPerBlockShift;
+        if (dir == nullptr || blockIdx >= dir->capacity) {
+            return false;
+        }
+
+        const Block* block =
+            dir->blocks[blockIdx].load(std::memory_order_acquire);
+        if (block == nullptr) {
+            return false;
+        }
+
+        const Slot& slot = block->slots[idx & (kSlotsPerBlock - 1)];
+        while (true) {
+            uint32_t seq1 = slot.seq.load(std::memory_order_acquire);
+            if (seq1 == 0) {
+                return false;
+            }
+            if (seq1 & 1) {
+                continue;
+            }
+
+            bool present = slot.present.load(std::memory_order_relaxed);
+            ChunkID cid = slot.cid.load(std::memory_order_relaxed);
+            LogicPoolID lpid = slot.lpid.load(std::memory_order_relaxed);
+            CopysetID cpid = slot.cpid.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) == seq1) {
+                if (!present) {
+                    return false;
+                }
+                info->cid_ = cid;
+                info->lpid_ = lpid;
+                info->cpid_ = cpid;
+                return true;
+            }
+        }
+    }
+
+    /**
+     * 更新chunk index对应的chunk id信息
+     * @param: idx为chunk index
+     * @param: info为待更新的chunk id信息
+     */
+    void Set(ChunkIndex idx, const ChunkIDInfo& info) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        Slot& slot = GetOrCreateBlock(idx >> kSlotsPerBlockShift)
+                         ->slots[idx & (kSlotsPerBlock - 1)];
+
+        uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+        slot.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.cid.store(info.cid_, std::memory_order_relaxed);
+        slot.lpid.store(info.lpid_, std::memory_order_relaxed);
+        slot.cpid.store(info.cpid_, std::memory_order_relaxed);
+        slot.present.store(true, std::memory_order_relaxed);
+        slot.seq.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * 删除chunk index对应的chunk id信息，chunk被删除后调用
+     * @param: idx为chunk index
+     */
+    void Erase(ChunkIndex idx) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        const Directory* dir = dir_.load(std::memory_order_relaxed);
+        const size_t blockIdx = idx >> kSlotsPerBlockShift;
+        if (dir == nullptr || blockIdx >= dir->capacity) {
+            return;
+        }
+
+        Block* block = dir->blocks[blockIdx].load(std::memory_order_relaxed);
+        if (block == nullptr) {
+            return;
+        }
+
+        Slot& slot = block->slots[idx & (kSlotsPerBlock - 1)];
+        uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+        if (seq == 0) {
+            return;
+        }
+        slot.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.present.store(false, std::memory_order_relaxed);
+        slot.seq.store(seq + 2, std::memory_order_release);
+    }
+
+ private:
+    static constexpr uint32_t kSlotsPerBlockShift = 10;
+    static constexpr uint32_t kSlotsPerBlock = 1u << kSlotsPerBlockShift;
+
+    struct Slot {
+        // 0表示槽位未写入，奇数表示正在写入
+        std::atomic<uint32_t> seq{0};
+        // 被Erase后为false
+        std::atomic<bool> present{false};
+        std::atomic<uint32_t> lpid{0};
+        std::atomic<uint32_t> cpid{0};
+        std::atomic<uint64_t> cid{0};
+    };
+
+    struct Block {
+        Slot slots[kSlotsPerBlock];
+    };
+
+    struct Directory {
+        explicit Directory(size_t cap)
+          : capacity(cap), blocks(new std::atomic<Block*>[cap]),
+            prev(nullptr) {
+            for (size_t i = 0; i < capacity; ++i) {
+                blocks[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~Directory() {
+            delete prev;
+        }
+
+        size_t capacity;
+        std::unique_ptr<std::atomic<Block*>[]> blocks;
+        // 被替换下来的旧目录，读者可能仍在访问，随当前目录一起释放
+        Directory* prev;
+    };
+
+    // 调用者需持有mtx_
+    Block* GetOrCreateBlock(size_t blockIdx) {
+        Directory* dir = dir_.load(std::memory_order_relaxed);
+        if (dir == nullptr || blockIdx >= dir->capacity) {
+            size_t newCap = dir == nullptr ? 1 : dir->capacity;
+            while (newCap <= blockIdx) {
+                newCap <<= 1;
+            }
+
+            Directory* newDir = new Directory(newCap);
+            if (dir != nullptr) {
+                for (size_t i = 0; i < dir->capacity; ++i) {
+                    newDir->blocks[i].store(
+                        dir->blocks[i].load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+                }
+            }
+            newDir->prev = dir;
+            dir_.store(newDir, std::memory_order_release);
+            dir = newDir;
+        }
+
+        Block* block = dir->blocks[blockIdx].load(std::memory_order_relaxed);
+        if (block == nullptr) {
+            block = new Block();
+            dir->blocks[blockIdx].store(block, std::memory_order_release);
+        }
+        return block;
+    }
+
+ private:
+    std::atomic<Directory*> dir_;
+    std::mutex mtx_;
+};
+
 }   // namespace client
 }   // namespace curve
 
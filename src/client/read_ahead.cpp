@@ -0,0 +1,379 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "src/client/read_ahead.h"
+
+namespace curve {
+namespace client {
+
+const uint32_t ReadAhead::kMaxStreamNum;
+const uint32_t ReadAhead::kTriggerCount;
+
+ReadAhead::ReadAhead()
+    : enable_(false),
+      minWindow_(0),
+      maxWindow_(0),
+      maxBufferBytes_(0),
+      bufferBytes_(0),
+      clock_(0),
+      fileMetric_(nullptr) {}
+
+void ReadAhead::Init(const ReadAheadOption_t& opt,
+                     FileMetric* fileMetric,
+                     ReadAheadIssueFunc issueFunc) {
+    fileMetric_ = fileMetric;
+    issueFunc_ = issueFunc;
+    maxBufferBytes_ = opt.maxBufferMB * 1024 * 1024;
+    minWindow_ = static_cast<uint64_t>(opt.minWindowKB) * 1024;
+    // 至少要能同时容纳正在读取和正在预读的两个窗口
+    maxWindow_ = std::min(static_cast<uint64_t>(opt.maxWindowKB) * 1024,
+                          maxBufferBytes_ / 2);
+    enable_ = opt.enable && minWindow_ > 0 && minWindow_ <= maxWindow_;
+
+    LOG_IF(WARNING, opt.enable && !enable_)
+        << "read ahead disabled, min window = " << opt.minWindowKB
+        << "KB, max window = " << opt.maxWindowKB
+        << "KB, max buffer = " << opt.maxBufferMB << "MB";
+}
+
+void ReadAhead::Observe(off_t offset, size_t length, uint64_t fileLength) {
+    if (!enable_ || length == 0) {
+        return;
+    }
+
+    PrefetchContext* prefetch = nullptr;
+    std::list<ReadWaiter> finished;
+    {
+        std::lock_guard<Mutex> lk(mtx_);
+        Stream* stream = FindStream(offset, length);
+        if (stream == nullptr || stream->seqCount < kTriggerCount) {
+            return;
+        }
+
+        prefetch = Prefetch(stream, fileLength);
+        // 预读可能淘汰了等待中的读请求需要的数据
+        CheckWaiters(&finished);
+    }
+    FinishWaiters(&finished);
+
+    // 在锁外下发，预读请求可能在下发过程中直接返回
+    if (prefetch != nullptr) {
+        MetricHelper::IncremReadAheadPrefetchBytes(fileMetric_,
+                                                   prefetch->ctx.length);
+        issueFunc_(&prefetch->ctx);
+    }
+}
+
+ReadAhead::ReadStatus ReadAhead::Read(off_t offset, size_t length,
+                                      char* buf, ReadAheadDone done) {
+    if (!enable_ || length == 0) {
+        return ReadStatus::MISS;
+    }
+
+    std::lock_guard<Mutex> lk(mtx_);
+    ReadStatus status = ReadLocked(offset, length, buf);
+    if (status == ReadStatus::PENDING) {
+        // 不在当前线程等待，预读返回后由回调完成读请求
+        waiters_.push_back({static_cast<uint64_t>(offset), length, buf,
+                            std::move(done), false});
+    }
+    return status;
+}
+
+void ReadAhead::Invalidate(off_t offset, size_t length) {
+    if (!enable_ || length == 0) {
+        return;
+    }
+
+    uint64_t start = offset;
+    uint64_t end = offset + length;
+
+    std::list<ReadWaiter> finished;
+    {
+        std::lock_guard<Mutex> lk(mtx_);
+        auto iter = segments_.upper_bound(start);
+        if (iter != segments_.begin()) {
+            --iter;
+            if (iter->second->offset + iter->second->length <= start) {
+                ++iter;
+            }
+        }
+
+        bool erased = false;
+        while (iter != segments_.end() && iter->first < end) {
+            iter = EraseSegment(iter);
+            erased = true;
+        }
+
+        if (erased) {
+            CheckWaiters(&finished);
+        }
+    }
+    FinishWaiters(&finished);
+}
+
+void ReadAhead::Drop() {
+    if (!enable_) {
+        return;
+    }
+
+    std::list<ReadWaiter> finished;
+    {
+        std::lock_guard<Mutex> lk(mtx_);
+        auto iter = segments_.begin();
+        while (iter != segments_.end()) {
+            iter = EraseSegment(iter);
+        }
+
+        // 丢弃后重新检测顺序读
+        streams_.clear();
+        CheckWaiters(&finished);
+    }
+    FinishWaiters(&finished);
+}
+
+uint64_t ReadAhead::GetBufferBytes() {
+    std::lock_guard<Mutex> lk(mtx_);
+    return bufferBytes_;
+}
+
+void ReadAhead::PrefetchCallback(CurveAioContext* ctx) {
+    PrefetchContext* prefetch = reinterpret_cast<PrefetchContext*>(ctx);
+    ReadAhead* readAhead = prefetch->readAhead;
+    const auto& segment = prefetch->segment;
+
+    std::list<ReadWaiter> finished;
+    {
+        std::lock_guard<Mutex> lk(readAhead->mtx_);
+        // 被失效的预读数据已经从索引中删除，直接丢弃
+        if (segment->state == SegmentState::INFLIGHT) {
+            if (ctx->ret == static_cast<int>(segment->length)) {
+                segment->state = SegmentState::READY;
+            } else {
+                LOG(WARNING) << "prefetch failed, offset = " << segment->offset
+                             << ", length = " << segment->length
+                             << ", ret = " << ctx->ret;
+                readAhead->EraseSegment(
+                    readAhead->segments_.find(segment->offset));
+            }
+        }
+        readAhead->CheckWaiters(&finished);
+    }
+
+    delete prefetch;
+    FinishWaiters(&finished);
+}
+
+ReadAhead::ReadStatus ReadAhead::ReadLocked(uint64_t offset, uint64_t length,
+                                            char* buf) {
+    uint64_t start = offset;
+    uint64_t end = offset + length;
+
+    std::vector<std::shared_ptr<Segment>> covered;
+    bool inflight = false;
+    uint64_t pos = start;
+    while (pos < end) {
+        auto iter = segments_.upper_bound(pos);
+        if (iter == segments_.begin()) {
+            break;
+        }
+        --iter;
+        const auto& segment = iter->second;
+        if (segment->offset + segment->length <= pos) {
+            break;
+        }
+        inflight = inflight || segment->state == SegmentState::INFLIGHT;
+        covered.push_back(segment);
+        pos = segment->offset + segment->length;
+    }
+
+    if (pos < end) {
+        MetricHelper::IncremReadAheadMissCount(fileMetric_);
+        return ReadStatus::MISS;
+    }
+
+    if (inflight) {
+        return ReadStatus::PENDING;
+    }
+
+    for (const auto& segment : covered) {
+        uint64_t copyStart = std::max(start, segment->offset);
+        uint64_t copyEnd = std::min(end, segment->offset + segment->length);
+        memcpy(buf + (copyStart - start),
+               segment->data.get() + (copyStart - segment->offset),
+               copyEnd - copyStart);
+
+        // 顺序读不会再读已经读过的数据，全部读完后立即释放
+        if (copyEnd == segment->offset + segment->length) {
+            EraseSegment(segments_.find(segment->offset));
+        }
+    }
+
+    MetricHelper::IncremReadAheadHitCount(fileMetric_);
+    return ReadStatus::HIT;
+}
+
+void ReadAhead::CheckWaiters(std::list<ReadWaiter>* finished) {
+    auto iter = waiters_.begin();
+    while (iter != waiters_.end()) {
+        ReadStatus status = ReadLocked(iter->offset, iter->length, iter->buf);
+        if (status == ReadStatus::PENDING) {
+            ++iter;
+            continue;
+        }
+        iter->hit = status == ReadStatus::HIT;
+        finished->splice(finished->end(), waiters_, iter++);
+    }
+}
+
+void ReadAhead::FinishWaiters(std::list<ReadWaiter>* finished) {
+    for (auto& waiter : *finished) {
+        waiter.done(waiter.hit);
+    }
+}
+
+ReadAhead::Stream* ReadAhead::FindStream(uint64_t offset, uint64_t length) {
+    ++clock_;
+    for (auto& stream : streams_) {
+        if (stream.nextOffset == offset) {
+            stream.nextOffset = offset + length;
+            stream.lastAccess = clock_;
+            ++stream.seqCount;
+            return &stream;
+        }
+    }
+
+    Stream stream;
+    stream.nextOffset = offset + length;
+    stream.prefetchEnd = offset + length;
+    stream.window = minWindow_;
+    stream.seqCount = 0;
+    stream.lastAccess = clock_;
+
+    if (streams_.size() < kMaxStreamNum) {
+        streams_.push_back(stream);
+    } else {
+        auto oldest = std::min_element(streams_.begin(), streams_.end(),
+            [](const Stream& a, const Stream& b) {
+                return a.lastAccess < b.lastAccess;
+            });
+        *oldest = stream;
+    }
+    return nullptr;
+}
+
+ReadAhead::PrefetchContext* ReadAhead::Prefetch(Stream* stream,
+                                                uint64_t fileLength) {
+    // 读请求超过了预读的位置，从当前位置重新开始预读
+    stream->prefetchEnd = std::max(stream->prefetchEnd, stream->nextOffset);
+
+    // 剩余的预读数据还有半个窗口以上时不发起新的预读
+    if (stream->prefetchEnd - stream->nextOffset >= stream->window / 2) {
+        return nullptr;
+    }
+
+    uint64_t start = stream->prefetchEnd;
+    uint64_t end = std::min(stream->nextOffset + stream->window, fileLength);
+    stream->window = std::min(stream->window * 2, maxWindow_);
+
+    // 跳过已经预读的数据，可能是其他读流发起的
+    auto iter = segments_.upper_bound(start);
+    if (iter != segments_.begin()) {
+        auto prev = std::prev(iter);
+        start = std::max(start, prev->second->offset + prev->second->length);
+    }
+    while (iter != segments_.end() && iter->first <= start) {
+        start = std::max(start, iter->first + iter->second->length);
+        ++iter;
+    }
+    if (iter != segments_.end()) {
+        end = std::min(end, iter->first);
+    }
+
+    if (start >= end || !Reserve(end - start)) {
+        return nullptr;
+    }
+
+    std::shared_ptr<Segment> segment = std::make_shared<Segment>();
+    segment->offset = start;
+    segment->length = end - start;
+    segment->data.reset(new char[segment->length]);
+    segment->state = SegmentState::INFLIGHT;
+    segment->seq = ++clock_;
+    segments_.emplace(start, segment);
+    bufferBytes_ += segment->length;
+    MetricHelper::UpdateReadAheadBytes(fileMetric_, segment->length);
+
+    stream->prefetchEnd = end;
+
+    PrefetchContext* prefetch = new PrefetchContext();
+    prefetch->ctx.offset = segment->offset;
+    prefetch->ctx.length = segment->length;
+    prefetch->ctx.ret = 0;
+    prefetch->ctx.op = LIBCURVE_OP_READ;
+    prefetch->ctx.cb = PrefetchCallback;
+    prefetch->ctx.buf = segment->data.get();
+    prefetch->readAhead = this;
+    prefetch->segment = segment;
+    return prefetch;
+}
+
+bool ReadAhead::Reserve(uint64_t length) {
+    while (bufferBytes_ + length > maxBufferBytes_) {
+        // 正在预读的数据不能淘汰
+        auto victim = segments_.end();
+        for (auto iter = segments_.begin(); iter != segments_.end(); ++iter) {
+            if (iter->second->state == SegmentState::READY &&
+                (victim == segments_.end() ||
+                 iter->second->seq < victim->second->seq)) {
+                victim = iter;
+            }
+        }
+
+        if (victim == segments_.end()) {
+            return false;
+        }
+
+        EraseSegment(victim);
+        MetricHelper::IncremReadAheadEvictCount(fileMetric_);
+    }
+
+    return true;
+}
+
+std::map<uint64_t, std::shared_ptr<ReadAhead::Segment>>::iterator
+ReadAhead::EraseSegment(
+    std::map<uint64_t, std::shared_ptr<Segment>>::iterator iter) {
+    const auto& segment = iter->second;
+    segment->state = SegmentState::INVALID;
+    bufferBytes_ -= segment->length;
+    MetricHelper::UpdateReadAheadBytes(fileMetric_,
+        -static_cast<int64_t>(segment->length));
+    return segments_.erase(iter);
+}
+
+}   // namespace client
+}   // namespace curve
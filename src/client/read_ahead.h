@@ -0,0 +1,252 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_CLIENT_READ_AHEAD_H_
+#define SRC_CLIENT_READ_AHEAD_H_
+
+#include <sys/types.h>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "include/client/libcurve.h"
+#include "src/client/config_info.h"
+#include "src/client/client_metric.h"
+#include "src/common/concurrent/concurrent.h"
+
+namespace curve {
+namespace client {
+
+using curve::common::Mutex;
+
+/**
+ * 下发预读请求的函数，读取[ctx->offset, ctx->offset + ctx->length)到ctx->buf，
+ * 请求返回后调用ctx->cb，ctx->ret为读取的字节数或小于0的错误码
+ */
+using ReadAheadIssueFunc = std::function<void(CurveAioContext* ctx)>;
+
+/**
+ * 等待预读的读请求完成后的回调，参数为是否命中预读数据
+ */
+using ReadAheadDone = std::function<void(bool hit)>;
+
+/**
+ * 文件级别的顺序读预读
+ * 1. 每个文件最多跟踪kMaxStreamNum个读流，读请求的起始位置与某个流上次读的结束位置
+ *    相同时认为是该流上的顺序读，否则替换最久未访问的流
+ * 2. 同一个流上连续kTriggerCount次顺序读后开始预读，已预读但未被读取的数据不足
+ *    半个窗口时发起新的预读，补齐到一个窗口，并将窗口翻倍直到上限
+ * 3. 预读数据的总大小受maxBufferMB限制，超过后淘汰最早预读的数据，
+ *    读请求读过的预读数据立即释放
+ * 4. 读请求被预读数据完全覆盖时直接从预读数据返回，预读请求还未返回时
+ *    不阻塞调用线程，由预读请求返回的回调完成读请求
+ * 5. 写请求会失效覆盖到的预读数据，包括还未返回的预读请求
+ */
+class ReadAhead {
+ public:
+    enum class ReadStatus {
+        HIT,
+        MISS,
+        // 覆盖读范围的预读请求还未返回
+        PENDING,
+    };
+
+    ReadAhead();
+    ~ReadAhead() = default;
+
+    /**
+     * 初始化
+     * @param: opt为预读配置
+     * @param: fileMetric为文件级别metric，可以为空
+     * @param: issueFunc为下发预读请求的函数
+     */
+    void Init(const ReadAheadOption_t& opt,
+              FileMetric* fileMetric,
+              ReadAheadIssueFunc issueFunc);
+
+    bool Enabled() const {
+        return enable_;
+    }
+
+    /**
+     * 记录一次用户读请求，检测到顺序读时发起预读
+     * @param: fileLength为文件大小，预读不会超过文件末尾
+     */
+    void Observe(off_t offset, size_t length, uint64_t fileLength);
+
+    /**
+     * 从预读数据中读取，读范围被预读数据完全覆盖时才命中
+     * 覆盖读范围的预读请求还未返回时返回PENDING，预读返回、失败或被失效后
+     * 再读取并调用done，done在预读回调或失效预读数据的线程中执行
+     * @return: 命中返回HIT，未命中返回MISS，返回PENDING时才会调用done
+     */
+    ReadStatus Read(off_t offset, size_t length, char* buf,
+                    ReadAheadDone done);
+
+    /**
+     * 失效与[offset, offset + length)重叠的预读数据，写请求调用
+     */
+    void Invalidate(off_t offset, size_t length);
+
+    /**
+     * 丢弃所有预读数据，等待中的读请求全部未命中
+     */
+    void Drop();
+
+    /**
+     * 获取当前预读数据占用的内存字节数，测试使用
+     */
+    uint64_t GetBufferBytes();
+
+    // 每个文件最多跟踪的读流个数
+    static const uint32_t kMaxStreamNum = 4;
+
+    // 同一个流上连续多少次顺序读后开始预读
+    static const uint32_t kTriggerCount = 2;
+
+ private:
+    enum class SegmentState {
+        INFLIGHT,
+        READY,
+        // 预读失败或被写请求失效
+        INVALID,
+    };
+
+    // 一次预读请求对应的数据
+    struct Segment {
+        uint64_t offset;
+        uint64_t length;
+        std::unique_ptr<char[]> data;
+        SegmentState state;
+        // 预读请求的序号，淘汰时优先淘汰最早预读的数据
+        uint64_t seq;
+    };
+
+    // 预读请求上下文，ctx必须是第一个成员，回调时据此找到上下文
+    struct PrefetchContext {
+        CurveAioContext ctx;
+        ReadAhead* readAhead;
+        std::shared_ptr<Segment> segment;
+    };
+
+    // 等待预读请求返回的读请求
+    struct ReadWaiter {
+        uint64_t offset;
+        uint64_t length;
+        char* buf;
+        ReadAheadDone done;
+        bool hit;
+    };
+
+    // 一个顺序读流
+    struct Stream {
+        // 下一个顺序读请求的起始位置
+        uint64_t nextOffset;
+        // 已经发起预读的结束位置
+        uint64_t prefetchEnd;
+        // 当前预读窗口大小
+        uint64_t window;
+        // 连续顺序读的次数
+        uint32_t seqCount;
+        // 最近一次访问的时间，用于替换最久未访问的流
+        uint64_t lastAccess;
+    };
+
+    /**
+     * 预读请求返回的回调
+     */
+    static void PrefetchCallback(CurveAioContext* ctx);
+
+    /**
+     * 从预读数据中读取，调用方持有mtx_
+     */
+    ReadStatus ReadLocked(uint64_t offset, uint64_t length, char* buf);
+
+    /**
+     * 重新检查等待中的读请求，预读数据变化后调用，调用方持有mtx_
+     * @param[out]: finished为已经完成的读请求，需要在锁外调用其done
+     */
+    void CheckWaiters(std::list<ReadWaiter>* finished);
+
+    /**
+     * 在锁外通知已经完成的读请求
+     */
+    static void FinishWaiters(std::list<ReadWaiter>* finished);
+
+    /**
+     * 查找offset所在的读流，没有时替换最久未访问的流，调用方持有mtx_
+     * @return: offset是某个流上的顺序读时返回该流，否则返回nullptr
+     */
+    Stream* FindStream(uint64_t offset, uint64_t length);
+
+    /**
+     * 生成一个预读请求，调用方持有mtx_
+     * @return: 需要下发的预读请求，无法预读时返回nullptr
+     */
+    PrefetchContext* Prefetch(Stream* stream, uint64_t fileLength);
+
+    /**
+     * 淘汰最早预读的数据，直到可以再放入length字节，调用方持有mtx_
+     * @return: 空间足够时返回true
+     */
+    bool Reserve(uint64_t length);
+
+    /**
+     * 从索引中删除一段预读数据，调用方持有mtx_
+     */
+    std::map<uint64_t, std::shared_ptr<Segment>>::iterator EraseSegment(
+        std::map<uint64_t, std::shared_ptr<Segment>>::iterator iter);
+
+ private:
+    bool enable_;
+    uint64_t minWindow_;
+    uint64_t maxWindow_;
+    uint64_t maxBufferBytes_;
+
+    // 当前跟踪的读流
+    std::vector<Stream> streams_;
+
+    // 预读数据索引，key为offset，各段数据之间不重叠
+    std::map<uint64_t, std::shared_ptr<Segment>> segments_;
+
+    // 索引中的预读数据字节数
+    uint64_t bufferBytes_;
+
+    // 读流访问时间和预读请求序号的生成器
+    uint64_t clock_;
+
+    // 等待预读请求返回的读请求
+    std::list<ReadWaiter> waiters_;
+
+    // 保护上述状态
+    Mutex mtx_;
+
+    ReadAheadIssueFunc issueFunc_;
+
+    FileMetric* fileMetric_;
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // SRC_CLIENT_READ_AHEAD_H_
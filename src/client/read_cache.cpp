@@ -0,0 +1,189 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "src/client/read_cache.h"
+
+namespace curve {
+namespace client {
+
+ReadCache::ReadCache()
+    : enable_(false),
+      pageSize_(0),
+      maxPageNum_(0),
+      sequence_(0),
+      fileMetric_(nullptr) {}
+
+void ReadCache::Init(const ReadCacheOption_t& opt, FileMetric* fileMetric) {
+    fileMetric_ = fileMetric;
+    pageSize_ = static_cast<uint64_t>(opt.pageSizeKB) * 1024;
+    maxPageNum_ = pageSize_ == 0 ? 0 : opt.capacityMB * 1024 * 1024 / pageSize_;
+    enable_ = opt.enable && maxPageNum_ > 0;
+
+    LOG_IF(WARNING, opt.enable && !enable_)
+        << "read cache disabled, page size = " << opt.pageSizeKB
+        << "KB, capacity = " << opt.capacityMB << "MB";
+}
+
+bool ReadCache::Read(off_t offset, size_t length, char* buf) {
+    if (!enable_ || length == 0) {
+        return false;
+    }
+
+    uint64_t start = offset;
+    uint64_t end = offset + length;
+    uint64_t firstPage = start / pageSize_;
+    uint64_t lastPage = (end - 1) / pageSize_;
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    for (uint64_t index = firstPage; index <= lastPage; ++index) {
+        if (pages_.find(index) == pages_.end()) {
+            MetricHelper::IncremReadCacheMissCount(fileMetric_);
+            return false;
+        }
+    }
+
+    for (uint64_t index = firstPage; index <= lastPage; ++index) {
+        auto iter = pages_[index];
+        uint64_t pageStart = index * pageSize_;
+        uint64_t copyStart = std::max(start, pageStart);
+        uint64_t copyEnd = std::min(end, pageStart + pageSize_);
+        memcpy(buf + (copyStart - start),
+               iter->data.get() + (copyStart - pageStart),
+               copyEnd - copyStart);
+        lru_.splice(lru_.begin(), lru_, iter);
+    }
+
+    MetricHelper::IncremReadCacheHitCount(fileMetric_);
+    return true;
+}
+
+uint64_t ReadCache::GetSequence() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return sequence_;
+}
+
+void ReadCache::Put(off_t offset, size_t length, const char* buf,
+                    uint64_t seq) {
+    if (!enable_) {
+        return;
+    }
+
+    uint64_t start = offset;
+    uint64_t end = offset + length;
+    // 只缓存被完整覆盖的page
+    uint64_t firstPage = (start + pageSize_ - 1) / pageSize_;
+    uint64_t endPage = end / pageSize_;
+    if (firstPage >= endPage) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (seq != sequence_) {
+        return;
+    }
+
+    for (uint64_t index = firstPage; index < endPage; ++index) {
+        const char* src = buf + (index * pageSize_ - start);
+        auto iter = pages_.find(index);
+        if (iter != pages_.end()) {
+            memcpy(iter->second->data.get(), src, pageSize_);
+            lru_.splice(lru_.begin(), lru_, iter->second);
+            continue;
+        }
+
+        if (pages_.size() >= maxPageNum_) {
+            ErasePage(std::prev(lru_.end()));
+            MetricHelper::IncremReadCacheEvictCount(fileMetric_);
+        }
+
+        Page page;
+        page.index = index;
+        page.data.reset(new char[pageSize_]);
+        memcpy(page.data.get(), src, pageSize_);
+        lru_.push_front(std::move(page));
+        pages_.emplace(index, lru_.begin());
+        MetricHelper::UpdateReadCacheBytes(fileMetric_, pageSize_);
+    }
+}
+
+void ReadCache::Invalidate(off_t offset, size_t length) {
+    if (!enable_ || length == 0) {
+        return;
+    }
+
+    uint64_t firstPage = static_cast<uint64_t>(offset) / pageSize_;
+    uint64_t lastPage = (offset + length - 1) / pageSize_;
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    ++sequence_;
+
+    // 失效范围比缓存的page数量大时，直接遍历缓存
+    if (lastPage - firstPage + 1 > pages_.size()) {
+        auto iter = lru_.begin();
+        while (iter != lru_.end()) {
+            if (iter->index >= firstPage && iter->index <= lastPage) {
+                iter = ErasePage(iter);
+            } else {
+                ++iter;
+            }
+        }
+        return;
+    }
+
+    for (uint64_t index = firstPage; index <= lastPage; ++index) {
+        auto iter = pages_.find(index);
+        if (iter != pages_.end()) {
+            ErasePage(iter->second);
+        }
+    }
+}
+
+void ReadCache::Drop() {
+    if (!enable_) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    ++sequence_;
+    MetricHelper::UpdateReadCacheBytes(fileMetric_,
+        -static_cast<int64_t>(pages_.size() * pageSize_));
+    pages_.clear();
+    lru_.clear();
+}
+
+uint64_t ReadCache::GetCachedPageNum() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return pages_.size();
+}
+
+ReadCache::PageList::iterator ReadCache::ErasePage(PageList::iterator iter) {
+    pages_.erase(iter->index);
+    MetricHelper::UpdateReadCacheBytes(fileMetric_,
+                                       -static_cast<int64_t>(pageSize_));
+    return lru_.erase(iter);
+}
+
+}   // namespace client
+}   // namespace curve
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_CLIENT_READ_CACHE_H_
+#define SRC_CLIENT_READ_CACHE_H_
+
+#include <sys/types.h>
+
+#include <list>
+#include <memory>
+#include <mutex>    // NOLINT
+#include <unordered_map>
+
+#include "src/client/config_info.h"
+#include "src/client/client_metric.h"
+
+namespace curve {
+namespace client {
+
+/**
+ * 文件级别的client读缓存，按page粒度缓存读回的数据，按LRU淘汰。
+ * 缓存只做写失效(write-through invalidate)，不缓存写数据:
+ * 1. 写请求下发前和返回后都会失效覆盖到的page
+ * 2. 读请求发起时记录当前的失效序号，读返回时如果期间发生过失效，
+ *    则不填充缓存，避免与并发写交错时把旧数据放入缓存
+ */
+class ReadCache {
+ public:
+    ReadCache();
+    ~ReadCache() = default;
+
+    /**
+     * 初始化
+     * @param: opt为读缓存配置
+     * @param: fileMetric为文件级别metric，可以为空
+     */
+    void Init(const ReadCacheOption_t& opt, FileMetric* fileMetric);
+
+    /**
+     * 读缓存是否开启
+     */
+    bool Enabled() const {
+        return enable_;
+    }
+
+    /**
+     * 从缓存中读取数据，只有[offset, offset + length)覆盖到的page全部命中
+     * 才从缓存返回，部分命中按未命中处理
+     * @param: offset为读偏移
+     * @param: length为读长度
+     * @param: buf为读缓冲区
+     * @return: 全部命中返回true，否则返回false
+     */
+    bool Read(off_t offset, size_t length, char* buf);
+
+    /**
+     * 获取当前的失效序号，读请求发起前调用
+     */
+    uint64_t GetSequence();
+
+    /**
+     * 读请求成功返回后填充缓存，只填充被读请求完整覆盖的page
+     * @param: offset为读偏移
+     * @param: length为读长度
+     * @param: buf为读回的数据
+     * @param: seq为读请求发起时的失效序号，序号变化则放弃填充
+     */
+    void Put(off_t offset, size_t length, const char* buf, uint64_t seq);
+
+    /**
+     * 失效[offset, offset + length)覆盖到的page
+     */
+    void Invalidate(off_t offset, size_t length);
+
+    /**
+     * 清空缓存，lease失效、文件版本变化或上层要求失效缓存时调用
+     */
+    void Drop();
+
+    /**
+     * 获取当前缓存的page数量，测试使用
+     */
+    uint64_t GetCachedPageNum();
+
+ private:
+    struct Page {
+        uint64_t index;
+        std::unique_ptr<char[]> data;
+    };
+
+    using PageList = std::list<Page>;
+
+    // 删除page并更新metric，调用方持有mtx_
+    PageList::iterator ErasePage(PageList::iterator iter);
+
+    // 读缓存是否开启
+    bool enable_;
+
+    // page大小，单位字节
+    uint64_t pageSize_;
+
+    // 最多缓存的page数量
+    uint64_t maxPageNum_;
+
+    // 失效序号，每次失效或清空缓存递增
+    uint64_t sequence_;
+
+    // lru链表，头部为最近访问的page
+    PageList lru_;
+
+    // page index到lru链表节点的映射
+    std::unordered_map<uint64_t, PageList::iterator> pages_;
+
+    // 保护上述缓存结构
+    std::mutex mtx_;
+
+    // 文件级别metric
+    FileMetric* fileMetric_;
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // SRC_CLIENT_READ_CACHE_H_
@@ -20,6 +20,8 @@
  * Author: tongguangxun
  */
 
+#include <cstring>
+
 #include "src/client/request_closure.h"
 #include "src/client/io_tracker.h"
 #include "src/client/request_context.h"
@@ -55,6 +57,7 @@ void RequestClosure::SetFailed(int errorcode) {
 }
 
 void RequestClosure::Run() {
+    MarkHedgeReadDone();
     ReleaseInflightRPCToken();
     if (suspendRPC_) {
         MetricHelper::DecremIOSuspendNum(metric_);
@@ -62,6 +65,33 @@ void RequestClosure::Run() {
     tracker_->HandleResponse(reqCtx_);
 }
 
+void MergedRequestClosure::Run() {
+    MarkHedgeReadDone();
+    ReleaseInflightRPCToken();
+    if (IsSuspendRPC()) {
+        MetricHelper::DecremIOSuspendNum(GetMetric());
+    }
+
+    RequestContext* merged = GetReqCtx();
+    int errcode = GetErrorCode();
+    for (RequestContext* req : merged->subRequests_) {
+        // 被合并的请求按offset顺序依次从合并请求的数据中取走自己的部分
+        if (req->optype_ == OpType::READ && errcode == 0) {
+            req->SetReadData(&merged->readData_);
+        }
+
+        req->trace_.Accumulate(merged->trace_);
+
+        // 被合并的请求没有单独获取inflight token，直接通知tracker
+        req->done_->SetFailed(errcode);
+        req->done_->GetIOTracker()->HandleResponse(req);
+    }
+
+    // 释放合并的请求，当前closure也随之释放
+    merged->UnInit();
+    delete merged;
+}
+
 int RequestClosure::GetErrorCode() {
     return errcode_;
 }
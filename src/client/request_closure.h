@@ -27,12 +27,14 @@
 #include <google/protobuf/stubs/callback.h>
 #include <iostream>
 #include <map>
+#include <memory>
 
 #include "include/curve_compiler_specific.h"
 #include "src/client/inflight_controller.h"
 #include "src/client/client_metric.h"
 #include "src/client/config_info.h"
 #include "src/client/client_common.h"
+#include "src/client/hedge_read.h"
 #include "src/common/concurrent/concurrent.h"
 
 using curve::common::RWLock;
@@ -83,6 +85,13 @@ class RequestClosure : public ::google::protobuf::Closure {
      */
     void SetIOManager(IOManager* ioManager);
 
+    /**
+     * @brief 获取所属的iomanager
+     */
+    IOManager* GetIOManager() {
+       return ioManager_;
+    }
+
     /**
      * 设置当前closure重试次数
      */
@@ -149,6 +158,27 @@ class RequestClosure : public ::google::protobuf::Closure {
        return suspendRPC_;
     }
 
+    /**
+     * 设置对冲读状态，leader读请求重试时沿用
+     */
+    void SetHedgeReadState(const std::shared_ptr<HedgeReadState>& state) {
+       hedgeState_ = state;
+    }
+
+    const std::shared_ptr<HedgeReadState>& GetHedgeReadState() const {
+       return hedgeState_;
+    }
+
+ protected:
+    /**
+     * 请求返回给上层前通知对冲读，之后不再发起对冲读
+     */
+    void MarkHedgeReadDone() {
+       if (hedgeState_ != nullptr) {
+           hedgeState_->MarkDone();
+       }
+    }
+
  private:
     // suspend io标志
     bool suspendRPC_;
@@ -179,6 +209,21 @@ class RequestClosure : public ::google::protobuf::Closure {
 
     // 下一次rpc超时时间
     uint64_t nextTimeoutMS_;
+
+    // 对冲读状态，没有对冲读时为空
+    std::shared_ptr<HedgeReadState> hedgeState_;
+};
+
+/**
+ * 调度时由多个相邻请求合并成的请求的closure，RPC返回后将结果和读到的数据
+ * 分发给被合并的请求，由各请求通知其所属的IOTracker，然后释放合并的请求
+ */
+class MergedRequestClosure : public RequestClosure {
+ public:
+    explicit MergedRequestClosure(RequestContext* reqctx)
+        : RequestClosure(reqctx) {}
+
+    void Run() override;
 };
 }   // namespace client
 }   // namespace curve
@@ -23,6 +23,8 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
+#include <cstring>
+
 #include "src/client/request_context.h"
 #include "src/client/request_closure.h"
 
@@ -32,6 +34,7 @@ namespace client {
 std::atomic<uint64_t> RequestContext::reqCtxID_(1);
 
 RequestContext::RequestContext() {
+    done_ = nullptr;
     readBuffer_ = nullptr;
     writeBuffer_ = nullptr;
     chunkinfodetail_ = nullptr;
@@ -43,12 +46,77 @@ RequestContext::RequestContext() {
     rawlength_  = 0;
 
     appliedindex_ = 0;
+    priority_   = RequestPriority::FOREGROUND;
 }
 bool RequestContext::Init() {
     done_ = new (std::nothrow) RequestClosure(this);
     return done_ != nullptr;
 }
 
+bool RequestContext::InitMerged(
+    const std::vector<RequestContext*>& requests) {
+    const RequestContext* first = requests.front();
+    idinfo_ = first->idinfo_;
+    offset_ = first->offset_;
+    optype_ = first->optype_;
+    seq_ = first->seq_;
+    appliedindex_ = first->appliedindex_;
+    sourceInfo_ = first->sourceInfo_;
+    priority_ = first->priority_;
+    rawlength_ = 0;
+    for (const RequestContext* req : requests) {
+        rawlength_ += req->rawlength_;
+    }
+
+    if (optype_ == OpType::WRITE) {
+        for (const RequestContext* req : requests) {
+            // 数据来自iov的请求已经切好了数据块
+            if (!req->writeData_.empty()) {
+                writeData_.append(req->writeData_);
+                continue;
+            }
+            writeData_.append_user_data(
+                const_cast<char*>(req->writeBuffer_), req->rawlength_,
+                [](void*) {});
+        }
+        writeBuffer_ = first->writeBuffer_;
+    }
+
+    done_ = new (std::nothrow) MergedRequestClosure(this);
+    if (done_ == nullptr) {
+        return false;
+    }
+
+    // 合并请求沿用第一个请求的tracker、metric和iomanager，tracker只用于日志
+    done_->SetIOTracker(first->done_->GetIOTracker());
+    done_->SetFileMetric(first->done_->GetMetric());
+    done_->SetIOManager(first->done_->GetIOManager());
+    subRequests_ = requests;
+
+    // 被合并的请求已经出队，合并请求从当前时间开始计时
+    trace_.enable = first->trace_.enable;
+    trace_.Mark();
+    return true;
+}
+
+void RequestContext::SetReadData(butil::IOBuf* data) {
+    if (readBuffer_ == nullptr) {
+        readData_.clear();
+        data->cutn(&readData_, rawlength_);
+    } else {
+        data->cutn(readBuffer_, rawlength_);
+    }
+}
+
+void RequestContext::SetReadZero() {
+    if (readBuffer_ == nullptr) {
+        readData_.clear();
+        readData_.resize(rawlength_);
+    } else {
+        memset(readBuffer_, 0, rawlength_);
+    }
+}
+
 void RequestContext::UnInit() {
     delete done_;
 }
@@ -23,10 +23,14 @@
 #ifndef SRC_CLIENT_REQUEST_CONTEXT_H_
 #define SRC_CLIENT_REQUEST_CONTEXT_H_
 
+#include <butil/iobuf.h>
+
 #include <atomic>
 #include <string>
+#include <vector>
 
 #include "src/client/client_common.h"
+#include "src/client/io_trace.h"
 #include "src/client/request_closure.h"
 
 namespace curve {
@@ -59,6 +63,27 @@ class RequestContext {
     bool Init();
     void UnInit();
 
+    /**
+     * 将同一个chunk上相邻的多个读写请求合并成一个请求，请求顺序与offset顺序一致
+     * 写请求的数据以多段的形式放在writeData_中，读请求的数据保存在合并请求的
+     * readData_中，返回时再分给各个被合并的请求
+     * @param: requests为被合并的请求
+     * @return: 成功返回true
+     */
+    bool InitMerged(const std::vector<RequestContext*>& requests);
+
+    /**
+     * 保存读请求返回的数据，readBuffer_为空时直接引用data中的数据块，
+     * 否则拷贝到readBuffer_中
+     * @param: data为读到的数据，前rawlength_字节会被移走
+     */
+    void SetReadData(butil::IOBuf* data);
+
+    /**
+     * 读请求的chunk不存在，返回全0
+     */
+    void SetReadZero();
+
     // chunk的ID信息，sender在发送rpc的时候需要附带其ID信息
     ChunkIDInfo         idinfo_;
 
@@ -68,8 +93,10 @@ class RequestContext {
     size_t              rawlength_;
 
     // 当前IO的数据，读请求时数据在readbuffer，写请求在writebuffer
+    // readbuffer为空时读到的数据保存在readData_中，不拷贝rpc返回的数据
     char*               readBuffer_;
     const char*         writeBuffer_;
+    butil::IOBuf        readData_;
 
     // 因为RPC都是异步发送，因此在一个Request结束时，RPC回调调用当前的done
     // 来告知当前的request结束了
@@ -93,6 +120,19 @@ class RequestContext {
     // 当前request context id
     uint64_t            id_;
 
+    // 合并请求中被合并的请求，非合并请求为空
+    std::vector<RequestContext*> subRequests_;
+
+    // 合并写请求的数据，由各个被合并请求的buffer拼接而成，不拷贝数据
+    // 写请求的数据来自iov时writeBuffer_为空，数据同样以多段的形式放在这里
+    butil::IOBuf        writeData_;
+
+    // 请求在client内部各个阶段的耗时，所属IO开启追踪时记录
+    RequestTrace        trace_;
+
+    // 读写请求在调度队列中的优先级，预读等后台读写请求为BACKGROUND
+    RequestPriority     priority_;
+
     // request context id生成器
     static std::atomic<uint64_t> reqCtxID_;
 };
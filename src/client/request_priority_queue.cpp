@@ -0,0 +1,184 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+#include "src/client/request_priority_queue.h"
+
+namespace curve {
+namespace client {
+
+constexpr size_t RequestPriorityQueue::kLaneNum;
+
+RequestPriorityQueue::RequestPriorityQueue()
+    : enablePriority_(false),
+      capacity_(0),
+      fileMetric_(nullptr),
+      stopNum_(0) {}
+
+int RequestPriorityQueue::Init(const RequestScheduleOption_t& opt,
+                               FileMetric* fileMetric) {
+    if (opt.scheduleQueueCapacity == 0) {
+        return -1;
+    }
+
+    enablePriority_ = opt.enablePriority;
+    capacity_ = opt.scheduleQueueCapacity;
+    fileMetric_ = fileMetric;
+
+    // 权重为0的队列会饿死，至少为1
+    uint32_t weights[kLaneNum];
+    weights[static_cast<size_t>(RequestPriority::FOREGROUND)] =
+        opt.foregroundWeight;
+    weights[static_cast<size_t>(RequestPriority::RETRY)] = opt.retryWeight;
+    weights[static_cast<size_t>(RequestPriority::BACKGROUND)] =
+        opt.backgroundWeight;
+    for (size_t i = 0; i < kLaneNum; ++i) {
+        lanes_[i].weight = std::max<uint32_t>(weights[i], 1);
+        lanes_[i].credit = lanes_[i].weight;
+    }
+
+    if (enablePriority_) {
+        LOG(INFO) << "schedule priority enabled, foreground weight = "
+                  << lanes_[0].weight << ", retry weight = "
+                  << lanes_[1].weight << ", background weight = "
+                  << lanes_[2].weight;
+    }
+    return 0;
+}
+
+void RequestPriorityQueue::PutBack(const Item& item,
+                                   RequestPriority priority) {
+    Put(item, priority, false);
+}
+
+void RequestPriorityQueue::PutFront(const Item& item,
+                                    RequestPriority priority) {
+    Put(item, priority, true);
+}
+
+void RequestPriorityQueue::Put(const Item& item, RequestPriority priority,
+                               bool front) {
+    size_t index = Index(priority);
+    {
+        std::unique_lock<std::mutex> lk(mtx_);
+        if (item.IsStop()) {
+            ++stopNum_;
+            notEmpty_.notify_one();
+            return;
+        }
+
+        Lane* lane = &lanes_[index];
+        lane->notFull.wait(lk, [&]() {
+            return lane->items.size() < capacity_;
+        });
+        if (front) {
+            lane->items.push_front(item);
+        } else {
+            lane->items.push_back(item);
+        }
+        notEmpty_.notify_one();
+    }
+
+    MetricHelper::UpdateScheduleQueueDepth(
+        fileMetric_, static_cast<RequestPriority>(index), 1);
+}
+
+RequestPriorityQueue::Item RequestPriorityQueue::TakeFront(
+    RequestPriority* priority) {
+    size_t index = 0;
+    Item item(nullptr);
+    {
+        std::unique_lock<std::mutex> lk(mtx_);
+        notEmpty_.wait(lk, [this]() {
+            return HasRequest() || stopNum_ != 0;
+        });
+
+        // 队列中的请求都取出之后才能取出stop item
+        if (!HasRequest()) {
+            --stopNum_;
+            return Item(nullptr, true);
+        }
+
+        index = SelectLane();
+        Lane* lane = &lanes_[index];
+        item = lane->items.front();
+        lane->items.pop_front();
+        lane->notFull.notify_one();
+    }
+
+    *priority = static_cast<RequestPriority>(index);
+    MetricHelper::UpdateScheduleQueueDepth(fileMetric_, *priority, -1);
+    return item;
+}
+
+size_t RequestPriorityQueue::SelectLane() {
+    // 第一遍找当前一轮还有额度的非空队列，找不到说明非空队列的额度都用完了，
+    // 开始新的一轮再找一遍
+    for (int round = 0; round < 2; ++round) {
+        for (size_t i = 0; i < kLaneNum; ++i) {
+            if (!lanes_[i].items.empty() && lanes_[i].credit > 0) {
+                --lanes_[i].credit;
+                return i;
+            }
+        }
+
+        for (Lane& lane : lanes_) {
+            lane.credit = lane.weight;
+        }
+    }
+
+    // 调用时至少有一个队列不为空，不会走到这里
+    LOG(FATAL) << "no request in schedule queue";
+    return 0;
+}
+
+bool RequestPriorityQueue::HasRequest() const {
+    for (const Lane& lane : lanes_) {
+        if (!lane.items.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RequestPriorityQueue::Empty() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return stopNum_ == 0 && !HasRequest();
+}
+
+size_t RequestPriorityQueue::Size() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    size_t size = 0;
+    for (const Lane& lane : lanes_) {
+        size += lane.items.size();
+    }
+    return size;
+}
+
+size_t RequestPriorityQueue::Size(RequestPriority priority) const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return lanes_[static_cast<size_t>(priority)].items.size();
+}
+
+}   // namespace client
+}   // namespace curve
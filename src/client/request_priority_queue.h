@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_CLIENT_REQUEST_PRIORITY_QUEUE_H_
+#define SRC_CLIENT_REQUEST_PRIORITY_QUEUE_H_
+
+#include <condition_variable>   // NOLINT
+#include <deque>
+#include <mutex>                // NOLINT
+
+#include "src/client/client_common.h"
+#include "src/client/client_metric.h"
+#include "src/client/config_info.h"
+#include "src/common/concurrent/bounded_blocking_queue.h"
+#include "src/common/uncopyable.h"
+
+namespace curve {
+namespace client {
+
+using curve::common::BBQItem;
+using curve::common::Uncopyable;
+
+class RequestContext;
+
+/**
+ * 调度器的请求队列，每个优先级一个有界队列，线程安全
+ * 1. 出队时按权重在非空队列之间轮流，每一轮各队列最多出队权重个请求，
+ *    权重用完或者队列为空时轮到下一个队列，所有非空队列的权重都用完后开始新的一轮，
+ *    这样高权重的用户读写不会被后台请求和重试请求挤占，后台请求也不会饿死
+ * 2. stop item不属于任何优先级，只有所有队列都为空时才会出队，
+ *    保证调度线程退出前队列中的请求都已经处理完
+ * 3. 未开启优先级时所有请求都放在FOREGROUND队列，与单个队列的行为一致
+ */
+class RequestPriorityQueue : public Uncopyable {
+ public:
+    using Item = BBQItem<RequestContext*>;
+
+    RequestPriorityQueue();
+
+    /**
+     * 初始化
+     * @param: opt为调度配置，使用其中的队列深度、是否开启优先级和权重
+     * @param: fileMetric为文件的metric，用于统计各优先级的排队请求数
+     * @return: 成功返回0，否则返回-1
+     */
+    int Init(const RequestScheduleOption_t& opt, FileMetric* fileMetric);
+
+    bool PriorityEnabled() const {
+        return enablePriority_;
+    }
+
+    /**
+     * 请求放入对应优先级队列的尾部或者头部，队列满时阻塞
+     * 未开启优先级时忽略priority；stop item不占用队列深度
+     */
+    void PutBack(const Item& item, RequestPriority priority);
+    void PutFront(const Item& item, RequestPriority priority);
+
+    /**
+     * 按权重选择一个非空的队列取出头部的请求，所有队列都为空时阻塞
+     * @param[out]: priority为取出的请求所在的队列，取出stop item时不修改
+     */
+    Item TakeFront(RequestPriority* priority);
+
+    /**
+     * 指定优先级队列的头部满足pred时将其取出，不阻塞
+     * @param: priority为TakeFront返回的优先级
+     * @param: pred为判断条件
+     * @param[out]: item为取出的请求
+     * @return: 取出请求时返回true
+     */
+    template<typename Pred>
+    bool TakeFrontIf(RequestPriority priority, Pred pred, Item* item) {
+        Lane* lane = &lanes_[Index(priority)];
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            if (lane->items.empty() || !pred(lane->items.front())) {
+                return false;
+            }
+            *item = lane->items.front();
+            lane->items.pop_front();
+            lane->notFull.notify_one();
+        }
+
+        MetricHelper::UpdateScheduleQueueDepth(fileMetric_, priority, -1);
+        return true;
+    }
+
+    /**
+     * 队列中是否有请求或者stop item
+     */
+    bool Empty() const;
+
+    /**
+     * 所有队列中的请求数，不包括stop item
+     */
+    size_t Size() const;
+
+    /**
+     * 指定优先级队列中的请求数
+     */
+    size_t Size(RequestPriority priority) const;
+
+ private:
+    static constexpr size_t kLaneNum =
+        static_cast<size_t>(RequestPriority::PRIORITY_NUM);
+
+    struct Lane {
+        std::deque<Item> items;
+        std::condition_variable notFull;
+        uint32_t weight = 1;
+        // 当前一轮剩余的出队额度
+        uint32_t credit = 0;
+    };
+
+    size_t Index(RequestPriority priority) const {
+        return enablePriority_ ? static_cast<size_t>(priority) : 0;
+    }
+
+    void Put(const Item& item, RequestPriority priority, bool front);
+
+    /**
+     * 是否有排队的请求，需要持有锁
+     */
+    bool HasRequest() const;
+
+    /**
+     * 选择下一个出队的队列，需要持有锁且至少有一个队列不为空
+     */
+    size_t SelectLane();
+
+ private:
+    bool enablePriority_;
+    size_t capacity_;
+    FileMetric* fileMetric_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable notEmpty_;
+    Lane lanes_[kLaneNum];
+    // 调度器退出时放入的stop item数量
+    size_t stopNum_;
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // SRC_CLIENT_REQUEST_PRIORITY_QUEUE_H_
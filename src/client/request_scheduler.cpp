@@ -28,6 +28,7 @@
 #include "src/client/request_context.h"
 #include "src/client/request_closure.h"
 #include "src/client/chunk_closure.h"
+#include "src/client/splitor.h"
 
 namespace curve {
 namespace client {
@@ -42,7 +43,7 @@ int RequestScheduler::Init(const RequestScheduleOption_t& reqSchdulerOpt,
     reqschopt_ = reqSchdulerOpt;
 
     int rc = 0;
-    rc = queue_.Init(reqschopt_.scheduleQueueCapacity);
+    rc = queue_.Init(reqschopt_, fm);
     if (0 != rc) {
         return -1;
     }
@@ -62,7 +63,8 @@ int RequestScheduler::Init(const RequestScheduleOption_t& reqSchdulerOpt,
               << "scheduleQueueCapacity = "
               << reqschopt_.scheduleQueueCapacity
               << ", scheduleThreadpoolSize = "
-              << reqschopt_.scheduleThreadpoolSize;
+              << reqschopt_.scheduleThreadpoolSize
+              << ", enablePriority = " << reqschopt_.enablePriority;
     return 0;
 }
 
@@ -79,7 +81,7 @@ int RequestScheduler::Fini() {
         for (int i = 0; i < threadPool_.NumOfThreads(); ++i) {
             // notify the wait thread
             BBQItem<RequestContext *> stopReq(nullptr, true);
-            queue_.PutBack(stopReq);
+            queue_.PutBack(stopReq, RequestPriority::FOREGROUND);
         }
         threadPool_.Stop();
     }
@@ -91,8 +93,9 @@ int RequestScheduler::ScheduleRequest(const std::list<RequestContext *> requests
     if (running_.load(std::memory_order_acquire)) {
         /* TODO(wudemiao): 后期考虑 qos */
         for (auto it : requests) {
+            it->trace_.Mark();
             BBQItem<RequestContext *> req(it);
-            queue_.PutBack(req);
+            queue_.PutBack(req, GetPriority(it));
         }
         return 0;
     }
@@ -101,8 +104,9 @@ int RequestScheduler::ScheduleRequest(const std::list<RequestContext *> requests
 
 int RequestScheduler::ScheduleRequest(RequestContext *request) {
     if (running_.load(std::memory_order_acquire)) {
+        request->trace_.Mark();
         BBQItem<RequestContext *> req(request);
-        queue_.PutBack(req);
+        queue_.PutBack(req, GetPriority(request));
         return 0;
     }
     return -1;
@@ -110,8 +114,9 @@ int RequestScheduler::ScheduleRequest(RequestContext *request) {
 
 int RequestScheduler::ReSchedule(RequestContext *request) {
     if (running_.load(std::memory_order_acquire)) {
+        request->trace_.Mark();
         BBQItem<RequestContext *> req(request);
-        queue_.PutFront(req);
+        queue_.PutFront(req, RequestPriority::RETRY);
         return 0;
     }
     return -1;
@@ -137,72 +142,20 @@ void RequestScheduler::Process() {
         || !queue_.Empty())  // flush all request in the queue
         && !stop_.load(std::memory_order_acquire)) {
         WaitValidSession();
-        BBQItem<RequestContext *> item = queue_.TakeFront();
+        RequestPriority priority = RequestPriority::FOREGROUND;
+        BBQItem<RequestContext *> item = queue_.TakeFront(&priority);
         if (!item.IsStop()) {
             RequestContext *req = item.Item();
-            brpc::ClosureGuard guard(req->done_);
-            switch (req->optype_) {
-                case OpType::READ:
-                    DVLOG(9) << "Processing read request, buf header: "
-                             << " buf: " << *(unsigned int*)req->readBuffer_;
-                    {
-                        req->done_->GetInflightRPCToken();
-                        client_.ReadChunk(req->idinfo_,
-                                        req->seq_,
-                                        req->offset_,
-                                        req->rawlength_,
-                                        req->appliedindex_,
-                                        req->sourceInfo_,
-                                        guard.release());
-                    }
-                    break;
-                case OpType::WRITE:
-                    DVLOG(9) << "Processing write request, buf header: "
-                             << " buf: " << *(unsigned int*)req->writeBuffer_;
-                    {
-                        req->done_->GetInflightRPCToken();
-                        client_.WriteChunk(req->idinfo_,
-                                        req->seq_,
-                                        req->writeBuffer_,
-                                        req->offset_,
-                                        req->rawlength_,
-                                        req->sourceInfo_,
-                                        guard.release());
-                    }
-                    break;
-                case OpType::READ_SNAP:
-                    client_.ReadChunkSnapshot(req->idinfo_,
-                                        req->seq_,
-                                        req->offset_,
-                                        req->rawlength_,
-                                        guard.release());
-                    break;
-                case OpType::DELETE_SNAP:
-                    client_.DeleteChunkSnapshotOrCorrectSn(req->idinfo_,
-                                        req->correctedSeq_,
-                                        guard.release());
-                    break;
-                case OpType::GET_CHUNK_INFO:
-                    client_.GetChunkInfo(req->idinfo_,
-                                        guard.release());
-                    break;
-                case OpType::CREATE_CLONE:
-                    client_.CreateCloneChunk(req->idinfo_,
-                                        req->location_,
-                                        req->seq_,
-                                        req->correctedSeq_,
-                                        req->chunksize_,
-                                        guard.release());
-                    break;
-                case OpType::RECOVER_CHUNK:
-                    client_.RecoverChunk(req->idinfo_,
-                                         req->offset_, req->rawlength_,
-                                         guard.release());
-                    break;
-                default:
-                    /* TODO(wudemiao) 后期整个链路错误发统一了在处理 */
-                    req->done_->SetFailed(-1);
-                    LOG(ERROR) << "unknown op type: OpType::UNKNOWN";
+            req->trace_.OnDequeue();
+            if (!reqschopt_.enableMerge) {
+                ProcessOne(req);
+                continue;
+            }
+
+            std::vector<RequestContext*> reqs;
+            MergeRequests(req, priority, &reqs);
+            for (auto r : reqs) {
+                ProcessOne(r);
             }
         } else {
             /**
@@ -214,5 +167,148 @@ void RequestScheduler::Process() {
     }
 }
 
+void RequestScheduler::ProcessOne(RequestContext* req) {
+    brpc::ClosureGuard guard(req->done_);
+    switch (req->optype_) {
+        case OpType::READ:
+            DVLOG(9) << "Processing read request, " << *req;
+            {
+                req->done_->GetInflightRPCToken();
+                client_.ReadChunk(req->idinfo_,
+                                req->seq_,
+                                req->offset_,
+                                req->rawlength_,
+                                req->appliedindex_,
+                                req->sourceInfo_,
+                                guard.release());
+            }
+            break;
+        case OpType::WRITE:
+            DVLOG(9) << "Processing write request, " << *req;
+            {
+                req->done_->GetInflightRPCToken();
+                client_.WriteChunk(req->idinfo_,
+                                req->seq_,
+                                req->writeBuffer_,
+                                req->offset_,
+                                req->rawlength_,
+                                req->sourceInfo_,
+                                guard.release());
+            }
+            break;
+        case OpType::DISCARD:
+            {
+                req->done_->GetInflightRPCToken();
+                client_.DiscardChunk(req->idinfo_,
+                                req->seq_,
+                                guard.release());
+            }
+            break;
+        case OpType::READ_SNAP:
+            client_.ReadChunkSnapshot(req->idinfo_,
+                                req->seq_,
+                                req->offset_,
+                                req->rawlength_,
+                                guard.release());
+            break;
+        case OpType::DELETE_SNAP:
+            client_.DeleteChunkSnapshotOrCorrectSn(req->idinfo_,
+                                req->correctedSeq_,
+                                guard.release());
+            break;
+        case OpType::GET_CHUNK_INFO:
+            client_.GetChunkInfo(req->idinfo_,
+                                guard.release());
+            break;
+        case OpType::CREATE_CLONE:
+            client_.CreateCloneChunk(req->idinfo_,
+                                req->location_,
+                                req->seq_,
+                                req->correctedSeq_,
+                                req->chunksize_,
+                                guard.release());
+            break;
+        case OpType::RECOVER_CHUNK:
+            client_.RecoverChunk(req->idinfo_,
+                                 req->offset_, req->rawlength_,
+                                 guard.release());
+            break;
+        default:
+            /* TODO(wudemiao) 后期整个链路错误发统一了在处理 */
+            req->done_->SetFailed(-1);
+            LOG(ERROR) << "unknown op type: OpType::UNKNOWN";
+    }
+}
+
+RequestPriority RequestScheduler::GetPriority(const RequestContext* req) {
+    if (req->optype_ != OpType::READ && req->optype_ != OpType::WRITE) {
+        return RequestPriority::BACKGROUND;
+    }
+    return req->priority_;
+}
+
+void RequestScheduler::MergeRequests(RequestContext* req,
+                                     RequestPriority priority,
+                                     std::vector<RequestContext*>* reqs) {
+    reqs->push_back(req);
+
+    // 重新入队的请求(包括合并后的请求)不再合并
+    if ((req->optype_ != OpType::READ && req->optype_ != OpType::WRITE) ||
+        !req->subRequests_.empty() || req->done_->GetRetriedTimes() > 0) {
+        return;
+    }
+
+    uint64_t mergedLength = req->rawlength_;
+    BBQItem<RequestContext *> next(nullptr);
+    while (queue_.TakeFrontIf(priority,
+        [&](const BBQItem<RequestContext *>& item) {
+            return !item.IsStop() &&
+                   CanMerge(reqs->back(), item.Item(), mergedLength);
+        }, &next)) {
+        next.Item()->trace_.OnDequeue();
+        reqs->push_back(next.Item());
+        mergedLength += next.Item()->rawlength_;
+    }
+
+    if (reqs->size() == 1) {
+        return;
+    }
+
+    RequestContext* merged = new (std::nothrow) RequestContext();
+    if (merged == nullptr || !merged->InitMerged(*reqs)) {
+        LOG(WARNING) << "merge requests failed, send them separately";
+        if (merged != nullptr) {
+            merged->UnInit();
+            delete merged;
+        }
+        return;
+    }
+
+    DVLOG(9) << "merged " << reqs->size() << " requests into " << *merged;
+    reqs->clear();
+    reqs->push_back(merged);
+}
+
+bool RequestScheduler::CanMerge(const RequestContext* prev,
+                                const RequestContext* next,
+                                uint64_t mergedLength) {
+    // 合并后的请求不超过当前的IO拆分大小
+    return next->optype_ == prev->optype_ &&
+           next->subRequests_.empty() &&
+           next->done_->GetRetriedTimes() == 0 &&
+           next->idinfo_.lpid_ == prev->idinfo_.lpid_ &&
+           next->idinfo_.cpid_ == prev->idinfo_.cpid_ &&
+           next->idinfo_.cid_ == prev->idinfo_.cid_ &&
+           next->seq_ == prev->seq_ &&
+           next->appliedindex_ == prev->appliedindex_ &&
+           next->sourceInfo_.cloneFileSource ==
+               prev->sourceInfo_.cloneFileSource &&
+           next->sourceInfo_.cloneFileOffset ==
+               prev->sourceInfo_.cloneFileOffset &&
+           static_cast<uint64_t>(next->offset_) ==
+               prev->offset_ + prev->rawlength_ &&
+           mergedLength + next->rawlength_ <= Splitor::GetSplitSize();
+}
+
 }   // namespace client
 }   // namespace curve
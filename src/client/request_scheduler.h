@@ -24,6 +24,7 @@
 #define SRC_CLIENT_REQUEST_SCHEDULER_H_
 
 #include <list>
+#include <vector>
 
 #include "src/common/uncopyable.h"
 #include "src/client/config_info.h"
@@ -31,20 +32,21 @@
 #include "src/common/concurrent/thread_pool.h"
 #include "src/client/client_common.h"
 #include "src/client/copyset_client.h"
+#include "src/client/request_priority_queue.h"
 #include "include/curve_compiler_specific.h"
 
 namespace curve {
 namespace client {
 
 using curve::common::ThreadPool;
-using curve::common::BoundedBlockingDeque;
 using curve::common::BBQItem;
 using curve::common::Uncopyable;
 
 class RequestContext;
 /**
  * 请求调度器，上层拆分的I/O会交给Scheduler的线程池
- * 分发到具体的ChunkServer，后期QoS也会放在这里处理
+ * 分发到具体的ChunkServer，开启优先级时用户读写、重新入队的请求和后台请求
+ * 分别排队，按权重出队
  */
 class RequestScheduler : public Uncopyable {
  public:
@@ -95,7 +97,7 @@ class RequestScheduler : public Uncopyable {
     virtual int ScheduleRequest(RequestContext *request);
 
     /**
-     * 对于需要重新入队的RPC将其放在头部
+     * 对于需要重新入队的RPC将其放在头部，开启优先级时放入RETRY队列
      */
     virtual int ReSchedule(RequestContext *request);
 
@@ -128,7 +130,7 @@ class RequestScheduler : public Uncopyable {
     /**
      * 测试使用，获取队列
      */
-    BoundedBlockingDeque<BBQItem<RequestContext *>>* GetQueue() {
+    RequestPriorityQueue* GetQueue() {
        return &queue_;
     }
 
@@ -138,6 +140,34 @@ class RequestScheduler : public Uncopyable {
      */
     void Process();
 
+    /**
+     * 将一个request下发到chunkserver
+     */
+    void ProcessOne(RequestContext* req);
+
+    /**
+     * 新请求的优先级，快照克隆和discard等非读写请求为BACKGROUND
+     */
+    static RequestPriority GetPriority(const RequestContext* req);
+
+    /**
+     * 从队列头部取出与req相邻的同一个chunk上的读写请求，与req合并成一个请求
+     * @param: req为已经从队列中取出的请求
+     * @param: priority为req所在的队列，只合并同一个队列中的请求
+     * @param[out]: reqs为需要下发的请求，合并成功时只有合并后的请求，
+     *              合并失败时为各个原始请求
+     */
+    void MergeRequests(RequestContext* req, RequestPriority priority,
+                       std::vector<RequestContext*>* reqs);
+
+    /**
+     * 判断next能否合并到prev之后
+     * @param: mergedLength为当前已经合并的长度
+     */
+    static bool CanMerge(const RequestContext* prev,
+                         const RequestContext* next,
+                         uint64_t mergedLength);
+
     inline void WaitValidSession() {
       // lease续约失败的时候需要阻塞IO直到续约成功
       if (blockIO_.load(std::memory_order_acquire) && blockingQueue_) {
@@ -151,8 +181,8 @@ class RequestScheduler : public Uncopyable {
  private:
     // 线程池和queue容量的配置参数
     RequestScheduleOption_t reqschopt_;
-    // 存放 request 的队列
-    BoundedBlockingDeque<BBQItem<RequestContext *>> queue_;
+    // 存放 request 的队列，每个优先级一个队列
+    RequestPriorityQueue queue_;
     // 处理 request 的线程池
     ThreadPool threadPool_;
     // Scheduler 运行标记，只有运行了，才接收 request
@@ -24,11 +24,17 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <cerrno>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "proto/chunk.pb.h"
 #include "src/common/timeutility.h"
 #include "src/client/request_closure.h"
+#include "src/client/request_context.h"
 #include "src/common/location_operator.h"
+#include "src/common/crc32.h"
 
 using curve::common::TimeUtility;
 
@@ -38,11 +44,28 @@ namespace client {
 static void EmptyDeleter(void* ptr) {}
 
 int RequestSender::Init(const IOSenderOption_t& ioSenderOpt) {
-    if (0 != channel_.Init(serverEndPoint_, NULL)) {
-        LOG(ERROR) << "failed to init channel to server, id: " << chunkServerId_
-                   << ", "<< serverEndPoint_.ip << ":" << serverEndPoint_.port;
-        return -1;
+    uint32_t channelNum = std::max(ioSenderOpt.channelOpt.channelNum, 1u);
+
+    std::vector<std::unique_ptr<brpc::Channel>> channels;
+    channels.reserve(channelNum);
+    for (uint32_t i = 0; i < channelNum; ++i) {
+        // connection group不同的channel不共用链接
+        brpc::ChannelOptions options;
+        options.connection_type = ioSenderOpt.channelOpt.connectionType;
+        options.connection_group = std::to_string(i);
+
+        std::unique_ptr<brpc::Channel> channel(new brpc::Channel());
+        if (0 != channel->Init(serverEndPoint_, &options)) {
+            LOG(ERROR) << "failed to init channel to server, id: "
+                       << chunkServerId_ << ", " << serverEndPoint_.ip << ":"
+                       << serverEndPoint_.port << ", connection type: "
+                       << ioSenderOpt.channelOpt.connectionType;
+            return -1;
+        }
+        channels.emplace_back(std::move(channel));
     }
+
+    channels_.swap(channels);
     iosenderopt_ = ioSenderOpt;
     ClientClosure::SetFailureRequestOption(iosenderopt_.failRequestOpt);
 
@@ -61,6 +84,7 @@ int RequestSender::ReadChunk(ChunkIDInfo idinfo,
     RequestClosure* rc = static_cast<RequestClosure*>(done->GetClosure());
     MetricHelper::IncremRPCRPSCount(rc->GetMetric(), OpType::READ);
     rc->SetStartTime(TimeUtility::GetTimeofDayUs());
+    rc->GetReqCtx()->trace_.OnRpcSend();
 
     brpc::Controller *cntl = new brpc::Controller();
     cntl->set_timeout_ms(
@@ -88,12 +112,53 @@ int RequestSender::ReadChunk(ChunkIDInfo idinfo,
     if (iosenderopt_.chunkserverEnableAppliedIndexRead && appliedindex > 0) {
         request.set_appliedindex(appliedindex);
     }
-    ChunkService_Stub stub(&channel_);
+
+    if (iosenderopt_.crcOpt.Enabled(idinfo.lpid_)) {
+        request.set_needcrc(true);
+    }
+
+    // 对冲读已经成功时不再发送，由closure直接用对冲读的数据返回
+    const auto& hedgeState = done->GetHedgeReadState();
+    if (hedgeState != nullptr &&
+        !hedgeState->RegisterPrimaryCall(cntl->call_id())) {
+        cntl->SetFailed(ECANCELED, "hedge read already succeeded");
+        return 0;
+    }
+
+    ChunkService_Stub stub(GetChannel(idinfo.cid_));
     stub.ReadChunk(cntl, &request, response, doneGuard.release());
 
     return 0;
 }
 
+int RequestSender::HedgeReadChunk(const HedgeReadState& state,
+                                  HedgeReadClosure *done) {
+    brpc::ClosureGuard doneGuard(done);
+
+    done->SetStartTime(TimeUtility::GetTimeofDayUs());
+    brpc::Controller *cntl = done->GetCntl();
+    cntl->set_timeout_ms(iosenderopt_.failRequestOpt.chunkserverRPCTimeoutMS);
+
+    const ChunkIDInfo& idinfo = state.GetChunkIDInfo();
+    ChunkRequest request;
+    request.set_optype(curve::chunkserver::CHUNK_OP_TYPE::CHUNK_OP_READ);
+    request.set_logicpoolid(idinfo.lpid_);
+    request.set_copysetid(idinfo.cpid_);
+    request.set_chunkid(idinfo.cid_);
+    request.set_offset(state.GetOffset());
+    request.set_size(state.GetLength());
+    request.set_appliedindex(state.GetAppliedIndex());
+    request.set_allowfollowerread(true);
+    if (iosenderopt_.crcOpt.Enabled(idinfo.lpid_)) {
+        request.set_needcrc(true);
+    }
+
+    ChunkService_Stub stub(GetChannel(idinfo.cid_));
+    stub.ReadChunk(cntl, &request, done->GetResponse(), doneGuard.release());
+
+    return 0;
+}
+
 int RequestSender::WriteChunk(ChunkIDInfo idinfo,
                               uint64_t sn,
                               const char *buf,
@@ -106,9 +171,10 @@ int RequestSender::WriteChunk(ChunkIDInfo idinfo,
     RequestClosure* rc = static_cast<RequestClosure*>(done->GetClosure());
     MetricHelper::IncremRPCRPSCount(rc->GetMetric(), OpType::WRITE);
     rc->SetStartTime(TimeUtility::GetTimeofDayUs());
+    rc->GetReqCtx()->trace_.OnRpcSend();
 
-    DVLOG(9) << "Sending request, buf header: "
-             << " buf: " << *(unsigned int *)buf;
+    // iov和合并写请求的buf为空，数据在请求上下文的writeData_中
+    DVLOG(9) << "Sending write request, " << *rc->GetReqCtx();
     brpc::Controller *cntl = new brpc::Controller();
     cntl->set_timeout_ms(
     std::max(rc->GetNextTimeoutMS(),
@@ -133,9 +199,24 @@ int RequestSender::WriteChunk(ChunkIDInfo idinfo,
         request.set_clonefileoffset(sourceInfo.cloneFileOffset);
     }
 
-    cntl->request_attachment().append_user_data(
-        const_cast<char*>(buf), length, EmptyDeleter);
-    ChunkService_Stub stub(&channel_);
+    // 合并的写请求由多段数据组成，直接以多段的形式放入attachment
+    RequestContext* reqCtx = rc->GetReqCtx();
+    if (reqCtx != nullptr && !reqCtx->writeData_.empty()) {
+        cntl->request_attachment().append(reqCtx->writeData_);
+    } else {
+        cntl->request_attachment().append_user_data(
+            const_cast<char*>(buf), length, EmptyDeleter);
+    }
+
+    // 携带attachment中数据的CRC，由chunkserver在写入raft日志之前校验
+    if (iosenderopt_.crcOpt.Enabled(idinfo.lpid_)) {
+        uint64_t start = TimeUtility::GetTimeofDayUs();
+        request.set_crc32(
+            curve::common::CRC32(cntl->request_attachment()));
+        MetricHelper::CrcComputeRecord(
+            rc->GetMetric(), TimeUtility::GetTimeofDayUs() - start);
+    }
+    ChunkService_Stub stub(GetChannel(idinfo.cid_));
     stub.WriteChunk(cntl, &request, response, doneGuard.release());
 
     return 0;
@@ -165,7 +246,7 @@ int RequestSender::ReadChunkSnapshot(ChunkIDInfo idinfo,
     request.set_sn(sn);
     request.set_offset(offset);
     request.set_size(length);
-    ChunkService_Stub stub(&channel_);
+    ChunkService_Stub stub(GetChannel(idinfo.cid_));
     stub.ReadChunkSnapshot(cntl, &request, response, doneGuard.release());
 
     return 0;
@@ -191,7 +272,7 @@ int RequestSender::DeleteChunkSnapshotOrCorrectSn(ChunkIDInfo idinfo,
     request.set_copysetid(idinfo.cpid_);
     request.set_chunkid(idinfo.cid_);
     request.set_correctedsn(correctedSn);
-    ChunkService_Stub stub(&channel_);
+    ChunkService_Stub stub(GetChannel(idinfo.cid_));
     stub.DeleteChunkSnapshotOrCorrectSn(cntl,
                                         &request,
                                         response,
@@ -199,6 +280,31 @@ int RequestSender::DeleteChunkSnapshotOrCorrectSn(ChunkIDInfo idinfo,
     return 0;
 }
 
+int RequestSender::DiscardChunk(ChunkIDInfo idinfo,
+                                uint64_t sn,
+                                ClientClosure *done) {
+    brpc::ClosureGuard doneGuard(done);
+
+    RequestClosure* rc = static_cast<RequestClosure*>(done->GetClosure());
+    brpc::Controller *cntl = new brpc::Controller();
+    cntl->set_timeout_ms(
+    std::max(rc->GetNextTimeoutMS(),
+        iosenderopt_.failRequestOpt.chunkserverRPCTimeoutMS));
+    done->SetCntl(cntl);
+    ChunkResponse *response = new ChunkResponse();
+    done->SetResponse(response);
+
+    ChunkRequest request;
+    request.set_optype(curve::chunkserver::CHUNK_OP_TYPE::CHUNK_OP_DISCARD);
+    request.set_logicpoolid(idinfo.lpid_);
+    request.set_copysetid(idinfo.cpid_);
+    request.set_chunkid(idinfo.cid_);
+    request.set_sn(sn);
+    ChunkService_Stub stub(GetChannel(idinfo.cid_));
+    stub.DiscardChunk(cntl, &request, response, doneGuard.release());
+    return 0;
+}
+
 int RequestSender::GetChunkInfo(ChunkIDInfo idinfo,
                                 ClientClosure *done) {
     brpc::ClosureGuard doneGuard(done);
@@ -216,7 +322,7 @@ int RequestSender::GetChunkInfo(ChunkIDInfo idinfo,
     request.set_logicpoolid(idinfo.lpid_);
     request.set_copysetid(idinfo.cpid_);
     request.set_chunkid(idinfo.cid_);
-    ChunkService_Stub stub(&channel_);
+    ChunkService_Stub stub(GetChannel(idinfo.cid_));
     stub.GetChunkInfo(cntl, &request, response, doneGuard.release());
     return 0;
 }
@@ -249,7 +355,7 @@ int RequestSender::CreateCloneChunk(ChunkIDInfo idinfo,
     request.set_correctedsn(correntSn);
     request.set_size(chunkSize);
 
-    ChunkService_Stub stub(&channel_);
+    ChunkService_Stub stub(GetChannel(idinfo.cid_));
     stub.CreateCloneChunk(cntl, &request, response, doneGuard.release());
 }
 
@@ -276,7 +382,7 @@ int RequestSender::RecoverChunk(const ChunkIDInfo& idinfo,
     request.set_offset(offset);
     request.set_size(len);
 
-    ChunkService_Stub stub(&channel_);
+    ChunkService_Stub stub(GetChannel(idinfo.cid_));
     stub.RecoverChunk(cntl, &request, response, doneGuard.release());
 }
 
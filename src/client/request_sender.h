@@ -26,7 +26,9 @@
 #include <brpc/channel.h>
 #include <butil/endpoint.h>
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "src/client/client_config.h"
 #include "src/client/client_common.h"
@@ -45,8 +47,9 @@ using curve::chunkserver::ChunkService_Stub;
 using ::google::protobuf::Closure;
 
 /**
- * 一个RequestSender负责管理一个ChunkServer的所有
- * connection，目前一个ChunkServer仅有一个connection
+ * 一个RequestSender负责管理一个ChunkServer的所有connection，
+ * 每个ChunkServer建立channelNum个channel，请求按chunk id分散到各个channel，
+ * 同一个chunk的请求总是经过同一个channel
  */
 class RequestSender {
  public:
@@ -54,7 +57,7 @@ class RequestSender {
                   butil::EndPoint serverEndPoint)
         : chunkServerId_(chunkServerId),
           serverEndPoint_(serverEndPoint),
-          channel_() {}
+          channels_() {}
     virtual ~RequestSender() {}
 
     int Init(const IOSenderOption_t& ioSenderOpt);
@@ -77,6 +80,15 @@ class RequestSender {
                   const RequestSourceInfo& sourceInfo,
                   ClientClosure *done);
 
+    /**
+     * 对冲读，请求信息从对冲读状态中获取，允许follower在applied index
+     * 满足要求时直接读
+     * @param state:对冲读状态
+     * @param done:对冲读的closure
+     */
+    int HedgeReadChunk(const HedgeReadState& state,
+                       HedgeReadClosure *done);
+
     /**
    * 写Chunk
    * @param idinfo为chunk相关的id信息
@@ -120,6 +132,16 @@ class RequestSender {
                             uint64_t correctedSn,
                             ClientClosure *done);
 
+    /**
+     * discard整个chunk，chunk被快照或克隆使用时chunkserver保留该chunk
+     * @param idinfo为chunk相关的id信息
+     * @param sn:文件版本号
+     * @param done:上一层异步回调的closure
+     */
+    int DiscardChunk(ChunkIDInfo idinfo,
+                     uint64_t sn,
+                     ClientClosure *done);
+
     /**
      * 获取chunk文件的信息
      * @param idinfo为chunk相关的id信息
@@ -175,7 +197,30 @@ class RequestSender {
                     butil::EndPoint serverEndPoint);
 
     bool IsSocketHealth() {
-       return channel_.CheckHealth() == 0;
+        for (auto& channel : channels_) {
+            if (channel->CheckHealth() != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t GetChannelNum() const {
+        return channels_.size();
+    }
+
+    ChunkServerID GetChunkServerID() const {
+       return chunkServerId_;
+    }
+
+    const butil::EndPoint& GetChunkServerEndPoint() const {
+       return serverEndPoint_;
+    }
+
+ private:
+    // 同一个chunk的请求总是选择同一个channel
+    brpc::Channel* GetChannel(ChunkID cid) {
+        return channels_[cid % channels_.size()].get();
     }
 
  private:
@@ -185,7 +230,8 @@ class RequestSender {
     ChunkServerID chunkServerId_;
     // ChunkServer 的地址
     butil::EndPoint serverEndPoint_;
-    brpc::Channel channel_; /* TODO(wudemiao): 后期会维护多个 channel */
+    // 与ChunkServer之间的channel，每个channel使用不同的connection group
+    std::vector<std::unique_ptr<brpc::Channel>> channels_;
 };
 
 }   // namespace client
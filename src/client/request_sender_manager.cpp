@@ -22,6 +22,8 @@
 
 #include "src/client/request_sender_manager.h"
 
+#include <glog/logging.h>
+
 #include <utility>
 
 #include "src/client/request_sender.h"
@@ -33,42 +35,69 @@ RequestSenderManager::SenderPtr RequestSenderManager::GetOrCreateSender(
                                             const ChunkServerID &leaderId,
                                             const butil::EndPoint &leaderAddr,
                                             IOSenderOption_t senderopt) {
-    std::shared_ptr<RequestSender> senderPtr = nullptr;
+    SenderPtr senderPtr = GetSender(leaderId);
+    if (nullptr != senderPtr) {
+        return senderPtr;
+    }
 
     std::lock_guard<std::mutex> guard(lock_);
-    auto leaderIter = senderPool_.find(leaderId);
-    if (senderPool_.end() != leaderIter) {
-        return leaderIter->second;
-    } else {
-        // 不存在则创建
-        senderPtr = std::make_shared<RequestSender>(leaderId, leaderAddr);
-        CHECK(nullptr != senderPtr) << "new RequestSender failed";
-
-        int rc = senderPtr->Init(senderopt);
-        if (0 != rc) {
-            return nullptr;
-        }
-
-        senderPool_.insert(std::pair<ChunkServerID, SenderPtr>(leaderId,
-                                                               senderPtr));
+    // 加锁期间可能已经被其他线程创建
+    senderPtr = GetSender(leaderId);
+    if (nullptr != senderPtr) {
+        return senderPtr;
     }
+
+    // 不存在则创建
+    senderPtr = std::make_shared<RequestSender>(leaderId, leaderAddr);
+    CHECK(nullptr != senderPtr) << "new RequestSender failed";
+
+    int rc = senderPtr->Init(senderopt);
+    if (0 != rc) {
+        return nullptr;
+    }
+
+    senderPool_.Modify(AddSender, leaderId, senderPtr);
     return senderPtr;
 }
 
 void RequestSenderManager::ResetSenderIfNotHealth(const ChunkServerID& csId) {
     std::lock_guard<std::mutex> guard(lock_);
-    auto iter = senderPool_.find(csId);
+    SenderPtr senderPtr = GetSender(csId);
 
-    if (iter == senderPool_.end()) {
+    if (nullptr == senderPtr) {
         return;
     }
 
     // 检查是否健康
-    if (iter->second->IsSocketHealth()) {
+    if (senderPtr->IsSocketHealth()) {
         return;
     }
 
-    senderPool_.erase(iter);
+    senderPool_.Modify(RemoveSender, csId);
+}
+
+RequestSenderManager::SenderPtr RequestSenderManager::GetSender(
+    const ChunkServerID& csId) {
+    butil::DoublyBufferedData<SenderMap>::ScopedPtr ptr;
+    if (0 != senderPool_.Read(&ptr)) {
+        LOG(ERROR) << "read sender pool failed";
+        return nullptr;
+    }
+
+    auto iter = ptr->find(csId);
+    return iter == ptr->end() ? nullptr : iter->second;
+}
+
+size_t RequestSenderManager::AddSender(SenderMap& senders,
+                                       const ChunkServerID& csId,
+                                       const SenderPtr& sender) {
+    senders[csId] = sender;
+    return 1;
+}
+
+size_t RequestSenderManager::RemoveSender(SenderMap& senders,
+                                          const ChunkServerID& csId) {
+    return senders.erase(csId);
 }
 
 }   // namespace client
@@ -23,6 +23,8 @@
 #ifndef SRC_CLIENT_REQUEST_SENDER_MANAGER_H_
 #define SRC_CLIENT_REQUEST_SENDER_MANAGER_H_
 
+#include <butil/containers/doubly_buffered_data.h>
+
 #include <mutex>    //NOLINT
 #include <unordered_map>
 #include <memory>
@@ -40,6 +42,8 @@ class RequestSender;
 /**
  * 所有Chunk Server的request sender管理者，
  * 可以理解为Chunk Server的链接管理者
+ * sender只在第一次访问chunkserver或者链接异常时才会创建和删除，
+ * 用DoublyBufferedData保存，查找时不用竞争全局锁
  */
 class RequestSenderManager : public Uncopyable {
  public:
@@ -64,10 +68,25 @@ class RequestSenderManager : public Uncopyable {
     void ResetSenderIfNotHealth(const ChunkServerID& csId);
 
  private:
-    // 互斥锁，保护senderPool_
+    using SenderMap = std::unordered_map<ChunkServerID, SenderPtr>;
+
+    /**
+     * 查找csId对应的sender，不存在返回nullptr
+     */
+    SenderPtr GetSender(const ChunkServerID& csId);
+
+    static size_t AddSender(SenderMap& senders,  // NOLINT
+                            const ChunkServerID& csId,
+                            const SenderPtr& sender);
+
+    static size_t RemoveSender(SenderMap& senders,  // NOLINT
+                               const ChunkServerID& csId);
+
+ private:
+    // 互斥锁，串行化sender的创建和删除，查找时不需要加锁
     mutable std::mutex lock_;
     // 请求发送链接的map，以ChunkServer ID为key
-    std::unordered_map<ChunkServerID, SenderPtr> senderPool_;
+    butil::DoublyBufferedData<SenderMap> senderPool_;
 };
 
 }   // namespace client
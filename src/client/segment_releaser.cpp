@@ -0,0 +1,205 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <glog/logging.h>
+
+#include "src/client/segment_releaser.h"
+
+namespace curve {
+namespace client {
+
+void SegmentReleaser::Init(SegmentReleaseFunc releaseFunc,
+                           SegmentReleaseExecutor executor) {
+    releaseFunc_ = releaseFunc;
+    executor_ = executor;
+}
+
+bool SegmentReleaser::BeginWrite(uint64_t offset, uint64_t length,
+                                 uint64_t segmentSize,
+                                 const std::function<void()>& resume) {
+    std::vector<uint64_t> segoffs =
+        TouchedSegments(offset, length, segmentSize);
+
+    std::lock_guard<Mutex> lk(mtx_);
+    for (auto segoff : segoffs) {
+        auto iter = segments_.find(segoff);
+        if (iter != segments_.end() && iter->second.releasing) {
+            iter->second.waiters.push_back(resume);
+            return false;
+        }
+    }
+
+    for (auto segoff : segoffs) {
+        SegmentState& state = segments_[segoff];
+        ++state.writes;
+        if (state.discards > 0) {
+            state.written = true;
+        }
+    }
+    return true;
+}
+
+void SegmentReleaser::EndWrite(uint64_t offset, uint64_t length,
+                               uint64_t segmentSize) {
+    std::vector<uint64_t> segoffs =
+        TouchedSegments(offset, length, segmentSize);
+
+    std::lock_guard<Mutex> lk(mtx_);
+    for (auto segoff : segoffs) {
+        auto iter = segments_.find(segoff);
+        if (iter == segments_.end() || iter->second.writes == 0) {
+            continue;
+        }
+        --iter->second.writes;
+        TryErase(segoff);
+    }
+}
+
+void SegmentReleaser::BeginDiscard(uint64_t offset, uint64_t length,
+                                   uint64_t segmentSize) {
+    std::vector<uint64_t> segoffs =
+        CoveredSegments(offset, length, segmentSize);
+
+    std::lock_guard<Mutex> lk(mtx_);
+    for (auto segoff : segoffs) {
+        SegmentState& state = segments_[segoff];
+        // 正在进行的写请求可能在chunk被删除之后才写到chunkserver
+        if (state.discards == 0) {
+            state.written = state.writes > 0;
+        } else {
+            state.written = state.written || state.writes > 0;
+        }
+        ++state.discards;
+    }
+}
+
+void SegmentReleaser::EndDiscard(uint64_t offset, uint64_t length,
+                                 uint64_t segmentSize, bool release) {
+    std::vector<uint64_t> segoffs =
+        CoveredSegments(offset, length, segmentSize);
+    if (segoffs.empty()) {
+        return;
+    }
+
+    if (release) {
+        executor_([this, segoffs]() { Release(segoffs); });
+        return;
+    }
+
+    std::lock_guard<Mutex> lk(mtx_);
+    for (auto segoff : segoffs) {
+        auto iter = segments_.find(segoff);
+        if (iter == segments_.end() || iter->second.discards == 0) {
+            continue;
+        }
+        --iter->second.discards;
+        TryErase(segoff);
+    }
+}
+
+size_t SegmentReleaser::GetSegmentNum() {
+    std::lock_guard<Mutex> lk(mtx_);
+    return segments_.size();
+}
+
+void SegmentReleaser::Release(const std::vector<uint64_t>& segoffs) {
+    for (auto segoff : segoffs) {
+        bool release = false;
+        {
+            std::lock_guard<Mutex> lk(mtx_);
+            SegmentState& state = segments_[segoff];
+            release = !state.written && state.writes == 0 && !state.releasing;
+            if (release) {
+                state.releasing = true;
+            }
+        }
+
+        if (release) {
+            releaseFunc_(segoff);
+        } else {
+            DVLOG(6) << "segment written during discard, skip release, "
+                     << "segment offset = " << segoff;
+        }
+
+        std::vector<std::function<void()>> waiters;
+        {
+            std::lock_guard<Mutex> lk(mtx_);
+            SegmentState& state = segments_[segoff];
+            if (release) {
+                state.releasing = false;
+                waiters.swap(state.waiters);
+            }
+            if (state.discards > 0) {
+                --state.discards;
+            }
+            TryErase(segoff);
+        }
+
+        // 挂起的写请求在后台重新拆分
+        for (const auto& waiter : waiters) {
+            executor_(waiter);
+        }
+    }
+}
+
+void SegmentReleaser::TryErase(uint64_t segoff) {
+    auto iter = segments_.find(segoff);
+    if (iter == segments_.end()) {
+        return;
+    }
+
+    SegmentState& state = iter->second;
+    if (state.discards == 0) {
+        state.written = false;
+    }
+    if (state.discards == 0 && state.writes == 0 && !state.releasing) {
+        segments_.erase(iter);
+    }
+}
+
+std::vector<uint64_t> SegmentReleaser::CoveredSegments(uint64_t offset,
+                                                       uint64_t length,
+                                                       uint64_t segmentSize) {
+    std::vector<uint64_t> segoffs;
+    uint64_t end = offset + length;
+    uint64_t segoff = (offset + segmentSize - 1) / segmentSize * segmentSize;
+    for (; segoff + segmentSize <= end; segoff += segmentSize) {
+        segoffs.push_back(segoff);
+    }
+    return segoffs;
+}
+
+std::vector<uint64_t> SegmentReleaser::TouchedSegments(uint64_t offset,
+                                                       uint64_t length,
+                                                       uint64_t segmentSize) {
+    std::vector<uint64_t> segoffs;
+    if (length == 0) {
+        return segoffs;
+    }
+    uint64_t end = offset + length;
+    for (uint64_t segoff = offset / segmentSize * segmentSize; segoff < end;
+         segoff += segmentSize) {
+        segoffs.push_back(segoff);
+    }
+    return segoffs;
+}
+
+}   // namespace client
+}   // namespace curve
@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_CLIENT_SEGMENT_RELEASER_H_
+#define SRC_CLIENT_SEGMENT_RELEASER_H_
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "src/common/concurrent/concurrent.h"
+
+namespace curve {
+namespace client {
+
+using curve::common::Mutex;
+
+/**
+ * 释放一个segment，segoff为segment在文件中的偏移
+ */
+using SegmentReleaseFunc = std::function<void(uint64_t segoff)>;
+
+/**
+ * 在后台执行释放任务的函数
+ */
+using SegmentReleaseExecutor =
+    std::function<void(const std::function<void()>& task)>;
+
+/**
+ * 在后台释放被discard完全覆盖的segment，并与同一segment上的写请求互斥
+ * 1. discard下发前登记被其完全覆盖的segment，返回后由后台线程释放，
+ *    释放的RPC不在IO返回的回调中执行
+ * 2. discard期间有写请求写过的segment不再释放，写请求可能已经重新创建了
+ *    被删除的chunk，释放segment后这些chunk会成为孤儿chunk
+ * 3. 有写请求正在进行的segment不释放，segment正在释放时新的写请求
+ *    挂起，释放完成后在后台重新拆分，从mds重新分配segment
+ */
+class SegmentReleaser {
+ public:
+    SegmentReleaser() = default;
+
+    /**
+     * 初始化
+     * @param: releaseFunc为释放segment的函数
+     * @param: executor为在后台执行释放任务的函数
+     */
+    void Init(SegmentReleaseFunc releaseFunc,
+              SegmentReleaseExecutor executor);
+
+    /**
+     * 写请求拆分前调用，不阻塞调用线程
+     * @param: resume为写到的segment正在释放时，释放完成后在后台重新执行的任务
+     * @return: 登记成功返回true，segment正在释放时挂起resume并返回false
+     */
+    bool BeginWrite(uint64_t offset, uint64_t length, uint64_t segmentSize,
+                    const std::function<void()>& resume);
+
+    /**
+     * 写请求返回后调用
+     */
+    void EndWrite(uint64_t offset, uint64_t length, uint64_t segmentSize);
+
+    /**
+     * discard下发前调用，登记被discard完全覆盖的segment
+     */
+    void BeginDiscard(uint64_t offset, uint64_t length, uint64_t segmentSize);
+
+    /**
+     * discard返回后调用
+     * @param: release为true时在后台释放登记的segment，否则只取消登记
+     */
+    void EndDiscard(uint64_t offset, uint64_t length, uint64_t segmentSize,
+                    bool release);
+
+    /**
+     * 获取当前登记的segment数量，测试使用
+     */
+    size_t GetSegmentNum();
+
+ private:
+    struct SegmentState {
+        // 正在进行的discard数量
+        uint32_t discards;
+        // 正在进行的写请求数量
+        uint32_t writes;
+        // discard期间是否有写请求写过该segment
+        bool written;
+        // 是否正在释放
+        bool releasing;
+        // 等待释放完成的写请求
+        std::vector<std::function<void()>> waiters;
+    };
+
+    /**
+     * 在后台线程中释放segment
+     */
+    void Release(const std::vector<uint64_t>& segoffs);
+
+    /**
+     * segment上没有进行中的请求时删除其状态，调用方持有mtx_
+     */
+    void TryErase(uint64_t segoff);
+
+    /**
+     * 获取[offset, offset + length)完全覆盖的segment
+     */
+    static std::vector<uint64_t> CoveredSegments(uint64_t offset,
+                                                 uint64_t length,
+                                                 uint64_t segmentSize);
+
+    /**
+     * 获取与[offset, offset + length)重叠的segment
+     */
+    static std::vector<uint64_t> TouchedSegments(uint64_t offset,
+                                                 uint64_t length,
+                                                 uint64_t segmentSize);
+
+ private:
+    SegmentReleaseFunc releaseFunc_;
+    SegmentReleaseExecutor executor_;
+
+    // 保护segments_
+    Mutex mtx_;
+
+    // 有进行中的discard或写请求的segment，key为segment在文件中的偏移
+    std::unordered_map<uint64_t, SegmentState> segments_;
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // SRC_CLIENT_SEGMENT_RELEASER_H_
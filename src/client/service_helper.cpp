@@ -79,6 +79,31 @@ void ServiceHelper::ProtoFileInfo2Local(const curve::mds::FileInfo* finfo,
     if (finfo->has_clonelength()) {
         fi->cloneLength = finfo->clonelength();
     }
+    if (finfo->has_throttleparams()) {
+        fi->hasThrottleParams = true;
+        fi->throttleParams = FileThrottleParams_t();
+        for (const auto& param : finfo->throttleparams().throttleparams()) {
+            ThrottleParams_t* target = nullptr;
+            switch (param.type()) {
+                case curve::mds::ThrottleType::READ_IOPS:
+                    target = &fi->throttleParams.readIOPS;
+                    break;
+                case curve::mds::ThrottleType::WRITE_IOPS:
+                    target = &fi->throttleParams.writeIOPS;
+                    break;
+                case curve::mds::ThrottleType::READ_BPS:
+                    target = &fi->throttleParams.readBPS;
+                    break;
+                case curve::mds::ThrottleType::WRITE_BPS:
+                    target = &fi->throttleParams.writeBPS;
+                    break;
+            }
+            if (target != nullptr) {
+                target->limit = param.limit();
+                target->burst = param.burst();
+            }
+        }
+    }
 }
 
 class GetLeaderProxy : public std::enable_shared_from_this<GetLeaderProxy> {
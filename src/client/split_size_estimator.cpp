@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+#include "src/client/split_size_estimator.h"
+
+namespace curve {
+namespace client {
+
+const uint32_t SplitSizeEstimator::kUpdateInterval;
+const uint32_t SplitSizeEstimator::kOverheadRatio;
+
+namespace {
+// 拆分大小的对齐粒度
+const uint64_t kSplitAlignment = 4096;
+// 每次计算后旧样本的权重衰减系数
+const double kDecayFactor = 0.5;
+// 请求大小的标准差小于均值的该比例时认为无法拟合
+const double kMinSizeDeviation = 0.1;
+}   // namespace
+
+SplitSizeEstimator::SplitSizeEstimator()
+    : adaptive_(false),
+      minSize_(0),
+      maxSize_(0),
+      splitSize_(0),
+      sumW_(0),
+      sumX_(0),
+      sumY_(0),
+      sumXX_(0),
+      sumXY_(0),
+      pending_(0) {}
+
+void SplitSizeEstimator::Init(const IOSplitOPtion_t& opt) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    uint64_t initSize = opt.fileIOSplitMaxSizeKB * 1024;
+    minSize_ = std::max(opt.adaptiveSplitMinSizeKB * 1024, kSplitAlignment);
+    maxSize_ = opt.adaptiveSplitMaxSizeKB * 1024;
+    bool adaptive = opt.enableAdaptiveSplit && minSize_ <= maxSize_;
+    if (adaptive) {
+        initSize = std::min(std::max(initSize, minSize_), maxSize_);
+    }
+    splitSize_.store(initSize, std::memory_order_relaxed);
+
+    sumW_ = sumX_ = sumY_ = sumXX_ = sumXY_ = 0;
+    pending_ = 0;
+    adaptive_.store(adaptive, std::memory_order_relaxed);
+
+    LOG_IF(WARNING, opt.enableAdaptiveSplit && !adaptive)
+        << "adaptive split disabled, min size = "
+        << opt.adaptiveSplitMinSizeKB << "KB, max size = "
+        << opt.adaptiveSplitMaxSizeKB << "KB";
+}
+
+void SplitSizeEstimator::Record(uint64_t length, uint64_t latencyUs) {
+    if (!adaptive_.load(std::memory_order_relaxed) || length == 0) {
+        return;
+    }
+
+    // 样本足够多，丢弃部分样本不影响结果，不让RPC回调等锁
+    std::unique_lock<std::mutex> lk(mtx_, std::try_to_lock);
+    if (!lk.owns_lock()) {
+        return;
+    }
+
+    double x = length;
+    double y = latencyUs;
+    sumW_ += 1;
+    sumX_ += x;
+    sumY_ += y;
+    sumXX_ += x * x;
+    sumXY_ += x * y;
+
+    if (++pending_ >= kUpdateInterval) {
+        Update();
+        pending_ = 0;
+    }
+}
+
+void SplitSizeEstimator::Update() {
+    double meanX = sumX_ / sumW_;
+    double meanY = sumY_ / sumW_;
+    double varX = sumXX_ / sumW_ - meanX * meanX;
+    double covXY = sumXY_ / sumW_ - meanX * meanY;
+
+    sumW_ *= kDecayFactor;
+    sumX_ *= kDecayFactor;
+    sumY_ *= kDecayFactor;
+    sumXX_ *= kDecayFactor;
+    sumXY_ *= kDecayFactor;
+
+    double minDeviation = kMinSizeDeviation * meanX;
+    if (varX < minDeviation * minDeviation) {
+        return;
+    }
+
+    // slope为每字节的传输时间，intercept为单个RPC的固定开销
+    double slope = covXY / varX;
+    double intercept = meanY - slope * meanX;
+
+    uint64_t size;
+    if (slope <= 0) {
+        // latency与请求大小无关，带宽不是瓶颈
+        size = maxSize_;
+    } else if (intercept <= 0) {
+        // 固定开销可以忽略
+        size = minSize_;
+    } else {
+        double target = kOverheadRatio * intercept / slope;
+        size = target >= maxSize_ ? maxSize_ : static_cast<uint64_t>(target);
+        size = size / kSplitAlignment * kSplitAlignment;
+        size = std::min(std::max(size, minSize_), maxSize_);
+    }
+
+    uint64_t old = splitSize_.exchange(size, std::memory_order_relaxed);
+    LOG_IF(INFO, old != size)
+        << "split size changed from " << old << " to " << size
+        << ", rpc overhead = " << intercept << "us, bandwidth = "
+        << (slope > 0 ? 1.0 / slope : 0) << "B/us";
+}
+
+}   // namespace client
+}   // namespace curve
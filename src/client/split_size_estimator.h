@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_CLIENT_SPLIT_SIZE_ESTIMATOR_H_
+#define SRC_CLIENT_SPLIT_SIZE_ESTIMATOR_H_
+
+#include <atomic>
+#include <mutex>    // NOLINT
+
+#include "src/client/config_info.h"
+
+namespace curve {
+namespace client {
+
+/**
+ * 根据chunkserver读写RPC的latency自适应地选择IO拆分大小
+ * 1. 将RPC的latency建模为 latency = 固定开销 + 请求大小 / 带宽，
+ *    用指数衰减加权的最小二乘拟合出固定开销和带宽
+ * 2. 拆分大小取使数据传输时间为固定开销kOverheadRatio倍的请求大小，
+ *    即单个RPC的固定开销占比不超过1 / (kOverheadRatio + 1)
+ * 3. 拆分大小按4KB对齐，并限制在[adaptiveSplitMinSizeKB, adaptiveSplitMaxSizeKB]
+ * 4. 样本中请求大小差异太小时无法拟合，保持当前的拆分大小
+ */
+class SplitSizeEstimator {
+ public:
+    SplitSizeEstimator();
+
+    /**
+     * 初始化，未开启自适应拆分时拆分大小固定为fileIOSplitMaxSizeKB，
+     * 开启时以fileIOSplitMaxSizeKB作为初始值
+     * 初始化会清空已经收集的样本，进程内共享的实例只应初始化一次
+     */
+    void Init(const IOSplitOPtion_t& opt);
+
+    /**
+     * 获取当前的拆分大小，单位为字节
+     */
+    uint64_t GetSplitSize() const {
+        return splitSize_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * 记录一次成功的读写RPC，锁被占用时直接丢弃该样本
+     * @param: length为请求大小
+     * @param: latencyUs为RPC的latency
+     */
+    void Record(uint64_t length, uint64_t latencyUs);
+
+    // 每收集多少个样本重新计算一次拆分大小
+    static const uint32_t kUpdateInterval = 256;
+
+    // 数据传输时间与固定开销的目标比例
+    static const uint32_t kOverheadRatio = 4;
+
+ private:
+    /**
+     * 根据当前样本重新计算拆分大小，调用方持有mtx_
+     */
+    void Update();
+
+ private:
+    // Record在IO返回路径上无锁读取
+    std::atomic<bool> adaptive_;
+    uint64_t minSize_;
+    uint64_t maxSize_;
+
+    std::atomic<uint64_t> splitSize_;
+
+    // 保护下面的样本统计量
+    std::mutex mtx_;
+
+    // 按指数衰减加权的样本统计量，x为请求大小，y为latency
+    double sumW_;
+    double sumX_;
+    double sumY_;
+    double sumXX_;
+    double sumXY_;
+
+    // 上次计算之后新收集的样本数
+    uint32_t pending_;
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // SRC_CLIENT_SPLIT_SIZE_ESTIMATOR_H_
@@ -23,6 +23,7 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <algorithm>
+#include <mutex>    // NOLINT
 #include <vector>
 #include <string>
 #include "src/client/splitor.h"
@@ -31,12 +32,22 @@
 #include "src/client/request_closure.h"
 #include "src/client/metacache_struct.h"
 #include "src/common/location_operator.h"
+#include "src/common/timeutility.h"
+
+using curve::common::TimeUtility;
 
 namespace curve {
 namespace client {
 IOSplitOPtion_t Splitor::iosplitopt_;
+SplitSizeEstimator Splitor::estimator_;
 void Splitor::Init(IOSplitOPtion_t ioSplitOpt) {
     iosplitopt_ = ioSplitOpt;
+    // 每次打开文件都会调用，拆分大小在进程内所有文件间共享，只初始化一次，
+    // 避免清空其他文件已经收集的样本
+    static std::once_flag estimatorInitFlag;
+    std::call_once(estimatorInitFlag, [&ioSplitOpt]() {
+        estimator_.Init(ioSplitOpt);
+    });
     LOG(INFO) << "io splitor init success!";
 }
 int Splitor::IO2ChunkRequests(IOTracker* iotracker,
@@ -47,11 +58,17 @@ int Splitor::IO2ChunkRequests(IOTracker* iotracker,
                               size_t length,
                               MDSClient* mdsclient,
                               const FInfo_t* fi) {
-    if (targetlist == nullptr|| data == nullptr || mdsclient == nullptr ||
+    if (targetlist == nullptr || mdsclient == nullptr ||
         mc == nullptr || iotracker == nullptr || fi == nullptr) {
         return -1;
     }
 
+    // 读请求的数据以IOBuf返回时没有用户buffer，写请求的数据可能来自iov
+    if (data == nullptr && iotracker->Optype() != OpType::READ &&
+        iotracker->WriteIOBuf() == nullptr) {
+        return -1;
+    }
+
     uint64_t chunksize = fi->chunksize;
 
     uint64_t startchunkindex = offset / chunksize;
@@ -77,7 +94,8 @@ int Splitor::IO2ChunkRequests(IOTracker* iotracker,
                  << ", chunkindex = " << startchunkindex
                  << ", endchunkindex = " << endchunkindex;
 
-        if (!AssignInternal(iotracker, mc, targetlist, data + dataoff,
+        const char* buf = data == nullptr ? nullptr : data + dataoff;
+        if (!AssignInternal(iotracker, mc, targetlist, buf,
                             off, len, mdsclient, fi, startchunkindex)) {
             LOG(ERROR)  << "request split failed"
                         << ", off = " << off
@@ -100,6 +118,94 @@ int Splitor::IO2ChunkRequests(IOTracker* iotracker,
     return 0;
 }
 
+int Splitor::IO2DiscardRequests(IOTracker* iotracker,
+                                MetaCache* mc,
+                                std::list<RequestContext*>* targetlist,
+                                off_t offset,
+                                size_t length,
+                                MDSClient* mdsclient,
+                                const FInfo_t* fi,
+                                DiscardRecorder* recorder,
+                                uint32_t* keepChunkNum) {
+    if (targetlist == nullptr || mdsclient == nullptr || mc == nullptr ||
+        iotracker == nullptr || fi == nullptr || keepChunkNum == nullptr) {
+        return -1;
+    }
+
+    const FInfo* fileInfo = mc->GetFileInfo();
+    uint64_t chunksize = fi->chunksize;
+    uint64_t endoff = offset + length;
+    uint64_t pos = offset;
+
+    while (pos < endoff) {
+        ChunkIndex chunkidx = pos / chunksize;
+        uint64_t chunkstart = static_cast<uint64_t>(chunkidx) * chunksize;
+        uint64_t off = pos - chunkstart;
+        uint64_t len = std::min(endoff, chunkstart + chunksize) - pos;
+        pos += len;
+
+        ChunkIDInfo_t chinfo;
+        if (mc->GetChunkInfoByIndex(chunkidx, &chinfo) != MetaCacheErrorType::OK) {   // NOLINT
+            LIBCURVE_ERROR re = LoadSegmentInfo(false, chunkidx, mc,
+                                                mdsclient, fi);
+            if (re == LIBCURVE_ERROR::NOT_ALLOCATE) {
+                // segment还未分配，没有需要删除的chunk，
+                // 直接跳到下一个segment，避免逐个chunk向mds查询
+                uint64_t segmentsize = fi->segmentsize;
+                pos = std::min(endoff,
+                               (chunkstart / segmentsize + 1) * segmentsize);
+                continue;
+            }
+            if (re != LIBCURVE_ERROR::OK ||
+                mc->GetChunkInfoByIndex(chunkidx, &chinfo) !=
+                    MetaCacheErrorType::OK) {
+                LOG(ERROR) << "can not find the chunk index info!"
+                           << ", chunk index = " << chunkidx;
+                return -1;
+            }
+        }
+
+        // 克隆文件中还未从源文件恢复的chunk不删除，否则读请求会重新读到源文件的数据
+        if (!fileInfo->cloneSource.empty() &&
+            chunkstart < fileInfo->cloneLength) {
+            ++(*keepChunkNum);
+            continue;
+        }
+
+        if (len < chunksize) {
+            // 只覆盖了chunk部分区间，等整个chunk都被discard后再删除
+            if (recorder == nullptr ||
+                !recorder->Record(chunkidx, off, len, chunksize)) {
+                continue;
+            }
+        } else if (recorder != nullptr) {
+            recorder->Clear(chunkidx);
+        }
+
+        RequestContext* newreqNode = GetInitedRequestContext();
+        if (newreqNode == nullptr) {
+            return -1;
+        }
+        newreqNode->seq_          = fi->seqnum;
+        newreqNode->offset_       = 0;
+        newreqNode->rawlength_    = chunksize;
+        newreqNode->optype_       = OpType::DISCARD;
+        newreqNode->idinfo_       = chinfo;
+        newreqNode->appliedindex_ = mc->GetAppliedIndex(chinfo.lpid_,
+                                                        chinfo.cpid_);
+        newreqNode->done_->SetIOTracker(iotracker);
+        targetlist->push_back(newreqNode);
+
+        DVLOG(9) << "discard request split"
+                 << ", chunkindex = " << chunkidx
+                 << ", seqnum = " << fi->seqnum
+                 << ", chunkid = " << chinfo.cid_
+                 << ", copysetid = " << chinfo.cpid_
+                 << ", logicpoolid = " << chinfo.lpid_;
+    }
+    return 0;
+}
+
 // this offset is begin by chunk
 int Splitor::SingleChunkIO2ChunkRequests(IOTracker* iotracker,
                                         MetaCache* mc,
@@ -109,12 +215,13 @@ int Splitor::SingleChunkIO2ChunkRequests(IOTracker* iotracker,
                                         off_t offset,
                                         uint64_t length,
                                         uint64_t seq) {
-    if (targetlist == nullptr || mc == nullptr ||
-        iotracker == nullptr   || data == nullptr) {
+    if (targetlist == nullptr || mc == nullptr || iotracker == nullptr ||
+        (data == nullptr && iotracker->Optype() != OpType::READ &&
+         iotracker->WriteIOBuf() == nullptr)) {
             return -1;
     }
 
-    auto max_split_size_bytes = 1024 * iosplitopt_.fileIOSplitMaxSizeKB;
+    auto max_split_size_bytes = GetSplitSize();
 
     uint64_t len = 0;
     uint64_t off = 0;
@@ -131,8 +238,9 @@ int Splitor::SingleChunkIO2ChunkRequests(IOTracker* iotracker,
 
         newreqNode->seq_         = seq;
         if (iotracker->Optype() == OpType::WRITE) {
-            newreqNode->writeBuffer_ = data + off;
-        } else {
+            AssignWriteData(iotracker, data == nullptr ? nullptr : data + off,
+                            len, newreqNode);
+        } else if (data != nullptr) {
             newreqNode->readBuffer_  = const_cast<char*>(data + off);
         }
         // newreqNode->data_        = data + off;
@@ -166,58 +274,18 @@ bool Splitor::AssignInternal(IOTracker* iotracker,
                             MDSClient* mdsclient,
                             const FInfo_t* fileinfo,
                             ChunkIndex chunkidx) {
-    auto max_split_size_bytes = 1024 * iosplitopt_.fileIOSplitMaxSizeKB;
+    auto max_split_size_bytes = GetSplitSize();
 
     ChunkIDInfo_t chinfo;
-    SegmentInfo segInfo;
-    LogicalPoolCopysetIDInfo_t lpcsIDInfo;
     MetaCacheErrorType chunkidxexist = mc->GetChunkInfoByIndex(chunkidx, &chinfo);          // NOLINT
 
     if (chunkidxexist == MetaCacheErrorType::CHUNKINFO_NOT_FOUND) {
-        LIBCURVE_ERROR re = mdsclient->GetOrAllocateSegment(true,
-                                        (off_t)chunkidx * fileinfo->chunksize,
-                                        fileinfo,
-                                        &segInfo);
-        if (re == LIBCURVE_ERROR::FAILED || re == LIBCURVE_ERROR::AUTHFAIL) {
-            LOG(ERROR) << "GetOrAllocateSegment failed! "
-                       << "offset = " << chunkidx * fileinfo->chunksize;
+        uint64_t startUs = TimeUtility::GetTimeofDayUs();
+        LIBCURVE_ERROR ret = LoadSegmentInfo(true, chunkidx, mc, mdsclient,
+                                             fileinfo);
+        iotracker->RecordMetadataTime(TimeUtility::GetTimeofDayUs() - startUs);
+        if (ret != LIBCURVE_ERROR::OK) {
             return false;
-        } else {
-            int count = 0;
-            for (auto chunkidinfo : segInfo.chunkvec) {
-                uint64_t index = (segInfo.startoffset +
-                         count * fileinfo->chunksize) / fileinfo->chunksize;
-                mc->UpdateChunkInfoByIndex(index, chunkidinfo);
-                ++count;
-            }
-
-            std::vector<CopysetInfo_t> cpinfoVec;
-            re = mdsclient->GetServerList(segInfo.lpcpIDInfo.lpid,
-                            segInfo.lpcpIDInfo.cpidVec, &cpinfoVec);
-            for (auto cpinfo : cpinfoVec) {
-                for (auto peerinfo : cpinfo.csinfos_) {
-                    mc->AddCopysetIDInfo(peerinfo.chunkserverid_,
-                        CopysetIDInfo(segInfo.lpcpIDInfo.lpid, cpinfo.cpid_));
-                }
-            }
-
-            if (re == LIBCURVE_ERROR::FAILED) {
-                std::string cpidstr;
-                for (auto id : segInfo.lpcpIDInfo.cpidVec) {
-                    cpidstr.append(std::to_string(id))
-                        .append(",");
-                }
-
-                LOG(ERROR) << "GetServerList failed! "
-                           << "logicpool id = " << segInfo.lpcpIDInfo.lpid
-                           << ", copyset list = " << cpidstr.c_str();
-                return false;
-            } else {
-                for (auto cpinfo : cpinfoVec) {
-                    mc->UpdateCopysetInfo(segInfo.lpcpIDInfo.lpid,
-                    cpinfo.cpid_, cpinfo);
-                }
-            }
         }
 
         chunkidxexist = mc->GetChunkInfoByIndex(chunkidx, &chinfo);
@@ -244,7 +312,7 @@ bool Splitor::AssignInternal(IOTracker* iotracker,
             }
             newreqNode->seq_          = fileinfo->seqnum;
             if (iotracker->Optype() == OpType::WRITE) {
-                newreqNode->writeBuffer_ = buf;
+                AssignWriteData(iotracker, buf, len, newreqNode);
             } else {
                 newreqNode->readBuffer_  = const_cast<char*>(buf);
             }
@@ -267,6 +335,79 @@ bool Splitor::AssignInternal(IOTracker* iotracker,
     return false;
 }
 
+void Splitor::AssignWriteData(IOTracker* iotracker,
+                              const char* buf,
+                              size_t len,
+                              RequestContext* req) {
+    if (buf != nullptr) {
+        req->writeBuffer_ = buf;
+        return;
+    }
+
+    // 请求按offset顺序拆分，依次从头部切出各个请求的数据，只引用用户buffer
+    butil::IOBuf* data = iotracker->WriteIOBuf();
+    if (data != nullptr) {
+        data->cutn(&req->writeData_, len);
+    }
+}
+
+LIBCURVE_ERROR Splitor::LoadSegmentInfo(bool allocate,
+                                        ChunkIndex chunkidx,
+                                        MetaCache* mc,
+                                        MDSClient* mdsclient,
+                                        const FInfo_t* fileinfo) {
+    SegmentInfo segInfo;
+    LIBCURVE_ERROR re = mdsclient->GetOrAllocateSegment(allocate,
+                                    (off_t)chunkidx * fileinfo->chunksize,
+                                    fileinfo,
+                                    &segInfo);
+    if (re == LIBCURVE_ERROR::NOT_ALLOCATE) {
+        return re;
+    }
+    if (re == LIBCURVE_ERROR::FAILED || re == LIBCURVE_ERROR::AUTHFAIL) {
+        LOG(ERROR) << "GetOrAllocateSegment failed! "
+                   << "offset = " << chunkidx * fileinfo->chunksize;
+        return re;
+    }
+
+    int count = 0;
+    for (auto chunkidinfo : segInfo.chunkvec) {
+        uint64_t index = (segInfo.startoffset +
+                 count * fileinfo->chunksize) / fileinfo->chunksize;
+        mc->UpdateChunkInfoByIndex(index, chunkidinfo);
+        ++count;
+    }
+
+    std::vector<CopysetInfo_t> cpinfoVec;
+    re = mdsclient->GetServerList(segInfo.lpcpIDInfo.lpid,
+                    segInfo.lpcpIDInfo.cpidVec, &cpinfoVec);
+    for (auto cpinfo : cpinfoVec) {
+        for (auto peerinfo : cpinfo.csinfos_) {
+            mc->AddCopysetIDInfo(peerinfo.chunkserverid_,
+                CopysetIDInfo(segInfo.lpcpIDInfo.lpid, cpinfo.cpid_));
+        }
+    }
+
+    if (re == LIBCURVE_ERROR::FAILED) {
+        std::string cpidstr;
+        for (auto id : segInfo.lpcpIDInfo.cpidVec) {
+            cpidstr.append(std::to_string(id))
+                .append(",");
+        }
+
+        LOG(ERROR) << "GetServerList failed! "
+                   << "logicpool id = " << segInfo.lpcpIDInfo.lpid
+                   << ", copyset list = " << cpidstr.c_str();
+        return re;
+    }
+
+    for (auto cpinfo : cpinfoVec) {
+        mc->UpdateCopysetInfo(segInfo.lpcpIDInfo.lpid,
+        cpinfo.cpid_, cpinfo);
+    }
+    return LIBCURVE_ERROR::OK;
+}
+
 RequestContext* Splitor::GetInitedRequestContext() {
     RequestContext* ctx = new (std::nothrow) RequestContext();
     if (ctx && ctx->Init()) {
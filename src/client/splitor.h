@@ -31,6 +31,8 @@
 #include "src/client/request_context.h"
 #include "src/client/client_common.h"
 #include "src/client/client_config.h"
+#include "src/client/split_size_estimator.h"
+#include "src/client/discard_recorder.h"
 
 namespace curve {
 namespace client {
@@ -38,6 +40,22 @@ namespace client {
 class Splitor {
  public:
     static void Init(IOSplitOPtion_t ioSplitOpt);
+
+    /**
+     * 获取当前的IO拆分大小，未开启自适应拆分时为fileIOSplitMaxSizeKB
+     */
+    static uint64_t GetSplitSize() {
+        return estimator_.GetSplitSize();
+    }
+
+    /**
+     * 记录一次成功的读写RPC，用于自适应调整拆分大小
+     * @param: length为请求大小
+     * @param: latencyUs为RPC的latency
+     */
+    static void RecordRPC(uint64_t length, uint64_t latencyUs) {
+        estimator_.Record(length, latencyUs);
+    }
     /**
      * 用户IO拆分成Chunk级别的IO
      * @param: iotracker大IO上下文信息
@@ -57,6 +75,29 @@ class Splitor {
                            size_t length,
                            MDSClient* mdsclient,
                            const FInfo_t* fi);
+    /**
+     * 用户discard请求拆分成整个chunk的discard请求
+     * 只覆盖chunk部分区间的discard交给recorder记录，chunk的全部区间都被discard后
+     * 才下发该chunk的discard请求，segment未分配的chunk直接跳过
+     * @param: iotracker大IO上下文信息
+     * @param: mc是io拆分过程中需要使用的缓存信息
+     * @param: targetlist拆分之后的chunk级别请求存储列表
+     * @param: offset用户discard的起始偏移
+     * @param: length用户discard的长度
+     * @param: mdsclient在查找metacahe失败时，通过mdsclient查找信息
+     * @param: fi存储当前IO的一些基本信息，比如chunksize等
+     * @param: recorder记录部分discard的区间，为空时只删除被完全覆盖的chunk
+     * @param[out]: keepChunkNum为因克隆未完成而保留的chunk数量
+     */
+    static int IO2DiscardRequests(IOTracker* iotracker,
+                           MetaCache* mc,
+                           std::list<RequestContext*>* targetlist,
+                           off_t offset,
+                           size_t length,
+                           MDSClient* mdsclient,
+                           const FInfo_t* fi,
+                           DiscardRecorder* recorder,
+                           uint32_t* keepChunkNum);
     /**
      * 对单ChunkIO进行细粒度拆分
      * @param: iotracker大IO上下文信息
@@ -111,11 +152,41 @@ class Splitor {
                            const FInfo_t* fi,
                            ChunkIndex chunkidx);
 
+    /**
+     * 设置写请求的数据，buf为空时从iotracker中来自iov的数据头部切出len字节
+     * @param: iotracker大IO上下文信息
+     * @param: buf是请求在用户连续buffer中的数据
+     * @param: len是请求的长度
+     * @param: req是待设置的请求
+     */
+    static void AssignWriteData(IOTracker* iotracker,
+                                const char* buf,
+                                size_t len,
+                                RequestContext* req);
+
+    /**
+     * 从mds获取chunk所在segment的信息，并更新到metacache
+     * @param: allocate为true的时候segment不存在就分配
+     * @param: chunkidx是chunk在vdisk中的索引值
+     * @param: mc是需要更新的缓存信息
+     * @param: mdsclient用于与mds通信
+     * @param: fileinfo是当前文件的基本信息
+     * @return: 成功返回OK，segment未分配且allocate为false时返回NOT_ALLOCATE
+     */
+    static LIBCURVE_ERROR LoadSegmentInfo(bool allocate,
+                           ChunkIndex chunkidx,
+                           MetaCache* mc,
+                           MDSClient* mdsclient,
+                           const FInfo_t* fileinfo);
+
     static RequestContext* GetInitedRequestContext();
 
  private:
     // IO拆分模块所使用的配置信息
     static IOSplitOPtion_t iosplitopt_;
+
+    // 根据RPC的latency和带宽计算拆分大小
+    static SplitSizeEstimator estimator_;
 };
 }   // namespace client
 }   // namespace curve
@@ -0,0 +1,295 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>   // NOLINT
+#include <cmath>
+
+#include "src/client/throttle.h"
+#include "src/common/timeutility.h"
+
+using curve::common::TimeUtility;
+
+namespace curve {
+namespace client {
+
+namespace {
+bool SameParams(const ThrottleParams_t& lhs, const ThrottleParams_t& rhs) {
+    return lhs.limit == rhs.limit && lhs.burst == rhs.burst;
+}
+
+bool SameParams(const FileThrottleParams_t& lhs,
+                const FileThrottleParams_t& rhs) {
+    return SameParams(lhs.readIOPS, rhs.readIOPS) &&
+           SameParams(lhs.writeIOPS, rhs.writeIOPS) &&
+           SameParams(lhs.readBPS, rhs.readBPS) &&
+           SameParams(lhs.writeBPS, rhs.writeBPS);
+}
+}   // namespace
+
+void TokenBucket::SetParams(const ThrottleParams_t& params, uint64_t nowUs) {
+    Refill(nowUs);
+
+    bool wasEnabled = Enabled();
+    limit_ = params.limit;
+    capacity_ = std::max(params.limit, params.burst);
+    if (!wasEnabled) {
+        tokens_ = capacity_;
+    } else {
+        tokens_ = std::min(tokens_, capacity_);
+    }
+    lastUs_ = nowUs;
+}
+
+void TokenBucket::Refill(uint64_t nowUs) {
+    if (!Enabled() || nowUs <= lastUs_) {
+        return;
+    }
+
+    tokens_ += static_cast<double>(nowUs - lastUs_) * limit_ / 1000000;
+    tokens_ = std::min(tokens_, capacity_);
+    lastUs_ = nowUs;
+}
+
+uint64_t TokenBucket::WaitUs(uint64_t nowUs) {
+    if (!Enabled()) {
+        return 0;
+    }
+
+    Refill(nowUs);
+    if (tokens_ >= 0) {
+        return 0;
+    }
+
+    return std::max<uint64_t>(std::ceil(-tokens_ * 1000000 / limit_), 1);
+}
+
+void TokenBucket::Consume(uint64_t tokens) {
+    if (Enabled()) {
+        tokens_ -= tokens;
+    }
+}
+
+Throttle::Throttle()
+    : enable_(false),
+      running_(false),
+      fileMetric_(nullptr) {}
+
+Throttle::~Throttle() {
+    Stop();
+}
+
+void Throttle::Init(const ThrottleOption_t& opt, FileMetric* fileMetric,
+                    DispatchFunc dispatch) {
+    enable_ = opt.enable;
+    fileMetric_ = fileMetric;
+    dispatch_ = dispatch;
+    if (!enable_) {
+        return;
+    }
+
+    uint64_t now = TimeUtility::GetTimeofDayUs();
+    params_ = opt.params;
+    readQueue_.iops.SetParams(params_.readIOPS, now);
+    readQueue_.bps.SetParams(params_.readBPS, now);
+    writeQueue_.iops.SetParams(params_.writeIOPS, now);
+    writeQueue_.bps.SetParams(params_.writeBPS, now);
+
+    running_ = true;
+    thread_ = curve::common::Thread(&Throttle::ThreadFunc, this);
+
+    LOG(INFO) << "throttle started, read iops = " << params_.readIOPS.limit
+              << ", write iops = " << params_.writeIOPS.limit
+              << ", read bps = " << params_.readBPS.limit
+              << ", write bps = " << params_.writeBPS.limit;
+}
+
+void Throttle::UpdateParams(const FileThrottleParams_t& params) {
+    if (!enable_) {
+        return;
+    }
+
+    std::lock_guard<Mutex> lk(mtx_);
+    if (SameParams(params_, params)) {
+        return;
+    }
+
+    uint64_t now = TimeUtility::GetTimeofDayUs();
+    params_ = params;
+    readQueue_.iops.SetParams(params_.readIOPS, now);
+    readQueue_.bps.SetParams(params_.readBPS, now);
+    writeQueue_.iops.SetParams(params_.writeIOPS, now);
+    writeQueue_.bps.SetParams(params_.writeBPS, now);
+
+    // 限制放宽后排队的请求可能可以下发了
+    cond_.notify_one();
+
+    LOG(INFO) << "throttle params updated, read iops = "
+              << params_.readIOPS.limit << "/" << params_.readIOPS.burst
+              << ", write iops = " << params_.writeIOPS.limit << "/"
+              << params_.writeIOPS.burst << ", read bps = "
+              << params_.readBPS.limit << "/" << params_.readBPS.burst
+              << ", write bps = " << params_.writeBPS.limit << "/"
+              << params_.writeBPS.burst;
+}
+
+void Throttle::Add(OpType type, uint64_t length, const Task& task) {
+    if (!Enqueue(type, length, false, task)) {
+        dispatch_(task);
+    }
+}
+
+void Throttle::Wait(OpType type, uint64_t length) {
+    curve::common::CountDownEvent event(1);
+    if (Enqueue(type, length, true, [&event]() { event.Signal(); })) {
+        event.Wait();
+    }
+}
+
+bool Throttle::Enqueue(OpType type, uint64_t length, bool sync,
+                       const Task& task) {
+    if (!enable_ || (type != OpType::READ && type != OpType::WRITE)) {
+        return false;
+    }
+
+    ThrottleQueue* queue = type == OpType::READ ? &readQueue_ : &writeQueue_;
+    uint64_t now = TimeUtility::GetTimeofDayUs();
+
+    std::lock_guard<Mutex> lk(mtx_);
+    // 已经有排队的请求时直接排在后面，保证请求按提交顺序下发
+    if (!running_ || (queue->pending.empty() &&
+                      TryAcquire(queue, length, now) == 0)) {
+        return false;
+    }
+
+    queue->pending.push_back(PendingIO{length, now, sync, task});
+    MetricHelper::IncremThrottleCount(fileMetric_, type);
+    cond_.notify_one();
+    return true;
+}
+
+void Throttle::Stop() {
+    {
+        std::lock_guard<Mutex> lk(mtx_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        cond_.notify_all();
+    }
+
+    thread_.join();
+
+    std::vector<PendingIO> pending;
+    {
+        std::lock_guard<Mutex> lk(mtx_);
+        for (ThrottleQueue* queue : {&readQueue_, &writeQueue_}) {
+            pending.insert(pending.end(), queue->pending.begin(),
+                           queue->pending.end());
+            queue->pending.clear();
+        }
+    }
+
+    uint64_t now = TimeUtility::GetTimeofDayUs();
+    for (const auto& io : pending) {
+        Dispatch(io, now);
+    }
+}
+
+size_t Throttle::GetPendingNum() {
+    std::lock_guard<Mutex> lk(mtx_);
+    return readQueue_.pending.size() + writeQueue_.pending.size();
+}
+
+uint64_t Throttle::TryAcquire(ThrottleQueue* queue, uint64_t length,
+                              uint64_t nowUs) {
+    uint64_t waitUs = std::max(queue->iops.WaitUs(nowUs),
+                               queue->bps.WaitUs(nowUs));
+    if (waitUs != 0) {
+        return waitUs;
+    }
+
+    queue->iops.Consume(1);
+    queue->bps.Consume(length);
+    return 0;
+}
+
+uint64_t Throttle::CollectReady(ThrottleQueue* queue, uint64_t nowUs,
+                                std::vector<PendingIO>* ready) {
+    while (!queue->pending.empty()) {
+        uint64_t waitUs = TryAcquire(queue, queue->pending.front().length,
+                                     nowUs);
+        if (waitUs != 0) {
+            return waitUs;
+        }
+
+        ready->push_back(std::move(queue->pending.front()));
+        queue->pending.pop_front();
+    }
+
+    return 0;
+}
+
+void Throttle::Dispatch(const PendingIO& io, uint64_t nowUs) {
+    MetricHelper::ThrottleWaitRecord(fileMetric_, nowUs - io.startUs);
+    if (io.sync) {
+        io.task();
+    } else {
+        dispatch_(io.task);
+    }
+}
+
+void Throttle::ThreadFunc() {
+    while (true) {
+        std::vector<PendingIO> ready;
+        {
+            std::unique_lock<Mutex> lk(mtx_);
+            if (!running_) {
+                break;
+            }
+
+            uint64_t now = TimeUtility::GetTimeofDayUs();
+            uint64_t readWait = CollectReady(&readQueue_, now, &ready);
+            uint64_t writeWait = CollectReady(&writeQueue_, now, &ready);
+
+            if (ready.empty()) {
+                // 等待令牌补齐，期间有新请求或者参数更新时重新检查
+                uint64_t waitUs = readWait == 0 ? writeWait :
+                    (writeWait == 0 ? readWait : std::min(readWait, writeWait));
+                if (waitUs == 0) {
+                    cond_.wait(lk);
+                } else {
+                    cond_.wait_for(lk, std::chrono::microseconds(waitUs));
+                }
+                continue;
+            }
+        }
+
+        uint64_t now = TimeUtility::GetTimeofDayUs();
+        for (const auto& io : ready) {
+            Dispatch(io, now);
+        }
+    }
+}
+
+}   // namespace client
+}   // namespace curve
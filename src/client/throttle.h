@@ -0,0 +1,199 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_CLIENT_THROTTLE_H_
+#define SRC_CLIENT_THROTTLE_H_
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "src/client/client_common.h"
+#include "src/client/client_metric.h"
+#include "src/client/config_info.h"
+#include "src/common/concurrent/concurrent.h"
+
+namespace curve {
+namespace client {
+
+using curve::common::Mutex;
+using curve::common::ConditionVariable;
+
+/**
+ * 令牌桶，令牌按limit匀速积累，最多积累burst个
+ * 令牌不为负时允许请求通过并扣除请求需要的令牌，令牌可以被扣成负数，
+ * 这样大于桶容量的请求也能通过，之后的请求等待欠下的令牌补齐
+ */
+class TokenBucket {
+ public:
+    TokenBucket() : limit_(0), capacity_(0), tokens_(0), lastUs_(0) {}
+
+    /**
+     * 设置限流参数，从不限制变为限制时桶是满的
+     * @param: params为限流参数，limit为0表示不限制
+     * @param: nowUs为当前时间
+     */
+    void SetParams(const ThrottleParams_t& params, uint64_t nowUs);
+
+    bool Enabled() const {
+        return limit_ > 0;
+    }
+
+    /**
+     * 补充令牌，并计算令牌恢复到不为负需要等待的时间
+     * @return: 0表示请求可以通过，否则为需要等待的时间，单位us
+     */
+    uint64_t WaitUs(uint64_t nowUs);
+
+    /**
+     * 扣除令牌，WaitUs返回0之后调用
+     */
+    void Consume(uint64_t tokens);
+
+ private:
+    void Refill(uint64_t nowUs);
+
+ private:
+    uint64_t limit_;
+    double capacity_;
+    double tokens_;
+    uint64_t lastUs_;
+};
+
+/**
+ * 文件级别的QoS限流，读写IOPS和带宽分别用一个令牌桶限制
+ * 1. 令牌足够且没有排队的请求时直接下发，否则按读写分别排队，不阻塞提交请求的线程
+ * 2. 后台线程在令牌补齐后按顺序下发排队的请求，读写队列互不影响
+ * 3. 限流参数可以随mds下发的文件信息动态调整
+ */
+class Throttle {
+ public:
+    using Task = std::function<void()>;
+    // 限流通过后下发请求
+    using DispatchFunc = std::function<void(const Task&)>;
+
+    Throttle();
+    ~Throttle();
+
+    /**
+     * 初始化，开启限流时启动后台线程
+     * @param: opt为限流配置信息
+     * @param: fileMetric为文件的metric
+     * @param: dispatch用于下发限流通过的请求
+     */
+    void Init(const ThrottleOption_t& opt, FileMetric* fileMetric,
+              DispatchFunc dispatch);
+
+    /**
+     * 更新限流参数，参数没有变化或者未开启限流时忽略
+     */
+    void UpdateParams(const FileThrottleParams_t& params);
+
+    /**
+     * 提交一个请求，限流通过后调用dispatch下发
+     * 未开启限流或令牌足够时在当前线程下发，否则排队等待后台线程下发
+     * @param: type为请求类型，只限制读写请求
+     * @param: length为请求大小
+     * @param: task为下发请求的任务
+     */
+    void Add(OpType type, uint64_t length, const Task& task);
+
+    /**
+     * 同步请求等待限流通过，令牌不足时阻塞当前线程
+     */
+    void Wait(OpType type, uint64_t length);
+
+    /**
+     * 停止后台线程，排队中的请求不再限流，全部立即下发
+     */
+    void Stop();
+
+    bool Enabled() const {
+        return enable_;
+    }
+
+    /**
+     * 获取排队中的请求数，测试使用
+     */
+    size_t GetPendingNum();
+
+ private:
+    struct PendingIO {
+        uint64_t length;
+        uint64_t startUs;
+        // 同步请求直接在后台线程中唤醒，不经过dispatch
+        bool sync;
+        Task task;
+    };
+
+    // 读或者写请求的两个令牌桶和排队队列
+    struct ThrottleQueue {
+        TokenBucket iops;
+        TokenBucket bps;
+        std::deque<PendingIO> pending;
+    };
+
+    /**
+     * 需要限流时把请求放入排队队列
+     * @return: 请求进入排队队列返回true，可以直接下发返回false
+     */
+    bool Enqueue(OpType type, uint64_t length, bool sync, const Task& task);
+
+    /**
+     * 令牌足够时扣除令牌并返回0，否则返回需要等待的时间，需要持有锁
+     */
+    uint64_t TryAcquire(ThrottleQueue* queue, uint64_t length,
+                        uint64_t nowUs);
+
+    /**
+     * 取出队列头部令牌足够的请求，需要持有锁
+     * @param: ready保存可以下发的请求
+     * @return: 队列头部的请求需要等待的时间，队列为空时返回0
+     */
+    uint64_t CollectReady(ThrottleQueue* queue, uint64_t nowUs,
+                          std::vector<PendingIO>* ready);
+
+    void Dispatch(const PendingIO& io, uint64_t nowUs);
+
+    void ThreadFunc();
+
+ private:
+    bool enable_;
+    bool running_;
+
+    // 当前生效的限流参数
+    FileThrottleParams_t params_;
+
+    FileMetric* fileMetric_;
+    DispatchFunc dispatch_;
+
+    Mutex mtx_;
+    ConditionVariable cond_;
+
+    ThrottleQueue readQueue_;
+    ThrottleQueue writeQueue_;
+
+    curve::common::Thread thread_;
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // SRC_CLIENT_THROTTLE_H_
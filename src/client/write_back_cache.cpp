@@ -0,0 +1,743 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <glog/logging.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <algorithm>
+#include <chrono>   // NOLINT
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include "src/client/write_back_cache.h"
+#include "src/common/crc32.h"
+#include "src/common/timeutility.h"
+#include "include/client/libcurve.h"
+
+using curve::common::TimeUtility;
+
+namespace curve {
+namespace client {
+
+namespace {
+
+const uint32_t kLogRecordMagic = 0x57424c47;
+// 写日志失败的记录，回放时跳过
+const uint32_t kLogRecordSkipMagic = 0x57424c53;
+// 单条日志记录的最大数据长度，用于回放时过滤损坏的记录
+const uint64_t kMaxLogRecordLength = 1ull << 32;
+// 本地日志最多分成的段数，日志以段为单位回收
+const uint64_t kLogSegmentCount = 8;
+
+struct LogRecordHeader {
+    uint32_t magic;
+    uint32_t crc;
+    uint64_t offset;
+    uint64_t length;
+};
+
+uint32_t LogRecordCrc(const LogRecordHeader& header, const char* data) {
+    uint32_t crc = curve::common::CRC32(
+        reinterpret_cast<const char*>(&header.offset),
+        sizeof(header.offset) + sizeof(header.length));
+    return curve::common::CRC32(crc, data, header.length);
+}
+
+}   // namespace
+
+WriteBackCache::WriteBackCache()
+    : segmentSize_(0),
+      logSize_(0),
+      running_(false),
+      dirtyBytes_(0),
+      reservedSeq_(0),
+      appliedSeq_(0),
+      nextId_(1),
+      flushRequested_(false),
+      logFenced_(false),
+      fileMetric_(nullptr) {}
+
+WriteBackCache::~WriteBackCache() {
+    Stop();
+}
+
+void WriteBackCache::Init(const WriteBackOption_t& opt,
+                          const std::string& filename,
+                          FileMetric* fileMetric,
+                          WriteBackFlushFunc flushFunc) {
+    opt_ = opt;
+    fileMetric_ = fileMetric;
+    flushFunc_ = flushFunc;
+
+    // 文件名中的'/'替换为'_'作为本地日志文件名
+    std::string logName = filename;
+    std::replace(logName.begin(), logName.end(), '/', '_');
+    logPath_ = opt_.logDir + "/" + logName + ".wblog";
+}
+
+int WriteBackCache::Start() {
+    if (!opt_.enable || running_) {
+        return 0;
+    }
+
+    if (mkdir(opt_.logDir.c_str(), 0755) != 0 && errno != EEXIST) {
+        LOG(ERROR) << "create write back log dir failed, dir = "
+                   << opt_.logDir << ", errno = " << errno;
+        return -1;
+    }
+
+    segmentSize_ = std::max<uint64_t>(
+        opt_.maxLogSizeMB * 1024 * 1024 / kLogSegmentCount, 1);
+    if (ReplayLog() != 0) {
+        for (const auto& segment : segments_) {
+            close(segment.fd);
+        }
+        segments_.clear();
+        return -1;
+    }
+
+    running_ = true;
+    flushThread_ = curve::common::Thread(&WriteBackCache::FlushThreadFunc,
+                                         this);
+
+    LOG(INFO) << "write back cache started, log path = " << logPath_
+              << ", maxDirtyMB = " << opt_.maxDirtyMB
+              << ", flushThresholdMB = " << opt_.flushThresholdMB
+              << ", maxLogSizeMB = " << opt_.maxLogSizeMB;
+    return 0;
+}
+
+void WriteBackCache::Stop() {
+    {
+        std::lock_guard<Mutex> lk(mtx_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        flushCond_.notify_all();
+        spaceCond_.notify_all();
+    }
+
+    flushThread_.join();
+
+    std::list<FlushWaiter> pending;
+    std::deque<LogSegment> segments;
+    bool clean = false;
+    {
+        std::lock_guard<Mutex> lk(mtx_);
+        pending.swap(waiters_);
+        segments.swap(segments_);
+        clean = extents_.empty();
+
+        MetricHelper::UpdateWriteBackDirtyBytes(fileMetric_,
+            -static_cast<int64_t>(dirtyBytes_));
+        extents_.clear();
+        dirtySeqs_.clear();
+        dirtyBytes_ = 0;
+        logSize_ = 0;
+        reservedSeq_ = 0;
+        appliedSeq_ = 0;
+        flushRequested_ = false;
+        logFenced_ = false;
+    }
+
+    for (auto& waiter : pending) {
+        waiter.done(-LIBCURVE_ERROR::FAILED);
+    }
+
+    for (const auto& segment : segments) {
+        close(segment.fd);
+        if (clean) {
+            unlink(SegmentPath(segment.index).c_str());
+        }
+    }
+
+    if (!clean) {
+        LOG(WARNING) << "write back cache stopped with dirty data, "
+                     << "it will be replayed from " << logPath_
+                     << " on next open";
+    }
+}
+
+int WriteBackCache::Write(const char* buf, off_t offset, size_t length) {
+    if (length == 0) {
+        return 0;
+    }
+    // 返回值为写入的长度
+    if (length > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        LOG(ERROR) << "write back length too large, length = " << length;
+        return -LIBCURVE_ERROR::PARAM_ERROR;
+    }
+
+    const uint64_t recordSize = sizeof(LogRecordHeader) + length;
+    const uint64_t maxDirty = opt_.maxDirtyMB * 1024 * 1024;
+    const uint64_t maxLog = opt_.maxLogSizeMB * 1024 * 1024;
+
+    uint64_t seq = 0;
+    uint64_t pos = 0;
+    int fd = -1;
+    {
+        std::unique_lock<Mutex> lk(mtx_);
+        bool throttled = false;
+        // 缓存为空时放行，避免单个超过限制的大请求一直等待
+        while (running_ &&
+               ((dirtyBytes_ > 0 && dirtyBytes_ + length > maxDirty) ||
+                (logSize_ > 0 && logSize_ + recordSize > maxLog))) {
+            if (!throttled) {
+                MetricHelper::IncremWriteBackThrottleCount(fileMetric_);
+                throttled = true;
+            }
+            flushRequested_ = true;
+            flushCond_.notify_one();
+            spaceCond_.wait(lk);
+        }
+
+        if (!running_ || logFenced_) {
+            return -LIBCURVE_ERROR::FAILED;
+        }
+
+        // 当前段写满后滚动到下一段
+        if (segments_.back().size > 0 &&
+            segments_.back().size + recordSize > segmentSize_) {
+            LogSegment segment;
+            if (OpenSegment(segments_.back().index + 1, &segment) != 0) {
+                return -LIBCURVE_ERROR::FAILED;
+            }
+            segments_.push_back(segment);
+        }
+
+        seq = ++reservedSeq_;
+        LogSegment& segment = segments_.back();
+        fd = segment.fd;
+        pos = segment.size;
+        segment.size += recordSize;
+        segment.lastSeq = seq;
+        logSize_ += recordSize;
+    }
+
+    std::shared_ptr<char> data(new char[length], std::default_delete<char[]>());
+    memcpy(data.get(), buf, length);
+
+    LogRecordHeader header;
+    header.magic = kLogRecordMagic;
+    header.offset = offset;
+    header.length = length;
+    header.crc = LogRecordCrc(header, data.get());
+
+    struct iovec iov[2];
+    iov[0].iov_base = &header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = data.get();
+    iov[1].iov_len = length;
+
+    bool persisted =
+        pwritev(fd, iov, 2, pos) == static_cast<ssize_t>(recordSize) &&
+        fdatasync(fd) == 0;
+    bool fence = false;
+    if (!persisted) {
+        LOG(ERROR) << "append write back log failed, offset = " << offset
+                   << ", length = " << length << ", errno = " << errno;
+        // 将记录标记为跳过，避免回放时在此处中断
+        header.magic = kLogRecordSkipMagic;
+        fence = pwrite(fd, &header, sizeof(header), pos) !=
+                    static_cast<ssize_t>(sizeof(header)) ||
+                fdatasync(fd) != 0;
+        LOG_IF(ERROR, fence) << "mark write back log record skipped failed, "
+                             << "stop appending to " << logPath_
+                             << ", errno = " << errno;
+    }
+
+    {
+        std::unique_lock<Mutex> lk(mtx_);
+        applyCond_.wait(lk, [&]() { return appliedSeq_ == seq - 1; });
+        // 按序号顺序处理，之后的写请求即使已经写入日志也不再返回成功
+        if (fence) {
+            logFenced_ = true;
+        }
+        persisted = persisted && !logFenced_;
+        if (persisted) {
+            InsertExtent({static_cast<uint64_t>(offset), length, data,
+                          data.get(), seq, nextId_++});
+        }
+        appliedSeq_ = seq;
+        applyCond_.notify_all();
+
+        if (dirtyBytes_ >= opt_.flushThresholdMB * 1024 * 1024) {
+            flushRequested_ = true;
+            flushCond_.notify_one();
+        }
+    }
+
+    return persisted ? static_cast<int>(length) : -LIBCURVE_ERROR::FAILED;
+}
+
+bool WriteBackCache::GetDirtyExtents(off_t offset, size_t length,
+                                     std::vector<DirtyExtent>* extents) {
+    uint64_t start = offset;
+    uint64_t end = offset + length;
+    uint64_t covered = 0;
+
+    std::lock_guard<Mutex> lk(mtx_);
+    if (extents_.empty()) {
+        return false;
+    }
+
+    auto iter = extents_.lower_bound(start);
+    if (iter != extents_.begin()) {
+        auto prev = std::prev(iter);
+        if (prev->first + prev->second.length > start) {
+            iter = prev;
+        }
+    }
+
+    for (; iter != extents_.end() && iter->first < end; ++iter) {
+        const DirtyExtent& extent = iter->second;
+        covered += std::min(end, extent.offset + extent.length) -
+                   std::max(start, extent.offset);
+        extents->push_back(extent);
+    }
+
+    return covered == length;
+}
+
+void WriteBackCache::ApplyDirtyExtents(
+    const std::vector<DirtyExtent>& extents,
+    off_t offset, size_t length, char* buf) {
+    uint64_t start = offset;
+    uint64_t end = offset + length;
+    for (const auto& extent : extents) {
+        uint64_t copyStart = std::max(start, extent.offset);
+        uint64_t copyEnd = std::min(end, extent.offset + extent.length);
+        if (copyStart >= copyEnd) {
+            continue;
+        }
+        memcpy(buf + (copyStart - start),
+               extent.buf + (copyStart - extent.offset),
+               copyEnd - copyStart);
+    }
+}
+
+void WriteBackCache::AioFlush(WriteBackFlushDone done) {
+    uint64_t startTime = TimeUtility::GetTimeofDayUs();
+    int ret = 0;
+    {
+        std::lock_guard<Mutex> lk(mtx_);
+        if (running_ && !dirtySeqs_.empty()) {
+            waiters_.push_back({appliedSeq_, startTime, std::move(done)});
+            flushRequested_ = true;
+            flushCond_.notify_one();
+            return;
+        }
+        ret = extents_.empty() ? 0 : -LIBCURVE_ERROR::FAILED;
+    }
+
+    MetricHelper::WriteBackUserFlushRecord(fileMetric_,
+        TimeUtility::GetTimeofDayUs() - startTime);
+    done(ret);
+}
+
+int WriteBackCache::Flush() {
+    bool finished = false;
+    int ret = 0;
+    std::mutex mtx;
+    std::condition_variable cv;
+
+    AioFlush([&](int rc) {
+        std::lock_guard<std::mutex> lk(mtx);
+        ret = rc;
+        finished = true;
+        cv.notify_one();
+    });
+
+    std::unique_lock<std::mutex> lk(mtx);
+    cv.wait(lk, [&]() { return finished; });
+    return ret;
+}
+
+uint64_t WriteBackCache::GetDirtyBytes() {
+    std::lock_guard<Mutex> lk(mtx_);
+    return dirtyBytes_;
+}
+
+void WriteBackCache::InsertExtent(DirtyExtent extent) {
+    uint64_t start = extent.offset;
+    uint64_t end = extent.offset + extent.length;
+
+    auto iter = extents_.lower_bound(start);
+    if (iter != extents_.begin()) {
+        auto prev = std::prev(iter);
+        if (prev->first + prev->second.length > start) {
+            iter = prev;
+        }
+    }
+
+    // 被覆盖的旧数据保留未重叠的部分，新数据继承旧数据中最早的写请求序号，
+    // 保证在旧数据之后发起的flush会等待新数据刷盘
+    std::vector<DirtyExtent> pieces;
+    while (iter != extents_.end() && iter->first < end) {
+        const DirtyExtent& old = iter->second;
+        uint64_t oldEnd = old.offset + old.length;
+        extent.seq = std::min(extent.seq, old.seq);
+        if (old.offset < start) {
+            pieces.push_back({old.offset, start - old.offset, old.data,
+                              old.buf, old.seq, nextId_++});
+        }
+        if (oldEnd > end) {
+            pieces.push_back({end, oldEnd - end, old.data,
+                              old.buf + (end - old.offset), old.seq,
+                              nextId_++});
+        }
+        iter = EraseExtent(iter);
+    }
+    pieces.push_back(std::move(extent));
+
+    for (auto& piece : pieces) {
+        dirtySeqs_.insert(piece.seq);
+        dirtyBytes_ += piece.length;
+        MetricHelper::UpdateWriteBackDirtyBytes(fileMetric_, piece.length);
+        uint64_t key = piece.offset;
+        extents_.emplace(key, std::move(piece));
+    }
+}
+
+std::map<uint64_t, DirtyExtent>::iterator WriteBackCache::EraseExtent(
+    std::map<uint64_t, DirtyExtent>::iterator iter) {
+    dirtySeqs_.erase(dirtySeqs_.find(iter->second.seq));
+    dirtyBytes_ -= iter->second.length;
+    MetricHelper::UpdateWriteBackDirtyBytes(fileMetric_,
+        -static_cast<int64_t>(iter->second.length));
+    return extents_.erase(iter);
+}
+
+std::string WriteBackCache::SegmentPath(uint64_t index) const {
+    return index == 0 ? logPath_ : logPath_ + "." + std::to_string(index);
+}
+
+int WriteBackCache::OpenSegment(uint64_t index, LogSegment* segment) {
+    std::string path = SegmentPath(index);
+    int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        LOG(ERROR) << "open write back log failed, path = " << path
+                   << ", errno = " << errno;
+        return -1;
+    }
+
+    // 新建的日志段需要持久化目录项，否则掉电后可能丢失整段日志
+    int dirFd = open(opt_.logDir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd < 0 || fsync(dirFd) != 0) {
+        LOG(ERROR) << "sync write back log dir failed, dir = "
+                   << opt_.logDir << ", errno = " << errno;
+        if (dirFd >= 0) {
+            close(dirFd);
+        }
+        close(fd);
+        return -1;
+    }
+    close(dirFd);
+
+    segment->index = index;
+    segment->fd = fd;
+    segment->size = 0;
+    segment->lastSeq = reservedSeq_;
+    return 0;
+}
+
+int WriteBackCache::ListSegments(std::vector<uint64_t>* indexes) {
+    DIR* dir = opendir(opt_.logDir.c_str());
+    if (dir == nullptr) {
+        LOG(ERROR) << "open write back log dir failed, dir = "
+                   << opt_.logDir << ", errno = " << errno;
+        return -1;
+    }
+
+    std::string logName = logPath_.substr(opt_.logDir.size() + 1);
+    struct dirent* entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name == logName) {
+            indexes->push_back(0);
+            continue;
+        }
+        if (name.size() <= logName.size() + 1 ||
+            name.compare(0, logName.size() + 1, logName + ".") != 0) {
+            continue;
+        }
+        std::string suffix = name.substr(logName.size() + 1);
+        if (suffix.find_first_not_of("0123456789") != std::string::npos) {
+            continue;
+        }
+        indexes->push_back(std::stoull(suffix));
+    }
+    closedir(dir);
+
+    std::sort(indexes->begin(), indexes->end());
+    return 0;
+}
+
+int WriteBackCache::ReplayLog() {
+    std::lock_guard<Mutex> lk(mtx_);
+
+    std::vector<uint64_t> indexes;
+    if (ListSegments(&indexes) != 0) {
+        return -1;
+    }
+    if (indexes.empty()) {
+        indexes.push_back(0);
+    }
+
+    uint64_t count = 0;
+    // 遇到损坏的记录后，之后的记录和日志段都丢弃
+    bool broken = false;
+    for (auto index : indexes) {
+        if (broken) {
+            unlink(SegmentPath(index).c_str());
+            continue;
+        }
+
+        LogSegment segment;
+        if (OpenSegment(index, &segment) != 0) {
+            return -1;
+        }
+        segments_.push_back(segment);
+
+        uint64_t pos = 0;
+        while (true) {
+            LogRecordHeader header;
+            ssize_t n = pread(segment.fd, &header, sizeof(header), pos);
+            if (n == 0) {
+                break;
+            }
+            if (n != static_cast<ssize_t>(sizeof(header)) ||
+                (header.magic != kLogRecordMagic &&
+                 header.magic != kLogRecordSkipMagic) ||
+                header.length == 0 || header.length > kMaxLogRecordLength) {
+                broken = true;
+                break;
+            }
+
+            if (header.magic == kLogRecordSkipMagic) {
+                pos += sizeof(header) + header.length;
+                continue;
+            }
+
+            std::shared_ptr<char> data(new char[header.length],
+                                       std::default_delete<char[]>());
+            n = pread(segment.fd, data.get(), header.length,
+                      pos + sizeof(header));
+            if (n != static_cast<ssize_t>(header.length) ||
+                LogRecordCrc(header, data.get()) != header.crc) {
+                broken = true;
+                break;
+            }
+
+            ++reservedSeq_;
+            appliedSeq_ = reservedSeq_;
+            InsertExtent({header.offset, header.length, data, data.get(),
+                          reservedSeq_, nextId_++});
+            pos += sizeof(header) + header.length;
+            ++count;
+        }
+
+        // 截掉尾部不完整的记录
+        if (ftruncate(segment.fd, pos) != 0) {
+            LOG(ERROR) << "truncate write back log failed, path = "
+                       << SegmentPath(index) << ", errno = " << errno;
+            return -1;
+        }
+        segments_.back().size = pos;
+        segments_.back().lastSeq = reservedSeq_;
+        logSize_ += pos;
+    }
+
+    if (count > 0) {
+        LOG(WARNING) << "replay write back log " << logPath_
+                     << ", segment count = " << segments_.size()
+                     << ", record count = " << count
+                     << ", dirty bytes = " << dirtyBytes_;
+        flushRequested_ = true;
+    }
+    return 0;
+}
+
+void WriteBackCache::ReclaimLog(std::vector<LogSegment>* removed) {
+    // 序号小于liveSeq的记录都已经刷盘或者被之后的记录覆盖
+    uint64_t liveSeq = appliedSeq_ + 1;
+    if (!dirtySeqs_.empty()) {
+        liveSeq = std::min(liveSeq, *dirtySeqs_.begin());
+    }
+
+    // 当前追加写的段不删除
+    while (segments_.size() > 1 && segments_.front().lastSeq < liveSeq) {
+        logSize_ -= segments_.front().size;
+        removed->push_back(segments_.front());
+        segments_.pop_front();
+    }
+
+    // 脏数据全部刷完且没有正在写的日志，截断本地日志
+    if (extents_.empty() && reservedSeq_ == appliedSeq_ && logSize_ > 0) {
+        LogSegment& segment = segments_.back();
+        if (ftruncate(segment.fd, 0) == 0) {
+            logSize_ -= segment.size;
+            segment.size = 0;
+        } else {
+            LOG(ERROR) << "truncate write back log failed, path = "
+                       << SegmentPath(segment.index) << ", errno = " << errno;
+        }
+    }
+}
+
+void WriteBackCache::RemoveSegments(const std::vector<LogSegment>& segments) {
+    for (const auto& segment : segments) {
+        close(segment.fd);
+        std::string path = SegmentPath(segment.index);
+        if (unlink(path.c_str()) != 0) {
+            LOG(ERROR) << "remove write back log failed, path = " << path
+                       << ", errno = " << errno;
+        }
+    }
+}
+
+void WriteBackCache::FlushThreadFunc() {
+    const auto interval = std::chrono::milliseconds(opt_.flushIntervalMS);
+    const uint64_t threshold = opt_.flushThresholdMB * 1024 * 1024;
+
+    while (true) {
+        std::vector<DirtyExtent> batch;
+        {
+            std::unique_lock<Mutex> lk(mtx_);
+            flushCond_.wait_for(lk, interval, [&]() {
+                return !running_ || flushRequested_ || dirtyBytes_ >= threshold;
+            });
+            if (!running_) {
+                break;
+            }
+            flushRequested_ = false;
+
+            batch.reserve(extents_.size());
+            for (const auto& item : extents_) {
+                batch.push_back(item.second);
+            }
+        }
+
+        int ret = batch.empty() ? 0 : FlushExtents(batch);
+
+        std::list<FlushWaiter> finished;
+        std::vector<LogSegment> removed;
+        {
+            std::lock_guard<Mutex> lk(mtx_);
+            if (ret == 0) {
+                // 刷盘期间被覆盖的extent仍然是脏数据
+                for (const auto& extent : batch) {
+                    auto iter = extents_.find(extent.offset);
+                    if (iter != extents_.end() &&
+                        iter->second.id == extent.id) {
+                        EraseExtent(iter);
+                    }
+                }
+            }
+
+            CollectFinishedWaiters(ret, &finished);
+            ReclaimLog(&removed);
+            spaceCond_.notify_all();
+        }
+
+        RemoveSegments(removed);
+
+        uint64_t now = TimeUtility::GetTimeofDayUs();
+        for (auto& waiter : finished) {
+            MetricHelper::WriteBackUserFlushRecord(fileMetric_,
+                                                   now - waiter.startTime);
+            waiter.done(ret);
+        }
+
+        if (ret != 0) {
+            // 刷盘失败，等待一个周期后重试
+            std::unique_lock<Mutex> lk(mtx_);
+            flushCond_.wait_for(lk, interval, [&]() { return !running_; });
+        }
+    }
+}
+
+int WriteBackCache::FlushExtents(const std::vector<DirtyExtent>& extents) {
+    const uint64_t maxBatchSize = opt_.flushBatchSizeKB * 1024;
+    std::vector<char> buffer;
+
+    size_t i = 0;
+    while (i < extents.size()) {
+        // 合并offset连续的extent
+        size_t j = i;
+        uint64_t length = extents[i].length;
+        while (j + 1 < extents.size() &&
+               extents[j + 1].offset == extents[j].offset + extents[j].length &&
+               length + extents[j + 1].length <= maxBatchSize) {
+            ++j;
+            length += extents[j].length;
+        }
+
+        const char* buf = extents[i].buf;
+        if (j > i) {
+            buffer.resize(length);
+            uint64_t pos = 0;
+            for (size_t k = i; k <= j; ++k) {
+                memcpy(buffer.data() + pos, extents[k].buf, extents[k].length);
+                pos += extents[k].length;
+            }
+            buf = buffer.data();
+        }
+
+        uint64_t startTime = TimeUtility::GetTimeofDayUs();
+        int ret = flushFunc_(buf, extents[i].offset, length);
+        if (ret < 0) {
+            LOG(ERROR) << "write back flush failed, log path = " << logPath_
+                       << ", offset = " << extents[i].offset
+                       << ", length = " << length << ", ret = " << ret;
+            return ret;
+        }
+        MetricHelper::WriteBackFlushRecord(fileMetric_, length,
+            TimeUtility::GetTimeofDayUs() - startTime);
+
+        i = j + 1;
+    }
+
+    return 0;
+}
+
+void WriteBackCache::CollectFinishedWaiters(
+    int ret, std::list<FlushWaiter>* finished) {
+    auto iter = waiters_.begin();
+    while (iter != waiters_.end()) {
+        if (ret != 0 || dirtySeqs_.empty() ||
+            *dirtySeqs_.begin() > iter->seq) {
+            finished->splice(finished->end(), waiters_, iter++);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+}   // namespace client
+}   // namespace curve
@@ -0,0 +1,316 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_CLIENT_WRITE_BACK_CACHE_H_
+#define SRC_CLIENT_WRITE_BACK_CACHE_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "src/client/config_info.h"
+#include "src/client/client_metric.h"
+#include "src/common/concurrent/concurrent.h"
+
+namespace curve {
+namespace client {
+
+using curve::common::Mutex;
+using curve::common::ConditionVariable;
+
+// 写缓存中的一段连续脏数据，数据buffer不可变，多个extent可以共享同一个buffer
+struct DirtyExtent {
+    uint64_t offset;
+    uint64_t length;
+    // 持有数据buffer的引用
+    std::shared_ptr<char> data;
+    // 当前extent的数据起始地址，指向data内部
+    const char* buf;
+    // 当前extent包含的最早一次写请求的序号，flush据此判断数据是否已经刷盘
+    uint64_t seq;
+    // extent的唯一标识，刷盘返回时用于判断extent是否在刷盘期间被覆盖
+    uint64_t id;
+};
+
+/**
+ * 后台刷盘函数，将[offset, offset + length)的数据写到chunkserver
+ * @return: 成功返回写入的字节数，失败返回小于0的错误码
+ */
+using WriteBackFlushFunc =
+    std::function<int(const char* buf, off_t offset, size_t length)>;
+
+// flush完成后的回调，参数为flush的返回值
+using WriteBackFlushDone = std::function<void(int ret)>;
+
+/**
+ * 文件级别的client写缓存(write-back)
+ * 1. 写请求先追加到本地持久化日志，日志落盘后将数据插入内存中的脏数据索引并向上返回
+ * 2. 脏数据索引按offset组织，覆盖写会直接替换旧数据
+ * 3. 后台线程按offset顺序把连续的脏数据合并成大请求刷到chunkserver，
+ *    本地日志按段滚动写入，段内的记录全部刷盘后删除该段，
+ *    脏数据全部刷完后截断本地日志
+ * 4. 读请求需要用缓存中的脏数据覆盖从chunkserver读回的数据
+ * 5. flush请求在其之前返回的写请求全部刷到chunkserver后才返回
+ * 6. 进程异常退出后，再次打开文件时回放本地日志恢复脏数据
+ */
+class WriteBackCache {
+ public:
+    WriteBackCache();
+    ~WriteBackCache();
+
+    /**
+     * 初始化
+     * @param: opt为写缓存配置
+     * @param: filename为文件名，用于生成本地日志文件名
+     * @param: fileMetric为文件级别metric，可以为空
+     * @param: flushFunc为后台刷盘函数
+     */
+    void Init(const WriteBackOption_t& opt,
+              const std::string& filename,
+              FileMetric* fileMetric,
+              WriteBackFlushFunc flushFunc);
+
+    /**
+     * 打开本地日志，回放上次未刷盘的数据，并启动后台刷盘线程
+     * 写缓存未开启时直接返回成功
+     * @return: 成功返回0，否则返回-1
+     */
+    int Start();
+
+    /**
+     * 停止后台刷盘线程，不会主动刷盘，未刷盘的数据保留在本地日志中
+     * 调用前需要保证没有新的读写请求
+     */
+    void Stop();
+
+    /**
+     * 写缓存是否在运行，运行时写请求由写缓存处理
+     */
+    bool Running() const {
+        return running_;
+    }
+
+    /**
+     * 写入数据，数据写入本地日志后返回
+     * length不能超过INT_MAX，本地日志写失败且无法标记跳过时，
+     * 之后的写请求全部失败，避免已返回的写请求排在损坏的记录之后
+     * @return: 成功返回length，失败返回小于0的错误码
+     */
+    int Write(const char* buf, off_t offset, size_t length);
+
+    /**
+     * 获取与[offset, offset + length)重叠的脏数据，读请求发起时调用
+     * @param[out]: extents为重叠的脏数据
+     * @return: 读范围被脏数据完全覆盖时返回true
+     */
+    bool GetDirtyExtents(off_t offset, size_t length,
+                         std::vector<DirtyExtent>* extents);
+
+    /**
+     * 用脏数据覆盖读缓冲区中对应的部分
+     */
+    static void ApplyDirtyExtents(const std::vector<DirtyExtent>& extents,
+                                  off_t offset, size_t length, char* buf);
+
+    /**
+     * 异步flush，之前返回的写请求全部刷到chunkserver后调用done
+     * done可能在调用线程中直接执行，也可能在后台刷盘线程中执行
+     */
+    void AioFlush(WriteBackFlushDone done);
+
+    /**
+     * 同步flush
+     * @return: 成功返回0，否则返回小于0的错误码
+     */
+    int Flush();
+
+    /**
+     * 获取当前的脏数据字节数
+     */
+    uint64_t GetDirtyBytes();
+
+    /**
+     * 获取第一个本地日志段的文件路径，测试使用
+     */
+    const std::string& GetLogPath() const {
+        return logPath_;
+    }
+
+ private:
+    struct FlushWaiter {
+        uint64_t seq;
+        uint64_t startTime;
+        WriteBackFlushDone done;
+    };
+
+    // 本地日志段，日志写满一段后滚动到下一段
+    struct LogSegment {
+        uint64_t index;
+        int fd;
+        // 段内已分配的大小
+        uint64_t size;
+        // 段内最后一条记录的序号，小于最早的脏数据序号时该段可以删除
+        uint64_t lastSeq;
+    };
+
+    /**
+     * 将一段数据插入脏数据索引，覆盖与其重叠的旧数据，调用方持有mtx_
+     */
+    void InsertExtent(DirtyExtent extent);
+
+    /**
+     * 从脏数据索引中删除一个extent，调用方持有mtx_
+     * @return: 返回被删除extent的下一个extent
+     */
+    std::map<uint64_t, DirtyExtent>::iterator EraseExtent(
+        std::map<uint64_t, DirtyExtent>::iterator iter);
+
+    /**
+     * 获取日志段的文件路径，第0段为logPath_，其余段在logPath_后加上段号
+     */
+    std::string SegmentPath(uint64_t index) const;
+
+    /**
+     * 打开日志段，不存在时创建
+     * @return: 成功返回0，否则返回-1
+     */
+    int OpenSegment(uint64_t index, LogSegment* segment);
+
+    /**
+     * 按段号顺序列出本地已有的日志段
+     * @return: 成功返回0，否则返回-1
+     */
+    int ListSegments(std::vector<uint64_t>* indexes);
+
+    /**
+     * 回放本地日志
+     * @return: 成功返回0，否则返回-1
+     */
+    int ReplayLog();
+
+    /**
+     * 回收记录全部刷盘的日志段，调用方持有mtx_
+     * @param[out]: removed为需要关闭并删除的日志段
+     */
+    void ReclaimLog(std::vector<LogSegment>* removed);
+
+    /**
+     * 关闭并删除日志段
+     */
+    void RemoveSegments(const std::vector<LogSegment>& segments);
+
+    /**
+     * 后台刷盘线程
+     */
+    void FlushThreadFunc();
+
+    /**
+     * 将一批脏数据合并后刷到chunkserver
+     * @return: 成功返回0，否则返回小于0的错误码
+     */
+    int FlushExtents(const std::vector<DirtyExtent>& extents);
+
+    /**
+     * 取出已经完成的flush请求，调用方持有mtx_
+     * @param: ret为本轮刷盘结果，失败时所有等待中的flush都返回失败
+     */
+    void CollectFinishedWaiters(int ret, std::list<FlushWaiter>* finished);
+
+ private:
+    WriteBackOption_t opt_;
+
+    // 本地日志文件
+    std::string logPath_;
+
+    // 本地日志段，按段号递增排列，最后一段为当前追加写的段
+    std::deque<LogSegment> segments_;
+
+    // 单个日志段的大小
+    uint64_t segmentSize_;
+
+    // 所有日志段已分配的大小
+    uint64_t logSize_;
+
+    // 写缓存是否在运行
+    std::atomic<bool> running_;
+
+    // 脏数据索引，key为extent的offset
+    std::map<uint64_t, DirtyExtent> extents_;
+
+    // 所有脏数据extent的seq，用于判断flush是否完成
+    std::multiset<uint64_t> dirtySeqs_;
+
+    // 当前脏数据字节数
+    uint64_t dirtyBytes_;
+
+    // 已经分配的最大写请求序号
+    uint64_t reservedSeq_;
+
+    // 已经插入脏数据索引的最大写请求序号，写请求按序号顺序插入索引，
+    // 保证索引中的数据与日志回放的结果一致
+    uint64_t appliedSeq_;
+
+    // extent id生成器
+    uint64_t nextId_;
+
+    // 是否有待处理的刷盘请求
+    bool flushRequested_;
+
+    // 本地日志中有无法标记跳过的损坏记录，回放时其后的记录都会丢弃，
+    // 不再追加新的记录
+    bool logFenced_;
+
+    // 等待中的flush请求
+    std::list<FlushWaiter> waiters_;
+
+    // 保护上述状态
+    Mutex mtx_;
+
+    // 唤醒后台刷盘线程
+    ConditionVariable flushCond_;
+
+    // 唤醒等待脏数据或日志空间的写请求
+    ConditionVariable spaceCond_;
+
+    // 唤醒等待按序插入索引的写请求
+    ConditionVariable applyCond_;
+
+    // 后台刷盘线程
+    curve::common::Thread flushThread_;
+
+    // 后台刷盘函数
+    WriteBackFlushFunc flushFunc_;
+
+    // 文件级别metric
+    FileMetric* fileMetric_;
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // SRC_CLIENT_WRITE_BACK_CACHE_H_
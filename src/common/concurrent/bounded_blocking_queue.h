@@ -59,7 +59,7 @@ class BBQItem {
         return stop_.load(std::memory_order_acquire);
     }
 
-    T Item() {
+    T Item() const {
         return item_;
     }
 
@@ -119,6 +119,24 @@ class BoundedBlockingDeque : public Uncopyable {
         return front;
     }
 
+    /**
+     * 队首元素满足pred时将其取出，不阻塞
+     * @param: pred为判断条件
+     * @param[out]: x为取出的元素
+     * @return: 取出元素时返回true
+     */
+    template<typename Pred>
+    bool TakeFrontIf(Pred pred, T *x) {
+        std::unique_lock<std::mutex> guard(mutex_);
+        if (deque_.empty() || !pred(deque_.front())) {
+            return false;
+        }
+        *x = deque_.front();
+        deque_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
     T TakeBack() {
         std::unique_lock<std::mutex> guard(mutex_);
         while (deque_.empty()) {
@@ -27,6 +27,7 @@
 #include <sys/types.h>
 
 #include <butil/crc32c.h>
+#include <butil/iobuf.h>
 
 namespace curve {
 namespace common {
@@ -54,6 +55,19 @@ inline uint32_t CRC32(uint32_t crc, const char *pData, size_t iLen) {
     return butil::crc32c::Extend(crc, pData, iLen);
 }
 
+/**
+ * 计算IOBuf中数据的CRC，按block依次扩展，不需要把数据拷贝到连续的内存中
+ * 结果与对相同内容的连续内存计算CRC一致
+ */
+inline uint32_t CRC32(const butil::IOBuf &buf) {
+    uint32_t crc = 0;
+    for (size_t i = 0; i < buf.backing_block_num(); ++i) {
+        butil::StringPiece block = buf.backing_block(i);
+        crc = CRC32(crc, block.data(), block.size());
+    }
+    return crc;
+}
+
 }  // namespace common
 }  // namespace curve
 
@@ -45,11 +45,15 @@ const char SNAPINFOKEYPREFIX[] = "11";
 const char SNAPINFOKEYEND[] = "12";
 const char CLONEINFOKEYPREFIX[] = "12";
 const char CLONEINFOKEYEND[] = "13";
+const char ALLOCSIZEKEYPREFIX[] = "13";
+const char ALLOCSIZEKEYEND[] = "14";
+const char ALLOCSIZESTATEKEY[] = "14allocsizestate";
 
 // TODO(hzsunjianliang): if use single prefix for snapshot file?
 const int COMMON_PREFIX_LENGTH = 2;
 const int LEADER_PREFIX_LENGTH = 8;
 const int SEGMENTKEYLEN = 18;
+const int ALLOCSIZEKEYLEN = 10;
 
 }  // namespace common
 }  // namespace curve
@@ -24,6 +24,7 @@
 #define SRC_MDS_CHUNKSERVERCLIENT_COPYSET_CLIENT_H_
 
 #include <memory>
+#include <vector>
 #include "src/mds/common/mds_define.h"
 #include "src/mds/topology/topology.h"
 
@@ -90,6 +91,22 @@ class CopysetClient {
         ChunkID chunkId,
         uint64_t sn);
 
+    /**
+     * @brief 批量删除同一个复制组中的非快照chunk文件，
+     *        所有chunk在chunkserver上通过一条raft日志删除
+     *
+     * @param logicPoolId 逻辑池id
+     * @param copysetId 复制组id
+     * @param chunkIds Chunk文件id列表，不能为空
+     * @param sn 文件版本号
+     *
+     * @return 错误码
+     */
+    int DeleteChunks(LogicalPoolID logicalPoolId,
+        CopysetID copysetId,
+        const std::vector<ChunkID> &chunkIds,
+        uint64_t sn);
+
     /**
      * @brief 更新leader
      *
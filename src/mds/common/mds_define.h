@@ -23,6 +23,7 @@
 #ifndef SRC_MDS_COMMON_MDS_DEFINE_H_
 #define SRC_MDS_COMMON_MDS_DEFINE_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 
@@ -163,6 +164,26 @@ const char kLeastSupportSnapshotClientVersion[] = "0.0.5.3";
 
 const uint32_t kInvalidPort = 0;
 
+struct AllocatedSize {
+    // mds给文件分配的segment的大小
+    uint64_t allocatedSize;
+    // 实际会占用的底层空间
+    uint64_t physicalAllocatedSize;
+    AllocatedSize() : allocatedSize(0), physicalAllocatedSize(0) {}
+    AllocatedSize& operator+=(const AllocatedSize& rhs) {
+        allocatedSize += rhs.allocatedSize;
+        physicalAllocatedSize += rhs.physicalAllocatedSize;
+        return *this;
+    }
+    // 减到0为止，不会回绕
+    AllocatedSize& operator-=(const AllocatedSize& rhs) {
+        allocatedSize -= std::min(allocatedSize, rhs.allocatedSize);
+        physicalAllocatedSize -=
+            std::min(physicalAllocatedSize, rhs.physicalAllocatedSize);
+        return *this;
+    }
+};
+
 }  // namespace mds
 }  // namespace curve
 
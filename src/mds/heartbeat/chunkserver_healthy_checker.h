@@ -68,6 +68,14 @@ struct HeartbeatOption {
 
     // mdsStartTime: mds启动时间
     steady_clock::time_point mdsStartTime;
+
+    // shardNum: 心跳中的copyset按copyset分配到shardNum个分片并行处理,
+    // 为0时在rpc线程中串行处理
+    uint32_t shardNum = 0;
+
+    // shardQueueCapacity: 每个分片最多等待处理的copyset数量,
+    // 超过时拒绝心跳, chunkserver重新上报
+    uint32_t shardQueueCapacity = 0;
 };
 
 struct HeartbeatInfo {
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include "src/mds/heartbeat/chunkserver_report_cache.h"
+
+#include <utility>
+
+using ::curve::common::LockGuard;
+
+namespace curve {
+namespace mds {
+namespace heartbeat {
+
+std::shared_ptr<ChunkServerReportCache::Entry>
+ChunkServerReportCache::GetOrCreateEntry(ChunkServerIdType csId) {
+    LockGuard lk(mutex_);
+    auto &entry = entries_[csId];
+    if (entry == nullptr) {
+        entry = std::make_shared<Entry>();
+    }
+    return entry;
+}
+
+void ChunkServerReportCache::Reset(ChunkServerIdType csId, uint64_t seq,
+    CopysetReportMap reports) {
+    auto entry = GetOrCreateEntry(csId);
+    LockGuard lk(entry->mutex);
+    entry->hasFull = true;
+    entry->seq = seq;
+    entry->reports = std::move(reports);
+}
+
+bool ChunkServerReportCache::Merge(ChunkServerIdType csId, uint64_t seq,
+    CopysetReportMap delta) {
+    auto entry = GetOrCreateEntry(csId);
+    LockGuard lk(entry->mutex);
+    // 序号不连续时中间的增量心跳丢失，已有的记录不再完整，
+    // 仍然合并本次上报的信息，直到收到全量心跳
+    if (entry->hasFull && seq != entry->seq + 1) {
+        entry->hasFull = false;
+    }
+    entry->seq = seq;
+    for (auto &it : delta) {
+        entry->reports[it.first] = std::move(it.second);
+    }
+    return entry->hasFull;
+}
+
+void ChunkServerReportCache::ForEach(ChunkServerIdType csId,
+    const std::function<void(const CopySetKey&,
+                             const CopysetReport&)> &func) const {
+    std::shared_ptr<Entry> entry;
+    {
+        LockGuard lk(mutex_);
+        auto it = entries_.find(csId);
+        if (it == entries_.end()) {
+            return;
+        }
+        entry = it->second;
+    }
+    LockGuard lk(entry->mutex);
+    for (const auto &it : entry->reports) {
+        func(it.first, it.second);
+    }
+}
+
+void ChunkServerReportCache::Remove(ChunkServerIdType csId) {
+    LockGuard lk(mutex_);
+    entries_.erase(csId);
+}
+
+}  // namespace heartbeat
+}  // namespace mds
+}  // namespace curve
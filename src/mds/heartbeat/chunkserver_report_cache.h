@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_MDS_HEARTBEAT_CHUNKSERVER_REPORT_CACHE_H_
+#define SRC_MDS_HEARTBEAT_CHUNKSERVER_REPORT_CACHE_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+#include "proto/heartbeat.pb.h"
+#include "src/mds/topology/topology_item.h"
+#include "src/mds/topology/topology_stat.h"
+#include "src/common/concurrent/concurrent.h"
+
+namespace curve {
+namespace mds {
+namespace heartbeat {
+
+using ::curve::mds::topology::ChunkServerIdType;
+using ::curve::mds::topology::CopySetKey;
+using ::curve::mds::topology::CopysetStat;
+
+// chunkserver心跳中上报的单个copyset的信息
+struct CopysetReport {
+    // copyset的统计信息
+    CopysetStat stat;
+    // 是否已经转换为topology中的格式，
+    // 逻辑池不可用或者转换失败时为false，此时info无效
+    bool valid = false;
+    ::curve::mds::topology::CopySetInfo info;
+    // 配置变更信息
+    ConfigChangeInfo configChangeInfo;
+};
+
+using CopysetReportMap = std::map<CopySetKey, CopysetReport>;
+
+/**
+ * 记录每个chunkserver最近一次上报的所有copyset，用于处理增量心跳
+ * 1. 全量心跳替换chunkserver的所有记录
+ * 2. 增量心跳只包含变化的copyset，合并到已有记录中，
+ *    未变化的copyset使用记录中的信息生成配置和统计
+ * 3. 通过心跳序号检查增量心跳是否连续，没有全量记录或者序号不连续时
+ *    需要chunkserver重新发送全量心跳
+ * 同一个chunkserver的心跳是串行发送的，不同chunkserver的记录互不影响
+ */
+class ChunkServerReportCache {
+ public:
+    /**
+     * @brief 用全量心跳替换chunkserver的记录
+     *
+     * @param csId chunkserver id
+     * @param seq 心跳序号
+     * @param reports 心跳中的所有copyset
+     */
+    void Reset(ChunkServerIdType csId, uint64_t seq,
+               CopysetReportMap reports);
+
+    /**
+     * @brief 把增量心跳合并到chunkserver的记录中
+     *
+     * @param csId chunkserver id
+     * @param seq 心跳序号
+     * @param delta 增量心跳中的copyset
+     *
+     * @return 已有全量记录且序号连续时返回true，
+     *         否则返回false，需要chunkserver发送全量心跳
+     */
+    bool Merge(ChunkServerIdType csId, uint64_t seq,
+               CopysetReportMap delta);
+
+    /**
+     * @brief 遍历chunkserver记录中的所有copyset
+     *
+     * @param csId chunkserver id
+     * @param func 对每个copyset调用，遍历期间持有该chunkserver记录的锁
+     */
+    void ForEach(ChunkServerIdType csId,
+        const std::function<void(const CopySetKey&,
+                                 const CopysetReport&)> &func) const;
+
+    /**
+     * @brief 删除chunkserver的记录
+     */
+    void Remove(ChunkServerIdType csId);
+
+ private:
+    struct Entry {
+        // 是否有全量心跳作为基准
+        bool hasFull = false;
+        // 最近一次心跳的序号
+        uint64_t seq = 0;
+        CopysetReportMap reports;
+        mutable ::curve::common::Mutex mutex;
+    };
+
+    /**
+     * @brief 获取chunkserver的记录，不存在时创建
+     */
+    std::shared_ptr<Entry> GetOrCreateEntry(ChunkServerIdType csId);
+
+ private:
+    mutable ::curve::common::Mutex mutex_;
+    std::unordered_map<ChunkServerIdType, std::shared_ptr<Entry>> entries_;
+};
+
+}  // namespace heartbeat
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_HEARTBEAT_CHUNKSERVER_REPORT_CACHE_H_
@@ -56,6 +56,12 @@ HeartbeatManager::HeartbeatManager(HeartbeatOption option,
         std::make_shared<CopysetConfGenerator>(topology, coordinator,
             option.mdsStartTime, option.cleanFollowerAfterMs);
 
+    if (option.shardNum > 0) {
+        shardPool_ = std::make_shared<HeartbeatShardPool>(
+            option.shardNum, option.shardQueueCapacity,
+            topoUpdater_, copysetConfGenerator_);
+    }
+
     isStop_ = true;
     chunkserverHealthyCheckerRunInter_ = option.heartbeatMissTimeOutMs;
 }
@@ -75,6 +81,9 @@ void HeartbeatManager::Run() {
     if (isStop_.exchange(false)) {
         backEndThread_ =
             Thread(&HeartbeatManager::ChunkServerHealthyChecker, this);
+        if (shardPool_ != nullptr) {
+            shardPool_->Start();
+        }
     }
 }
 
@@ -83,6 +92,9 @@ void HeartbeatManager::Stop() {
         LOG(INFO) << "stop heartbeatManager...";
         sleeper_.interrupt();
         backEndThread_.join();
+        if (shardPool_ != nullptr) {
+            shardPool_->Stop();
+        }
         LOG(INFO) << "stop heartbeatManager ok.";
     } else {
         LOG(INFO) << "heartbeatManager not running.";
@@ -119,7 +131,8 @@ void HeartbeatManager::UpdateChunkServerDiskStatus(
 }
 
 void HeartbeatManager::UpdateChunkServerStatistics(
-    const ChunkServerHeartbeatRequest &request) {
+    const ChunkServerHeartbeatRequest &request,
+    const std::vector<CopysetStat> &copysetStats) {
     ChunkServerStat stat;
     stat.leaderCount = request.leadercount();
     stat.copysetCount = request.copysetcount();
@@ -132,46 +145,7 @@ void HeartbeatManager::UpdateChunkServerStatistics(
         stat.chunkSizeUsedBytes = request.stats().chunksizeusedbytes();
         stat.chunkSizeLeftBytes = request.stats().chunksizeleftbytes();
         stat.chunkSizeTrashedBytes = request.stats().chunksizetrashedbytes();
-
-        for (int i = 0; i < request.copysetinfos_size(); i++) {
-            CopysetStat cstat;
-            cstat.logicalPoolId = request.copysetinfos(i).logicalpoolid();
-            cstat.copysetId = request.copysetinfos(i).copysetid();
-
-            // TODO(xuchaojie) : 后续支持新的协议之后可直接使用id
-            std::string leaderPeer =
-                request.copysetinfos(i).leaderpeer().address();
-            std::string leaderIp;
-            uint32_t leaderPort;
-            if (SplitPeerId(leaderPeer, &leaderIp, &leaderPort)) {
-                cstat.leader =
-                    topology_->FindChunkServerNotRetired(
-                    leaderIp, leaderPort);
-                if (UNINTIALIZE_ID == cstat.leader) {
-                    LOG(INFO) << "hearbeat receive from chunkserver(id:"
-                        << request.chunkserverid()
-                        << ",ip:"<< request.ip() << ",port:" << request.port()
-                        << "), in which copyset(" << cstat.logicalPoolId
-                        << "," << cstat.copysetId << ") dose not have leader.";
-                }
-            } else {
-                LOG(ERROR) << "hearbeat failed on SplitPeerId, "
-                           << "peerId string = " << leaderPeer;
-            }
-            if (request.copysetinfos(i).has_stats()) {
-                cstat.readRate = request.copysetinfos(i).stats().readrate();
-                cstat.writeRate = request.copysetinfos(i).stats().writerate();
-                cstat.readIOPS = request.copysetinfos(i).stats().readiops();
-                cstat.writeIOPS = request.copysetinfos(i).stats().writeiops();
-            } else {
-                LOG(WARNING) << "hearbeat manager receive request "
-                             << "copyset {" << cstat.logicalPoolId
-                             << ", " << cstat.copysetId << "} "
-                             << "do not have CopysetStatistics";
-            }
-            stat.copysetStats.push_back(cstat);
-        }
-
+        stat.copysetStats = copysetStats;
     } else {
         LOG(WARNING) << "hearbeat manager receive request "
                      << "do not have ChunkServerStatisticInfo";
@@ -179,6 +153,60 @@ void HeartbeatManager::UpdateChunkServerStatistics(
     topologyStat_->UpdateChunkServerStat(request.chunkserverid(), stat);
 }
 
+CopysetStat HeartbeatManager::GetCopysetStat(
+    const ChunkServerHeartbeatRequest &request,
+    const ::curve::mds::heartbeat::CopySetInfo &info) {
+    CopysetStat cstat;
+    cstat.logicalPoolId = info.logicalpoolid();
+    cstat.copysetId = info.copysetid();
+
+    // TODO(xuchaojie) : 后续支持新的协议之后可直接使用id
+    std::string leaderPeer = info.leaderpeer().address();
+    std::string leaderIp;
+    uint32_t leaderPort;
+    if (SplitPeerId(leaderPeer, &leaderIp, &leaderPort)) {
+        cstat.leader =
+            topology_->FindChunkServerNotRetired(leaderIp, leaderPort);
+        if (UNINTIALIZE_ID == cstat.leader) {
+            LOG(INFO) << "hearbeat receive from chunkserver(id:"
+                << request.chunkserverid()
+                << ",ip:"<< request.ip() << ",port:" << request.port()
+                << "), in which copyset(" << cstat.logicalPoolId
+                << "," << cstat.copysetId << ") dose not have leader.";
+        }
+    } else {
+        LOG(ERROR) << "hearbeat failed on SplitPeerId, "
+                   << "peerId string = " << leaderPeer;
+    }
+    if (info.has_stats()) {
+        cstat.readRate = info.stats().readrate();
+        cstat.writeRate = info.stats().writerate();
+        cstat.readIOPS = info.stats().readiops();
+        cstat.writeIOPS = info.stats().writeiops();
+    } else {
+        LOG(WARNING) << "hearbeat manager receive request "
+                     << "copyset {" << cstat.logicalPoolId
+                     << ", " << cstat.copysetId << "} "
+                     << "do not have CopysetStatistics";
+    }
+    return cstat;
+}
+
+bool HeartbeatManager::IsLogicalPoolAvailable(PoolIdType poolId,
+    std::map<PoolIdType, bool> *checked) {
+    auto it = checked->find(poolId);
+    if (it != checked->end()) {
+        return it->second;
+    }
+    bool available = true;
+    ::curve::mds::topology::LogicalPool lPool;
+    if (topology_->GetLogicalPool(poolId, &lPool)) {
+        available = lPool.GetLogicalPoolAvaliableFlag();
+    }
+    checked->emplace(poolId, available);
+    return available;
+}
+
 void HeartbeatManager::ChunkServerHeartbeat(
     const ChunkServerHeartbeatRequest &request,
     ChunkServerHeartbeatResponse *response) {
@@ -188,6 +216,10 @@ void HeartbeatManager::ChunkServerHeartbeat(
     if (ret != HeartbeatStatusCode::hbOK) {
         LOG(ERROR) << "heartbeatManager get error request";
         response->set_statuscode(ret);
+        if (ret == HeartbeatStatusCode::hbChunkserverUnknown ||
+            ret == HeartbeatStatusCode::hbChunkserverRetired) {
+            reportCache_.Remove(request.chunkserverid());
+        }
         return;
     }
 
@@ -203,22 +235,47 @@ void HeartbeatManager::ChunkServerHeartbeat(
 
     UpdateChunkServerDiskStatus(request);
 
-    UpdateChunkServerStatistics(request);
+    ChunkServerIdType csId = request.chunkserverid();
+    bool isDelta = request.isdelta();
+    CopysetReportMap reports;
+    std::vector<CopysetStat> copysetStats;
+    for (auto &value : request.copysetinfos()) {
+        CopysetReport &report =
+            reports[CopySetKey(value.logicalpoolid(), value.copysetid())];
+        report.configChangeInfo = value.configchangeinfo();
+        if (request.has_stats()) {
+            report.stat = GetCopysetStat(request, value);
+            copysetStats.push_back(report.stat);
+        }
+    }
+    // 增量心跳中未上报的copyset使用上一次上报的统计数据
+    if (isDelta && request.has_stats()) {
+        reportCache_.ForEach(csId,
+            [&](const CopySetKey &key, const CopysetReport &report) {
+                if (reports.count(key) == 0) {
+                    copysetStats.push_back(report.stat);
+                }
+            });
+    }
+    UpdateChunkServerStatistics(request, copysetStats);
+
     // request里面没有copyset信息
-    if (request.copysetinfos_size() == 0) {
+    if (!isDelta && request.copysetinfos_size() == 0) {
         response->set_statuscode(HeartbeatStatusCode::hbRequestNoCopyset);
     }
     // 处理心跳中的copyset
+    std::map<PoolIdType, bool> checkedPools;
+    std::vector<CopysetTask> tasks;
+    tasks.reserve(request.copysetinfos_size());
     for (auto &value : request.copysetinfos()) {
         // 逻辑池不可用时，不处理该逻辑池的copyset信息
-        ::curve::mds::topology::LogicalPool lPool;
-        if (topology_->GetLogicalPool(value.logicalpoolid(), &lPool)) {
-            if (lPool.GetLogicalPoolAvaliableFlag() != true) {
-                continue;
-            }
+        if (!IsLogicalPoolAvailable(value.logicalpoolid(), &checkedPools)) {
+            continue;
         }
         // heartbeat中copysetInfo格式转化为topology的格式
-        ::curve::mds::topology::CopySetInfo reportCopySetInfo;
+        CopysetReport &report =
+            reports[CopySetKey(value.logicalpoolid(), value.copysetid())];
+        ::curve::mds::topology::CopySetInfo &reportCopySetInfo = report.info;
         if (!FromHeartbeatCopySetInfoToTopologyOne(value,
                 &reportCopySetInfo)) {
             LOG(ERROR) << "heartbeatManager receive copyset("
@@ -229,22 +286,84 @@ void HeartbeatManager::ChunkServerHeartbeat(
                             HeartbeatStatusCode::hbAnalyseCopysetError);
             continue;
         }
+        report.valid = true;
+
+        CopysetTask task;
+        task.csId = csId;
+        task.report = &report;
+        // 如果是leader, 根据leader上报的信息更新topology
+        task.updateTopo = (csId == reportCopySetInfo.GetLeader());
+        tasks.emplace_back(std::move(task));
+    }
+
+    // 增量心跳中未上报的copyset没有变化，topology中已经是最新的信息，
+    // 只需要检查是否有配置需要下发
+    CopysetReportMap unchanged;
+    if (isDelta) {
+        reportCache_.ForEach(csId,
+            [&](const CopySetKey &key, const CopysetReport &report) {
+                if (!report.valid || reports.count(key) > 0 ||
+                    !IsLogicalPoolAvailable(key.first, &checkedPools)) {
+                    return;
+                }
+                unchanged.emplace(key, report);
+            });
+        for (const auto &it : unchanged) {
+            CopysetTask task;
+            task.csId = csId;
+            task.report = &it.second;
+            tasks.emplace_back(std::move(task));
+        }
+    }
 
-        // 把上报的copyset的信息转发到CopysetConfGenerator模块处理
-        CopySetConf conf;
-        ConfigChangeInfo configChInfo;
-        if (copysetConfGenerator_->GenCopysetConf(
-                request.chunkserverid(), reportCopySetInfo,
-                value.configchangeinfo(), &conf)) {
+    // 把copyset的信息转发到CopysetConfGenerator模块处理
+    if (!ProcessCopysetTasks(&tasks)) {
+        LOG(WARNING) << "heartbeatManager receive heartbeat from"
+                     << " chunkserver: " << csId << " with "
+                     << tasks.size() << " copysets, but shard queue is full";
+        response->set_statuscode(HeartbeatStatusCode::hbMdsBusy);
+        return;
+    }
+    for (const auto &task : tasks) {
+        if (task.hasConf) {
             CopySetConf *res = response->add_needupdatecopysets();
-            *res = conf;
+            *res = task.conf;
+        }
+    }
+
+    if (!isDelta) {
+        // 只有开启增量心跳的chunkserver才设置心跳序号，需要记录全量信息
+        if (request.has_heartbeatseq()) {
+            reportCache_.Reset(
+                csId, request.heartbeatseq(), std::move(reports));
         }
+        return;
+    }
 
-        // 如果是leader, 根据leader上报的信息
-        if (request.chunkserverid() == reportCopySetInfo.GetLeader()) {
-            topoUpdater_->UpdateTopo(reportCopySetInfo);
+    if (!reportCache_.Merge(csId, request.heartbeatseq(), std::move(reports))) {
+        LOG(INFO) << "heartbeatManager receive delta heartbeat from"
+                  << " chunkserver: " << csId << ", seq: "
+                  << request.heartbeatseq()
+                  << ", but no full report or seq not continuous,"
+                  << " need full heartbeat";
+        response->set_needfullheartbeat(true);
+    }
+}
+
+bool HeartbeatManager::ProcessCopysetTasks(
+    std::vector<CopysetTask> *tasks) {
+    if (shardPool_ != nullptr) {
+        return shardPool_->Process(tasks);
+    }
+
+    for (auto &task : *tasks) {
+        task.hasConf = copysetConfGenerator_->GenCopysetConf(task.csId,
+            task.report->info, task.report->configChangeInfo, &task.conf);
+        if (task.updateTopo) {
+            topoUpdater_->UpdateTopo(task.report->info);
         }
     }
+    return true;
 }
 
 HeartbeatStatusCode HeartbeatManager::CheckRequest(
@@ -34,6 +34,8 @@
 #include "src/mds/heartbeat/topo_updater.h"
 #include "src/mds/heartbeat/copyset_conf_generator.h"
 #include "src/mds/heartbeat/chunkserver_healthy_checker.h"
+#include "src/mds/heartbeat/chunkserver_report_cache.h"
+#include "src/mds/heartbeat/heartbeat_shard_pool.h"
 #include "src/mds/schedule/coordinator.h"
 #include "src/common/concurrent/concurrent.h"
 #include "src/common/interruptible_sleeper.h"
@@ -45,6 +47,7 @@ using ::curve::mds::topology::PoolIdType;
 using ::curve::mds::topology::CopySetIdType;
 using ::curve::mds::topology::Topology;
 using ::curve::mds::topology::TopologyStat;
+using ::curve::mds::topology::CopysetStat;
 using ::curve::mds::schedule::Coordinator;
 
 using ::curve::common::Thread;
@@ -66,6 +69,9 @@ namespace heartbeat {
 // 2. 更新topology信息。
 //    - 根据chunkserver上报的copyset的信息，更新topology中copyset的epoch,
 //      副本关系, 统计信息等
+// 增量心跳只包含发生变化的copyset, 只对这些copyset更新topology,
+// 未上报的copyset使用上一次上报的信息下发配置和更新统计
+// 开启分片处理时, 3和2由HeartbeatShardPool按copyset分片并行处理
 class HeartbeatManager {
  public:
     HeartbeatManager(HeartbeatOption option,
@@ -116,10 +122,43 @@ class HeartbeatManager {
      * @brief 更新chunkserver统计数据
      *
      * @param request 请求报文
-     * @param response 回复报文
+     * @param copysetStats chunkserver上所有copyset的统计数据，
+     *        增量心跳中未上报的copyset使用上一次上报的数据
      */
     void UpdateChunkServerStatistics(
-        const ChunkServerHeartbeatRequest &request);
+        const ChunkServerHeartbeatRequest &request,
+        const std::vector<CopysetStat> &copysetStats);
+
+    /**
+     * @brief 从心跳上报的copyset信息中获取copyset的统计数据
+     *
+     * @param request 请求报文
+     * @param info 心跳上报的copyset信息
+     *
+     * @return copyset的统计数据
+     */
+    CopysetStat GetCopysetStat(const ChunkServerHeartbeatRequest &request,
+        const ::curve::mds::heartbeat::CopySetInfo &info);
+
+    /**
+     * @brief 逻辑池是否可用，topology中不存在的逻辑池视为可用
+     *
+     * @param poolId 逻辑池id
+     * @param[in,out] checked 本次心跳中已经查询过的逻辑池
+     *
+     * @return 可用返回true, 否则返回false
+     */
+    bool IsLogicalPoolAvailable(PoolIdType poolId,
+        std::map<PoolIdType, bool> *checked);
+
+    /**
+     * @brief 处理心跳中的copyset, 生成需要下发的配置并更新topology
+     *
+     * @param[in,out] tasks 心跳中的copyset任务
+     *
+     * @return 处理完成返回true, 分片队列已满时返回false
+     */
+    bool ProcessCopysetTasks(std::vector<CopysetTask> *tasks);
 
     /**
      * @brief ChunkServerHealthyChecker 心跳超时检查后端线程
@@ -173,6 +212,10 @@ class HeartbeatManager {
     // 2. leader copyset
     // 3. copyset的最新复制组中不包含该chunkserver
     std::shared_ptr<CopysetConfGenerator> copysetConfGenerator_;
+    // reportCache_ 记录chunkserver最近一次上报的copyset, 用于处理增量心跳
+    ChunkServerReportCache reportCache_;
+    // shardPool_ 按copyset分片并行处理心跳中的copyset, 未开启时为nullptr
+    std::shared_ptr<HeartbeatShardPool> shardPool_;
 
     // 管理chunkserverHealthyChecker线程
     Thread backEndThread_;
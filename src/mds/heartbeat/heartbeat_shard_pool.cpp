@@ -0,0 +1,206 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include "src/mds/heartbeat/heartbeat_shard_pool.h"
+
+#include <glog/logging.h>
+
+#include <functional>
+#include <utility>
+
+using ::curve::common::LockGuard;
+using ::curve::common::UniqueLock;
+using ::curve::common::CountDownEvent;
+using std::chrono::steady_clock;
+
+namespace curve {
+namespace mds {
+namespace heartbeat {
+
+HeartbeatShardPool::HeartbeatShardPool(uint32_t shardNum,
+    uint32_t queueCapacity,
+    std::shared_ptr<TopoUpdater> topoUpdater,
+    std::shared_ptr<CopysetConfGenerator> copysetConfGenerator)
+    : queueCapacity_(queueCapacity),
+      topoUpdater_(topoUpdater),
+      copysetConfGenerator_(copysetConfGenerator) {
+    for (uint32_t i = 0; i < shardNum; ++i) {
+        shards_.emplace_back(new Shard());
+    }
+    isStop_ = true;
+}
+
+void HeartbeatShardPool::Start() {
+    if (isStop_.exchange(false)) {
+        for (auto &shard : shards_) {
+            shard->thread = ::curve::common::Thread(
+                &HeartbeatShardPool::ShardWorker, this, shard.get());
+        }
+        LOG(INFO) << "start heartbeat shard pool, shard num: "
+                  << shards_.size() << ", queue capacity: "
+                  << queueCapacity_;
+    }
+}
+
+void HeartbeatShardPool::Stop() {
+    if (!isStop_.exchange(true)) {
+        LOG(INFO) << "stop heartbeat shard pool...";
+        for (auto &shard : shards_) {
+            {
+                LockGuard lk(shard->mutex);
+                shard->cond.notify_all();
+            }
+            shard->thread.join();
+        }
+        LOG(INFO) << "stop heartbeat shard pool ok.";
+    }
+}
+
+uint32_t HeartbeatShardPool::GetShardIndex(const CopySetKey &key) const {
+    uint64_t hash = (static_cast<uint64_t>(key.first) << 32) | key.second;
+    return std::hash<uint64_t>()(hash) % shards_.size();
+}
+
+bool HeartbeatShardPool::Process(std::vector<CopysetTask> *tasks) {
+    if (tasks->empty()) {
+        return true;
+    }
+    if (shards_.empty()) {
+        return false;
+    }
+
+    std::vector<std::vector<CopysetTask*>> shardTasks(shards_.size());
+    for (auto &task : *tasks) {
+        CopySetKey key = task.report->info.GetCopySetKey();
+        shardTasks[GetShardIndex(key)].push_back(&task);
+    }
+
+    // 先在所有分片中预留队列空间，任意一个分片放不下时全部回退，
+    // 保证一次心跳要么全部处理，要么全部不处理
+    uint32_t reserved = 0;
+    bool ok = true;
+    for (; reserved < shards_.size(); ++reserved) {
+        uint32_t num = shardTasks[reserved].size();
+        if (num == 0) {
+            continue;
+        }
+        Shard *shard = shards_[reserved].get();
+        LockGuard lk(shard->mutex);
+        if (isStop_ || shard->pending + num > queueCapacity_) {
+            ok = false;
+            break;
+        }
+        shard->pending += num;
+    }
+    if (!ok) {
+        for (uint32_t i = 0; i < reserved; ++i) {
+            uint32_t num = shardTasks[i].size();
+            if (num == 0) {
+                continue;
+            }
+            Shard *shard = shards_[i].get();
+            LockGuard lk(shard->mutex);
+            shard->pending -= num;
+            shard->cond.notify_all();
+        }
+        metrics_.rejectCount << 1;
+        return false;
+    }
+
+    uint32_t batchNum = 0;
+    for (const auto &it : shardTasks) {
+        if (!it.empty()) {
+            batchNum++;
+        }
+    }
+    CountDownEvent done(batchNum);
+    steady_clock::time_point now = steady_clock::now();
+    metrics_.pendingCopysets << tasks->size();
+    for (uint32_t i = 0; i < shards_.size(); ++i) {
+        if (shardTasks[i].empty()) {
+            continue;
+        }
+        Batch batch;
+        batch.tasks = std::move(shardTasks[i]);
+        batch.done = &done;
+        batch.enqueueTime = now;
+        Shard *shard = shards_[i].get();
+        LockGuard lk(shard->mutex);
+        shard->queue.emplace_back(std::move(batch));
+        shard->cond.notify_one();
+    }
+    done.Wait();
+    return true;
+}
+
+void HeartbeatShardPool::ShardWorker(Shard *shard) {
+    std::deque<Batch> batches;
+    std::vector<::curve::mds::topology::CopySetInfo> updates;
+    while (true) {
+        {
+            UniqueLock lk(shard->mutex);
+            // 停止时需要等待已经预留空间的任务全部处理完成
+            shard->cond.wait(lk, [&] {
+                return !shard->queue.empty() ||
+                    (isStop_ && shard->pending == 0);
+            });
+            if (shard->queue.empty()) {
+                return;
+            }
+            batches.swap(shard->queue);
+        }
+
+        // 先逐个生成需要下发的配置，再合并更新topology
+        uint32_t num = 0;
+        steady_clock::time_point now = steady_clock::now();
+        for (auto &batch : batches) {
+            metrics_.queueDelay <<
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    now - batch.enqueueTime).count();
+            for (CopysetTask *task : batch.tasks) {
+                task->hasConf = copysetConfGenerator_->GenCopysetConf(
+                    task->csId, task->report->info,
+                    task->report->configChangeInfo, &task->conf);
+                if (task->updateTopo) {
+                    updates.emplace_back(task->report->info);
+                }
+            }
+            num += batch.tasks.size();
+        }
+        if (!updates.empty()) {
+            topoUpdater_->UpdateTopo(updates);
+            updates.clear();
+        }
+
+        {
+            LockGuard lk(shard->mutex);
+            shard->pending -= num;
+        }
+        metrics_.pendingCopysets << -static_cast<int64_t>(num);
+        for (auto &batch : batches) {
+            batch.done->Signal();
+        }
+        batches.clear();
+    }
+}
+
+}  // namespace heartbeat
+}  // namespace mds
+}  // namespace curve
@@ -0,0 +1,162 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_MDS_HEARTBEAT_HEARTBEAT_SHARD_POOL_H_
+#define SRC_MDS_HEARTBEAT_HEARTBEAT_SHARD_POOL_H_
+
+#include <bvar/bvar.h>
+
+#include <chrono>  //NOLINT
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "proto/heartbeat.pb.h"
+#include "src/mds/heartbeat/chunkserver_report_cache.h"
+#include "src/mds/heartbeat/copyset_conf_generator.h"
+#include "src/mds/heartbeat/topo_updater.h"
+#include "src/common/concurrent/concurrent.h"
+
+namespace curve {
+namespace mds {
+namespace heartbeat {
+
+// 心跳中单个copyset的处理任务
+struct CopysetTask {
+    // 上报心跳的chunkserver
+    ChunkServerIdType csId = 0;
+    // 上报的copyset信息，处理完成之前需要保证有效
+    const CopysetReport *report = nullptr;
+    // 上报的chunkserver是leader时需要根据上报信息更新topology
+    bool updateTopo = false;
+
+    // 处理结果，hasConf为true时conf为需要下发给chunkserver的配置
+    bool hasConf = false;
+    CopySetConf conf;
+};
+
+class HeartbeatShardMetrics {
+ public:
+    HeartbeatShardMetrics() :
+        queueDelay(HeartbeatShardMetricsPrefix, "queue_delay"),
+        pendingCopysets(HeartbeatShardMetricsPrefix, "pending_copysets"),
+        rejectCount(HeartbeatShardMetricsPrefix, "reject_count") {}
+
+ public:
+    const std::string HeartbeatShardMetricsPrefix =
+        "mds_heartbeat_shard_metric";
+
+    // copyset任务从入队到开始处理的时间，单位us
+    bvar::LatencyRecorder queueDelay;
+    // 所有分片中等待处理的copyset数量
+    bvar::Adder<int64_t> pendingCopysets;
+    // 分片队列已满被拒绝的心跳数量
+    bvar::Adder<uint64_t> rejectCount;
+};
+
+/**
+ * 心跳分片处理
+ * 1. 按copyset把心跳中的copyset分配到固定的分片，每个分片一个线程串行处理，
+ *    同一个copyset在不同chunkserver上的副本上报的信息由同一个分片处理
+ * 2. 分片线程每次取出队列中所有待处理的任务，先逐个生成需要下发的配置，
+ *    再把leader上报的信息合并为一次topology更新
+ * 3. 每个分片最多允许queueCapacity个copyset等待处理，任意一个分片放不下时
+ *    整个心跳都不处理，由调用方返回hbMdsBusy，chunkserver稍后重新上报
+ */
+class HeartbeatShardPool {
+ public:
+    /**
+     * @param shardNum 分片数量
+     * @param queueCapacity 每个分片最多等待处理的copyset数量
+     * @param topoUpdater 更新topology中copyset的信息
+     * @param copysetConfGenerator 生成需要下发给chunkserver的配置
+     */
+    HeartbeatShardPool(uint32_t shardNum, uint32_t queueCapacity,
+        std::shared_ptr<TopoUpdater> topoUpdater,
+        std::shared_ptr<CopysetConfGenerator> copysetConfGenerator);
+
+    ~HeartbeatShardPool() {
+        Stop();
+    }
+
+    /**
+     * @brief 启动所有分片线程
+     */
+    void Start();
+
+    /**
+     * @brief 停止所有分片线程，队列中已有的任务处理完成之后退出
+     */
+    void Stop();
+
+    /**
+     * @brief 把一次心跳的copyset任务分配到各分片，并等待全部处理完成
+     *
+     * @param[in,out] tasks 心跳中的copyset任务，处理结果填写在任务中
+     *
+     * @return 全部处理完成返回true；分片队列已满或者未启动时返回false，
+     *         此时所有任务都没有被处理
+     */
+    bool Process(std::vector<CopysetTask> *tasks);
+
+    /**
+     * @brief 计算copyset所属的分片
+     */
+    uint32_t GetShardIndex(const CopySetKey &key) const;
+
+ private:
+    // 一次心跳分配到同一个分片的任务
+    struct Batch {
+        std::vector<CopysetTask*> tasks;
+        ::curve::common::CountDownEvent *done;
+        std::chrono::steady_clock::time_point enqueueTime;
+    };
+
+    struct Shard {
+        ::curve::common::Mutex mutex;
+        ::curve::common::ConditionVariable cond;
+        std::deque<Batch> queue;
+        // 已预留队列空间还未处理完成的copyset数量
+        uint32_t pending = 0;
+        ::curve::common::Thread thread;
+    };
+
+    /**
+     * @brief 分片线程，批量处理队列中的任务
+     */
+    void ShardWorker(Shard *shard);
+
+ private:
+    uint32_t queueCapacity_;
+    std::shared_ptr<TopoUpdater> topoUpdater_;
+    std::shared_ptr<CopysetConfGenerator> copysetConfGenerator_;
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    ::curve::common::Atomic<bool> isStop_;
+
+    HeartbeatShardMetrics metrics_;
+};
+
+}  // namespace heartbeat
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_HEARTBEAT_HEARTBEAT_SHARD_POOL_H_
@@ -21,12 +21,65 @@
  */
 
 #include <glog/logging.h>
+#include <map>
 #include "src/mds/heartbeat/topo_updater.h"
 
+using ::curve::mds::topology::CopySetKey;
+
 namespace curve {
 namespace mds {
 namespace heartbeat {
 void TopoUpdater::UpdateTopo(const CopySetInfo &reportCopySetInfo) {
+    if (!NeedUpdateTopo(reportCopySetInfo)) {
+        return;
+    }
+
+    // 更新到数据库和内存
+    int updateCode = topo_->UpdateCopySetTopo(reportCopySetInfo);
+    if (::curve::mds::topology::kTopoErrCodeSuccess != updateCode) {
+        LOG(ERROR) << "topoUpdater update copyset("
+                   << reportCopySetInfo.GetLogicalPoolId()
+                   << "," << reportCopySetInfo.GetId()
+                   << ") got error code: " << updateCode;
+    }
+}
+
+void TopoUpdater::UpdateTopo(
+    const std::vector<::curve::mds::topology::CopySetInfo>
+        &reportCopySetInfos) {
+    // 同一批次中同一个copyset可能有多个leader上报(如leader切换前后)，
+    // 只保留epoch最大的一个，epoch相同时保留后到的上报
+    std::vector<const CopySetInfo *> latest;
+    std::map<CopySetKey, size_t> index;
+    for (const auto &reportCopySetInfo : reportCopySetInfos) {
+        auto it = index.find(reportCopySetInfo.GetCopySetKey());
+        if (it == index.end()) {
+            index.emplace(reportCopySetInfo.GetCopySetKey(), latest.size());
+            latest.emplace_back(&reportCopySetInfo);
+        } else if (latest[it->second]->GetEpoch() <=
+            reportCopySetInfo.GetEpoch()) {
+            latest[it->second] = &reportCopySetInfo;
+        }
+    }
+
+    std::vector<CopySetInfo> needUpdate;
+    for (const CopySetInfo *reportCopySetInfo : latest) {
+        if (NeedUpdateTopo(*reportCopySetInfo)) {
+            needUpdate.emplace_back(*reportCopySetInfo);
+        }
+    }
+    if (needUpdate.empty()) {
+        return;
+    }
+
+    int updateCode = topo_->BatchUpdateCopySetTopo(needUpdate);
+    if (::curve::mds::topology::kTopoErrCodeSuccess != updateCode) {
+        LOG(ERROR) << "topoUpdater update " << needUpdate.size()
+                   << " copysets got error code: " << updateCode;
+    }
+}
+
+bool TopoUpdater::NeedUpdateTopo(const CopySetInfo &reportCopySetInfo) {
     CopySetInfo recordCopySetInfo;
     if (!topo_->GetCopySet(
         reportCopySetInfo.GetCopySetKey(), &recordCopySetInfo)) {
@@ -34,7 +87,7 @@ void TopoUpdater::UpdateTopo(const CopySetInfo &reportCopySetInfo) {
                    << reportCopySetInfo.GetLogicalPoolId()
                    << "," << reportCopySetInfo.GetId()
                    << ") information, but can not get info from topology";
-        return;
+        return false;
     }
 
     // 比较report epoch 和 mds record epoch的大小，有如下三种情况:
@@ -78,7 +131,7 @@ void TopoUpdater::UpdateTopo(const CopySetInfo &reportCopySetInfo) {
                        << recordCopySetInfo.GetCopySetMembersStr()
                        << ", but epoch is same: "
                        << recordCopySetInfo.GetEpoch();
-            return;
+            return false;
         }
 
         // report的信息中不含有变更项
@@ -118,25 +171,15 @@ void TopoUpdater::UpdateTopo(const CopySetInfo &reportCopySetInfo) {
                    << "), record epoch:" << recordCopySetInfo.GetEpoch()
                    << " bigger than report epoch:"
                    << reportCopySetInfo.GetEpoch();
-        return;
+        return false;
     }
 
-    // 更新到数据库和内存
     if (needUpdate) {
         LOG(INFO) << "topoUpdater find copyset("
                   << reportCopySetInfo.GetLogicalPoolId() << ","
                   << reportCopySetInfo.GetId() << ") need to update";
-
-        int updateCode =
-            topo_->UpdateCopySetTopo(reportCopySetInfo);
-        if (::curve::mds::topology::kTopoErrCodeSuccess != updateCode) {
-            LOG(ERROR) << "topoUpdater update copyset("
-                       << reportCopySetInfo.GetLogicalPoolId()
-                       << "," << reportCopySetInfo.GetId()
-                       << ") got error code: " << updateCode;
-            return;
-        }
     }
+    return needUpdate;
 }
 }  // namespace heartbeat
 }  // namespace mds
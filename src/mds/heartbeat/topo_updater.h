@@ -24,6 +24,7 @@
 #define SRC_MDS_HEARTBEAT_TOPO_UPDATER_H_
 
 #include <memory>
+#include <vector>
 #include "src/mds/topology/topology_item.h"
 #include "src/mds/topology/topology.h"
 
@@ -43,9 +44,31 @@ class TopoUpdater {
     *                    epoch, 副本关系， 统计信息等; leader copyset调用
     * @param[in] reportCopySetInfo chunkserver上报的copyset信息
     */
-    void UpdateTopo(const CopySetInfo &reportCopySetInfo);
+    void UpdateTopo(
+        const ::curve::mds::topology::CopySetInfo &reportCopySetInfo);
+
+    /*
+    * @brief UpdateTopo 批量更新多个leader copyset上报的信息，
+    *                    需要更新的copyset合并为一次topology更新，
+    *                    同一个copyset只使用epoch最大的上报
+    * @param[in] reportCopySetInfos chunkserver上报的copyset信息
+    */
+    void UpdateTopo(
+        const std::vector<::curve::mds::topology::CopySetInfo>
+            &reportCopySetInfos);
 
  private:
+    /*
+    * @brief NeedUpdateTopo 比较上报的信息和topology中的记录，
+    *                        判断是否需要更新topology
+    * @param[in] reportCopySetInfo chunkserver上报的copyset信息
+    *
+    * @return 需要更新返回true, 否则返回false
+    */
+    bool NeedUpdateTopo(
+        const ::curve::mds::topology::CopySetInfo &reportCopySetInfo);
+
+
     std::shared_ptr<Topology> topo_;
 };
 }  // namespace heartbeat
@@ -0,0 +1,251 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include "src/mds/nameserver2/alloc_size_counter.h"
+
+#include <glog/logging.h>
+
+using ::curve::common::LockGuard;
+
+namespace curve {
+namespace mds {
+
+bool AllocSizeCounter::Init() {
+    std::map<InodeID, AllocatedSize> sizes;
+    auto ret = storage_->LoadAllocSize(&sizes);
+    if (ret != StoreStatus::OK) {
+        LOG(ERROR) << "load alloc size fail, ret = " << ret;
+        return false;
+    }
+
+    bool clean = false;
+    size_t count = 0;
+    ret = storage_->GetAllocSizeState(&clean);
+    if (ret != StoreStatus::OK && ret != StoreStatus::KeyNotExist) {
+        LOG(ERROR) << "get alloc size state fail, ret = " << ret;
+        return false;
+    }
+
+    {
+        LockGuard lk(lock_);
+        sizes_.clear();
+        dirty_.clear();
+        if (ret == StoreStatus::OK && clean) {
+            sizes_.swap(sizes);
+        } else {
+            // 上次没有正常退出，部分增量可能没有持久化，
+            // 丢弃加载的计数并由后台线程从etcd中删除
+            for (const auto &item : sizes) {
+                dirty_.insert(item.first);
+            }
+            LOG_IF(WARNING, !sizes.empty())
+                << "alloc size is not persisted completely last time, "
+                << "drop " << sizes.size() << " alloc size";
+        }
+        count = sizes_.size();
+    }
+
+    // 正常退出前一直标记为未持久化完成
+    ret = storage_->PutAllocSizeState(false);
+    if (ret != StoreStatus::OK) {
+        LOG(ERROR) << "put alloc size state fail, ret = " << ret;
+        return false;
+    }
+
+    LOG(INFO) << "load alloc size success, count = " << count;
+    return true;
+}
+
+void AllocSizeCounter::Run() {
+    stop_.store(false);
+    persistThread_ = ::curve::common::Thread(
+        &AllocSizeCounter::PeriodicPersist, this);
+}
+
+void AllocSizeCounter::Stop() {
+    if (!stop_.exchange(true)) {
+        LOG(INFO) << "start stop AllocSizeCounter...";
+        sleeper_.interrupt();
+        persistThread_.join();
+
+        // 全部计数持久化成功后才标记为正常退出
+        if (Flush() &&
+            storage_->PutAllocSizeState(true) == StoreStatus::OK) {
+            LOG(INFO) << "stop AllocSizeCounter ok!";
+        } else {
+            LOG(WARNING) << "stop AllocSizeCounter, "
+                         << "alloc size is not persisted completely";
+        }
+    }
+}
+
+bool AllocSizeCounter::Get(InodeID id, AllocatedSize *allocSize) {
+    LockGuard lk(lock_);
+    auto it = sizes_.find(id);
+    if (it == sizes_.end()) {
+        return false;
+    }
+    *allocSize = it->second;
+    return true;
+}
+
+uint64_t AllocSizeCounter::BeginBuild(InodeID id) {
+    LockGuard lk(lock_);
+    BuildState &state = building_[id];
+    state.refs++;
+    uint64_t generation = state.generation;
+    // 有进行中的增量更新时，统计可能读到更新前或更新后的元数据，结果无效
+    if (updating_.find(id) != updating_.end()) {
+        state.generation++;
+    }
+    return generation;
+}
+
+bool AllocSizeCounter::EndBuild(InodeID id, uint64_t generation,
+                                const AllocatedSize &allocSize,
+                                bool record) {
+    LockGuard lk(lock_);
+    auto it = building_.find(id);
+    if (it == building_.end()) {
+        return false;
+    }
+
+    bool valid = record && it->second.generation == generation;
+    if (--it->second.refs == 0) {
+        building_.erase(it);
+    }
+    if (!valid) {
+        return false;
+    }
+    sizes_[id] = allocSize;
+    dirty_.insert(id);
+    return true;
+}
+
+void AllocSizeCounter::BeginUpdate(const std::vector<InodeID> &ids) {
+    LockGuard lk(lock_);
+    for (auto id : ids) {
+        updating_[id]++;
+        InvalidateBuildLocked(id);
+    }
+}
+
+void AllocSizeCounter::EndUpdate(const std::vector<InodeID> &ids) {
+    LockGuard lk(lock_);
+    for (auto id : ids) {
+        auto it = updating_.find(id);
+        if (it != updating_.end() && --it->second == 0) {
+            updating_.erase(it);
+        }
+    }
+}
+
+void AllocSizeCounter::Add(const std::vector<InodeID> &ids,
+                           const AllocatedSize &delta) {
+    Update(ids, delta, true);
+}
+
+void AllocSizeCounter::Sub(const std::vector<InodeID> &ids,
+                           const AllocatedSize &delta) {
+    Update(ids, delta, false);
+}
+
+void AllocSizeCounter::Invalidate(const std::vector<InodeID> &ids) {
+    LockGuard lk(lock_);
+    for (auto id : ids) {
+        if (sizes_.erase(id) > 0) {
+            dirty_.insert(id);
+        }
+        InvalidateBuildLocked(id);
+    }
+}
+
+void AllocSizeCounter::Update(const std::vector<InodeID> &ids,
+                              const AllocatedSize &delta, bool add) {
+    LockGuard lk(lock_);
+    for (auto id : ids) {
+        auto it = sizes_.find(id);
+        if (it == sizes_.end()) {
+            continue;
+        }
+
+        if (add) {
+            it->second += delta;
+        } else {
+            it->second -= delta;
+        }
+        dirty_.insert(id);
+    }
+}
+
+bool AllocSizeCounter::Flush() {
+    std::map<InodeID, AllocatedSize> puts;
+    std::vector<InodeID> deletes;
+    {
+        LockGuard lk(lock_);
+        for (auto id : dirty_) {
+            auto it = sizes_.find(id);
+            if (it != sizes_.end()) {
+                puts[id] = it->second;
+            } else {
+                deletes.push_back(id);
+            }
+        }
+        dirty_.clear();
+    }
+
+    // 持久化期间有变化的inode会再次被标记，下一轮持久化最新的值
+    std::vector<InodeID> failed;
+    for (const auto &item : puts) {
+        if (storage_->PutAllocSize(item.first, item.second)
+            != StoreStatus::OK) {
+            failed.push_back(item.first);
+        }
+    }
+    for (auto id : deletes) {
+        if (storage_->DeleteAllocSize(id) != StoreStatus::OK) {
+            failed.push_back(id);
+        }
+    }
+
+    if (!failed.empty()) {
+        LOG(WARNING) << "persist alloc size fail, count = " << failed.size();
+        LockGuard lk(lock_);
+        dirty_.insert(failed.begin(), failed.end());
+        return false;
+    }
+    return true;
+}
+
+void AllocSizeCounter::InvalidateBuildLocked(InodeID id) {
+    auto it = building_.find(id);
+    if (it != building_.end()) {
+        it->second.generation++;
+    }
+}
+
+void AllocSizeCounter::PeriodicPersist() {
+    while (sleeper_.wait_for(std::chrono::milliseconds(persistIntervalMs_))) {
+        Flush();
+    }
+}
+
+}  // namespace mds
+}  // namespace curve
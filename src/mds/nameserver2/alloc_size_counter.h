@@ -0,0 +1,222 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_MDS_NAMESERVER2_ALLOC_SIZE_COUNTER_H_
+#define SRC_MDS_NAMESERVER2_ALLOC_SIZE_COUNTER_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/interruptible_sleeper.h"
+#include "src/mds/common/mds_define.h"
+#include "src/mds/nameserver2/namespace_storage.h"
+
+namespace curve {
+namespace mds {
+
+/**
+ * 文件和目录的分配大小计数，目录的分配大小为其下所有文件之和
+ * 1. 启动时从etcd加载全部计数，查询时直接返回，不再遍历目录和segment
+ * 2. 分配、回收segment以及文件rename、移入回收站时，
+ *    对文件及其所有祖先目录的计数增量更新，只修改内存
+ * 3. 没有记录的inode不做增量更新，首次查询时由调用方统计后记录，
+ *    统计不加全局锁，期间有增量更新的inode不记录统计结果
+ * 4. 后台线程定期持久化有变化的计数，持久化失败的计数下一轮重试
+ * 5. 正常退出时持久化全部计数并标记，mds异常退出后etcd中的计数
+ *    可能缺少部分增量，重新加载时全部丢弃，下次查询时重新统计
+ */
+class AllocSizeCounter {
+ public:
+    /**
+     * @param storage 存储计数的NameServerStorage
+     * @param persistIntervalMs 定期持久化计数的间隔
+     */
+    AllocSizeCounter(std::shared_ptr<NameServerStorage> storage,
+                     uint64_t persistIntervalMs)
+        : storage_(storage),
+          persistIntervalMs_(persistIntervalMs),
+          stop_(true) {}
+
+    ~AllocSizeCounter() {
+        Stop();
+    }
+
+    /**
+     * @brief 从存储中加载所有计数，上次没有正常退出时丢弃加载的计数
+     *
+     * @return 成功返回true，失败返回false
+     */
+    bool Init();
+
+    /**
+     * @brief 启动定期持久化计数的后台线程
+     */
+    void Run();
+
+    /**
+     * @brief 停止后台线程，持久化全部计数并标记为正常退出
+     */
+    void Stop();
+
+    /**
+     * @brief 获取文件或目录的分配大小
+     *
+     * @param id 文件或目录的inode id
+     * @param[out] allocSize 分配大小
+     *
+     * @return 有记录返回true，没有记录返回false
+     */
+    bool Get(InodeID id, AllocatedSize *allocSize);
+
+    /**
+     * @brief 开始统计没有记录的文件或目录的分配大小
+     *
+     * @param id 文件或目录的inode id
+     *
+     * @return 统计开始时inode的版本号，结束时用于判断统计结果是否有效
+     */
+    uint64_t BeginBuild(InodeID id);
+
+    /**
+     * @brief 结束统计，统计期间inode没有更新时记录统计出的分配大小
+     *
+     * @param id 文件或目录的inode id
+     * @param generation BeginBuild返回的版本号
+     * @param allocSize 统计出的分配大小
+     * @param record 是否记录，统计失败时为false
+     *
+     * @return 记录了统计结果返回true，否则返回false
+     */
+    bool EndBuild(InodeID id, uint64_t generation,
+                  const AllocatedSize &allocSize, bool record);
+
+    /**
+     * @brief 在更新文件元数据之前登记将要增量更新的inode，
+     *        与更新过程重叠的统计结果不再记录
+     *
+     * @param ids 文件及其祖先目录的inode id
+     */
+    void BeginUpdate(const std::vector<InodeID> &ids);
+
+    /**
+     * @brief 增量更新计数之后取消登记
+     *
+     * @param ids 与BeginUpdate相同的inode id
+     */
+    void EndUpdate(const std::vector<InodeID> &ids);
+
+    /**
+     * @brief 增加一组inode的分配大小，没有记录的inode跳过
+     *
+     * @param ids 文件及其祖先目录的inode id
+     * @param delta 增加的分配大小
+     */
+    void Add(const std::vector<InodeID> &ids, const AllocatedSize &delta);
+
+    /**
+     * @brief 减少一组inode的分配大小，没有记录的inode跳过
+     *
+     * @param ids 文件及其祖先目录的inode id
+     * @param delta 减少的分配大小
+     */
+    void Sub(const std::vector<InodeID> &ids, const AllocatedSize &delta);
+
+    /**
+     * @brief 删除一组inode的计数，下次查询时重新统计
+     *
+     * @param ids 需要删除计数的inode id
+     */
+    void Invalidate(const std::vector<InodeID> &ids);
+
+ private:
+    void Update(const std::vector<InodeID> &ids, const AllocatedSize &delta,
+                bool add);
+
+    /**
+     * @brief 持久化有变化的计数，失败的计数留到下一轮
+     *
+     * @return 全部持久化成功返回true，否则返回false
+     */
+    bool Flush();
+
+    void PeriodicPersist();
+
+    // 调用方持有lock_，使正在统计该inode的结果失效
+    void InvalidateBuildLocked(InodeID id);
+
+ private:
+    std::shared_ptr<NameServerStorage> storage_;
+
+    struct BuildState {
+        // 正在进行的统计数量
+        uint32_t refs = 0;
+        // 统计期间inode有更新时增加
+        uint64_t generation = 0;
+    };
+
+    // 保护sizes_、dirty_、building_和updating_
+    ::curve::common::Mutex lock_;
+    std::map<InodeID, AllocatedSize> sizes_;
+    // 有变化还未持久化的inode，不在sizes_中的需要从etcd中删除
+    std::set<InodeID> dirty_;
+    // 正在统计分配大小的inode
+    std::map<InodeID, BuildState> building_;
+    // 正在增量更新的inode及其更新数量
+    std::map<InodeID, uint32_t> updating_;
+
+    // 持久化间隔, 单位ms
+    uint64_t persistIntervalMs_;
+
+    ::curve::common::Atomic<bool> stop_;
+    ::curve::common::InterruptibleSleeper sleeper_;
+    ::curve::common::Thread persistThread_;
+};
+
+/**
+ * 在作用域内登记正在增量更新的inode，counter为nullptr时不做处理
+ */
+class AllocSizeUpdateGuard {
+ public:
+    AllocSizeUpdateGuard(std::shared_ptr<AllocSizeCounter> counter,
+                         const std::vector<InodeID> &ids)
+        : counter_(counter), ids_(ids) {
+        if (counter_ != nullptr) {
+            counter_->BeginUpdate(ids_);
+        }
+    }
+
+    ~AllocSizeUpdateGuard() {
+        if (counter_ != nullptr) {
+            counter_->EndUpdate(ids_);
+        }
+    }
+
+ private:
+    std::shared_ptr<AllocSizeCounter> counter_;
+    std::vector<InodeID> ids_;
+};
+
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_NAMESERVER2_ALLOC_SIZE_COUNTER_H_
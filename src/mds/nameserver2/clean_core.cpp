@@ -22,8 +22,116 @@
 
 #include "src/mds/nameserver2/clean_core.h"
 
+#include <atomic>
+#include <map>
+#include <utility>
+
+using ::curve::common::CountDownEvent;
+using ::curve::common::TaskThreadPool;
+using ::curve::mds::topology::ChunkServerIdType;
+using ::curve::mds::topology::CopySetKey;
+using ::curve::mds::topology::UNINTIALIZE_ID;
+
 namespace curve {
 namespace mds {
+CleanCore::CleanCore(std::shared_ptr<NameServerStorage> storage,
+    std::shared_ptr<CopysetClient> copysetClient,
+    std::shared_ptr<AllocStatistic> allocStatistic,
+    const CleanCoreOption &option,
+    std::shared_ptr<Topology> topology)
+    : storage_(storage),
+      copysetClient_(copysetClient),
+      allocStatistic_(allocStatistic),
+      topology_(topology),
+      rateLimiter_(option.maxChunksPerSecond),
+      chunkserverLimiter_(option.chunkserverConcurrency),
+      deleteBatchSize_(option.deleteBatchSize),
+      deleteSegmentWindow_(option.deleteSegmentWindow) {
+    if (option.concurrency > 1) {
+        deletePool_.reset(new TaskThreadPool());
+        deletePool_->Start(option.concurrency);
+    }
+}
+
+CleanCore::~CleanCore() {
+    if (deletePool_ != nullptr) {
+        deletePool_->Stop();
+    }
+}
+
+int CleanCore::DeleteChunksWithThrottle(LogicalPoolID logicalPoolId,
+    CopysetID copysetId, const std::vector<ChunkID> &chunkIds,
+    const DeleteChunksFunc &func) {
+    rateLimiter_.Acquire(chunkIds.size());
+
+    // leader可能已经变化，只用于限流，查询失败时不限制
+    ChunkServerIdType leader = UNINTIALIZE_ID;
+    if (topology_ != nullptr) {
+        ::curve::mds::topology::CopySetInfo copyset;
+        if (topology_->GetCopySet(
+                CopySetKey(logicalPoolId, copysetId), &copyset)) {
+            leader = copyset.GetLeader();
+        }
+    }
+    chunkserverLimiter_.Acquire(leader);
+    int ret = func(logicalPoolId, copysetId, chunkIds);
+    chunkserverLimiter_.Release(leader);
+    return ret;
+}
+
+int CleanCore::DeleteSegmentChunks(
+    const std::vector<PageFileSegment> &segments,
+    uint32_t batchSize, const DeleteChunksFunc &func) {
+    // 按copyset分组，组内保持chunk在segment中的顺序，
+    // 不同segment可能属于不同的逻辑池
+    std::vector<std::pair<CopySetKey, std::vector<ChunkID>>> batches;
+    std::map<CopySetKey, size_t> openBatch;
+    for (const auto &segment : segments) {
+        for (int j = 0; j != segment.chunks_size(); j++) {
+            const PageFileChunkInfo &chunk = segment.chunks(j);
+            CopySetKey key(segment.logicalpoolid(), chunk.copysetid());
+            auto it = openBatch.find(key);
+            if (batchSize <= 1 || it == openBatch.end() ||
+                batches[it->second].second.size() >= batchSize) {
+                batches.emplace_back(key, std::vector<ChunkID>());
+                openBatch[key] = batches.size() - 1;
+                batches.back().second.push_back(chunk.chunkid());
+            } else {
+                batches[it->second].second.push_back(chunk.chunkid());
+            }
+        }
+    }
+
+    if (deletePool_ == nullptr) {
+        for (auto &batch : batches) {
+            int ret = DeleteChunksWithThrottle(batch.first.first,
+                batch.first.second, batch.second, func);
+            if (ret != 0) {
+                return ret;
+            }
+        }
+        return 0;
+    }
+
+    CountDownEvent done(batches.size());
+    std::atomic<int> result(0);
+    for (auto &batch : batches) {
+        deletePool_->Enqueue([&]() {
+            if (result.load() == 0) {
+                int ret = DeleteChunksWithThrottle(batch.first.first,
+                    batch.first.second, batch.second, func);
+                int expected = 0;
+                if (ret != 0) {
+                    result.compare_exchange_strong(expected, ret);
+                }
+            }
+            done.Signal();
+        });
+    }
+    done.Wait();
+    return result.load();
+}
+
 StatusCode CleanCore::CleanSnapShotFile(const FileInfo & fileInfo,
                                         TaskProgress* progress) {
     if (fileInfo.segmentsize() == 0) {
@@ -51,28 +159,25 @@ StatusCode CleanCore::CleanSnapShotFile(const FileInfo & fileInfo,
         }
 
         // delete chunks in chunkserver
-        LogicalPoolID logicalPoolID = segment.logicalpoolid();
-        uint32_t chunkNum = segment.chunks_size();
-        for (uint32_t j = 0; j != chunkNum; j++) {
-            // 删除快照时如果chunk不存在快照，则需要修改chunk的correctedSn
-            // 防止删除快照后，后续的写触发chunk的快照
-            // correctSn为创建快照后文件的版本号，也就是快照版本号+1
-            SeqNum correctSn = fileInfo.seqnum() + 1;
-            int ret = copysetClient_->DeleteChunkSnapshotOrCorrectSn(
-                logicalPoolID,
-                segment.chunks()[j].copysetid(),
-                segment.chunks()[j].chunkid(),
-                correctSn);
-            if (ret != 0) {
-                LOG(ERROR) << "CleanSnapShotFile Error: "
-                    << "DeleteChunkSnapshotOrCorrectSn Error"
-                    << ", ret = " << ret
-                    << ", inodeid = " << fileInfo.id()
-                    << ", filename = " << fileInfo.filename()
-                    << ", correctSn = " << correctSn;
-                progress->SetStatus(TaskStatus::FAILED);
-                return StatusCode::kSnapshotFileDeleteError;
-            }
+        // 删除快照时如果chunk不存在快照，则需要修改chunk的correctedSn
+        // 防止删除快照后，后续的写触发chunk的快照
+        // correctSn为创建快照后文件的版本号，也就是快照版本号+1
+        SeqNum correctSn = fileInfo.seqnum() + 1;
+        int ret = DeleteSegmentChunks({segment}, 1,
+            [&](LogicalPoolID logicalPoolID, CopysetID copysetId,
+                const std::vector<ChunkID> &chunkIds) {
+                return copysetClient_->DeleteChunkSnapshotOrCorrectSn(
+                    logicalPoolID, copysetId, chunkIds.front(), correctSn);
+            });
+        if (ret != 0) {
+            LOG(ERROR) << "CleanSnapShotFile Error: "
+                << "DeleteChunkSnapshotOrCorrectSn Error"
+                << ", ret = " << ret
+                << ", inodeid = " << fileInfo.id()
+                << ", filename = " << fileInfo.filename()
+                << ", correctSn = " << correctSn;
+            progress->SetStatus(TaskStatus::FAILED);
+            return StatusCode::kSnapshotFileDeleteError;
         }
         progress->SetProgress(100 * (i+1) / segmentNum);
     }
@@ -95,6 +200,55 @@ StatusCode CleanCore::CleanSnapShotFile(const FileInfo & fileInfo,
     return StatusCode::kOK;
 }
 
+bool CleanCore::CleanFileSegments(const FileInfo &commonFile,
+    const std::vector<PageFileSegment> &segments) {
+    if (segments.empty()) {
+        return true;
+    }
+
+    // delete chunks in chunkserver
+    SeqNum seq = commonFile.seqnum();
+    int ret = DeleteSegmentChunks(segments, deleteBatchSize_,
+        [&](LogicalPoolID logicalPoolID, CopysetID copysetId,
+            const std::vector<ChunkID> &chunkIds) {
+            if (deleteBatchSize_ <= 1) {
+                return copysetClient_->DeleteChunk(
+                    logicalPoolID, copysetId, chunkIds.front(), seq);
+            }
+            return copysetClient_->DeleteChunks(
+                logicalPoolID, copysetId, chunkIds, seq);
+        });
+    if (ret != 0) {
+        LOG(ERROR) << "Clean common File Error: "
+            << "DeleteChunk Error"
+            << ", ret = " << ret
+            << ", inodeid = " << commonFile.id()
+            << ", filename = " << commonFile.filename()
+            << ", sequenceNum = " << seq;
+        return false;
+    }
+
+    // 这一组segment中的chunk全部删除之后再删除segment，
+    // mds切换之后重新执行删除任务时跳过已经删除的segment
+    // delete segment
+    for (const auto &segment : segments) {
+        int64_t revision;
+        StoreStatus storeRet = storage_->DeleteSegment(
+            commonFile.id(), segment.startoffset(), &revision);
+        if (storeRet != StoreStatus::OK) {
+            LOG(ERROR) << "Clean common File Error: "
+            << "DeleteSegment Error, inodeid = " << commonFile.id()
+            << ", filename = " << commonFile.filename()
+            << ", offset = " << segment.startoffset()
+            << ", sequenceNum = " << commonFile.seqnum();
+            return false;
+        }
+        allocStatistic_->DeAllocSpace(segment.logicalpoolid(),
+            segment.segmentsize(), revision);
+    }
+    return true;
+}
+
 StatusCode CleanCore::CleanFile(const FileInfo & commonFile,
                                 TaskProgress* progress) {
     if (commonFile.segmentsize() == 0) {
@@ -104,14 +258,21 @@ StatusCode CleanCore::CleanFile(const FileInfo & commonFile,
 
     int  segmentNum = commonFile.length() / commonFile.segmentsize();
     uint64_t segmentSize = commonFile.segmentsize();
+    // 批量删除时加载多个segment后一起按copyset分组，
+    // 每个DeleteChunks请求中可以包含更多的chunk
+    uint32_t window = 1;
+    if (deleteBatchSize_ > 1 && deleteSegmentWindow_ > 1) {
+        window = deleteSegmentWindow_;
+    }
+    std::vector<PageFileSegment> segments;
     for (int i = 0; i != segmentNum; i++) {
         // load  segment
         PageFileSegment segment;
         StoreStatus storeRet = storage_->GetSegment(commonFile.id(),
                                     i * segmentSize, &segment);
-        if (storeRet == StoreStatus::KeyNotExist) {
-            continue;
-        } else if (storeRet !=  StoreStatus::OK) {
+        if (storeRet == StoreStatus::OK) {
+            segments.emplace_back(std::move(segment));
+        } else if (storeRet != StoreStatus::KeyNotExist) {
             LOG(ERROR) << "Clean common File Error: "
                 << "GetSegment Error, inodeid = " << commonFile.id()
                 << ", filename = " << commonFile.filename()
@@ -120,42 +281,14 @@ StatusCode CleanCore::CleanFile(const FileInfo & commonFile,
             return StatusCode::kCommonFileDeleteError;
         }
 
-        // delete chunks in chunkserver
-        LogicalPoolID logicalPoolID = segment.logicalpoolid();
-        uint32_t chunkNum = segment.chunks_size();
-        for (uint32_t j = 0; j != chunkNum; j++) {
-            SeqNum seq = commonFile.seqnum();
-            int ret = copysetClient_->DeleteChunk(logicalPoolID,
-                segment.chunks()[j].copysetid(),
-                segment.chunks()[j].chunkid(),
-                seq);
-            if (ret != 0) {
-                LOG(ERROR) << "Clean common File Error: "
-                    << "DeleteChunk Error"
-                    << ", ret = " << ret
-                    << ", inodeid = " << commonFile.id()
-                    << ", filename = " << commonFile.filename()
-                    << ", sequenceNum = " << seq;
-                progress->SetStatus(TaskStatus::FAILED);
-                return StatusCode::kCommonFileDeleteError;
-            }
+        if (segments.size() < window && i + 1 != segmentNum) {
+            continue;
         }
-
-        // delete segment
-        int64_t revision;
-        storeRet = storage_->DeleteSegment(
-            commonFile.id(), i * segmentSize, &revision);
-        if (storeRet != StoreStatus::OK) {
-            LOG(ERROR) << "Clean common File Error: "
-            << "DeleteSegment Error, inodeid = " << commonFile.id()
-            << ", filename = " << commonFile.filename()
-            << ", offset = " << i * segmentSize
-            << ", sequenceNum = " << commonFile.seqnum();
+        if (!CleanFileSegments(commonFile, segments)) {
             progress->SetStatus(TaskStatus::FAILED);
             return StatusCode::kCommonFileDeleteError;
         }
-        allocStatistic_->DeAllocSpace(segment.logicalpoolid(),
-            segment.segmentsize(), revision);
+        segments.clear();
         progress->SetProgress(100 * (i + 1) / segmentNum);
     }
 
@@ -176,5 +309,16 @@ StatusCode CleanCore::CleanFile(const FileInfo & commonFile,
     progress->SetStatus(TaskStatus::SUCCESS);
     return StatusCode::kOK;
 }
+
+StatusCode CleanCore::CleanSegment(const FileInfo & commonFile,
+                                   const PageFileSegment & segment) {
+    if (!CleanFileSegments(commonFile, {segment})) {
+        LOG(ERROR) << "Clean segment error, inodeid = " << commonFile.id()
+                   << ", filename = " << commonFile.filename()
+                   << ", offset = " << segment.startoffset();
+        return StatusCode::kCommonFileDeleteError;
+    }
+    return StatusCode::kOK;
+}
 }  // namespace mds
 }  // namespace curve
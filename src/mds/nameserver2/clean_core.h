@@ -23,13 +23,17 @@
 #ifndef SRC_MDS_NAMESERVER2_CLEAN_CORE_H_
 #define SRC_MDS_NAMESERVER2_CLEAN_CORE_H_
 
+#include <functional>
 #include <memory>
+#include <vector>
 #include "src/mds/nameserver2/namespace_storage.h"
 #include "src/mds/common/mds_define.h"
 #include "src/mds/nameserver2/task_progress.h"
 #include "src/mds/chunkserverclient/copyset_client.h"
 #include "src/mds/topology/topology.h"
 #include "src/mds/nameserver2/allocstatistic/alloc_statistic.h"
+#include "src/mds/nameserver2/clean_throttle.h"
+#include "src/common/concurrent/task_thread_pool.h"
 
 using ::curve::mds::chunkserverclient::CopysetClient;
 using ::curve::mds::topology::Topology;
@@ -37,14 +41,35 @@ using ::curve::mds::topology::Topology;
 namespace curve {
 namespace mds {
 
+struct CleanCoreOption {
+    // 所有删除任务共用的删除chunk的线程数，为1时每个任务逐个删除
+    uint32_t concurrency = 1;
+    // 每个chunkserver同时处理的删除请求数量上限，为0表示不限制
+    uint32_t chunkserverConcurrency = 0;
+    // 所有删除任务每秒下发的删除请求数量上限，为0表示不限制
+    uint32_t maxChunksPerSecond = 0;
+    // 删除普通文件时同一个copyset中的chunk通过DeleteChunks批量删除，
+    // 每个请求中的chunk数量上限，为0或1时逐个删除
+    uint32_t deleteBatchSize = 0;
+    // 批量删除时每次加载的segment数量，这些segment中的chunk一起按copyset
+    // 分组，全部删除成功后再删除segment
+    uint32_t deleteSegmentWindow = 32;
+};
+
 class CleanCore {
  public:
+    /**
+     * @param option 删除chunk的并发和限流配置
+     * @param topology 用于查询copyset的leader，
+     *                 为nullptr时不限制每个chunkserver上的并发
+     */
     CleanCore(std::shared_ptr<NameServerStorage> storage,
         std::shared_ptr<CopysetClient> copysetClient,
-        std::shared_ptr<AllocStatistic> allocStatistic)
-        : storage_(storage),
-          copysetClient_(copysetClient),
-          allocStatistic_(allocStatistic) {}
+        std::shared_ptr<AllocStatistic> allocStatistic,
+        const CleanCoreOption &option = CleanCoreOption(),
+        std::shared_ptr<Topology> topology = nullptr);
+
+    ~CleanCore();
 
     /**
      * @brief 删除快照文件，更新task状态
@@ -65,10 +90,66 @@ class CleanCore {
     StatusCode CleanFile(const FileInfo & commonFile,
                         TaskProgress* progress);
 
+    /**
+     * @brief 释放普通文件的一个segment，先删除segment中的所有chunk，
+     *        全部成功后再删除segment元数据并释放空间
+     * @param commonFile: segment所属的普通文件
+     * @param segment: 需要释放的segment
+     * @return 是否执行成功，成功返回StatusCode::kOK
+     */
+    StatusCode CleanSegment(const FileInfo & commonFile,
+                            const PageFileSegment & segment);
+
+ private:
+    // 删除同一个copyset中的一组chunk，返回值为0表示成功
+    using DeleteChunksFunc = std::function<int(LogicalPoolID, CopysetID,
+                                               const std::vector<ChunkID>&)>;
+
+    /**
+     * @brief 删除一组segment中的所有chunk
+     *        同一个copyset中的chunk按batchSize分组，每组调用一次func，
+     *        开启并发时在删除线程池中并发删除，等待全部完成之后返回，
+     *        有chunk删除失败时不再下发剩余的请求
+     *
+     * @param segments 需要删除chunk的segment
+     * @param batchSize 每组chunk的数量上限，为0或1时每个chunk单独一组
+     * @param func 删除一组chunk
+     *
+     * @return 全部删除成功返回0，否则返回第一个失败的错误码
+     */
+    int DeleteSegmentChunks(const std::vector<PageFileSegment> &segments,
+                            uint32_t batchSize,
+                            const DeleteChunksFunc &func);
+
+    /**
+     * @brief 删除普通文件的一组segment，先删除所有chunk，
+     *        全部成功后再删除segment元数据
+     *
+     * @return 全部删除成功返回true
+     */
+    bool CleanFileSegments(const FileInfo &commonFile,
+                           const std::vector<PageFileSegment> &segments);
+
+    /**
+     * @brief 限流之后删除同一个copyset中的一组chunk
+     */
+    int DeleteChunksWithThrottle(LogicalPoolID logicalPoolId,
+                                 CopysetID copysetId,
+                                 const std::vector<ChunkID> &chunkIds,
+                                 const DeleteChunksFunc &func);
+
  private:
     std::shared_ptr<NameServerStorage> storage_;
     std::shared_ptr<CopysetClient> copysetClient_;
     std::shared_ptr<AllocStatistic> allocStatistic_;
+    std::shared_ptr<Topology> topology_;
+
+    // 删除chunk的线程池，concurrency为1时不创建
+    std::unique_ptr<::curve::common::TaskThreadPool> deletePool_;
+    CleanRateLimiter rateLimiter_;
+    ChunkServerInflightLimiter chunkserverLimiter_;
+    uint32_t deleteBatchSize_;
+    uint32_t deleteSegmentWindow_;
 };
 
 }  // namespace mds
@@ -57,6 +57,11 @@ bool CleanManager::SubmitDeleteCommonFileJob(const FileInfo &fileInfo) {
     return taskMgr_->PushTask(commonFileCleanTask);
 }
 
+StatusCode CleanManager::CleanSegment(const FileInfo &fileInfo,
+                                      const PageFileSegment &segment) {
+    return cleanCore_->CleanSegment(fileInfo, segment);
+}
+
 bool CleanManager::RecoverCleanTasks(void) {
     // load task from store
     std::vector<FileInfo> snapShotFiles;
@@ -40,6 +40,8 @@ class CleanManagerInterface {
       std::shared_ptr<AsyncDeleteSnapShotEntity> entity) = 0;
     virtual std::shared_ptr<Task> GetTask(TaskIDType id) = 0;
     virtual bool SubmitDeleteCommonFileJob(const FileInfo&) = 0;
+    virtual StatusCode CleanSegment(const FileInfo&,
+                                    const PageFileSegment&) = 0;
 };
 /**
  * CleanManager 用于异步清理 删除快照对应的数据
@@ -61,6 +63,12 @@ class CleanManager : public CleanManagerInterface {
 
     bool SubmitDeleteCommonFileJob(const FileInfo&fileInfo) override;
 
+    /**
+     * 同步释放普通文件的一个segment，删除其中的chunk后再删除segment元数据
+     */
+    StatusCode CleanSegment(const FileInfo &fileInfo,
+                            const PageFileSegment &segment) override;
+
     bool RecoverCleanTasks(void);
 
     std::shared_ptr<Task> GetTask(TaskIDType id) override;
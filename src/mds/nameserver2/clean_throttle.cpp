@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include "src/mds/nameserver2/clean_throttle.h"
+
+#include <chrono>  //NOLINT
+#include <thread>  //NOLINT
+
+#include "src/common/timeutility.h"
+
+using ::curve::common::LockGuard;
+using ::curve::common::UniqueLock;
+using ::curve::common::TimeUtility;
+using ::curve::mds::topology::ChunkServerIdType;
+using ::curve::mds::topology::UNINTIALIZE_ID;
+
+namespace curve {
+namespace mds {
+
+void CleanRateLimiter::Acquire(uint32_t count) {
+    if (intervalUs_ == 0) {
+        return;
+    }
+
+    uint64_t waitUs = 0;
+    {
+        LockGuard lk(mutex_);
+        uint64_t nowUs = TimeUtility::GetTimeofDayUs();
+        if (nextUs_ < nowUs) {
+            nextUs_ = nowUs;
+        }
+        waitUs = nextUs_ - nowUs;
+        nextUs_ += intervalUs_ * count;
+    }
+    if (waitUs > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(waitUs));
+    }
+}
+
+void ChunkServerInflightLimiter::Acquire(ChunkServerIdType csId) {
+    if (limit_ == 0 || csId == UNINTIALIZE_ID) {
+        return;
+    }
+
+    UniqueLock lk(mutex_);
+    cond_.wait(lk, [&] {
+        return inflight_[csId] < limit_;
+    });
+    inflight_[csId]++;
+}
+
+void ChunkServerInflightLimiter::Release(ChunkServerIdType csId) {
+    if (limit_ == 0 || csId == UNINTIALIZE_ID) {
+        return;
+    }
+
+    LockGuard lk(mutex_);
+    auto it = inflight_.find(csId);
+    if (it == inflight_.end()) {
+        return;
+    }
+    if (--it->second == 0) {
+        inflight_.erase(it);
+    }
+    cond_.notify_all();
+}
+
+}  // namespace mds
+}  // namespace curve
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_MDS_NAMESERVER2_CLEAN_THROTTLE_H_
+#define SRC_MDS_NAMESERVER2_CLEAN_THROTTLE_H_
+
+#include <unordered_map>
+
+#include "src/common/concurrent/concurrent.h"
+#include "src/mds/common/mds_define.h"
+
+namespace curve {
+namespace mds {
+
+/**
+ * 限制所有删除任务下发删除请求的速率
+ * 按固定间隔分配请求的下发时间，调用方等待到分配的时间之后再下发
+ */
+class CleanRateLimiter {
+ public:
+    /**
+     * @param limit 每秒最多下发的请求数量，为0表示不限制
+     */
+    explicit CleanRateLimiter(uint32_t limit)
+        : intervalUs_(limit == 0 ? 0 : 1000000 / limit), nextUs_(0) {}
+
+    /**
+     * @brief 等待直到允许下发count个请求，批量删除时按chunk数量计算
+     */
+    void Acquire(uint32_t count = 1);
+
+ private:
+    // 两个请求之间的最小间隔
+    uint64_t intervalUs_;
+    // 下一个请求可以下发的时间
+    uint64_t nextUs_;
+    ::curve::common::Mutex mutex_;
+};
+
+/**
+ * 限制每个chunkserver上同时处理的删除请求数量，
+ * 避免删除大文件时集中在少数chunkserver上影响正常IO
+ */
+class ChunkServerInflightLimiter {
+ public:
+    /**
+     * @param limit 每个chunkserver同时处理的请求数量上限，为0表示不限制
+     */
+    explicit ChunkServerInflightLimiter(uint32_t limit) : limit_(limit) {}
+
+    /**
+     * @brief 等待直到chunkserver上处理中的请求数量小于上限
+     *
+     * @param csId chunkserver id，为UNINTIALIZE_ID时不限制
+     */
+    void Acquire(topology::ChunkServerIdType csId);
+
+    /**
+     * @brief 请求处理完成，与Acquire成对调用
+     */
+    void Release(topology::ChunkServerIdType csId);
+
+ private:
+    uint32_t limit_;
+    std::unordered_map<topology::ChunkServerIdType, uint32_t> inflight_;
+    ::curve::common::Mutex mutex_;
+    ::curve::common::ConditionVariable cond_;
+};
+
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_NAMESERVER2_CLEAN_THROTTLE_H_
@@ -101,6 +101,22 @@ bool CurveFS::Init(std::shared_ptr<NameServerStorage> storage,
 
     defaultChunkSize_ = curveFSOptions.defaultChunkSize;
     topology_ = topology;
+    if (curveFSOptions.dirPathCacheCount > 0) {
+        dirPathCache_ = std::make_shared<DirPathCache>(
+            curveFSOptions.dirPathCacheCount);
+    } else {
+        dirPathCache_ = nullptr;
+    }
+    if (curveFSOptions.enableAllocSizeCounter) {
+        allocSizeCounter_ = std::make_shared<AllocSizeCounter>(
+            storage_, curveFSOptions.allocSizePersistIntervalMs);
+        if (!allocSizeCounter_->Init()) {
+            LOG(ERROR) << "Init AllocSizeCounter fail!";
+            return false;
+        }
+    } else {
+        allocSizeCounter_ = nullptr;
+    }
 
     InitRootFile();
     bool ret = InitRecycleBinDir();
@@ -116,16 +132,24 @@ bool CurveFS::Init(std::shared_ptr<NameServerStorage> storage,
 
 void CurveFS::Run() {
     fileRecordManager_->Start();
+    if (allocSizeCounter_ != nullptr) {
+        allocSizeCounter_->Run();
+    }
 }
 
 void CurveFS::Uninit() {
     fileRecordManager_->Stop();
+    if (allocSizeCounter_ != nullptr) {
+        allocSizeCounter_->Stop();
+    }
     storage_ = nullptr;
     InodeIDGenerator_ = nullptr;
     chunkSegAllocator_ = nullptr;
     cleanManager_ = nullptr;
     allocStatistic_ = nullptr;
     fileRecordManager_ = nullptr;
+    dirPathCache_ = nullptr;
+    allocSizeCounter_ = nullptr;
 }
 
 void CurveFS::InitRootFile(void) {
@@ -150,6 +174,23 @@ StatusCode CurveFS::WalkPath(const std::string &fileName,
     *lastEntry = paths.back();
     uint64_t parentID = rootFileInfo_.id();
 
+    // 先按父目录的完整路径查询缓存，未命中时逐级查询存储并缓存每一级目录
+    bool useCache = dirPathCache_ != nullptr && paths.size() > 1;
+    uint64_t cacheVersion = 0;
+    std::string dirPath;
+    if (useCache) {
+        cacheVersion = dirPathCache_->GetVersion();
+        for (uint32_t i = 0; i < paths.size() - 1; i++) {
+            dirPath += "/" + paths[i];
+        }
+        DirInfoPtr dir = dirPathCache_->Get(dirPath);
+        if (dir != nullptr) {
+            fileInfo->CopyFrom(*dir);
+            return StatusCode::kOK;
+        }
+        dirPath.clear();
+    }
+
     for (uint32_t i = 0; i < paths.size() - 1; i++) {
         auto ret = storage_->GetFile(parentID, paths[i], fileInfo);
 
@@ -166,6 +207,11 @@ StatusCode CurveFS::WalkPath(const std::string &fileName,
         }
         // assert(fileInfo->parentid() != parentID);
         parentID =  fileInfo->id();
+        if (useCache) {
+            dirPath += "/" + paths[i];
+            dirPathCache_->Put(dirPath,
+                std::make_shared<const FileInfo>(*fileInfo), cacheVersion);
+        }
     }
     return StatusCode::kOK;
 }
@@ -196,6 +242,12 @@ StatusCode CurveFS::PutFile(const FileInfo & fileInfo) {
     }
 }
 
+void CurveFS::InvalidateDirPathCache() {
+    if (dirPathCache_ != nullptr) {
+        dirPathCache_->Invalidate();
+    }
+}
+
 StatusCode CurveFS::SnapShotFile(const FileInfo * origFileInfo,
                                 const FileInfo * snapshotFile) const {
     if (storage_->SnapShotFile(origFileInfo, snapshotFile) != StoreStatus::OK) {
@@ -302,12 +354,6 @@ StatusCode CurveFS::GetFileInfo(const std::string & filename,
     }
 }
 
-AllocatedSize& AllocatedSize::operator+=(const AllocatedSize& rhs) {
-    allocatedSize += rhs.allocatedSize;
-    physicalAllocatedSize += rhs.physicalAllocatedSize;
-    return *this;
-}
-
 StatusCode CurveFS::GetAllocatedSize(const std::string& fileName,
                                      AllocatedSize* allocatedSize) {
     assert(allocatedSize != nullptr);
@@ -332,11 +378,29 @@ StatusCode CurveFS::GetAllocatedSize(const std::string& fileName,
 StatusCode CurveFS::GetAllocatedSize(const std::string& fileName,
                                      const FileInfo& fileInfo,
                                      AllocatedSize* allocSize) {
+    uint64_t generation = 0;
+    if (allocSizeCounter_ != nullptr) {
+        if (allocSizeCounter_->Get(fileInfo.id(), allocSize)) {
+            return StatusCode::kOK;
+        }
+        // 没有记录时统计一次，统计期间有增量更新时不记录
+        generation = allocSizeCounter_->BeginBuild(fileInfo.id());
+    }
+
+    StatusCode ret;
     if (fileInfo.filetype() != curve::mds::FileType::INODE_DIRECTORY) {
-        return GetFileAllocSize(fileName, fileInfo, allocSize);
+        ret = GetFileAllocSize(fileName, fileInfo, allocSize);
     } else {  // 如果是目录，则list dir，并递归计算每个文件的大小最后加起来
-        return GetDirAllocSize(fileName, fileInfo, allocSize);
+        ret = GetDirAllocSize(fileName, fileInfo, allocSize);
+    }
+
+    // 正在删除的文件已经从祖先目录的计数中减去，不再记录
+    if (allocSizeCounter_ != nullptr) {
+        allocSizeCounter_->EndBuild(fileInfo.id(), generation, *allocSize,
+            ret == StatusCode::kOK &&
+            fileInfo.filestatus() != FileStatus::kFileDeleting);
     }
+    return ret;
 }
 
 StatusCode CurveFS::GetFileAllocSize(const std::string& fileName,
@@ -374,6 +438,11 @@ StatusCode CurveFS::GetDirAllocSize(const std::string& fileName,
         return ret;
     }
     for (const auto& file : files) {
+        // 开启计数时正在删除的文件不计入目录的分配大小
+        if (allocSizeCounter_ != nullptr &&
+            file.filestatus() == FileStatus::kFileDeleting) {
+            continue;
+        }
         std::string fullPathName;
         if (fileName == "/") {
             fullPathName = fileName + file.filename();
@@ -381,9 +450,14 @@ StatusCode CurveFS::GetDirAllocSize(const std::string& fileName,
             fullPathName = fileName + "/" + file.filename();
         }
         AllocatedSize size;
-        if (GetAllocatedSize(fullPathName, file, &size) != 0) {
+        ret = GetAllocatedSize(fullPathName, file, &size);
+        if (ret != StatusCode::kOK) {
             std::cout << "Get allocated size of " << fullPathName
                       << " fail!" << std::endl;
+            // 开启计数时不记录不完整的统计结果
+            if (allocSizeCounter_ != nullptr) {
+                return ret;
+            }
             continue;
         }
         *allocSize += size;
@@ -391,6 +465,127 @@ StatusCode CurveFS::GetDirAllocSize(const std::string& fileName,
     return StatusCode::kOK;
 }
 
+StatusCode CurveFS::GetAncestorIds(const std::string& fileName,
+                                   std::vector<InodeID>* ids) {
+    std::vector<std::string> paths;
+    ::curve::common::SplitString(fileName, "/", &paths);
+
+    ids->clear();
+    ids->push_back(rootFileInfo_.id());
+    for (uint32_t i = 0; i + 1 < paths.size(); i++) {
+        FileInfo fileInfo;
+        auto ret = storage_->GetFile(ids->back(), paths[i], &fileInfo);
+        if (ret == StoreStatus::KeyNotExist) {
+            return StatusCode::kFileNotExists;
+        } else if (ret != StoreStatus::OK) {
+            LOG(ERROR) << "GetFile error, errcode = " << ret;
+            return StatusCode::kStorageError;
+        }
+        ids->push_back(fileInfo.id());
+    }
+    return StatusCode::kOK;
+}
+
+bool CurveFS::GetSegmentAllocSize(const FileInfo& fileInfo,
+                                  const PageFileSegment& segment,
+                                  AllocatedSize* allocSize) {
+    LogicalPool logicPool;
+    if (!topology_->GetLogicalPool(segment.logicalpoolid(), &logicPool)) {
+        LOG(ERROR) << "Get logical pool " << segment.logicalpoolid()
+                   << " from topology failed!";
+        return false;
+    }
+    allocSize->allocatedSize = fileInfo.segmentsize();
+    allocSize->physicalAllocatedSize =
+        fileInfo.segmentsize() * logicPool.GetReplicaNum();
+    return true;
+}
+
+void CurveFS::GetAllocSizeIds(const std::string& fileName,
+                              const FileInfo& fileInfo,
+                              std::vector<InodeID>* ids) {
+    ids->clear();
+    if (allocSizeCounter_ == nullptr) {
+        return;
+    }
+
+    if (GetAncestorIds(fileName, ids) != StatusCode::kOK) {
+        LOG(ERROR) << "get ancestor ids fail, fileName = " << fileName;
+        allocSizeCounter_->Invalidate({fileInfo.parentid(), fileInfo.id()});
+        ids->assign({fileInfo.parentid()});
+    }
+    ids->push_back(fileInfo.id());
+}
+
+void CurveFS::UpdateAllocSize(const std::vector<InodeID>& ids,
+                              const FileInfo& fileInfo,
+                              const PageFileSegment& segment,
+                              bool add) {
+    if (allocSizeCounter_ == nullptr) {
+        return;
+    }
+
+    AllocatedSize delta;
+    if (!GetSegmentAllocSize(fileInfo, segment, &delta)) {
+        allocSizeCounter_->Invalidate(ids);
+        return;
+    }
+
+    if (add) {
+        allocSizeCounter_->Add(ids, delta);
+    } else {
+        allocSizeCounter_->Sub(ids, delta);
+    }
+}
+
+void CurveFS::MoveAllocSize(const std::vector<InodeID>& oldIds,
+                            const std::vector<InodeID>& newIds,
+                            const std::string& newFileName,
+                            const FileInfo& fileInfo) {
+    if (allocSizeCounter_ == nullptr) {
+        return;
+    }
+
+    // 文件本身的计数不变，公共的祖先目录分配大小也不变
+    std::vector<InodeID> subIds(oldIds.begin(), oldIds.end() - 1);
+    std::vector<InodeID> addIds(newIds.begin(), newIds.end() - 1);
+    uint32_t common = 0;
+    while (common < subIds.size() && common < addIds.size() &&
+           subIds[common] == addIds[common]) {
+        common++;
+    }
+    subIds.erase(subIds.begin(), subIds.begin() + common);
+    addIds.erase(addIds.begin(), addIds.begin() + common);
+
+    // 文件没有记录时统计一次，只用于转移祖先目录的计数
+    AllocatedSize size;
+    if (!allocSizeCounter_->Get(fileInfo.id(), &size) &&
+        GetFileAllocSize(newFileName, fileInfo, &size) != StatusCode::kOK) {
+        allocSizeCounter_->Invalidate(subIds);
+        allocSizeCounter_->Invalidate(addIds);
+        return;
+    }
+    allocSizeCounter_->Sub(subIds, size);
+    allocSizeCounter_->Add(addIds, size);
+}
+
+void CurveFS::RemoveAllocSize(const std::vector<InodeID>& ids,
+                              const std::string& fileName,
+                              const FileInfo& fileInfo) {
+    if (allocSizeCounter_ == nullptr) {
+        return;
+    }
+
+    AllocatedSize size;
+    if (!allocSizeCounter_->Get(fileInfo.id(), &size) &&
+        GetFileAllocSize(fileName, fileInfo, &size) != StatusCode::kOK) {
+        allocSizeCounter_->Invalidate(ids);
+        return;
+    }
+    allocSizeCounter_->Sub(ids, size);
+    allocSizeCounter_->Invalidate({fileInfo.id()});
+}
+
 StatusCode CurveFS::isDirectoryEmpty(const FileInfo &fileInfo, bool *result) {
     assert(fileInfo.filetype() == FileType::INODE_DIRECTORY);
     std::vector<FileInfo> fileInfoList;
@@ -491,12 +686,16 @@ StatusCode CurveFS::DeleteFile(const std::string & filename, uint64_t fileId,
         }
         auto ret = storage_->DeleteFile(fileInfo.parentid(),
                                                 fileInfo.filename());
+        InvalidateDirPathCache();
         if (ret != StoreStatus::OK) {
             LOG(ERROR) << "delete file, file is directory and delete fail"
                        << ", filename = " << filename
                        << ", ret = " << ret;
             return StatusCode::kStorageError;
         }
+        if (allocSizeCounter_ != nullptr) {
+            allocSizeCounter_->Invalidate({fileInfo.id()});
+        }
 
         LOG(INFO) << "delete file success, file is directory"
                   << ", filename = " << filename;
@@ -518,14 +717,24 @@ StatusCode CurveFS::DeleteFile(const std::string & filename, uint64_t fileId,
                 std::to_string(recycleFileInfo.id()));
             recycleFileInfo.set_originalfullpathname(filename);
 
+            std::string recycleFileName =
+                RECYCLEBINDIR + "/" + recycleFileInfo.filename();
+            std::vector<InodeID> oldIds;
+            std::vector<InodeID> newIds;
+            GetAllocSizeIds(filename, fileInfo, &oldIds);
+            GetAllocSizeIds(recycleFileName, recycleFileInfo, &newIds);
+            AllocSizeUpdateGuard oldGuard(allocSizeCounter_, oldIds);
+            AllocSizeUpdateGuard newGuard(allocSizeCounter_, newIds);
             StoreStatus ret1 =
                 storage_->MoveFileToRecycle(fileInfo, recycleFileInfo);
+            InvalidateDirPathCache();
             if (ret1 != StoreStatus::OK) {
                 LOG(ERROR) << "delete file, move file to recycle fail"
                         << ", filename = " << filename
                         << ", ret = " << ret1;
                 return StatusCode::kStorageError;
             }
+            MoveAllocSize(oldIds, newIds, recycleFileName, recycleFileInfo);
             LOG(INFO) << "file delete to recyclebin, fileName = " << filename
                       << ", recycle filename = " << recycleFileInfo.filename();
             return StatusCode::kOK;
@@ -550,6 +759,9 @@ StatusCode CurveFS::DeleteFile(const std::string & filename, uint64_t fileId,
                 return StatusCode::kOK;
             }
 
+            std::vector<InodeID> ids;
+            GetAllocSizeIds(filename, fileInfo, &ids);
+            AllocSizeUpdateGuard guard(allocSizeCounter_, ids);
             fileInfo.set_filestatus(FileStatus::kFileDeleting);
             auto ret = PutFile(fileInfo);
             if (ret != StatusCode::kOK) {
@@ -557,6 +769,7 @@ StatusCode CurveFS::DeleteFile(const std::string & filename, uint64_t fileId,
                            << filename << ", retCode = " << ret;
                 return StatusCode::KInternalError;
             }
+            RemoveAllocSize(ids, filename, fileInfo);
 
             // 提交一个删除文件的任务
             if (!cleanManager_->SubmitDeleteCommonFileJob(fileInfo)) {
@@ -739,10 +952,25 @@ StatusCode CurveFS::RenameFile(const std::string & oldFileName,
         newFileInfo.set_parentid(parentFileInfo.id());
         newFileInfo.set_filename(lastEntry);
 
+        std::string recycleFileName =
+            RECYCLEBINDIR + "/" + recycleFileInfo.filename();
+        std::vector<InodeID> existIds;
+        std::vector<InodeID> recycleIds;
+        std::vector<InodeID> oldIds;
+        std::vector<InodeID> newIds;
+        GetAllocSizeIds(newFileName, existNewFileInfo, &existIds);
+        GetAllocSizeIds(recycleFileName, recycleFileInfo, &recycleIds);
+        GetAllocSizeIds(oldFileName, oldFileInfo, &oldIds);
+        GetAllocSizeIds(newFileName, newFileInfo, &newIds);
+        AllocSizeUpdateGuard existGuard(allocSizeCounter_, existIds);
+        AllocSizeUpdateGuard recycleGuard(allocSizeCounter_, recycleIds);
+        AllocSizeUpdateGuard oldGuard(allocSizeCounter_, oldIds);
+        AllocSizeUpdateGuard newGuard(allocSizeCounter_, newIds);
         auto ret1 = storage_->ReplaceFileAndRecycleOldFile(oldFileInfo,
                                                         newFileInfo,
                                                         existNewFileInfo,
                                                         recycleFileInfo);
+        InvalidateDirPathCache();
         if (ret1 != StoreStatus::OK) {
             LOG(ERROR) << "storage_ ReplaceFileAndRecycleOldFile error"
                         << ", oldFileName = " << oldFileName
@@ -751,6 +979,8 @@ StatusCode CurveFS::RenameFile(const std::string & oldFileName,
 
             return StatusCode::kStorageError;
         }
+        MoveAllocSize(existIds, recycleIds, recycleFileName, recycleFileInfo);
+        MoveAllocSize(oldIds, newIds, newFileName, newFileInfo);
         return StatusCode::kOK;
     } else if (ret3 == StatusCode::kFileNotExists) {
         // newFileName不存在, 直接rename
@@ -759,11 +989,19 @@ StatusCode CurveFS::RenameFile(const std::string & oldFileName,
         newFileInfo.set_parentid(parentFileInfo.id());
         newFileInfo.set_filename(lastEntry);
 
+        std::vector<InodeID> oldIds;
+        std::vector<InodeID> newIds;
+        GetAllocSizeIds(oldFileName, oldFileInfo, &oldIds);
+        GetAllocSizeIds(newFileName, newFileInfo, &newIds);
+        AllocSizeUpdateGuard oldGuard(allocSizeCounter_, oldIds);
+        AllocSizeUpdateGuard newGuard(allocSizeCounter_, newIds);
         auto ret = storage_->RenameFile(oldFileInfo, newFileInfo);
+        InvalidateDirPathCache();
         if ( ret != StoreStatus::OK ) {
             LOG(ERROR) << "storage_ renamefile error, error = " << ret;
             return StatusCode::kStorageError;
         }
+        MoveAllocSize(oldIds, newIds, newFileName, newFileInfo);
         return StatusCode::kOK;
     } else {
         LOG(INFO) << "dest file LookUpFile return: " << ret3;
@@ -866,7 +1104,11 @@ StatusCode CurveFS::ChangeOwner(const std::string &filename,
 
     // 修改文件owner
     fileInfo.set_owner(newOwner);
-    return PutFile(fileInfo);
+    ret = PutFile(fileInfo);
+    if (fileInfo.filetype() == FileType::INODE_DIRECTORY) {
+        InvalidateDirPathCache();
+    }
+    return ret;
 }
 
 StatusCode CurveFS::GetOrAllocateSegment(const std::string & filename,
@@ -913,6 +1155,9 @@ StatusCode CurveFS::GetOrAllocateSegment(const std::string & filename,
                 LOG(ERROR) << "AllocateChunkSegment error";
                 return StatusCode::kSegmentAllocateError;
             }
+            std::vector<InodeID> ids;
+            GetAllocSizeIds(filename, fileInfo, &ids);
+            AllocSizeUpdateGuard guard(allocSizeCounter_, ids);
             int64_t revision;
             if (storage_->PutSegment(fileInfo.id(), offset, segment, &revision)
                 != StoreStatus::OK) {
@@ -925,6 +1170,7 @@ StatusCode CurveFS::GetOrAllocateSegment(const std::string & filename,
             allocStatistic_->AllocSpace(segment->logicalpoolid(),
                     segment->segmentsize(),
                     revision);
+            UpdateAllocSize(ids, fileInfo, *segment, true);
 
             LOG(INFO) << "alloc segment success, fileInfo.id() = "
                       << fileInfo.id()
@@ -936,6 +1182,79 @@ StatusCode CurveFS::GetOrAllocateSegment(const std::string & filename,
     }
 }
 
+StatusCode CurveFS::DeAllocateSegment(const std::string & filename,
+                                      offset_t offset) {
+    FileInfo  fileInfo;
+    auto ret = GetFileInfo(filename, &fileInfo);
+    if (ret != StatusCode::kOK) {
+        LOG(INFO) << "get source file error, errCode = " << ret;
+        return  ret;
+    }
+
+    if (fileInfo.filetype() != FileType::INODE_PAGEFILE) {
+        LOG(INFO) << "not pageFile, can't do this";
+        return StatusCode::kParaError;
+    }
+
+    if (offset % fileInfo.segmentsize() != 0) {
+        LOG(INFO) << "offset not align with segment";
+        return StatusCode::kParaError;
+    }
+
+    if (offset + fileInfo.segmentsize() > fileInfo.length()) {
+        LOG(INFO) << "bigger than file length";
+        return StatusCode::kParaError;
+    }
+
+    // 克隆中的文件和作为克隆源的文件，chunk的数据可能还会被读取
+    if (fileInfo.filestatus() != FileStatus::kFileCreated &&
+        fileInfo.filestatus() != FileStatus::kFileCloned) {
+        LOG(INFO) << "file = " << filename << ", status = "
+                  << fileInfo.filestatus() << ", can't deallocate segment";
+        return StatusCode::kNotSupported;
+    }
+
+    // 快照文件还会读取源文件的segment
+    std::vector<FileInfo> snapShotFiles;
+    if (storage_->ListSnapshotFile(fileInfo.id(),
+                  fileInfo.id() + 1, &snapShotFiles) != StoreStatus::OK) {
+        LOG(ERROR) << filename << " listFile fail";
+        return StatusCode::kStorageError;
+    }
+    if (!snapShotFiles.empty()) {
+        LOG(INFO) << filename << " exist snapshotfile, num = "
+                  << snapShotFiles.size();
+        return StatusCode::kFileUnderSnapShot;
+    }
+
+    PageFileSegment segment;
+    auto storeRet = storage_->GetSegment(fileInfo.id(), offset, &segment);
+    if (storeRet == StoreStatus::KeyNotExist) {
+        return StatusCode::kOK;
+    } else if (storeRet != StoreStatus::OK) {
+        LOG(ERROR) << "GetSegment fail, fileInfo.id() = " << fileInfo.id()
+                   << ", offset = " << offset;
+        return StatusCode::kStorageError;
+    }
+
+    std::vector<InodeID> ids;
+    GetAllocSizeIds(filename, fileInfo, &ids);
+    AllocSizeUpdateGuard guard(allocSizeCounter_, ids);
+    // 不依赖client已经删除了chunk，segment中的chunk全部删除成功后
+    // 再删除segment元数据并释放空间，否则chunk会成为孤儿chunk
+    ret = cleanManager_->CleanSegment(fileInfo, segment);
+    if (ret != StatusCode::kOK) {
+        LOG(ERROR) << "CleanSegment fail, fileInfo.id() = " << fileInfo.id()
+                   << ", offset = " << offset << ", errCode = " << ret;
+        return ret;
+    }
+    UpdateAllocSize(ids, fileInfo, segment, false);
+
+    LOG(INFO) << "dealloc segment success, fileInfo.id() = " << fileInfo.id()
+              << ", offset = " << offset;
+    return StatusCode::kOK;
+}
+
 StatusCode CurveFS::CreateSnapShotFile(const std::string &fileName,
                                     FileInfo *snapshotFileInfo) {
     FileInfo  parentFileInfo;
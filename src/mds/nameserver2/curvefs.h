@@ -31,6 +31,8 @@
 #include <chrono>
 #include "proto/nameserver2.pb.h"
 #include "src/mds/nameserver2/namespace_storage.h"
+#include "src/mds/nameserver2/dir_path_cache.h"
+#include "src/mds/nameserver2/alloc_size_counter.h"
 #include "src/mds/common/mds_define.h"
 #include "src/mds/nameserver2/chunk_allocator.h"
 #include "src/mds/nameserver2/clean_manager.h"
@@ -53,15 +55,14 @@ struct CurveFSOption {
     uint64_t defaultChunkSize;
     RootAuthOption authOptions;
     FileRecordOptions fileRecordOptions;
-};
-
-struct AllocatedSize {
-    // mds给文件分配的segment的大小
-    uint64_t allocatedSize;
-    // 实际会占用的底层空间
-    uint64_t physicalAllocatedSize;
-    AllocatedSize() : allocatedSize(0), physicalAllocatedSize(0) {}
-    AllocatedSize& operator+=(const AllocatedSize& rhs);
+    // WalkPath缓存的目录数量，为0时不缓存
+    uint64_t dirPathCacheCount = 0;
+    // 是否增量维护文件和目录的分配大小，关闭时查询分配大小需要遍历目录
+    bool enableAllocSizeCounter = false;
+    // 分配大小计数定期持久化的间隔(ms)
+    uint64_t allocSizePersistIntervalMs = 1000;
+    // inode id和chunk id生成器的配置
+    IdGeneratorOption idGeneratorOption;
 };
 
 using ::curve::mds::DeleteSnapShotResponse;
@@ -212,6 +213,17 @@ class CurveFS {
         offset_t offset,
         bool allocateIfNoExist, PageFileSegment *segment);
 
+    /**
+     *  @brief 释放文件中已经被discard的segment，segment不存在时返回成功
+     *         先删除segment内的所有chunk，成功后再删除segment元数据，
+     *         文件存在快照或者处于克隆相关状态时不允许释放
+     *  @param filename：文件名
+     *         offset: segment的偏移
+     *  @return 是否成功，成功返回StatusCode::kOK
+     */
+    StatusCode DeAllocateSegment(const std::string & filename,
+                                 offset_t offset);
+
     /**
      *  @brief 获取root文件信息
      *  @param
@@ -472,6 +484,11 @@ class CurveFS {
 
     StatusCode PutFile(const FileInfo & fileInfo);
 
+    /**
+     *  @brief 目录结构变化之后使WalkPath的目录缓存失效
+     */
+    void InvalidateDirPathCache();
+
     /**
      * @brief 执行一次fileinfo的snapshot快照事务
      * @param originalFileInfo: 原文件对于fileInfo
@@ -573,6 +590,73 @@ class CurveFS {
                                 const FileInfo& fileInfo,
                                 AllocatedSize* allocSize);
 
+    /**
+     *  @brief 获取路径上所有祖先目录的inode id，从根目录开始，不包括文件本身
+     *  @param: fileName：文件名
+     *  @param[out]: ids： 祖先目录的inode id
+     *  @return 是否成功，成功返回StatusCode::kOK
+     */
+    StatusCode GetAncestorIds(const std::string& fileName,
+                              std::vector<InodeID>* ids);
+
+    /**
+     *  @brief 获取文件一个segment的分配大小
+     *  @param: fileInfo 文件信息
+     *  @param: segment segment信息
+     *  @param[out]: allocSize： segment的分配大小
+     *  @return 是否成功
+     */
+    bool GetSegmentAllocSize(const FileInfo& fileInfo,
+                             const PageFileSegment& segment,
+                             AllocatedSize* allocSize);
+
+    /**
+     *  @brief 获取文件及其所有祖先目录的inode id，文件在最后，
+     *         更新文件元数据之前获取并登记，未开启计数时为空
+     *         获取祖先目录失败时删除文件和父目录的计数，只返回这两个id
+     *  @param: fileName：文件名
+     *  @param: fileInfo 文件信息
+     *  @param[out]: ids： 文件及其祖先目录的inode id
+     */
+    void GetAllocSizeIds(const std::string& fileName,
+                         const FileInfo& fileInfo,
+                         std::vector<InodeID>* ids);
+
+    /**
+     *  @brief 文件分配或回收segment之后，更新文件及其祖先目录的分配大小计数
+     *  @param: ids：GetAllocSizeIds获取的inode id
+     *  @param: fileInfo 文件信息
+     *  @param: segment 分配或回收的segment
+     *  @param: add： true为分配，false为回收
+     */
+    void UpdateAllocSize(const std::vector<InodeID>& ids,
+                         const FileInfo& fileInfo,
+                         const PageFileSegment& segment,
+                         bool add);
+
+    /**
+     *  @brief 文件rename或移入回收站之后，
+     *         把文件的分配大小从原路径的祖先目录转移到新路径的祖先目录
+     *  @param: oldIds：原路径上GetAllocSizeIds获取的inode id
+     *  @param: newIds：新路径上GetAllocSizeIds获取的inode id
+     *  @param: newFileName：新文件名
+     *  @param: fileInfo 文件信息
+     */
+    void MoveAllocSize(const std::vector<InodeID>& oldIds,
+                       const std::vector<InodeID>& newIds,
+                       const std::string& newFileName,
+                       const FileInfo& fileInfo);
+
+    /**
+     *  @brief 文件开始删除之后，从祖先目录中减去文件的分配大小并删除文件的计数
+     *  @param: ids：GetAllocSizeIds获取的inode id
+     *  @param: fileName：文件名
+     *  @param: fileInfo 文件信息
+     */
+    void RemoveAllocSize(const std::vector<InodeID>& ids,
+                         const std::string& fileName,
+                         const FileInfo& fileInfo);
+
  private:
     FileInfo rootFileInfo_;
     std::shared_ptr<NameServerStorage> storage_;
@@ -582,6 +666,9 @@ class CurveFS {
     std::shared_ptr<CleanManagerInterface> cleanManager_;
     std::shared_ptr<AllocStatistic> allocStatistic_;
     std::shared_ptr<Topology> topology_;
+    std::shared_ptr<DirPathCache> dirPathCache_;
+    // 文件和目录的分配大小计数，未开启时为nullptr
+    std::shared_ptr<AllocSizeCounter> allocSizeCounter_;
     struct RootAuthOption       rootAuthOptions_;
 
     uint64_t defaultChunkSize_;
@@ -0,0 +1,64 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include "src/mds/nameserver2/dir_path_cache.h"
+
+#include <utility>
+
+using ::curve::common::ReadLockGuard;
+using ::curve::common::WriteLockGuard;
+
+namespace curve {
+namespace mds {
+
+uint64_t DirPathCache::GetVersion() const {
+    ReadLockGuard lk(lock_);
+    return version_;
+}
+
+DirInfoPtr DirPathCache::Get(const std::string &path) const {
+    ReadLockGuard lk(lock_);
+    auto it = dirs_.find(path);
+    if (it == dirs_.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void DirPathCache::Put(const std::string &path, DirInfoPtr dir,
+    uint64_t version) {
+    WriteLockGuard lk(lock_);
+    if (version != version_) {
+        return;
+    }
+    if (dirs_.size() >= maxCount_ && dirs_.find(path) == dirs_.end()) {
+        dirs_.clear();
+    }
+    dirs_[path] = std::move(dir);
+}
+
+void DirPathCache::Invalidate() {
+    WriteLockGuard lk(lock_);
+    version_++;
+    dirs_.clear();
+}
+
+}  // namespace mds
+}  // namespace curve
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_MDS_NAMESERVER2_DIR_PATH_CACHE_H_
+#define SRC_MDS_NAMESERVER2_DIR_PATH_CACHE_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "proto/nameserver2.pb.h"
+#include "src/common/concurrent/rw_lock.h"
+
+namespace curve {
+namespace mds {
+
+using DirInfoPtr = std::shared_ptr<const FileInfo>;
+
+/**
+ * WalkPath使用的目录路径缓存，记录目录完整路径到目录FileInfo的映射
+ * 1. 只缓存目录，放入缓存的FileInfo不再修改，由所有查询共享
+ * 2. 目录被删除、修改owner，或者有文件rename、移入回收站时整体失效，
+ *    这些操作远少于open、stat等需要解析路径的请求
+ * 3. 查询存储之前先记录版本号，失效时版本号增加，
+ *    避免把失效之前从存储中读到的旧数据放入缓存
+ */
+class DirPathCache {
+ public:
+    /**
+     * @param maxCount 最多缓存的目录数量，达到上限时清空缓存
+     */
+    explicit DirPathCache(uint64_t maxCount)
+        : maxCount_(maxCount), version_(0) {}
+
+    /**
+     * @brief 获取当前版本号，查询存储之前调用
+     */
+    uint64_t GetVersion() const;
+
+    /**
+     * @brief 查询目录
+     *
+     * @param path 目录的完整路径，如"/a/b"
+     *
+     * @return 目录不在缓存中时返回nullptr
+     */
+    DirInfoPtr Get(const std::string &path) const;
+
+    /**
+     * @brief 缓存目录，version与当前版本号不一致时不缓存
+     *
+     * @param path 目录的完整路径
+     * @param dir 目录的FileInfo
+     * @param version 查询存储之前通过GetVersion获取的版本号
+     */
+    void Put(const std::string &path, DirInfoPtr dir, uint64_t version);
+
+    /**
+     * @brief 清空缓存并增加版本号
+     */
+    void Invalidate();
+
+ private:
+    uint64_t maxCount_;
+    mutable ::curve::common::RWLock lock_;
+    uint64_t version_;
+    std::unordered_map<std::string, DirInfoPtr> dirs_;
+};
+
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_NAMESERVER2_DIR_PATH_CACHE_H_
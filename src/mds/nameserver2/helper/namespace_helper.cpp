@@ -31,6 +31,8 @@ using ::curve::common::SNAPSHOTFILEINFOKEYPREFIX;
 using ::curve::common::SEGMENTKEYLEN;
 using ::curve::common::SEGMENTINFOKEYPREFIX;
 using ::curve::common::SEGMENTALLOCSIZEKEY;
+using ::curve::common::ALLOCSIZEKEYPREFIX;
+using ::curve::common::ALLOCSIZEKEYLEN;
 
 namespace curve {
 namespace mds {
@@ -132,5 +134,55 @@ bool NameSpaceStorageCodec::DecodeSegmentAllocValue(
 
     return true;
 }
+
+std::string NameSpaceStorageCodec::EncodeAllocSizeKey(InodeID id) {
+    std::string storeKey;
+    storeKey.resize(ALLOCSIZEKEYLEN);
+    memcpy(&(storeKey[0]), ALLOCSIZEKEYPREFIX, COMMON_PREFIX_LENGTH);
+    ::curve::common::EncodeBigEndian(&(storeKey[2]), id);
+    return storeKey;
+}
+
+std::string NameSpaceStorageCodec::EncodeAllocSizeValue(
+    InodeID id, const AllocatedSize &allocSize) {
+    return std::to_string(id) + "_" +
+           std::to_string(allocSize.allocatedSize) + "_" +
+           std::to_string(allocSize.physicalAllocatedSize);
+}
+
+bool NameSpaceStorageCodec::DecodeAllocSizeValue(
+    const std::string &value, InodeID *id, AllocatedSize *allocSize) {
+    std::vector<std::string> res;
+    ::curve::common::SplitString(value, "_", &res);
+    if (res.size() != 3) {
+        LOG(ERROR) << "alloc size value: "
+                   << value << " is in unknown format";
+        return false;
+    }
+
+    if (!::curve::common::StringToUll(res[0], id) ||
+        !::curve::common::StringToUll(res[1], &allocSize->allocatedSize) ||
+        !::curve::common::StringToUll(
+            res[2], &allocSize->physicalAllocatedSize)) {
+        LOG(ERROR) << "decode alloc size value: " << value << " fail";
+        return false;
+    }
+    return true;
+}
+
+std::string NameSpaceStorageCodec::EncodeAllocSizeStateValue(bool clean) {
+    return clean ? "1" : "0";
+}
+
+bool NameSpaceStorageCodec::DecodeAllocSizeStateValue(
+    const std::string &value, bool *clean) {
+    if (value != "0" && value != "1") {
+        LOG(ERROR) << "alloc size state value: "
+                   << value << " is in unknown format";
+        return false;
+    }
+    *clean = (value == "1");
+    return true;
+}
 }   // namespace mds
 }   // namespace curve
@@ -50,6 +50,15 @@ class NameSpaceStorageCodec {
     static std::string EncodeSegmentAllocValue(uint16_t lid, uint64_t alloc);
     static bool DecodeSegmentAllocValue(
         const std::string &value, uint16_t *lid, uint64_t *alloc);
+
+    static std::string EncodeAllocSizeKey(InodeID id);
+    static std::string EncodeAllocSizeValue(
+        InodeID id, const AllocatedSize &allocSize);
+    static bool DecodeAllocSizeValue(
+        const std::string &value, InodeID *id, AllocatedSize *allocSize);
+    static std::string EncodeAllocSizeStateValue(bool clean);
+    static bool DecodeAllocSizeStateValue(
+        const std::string &value, bool *clean);
 };
 }   // namespace mds
 }   // namespace curve
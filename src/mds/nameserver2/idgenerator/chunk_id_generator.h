@@ -54,9 +54,10 @@ class ChunkIDGenerator {
 
 class ChunkIDGeneratorImp : public ChunkIDGenerator {
  public:
-    explicit ChunkIDGeneratorImp(std::shared_ptr<KVStorageClient> client) {
-        generator_ = std::make_shared<EtcdIdGenerator>(
-            client, CHUNKSTOREKEY, CHUNKINITIALIZE, CHUNKBUNDLEALLOCATED);
+    explicit ChunkIDGeneratorImp(std::shared_ptr<KVStorageClient> client,
+        const IdGeneratorOption &option = IdGeneratorOption()) {
+        generator_ = std::make_shared<EtcdIdGenerator>(client, CHUNKSTOREKEY,
+            CHUNKINITIALIZE, CHUNKBUNDLEALLOCATED, option);
     }
     virtual ~ChunkIDGeneratorImp() {}
 
@@ -21,14 +21,44 @@
  */
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <string>
 #include "src/mds/nameserver2/idgenerator/etcd_id_generator.h"
+#include "src/common/timeutility.h"
 #include "src/common/string_util.h"
 #include "src/mds/nameserver2/helper/namespace_helper.h"
 
 namespace curve {
 namespace mds {
+// 开启预取时，当前bundle剩余的id少于bundle大小的1/kPrefetchWatermark时开始预取
+const uint64_t kPrefetchWatermark = 4;
+
+EtcdIdGenerator::EtcdIdGenerator(
+    const std::shared_ptr<KVStorageClient> &client,
+    const std::string &storeKey, uint64_t initial, uint64_t bundle,
+    const IdGeneratorOption &option) :
+    client_(client), storeKey_(storeKey), initialize_(initial),
+    bundle_(bundle), nextId_(initial), bundleEnd_(initial), option_(option),
+    nextStart_(0), nextEnd_(0), fetching_(false), lastBundleSize_(bundle),
+    lastFetchTimeMs_(0) {
+    if (option_.enablePrefetch) {
+        option_.maxBundleSize = std::max(option_.maxBundleSize, bundle_);
+        prefetchPool_.reset(new ::curve::common::TaskThreadPool());
+        prefetchPool_->Start(1);
+    }
+}
+
+EtcdIdGenerator::~EtcdIdGenerator() {
+    if (prefetchPool_ != nullptr) {
+        prefetchPool_->Stop();
+    }
+}
+
 bool EtcdIdGenerator::GenID(InodeID *id) {
+    if (option_.enablePrefetch) {
+        return GenIDWithPrefetch(id);
+    }
+
     ::curve::common::WriteLockGuard guard(lock_);
     if (nextId_ > bundleEnd_ || nextId_ == initialize_) {
         if (!AllocateBundleIds(bundle_)) {
@@ -40,7 +70,83 @@ bool EtcdIdGenerator::GenID(InodeID *id) {
     return true;
 }
 
+bool EtcdIdGenerator::GenIDWithPrefetch(InodeID *id) {
+    ::curve::common::UniqueLock lk(mtx_);
+    while (CurrentBundleEmpty()) {
+        if (nextEnd_ != 0) {
+            nextId_ = nextStart_;
+            bundleEnd_ = nextEnd_;
+            nextEnd_ = 0;
+        } else if (fetching_) {
+            // 已经有线程在申请，等待申请结果
+            cond_.wait(lk);
+        } else if (!FetchNextBundle(&lk)) {
+            return false;
+        }
+    }
+
+    *id = nextId_++;
+
+    // 当前bundle即将用完且没有预取的bundle时，异步预取下一个bundle
+    if (nextEnd_ == 0 && !fetching_ &&
+        bundleEnd_ + 1 - nextId_ < lastBundleSize_ / kPrefetchWatermark) {
+        fetching_ = true;
+        prefetchPool_->Enqueue([this]() { Prefetch(); });
+    }
+    return true;
+}
+
+void EtcdIdGenerator::Prefetch() {
+    ::curve::common::UniqueLock lk(mtx_);
+    // 入队时已经设置fetching_
+    fetching_ = false;
+    if (nextEnd_ != 0) {
+        return;
+    }
+    FetchNextBundle(&lk);
+}
+
+bool EtcdIdGenerator::FetchNextBundle(::curve::common::UniqueLock *lk) {
+    // 根据上一个bundle的使用时间估算分配速率，调整本次申请的大小
+    uint64_t now = ::curve::common::TimeUtility::GetTimeofDayMs();
+    uint64_t requiredNum = bundle_;
+    if (lastFetchTimeMs_ != 0) {
+        uint64_t elapsedMs = std::max<uint64_t>(now - lastFetchTimeMs_, 1);
+        requiredNum = lastBundleSize_ * option_.bundleLifeMs / elapsedMs;
+        requiredNum = std::min(std::max(requiredNum, bundle_),
+                               option_.maxBundleSize);
+    }
+
+    fetching_ = true;
+    lk->unlock();
+    uint64_t start, end;
+    bool ok = FetchBundle(requiredNum, &start, &end);
+    lk->lock();
+    fetching_ = false;
+    if (ok) {
+        nextStart_ = start;
+        nextEnd_ = end;
+        lastBundleSize_ = requiredNum;
+        lastFetchTimeMs_ = now;
+    }
+    cond_.notify_all();
+    return ok;
+}
+
 bool EtcdIdGenerator::AllocateBundleIds(int requiredNum) {
+    uint64_t start, end;
+    if (!FetchBundle(requiredNum, &start, &end)) {
+        return false;
+    }
+
+    // 给next和end赋值
+    bundleEnd_ = end;
+    nextId_ = start;
+    return true;
+}
+
+bool EtcdIdGenerator::FetchBundle(uint64_t requiredNum,
+                                  uint64_t *start, uint64_t *end) {
     // 获取已经allocate的最大值
     std::string out = "";
     uint64_t alloc;
@@ -69,9 +175,8 @@ bool EtcdIdGenerator::AllocateBundleIds(int requiredNum) {
         return false;
     }
 
-    // 给next和end赋值
-    bundleEnd_ = target;
-    nextId_ = alloc + 1;
+    *start = alloc + 1;
+    *end = target;
     return true;
 }
 }  // namespace mds
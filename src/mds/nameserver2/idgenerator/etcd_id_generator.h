@@ -28,20 +28,30 @@
 #include "src/mds/common/mds_define.h"
 #include "src/kvstorageclient/etcd_client.h"
 #include "src/common/concurrent/concurrent.h"
+#include "src/common/concurrent/task_thread_pool.h"
 
 using ::curve::common::Atomic;
 using ::curve::kvstorage::KVStorageClient;
 
 namespace curve {
 namespace mds {
+
+struct IdGeneratorOption {
+    // 是否在当前bundle即将用完时异步预取下一个bundle，关闭时用完后同步申请
+    bool enablePrefetch = false;
+    // 预取时bundle的最大id数量，bundle按分配速率在[bundle, maxBundleSize]之间调整
+    uint64_t maxBundleSize = 0;
+    // 期望一个bundle能使用的时间，分配速率乘以该时间即为下一个bundle的大小
+    uint64_t bundleLifeMs = 1000;
+};
+
 class EtcdIdGenerator {
  public:
     EtcdIdGenerator(
         const std::shared_ptr<KVStorageClient> &client,
-        const std::string &storeKey, uint64_t initial, uint64_t bundle) :
-        client_(client), storeKey_(storeKey), initialize_(initial),
-        bundle_(bundle), nextId_(initial), bundleEnd_(initial) {}
-    virtual ~EtcdIdGenerator() {}
+        const std::string &storeKey, uint64_t initial, uint64_t bundle,
+        const IdGeneratorOption &option = IdGeneratorOption());
+    virtual ~EtcdIdGenerator();
 
 
     bool GenID(InodeID *id);
@@ -56,6 +66,40 @@ class EtcdIdGenerator {
     */
     bool AllocateBundleIds(int requiredNum);
 
+    /*
+    * @brief 从storage中批量申请ID，申请到的id范围为[start, end]
+    *
+    * @param[in] requiredNum 需要申请的id个数
+    * @param[out] start 申请到的第一个id
+    * @param[out] end 申请到的最后一个id
+    *
+    * @return false表示申请失败，true表示申请成功
+    */
+    bool FetchBundle(uint64_t requiredNum, uint64_t *start, uint64_t *end);
+
+    /*
+    * @brief 开启预取时生成id，当前bundle用完时切换到预取的bundle，
+    *        只有预取的bundle也没有时才等待etcd
+    */
+    bool GenIDWithPrefetch(InodeID *id);
+
+    /*
+    * @brief 在后台线程中预取下一个bundle
+    */
+    void Prefetch();
+
+    /*
+    * @brief 申请一个bundle，结果放入nextStart_和nextEnd_
+    *
+    * @param[in] lk 持有的mtx_，申请etcd期间释放
+    */
+    bool FetchNextBundle(::curve::common::UniqueLock *lk);
+
+    // 调用方持有mtx_
+    bool CurrentBundleEmpty() const {
+        return nextId_ > bundleEnd_ || nextId_ == initialize_;
+    }
+
  private:
     std::string storeKey_;
     uint64_t initialize_;
@@ -66,6 +110,20 @@ class EtcdIdGenerator {
     uint64_t bundleEnd_;
 
     ::curve::common::RWLock lock_;
+
+    // 以下成员只在开启预取时使用，由mtx_保护
+    IdGeneratorOption option_;
+    ::curve::common::Mutex mtx_;
+    ::curve::common::ConditionVariable cond_;
+    // 预取到的下一个bundle[nextStart_, nextEnd_]，nextEnd_为0表示没有
+    uint64_t nextStart_;
+    uint64_t nextEnd_;
+    // 是否有正在进行的bundle申请
+    bool fetching_;
+    // 上一个bundle的大小和申请时间，用于估算分配速率
+    uint64_t lastBundleSize_;
+    uint64_t lastFetchTimeMs_;
+    std::unique_ptr<::curve::common::TaskThreadPool> prefetchPool_;
 };
 
 }  // namespace mds
@@ -54,9 +54,10 @@ class InodeIDGenerator {
 
 class InodeIdGeneratorImp : public InodeIDGenerator {
  public:
-    explicit InodeIdGeneratorImp(std::shared_ptr<KVStorageClient> client) {
-        generator_ = std::make_shared<EtcdIdGenerator>(
-            client, INODESTOREKEY, USERSTARTINODEID, INODEBUNDLEALLOCATED);
+    explicit InodeIdGeneratorImp(std::shared_ptr<KVStorageClient> client,
+        const IdGeneratorOption &option = IdGeneratorOption()) {
+        generator_ = std::make_shared<EtcdIdGenerator>(client, INODESTOREKEY,
+            USERSTARTINODEID, INODEBUNDLEALLOCATED, option);
     }
     virtual ~InodeIdGeneratorImp() {}
 
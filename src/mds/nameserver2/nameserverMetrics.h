@@ -35,6 +35,12 @@ class NameserverCacheMetrics {
         cacheCount(NameServerMetricsPrefix, "cache_count"),
         cacheBytes(NameServerMetricsPrefix, "cache_bytes") {}
 
+    // 指定metric的前缀，用于区分缓存的不同分片
+    explicit NameserverCacheMetrics(const std::string &prefix) :
+        NameServerMetricsPrefix(prefix),
+        cacheCount(prefix, "cache_count"),
+        cacheBytes(prefix, "cache_bytes") {}
+
     void UpdateAddToCacheCount();
 
     void UpdateRemoveFromCacheCount();
@@ -336,6 +336,81 @@ void NameSpaceService::GetOrAllocateSegment(
     return;
 }
 
+void NameSpaceService::DeAllocateSegment(
+                    ::google::protobuf::RpcController* controller,
+                    const ::curve::mds::DeAllocateSegmentRequest* request,
+                    ::curve::mds::DeAllocateSegmentResponse* response,
+                    ::google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+
+    if (!isPathValid(request->filename())) {
+        response->set_statuscode(StatusCode::kParaError);
+        LOG(ERROR) << "logid = " << cntl->log_id()
+            << ", DeAllocateSegment request path is invalid, filename = "
+            << request->filename()
+            << ", offset = " << request->offset();
+        return;
+    }
+
+    LOG(INFO) << "logid = " << cntl->log_id()
+        << ", DeAllocateSegment request, filename = " << request->filename()
+        << ", offset = " << request->offset();
+
+    // 与GetOrAllocateSegment互斥
+    FileWriteLockGuard guard(fileLockManager_, request->filename());
+
+    std::string signature;
+    if (request->has_signature()) {
+        signature = request->signature();
+    }
+
+    StatusCode retCode;
+    retCode = kCurveFS.CheckFileOwner(request->filename(), request->owner(),
+                                      signature, request->date());
+    if (retCode != StatusCode::kOK) {
+        response->set_statuscode(retCode);
+        if (google::ERROR != GetMdsLogLevel(retCode)) {
+            LOG(WARNING) << "logid = " << cntl->log_id()
+                << ", CheckFileOwner fail, filename = " <<  request->filename()
+                << ", owner = " << request->owner()
+                << ", statusCode = " << retCode;
+        } else {
+            LOG(ERROR) << "logid = " << cntl->log_id()
+                << ", CheckFileOwner fail, filename = " <<  request->filename()
+                << ", owner = " << request->owner()
+                << ", statusCode = " << retCode;
+        }
+        return;
+    }
+
+    retCode = kCurveFS.DeAllocateSegment(request->filename(),
+                                         request->offset());
+    response->set_statuscode(retCode);
+    if (retCode != StatusCode::kOK)  {
+        if (google::ERROR != GetMdsLogLevel(retCode)) {
+            LOG(WARNING) << "logid = " << cntl->log_id()
+                << ", DeAllocateSegment fail, filename = "
+                <<  request->filename()
+                << ", offset = " << request->offset()
+                << ", statusCode = " << retCode
+                << ", StatusCode_Name = " << StatusCode_Name(retCode);
+        } else {
+            LOG(ERROR) << "logid = " << cntl->log_id()
+                << ", DeAllocateSegment fail, filename = "
+                <<  request->filename()
+                << ", offset = " << request->offset()
+                << ", statusCode = " << retCode
+                << ", StatusCode_Name = " << StatusCode_Name(retCode);
+        }
+    } else {
+        LOG(INFO) << "logid = " << cntl->log_id()
+            << ", DeAllocateSegment ok, filename = " << request->filename()
+            << ", offset = " << request->offset();
+    }
+    return;
+}
+
 void NameSpaceService::RenameFile(::google::protobuf::RpcController* controller,
                          const ::curve::mds::RenameFileRequest* request,
                          ::curve::mds::RenameFileResponse* response,
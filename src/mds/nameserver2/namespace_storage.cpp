@@ -21,12 +21,16 @@
  */
 
 #include <glog/logging.h>
+#include <memory>
 #include "src/mds/nameserver2/namespace_storage.h"
 #include "src/mds/nameserver2/helper/namespace_helper.h"
 #include "src/common/namespace_define.h"
 
 using ::curve::common::SNAPSHOTFILEINFOKEYPREFIX;
 using ::curve::common::SNAPSHOTFILEINFOKEYEND;
+using ::curve::common::ALLOCSIZEKEYPREFIX;
+using ::curve::common::ALLOCSIZEKEYEND;
+using ::curve::common::ALLOCSIZESTATEKEY;
 
 namespace curve {
 namespace mds {
@@ -64,7 +68,7 @@ StoreStatus NameServerStorageImp::PutFile(const FileInfo &fileInfo) {
                     << errCode;
     } else {
         // 更新到缓存
-        cache_->Put(storeKey, encodeFileInfo);
+        cache_->Put(storeKey, std::make_shared<const FileInfo>(fileInfo));
     }
 
     return getErrorCode(errCode);
@@ -80,12 +84,18 @@ StoreStatus NameServerStorageImp::GetFile(InodeID parentid,
         return StoreStatus::InternalError;
     }
 
-    int errCode = EtcdErrCode::EtcdOK;
-    std::string out;
-    if (!cache_->Get(storeKey, &out)) {
-        errCode = client_->Get(storeKey, &out);
+    // 缓存中是解码后的FileInfo，命中时直接拷贝
+    CacheValue value;
+    if (cache_->Get(storeKey, &value)) {
+        auto cached = std::dynamic_pointer_cast<const FileInfo>(value);
+        if (cached != nullptr) {
+            fileInfo->CopyFrom(*cached);
+            return StoreStatus::OK;
+        }
     }
 
+    std::string out;
+    int errCode = client_->Get(storeKey, &out);
     if (errCode == EtcdErrCode::EtcdOK) {
         bool decodeOK = NameSpaceStorageCodec::DecodeFileInfo(out, fileInfo);
         if (decodeOK) {
@@ -203,7 +213,7 @@ StoreStatus NameServerStorageImp::RenameFile(const FileInfo &oldFInfo,
                    << errCode;
     } else {
         // 最后更新到缓存
-        cache_->Put(newStoreKey, encodeNewFileInfo);
+        cache_->Put(newStoreKey, std::make_shared<const FileInfo>(newFInfo));
     }
     return getErrorCode(errCode);
 }
@@ -294,8 +304,9 @@ StoreStatus NameServerStorageImp::ReplaceFileAndRecycleOldFile(
                    << errCode;
     } else {
         //更新到缓存
-        cache_->Put(recycleStoreKey, encodeRecycleFInfo);
-        cache_->Put(newStoreKey, encodeNewFInfo);
+        cache_->Put(recycleStoreKey,
+            std::make_shared<const FileInfo>(recycleFInfo));
+        cache_->Put(newStoreKey, std::make_shared<const FileInfo>(newFInfo));
     }
     return getErrorCode(errCode);
 }
@@ -351,7 +362,8 @@ StoreStatus NameServerStorageImp::MoveFileToRecycle(
                    << errCode;
     } else {
         //更新到缓存
-        cache_->Put(recycleFileInfoKey, encodeRecycleFInfo);
+        cache_->Put(recycleFileInfoKey,
+            std::make_shared<const FileInfo>(recycleFileInfo));
     }
     return getErrorCode(errCode);
 }
@@ -472,7 +484,8 @@ StoreStatus NameServerStorageImp::PutSegment(InodeID id,
         LOG(ERROR) << "put segment of logicalPoolId:"
                    << segment->logicalpoolid() << "err:" << errCode;
     } else {
-        cache_->Put(storeKey, encodeSegment);
+        cache_->Put(storeKey,
+            std::make_shared<const PageFileSegment>(*segment));
     }
     return getErrorCode(errCode);
 }
@@ -482,12 +495,18 @@ StoreStatus NameServerStorageImp::GetSegment(InodeID id,
                                              PageFileSegment *segment) {
     std::string storeKey =
         NameSpaceStorageCodec::EncodeSegmentStoreKey(id, off);
-    int errCode = EtcdErrCode::EtcdOK;
-    std::string out;
-    if (!cache_->Get(storeKey, &out)) {
-        errCode = client_->Get(storeKey, &out);
+    // 缓存中是解码后的PageFileSegment，命中时直接拷贝
+    CacheValue value;
+    if (cache_->Get(storeKey, &value)) {
+        auto cached = std::dynamic_pointer_cast<const PageFileSegment>(value);
+        if (cached != nullptr) {
+            segment->CopyFrom(*cached);
+            return StoreStatus::OK;
+        }
     }
 
+    std::string out;
+    int errCode = client_->Get(storeKey, &out);
     if (errCode == EtcdErrCode::EtcdOK) {
         bool decodeOK = NameSpaceStorageCodec::DecodeSegment(out, segment);
         if (decodeOK) {
@@ -580,8 +599,10 @@ StoreStatus NameServerStorageImp::SnapShotFile(const FileInfo *originFInfo,
                    << ", fileinfo: " << originFInfo->filename() << "err";
     } else {
         // 最后put到缓存中
-        cache_->Put(originFileKey, encodeFileInfo);
-        cache_->Put(snapshotFileKey, encodeSnapshot);
+        cache_->Put(originFileKey,
+            std::make_shared<const FileInfo>(*originFInfo));
+        cache_->Put(snapshotFileKey,
+            std::make_shared<const FileInfo>(*snapshotFInfo));
     }
     return getErrorCode(errCode);
 }
@@ -592,6 +613,77 @@ StoreStatus NameServerStorageImp::LoadSnapShotFile(
                             SNAPSHOTFILEINFOKEYEND, snapshotFiles);
 }
 
+StoreStatus NameServerStorageImp::PutAllocSize(
+    InodeID id, const AllocatedSize &allocSize) {
+    std::string storeKey = NameSpaceStorageCodec::EncodeAllocSizeKey(id);
+    std::string value =
+        NameSpaceStorageCodec::EncodeAllocSizeValue(id, allocSize);
+    int errCode = client_->Put(storeKey, value);
+    if (errCode != EtcdErrCode::EtcdOK) {
+        LOG(ERROR) << "put alloc size of inodeid: " << id
+                   << " err: " << errCode;
+    }
+    return getErrorCode(errCode);
+}
+
+StoreStatus NameServerStorageImp::DeleteAllocSize(InodeID id) {
+    std::string storeKey = NameSpaceStorageCodec::EncodeAllocSizeKey(id);
+    int errCode = client_->Delete(storeKey);
+    if (errCode != EtcdErrCode::EtcdOK &&
+        errCode != EtcdErrCode::EtcdKeyNotExist) {
+        LOG(ERROR) << "delete alloc size of inodeid: " << id
+                   << " err: " << errCode;
+        return getErrorCode(errCode);
+    }
+    return StoreStatus::OK;
+}
+
+StoreStatus NameServerStorageImp::LoadAllocSize(
+    std::map<InodeID, AllocatedSize> *allocSizes) {
+    std::vector<std::string> out;
+    int errCode = client_->List(ALLOCSIZEKEYPREFIX, ALLOCSIZEKEYEND, &out);
+    if (errCode != EtcdErrCode::EtcdOK) {
+        LOG(ERROR) << "list alloc size err:" << errCode;
+        return getErrorCode(errCode);
+    }
+
+    for (const auto &value : out) {
+        InodeID id;
+        AllocatedSize allocSize;
+        if (!NameSpaceStorageCodec::DecodeAllocSizeValue(
+                value, &id, &allocSize)) {
+            return StoreStatus::InternalError;
+        }
+        (*allocSizes)[id] = allocSize;
+    }
+    return StoreStatus::OK;
+}
+
+StoreStatus NameServerStorageImp::PutAllocSizeState(bool clean) {
+    int errCode = client_->Put(ALLOCSIZESTATEKEY,
+        NameSpaceStorageCodec::EncodeAllocSizeStateValue(clean));
+    if (errCode != EtcdErrCode::EtcdOK) {
+        LOG(ERROR) << "put alloc size state err: " << errCode;
+    }
+    return getErrorCode(errCode);
+}
+
+StoreStatus NameServerStorageImp::GetAllocSizeState(bool *clean) {
+    std::string out;
+    int errCode = client_->Get(ALLOCSIZESTATEKEY, &out);
+    if (errCode != EtcdErrCode::EtcdOK) {
+        if (errCode != EtcdErrCode::EtcdKeyNotExist) {
+            LOG(ERROR) << "get alloc size state err: " << errCode;
+        }
+        return getErrorCode(errCode);
+    }
+
+    if (!NameSpaceStorageCodec::DecodeAllocSizeStateValue(out, clean)) {
+        return StoreStatus::InternalError;
+    }
+    return StoreStatus::OK;
+}
+
 StoreStatus NameServerStorageImp::getErrorCode(int errCode) {
     switch (errCode) {
         case EtcdErrCode::EtcdOK:
@@ -234,6 +234,54 @@ class NameServerStorage {
      */
     virtual StoreStatus LoadSnapShotFile(
                                     std::vector<FileInfo> *snapShotFiles) = 0;
+
+    /**
+     * @brief PutAllocSize 存储文件或目录的分配大小
+     *
+     * @param[in] id 文件或目录的inode id
+     * @param[in] allocSize 分配大小
+     *
+     * @return StoreStatus 错误码
+     */
+    virtual StoreStatus PutAllocSize(InodeID id,
+                                     const AllocatedSize &allocSize) = 0;
+
+    /**
+     * @brief DeleteAllocSize 删除文件或目录的分配大小
+     *
+     * @param[in] id 文件或目录的inode id
+     *
+     * @return StoreStatus 错误码
+     */
+    virtual StoreStatus DeleteAllocSize(InodeID id) = 0;
+
+    /**
+     * @brief LoadAllocSize 加载所有已记录的分配大小
+     *
+     * @param[out] allocSizes inode id到分配大小的映射
+     *
+     * @return StoreStatus 错误码
+     */
+    virtual StoreStatus LoadAllocSize(
+        std::map<InodeID, AllocatedSize> *allocSizes) = 0;
+
+    /**
+     * @brief PutAllocSizeState 存储分配大小计数的状态
+     *
+     * @param[in] clean 计数是否已全部持久化
+     *
+     * @return StoreStatus 错误码
+     */
+    virtual StoreStatus PutAllocSizeState(bool clean) = 0;
+
+    /**
+     * @brief GetAllocSizeState 获取分配大小计数的状态
+     *
+     * @param[out] clean 计数是否已全部持久化
+     *
+     * @return StoreStatus 错误码，没有记录时返回KeyNotExist
+     */
+    virtual StoreStatus GetAllocSizeState(bool *clean) = 0;
 };
 
 class NameServerStorageImp : public NameServerStorage {
@@ -293,6 +341,18 @@ class NameServerStorageImp : public NameServerStorage {
 
     StoreStatus LoadSnapShotFile(std::vector<FileInfo> *snapShotFiles) override;
 
+    StoreStatus PutAllocSize(InodeID id,
+                             const AllocatedSize &allocSize) override;
+
+    StoreStatus DeleteAllocSize(InodeID id) override;
+
+    StoreStatus LoadAllocSize(
+        std::map<InodeID, AllocatedSize> *allocSizes) override;
+
+    StoreStatus PutAllocSizeState(bool clean) override;
+
+    StoreStatus GetAllocSizeState(bool *clean) override;
+
  private:
     StoreStatus ListFileInternal(const std::string& startStoreKey,
                                  const std::string& endStoreKey,
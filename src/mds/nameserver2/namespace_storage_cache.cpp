@@ -21,16 +21,19 @@
  */
 
 #include <glog/logging.h>
+#include <functional>
+#include <iterator>
+#include <utility>
 #include "src/mds/nameserver2/namespace_storage_cache.h"
 
 namespace curve {
 namespace mds {
-void LRUCache::Put(const std::string &key, const std::string &value) {
+void LRUCache::Put(const std::string &key, const CacheValue &value) {
     ::curve::common::WriteLockGuard guard(lock_);
     PutLocked(key, value);
 }
 
-bool LRUCache::Get(const std::string &key, std::string *value) {
+bool LRUCache::Get(const std::string &key, CacheValue *value) {
     ::curve::common::WriteLockGuard guard(lock_);
     auto iter = cache_.find(key);
     if (iter == cache_.end()) {
@@ -39,7 +42,7 @@ bool LRUCache::Get(const std::string &key, std::string *value) {
 
     // 更新元素在列表中的位置
     MoveToFront(iter->second);
-    *value = cache_[key]->value;
+    *value = iter->second->value;
     return true;
 }
 
@@ -52,7 +55,7 @@ std::shared_ptr<NameserverCacheMetrics> LRUCache::GetCacheMetrics() const {
     return  cacheMetrics_;
 }
 
-void LRUCache::PutLocked(const std::string &key, const std::string &value) {
+void LRUCache::PutLocked(const std::string &key, const CacheValue &value) {
     auto iter = cache_.find(key);
 
     // 如果已存在，删除旧值
@@ -61,11 +64,11 @@ void LRUCache::PutLocked(const std::string &key, const std::string &value) {
     }
 
     // put新值
-    Item kv{key, value};
+    Item kv{key, value, value->ByteSizeLong()};
     ll_.push_front(kv);
     cache_[key] = ll_.begin();
     cacheMetrics_->UpdateAddToCacheCount();
-    cacheMetrics_->UpdateAddToCacheBytes(key.size() + value.size());
+    cacheMetrics_->UpdateAddToCacheBytes(key.size() + kv.size);
     if (maxCount_ != 0 && ll_.size() > maxCount_) {
         RemoveOldest();
     }
@@ -79,10 +82,8 @@ void LRUCache::RemoveLocked(const std::string &key) {
 }
 
 void LRUCache::MoveToFront(const std::list<Item>::iterator &elem) {
-    Item duplica{elem->key, elem->value};
-    ll_.erase(elem);
-    ll_.push_front(duplica);
-    cache_[duplica.key] = ll_.begin();
+    // splice不会使迭代器失效，cache_中记录的位置不需要更新
+    ll_.splice(ll_.begin(), ll_, elem);
 }
 
 void LRUCache::RemoveOldest() {
@@ -91,16 +92,114 @@ void LRUCache::RemoveOldest() {
     }
 }
 
-void LRUCache::RemoveElement(const std::list<Item>::iterator &elem) {
+void LRUCache::RemoveElement(std::list<Item>::iterator elem) {
     cacheMetrics_->UpdateRemoveFromCacheCount();
-    cacheMetrics_->UpdateRemoveFromCacheBytes(
-        elem->key.size() + elem->value.size());
+    cacheMetrics_->UpdateRemoveFromCacheBytes(elem->key.size() + elem->size);
 
     auto iter = cache_.find(elem->key);
     cache_.erase(iter);
     ll_.erase(elem);
 }
 
+ShardedLRUCache::ShardedLRUCache(uint64_t maxCount, uint32_t shardNum) {
+    if (shardNum == 0) {
+        shardNum = 1;
+    }
+    shardMaxCount_ = (maxCount + shardNum - 1) / shardNum;
+    cacheMetrics_ = std::make_shared<NameserverCacheMetrics>();
+    for (uint32_t i = 0; i < shardNum; ++i) {
+        std::unique_ptr<Shard> shard(new Shard());
+        shard->metrics = std::make_shared<NameserverCacheMetrics>(
+            cacheMetrics_->NameServerMetricsPrefix + "_shard_" +
+            std::to_string(i));
+        shards_.emplace_back(std::move(shard));
+    }
+}
+
+ShardedLRUCache::Shard *ShardedLRUCache::GetShard(
+    const std::string &key) const {
+    return shards_[std::hash<std::string>()(key) % shards_.size()].get();
+}
+
+void ShardedLRUCache::Put(const std::string &key, const CacheValue &value) {
+    Shard *shard = GetShard(key);
+    ::curve::common::WriteLockGuard guard(shard->lock);
+    auto iter = shard->cache.find(key);
+    if (iter != shard->cache.end()) {
+        RemoveElement(shard, iter->second);
+    } else if (shardMaxCount_ != 0 && shard->ll.size() >= shardMaxCount_) {
+        // 先淘汰再放入，避免新放入还没有访问标记的元素被淘汰
+        EvictOne(shard);
+    }
+
+    uint64_t size = value->ByteSizeLong();
+    shard->ll.emplace_front(key, value, size);
+    shard->cache[key] = shard->ll.begin();
+    shard->metrics->UpdateAddToCacheCount();
+    shard->metrics->UpdateAddToCacheBytes(key.size() + size);
+    cacheMetrics_->UpdateAddToCacheCount();
+    cacheMetrics_->UpdateAddToCacheBytes(key.size() + size);
+}
+
+bool ShardedLRUCache::Get(const std::string &key, CacheValue *value) {
+    Shard *shard = GetShard(key);
+    ::curve::common::ReadLockGuard guard(shard->lock);
+    auto iter = shard->cache.find(key);
+    if (iter == shard->cache.end()) {
+        return false;
+    }
+
+    // 只设置访问标记，淘汰时再调整位置
+    if (!iter->second->referenced.load(std::memory_order_relaxed)) {
+        iter->second->referenced.store(true, std::memory_order_relaxed);
+    }
+    *value = iter->second->value;
+    return true;
+}
+
+void ShardedLRUCache::Remove(const std::string &key) {
+    Shard *shard = GetShard(key);
+    ::curve::common::WriteLockGuard guard(shard->lock);
+    auto iter = shard->cache.find(key);
+    if (iter != shard->cache.end()) {
+        RemoveElement(shard, iter->second);
+    }
+}
+
+std::shared_ptr<NameserverCacheMetrics>
+ShardedLRUCache::GetCacheMetrics() const {
+    return cacheMetrics_;
+}
+
+std::shared_ptr<NameserverCacheMetrics>
+ShardedLRUCache::GetShardMetrics(uint32_t index) const {
+    return shards_[index]->metrics;
+}
+
+void ShardedLRUCache::RemoveElement(Shard *shard,
+    std::list<ClockItem>::iterator elem) {
+    shard->metrics->UpdateRemoveFromCacheCount();
+    shard->metrics->UpdateRemoveFromCacheBytes(elem->key.size() + elem->size);
+    cacheMetrics_->UpdateRemoveFromCacheCount();
+    cacheMetrics_->UpdateRemoveFromCacheBytes(elem->key.size() + elem->size);
+    shard->cache.erase(elem->key);
+    shard->ll.erase(elem);
+}
+
+void ShardedLRUCache::EvictOne(Shard *shard) {
+    // 每个元素最多被移到队首一次，最多遍历两轮
+    while (!shard->ll.empty()) {
+        auto elem = std::prev(shard->ll.end());
+        if (elem->referenced.load(std::memory_order_relaxed)) {
+            elem->referenced.store(false, std::memory_order_relaxed);
+            shard->ll.splice(shard->ll.begin(), shard->ll, elem);
+            continue;
+        }
+        RemoveElement(shard, elem);
+        return;
+    }
+}
+
 }  // namespace mds
 }  // namespace curve
 
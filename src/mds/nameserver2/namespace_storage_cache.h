@@ -23,18 +23,28 @@
 #ifndef SRC_MDS_NAMESERVER2_NAMESPACE_STORAGE_CACHE_H_
 #define SRC_MDS_NAMESERVER2_NAMESPACE_STORAGE_CACHE_H_
 
+#include <google/protobuf/message.h>
+#include <atomic>
 #include <string>
 #include <list>
 #include <map>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include "src/common/concurrent/concurrent.h"
 #include "src/mds/nameserver2/nameserverMetrics.h"
 
 namespace curve {
 namespace mds {
+// 缓存中存放解码后的元数据(FileInfo/PageFileSegment)，放入缓存之后不再修改，
+// 由多个读者共享，命中时不需要再解析protobuf
+using CacheValue = std::shared_ptr<const ::google::protobuf::Message>;
+
 struct Item {
     std::string key;
-    std::string value;
+    CacheValue value;
+    // value序列化之后的大小，用于统计缓存占用的空间
+    uint64_t size;
 };
 
 class Cache {
@@ -43,9 +53,9 @@ class Cache {
     * @brief Put 存储key-value到缓存
     *
     * @param[in] key
-    * @param[in] value
+    * @param[in] value 解码后的元数据，放入缓存之后不能再修改
     */
-    virtual void Put(const std::string &key, const std::string &value) = 0;
+    virtual void Put(const std::string &key, const CacheValue &value) = 0;
 
     /*
     * @brief Get 从缓存中获取key对应的value
@@ -55,7 +65,7 @@ class Cache {
     *
     * @return false-获取不到 true-获取成功
     */
-    virtual bool Get(const std::string &key, std::string *value) = 0;
+    virtual bool Get(const std::string &key, CacheValue *value) = 0;
 
     /*
     * @brief Remove 从缓存中移除key-value
@@ -74,8 +84,8 @@ class LRUCache : public Cache {
         cacheMetrics_ = std::make_shared<NameserverCacheMetrics>();
     }
 
-    void Put(const std::string &key, const std::string &value) override;
-    bool Get(const std::string &key, std::string *value) override;
+    void Put(const std::string &key, const CacheValue &value) override;
+    bool Get(const std::string &key, CacheValue *value) override;
     void Remove(const std::string &key) override;
     std::shared_ptr<NameserverCacheMetrics> GetCacheMetrics() const;
 
@@ -86,7 +96,7 @@ class LRUCache : public Cache {
     * @param[in] key
     * @param[in] value
     */
-    void PutLocked(const std::string &key, const std::string &value);
+    void PutLocked(const std::string &key, const CacheValue &value);
 
     /*
     * @brief RemoveLocked 从缓存中移除key-value，非线程安全
@@ -110,9 +120,10 @@ class LRUCache : public Cache {
     /*
     * @brief RemoveElement 移除指定元素
     *
-    * @param[in] elem 指定元素
+    * @param[in] elem 指定元素，传值是因为调用方传入的可能是cache_中的值，
+    *                 从cache_中删除之后引用失效
     */
-    void RemoveElement(const std::list<Item>::iterator &elem);
+    void RemoveElement(std::list<Item>::iterator elem);
 
  private:
     ::curve::common::RWLock lock_;
@@ -128,6 +139,81 @@ class LRUCache : public Cache {
     std::shared_ptr<NameserverCacheMetrics> cacheMetrics_;
 };
 
+/**
+ * 分片的近似LRU缓存
+ * 1. key按hash分配到固定的分片，每个分片一把读写锁，不同分片互不影响
+ * 2. 命中时只在读锁下设置元素的访问标记，不移动元素在队列中的位置，
+ *    多个线程的Get可以并发执行
+ * 3. 淘汰时从队尾开始检查，有访问标记的元素清除标记后移到队首(CLOCK)，
+ *    没有访问标记的元素被淘汰
+ */
+class ShardedLRUCache : public Cache {
+ public:
+    /**
+     * @param maxCount 缓存的最大元素数量，平均分配到各分片，为0表示不限
+     * @param shardNum 分片数量，为0时按1处理
+     */
+    ShardedLRUCache(uint64_t maxCount, uint32_t shardNum);
+
+    void Put(const std::string &key, const CacheValue &value) override;
+    bool Get(const std::string &key, CacheValue *value) override;
+    void Remove(const std::string &key) override;
+
+    /**
+     * @brief 获取所有分片汇总的metric
+     */
+    std::shared_ptr<NameserverCacheMetrics> GetCacheMetrics() const;
+
+    /**
+     * @brief 获取单个分片的metric
+     */
+    std::shared_ptr<NameserverCacheMetrics> GetShardMetrics(
+        uint32_t index) const;
+
+    uint32_t GetShardNum() const {
+        return shards_.size();
+    }
+
+ private:
+    struct ClockItem {
+        ClockItem(const std::string &k, const CacheValue &v, uint64_t s)
+            : key(k), value(v), size(s), referenced(false) {}
+
+        std::string key;
+        CacheValue value;
+        uint64_t size;
+        // 上次淘汰检查之后是否被访问过，持有读锁时也可以修改
+        std::atomic<bool> referenced;
+    };
+
+    struct Shard {
+        ::curve::common::RWLock lock;
+        std::list<ClockItem> ll;
+        std::unordered_map<std::string, std::list<ClockItem>::iterator> cache;
+        std::shared_ptr<NameserverCacheMetrics> metrics;
+    };
+
+    Shard *GetShard(const std::string &key) const;
+
+    /**
+     * @brief 从分片中删除元素，需要持有分片的写锁
+     */
+    void RemoveElement(Shard *shard, std::list<ClockItem>::iterator elem);
+
+    /**
+     * @brief 按CLOCK策略淘汰一个元素，需要持有分片的写锁
+     */
+    void EvictOne(Shard *shard);
+
+ private:
+    // 每个分片的最大长度，为0表示长度不限
+    uint64_t shardMaxCount_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    // 所有分片汇总的metric
+    std::shared_ptr<NameserverCacheMetrics> cacheMetrics_;
+};
+
 }  // namespace mds
 }  // namespace curve
 
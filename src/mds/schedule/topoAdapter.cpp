@@ -25,6 +25,7 @@
 #include <string>
 #include <map>
 #include <memory>
+#include <utility>
 #include "src/mds/schedule/topoAdapter.h"
 #include "src/mds/common/mds_define.h"
 #include "proto/topology.pb.h"
@@ -151,10 +152,12 @@ bool ChunkServerInfo::IsHealthy() const {
 TopoAdapterImpl::TopoAdapterImpl(
     std::shared_ptr<Topology> topo,
     std::shared_ptr<TopologyServiceManager> manager,
-    std::shared_ptr<TopologyStat> stat) {
+    std::shared_ptr<TopologyStat> stat,
+    bool enableSnapshot) {
     this->topo_ = topo;
     this->topoServiceManager_ = manager;
     this->topoStat_ = stat;
+    this->enableSnapshot_ = enableSnapshot;
 }
 
 std::vector<PoolIdType> TopoAdapterImpl::GetLogicalpools() {
@@ -162,6 +165,16 @@ std::vector<PoolIdType> TopoAdapterImpl::GetLogicalpools() {
 }
 
 bool TopoAdapterImpl::GetCopySetInfo(const CopySetKey &id, CopySetInfo *info) {
+    if (enableSnapshot_) {
+        auto snapshot = topo_->GetSnapshot();
+        const CopySetSnapshot *copySet = snapshot->FindCopySet(id);
+        if (copySet == nullptr ||
+            snapshot->FindLogicalPool(id.first) == nullptr) {
+            return false;
+        }
+        return CopySetFromSnapshot(*snapshot, *copySet, info);
+    }
+
     ::curve::mds::topology::CopySetInfo csInfo;
     // cannot get copyset info
     if (!topo_->GetCopySet(id, &csInfo)) {
@@ -184,6 +197,21 @@ bool TopoAdapterImpl::GetCopySetInfo(const CopySetKey &id, CopySetInfo *info) {
 
 std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfos() {
     std::vector<CopySetInfo> infos;
+    if (enableSnapshot_) {
+        auto snapshot = topo_->GetSnapshot();
+        infos.reserve(snapshot->GetCopySets().size());
+        for (const auto &copySet : snapshot->GetCopySets()) {
+            if (!copySet.logicalPoolAvailable) {
+                continue;
+            }
+            CopySetInfo info;
+            if (CopySetFromSnapshot(*snapshot, copySet, &info)) {
+                infos.emplace_back(std::move(info));
+            }
+        }
+        return infos;
+    }
+
     for (auto copySetKey : topo_->GetCopySetsInCluster()) {
         CopySetInfo copySetInfo;
         if (GetCopySetInfo(copySetKey, &copySetInfo)) {
@@ -197,6 +225,26 @@ std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfos() {
 
 std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfosInChunkServer(
     ChunkServerIdType id) {
+    if (enableSnapshot_) {
+        std::vector<CopySetInfo> out;
+        auto snapshot = topo_->GetSnapshot();
+        const ChunkServerSnapshot *cs = snapshot->FindChunkServer(id);
+        if (cs == nullptr) {
+            return out;
+        }
+        for (uint32_t index : cs->copySets) {
+            const CopySetSnapshot &copySet = snapshot->GetCopySets()[index];
+            if (!copySet.logicalPoolAvailable) {
+                continue;
+            }
+            CopySetInfo info;
+            if (CopySetFromSnapshot(*snapshot, copySet, &info)) {
+                out.emplace_back(std::move(info));
+            }
+        }
+        return out;
+    }
+
     std::vector<CopySetKey> keys = topo_->GetCopySetsInChunkServer(id);
 
     std::vector<CopySetInfo> out;
@@ -214,6 +262,22 @@ std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfosInChunkServer(
 std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfosInLogicalPool(
     PoolIdType lid) {
     std::vector<CopySetInfo> infos;
+    if (enableSnapshot_) {
+        auto snapshot = topo_->GetSnapshot();
+        auto pool = snapshot->FindLogicalPool(lid);
+        if (pool == nullptr) {
+            return infos;
+        }
+        for (uint32_t i = pool->copySetBegin; i < pool->copySetEnd; ++i) {
+            CopySetInfo info;
+            if (CopySetFromSnapshot(*snapshot,
+                    snapshot->GetCopySets()[i], &info)) {
+                infos.emplace_back(std::move(info));
+            }
+        }
+        return infos;
+    }
+
     for (auto &copysetInfo : topo_->GetCopySetInfosInLogicalPool(lid)) {
         ::curve::mds::schedule::CopySetInfo out;
         if (CopySetFromTopoToSchedule(copysetInfo, &out)) {
@@ -228,6 +292,18 @@ bool TopoAdapterImpl::GetChunkServerInfo(ChunkServerIdType id,
                                          ChunkServerInfo *out) {
     assert(out != nullptr);
 
+    if (enableSnapshot_) {
+        auto snapshot = topo_->GetSnapshot();
+        const ChunkServerSnapshot *cs = snapshot->FindChunkServer(id);
+        if (cs == nullptr) {
+            LOG(ERROR) << "can not get chunkServer:" << id
+                       << " from topology snapshot";
+            return false;
+        }
+        ChunkServerFromSnapshot(*cs, out);
+        return true;
+    }
+
     ::curve::mds::topology::ChunkServer cs;
     if (!topo_->GetChunkServer(id, &cs)) {
         LOG(ERROR) << "can not get chunkServer:" << id << " from topology";
@@ -238,6 +314,19 @@ bool TopoAdapterImpl::GetChunkServerInfo(ChunkServerIdType id,
 
 std::vector<ChunkServerInfo> TopoAdapterImpl::GetChunkServerInfos() {
     std::vector<ChunkServerInfo> infos;
+    if (enableSnapshot_) {
+        auto snapshot = topo_->GetSnapshot();
+        for (const auto &cs : snapshot->GetChunkServers()) {
+            if (cs.status == ChunkServerStatus::RETIRED) {
+                continue;
+            }
+            ChunkServerInfo info;
+            ChunkServerFromSnapshot(cs, &info);
+            infos.emplace_back(std::move(info));
+        }
+        return infos;
+    }
+
     for (auto chunkServerId : topo_->GetChunkServerInCluster(
         [] (const ChunkServer &cs) {
             return cs.GetStatus() != ChunkServerStatus::RETIRED;
@@ -254,6 +343,25 @@ std::vector<ChunkServerInfo> TopoAdapterImpl::GetChunkServerInfos() {
 std::vector<ChunkServerInfo> TopoAdapterImpl::GetChunkServersInLogicalPool(
     PoolIdType lid) {
     std::vector<ChunkServerInfo> infos;
+    if (enableSnapshot_) {
+        auto snapshot = topo_->GetSnapshot();
+        auto pool = snapshot->FindLogicalPool(lid);
+        if (pool == nullptr) {
+            return infos;
+        }
+        for (uint32_t index : pool->chunkServers) {
+            const ChunkServerSnapshot &cs =
+                snapshot->GetChunkServers()[index];
+            if (cs.status == ChunkServerStatus::RETIRED) {
+                continue;
+            }
+            ChunkServerInfo info;
+            ChunkServerFromSnapshot(cs, &info);
+            infos.emplace_back(std::move(info));
+        }
+        return infos;
+    }
+
     auto ids = topo_->GetChunkServerInLogicalPool(lid,
         [](const ChunkServer &chunkserver) {
             return chunkserver.GetStatus() != ChunkServerStatus::RETIRED;
@@ -359,6 +467,57 @@ bool TopoAdapterImpl::CopySetFromTopoToSchedule(
     return true;
 }
 
+bool TopoAdapterImpl::CopySetFromSnapshot(const TopologySnapshot &snapshot,
+    const CopySetSnapshot &origin, CopySetInfo *out) {
+    out->id = origin.key;
+    out->epoch = origin.epoch;
+    out->leader = origin.leader;
+    out->logicalPoolWork = origin.logicalPoolAvailable;
+
+    out->peers.reserve(origin.members.size());
+    for (ChunkServerIdType id : origin.members) {
+        const ChunkServerSnapshot *cs = snapshot.FindChunkServer(id);
+        if (cs == nullptr) {
+            LOG(ERROR) << "topoAdapter can not find chunkServer " << id
+                       << " in topology snapshot";
+            return false;
+        }
+        out->peers.emplace_back(cs->id, cs->zoneId, cs->serverId,
+                                cs->hostIp, cs->port);
+    }
+
+    if (origin.candidate != UNINTIALIZE_ID) {
+        const ChunkServerSnapshot *cs =
+            snapshot.FindChunkServer(origin.candidate);
+        if (cs == nullptr) {
+            LOG(ERROR) << "topoAdapter can not find candidate "
+                       << origin.candidate << " in topology snapshot";
+            return false;
+        }
+        out->candidatePeerInfo = PeerInfo(cs->id, cs->zoneId, cs->serverId,
+                                          cs->hostIp, cs->port);
+    }
+    return true;
+}
+
+void TopoAdapterImpl::ChunkServerFromSnapshot(
+    const ChunkServerSnapshot &origin, ChunkServerInfo *out) {
+    out->info = PeerInfo(origin.id, origin.zoneId, origin.serverId,
+                         origin.hostIp, origin.port);
+    out->startUpTime = origin.startUpTime;
+    out->state = origin.onlineState;
+    out->status = origin.status;
+    out->diskState = origin.diskState;
+    // 磁盘容量和使用量每次心跳都会变化，不会触发快照重建，从topology中读取
+    ::curve::mds::topology::ChunkServer cs;
+    if (topo_->GetChunkServer(origin.id, &cs)) {
+        out->diskCapacity = cs.GetChunkServerState().GetDiskCapacity();
+        out->diskUsed = cs.GetChunkServerState().GetDiskUsed();
+    }
+    // 快照中的leader数量由copyset的leader统计得到，与心跳上报的一致
+    out->leaderCount = origin.leaderCount;
+}
+
 bool TopoAdapterImpl::ChunkServerFromTopoToSchedule(
     const ::curve::mds::topology::ChunkServer &origin,
     ::curve::mds::schedule::ChunkServerInfo *out) {
@@ -403,6 +562,30 @@ void TopoAdapterImpl::GetChunkServerScatterMap(
     const ChunkServerIdType &cs, std::map<ChunkServerIdType, int> *out) {
     assert(out != nullptr);
 
+    if (enableSnapshot_) {
+        auto snapshot = topo_->GetSnapshot();
+        const ChunkServerSnapshot *target = snapshot->FindChunkServer(cs);
+        if (target == nullptr) {
+            return;
+        }
+        for (uint32_t index : target->copySets) {
+            for (ChunkServerIdType peerId :
+                snapshot->GetCopySets()[index].members) {
+                if (peerId == cs) {
+                    continue;
+                }
+                const ChunkServerSnapshot *peer =
+                    snapshot->FindChunkServer(peerId);
+                if (peer == nullptr ||
+                    peer->onlineState == OnlineState::OFFLINE) {
+                    continue;
+                }
+                (*out)[peerId]++;
+            }
+        }
+        return;
+    }
+
     std::vector<CopySetKey> copySetsInCS = topo_->GetCopySetsInChunkServer(cs);
     for (auto key : copySetsInCS) {
         ::curve::mds::topology::CopySetInfo copySetInfo;
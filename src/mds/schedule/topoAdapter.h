@@ -52,6 +52,9 @@ using ::curve::mds::topology::DiskState;
 using ::curve::mds::topology::ChunkServerStatus;
 using ::curve::mds::topology::ChunkServerStat;
 using ::curve::mds::topology::UNINTIALIZE_ID;
+using ::curve::mds::topology::TopologySnapshot;
+using ::curve::mds::topology::ChunkServerSnapshot;
+using ::curve::mds::topology::CopySetSnapshot;
 using ::curve::mds::heartbeat::ConfigChangeInfo;
 using ::curve::mds::heartbeat::ConfigChangeType;
 using ::curve::mds::heartbeat::CopysetStatistics;
@@ -312,12 +315,15 @@ class TopoAdapter {
 };
 
 // adapter实现
+// 开启快照时copyset和chunkserver相关的查询都从topology快照中获取，
+// 不需要再逐个copyset和chunkserver加锁查询topology
 class TopoAdapterImpl : public TopoAdapter {
  public:
     TopoAdapterImpl() = default;
     explicit TopoAdapterImpl(std::shared_ptr<Topology> topo,
                              std::shared_ptr<TopologyServiceManager> manager,
-                             std::shared_ptr<TopologyStat> stat);
+                             std::shared_ptr<TopologyStat> stat,
+                             bool enableSnapshot = false);
 
     std::vector<PoolIdType> GetLogicalpools() override;
 
@@ -363,10 +369,26 @@ class TopoAdapterImpl : public TopoAdapter {
  private:
     bool GetPeerInfo(ChunkServerIdType id, PeerInfo *peerInfo);
 
+    /**
+     * @brief 把快照中的copyset转化为schedule中的类型
+     *
+     * @return false-copyset的成员或candidate不在快照中 true-转化成功
+     */
+    bool CopySetFromSnapshot(const TopologySnapshot &snapshot,
+        const CopySetSnapshot &origin, CopySetInfo *out);
+
+    /**
+     * @brief 把快照中的chunkserver转化为schedule中的类型，
+     *        磁盘容量和使用量从topology中读取
+     */
+    void ChunkServerFromSnapshot(const ChunkServerSnapshot &origin,
+        ChunkServerInfo *out);
+
  private:
     std::shared_ptr<Topology> topo_;
     std::shared_ptr<TopologyServiceManager> topoServiceManager_;
     std::shared_ptr<TopologyStat> topoStat_;
+    bool enableSnapshot_ = false;
 };
 }  // namespace schedule
 }  // namespace mds
@@ -58,6 +58,8 @@ void MDS::InitMdsOptions(std::shared_ptr<Configuration> conf) {
 
     // namestorage的缓存大小
     conf_->GetValueFatalIfFail("mds.cache.count", &options_.mdsCacheCount);
+    conf_->GetValueFatalIfFail(
+        "mds.cache.shardNum", &options_.mdsCacheShardNum);
 
     // 获取mds监听地址
     conf_->GetValueFatalIfFail("mds.listen.addr", &options_.mdsListenAddr);
@@ -117,7 +119,7 @@ void MDS::Init() {
     InitSegmentAllocStatistic(options_.retryInterTimes,
                               options_.periodicPersistInterMs);
     // 初始化NameServer存储模块
-    InitNameServerStorage(options_.mdsCacheCount);
+    InitNameServerStorage(options_.mdsCacheCount, options_.mdsCacheShardNum);
     // init topology
     InitTopology(options_.topologyOption);
     // init TopologyStat
@@ -321,6 +323,9 @@ void MDS::InitTopologyOption(TopologyOption *topologyOption) {
     conf_->GetValueFatalIfFail(
         "mds.topology.choosePoolPolicy",
         &topologyOption->choosePoolPolicy);
+    conf_->GetValueFatalIfFail(
+        "mds.topology.enableSnapshot",
+        &topologyOption->enableSnapshot);
 }
 
 void MDS::InitTopology(const TopologyOption& option) {
@@ -401,10 +406,19 @@ void MDS::InitTopologyChunkAllocator(const TopologyOption& option) {
     LOG(INFO) << "init topologyChunkAllocator success.";
 }
 
-void MDS::InitNameServerStorage(int mdsCacheCount) {
+void MDS::InitNameServerStorage(int mdsCacheCount,
+                                uint32_t mdsCacheShardNum) {
     // init LRUCache
-    auto cache = std::make_shared<LRUCache>(mdsCacheCount);
-    LOG(INFO) << "init LRUCache success.";
+    std::shared_ptr<Cache> cache;
+    if (mdsCacheShardNum > 0) {
+        cache = std::make_shared<ShardedLRUCache>(mdsCacheCount,
+                                                  mdsCacheShardNum);
+        LOG(INFO) << "init ShardedLRUCache success, shard num: "
+                  << mdsCacheShardNum;
+    } else {
+        cache = std::make_shared<LRUCache>(mdsCacheCount);
+        LOG(INFO) << "init LRUCache success.";
+    }
 
     // init NameServerStorage
     nameServerStorage_ = std::make_shared<NameServerStorageImp>(etcdClient_,
@@ -414,10 +428,12 @@ void MDS::InitNameServerStorage(int mdsCacheCount) {
 
 void MDS::InitCurveFS(const CurveFSOption& curveFSOptions) {
     // init InodeIDGenerator
-    auto inodeIdGenerator = std::make_shared<InodeIdGeneratorImp>(etcdClient_);
+    auto inodeIdGenerator = std::make_shared<InodeIdGeneratorImp>(
+        etcdClient_, curveFSOptions.idGeneratorOption);
 
     // init ChunkIDGenerator
-    auto chunkIdGenerator = std::make_shared<ChunkIDGeneratorImp>(etcdClient_);
+    auto chunkIdGenerator = std::make_shared<ChunkIDGeneratorImp>(
+        etcdClient_, curveFSOptions.idGeneratorOption);
 
     // init ChunkSegmentAllocator
     auto chunkSegmentAllocate =
@@ -458,6 +474,18 @@ void MDS::InitAuthOptions(RootAuthOption *authOptions) {
 void MDS::InitCurveFSOptions(CurveFSOption *curveFSOptions) {
     conf_->GetValueFatalIfFail(
         "mds.curvefs.defaultChunkSize", &curveFSOptions->defaultChunkSize);
+    conf_->GetValueFatalIfFail(
+        "mds.curvefs.dirPathCacheCount", &curveFSOptions->dirPathCacheCount);
+    conf_->GetValueFatalIfFail("mds.curvefs.enableAllocSizeCounter",
+        &curveFSOptions->enableAllocSizeCounter);
+    conf_->GetValueFatalIfFail("mds.curvefs.allocSizePersistIntervalMs",
+        &curveFSOptions->allocSizePersistIntervalMs);
+    conf_->GetValueFatalIfFail("mds.idgenerator.enablePrefetch",
+        &curveFSOptions->idGeneratorOption.enablePrefetch);
+    conf_->GetValueFatalIfFail("mds.idgenerator.maxBundleSize",
+        &curveFSOptions->idGeneratorOption.maxBundleSize);
+    conf_->GetValueFatalIfFail("mds.idgenerator.bundleLifeMs",
+        &curveFSOptions->idGeneratorOption.bundleLifeMs);
     FileRecordOptions fileRecordOptions;
     InitFileRecordOptions(&curveFSOptions->fileRecordOptions);
 
@@ -476,15 +504,32 @@ void MDS::InitCleanManager() {
         std::make_shared<CopysetClient>(topology_, chunkServerClientOption,
                                                         channelPool);
 
+    CleanCoreOption cleanCoreOption;
+    InitCleanCoreOption(&cleanCoreOption);
     auto cleanCore = std::make_shared<CleanCore>(nameServerStorage_,
                                                  copysetClient,
-                                                 segmentAllocStatistic_);
+                                                 segmentAllocStatistic_,
+                                                 cleanCoreOption,
+                                                 topology_);
 
     cleanManager_ = std::make_shared<CleanManager>(cleanCore,
                                             taskManager, nameServerStorage_);
     LOG(INFO) << "init CleanManager success.";
 }
 
+void MDS::InitCleanCoreOption(CleanCoreOption *option) {
+    conf_->GetValueFatalIfFail("mds.clean.concurrency",
+        &option->concurrency);
+    conf_->GetValueFatalIfFail("mds.clean.chunkserverConcurrency",
+        &option->chunkserverConcurrency);
+    conf_->GetValueFatalIfFail("mds.clean.maxChunksPerSecond",
+        &option->maxChunksPerSecond);
+    conf_->GetValueFatalIfFail("mds.clean.deleteBatchSize",
+        &option->deleteBatchSize);
+    conf_->GetValueFatalIfFail("mds.clean.deleteSegmentWindow",
+        &option->deleteSegmentWindow);
+}
+
 void MDS::InitChunkServerClientOption(ChunkServerClientOption *option) {
     conf_->GetValueFatalIfFail("mds.chunkserverclient.rpcTimeoutMs",
         &option->rpcTimeoutMs);
@@ -506,7 +551,8 @@ void MDS::InitCoordinator() {
 
     auto scheduleMetrics = std::make_shared<ScheduleMetrics>(topology_);
     auto topoAdapter = std::make_shared<TopoAdapterImpl>(
-        topology_, topologyServiceManager_, topologyStat_);
+        topology_, topologyServiceManager_, topologyStat_,
+        options_.topologyOption.enableSnapshot);
     coordinator_ = std::make_shared<Coordinator>(topoAdapter);
     coordinator_->InitScheduler(scheduleOption, scheduleMetrics);
 }
@@ -570,6 +616,10 @@ void MDS::InitHeartbeatOption(HeartbeatOption* heartbeatOption) {
                         &heartbeatOption->offLineTimeOutMs);
     conf_->GetValueFatalIfFail("mds.heartbeat.clean_follower_afterMs",
                         &heartbeatOption->cleanFollowerAfterMs);
+    conf_->GetValueFatalIfFail("mds.heartbeat.shardNum",
+                        &heartbeatOption->shardNum);
+    conf_->GetValueFatalIfFail("mds.heartbeat.shardQueueCapacity",
+                        &heartbeatOption->shardQueueCapacity);
 }
 }  // namespace mds
 }  // namespace curve
@@ -92,6 +92,8 @@ struct MDSOptions {
     uint64_t periodicPersistInterMs;
     // namestorage的缓存大小
     int mdsCacheCount;
+    // namestorage缓存的分片数量，为0时使用不分片的LRU缓存
+    uint32_t mdsCacheShardNum;
     // mds的文件锁桶大小
     int mdsFilelockBucketNum;
 
@@ -204,6 +206,12 @@ class MDS {
      */
     void InitChunkServerClientOption(ChunkServerClientOption *option);
 
+    /**
+     * @brief 初始化clean core option
+     * @param[out] option 删除chunk的并发和限流选项
+     */
+    void InitCleanCoreOption(CleanCoreOption *option);
+
     /**
      * @brief 初始化etcd client
      * @param etcdConf etcd配置项
@@ -231,8 +239,9 @@ class MDS {
     /**
      * @brief 初始化nameserver存储模块
      * @param mdsCacheCount 缓存大小
+     * @param mdsCacheShardNum 缓存分片数量
      */
-    void InitNameServerStorage(int mdsCacheCount);
+    void InitNameServerStorage(int mdsCacheCount, uint32_t mdsCacheShardNum);
 
     /**
      * @brief 开启brpc server
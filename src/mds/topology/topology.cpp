@@ -22,7 +22,9 @@
 #include "src/mds/topology/topology.h"
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <chrono>  //NOLINT
+#include <utility>
 
 #include "src/common/uuid.h"
 
@@ -66,6 +68,7 @@ int TopologyImpl::AddLogicalPool(const LogicalPool &data) {
                 return kTopoErrCodeStorgeFail;
             }
             logicalPoolMap_[data.GetId()] = data;
+            IncreaseVersion();
             return kTopoErrCodeSuccess;
         } else {
             return kTopoErrCodeIdDuplicated;
@@ -82,6 +85,7 @@ int TopologyImpl::AddPhysicalPool(const PhysicalPool &data) {
             return kTopoErrCodeStorgeFail;
         }
         physicalPoolMap_[data.GetId()] = data;
+        IncreaseVersion();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeIdDuplicated;
@@ -99,6 +103,7 @@ int TopologyImpl::AddZone(const Zone &data) {
             }
             it->second.AddZone(data.GetId());
             zoneMap_[data.GetId()] = data;
+            IncreaseVersion();
             return kTopoErrCodeSuccess;
         } else {
             return kTopoErrCodeIdDuplicated;
@@ -119,6 +124,7 @@ int TopologyImpl::AddServer(const Server &data) {
             }
             it->second.AddServer(data.GetId());
             serverMap_[data.GetId()] = data;
+            IncreaseVersion();
             return kTopoErrCodeSuccess;
         } else {
             return kTopoErrCodeIdDuplicated;
@@ -150,7 +156,13 @@ int TopologyImpl::AddChunkServer(const ChunkServer &data) {
                 }
                 it->second.AddChunkServer(data.GetId());
                 chunkServerMap_[data.GetId()] = data;
+                {
+                    WriteLockGuard wlockIndex(chunkServerEndpointMutex_);
+                    UpdateChunkServerEndpointIndex(data.GetId(), "",
+                        BuildPeerId(data.GetHostIp(), data.GetPort()));
+                }
                 csCapacity = data.GetChunkServerState().GetDiskCapacity();
+                IncreaseVersion();
             } else {
                 return kTopoErrCodeIdDuplicated;
             }
@@ -178,6 +190,7 @@ int TopologyImpl::RemoveLogicalPool(PoolIdType id) {
             return kTopoErrCodeStorgeFail;
         }
         logicalPoolMap_.erase(it);
+        IncreaseVersion();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeLogicalPoolNotFound;
@@ -195,6 +208,7 @@ int TopologyImpl::RemovePhysicalPool(PoolIdType id) {
             return kTopoErrCodeStorgeFail;
         }
         physicalPoolMap_.erase(it);
+        IncreaseVersion();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodePhysicalPoolNotFound;
@@ -217,6 +231,7 @@ int TopologyImpl::RemoveZone(ZoneIdType id) {
             ix->second.RemoveZone(id);
         }
         zoneMap_.erase(it);
+        IncreaseVersion();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeZoneNotFound;
@@ -239,6 +254,7 @@ int TopologyImpl::RemoveServer(ServerIdType id) {
             ix->second.RemoveServer(id);
         }
         serverMap_.erase(it);
+        IncreaseVersion();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeServerNotFound;
@@ -260,7 +276,14 @@ int TopologyImpl::RemoveChunkServer(ChunkServerIdType id) {
         if (ix != serverMap_.end()) {
             ix->second.RemoveChunkServer(id);
         }
+        {
+            WriteLockGuard wlockIndex(chunkServerEndpointMutex_);
+            UpdateChunkServerEndpointIndex(id,
+                BuildPeerId(it->second.GetHostIp(), it->second.GetPort()),
+                "");
+        }
         chunkServerMap_.erase(it);
+        IncreaseVersion();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeChunkServerNotFound;
@@ -275,6 +298,7 @@ int TopologyImpl::UpdateLogicalPool(const LogicalPool &data) {
             return kTopoErrCodeStorgeFail;
         }
         it->second = data;
+        IncreaseVersion();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeLogicalPoolNotFound;
@@ -289,6 +313,7 @@ int TopologyImpl::UpdatePhysicalPool(const PhysicalPool &data) {
             return kTopoErrCodeStorgeFail;
         }
         it->second = data;
+        IncreaseVersion();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodePhysicalPoolNotFound;
@@ -303,6 +328,7 @@ int TopologyImpl::UpdateZone(const Zone &data) {
             return kTopoErrCodeStorgeFail;
         }
         it->second = data;
+        IncreaseVersion();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeZoneNotFound;
@@ -317,6 +343,7 @@ int TopologyImpl::UpdateServer(const Server &data) {
             return kTopoErrCodeStorgeFail;
         }
         it->second = data;
+        IncreaseVersion();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeServerNotFound;
@@ -336,8 +363,18 @@ int TopologyImpl::UpdateChunkServerTopo(const ChunkServer &data) {
         if (!storage_->UpdateChunkServer(temp)) {
             return kTopoErrCodeStorgeFail;
         }
+        std::string oldEndpoint =
+            BuildPeerId(it->second.GetHostIp(), it->second.GetPort());
+        std::string newEndpoint =
+            BuildPeerId(temp.GetHostIp(), temp.GetPort());
+        if (oldEndpoint != newEndpoint) {
+            WriteLockGuard wlockIndex(chunkServerEndpointMutex_);
+            UpdateChunkServerEndpointIndex(data.GetId(),
+                oldEndpoint, newEndpoint);
+        }
         it->second = temp;
         it->second.SetDirtyFlag(false);
+        IncreaseVersion();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeChunkServerNotFound;
@@ -368,6 +405,7 @@ int TopologyImpl::UpdateChunkServerRwState(const ChunkServerStatus &rwState,
             csCapacity = it->second.GetChunkServerState().GetDiskCapacity();
             it->second.SetStatus(rwState);
             it->second.SetDirtyFlag(true);
+            IncreaseVersion();
         }
     }
     // 更新物理池
@@ -446,6 +484,9 @@ int TopologyImpl::UpdateChunkServerOnlineState(const OnlineState &onlineState,
     auto it = chunkServerMap_.find(id);
     if (it != chunkServerMap_.end()) {
         WriteLockGuard wlockChunkServer(it->second.GetRWLockRef());
+        if (it->second.GetOnlineState() != onlineState) {
+            IncreaseVersion();
+        }
         it->second.SetOnlineState(onlineState);
         it->second.SetDirtyFlag(true);
         return kTopoErrCodeSuccess;
@@ -473,6 +514,11 @@ int TopologyImpl::UpdateChunkServerDiskStatus(const ChunkServerState &state,
             WriteLockGuard wlockChunkServer(it->second.GetRWLockRef());
             diff = state.GetDiskCapacity() -
                 it->second.GetChunkServerState().GetDiskCapacity();
+            // 磁盘容量和使用量每次心跳都会变化，只有磁盘状态变化时才更新版本号
+            if (state.GetDiskState() !=
+                it->second.GetChunkServerState().GetDiskState()) {
+                IncreaseVersion();
+            }
             // 心跳数据，只更新内存，后台定期刷入数据库
             it->second.SetChunkServerState(state);
             it->second.SetDirtyFlag(true);
@@ -498,6 +544,9 @@ int TopologyImpl::UpdateChunkServerStartUpTime(uint64_t time,
     auto it = chunkServerMap_.find(id);
     if (it != chunkServerMap_.end()) {
         WriteLockGuard wlockChunkServer(it->second.GetRWLockRef());
+        if (it->second.GetStartUpTime() != time) {
+            IncreaseVersion();
+        }
         it->second.SetStartUpTime(time);
         return kTopoErrCodeSuccess;
     } else {
@@ -586,9 +635,43 @@ ServerIdType TopologyImpl::FindServerByHostIpPort(
 }
 
 ChunkServerIdType TopologyImpl::FindChunkServerNotRetired(
+    const std::string &hostIp,
+    uint32_t port) const {
+    // 先按chunkserver注册的地址查索引，候选的chunkserver一般只有一个
+    std::vector<ChunkServerIdType> candidates;
+    {
+        ReadLockGuard rlockIndex(chunkServerEndpointMutex_);
+        auto it = chunkServerEndpointIndex_.find(BuildPeerId(hostIp, port));
+        if (it != chunkServerEndpointIndex_.end()) {
+            candidates.assign(it->second.begin(), it->second.end());
+        }
+    }
+    if (!candidates.empty()) {
+        ReadLockGuard rlockChunkServerMap(chunkServerMutex_);
+        for (ChunkServerIdType id : candidates) {
+            auto it = chunkServerMap_.find(id);
+            if (it == chunkServerMap_.end()) {
+                continue;
+            }
+            ReadLockGuard rlockChunkServer(it->second.GetRWLockRef());
+            // 释放索引锁之后chunkserver可能被修改，需要重新检查
+            if ((it->second.GetStatus() != ChunkServerStatus::RETIRED) &&
+                (it->second.GetHostIp() == hostIp) &&
+                (it->second.GetPort() == port)) {
+                return id;
+            }
+        }
+    }
+    return FindChunkServerNotRetiredByServer(hostIp, port);
+}
+
+ChunkServerIdType TopologyImpl::FindChunkServerNotRetiredByServer(
     const std::string &hostIp,
     uint32_t port) const {
     ServerIdType serverId = FindServerByHostIpPort(hostIp, port);
+    if (UNINTIALIZE_ID == serverId) {
+        return static_cast<ChunkServerIdType>(UNINTIALIZE_ID);
+    }
     ReadLockGuard rlockChunkServerMap(chunkServerMutex_);
     for (auto it = chunkServerMap_.begin();
          it != chunkServerMap_.end();
@@ -972,6 +1055,15 @@ int TopologyImpl::Init(const TopologyOption &option) {
     }
     LOG(INFO) << "Clean Invalid LogicalPool and copyset success.";
 
+    BuildCopySetIndex();
+    LOG(INFO) << "Build copyset index success, "
+              << "chunkserver num = " << chunkServerCopySetIndex_.size()
+              << ", logicalPool num = " << logicalPoolCopySetIndex_.size();
+
+    BuildChunkServerEndpointIndex();
+    LOG(INFO) << "Build chunkserver endpoint index success, "
+              << "endpoint num = " << chunkServerEndpointIndex_.size();
+
     return kTopoErrCodeSuccess;
 }
 
@@ -999,6 +1091,68 @@ int TopologyImpl::CleanInvalidLogicalPoolAndCopyset() {
     return kTopoErrCodeSuccess;
 }
 
+void TopologyImpl::IncreaseVersion() {
+    version_.fetch_add(1, std::memory_order_release);
+}
+
+void TopologyImpl::BuildCopySetIndex() {
+    WriteLockGuard wlockIndex(copySetIndexMutex_);
+    chunkServerCopySetIndex_.clear();
+    logicalPoolCopySetIndex_.clear();
+    for (const auto &it : copySetMap_) {
+        logicalPoolCopySetIndex_[it.first.first].insert(it.first.second);
+        UpdateChunkServerCopySetIndex(it.first, {},
+            it.second.GetCopySetMembers());
+    }
+}
+
+void TopologyImpl::BuildChunkServerEndpointIndex() {
+    WriteLockGuard wlockIndex(chunkServerEndpointMutex_);
+    chunkServerEndpointIndex_.clear();
+    for (const auto &it : chunkServerMap_) {
+        UpdateChunkServerEndpointIndex(it.first, "",
+            BuildPeerId(it.second.GetHostIp(), it.second.GetPort()));
+    }
+}
+
+void TopologyImpl::UpdateChunkServerEndpointIndex(ChunkServerIdType id,
+    const std::string &oldEndpoint,
+    const std::string &newEndpoint) {
+    if (!oldEndpoint.empty()) {
+        auto it = chunkServerEndpointIndex_.find(oldEndpoint);
+        if (it != chunkServerEndpointIndex_.end()) {
+            it->second.erase(id);
+            if (it->second.empty()) {
+                chunkServerEndpointIndex_.erase(it);
+            }
+        }
+    }
+    if (!newEndpoint.empty()) {
+        chunkServerEndpointIndex_[newEndpoint].insert(id);
+    }
+}
+
+void TopologyImpl::UpdateChunkServerCopySetIndex(const CopySetKey &key,
+    const std::set<ChunkServerIdType> &oldMembers,
+    const std::set<ChunkServerIdType> &newMembers) {
+    for (ChunkServerIdType csId : oldMembers) {
+        if (newMembers.count(csId) > 0) {
+            continue;
+        }
+        auto it = chunkServerCopySetIndex_.find(csId);
+        if (it != chunkServerCopySetIndex_.end()) {
+            it->second.erase(key);
+            if (it->second.empty()) {
+                chunkServerCopySetIndex_.erase(it);
+            }
+        }
+    }
+    for (ChunkServerIdType csId : newMembers) {
+        if (oldMembers.count(csId) == 0) {
+            chunkServerCopySetIndex_[csId].insert(key);
+        }
+    }
+}
 
 CopySetIdType TopologyImpl::AllocateCopySetId(PoolIdType logicalPoolId) {
     return idGenerator_->GenCopySetId(logicalPoolId);
@@ -1015,6 +1169,11 @@ int TopologyImpl::AddCopySet(const CopySetInfo &data) {
                 return kTopoErrCodeStorgeFail;
             }
             copySetMap_[key] = data;
+            logicalPoolCopySetIndex_[key.first].insert(key.second);
+            WriteLockGuard wlockIndex(copySetIndexMutex_);
+            UpdateChunkServerCopySetIndex(key, {},
+                data.GetCopySetMembers());
+            IncreaseVersion();
             return kTopoErrCodeSuccess;
         } else {
             return kTopoErrCodeIdDuplicated;
@@ -1031,7 +1190,20 @@ int TopologyImpl::RemoveCopySet(CopySetKey key) {
         if (!storage_->DeleteCopySet(key)) {
             return kTopoErrCodeStorgeFail;
         }
-        copySetMap_.erase(key);
+        auto ix = logicalPoolCopySetIndex_.find(key.first);
+        if (ix != logicalPoolCopySetIndex_.end()) {
+            ix->second.erase(key.second);
+            if (ix->second.empty()) {
+                logicalPoolCopySetIndex_.erase(ix);
+            }
+        }
+        {
+            WriteLockGuard wlockIndex(copySetIndexMutex_);
+            UpdateChunkServerCopySetIndex(key,
+                it->second.GetCopySetMembers(), {});
+        }
+        copySetMap_.erase(it);
+        IncreaseVersion();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeCopySetNotFound;
@@ -1040,13 +1212,62 @@ int TopologyImpl::RemoveCopySet(CopySetKey key) {
 
 int TopologyImpl::UpdateCopySetTopo(const CopySetInfo &data) {
     ReadLockGuard rlockCopySetMap(copySetMutex_);
+    int ret = UpdateCopySetTopoLocked(data);
+    if (ret == kTopoErrCodeSuccess) {
+        IncreaseVersion();
+    }
+    return ret;
+}
+
+int TopologyImpl::BatchUpdateCopySetTopo(
+    const std::vector<CopySetInfo> &datas) {
+    if (datas.empty()) {
+        return kTopoErrCodeSuccess;
+    }
+    // 整批只获取一次copySetMutex_的读锁，只增加一次版本号
+    ReadLockGuard rlockCopySetMap(copySetMutex_);
+    int ret = kTopoErrCodeSuccess;
+    bool updated = false;
+    for (const auto &data : datas) {
+        int code = UpdateCopySetTopoLocked(data, true);
+        if (code == kTopoErrCodeSuccess) {
+            updated = true;
+        } else {
+            ret = code;
+        }
+    }
+    if (updated) {
+        IncreaseVersion();
+    }
+    return ret;
+}
+
+int TopologyImpl::UpdateCopySetTopoLocked(const CopySetInfo &data,
+    bool checkEpoch) {
     CopySetKey key(data.GetLogicalPoolId(), data.GetId());
     auto it = copySetMap_.find(key);
     if (it != copySetMap_.end()) {
         WriteLockGuard wlockCopySet(it->second.GetRWLockRef());
+        // 批量更新的数据在加锁前生成，期间copyset可能已被更新到更大的epoch
+        if (checkEpoch && data.GetEpoch() < it->second.GetEpoch()) {
+            LOG(WARNING) << "UpdateCopySetTopo skip stale copyset, "
+                         << "logicalPoolId = " << data.GetLogicalPoolId()
+                         << ", copysetId = " << data.GetId()
+                         << ", epoch = " << data.GetEpoch()
+                         << ", record epoch = " << it->second.GetEpoch();
+            return kTopoErrCodeSuccess;
+        }
         it->second.SetLeader(data.GetLeader());
         it->second.SetEpoch(data.GetEpoch());
-        it->second.SetCopySetMembers(data.GetCopySetMembers());
+        // 只持有copySetMutex_的读锁，索引由copySetIndexMutex_单独保护
+        std::set<ChunkServerIdType> oldMembers =
+            it->second.GetCopySetMembers();
+        std::set<ChunkServerIdType> newMembers = data.GetCopySetMembers();
+        if (oldMembers != newMembers) {
+            WriteLockGuard wlockIndex(copySetIndexMutex_);
+            UpdateChunkServerCopySetIndex(key, oldMembers, newMembers);
+        }
+        it->second.SetCopySetMembers(newMembers);
         if (data.HasCandidate()) {
             it->second.SetCandidate(data.GetCandidate());
         } else {
@@ -1078,10 +1299,17 @@ std::vector<CopySetIdType> TopologyImpl::GetCopySetsInLogicalPool(
     PoolIdType logicalPoolId,
     CopySetFilter filter) const {
     std::vector<CopySetIdType> ret;
-    ReadLockGuard rlockCopySet(copySetMutex_);
-    for (auto it : copySetMap_) {
-        if (filter(it.second) && it.first.first == logicalPoolId) {
-            ret.push_back(it.first.second);
+    ReadLockGuard rlockCopySetMap(copySetMutex_);
+    auto ix = logicalPoolCopySetIndex_.find(logicalPoolId);
+    if (ix == logicalPoolCopySetIndex_.end()) {
+        return ret;
+    }
+    ret.reserve(ix->second.size());
+    for (CopySetIdType id : ix->second) {
+        auto it = copySetMap_.find(CopySetKey(logicalPoolId, id));
+        ReadLockGuard rlockCopySet(it->second.GetRWLockRef());
+        if (filter(it->second)) {
+            ret.push_back(id);
         }
     }
     return ret;
@@ -1091,10 +1319,17 @@ std::vector<CopySetInfo> TopologyImpl::GetCopySetInfosInLogicalPool(
     PoolIdType logicalPoolId,
     CopySetFilter filter) const {
     std::vector<CopySetInfo> ret;
-    ReadLockGuard rlockCopySet(copySetMutex_);
-    for (auto it : copySetMap_) {
-        if (filter(it.second) && it.first.first == logicalPoolId) {
-            ret.push_back(it.second);
+    ReadLockGuard rlockCopySetMap(copySetMutex_);
+    auto ix = logicalPoolCopySetIndex_.find(logicalPoolId);
+    if (ix == logicalPoolCopySetIndex_.end()) {
+        return ret;
+    }
+    ret.reserve(ix->second.size());
+    for (CopySetIdType id : ix->second) {
+        auto it = copySetMap_.find(CopySetKey(logicalPoolId, id));
+        ReadLockGuard rlockCopySet(it->second.GetRWLockRef());
+        if (filter(it->second)) {
+            ret.push_back(it->second);
         }
     }
     return ret;
@@ -1116,15 +1351,118 @@ std::vector<CopySetKey> TopologyImpl::GetCopySetsInChunkServer(
     ChunkServerIdType id,
     CopySetFilter filter) const {
     std::vector<CopySetKey> ret;
-    ReadLockGuard rlockCopySet(copySetMutex_);
-    for (auto it : copySetMap_) {
-        if (filter(it.second) && it.second.GetCopySetMembers().count(id) > 0) {
-            ret.push_back(it.first);
+    ReadLockGuard rlockCopySetMap(copySetMutex_);
+    {
+        // 先拷贝出索引再释放，获取单个copyset的锁时不能持有索引的锁
+        ReadLockGuard rlockIndex(copySetIndexMutex_);
+        auto ix = chunkServerCopySetIndex_.find(id);
+        if (ix == chunkServerCopySetIndex_.end()) {
+            return ret;
         }
-    }
+        ret.assign(ix->second.begin(), ix->second.end());
+    }
+
+    // 拷贝索引之后copyset的成员可能发生了变化，以copyset当前的成员为准
+    auto end = std::remove_if(ret.begin(), ret.end(),
+        [&](const CopySetKey &key) {
+            auto it = copySetMap_.find(key);
+            ReadLockGuard rlockCopySet(it->second.GetRWLockRef());
+            return it->second.GetCopySetMembers().count(id) == 0 ||
+                   !filter(it->second);
+        });
+    ret.erase(end, ret.end());
     return ret;
 }
 
+std::shared_ptr<const TopologySnapshot> TopologyImpl::GetSnapshot() {
+    uint64_t version = version_.load(std::memory_order_acquire);
+    std::shared_ptr<const TopologySnapshot> snapshot =
+        std::atomic_load(&snapshot_);
+    if (snapshot != nullptr && snapshot->GetVersion() == version) {
+        return snapshot;
+    }
+
+    // 同一时间只有一个线程构建快照，等锁的线程直接使用构建好的快照
+    std::lock_guard<std::mutex> lk(snapshotBuildMutex_);
+    version = version_.load(std::memory_order_acquire);
+    snapshot = std::atomic_load(&snapshot_);
+    if (snapshot != nullptr && snapshot->GetVersion() == version) {
+        return snapshot;
+    }
+    snapshot = BuildSnapshot(version);
+    std::atomic_store(&snapshot_, snapshot);
+    return snapshot;
+}
+
+std::shared_ptr<const TopologySnapshot> TopologyImpl::BuildSnapshot(
+    uint64_t version) const {
+    std::vector<LogicalPoolSnapshot> logicalPools;
+    std::vector<ChunkServerSnapshot> chunkServers;
+    std::vector<CopySetSnapshot> copySets;
+    {
+        // 构建过程中有变化时版本号会大于version，下次获取时会重新构建
+        ReadLockGuard rlockLogicalPool(logicalPoolMutex_);
+        ReadLockGuard rlockServer(serverMutex_);
+        ReadLockGuard rlockChunkServer(chunkServerMutex_);
+        ReadLockGuard rlockCopySet(copySetMutex_);
+
+        logicalPools.reserve(logicalPoolMap_.size());
+        for (const auto &pair : logicalPoolMap_) {
+            const LogicalPool &pool = pair.second;
+            LogicalPoolSnapshot snap;
+            snap.id = pool.GetId();
+            snap.physicalPoolId = pool.GetPhysicalPoolId();
+            snap.available = pool.GetLogicalPoolAvaliableFlag();
+            snap.replicaNum = pool.GetReplicaNum();
+            snap.scatterWidth = pool.GetScatterWidth();
+            logicalPools.emplace_back(std::move(snap));
+        }
+
+        chunkServers.reserve(chunkServerMap_.size());
+        for (const auto &pair : chunkServerMap_) {
+            const ChunkServer &cs = pair.second;
+            ReadLockGuard rlockChunkServer(cs.GetRWLockRef());
+            auto server = serverMap_.find(cs.GetServerId());
+            if (server == serverMap_.end()) {
+                LOG(WARNING) << "BuildSnapshot can not find server "
+                             << cs.GetServerId() << " of chunkserver "
+                             << cs.GetId();
+                continue;
+            }
+            ChunkServerSnapshot snap;
+            snap.id = cs.GetId();
+            snap.serverId = cs.GetServerId();
+            snap.zoneId = server->second.GetZoneId();
+            snap.physicalPoolId = server->second.GetPhysicalPoolId();
+            snap.hostIp = cs.GetHostIp();
+            snap.port = cs.GetPort();
+            snap.startUpTime = cs.GetStartUpTime();
+            snap.onlineState = cs.GetOnlineState();
+            snap.status = cs.GetStatus();
+            snap.diskState = cs.GetChunkServerState().GetDiskState();
+            chunkServers.emplace_back(std::move(snap));
+        }
+
+        copySets.reserve(copySetMap_.size());
+        for (const auto &pair : copySetMap_) {
+            const CopySetInfo &info = pair.second;
+            ReadLockGuard rlockCopySet(info.GetRWLockRef());
+            CopySetSnapshot snap;
+            snap.key = pair.first;
+            snap.epoch = info.GetEpoch();
+            snap.leader = info.GetLeader();
+            snap.candidate = info.GetCandidate();
+            std::set<ChunkServerIdType> members = info.GetCopySetMembers();
+            snap.members.assign(members.begin(), members.end());
+            copySets.emplace_back(std::move(snap));
+        }
+    }
+
+    return std::make_shared<const TopologySnapshot>(version,
+        std::move(logicalPools), std::move(chunkServers),
+        std::move(copySets));
+}
+
 int TopologyImpl::Run() {
     if (isStop_.exchange(false)) {
         backEndThread_ = curve::common::Thread(
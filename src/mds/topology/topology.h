@@ -26,12 +26,15 @@
 #include <string>
 #include <list>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <vector>
 #include <map>
+#include <set>
 
 #include "proto/topology.pb.h"
 #include "src/mds/common/mds_define.h"
 #include "src/mds/topology/topology_item.h"
+#include "src/mds/topology/topology_snapshot.h"
 #include "src/mds/topology/topology_id_generator.h"
 #include "src/mds/topology/topology_token_generator.h"
 #include "src/mds/topology/topology_storge.h"
@@ -162,6 +165,28 @@ class Topology {
      */
     virtual int UpdateCopySetTopo(const CopySetInfo &data) = 0;
 
+    /**
+     * @brief 批量更新copyset拓扑信息
+     * @detail
+     * - 用于心跳分片处理时合并同一批次中多个copyset的更新
+     * - TopologyImpl中epoch小于当前记录的copyset不更新
+     * - 默认逐个调用UpdateCopySetTopo
+     *
+     * @param datas copyset数据
+     *
+     * @return 全部更新成功返回kTopoErrCodeSuccess，否则返回最后一个错误码
+     */
+    virtual int BatchUpdateCopySetTopo(const std::vector<CopySetInfo> &datas) {
+        int ret = kTopoErrCodeSuccess;
+        for (const auto &data : datas) {
+            int code = UpdateCopySetTopo(data);
+            if (code != kTopoErrCodeSuccess) {
+                ret = code;
+            }
+        }
+        return ret;
+    }
+
     virtual PoolIdType
         FindLogicalPool(const std::string &logicalPoolName,
                         const std::string &physicalPoolName) const = 0;
@@ -305,6 +330,12 @@ class Topology {
         GetCopySetsInChunkServer(ChunkServerIdType id,
         CopySetFilter filter = [](const CopySetInfo&) {
             return true;}) const = 0;
+    /**
+     * @brief 获取topology的只读快照，topology没有变化时返回同一个快照
+     *
+     * @return 快照
+     */
+    virtual std::shared_ptr<const TopologySnapshot> GetSnapshot() = 0;
 };
 
 class TopologyImpl : public Topology {
@@ -315,6 +346,7 @@ class TopologyImpl : public Topology {
         : idGenerator_(idGenerator),
           tokenGenerator_(tokenGenerator),
           storage_(storage),
+          version_(0),
           isStop_(true) {
     }
 
@@ -368,6 +400,8 @@ class TopologyImpl : public Topology {
                          ChunkServerIdType id) override;
 
     int UpdateCopySetTopo(const CopySetInfo &data) override;
+    int BatchUpdateCopySetTopo(
+        const std::vector<CopySetInfo> &datas) override;
 
     PoolIdType FindLogicalPool(const std::string &logicalPoolName,
         const std::string &physicalPoolName) const override;
@@ -516,6 +550,8 @@ class TopologyImpl : public Topology {
         CopySetFilter filter = [](const CopySetInfo&) {
             return true;}) const override;
 
+    std::shared_ptr<const TopologySnapshot> GetSnapshot() override;
+
     /**
      * @brief 获取chunksever的所属physicalPool Id
      *
@@ -543,6 +579,72 @@ class TopologyImpl : public Topology {
 
     int CleanInvalidLogicalPoolAndCopyset();
 
+    /**
+     * @brief 根据copySetMap_重建copyset索引，只在Init时调用
+     */
+    void BuildCopySetIndex();
+
+    /**
+     * @brief copyset的成员变化时更新chunkserver上的copyset索引，
+     *        需要持有copySetIndexMutex_的写锁
+     *
+     * @param key copyset
+     * @param oldMembers 变化之前的成员，新增copyset时为空
+     * @param newMembers 变化之后的成员，删除copyset时为空
+     */
+    void UpdateChunkServerCopySetIndex(const CopySetKey &key,
+        const std::set<ChunkServerIdType> &oldMembers,
+        const std::set<ChunkServerIdType> &newMembers);
+
+    /**
+     * @brief 更新copyset拓扑信息，需要持有copySetMutex_的读锁
+     *
+     * @param data copyset数据
+     * @param checkEpoch 为true时跳过epoch小于当前记录的数据
+     *
+     * @return 错误码
+     */
+    int UpdateCopySetTopoLocked(const CopySetInfo &data,
+        bool checkEpoch = false);
+
+    /**
+     * @brief 根据chunkServerMap_重建chunkserver地址索引，只在Init时调用
+     */
+    void BuildChunkServerEndpointIndex();
+
+    /**
+     * @brief 更新chunkserver地址索引，需要持有chunkServerEndpointMutex_的写锁
+     *
+     * @param id chunkserver id
+     * @param oldEndpoint 变化之前的地址，新增chunkserver时为空
+     * @param newEndpoint 变化之后的地址，删除chunkserver时为空
+     */
+    void UpdateChunkServerEndpointIndex(ChunkServerIdType id,
+        const std::string &oldEndpoint,
+        const std::string &newEndpoint);
+
+    /**
+     * @brief 遍历server和chunkserver查找未退役的chunkserver，
+     *        上报地址不是chunkserver注册的地址时(如server的外部地址)使用
+     */
+    ChunkServerIdType FindChunkServerNotRetiredByServer(
+        const std::string &hostIp, uint32_t port) const;
+
+    /**
+     * @brief topology变化后增加版本号，使快照失效
+     */
+    void IncreaseVersion();
+
+    /**
+     * @brief 按当前的topology构建快照
+     *
+     * @param version 开始构建前的版本号
+     *
+     * @return 快照
+     */
+    std::shared_ptr<const TopologySnapshot> BuildSnapshot(
+        uint64_t version) const;
+
     void BackEndFunc();
 
     void FlushCopySetToStorage();
@@ -558,6 +660,21 @@ class TopologyImpl : public Topology {
 
     std::map<CopySetKey, CopySetInfo> copySetMap_;
 
+    // 以下为copySetMap_的索引，copyset增删和成员变化时增量更新，
+    // 按chunkserver和logicalPool查询copyset时不需要遍历copySetMap_
+    // chunkserver上的copyset，由copySetIndexMutex_保护
+    std::unordered_map<ChunkServerIdType, std::set<CopySetKey>>
+        chunkServerCopySetIndex_;
+    // logicalPool中的copyset，只在持有copySetMutex_写锁时修改
+    std::unordered_map<PoolIdType, std::set<CopySetIdType>>
+        logicalPoolCopySetIndex_;
+
+    // chunkserver注册的ip:port到chunkserver的索引，包含已退役的chunkserver，
+    // 同一个地址上可能有退役的旧chunkserver和新注册的chunkserver，
+    // 由chunkServerEndpointMutex_保护
+    std::unordered_map<std::string, std::set<ChunkServerIdType>>
+        chunkServerEndpointIndex_;
+
     // 集群信息
     ClusterInformation clusterInfo;
 
@@ -572,6 +689,17 @@ class TopologyImpl : public Topology {
     mutable curve::common::RWLock serverMutex_;
     mutable curve::common::RWLock chunkServerMutex_;
     mutable curve::common::RWLock copySetMutex_;
+    // 在copySetMutex_和单个copyset的锁之后获取，持有时不能再获取其他锁
+    mutable curve::common::RWLock copySetIndexMutex_;
+    // 在chunkServerMutex_和单个chunkserver的锁之后获取，
+    // 持有时不能再获取其他锁
+    mutable curve::common::RWLock chunkServerEndpointMutex_;
+
+    // topology的版本号，影响快照内容的修改都会增加版本号
+    curve::common::Atomic<uint64_t> version_;
+    // 最新构建的快照，通过std::atomic_load/atomic_store读取和发布
+    std::shared_ptr<const TopologySnapshot> snapshot_;
+    std::mutex snapshotBuildMutex_;
 
     TopologyOption option_;
     curve::common::Thread backEndThread_;
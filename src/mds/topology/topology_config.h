@@ -45,6 +45,8 @@ struct TopologyOption {
     uint32_t PoolUsagePercentLimit;
     // ChoosePoolPolicy
     int choosePoolPolicy;
+    // 调度器和metric是否使用topology快照
+    bool enableSnapshot;
 
     TopologyOption()
         : TopologyUpdateToRepoSec(0),
@@ -53,7 +55,8 @@ struct TopologyOption {
           CreateCopysetRpcRetrySleepTimeMs(500),
           UpdateMetricIntervalSec(0),
           PoolUsagePercentLimit(100),
-          choosePoolPolicy(0) {}
+          choosePoolPolicy(0),
+          enableSnapshot(false) {}
 };
 
 }  // namespace topology
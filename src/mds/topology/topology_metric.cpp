@@ -86,6 +86,12 @@ void TopologyMetricService::UpdateTopologyMetrics() {
         }
     }
 
+    // 同一轮的所有逻辑池使用同一个快照
+    std::shared_ptr<const TopologySnapshot> snapshot;
+    if (option_.enableSnapshot) {
+        snapshot = topo_->GetSnapshot();
+    }
+
     // 处理逻辑池
     std::vector<PoolIdType> lPools =
         topo_->GetLogicalPoolInCluster([] (const LogicalPool &pool) {
@@ -98,12 +104,18 @@ void TopologyMetricService::UpdateTopologyMetrics() {
         }
         std::string poolName = pool.GetName();
 
-        std::vector<CopySetInfo> copysets =
-            topo_->GetCopySetInfosInLogicalPool(pid);
-
         std::map<ChunkServerIdType, ChunkServerMetricInfo>
             chunkServerMetricInfo;
-        CalcChunkServerMetrics(copysets, &chunkServerMetricInfo);
+        uint32_t copysetNum = 0;
+        if (snapshot != nullptr) {
+            copysetNum = CalcChunkServerMetrics(*snapshot, pid,
+                &chunkServerMetricInfo);
+        } else {
+            std::vector<CopySetInfo> copysets =
+                topo_->GetCopySetInfosInLogicalPool(pid);
+            CalcChunkServerMetrics(copysets, &chunkServerMetricInfo);
+            copysetNum = copysets.size();
+        }
 
         auto it = gLogicalPoolMetrics.find(pid);
         if (it == gLogicalPoolMetrics.end()) {
@@ -114,8 +126,7 @@ void TopologyMetricService::UpdateTopologyMetrics() {
 
         it->second->chunkServerNum.set_value(
             chunkServerMetricInfo.size());
-        it->second->copysetNum.set_value(
-            copysets.size());
+        it->second->copysetNum.set_value(copysetNum);
 
 
         LogicalPoolMetricInfo poolMetricInfo;
@@ -260,6 +271,34 @@ void TopologyMetricService::CalcChunkServerMetrics(
     }
 }
 
+uint32_t TopologyMetricService::CalcChunkServerMetrics(
+    const TopologySnapshot &snapshot, PoolIdType pid,
+    std::map<ChunkServerIdType, ChunkServerMetricInfo> *csMetricInfoMap) {
+    const LogicalPoolSnapshot *pool = snapshot.FindLogicalPool(pid);
+    if (pool == nullptr) {
+        return 0;
+    }
+    // 与按copyset计算时一样，只考虑一个物理池只对应一个逻辑池的情况，
+    // 快照中chunkserver的统计值就是该逻辑池内的统计值
+    for (uint32_t i = pool->copySetBegin; i < pool->copySetEnd; ++i) {
+        for (ChunkServerIdType csId : snapshot.GetCopySets()[i].members) {
+            if (csMetricInfoMap->count(csId) != 0) {
+                continue;
+            }
+            const ChunkServerSnapshot *cs = snapshot.FindChunkServer(csId);
+            if (cs == nullptr) {
+                continue;
+            }
+            ChunkServerMetricInfo info;
+            info.scatterWidth = cs->scatterWidth;
+            info.copysetNum = cs->copySets.size();
+            info.leaderNum = cs->leaderCount;
+            csMetricInfoMap->emplace(csId, info);
+        }
+    }
+    return pool->copySetEnd - pool->copySetBegin;
+}
+
 void TopologyMetricService::CalcLogicalPoolMetrics(
     const std::map<ChunkServerIdType, ChunkServerMetricInfo> &csMetricInfoMap,
     LogicalPoolMetricInfo *poolMetricInfo) {
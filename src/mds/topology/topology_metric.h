@@ -335,6 +335,20 @@ class TopologyMetricService {
     void CalcChunkServerMetrics(const std::vector<CopySetInfo> &copysets,
         std::map<ChunkServerIdType, ChunkServerMetricInfo> *csMetricInfoMap);
 
+    /**
+     * @brief 根据topology快照计算逻辑池中chunkserver的metric数据，
+     *        scatterWidth、copyset数量和leader数量在快照中已经计算好
+     *
+     * @param snapshot topology快照
+     * @param pid 逻辑池id
+     * @param[out] csMetricInfoMap metric数据
+     *
+     * @return 逻辑池中的copyset数量
+     */
+    uint32_t CalcChunkServerMetrics(const TopologySnapshot &snapshot,
+        PoolIdType pid,
+        std::map<ChunkServerIdType, ChunkServerMetricInfo> *csMetricInfoMap);
+
     /**
      * @brief 计算逻辑池的metric数据
      *
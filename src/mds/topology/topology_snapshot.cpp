@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include "src/mds/topology/topology_snapshot.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace curve {
+namespace mds {
+namespace topology {
+
+TopologySnapshot::TopologySnapshot(uint64_t version,
+    std::vector<LogicalPoolSnapshot> logicalPools,
+    std::vector<ChunkServerSnapshot> chunkServers,
+    std::vector<CopySetSnapshot> copySets)
+    : version_(version),
+      logicalPools_(std::move(logicalPools)),
+      chunkServers_(std::move(chunkServers)),
+      copySets_(std::move(copySets)) {
+    BuildIndex();
+}
+
+void TopologySnapshot::BuildIndex() {
+    std::sort(logicalPools_.begin(), logicalPools_.end(),
+        [](const LogicalPoolSnapshot &a, const LogicalPoolSnapshot &b) {
+            return a.id < b.id;
+        });
+    std::sort(chunkServers_.begin(), chunkServers_.end(),
+        [](const ChunkServerSnapshot &a, const ChunkServerSnapshot &b) {
+            return a.id < b.id;
+        });
+    std::sort(copySets_.begin(), copySets_.end(),
+        [](const CopySetSnapshot &a, const CopySetSnapshot &b) {
+            return a.key < b.key;
+        });
+
+    // copyset按CopySetKey排序，同一个逻辑池的copyset是连续的
+    for (auto &pool : logicalPools_) {
+        auto begin = std::lower_bound(copySets_.begin(), copySets_.end(),
+            pool.id, [](const CopySetSnapshot &cs, PoolIdType id) {
+                return cs.key.first < id;
+            });
+        auto end = std::upper_bound(begin, copySets_.end(),
+            pool.id, [](PoolIdType id, const CopySetSnapshot &cs) {
+                return id < cs.key.first;
+            });
+        pool.copySetBegin = begin - copySets_.begin();
+        pool.copySetEnd = end - copySets_.begin();
+        for (uint32_t i = 0; i < chunkServers_.size(); ++i) {
+            if (chunkServers_[i].physicalPoolId == pool.physicalPoolId) {
+                pool.chunkServers.push_back(i);
+            }
+        }
+        for (uint32_t i = pool.copySetBegin; i < pool.copySetEnd; ++i) {
+            copySets_[i].logicalPoolAvailable = pool.available;
+        }
+    }
+
+    for (uint32_t i = 0; i < copySets_.size(); ++i) {
+        const CopySetSnapshot &copySet = copySets_[i];
+        for (ChunkServerIdType member : copySet.members) {
+            auto cs = std::lower_bound(chunkServers_.begin(),
+                chunkServers_.end(), member,
+                [](const ChunkServerSnapshot &cs, ChunkServerIdType id) {
+                    return cs.id < id;
+                });
+            if (cs == chunkServers_.end() || cs->id != member) {
+                continue;
+            }
+            cs->copySets.push_back(i);
+            if (copySet.leader == member) {
+                cs->leaderCount++;
+            }
+        }
+    }
+
+    std::vector<ChunkServerIdType> peers;
+    for (auto &cs : chunkServers_) {
+        peers.clear();
+        for (uint32_t index : cs.copySets) {
+            for (ChunkServerIdType member : copySets_[index].members) {
+                if (member != cs.id) {
+                    peers.push_back(member);
+                }
+            }
+        }
+        std::sort(peers.begin(), peers.end());
+        cs.scatterWidth =
+            std::unique(peers.begin(), peers.end()) - peers.begin();
+    }
+}
+
+const LogicalPoolSnapshot* TopologySnapshot::FindLogicalPool(
+    PoolIdType id) const {
+    auto it = std::lower_bound(logicalPools_.begin(), logicalPools_.end(),
+        id, [](const LogicalPoolSnapshot &pool, PoolIdType id) {
+            return pool.id < id;
+        });
+    if (it == logicalPools_.end() || it->id != id) {
+        return nullptr;
+    }
+    return &(*it);
+}
+
+const ChunkServerSnapshot* TopologySnapshot::FindChunkServer(
+    ChunkServerIdType id) const {
+    auto it = std::lower_bound(chunkServers_.begin(), chunkServers_.end(),
+        id, [](const ChunkServerSnapshot &cs, ChunkServerIdType id) {
+            return cs.id < id;
+        });
+    if (it == chunkServers_.end() || it->id != id) {
+        return nullptr;
+    }
+    return &(*it);
+}
+
+const CopySetSnapshot* TopologySnapshot::FindCopySet(
+    const CopySetKey &key) const {
+    auto it = std::lower_bound(copySets_.begin(), copySets_.end(),
+        key, [](const CopySetSnapshot &copySet, const CopySetKey &key) {
+            return copySet.key < key;
+        });
+    if (it == copySets_.end() || it->key != key) {
+        return nullptr;
+    }
+    return &(*it);
+}
+
+}  // namespace topology
+}  // namespace mds
+}  // namespace curve
@@ -0,0 +1,145 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#ifndef SRC_MDS_TOPOLOGY_TOPOLOGY_SNAPSHOT_H_
+#define SRC_MDS_TOPOLOGY_TOPOLOGY_SNAPSHOT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "src/mds/common/mds_define.h"
+#include "src/mds/topology/topology_item.h"
+
+namespace curve {
+namespace mds {
+namespace topology {
+
+struct LogicalPoolSnapshot {
+    PoolIdType id = UNINTIALIZE_ID;
+    PoolIdType physicalPoolId = UNINTIALIZE_ID;
+    bool available = false;
+    uint32_t replicaNum = 0;
+    uint32_t scatterWidth = 0;
+
+    // 以下在构建快照时计算
+    // 逻辑池中的copyset在copyset数组中的下标范围[copySetBegin, copySetEnd)
+    uint32_t copySetBegin = 0;
+    uint32_t copySetEnd = 0;
+    // 所属物理池中的chunkserver在chunkserver数组中的下标
+    std::vector<uint32_t> chunkServers;
+};
+
+struct ChunkServerSnapshot {
+    ChunkServerIdType id = UNINTIALIZE_ID;
+    ServerIdType serverId = UNINTIALIZE_ID;
+    ZoneIdType zoneId = UNINTIALIZE_ID;
+    PoolIdType physicalPoolId = UNINTIALIZE_ID;
+    std::string hostIp;
+    uint32_t port = 0;
+    uint64_t startUpTime = 0;
+    OnlineState onlineState = OnlineState::OFFLINE;
+    DiskState diskState = DiskState::DISKNORMAL;
+    ChunkServerStatus status = ChunkServerStatus::READWRITE;
+    // 磁盘容量和使用量变化时不更新版本号，不放在快照中
+
+    // 以下在构建快照时计算
+    // chunkserver上的copyset在copyset数组中的下标，按CopySetKey排序
+    std::vector<uint32_t> copySets;
+    // leader在该chunkserver上的copyset数量
+    uint32_t leaderCount = 0;
+    // chunkserver上所有copyset的其他副本分布在多少个chunkserver上
+    uint32_t scatterWidth = 0;
+};
+
+struct CopySetSnapshot {
+    CopySetKey key;
+    EpochType epoch = 0;
+    ChunkServerIdType leader = UNINTIALIZE_ID;
+    // 没有candidate时为UNINTIALIZE_ID
+    ChunkServerIdType candidate = UNINTIALIZE_ID;
+    // 按id排序
+    std::vector<ChunkServerIdType> members;
+
+    // 所属逻辑池是否可用，在构建快照时计算
+    bool logicalPoolAvailable = false;
+};
+
+/**
+ * topology的只读快照
+ * 1. 快照由TopologyImpl在拓扑变化之后按需构建，构建完成后不再修改，
+ *    同一个版本的快照被所有调度器和metric共享，读取时不需要加锁
+ * 2. 逻辑池、chunkserver和copyset分别按id存放在连续的数组中，
+ *    相互之间通过数组下标引用，查找时二分查找
+ * 3. chunkserver上的copyset列表、leader数量和scatter-width在构建时计算好
+ */
+class TopologySnapshot {
+ public:
+    /**
+     * @brief 构建快照，排序并计算各数组之间的索引
+     *
+     * @param version 构建时topology的版本号
+     * @param logicalPools 逻辑池信息，只需要填写计算字段以外的信息
+     * @param chunkServers chunkserver信息，只需要填写计算字段以外的信息
+     * @param copySets copyset信息，只需要填写计算字段以外的信息
+     */
+    TopologySnapshot(uint64_t version,
+                     std::vector<LogicalPoolSnapshot> logicalPools,
+                     std::vector<ChunkServerSnapshot> chunkServers,
+                     std::vector<CopySetSnapshot> copySets);
+
+    uint64_t GetVersion() const {
+        return version_;
+    }
+
+    const std::vector<LogicalPoolSnapshot>& GetLogicalPools() const {
+        return logicalPools_;
+    }
+
+    const std::vector<ChunkServerSnapshot>& GetChunkServers() const {
+        return chunkServers_;
+    }
+
+    const std::vector<CopySetSnapshot>& GetCopySets() const {
+        return copySets_;
+    }
+
+    /**
+     * @brief 按id查找，不存在时返回nullptr
+     */
+    const LogicalPoolSnapshot* FindLogicalPool(PoolIdType id) const;
+    const ChunkServerSnapshot* FindChunkServer(ChunkServerIdType id) const;
+    const CopySetSnapshot* FindCopySet(const CopySetKey &key) const;
+
+ private:
+    void BuildIndex();
+
+ private:
+    uint64_t version_;
+    std::vector<LogicalPoolSnapshot> logicalPools_;
+    std::vector<ChunkServerSnapshot> chunkServers_;
+    std::vector<CopySetSnapshot> copySets_;
+};
+
+}  // namespace topology
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_TOPOLOGY_TOPOLOGY_SNAPSHOT_H_
@@ -38,6 +38,7 @@
 #include "test/chunkserver/chunkserver_test_util.h"
 #include "src/common/uuid.h"
 #include "src/chunkserver/chunk_service.h"
+#include "src/common/crc32.h"
 
 namespace curve {
 namespace chunkserver {
@@ -406,6 +407,27 @@ TEST_F(ChunkService2Test, illegial_parameters_test) {
         ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST,
                   response.status());
     }
+    /* write 数据crc不匹配 */
+    {
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(rpcTimeoutMs);
+        ChunkRequest request;
+        ChunkResponse response;
+        request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+        request.set_logicpoolid(logicPoolId);
+        request.set_copysetid(copysetId);
+        request.set_chunkid(chunkId);
+        request.set_sn(sn);
+        request.set_offset(0);
+        request.set_size(kOpRequestAlignSize);
+        std::string data(kOpRequestAlignSize, 'a');
+        request.set_crc32(curve::common::CRC32(data.c_str(), data.size()) + 1);
+        cntl.request_attachment().append(data);
+        stub.WriteChunk(&cntl, &request, &response, nullptr);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_CRC_FAIL,
+                  response.status());
+    }
     /* delete copyset 不存在*/
     {
         brpc::Controller cntl;
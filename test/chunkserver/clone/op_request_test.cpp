@@ -982,6 +982,102 @@ TEST_F(OpRequestTest, ReadChunkTest) {
     closure->Release();
 }
 
+TEST_F(OpRequestTest, ReadChunkFollowerReadTest) {
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 10001;
+    uint64_t chunkId = 12345;
+    uint32_t offset = 0;
+    uint32_t length = 5 * PAGE_SIZE;
+    ChunkRequest* request = new ChunkRequest();
+    request->set_logicpoolid(logicPoolId);
+    request->set_copysetid(copysetId);
+    request->set_chunkid(chunkId);
+    request->set_optype(CHUNK_OP_READ);
+    request->set_offset(offset);
+    request->set_size(length);
+    request->set_allowfollowerread(true);
+    brpc::Controller *cntl = new brpc::Controller();
+    ChunkResponse *response = new ChunkResponse();
+    UnitTestClosure *closure = new UnitTestClosure();
+    closure->SetCntl(cntl);
+    closure->SetRequest(request);
+    closure->SetResponse(response);
+    std::shared_ptr<ReadChunkRequest> opReq =
+        std::make_shared<ReadChunkRequest>(node_,
+                                           cloneMgr_.get(),
+                                           cntl,
+                                           request,
+                                           response,
+                                           closure);
+    EXPECT_CALL(*node_, IsLeaderTerm())
+        .WillRepeatedly(Return(false));
+    EXPECT_CALL(*node_, Propose(_))
+        .Times(0);
+
+    /**
+     * 测试Process
+     * 用例： node_->IsLeaderTerm() == false，请求允许follower读，
+     *       但请求的 apply index 大于 node的 apply index
+     * 预期： 会要求转发请求，返回CHUNK_OP_STATUS_REDIRECTED
+     */
+    {
+        request->set_appliedindex(LAST_INDEX + 1);
+
+        opReq->Process();
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                  closure->response_->status());
+    }
+    /**
+     * 测试Process
+     * 用例： node_->IsLeaderTerm() == false，请求允许follower读，
+     *       请求的 apply index 小于等于 node的 apply index
+     * 预期： 不会转发请求，请求提交给concurrentApplyModule_处理
+     */
+    {
+        closure->Reset();
+        request->set_appliedindex(3);
+
+        opReq->Process();
+
+        ASSERT_FALSE(closure->isDone_);
+        ASSERT_FALSE(closure->response_->has_status());
+
+        closure->Run();
+        ASSERT_TRUE(closure->isDone_);
+    }
+    /**
+     * 测试OnApply
+     * 用例：follower上读的chunk是 clone chunk，请求区域需要从源端拷贝
+     * 预期：不会发起clone task，返回CHUNK_OP_STATUS_REDIRECTED
+     */
+    {
+        closure->Reset();
+
+        CSChunkInfo info;
+        info.isClone = true;
+        info.pageSize = PAGE_SIZE;
+        info.chunkSize = CHUNK_SIZE;
+        info.bitmap = std::make_shared<Bitmap>(CHUNK_SIZE / PAGE_SIZE);
+        EXPECT_CALL(*datastore_, GetChunkInfo(_, _))
+            .WillOnce(DoAll(SetArgPointee<1>(info),
+                            Return(CSErrorCode::Success)));
+        EXPECT_CALL(*cloneMgr_, IssueCloneTask(_))
+            .Times(0);
+        EXPECT_CALL(*node_, UpdateAppliedIndex(_))
+            .Times(0);
+
+        opReq->OnApply(3, closure);
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                  response->status());
+    }
+    // 释放资源
+    closure->Release();
+}
+
 TEST_F(OpRequestTest, RecoverChunkTest) {
     // 创建CreateCloneChunkRequest
     LogicPoolID logicPoolId = 1;
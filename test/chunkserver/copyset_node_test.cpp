@@ -31,11 +31,17 @@
 #include <vector>
 #include <string>
 #include <cstdlib>
+#include <chrono>   // NOLINT
+#include <mutex>    // NOLINT
+#include <thread>   // NOLINT
 
 #include "test/fs/mock_local_filesystem.h"
 #include "src/chunkserver/copyset_node_manager.h"
 #include "src/chunkserver/copyset_node.h"
+#include "src/chunkserver/chunk_closure.h"
+#include "src/chunkserver/op_request.h"
 #include "test/chunkserver/fake_datastore.h"
+#include "test/chunkserver/datastore/mock_datastore.h"
 #include "test/chunkserver/mock_node.h"
 #include "src/chunkserver/conf_epoch_file.h"
 #include "proto/heartbeat.pb.h"
@@ -1008,5 +1014,118 @@ TEST_F(CopysetNodeTest, get_leader_status) {
     }
 }
 
+TEST_F(CopysetNodeTest, apply_delete_batch_as_barrier) {
+    LogicPoolID logicPoolID = 1;
+    CopysetID copysetID = 1;
+    Configuration conf;
+    std::shared_ptr<CopysetNode> copysetNode =
+        std::make_shared<CopysetNode>(logicPoolID, copysetID, conf);
+    ASSERT_EQ(0, copysetNode->Init(defaultOptions_));
+    std::shared_ptr<MockDataStore> mockDataStore =
+        std::make_shared<MockDataStore>();
+    copysetNode->SetCSDateStore(mockDataStore);
+
+    // 记录datastore上op执行的顺序，写请求记录chunk id，批量删除记录0
+    std::mutex mtx;
+    std::vector<ChunkID> applied;
+    EXPECT_CALL(*mockDataStore, WriteChunk(_, _, _, _, _, _, _))
+        .WillRepeatedly(Invoke([&](ChunkID id, SequenceNum, const char*,
+                                   off_t, size_t, uint32_t*,
+                                   const std::string&) {
+            // 写请求apply较慢，批量删除不等待时会先于写请求执行
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            std::lock_guard<std::mutex> lk(mtx);
+            applied.push_back(id);
+            return CSErrorCode::Success;
+        }));
+    EXPECT_CALL(*mockDataStore, DeleteChunks(std::vector<ChunkID>({1, 2}), _))
+        .Times(2)
+        .WillRepeatedly(Invoke([&](const std::vector<ChunkID>&,
+                                   SequenceNum) {
+            std::lock_guard<std::mutex> lk(mtx);
+            applied.push_back(0);
+            return CSErrorCode::Success;
+        }));
+
+    auto makeRequest = [&](CHUNK_OP_TYPE type, ChunkID id,
+                           ChunkRequest *request) {
+        request->set_optype(type);
+        request->set_logicpoolid(logicPoolID);
+        request->set_copysetid(copysetID);
+        request->set_chunkid(id);
+        request->set_sn(1);
+        if (CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH == type) {
+            request->add_chunkids(1);
+            request->add_chunkids(2);
+        } else {
+            request->set_offset(0);
+            request->set_size(4096);
+        }
+    };
+    // 同一批apply中，批量删除之前写chunk 1和chunk 2，之后再写chunk 1
+    const std::vector<std::pair<CHUNK_OP_TYPE, ChunkID>> ops = {
+        {CHUNK_OP_TYPE::CHUNK_OP_WRITE, 1},
+        {CHUNK_OP_TYPE::CHUNK_OP_WRITE, 2},
+        {CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH, 1},
+        {CHUNK_OP_TYPE::CHUNK_OP_WRITE, 1},
+    };
+    auto checkOrder = [&]() {
+        std::lock_guard<std::mutex> lk(mtx);
+        ASSERT_EQ(4, applied.size());
+        ASSERT_EQ(3, applied[0] + applied[1]);
+        ASSERT_EQ(0, applied[2]);
+        ASSERT_EQ(1, applied[3]);
+        applied.clear();
+    };
+
+    // leader上apply，op的上下文在ChunkClosure中
+    {
+        std::string str(4096, 'a');
+        ChunkRequest requests[4];
+        ChunkResponse responses[4];
+        brpc::Controller cntls[4];
+        FakeClosure dones[4];
+        for (int i = 0; i < 4; ++i) {
+            makeRequest(ops[i].first, ops[i].second, &requests[i]);
+            std::shared_ptr<ChunkOpRequest> opReq;
+            if (CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH == ops[i].first) {
+                opReq = std::make_shared<DeleteChunksRequest>(copysetNode,
+                    &cntls[i], &requests[i], &responses[i], &dones[i]);
+            } else {
+                cntls[i].request_attachment().append(str);
+                opReq = std::make_shared<WriteChunkRequest>(copysetNode,
+                    &cntls[i], &requests[i], &responses[i], &dones[i]);
+            }
+            copysetNode->ApplyEntry(i + 1, butil::IOBuf(),
+                                    new ChunkClosure(opReq));
+        }
+        concurrentModule_.Flush();
+        checkOrder();
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                      responses[i].status());
+        }
+    }
+
+    // 重启回放日志和follower apply，op从log entry中解析
+    {
+        butil::IOBuf data;
+        data.append(std::string(4096, 'a'));
+        for (int i = 0; i < 4; ++i) {
+            ChunkRequest request;
+            makeRequest(ops[i].first, ops[i].second, &request);
+            butil::IOBuf log;
+            if (CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH == ops[i].first) {
+                ASSERT_EQ(0, ChunkOpRequest::Encode(&request, nullptr, &log));
+            } else {
+                ASSERT_EQ(0, ChunkOpRequest::Encode(&request, &data, &log));
+            }
+            copysetNode->ApplyEntry(i + 5, log, nullptr);
+        }
+        concurrentModule_.Flush();
+        checkOrder();
+    }
+}
+
 }  // namespace chunkserver
 }  // namespace curve
@@ -261,6 +261,41 @@ TEST_F(CSChunkfilePool_test, RecycleChunkTest) {
     ASSERT_EQ(0, fsptr->Delete("./cspooltest/chunkfilepool/4"));
 }
 
+TEST_F(CSChunkfilePool_test, RecycleChunksTest) {
+    std::string chunkfilepool = "./cspooltest/chunkfilepool.meta";
+    ChunkfilePoolOptions cfop;
+    cfop.chunkSize = 4096;
+    cfop.metaPageSize = 4096;
+    memcpy(cfop.metaPath, chunkfilepool.c_str(), chunkfilepool.size());
+
+    ChunkfilepoolPtr_->Initialize(cfop);
+    ASSERT_EQ(50, ChunkfilepoolPtr_->Size());
+    char metapage[4096];
+    memset(metapage, '1', 4096);
+    ASSERT_EQ(0, ChunkfilepoolPtr_->GetChunk("./new1", metapage));
+    ASSERT_EQ(0, ChunkfilepoolPtr_->GetChunk("./new2", metapage));
+    ASSERT_EQ(48, ChunkfilepoolPtr_->Size());
+
+    // 大小不符合要求的文件直接删除，不回收到chunkfilepool
+    int fd = fsptr->Open("./new3", O_RDWR | O_CREAT);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(0, fsptr->Close(fd));
+
+    std::vector<std::string> chunkpaths = {"./new1", "./new2", "./new3"};
+    ASSERT_EQ(0, ChunkfilepoolPtr_->RecycleChunks(chunkpaths));
+    ASSERT_EQ(50, ChunkfilepoolPtr_->Size());
+    ChunkFilePoolState_t currentStat = ChunkfilepoolPtr_->GetState();
+    ASSERT_EQ(50, currentStat.preallocatedChunksLeft);
+
+    ASSERT_FALSE(fsptr->FileExists("./new1"));
+    ASSERT_FALSE(fsptr->FileExists("./new2"));
+    ASSERT_FALSE(fsptr->FileExists("./new3"));
+    ASSERT_TRUE(fsptr->FileExists("./cspooltest/chunkfilepool/4"));
+    ASSERT_TRUE(fsptr->FileExists("./cspooltest/chunkfilepool/5"));
+    ASSERT_EQ(0, fsptr->Delete("./cspooltest/chunkfilepool/4"));
+    ASSERT_EQ(0, fsptr->Delete("./cspooltest/chunkfilepool/5"));
+}
+
 TEST(CSChunkfilePool, GetChunkDirectlyTest) {
     std::shared_ptr<ChunkfilePool>  ChunkfilepoolPtr_;
     std::shared_ptr<LocalFileSystem>  fsptr;
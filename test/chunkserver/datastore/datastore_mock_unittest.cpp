@@ -2908,6 +2908,186 @@ TEST_F(CSDataStore_test, DeleteChunkErrorTest1) {
         .Times(1);
 }
 
+/**
+ * DeleteChunksTest
+ * case1:chunk2存在,chunk3不存在,sn<chunk2的sn
+ * 预期结果1:返回BackwardRequestError,不回收chunk
+ * case2:chunk2存在,chunk3不存在
+ * 预期结果2:返回成功,chunk2通过RecycleChunks回收
+ */
+TEST_F(CSDataStore_test, DeleteChunksTest) {
+    // initialize
+    FakeEnv();
+    EXPECT_TRUE(dataStore->Initialize());
+
+    std::vector<ChunkID> ids = {2, 3};
+
+    // case1
+    {
+        EXPECT_CALL(*lfs_, Close(3))
+            .Times(0);
+        EXPECT_CALL(*fpool_, RecycleChunks(_))
+            .Times(0);
+        EXPECT_EQ(CSErrorCode::BackwardRequestError,
+                  dataStore->DeleteChunks(ids, 1));
+    }
+
+    // case2
+    {
+        // chunk will be closed
+        EXPECT_CALL(*lfs_, Close(3))
+            .Times(1);
+        EXPECT_CALL(*fpool_, RecycleChunks(ElementsAre(chunk2Path)))
+            .WillOnce(Return(0));
+        EXPECT_EQ(CSErrorCode::Success,
+                  dataStore->DeleteChunks(ids, 2));
+        CSChunkInfo info;
+        ASSERT_EQ(CSErrorCode::ChunkNotExistError,
+                  dataStore->GetChunkInfo(2, &info));
+    }
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+}
+
+/**
+ * DeleteChunksErrorTest
+ * case:chunk存在,RecycleChunks时出错
+ * 预期结果:返回InternalError
+ */
+TEST_F(CSDataStore_test, DeleteChunksErrorTest) {
+    // initialize
+    FakeEnv();
+    EXPECT_TRUE(dataStore->Initialize());
+
+    std::vector<ChunkID> ids = {2};
+    // chunk will be closed
+    EXPECT_CALL(*lfs_, Close(3))
+        .Times(1);
+    EXPECT_CALL(*fpool_, RecycleChunks(ElementsAre(chunk2Path)))
+        .WillOnce(Return(-1));
+    EXPECT_EQ(CSErrorCode::InternalError,
+              dataStore->DeleteChunks(ids, 2));
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+}
+
+/**
+ * DiscardChunkTest
+ * case:chunk不存在
+ * 预期结果:返回成功
+ */
+TEST_F(CSDataStore_test, DiscardChunkTest1) {
+    // initialize
+    FakeEnv();
+    EXPECT_TRUE(dataStore->Initialize());
+
+    ChunkID id = 3;
+    SequenceNum sn = 2;
+
+    // test chunk not exists
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->DiscardChunk(id, sn));
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(3))
+        .Times(1);
+}
+
+/**
+ * DiscardChunkTest
+ * case:chunk存在快照文件
+ * 预期结果:返回SnapshotExistError，chunk和快照都被保留
+ */
+TEST_F(CSDataStore_test, DiscardChunkTest2) {
+    // initialize
+    FakeEnv();
+    EXPECT_TRUE(dataStore->Initialize());
+
+    ChunkID id = 1;
+    SequenceNum sn = 2;
+
+    EXPECT_CALL(*fpool_, RecycleChunk(_))
+        .Times(0);
+    EXPECT_EQ(CSErrorCode::SnapshotExistError,
+              dataStore->DiscardChunk(id, sn));
+    CSChunkInfo info;
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore->GetChunkInfo(id, &info));
+    ASSERT_EQ(1, info.snapSn);
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(3))
+        .Times(1);
+}
+
+/**
+ * DiscardChunkTest
+ * chunk存在,快照文件不存在
+ * case1: sn<chunkinfo.sn
+ * 预期结果1:返回BackwardRequestError
+ * case2: sn>chunkinfo.sn，chunk还未转储
+ * 预期结果2:返回SnapshotExistError，chunk被保留
+ * case3: sn==chunkinfo.sn
+ * 预期结果3:返回成功，chunk被回收到chunkfilepool
+ */
+TEST_F(CSDataStore_test, DiscardChunkTest3) {
+    // initialize
+    FakeEnv();
+    EXPECT_TRUE(dataStore->Initialize());
+
+    ChunkID id = 2;
+
+    // case1
+    {
+        EXPECT_CALL(*lfs_, Close(3))
+            .Times(0);
+        EXPECT_CALL(*fpool_, RecycleChunk(chunk2Path))
+            .Times(0);
+        EXPECT_EQ(CSErrorCode::BackwardRequestError,
+                  dataStore->DiscardChunk(id, 1));
+    }
+
+    // case2
+    {
+        EXPECT_CALL(*lfs_, Close(3))
+            .Times(0);
+        EXPECT_CALL(*fpool_, RecycleChunk(chunk2Path))
+            .Times(0);
+        EXPECT_EQ(CSErrorCode::SnapshotExistError,
+                  dataStore->DiscardChunk(id, 3));
+    }
+
+    // case3
+    {
+        EXPECT_CALL(*lfs_, Close(3))
+            .Times(1);
+        EXPECT_CALL(*fpool_, RecycleChunk(chunk2Path))
+            .WillOnce(Return(0));
+        EXPECT_EQ(CSErrorCode::Success,
+                  dataStore->DiscardChunk(id, 2));
+        CSChunkInfo info;
+        ASSERT_EQ(CSErrorCode::ChunkNotExistError,
+                  dataStore->GetChunkInfo(id, &info));
+    }
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+}
+
 /**
  * DeleteSnapshotChunkOrCorrectSnTest
  * case:chunk不存在
@@ -26,6 +26,7 @@
 #include <gmock/gmock.h>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "src/chunkserver/datastore/chunkfile_pool.h"
 
@@ -40,6 +41,7 @@ class MockChunkfilePool : public ChunkfilePool {
     MOCK_METHOD1(Initialize, bool(ChunkfilePoolOptions));
     MOCK_METHOD2(GetChunk, int(const std::string&, char*));
     MOCK_METHOD1(RecycleChunk, int(const std::string&  chunkpath));
+    MOCK_METHOD1(RecycleChunks, int(const std::vector<std::string>&));
     MOCK_METHOD0(UnInitialize, void());
     MOCK_METHOD0(Size, size_t());
 };
@@ -25,6 +25,7 @@
 
 #include <gmock/gmock.h>
 #include <string>
+#include <vector>
 
 #include "src/chunkserver/datastore/chunkserver_datastore.h"
 
@@ -37,6 +38,9 @@ class MockDataStore : public CSDataStore {
     ~MockDataStore() = default;
     MOCK_METHOD0(Initialize, bool());
     MOCK_METHOD2(DeleteChunk, CSErrorCode(ChunkID, SequenceNum));
+    MOCK_METHOD2(DeleteChunks, CSErrorCode(const std::vector<ChunkID>&,
+                                           SequenceNum));
+    MOCK_METHOD2(DiscardChunk, CSErrorCode(ChunkID, SequenceNum));
     MOCK_METHOD2(DeleteSnapshotChunkOrCorrectSn, CSErrorCode(ChunkID,
                                                              SequenceNum));
     MOCK_METHOD5(ReadChunk, CSErrorCode(ChunkID,
@@ -78,6 +78,27 @@ class FakeCSDataStore : public CSDataStore {
         }
     }
 
+    CSErrorCode DeleteChunks(const std::vector<ChunkID>& ids,
+                             SequenceNum sn) override {
+        CSErrorCode errorCode = HasInjectError();
+        if (errorCode != CSErrorCode::Success) {
+            return errorCode;
+        }
+        for (auto id : ids) {
+            chunkIds_.erase(id);
+        }
+        return CSErrorCode::Success;
+    }
+
+    CSErrorCode DiscardChunk(ChunkID id, SequenceNum sn) override {
+        CSErrorCode errorCode = HasInjectError();
+        if (errorCode != CSErrorCode::Success) {
+            return errorCode;
+        }
+        chunkIds_.erase(id);
+        return CSErrorCode::Success;
+    }
+
     CSErrorCode DeleteSnapshotChunkOrCorrectSn(
         ChunkID id, SequenceNum correctedSn) override {
         CSErrorCode errorCode = HasInjectError();
@@ -208,6 +208,54 @@ TEST(HeartbeatHelperTest, test_ChunkServerLoadCopySetFin) {
     delete copysetNodeManager;
 }
 
+TEST(HeartbeatHelperTest, test_BuildDeltaCopysets) {
+    auto buildRequest = [](uint64_t changedEpoch, int copysetNum) {
+        ChunkServerHeartbeatRequest request;
+        for (int i = 1; i <= copysetNum; i++) {
+            auto info = request.add_copysetinfos();
+            info->set_logicalpoolid(1);
+            info->set_copysetid(i);
+            info->set_epoch(i == 2 ? changedEpoch : 1);
+            info->mutable_leaderpeer()->set_address("127.0.0.1:8200:0");
+        }
+        return request;
+    };
+    std::map<GroupNid, std::string> lastReported;
+
+    // 1. 第一次上报为全量
+    auto request = buildRequest(1, 3);
+    ASSERT_FALSE(HeartbeatHelper::BuildDeltaCopysets(
+        &request, false, &lastReported));
+    ASSERT_EQ(3, request.copysetinfos_size());
+    ASSERT_EQ(3, lastReported.size());
+
+    // 2. copyset都没有变化
+    request = buildRequest(1, 3);
+    ASSERT_TRUE(HeartbeatHelper::BuildDeltaCopysets(
+        &request, false, &lastReported));
+    ASSERT_EQ(0, request.copysetinfos_size());
+
+    // 3. 只上报epoch变化的copyset
+    request = buildRequest(2, 3);
+    ASSERT_TRUE(HeartbeatHelper::BuildDeltaCopysets(
+        &request, false, &lastReported));
+    ASSERT_EQ(1, request.copysetinfos_size());
+    ASSERT_EQ(2, request.copysetinfos(0).copysetid());
+
+    // 4. 强制全量
+    request = buildRequest(2, 3);
+    ASSERT_FALSE(HeartbeatHelper::BuildDeltaCopysets(
+        &request, true, &lastReported));
+    ASSERT_EQ(3, request.copysetinfos_size());
+
+    // 5. copyset被删除，上报全量
+    request = buildRequest(2, 2);
+    ASSERT_FALSE(HeartbeatHelper::BuildDeltaCopysets(
+        &request, false, &lastReported));
+    ASSERT_EQ(2, request.copysetinfos_size());
+    ASSERT_EQ(2, lastReported.size());
+}
+
 }  // namespace chunkserver
 }  // namespace curve
 
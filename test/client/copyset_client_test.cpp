@@ -36,6 +36,7 @@
 #include "test/client/mock_request_context.h"
 #include "src/client/chunk_closure.h"
 #include "src/common/timeutility.h"
+#include "src/common/crc32.h"
 #include "test/client/fake/fakeChunkserver.h"
 
 namespace curve {
@@ -4424,5 +4425,167 @@ TEST_F(CopysetClientTest, retry_rpc_sleep_test) {
     scheduler.Fini();
 }
 
+static void ReadChunkWithCrcFunc(
+    ::google::protobuf::RpcController *controller,
+    const ::curve::chunkserver::ChunkRequest *request,
+    ::curve::chunkserver::ChunkResponse *response,
+    google::protobuf::Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller *cntl = dynamic_cast<brpc::Controller *>(controller);
+    std::string data(request->size(), 'a');
+    cntl->response_attachment().append(data);
+}
+
+TEST_F(CopysetClientTest, crc_test) {
+    MockChunkServiceImpl mockChunkService;
+    ASSERT_EQ(server_->AddService(&mockChunkService,
+                                  brpc::SERVER_DOESNT_OWN_SERVICE), 0);
+    ASSERT_EQ(server_->Start(listenAddr_.c_str(), nullptr), 0);
+
+    IOSenderOption_t ioSenderOpt;
+    ioSenderOpt.failRequestOpt.chunkserverRPCTimeoutMS = 1000;
+    ioSenderOpt.failRequestOpt.chunkserverOPMaxRetry = 3;
+    ioSenderOpt.failRequestOpt.chunkserverOPRetryIntervalUS = 500;
+    ioSenderOpt.failRequestOpt.chunkserverMaxRPCTimeoutMS = 3500;
+    ioSenderOpt.failRequestOpt.chunkserverMaxRetrySleepIntervalUS = 3500000;
+    ioSenderOpt.chunkserverEnableAppliedIndexRead = 1;
+    ioSenderOpt.crcOpt.enable = true;
+    ioSenderOpt.crcOpt.logicPoolIds = {1};
+
+    RequestScheduleOption_t reqopt;
+    reqopt.ioSenderOpt = ioSenderOpt;
+
+    CopysetClient copysetClient;
+    MockMetaCache mockMetaCache;
+    mockMetaCache.DelegateToFake();
+
+    RequestScheduler scheduler;
+    scheduler.Init(reqopt, &mockMetaCache);
+    scheduler.Run();
+
+    copysetClient.Init(&mockMetaCache, ioSenderOpt, &scheduler);
+
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 100001;
+    ChunkID chunkId = 1;
+    uint64_t sn = 1;
+    size_t len = 8;
+    char buff1[8 + 1];
+    memset(buff1, 'a', 8);
+    buff1[8] = '\0';
+    off_t offset = 0;
+    uint32_t crc = curve::common::CRC32(buff1, len);
+
+    ChunkServerID leaderId = 10000;
+    butil::EndPoint leaderAddr;
+    butil::str2endpoint(listenAddr_.c_str(), &leaderAddr);
+
+    FileMetric fm("test");
+    IOTracker iot(nullptr, nullptr, nullptr, &fm);
+
+    EXPECT_CALL(mockMetaCache, GetLeader(_, _, _, _, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<2>(leaderId),
+                              SetArgPointee<3>(leaderAddr),
+                              Return(0)));
+
+    /* 写请求携带数据的CRC，chunkserver校验失败时重试 */
+    {
+        RequestContext *reqCtx = new FakeRequestContext();
+        reqCtx->optype_ = OpType::WRITE;
+        reqCtx->idinfo_ = ChunkIDInfo(chunkId, logicPoolId, copysetId);
+        reqCtx->writeBuffer_ = buff1;
+        reqCtx->offset_ = 0;
+        reqCtx->rawlength_ = len;
+
+        curve::common::CountDownEvent cond(1);
+        RequestClosure *reqDone = new FakeRequestClosure(&cond, reqCtx);
+        reqDone->SetFileMetric(&fm);
+        reqDone->SetIOTracker(&iot);
+        reqCtx->done_ = reqDone;
+
+        ChunkResponse response1;
+        response1.set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_CRC_FAIL);
+        ChunkResponse response2;
+        response2.set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        ChunkRequest request;
+        EXPECT_CALL(mockChunkService, WriteChunk(_, _, _, _)).Times(2)
+            .WillOnce(DoAll(SaveArgPointee<1>(&request),
+                            SetArgPointee<2>(response1),
+                            Invoke(WriteChunkFunc)))
+            .WillOnce(DoAll(SetArgPointee<2>(response2),
+                            Invoke(WriteChunkFunc)));
+        copysetClient.WriteChunk(reqCtx->idinfo_, sn, buff1,
+                                 offset, len, {}, reqDone);
+        cond.Wait();
+        ASSERT_EQ(0, reqDone->GetErrorCode());
+        ASSERT_TRUE(request.has_crc32());
+        ASSERT_EQ(crc, request.crc32());
+        ASSERT_EQ(1, fm.crc.writeMismatch.get_value());
+    }
+    /* 读请求返回的数据CRC不一致时重试 */
+    {
+        RequestContext *reqCtx = new FakeRequestContext();
+        reqCtx->optype_ = OpType::READ;
+        reqCtx->idinfo_ = ChunkIDInfo(chunkId, logicPoolId, copysetId);
+        reqCtx->offset_ = 0;
+        reqCtx->rawlength_ = len;
+
+        curve::common::CountDownEvent cond(1);
+        RequestClosure *reqDone = new FakeRequestClosure(&cond, reqCtx);
+        reqDone->SetFileMetric(&fm);
+        reqDone->SetIOTracker(&iot);
+        reqCtx->done_ = reqDone;
+
+        ChunkResponse response1;
+        response1.set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        response1.set_crc32(crc + 1);
+        ChunkResponse response2;
+        response2.set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        response2.set_crc32(crc);
+        ChunkRequest request;
+        EXPECT_CALL(mockChunkService, ReadChunk(_, _, _, _)).Times(2)
+            .WillOnce(DoAll(SaveArgPointee<1>(&request),
+                            SetArgPointee<2>(response1),
+                            Invoke(ReadChunkWithCrcFunc)))
+            .WillOnce(DoAll(SetArgPointee<2>(response2),
+                            Invoke(ReadChunkWithCrcFunc)));
+        copysetClient.ReadChunk(reqCtx->idinfo_, sn,
+                                offset, len, 0, {}, reqDone);
+        cond.Wait();
+        ASSERT_EQ(0, reqDone->GetErrorCode());
+        ASSERT_TRUE(request.needcrc());
+        ASSERT_EQ(1, fm.crc.readMismatch.get_value());
+    }
+    /* 未开启CRC校验的逻辑池不携带CRC */
+    {
+        RequestContext *reqCtx = new FakeRequestContext();
+        reqCtx->optype_ = OpType::WRITE;
+        reqCtx->idinfo_ = ChunkIDInfo(chunkId, logicPoolId + 1, copysetId);
+        reqCtx->writeBuffer_ = buff1;
+        reqCtx->offset_ = 0;
+        reqCtx->rawlength_ = len;
+
+        curve::common::CountDownEvent cond(1);
+        RequestClosure *reqDone = new FakeRequestClosure(&cond, reqCtx);
+        reqDone->SetFileMetric(&fm);
+        reqDone->SetIOTracker(&iot);
+        reqCtx->done_ = reqDone;
+
+        ChunkResponse response;
+        response.set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        ChunkRequest request;
+        EXPECT_CALL(mockChunkService, WriteChunk(_, _, _, _)).Times(1)
+            .WillOnce(DoAll(SaveArgPointee<1>(&request),
+                            SetArgPointee<2>(response),
+                            Invoke(WriteChunkFunc)));
+        copysetClient.WriteChunk(reqCtx->idinfo_, sn, buff1,
+                                 offset, len, {}, reqDone);
+        cond.Wait();
+        ASSERT_EQ(0, reqDone->GetErrorCode());
+        ASSERT_FALSE(request.has_crc32());
+    }
+    scheduler.Fini();
+}
+
 }   // namespace client
 }   // namespace curve
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/client/discard_recorder.h"
+
+namespace curve {
+namespace client {
+
+const uint64_t kKB = 1024;
+const uint64_t kMB = 1024 * 1024;
+const uint64_t kChunkSize = 16 * 1024 * 1024;
+
+class DiscardRecorderTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        opt_.enable = true;
+        opt_.granularityKB = 4;
+        opt_.maxRecordChunkNum = 2;
+    }
+
+    DiscardOption_t opt_;
+    DiscardRecorder recorder_;
+};
+
+TEST_F(DiscardRecorderTest, DisableTest) {
+    DiscardRecorder recorder;
+    DiscardOption_t opt;
+    recorder.Init(opt, nullptr);
+    ASSERT_FALSE(recorder.Enabled());
+
+    // 不记录任何chunk时不开启
+    opt.enable = true;
+    opt.maxRecordChunkNum = 0;
+    recorder.Init(opt, nullptr);
+    ASSERT_FALSE(recorder.Enabled());
+    ASSERT_FALSE(recorder.Record(0, 0, 8 * kMB, kChunkSize));
+    ASSERT_EQ(0, recorder.GetRecordChunkNum());
+
+    // chunk大小不是粒度的整数倍时不记录
+    opt.maxRecordChunkNum = 2;
+    opt.granularityKB = 3;
+    recorder.Init(opt, nullptr);
+    ASSERT_TRUE(recorder.Enabled());
+    ASSERT_FALSE(recorder.Record(0, 0, 8 * kMB, kChunkSize));
+    ASSERT_EQ(0, recorder.GetRecordChunkNum());
+}
+
+TEST_F(DiscardRecorderTest, RecordTest) {
+    recorder_.Init(opt_, nullptr);
+    ASSERT_TRUE(recorder_.Enabled());
+
+    // 不足一个粒度的区间被忽略
+    ASSERT_FALSE(recorder_.Record(0, 1 * kKB, 2 * kKB, kChunkSize));
+    ASSERT_FALSE(recorder_.Record(0, 2 * kKB, 4 * kKB, kChunkSize));
+    ASSERT_EQ(0, recorder_.GetRecordChunkNum());
+
+    // 分多次覆盖整个chunk后返回true，并删除记录
+    ASSERT_FALSE(recorder_.Record(0, 0, 8 * kMB, kChunkSize));
+    ASSERT_EQ(1, recorder_.GetRecordChunkNum());
+    ASSERT_FALSE(recorder_.Record(0, 12 * kMB, 4 * kMB, kChunkSize));
+    ASSERT_FALSE(recorder_.Record(0, 8 * kMB, 4 * kMB - 1, kChunkSize));
+    ASSERT_TRUE(recorder_.Record(0, 12 * kMB - 4 * kKB, 4 * kKB, kChunkSize));
+    ASSERT_EQ(0, recorder_.GetRecordChunkNum());
+}
+
+TEST_F(DiscardRecorderTest, ClearTest) {
+    recorder_.Init(opt_, nullptr);
+
+    ASSERT_FALSE(recorder_.Record(0, 0, kChunkSize - 4 * kKB, kChunkSize));
+    ASSERT_FALSE(recorder_.Record(1, 4 * kKB, kChunkSize - 4 * kKB,
+                                  kChunkSize));
+
+    // 写请求跨越两个chunk，部分覆盖的粒度也被清除
+    recorder_.Clear(kChunkSize - 6 * kKB, 12 * kKB, kChunkSize);
+    ASSERT_FALSE(recorder_.Record(0, kChunkSize - 4 * kKB, 4 * kKB,
+                                  kChunkSize));
+    ASSERT_FALSE(recorder_.Record(1, 0, 4 * kKB, kChunkSize));
+    ASSERT_TRUE(recorder_.Record(0, kChunkSize - 8 * kKB, 4 * kKB, kChunkSize));
+    ASSERT_TRUE(recorder_.Record(1, 4 * kKB, 4 * kKB, kChunkSize));
+
+    // 清除整个chunk的记录
+    ASSERT_FALSE(recorder_.Record(2, 0, 4 * kKB, kChunkSize));
+    recorder_.Clear(2);
+    ASSERT_EQ(0, recorder_.GetRecordChunkNum());
+
+    ASSERT_FALSE(recorder_.Record(2, 0, 4 * kKB, kChunkSize));
+    recorder_.Drop();
+    ASSERT_EQ(0, recorder_.GetRecordChunkNum());
+}
+
+TEST_F(DiscardRecorderTest, EvictTest) {
+    recorder_.Init(opt_, nullptr);
+
+    ASSERT_FALSE(recorder_.Record(0, 0, 8 * kMB, kChunkSize));
+    ASSERT_FALSE(recorder_.Record(1, 0, 8 * kMB, kChunkSize));
+    ASSERT_FALSE(recorder_.Record(0, 8 * kMB, 4 * kMB, kChunkSize));
+
+    // 超过上限时淘汰最久未更新的记录
+    ASSERT_FALSE(recorder_.Record(2, 0, 8 * kMB, kChunkSize));
+    ASSERT_EQ(2, recorder_.GetRecordChunkNum());
+    ASSERT_TRUE(recorder_.Record(0, 12 * kMB, 4 * kMB, kChunkSize));
+    ASSERT_FALSE(recorder_.Record(1, 8 * kMB, 8 * kMB, kChunkSize));
+}
+
+}   // namespace client
+}   // namespace curve
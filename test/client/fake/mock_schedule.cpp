@@ -21,6 +21,8 @@
  */
 
 #include <glog/logging.h>
+#include <list>
+#include <string>
 #include <vector>
 
 #include "test/client/fake/mock_schedule.h"
@@ -45,6 +47,8 @@ int Schedule::ScheduleRequest(
         int processed = 0;
         int totallength = 0;
         std::vector<datastruct> datavec;
+        // 数据来自iov的写请求没有连续的buffer，拷贝一份用于校验
+        std::list<std::string> iovdatas;
         LOG(ERROR) << size;
 
         if (enableScheduleFailed) {
@@ -73,9 +77,10 @@ int Schedule::ScheduleRequest(
             }
 
             if (iter->optype_ == curve::client::OpType::READ) {
-                memset(iter->readBuffer_,
-                        fakedate[processed%10],
-                        iter->rawlength_);
+                butil::IOBuf data;
+                data.append(std::string(iter->rawlength_,
+                                        fakedate[processed%10]));
+                iter->SetReadData(&data);
                 // LOG(ERROR)  << "request split"
                 //            << ", off = " << iter->offset_
                 //            << ", len = " << iter->rawlength_
@@ -90,6 +95,10 @@ int Schedule::ScheduleRequest(
                 datastruct datas;
                 datas.length = iter->rawlength_;
                 datas.data = const_cast<char*>(iter->writeBuffer_);
+                if (datas.data == nullptr) {
+                    iovdatas.push_back(iter->writeData_.to_string());
+                    datas.data = &iovdatas.back()[0];
+                }
                 totallength += iter->rawlength_;
                 datavec.push_back(datas);
             }
@@ -0,0 +1,222 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <gtest/gtest.h>
+#include <bthread/unstable.h>
+#include <butil/time.h>
+
+#include <memory>
+#include <string>
+
+#include "src/client/hedge_read.h"
+
+namespace curve {
+namespace client {
+
+TEST(LatencyHistogramTest, PercentileTest) {
+    LatencyHistogram histogram(99);
+
+    // 样本数不足时不给出结果
+    for (uint32_t i = 0; i < LatencyHistogram::kMinSampleNum - 1; ++i) {
+        histogram.Record(1000);
+    }
+    ASSERT_EQ(0, histogram.GetPercentile());
+
+    // 99%的请求为1000us，1%的请求为100000us
+    for (uint32_t i = 0; i < 1000; ++i) {
+        histogram.Record(i % 100 == 0 ? 100000 : 1000);
+    }
+    uint64_t p99 = histogram.GetPercentile();
+    ASSERT_GE(p99, 1000);
+    ASSERT_LE(p99, 1000 * 9 / 8);
+
+    LatencyHistogram p50(50);
+    for (uint32_t i = 0; i < 1024; ++i) {
+        p50.Record(i % 2 == 0 ? 200 : 5000);
+    }
+    ASSERT_GE(p50.GetPercentile(), 200);
+    ASSERT_LE(p50.GetPercentile(), 200 * 9 / 8);
+}
+
+TEST(LatencyHistogramTest, DecayTest) {
+    LatencyHistogram histogram(99);
+    for (uint32_t i = 0; i < LatencyHistogram::kDecayInterval; ++i) {
+        histogram.Record(500);
+    }
+    ASSERT_LE(histogram.GetPercentile(), 500 * 9 / 8);
+
+    // latency变大后，历史样本的权重逐渐衰减，百分位跟随变化
+    for (uint32_t i = 0; i < 4 * LatencyHistogram::kDecayInterval; ++i) {
+        histogram.Record(20000);
+    }
+    ASSERT_GE(histogram.GetPercentile(), 20000);
+    ASSERT_LE(histogram.GetPercentile(), 20000 * 9 / 8);
+}
+
+class HedgeReadHelperTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        opt_.enable = true;
+        opt_.latencyPercentile = 99;
+        opt_.minDelayMS = 2;
+        opt_.maxHedgePercent = 10;
+        HedgeReadHelper::GetInstance().ResetState();
+    }
+
+    void TearDown() override {
+        HedgeReadHelper::GetInstance().SetOption(HedgeReadOption_t());
+        HedgeReadHelper::GetInstance().ResetState();
+    }
+
+    HedgeReadOption_t opt_;
+};
+
+TEST_F(HedgeReadHelperTest, DisableTest) {
+    HedgeReadHelper& helper = HedgeReadHelper::GetInstance();
+    helper.SetOption(HedgeReadOption_t());
+    ASSERT_FALSE(helper.Enabled());
+
+    for (uint32_t i = 0; i < 1024; ++i) {
+        helper.RecordLatency(1, 1000);
+    }
+    ASSERT_EQ(0, helper.GetLatencyPercentile(1));
+    ASSERT_EQ(0, helper.GetHedgeDelayUs(1, true));
+
+    // 参数不合法时不开启
+    opt_.latencyPercentile = 0;
+    helper.SetOption(opt_);
+    ASSERT_FALSE(helper.Enabled());
+}
+
+TEST_F(HedgeReadHelperTest, DelayTest) {
+    HedgeReadHelper& helper = HedgeReadHelper::GetInstance();
+    helper.SetOption(opt_);
+    ASSERT_TRUE(helper.Enabled());
+
+    // 没有latency样本时不对冲，chunkserver有超时时用最小等待时间
+    ASSERT_EQ(0, helper.GetHedgeDelayUs(1, false));
+    ASSERT_EQ(2000, helper.GetHedgeDelayUs(1, true));
+
+    for (uint32_t i = 0; i < 1024; ++i) {
+        helper.RecordLatency(1, 10000);
+        helper.RecordLatency(2, 100);
+    }
+    uint64_t delay = helper.GetHedgeDelayUs(1, false);
+    ASSERT_GE(delay, 10000);
+    ASSERT_LE(delay, 10000 * 9 / 8);
+
+    // 等待时间不小于minDelayMS
+    ASSERT_EQ(2000, helper.GetHedgeDelayUs(2, false));
+}
+
+TEST_F(HedgeReadHelperTest, QuotaTest) {
+    HedgeReadHelper& helper = HedgeReadHelper::GetInstance();
+    helper.SetOption(opt_);
+
+    // 每10个读请求可以发起一个对冲读
+    ASSERT_FALSE(helper.AcquireHedgeQuota());
+    for (int i = 0; i < 9; ++i) {
+        helper.GetHedgeDelayUs(1, false);
+    }
+    ASSERT_FALSE(helper.AcquireHedgeQuota());
+    helper.GetHedgeDelayUs(1, false);
+    ASSERT_TRUE(helper.AcquireHedgeQuota());
+    ASSERT_FALSE(helper.AcquireHedgeQuota());
+
+    // 额度最多累积kMaxBurstHedge个
+    for (int i = 0; i < 10000; ++i) {
+        helper.GetHedgeDelayUs(1, false);
+    }
+    for (int64_t i = 0; i < HedgeReadHelper::kMaxBurstHedge; ++i) {
+        ASSERT_TRUE(helper.AcquireHedgeQuota());
+    }
+    ASSERT_FALSE(helper.AcquireHedgeQuota());
+}
+
+TEST(HedgeReadStateTest, StateTest) {
+    ChunkIDInfo idinfo(1, 2, 3);
+    const size_t length = 4096;
+
+    // 对冲读成功后不再发送leader读请求，数据由leader读请求的closure返回
+    {
+        HedgeReadState state(nullptr, idinfo, 1, 0, length, 10, 1);
+        ASSERT_TRUE(state.RegisterPrimaryCall(brpc::CallId()));
+        ASSERT_FALSE(state.HedgeSucceeded());
+
+        bool sent = false;
+        ASSERT_TRUE(state.IssueHedge([&sent]() { sent = true; }));
+        ASSERT_TRUE(sent);
+
+        butil::IOBuf data;
+        data.append(std::string(length, 'a'));
+        ASSERT_TRUE(state.OnHedgeSuccess(&data));
+        ASSERT_TRUE(state.HedgeSucceeded());
+        ASSERT_FALSE(state.RegisterPrimaryCall(brpc::CallId()));
+
+        ASSERT_EQ(std::string(length, 'a'), state.GetHedgeData().to_string());
+
+        // 只接受第一个成功的对冲读
+        butil::IOBuf other;
+        other.append(std::string(length, 'b'));
+        ASSERT_FALSE(state.OnHedgeSuccess(&other));
+    }
+
+    // 请求结束后不再发起对冲读，对冲读的结果直接丢弃
+    {
+        HedgeReadState state(nullptr, idinfo, 1, 0, length, 10, 1);
+        state.MarkDone();
+
+        bool sent = false;
+        ASSERT_FALSE(state.IssueHedge([&sent]() { sent = true; }));
+        ASSERT_FALSE(sent);
+
+        butil::IOBuf data;
+        data.append(std::string(length, 'a'));
+        ASSERT_FALSE(state.OnHedgeSuccess(&data));
+        ASSERT_FALSE(state.HedgeSucceeded());
+    }
+}
+
+TEST(HedgeReadStateTest, TimerTest) {
+    ChunkIDInfo idinfo(1, 2, 3);
+    auto state = std::make_shared<HedgeReadState>(
+        nullptr, idinfo, 1, 0, 4096, 10, 1);
+
+    // 请求在等待时间内返回，删除定时器并释放回调的参数
+    auto arg = new std::shared_ptr<HedgeReadState>(state);
+    bthread_timer_t timer;
+    ASSERT_EQ(0, bthread_timer_add(&timer,
+        butil::milliseconds_from_now(100 * 1000),
+        [](void* arg) {
+            delete static_cast<std::shared_ptr<HedgeReadState>*>(arg);
+        }, arg));
+    state->SetTimer(timer, arg);
+    ASSERT_EQ(2, state.use_count());
+
+    state->MarkDone();
+    ASSERT_EQ(1, state.use_count());
+
+    // 重复调用不会再次删除
+    state->MarkDone();
+    ASSERT_EQ(1, state.use_count());
+}
+
+}   // namespace client
+}   // namespace curve
@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>   // NOLINT
+#include <iostream>
+#include <thread>   // NOLINT
+#include <vector>
+
+#include "src/client/inflight_controller.h"
+#include "src/common/timeutility.h"
+
+using curve::common::TimeUtility;
+
+namespace curve {
+namespace client {
+
+TEST(InflightControlTest, TokenTest) {
+    InflightControl control;
+    control.SetMaxInflightNum(2);
+
+    control.GetInflightToken();
+    control.GetInflightToken();
+    ASSERT_EQ(2, control.GetInflightNum());
+
+    // 达到上限后获取令牌等待，有令牌释放后继续
+    std::atomic<bool> acquired(false);
+    std::thread th([&]() {
+        control.GetInflightToken();
+        acquired.store(true);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(acquired.load());
+
+    control.ReleaseInflightToken();
+    th.join();
+    ASSERT_TRUE(acquired.load());
+    ASSERT_EQ(2, control.GetInflightNum());
+
+    control.ReleaseInflightToken();
+    control.ReleaseInflightToken();
+    ASSERT_EQ(0, control.GetInflightNum());
+}
+
+TEST(InflightControlTest, WaitAllComeBackTest) {
+    InflightControl control;
+    control.IncremInflightNum();
+    control.IncremInflightNum();
+
+    std::atomic<bool> finished(false);
+    std::thread th([&]() {
+        control.WaitInflightAllComeBack();
+        finished.store(true);
+    });
+
+    control.DecremInflightNum();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(finished.load());
+
+    control.DecremInflightNum();
+    th.join();
+    ASSERT_TRUE(finished.load());
+}
+
+TEST(InflightControlTest, ConcurrentTest) {
+    const uint64_t maxInflight = 4;
+    const int threadNum = 8;
+    const int loop = 20000;
+
+    InflightControl control;
+    control.SetMaxInflightNum(maxInflight);
+
+    // 并发获取令牌时inflight数不超过上限
+    std::atomic<uint64_t> current(0);
+    std::atomic<uint64_t> peak(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadNum; ++i) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < loop; ++j) {
+                control.GetInflightToken();
+                uint64_t now = current.fetch_add(1) + 1;
+                uint64_t old = peak.load();
+                while (now > old && !peak.compare_exchange_weak(old, now)) {}
+                current.fetch_sub(1);
+                control.ReleaseInflightToken();
+            }
+        });
+    }
+
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    ASSERT_LE(peak.load(), maxInflight);
+    ASSERT_EQ(0, control.GetInflightNum());
+}
+
+TEST(InflightControlTest, CompletionPathPerfTest) {
+    const int threadNum = 4;
+    const uint64_t loop = 1000000;
+
+    InflightControl control;
+    control.SetMaxInflightNum(UINT64_MAX);
+
+    // 没有等待者时请求下发和返回的开销
+    std::vector<std::thread> threads;
+    uint64_t start = TimeUtility::GetTimeofDayUs();
+    for (int i = 0; i < threadNum; ++i) {
+        threads.emplace_back([&]() {
+            for (uint64_t j = 0; j < loop; ++j) {
+                control.GetInflightToken();
+                control.ReleaseInflightToken();
+            }
+        });
+    }
+
+    for (auto& th : threads) {
+        th.join();
+    }
+    uint64_t elapsed = TimeUtility::GetTimeofDayUs() - start;
+
+    ASSERT_EQ(0, control.GetInflightNum());
+    std::cout << "inflight control " << threadNum << " threads, "
+              << "get + release token cost = "
+              << elapsed * 1000.0 / (loop * threadNum) << " ns" << std::endl;
+}
+
+}   // namespace client
+}   // namespace curve
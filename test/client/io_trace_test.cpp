@@ -0,0 +1,192 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>   // NOLINT
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>   // NOLINT
+#include <vector>
+
+#include "src/client/io_trace.h"
+
+namespace curve {
+namespace client {
+
+namespace {
+void SleepMs(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+IOTraceRecord MakeRecord(uint64_t id, uint64_t totalUs) {
+    IOTraceRecord record;
+    record.ioId = id;
+    record.type = OpType::WRITE;
+    record.length = 4096;
+    record.totalUs = totalUs;
+    record.requestNum = 1;
+    return record;
+}
+}   // namespace
+
+TEST(RequestTraceTest, StageTest) {
+    // 未开启时不记录
+    RequestTrace disabled;
+    disabled.Mark();
+    SleepMs(5);
+    disabled.OnDequeue();
+    disabled.OnRetry();
+    ASSERT_EQ(0, disabled.TotalUs());
+    ASSERT_EQ(0, disabled.retryNum);
+
+    RequestTrace trace;
+    trace.enable = true;
+    trace.Mark();
+    SleepMs(10);
+    trace.OnDequeue();
+    SleepMs(10);
+    trace.OnRpcSend();
+    SleepMs(10);
+    trace.OnRpcDone();
+    ASSERT_GE(trace.queueUs, 10000);
+    ASSERT_GE(trace.dispatchUs, 10000);
+    ASSERT_GE(trace.rpcUs, 10000);
+    ASSERT_EQ(0, trace.backoffUs);
+
+    // 重试时各阶段的耗时累加
+    uint64_t rpcUs = trace.rpcUs;
+    SleepMs(10);
+    trace.OnRetry();
+    trace.OnRpcSend();
+    SleepMs(10);
+    trace.OnRpcDone();
+    ASSERT_GE(trace.backoffUs, 10000);
+    ASSERT_GE(trace.rpcUs, rpcUs + 10000);
+    ASSERT_EQ(1, trace.retryNum);
+    ASSERT_EQ(trace.queueUs + trace.dispatchUs + trace.rpcUs + trace.backoffUs,
+              trace.TotalUs());
+
+    // 被合并的请求累加合并请求的耗时
+    RequestTrace sub;
+    sub.enable = true;
+    sub.queueUs = 100;
+    sub.Accumulate(trace);
+    ASSERT_EQ(100 + trace.queueUs, sub.queueUs);
+    ASSERT_EQ(trace.rpcUs, sub.rpcUs);
+    ASSERT_EQ(1, sub.retryNum);
+}
+
+class IOTracerTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        metric_.reset(new FileMetric("io_trace_test"));
+        opt_.enable = true;
+        opt_.slowIOThresholdMS = 10;
+        opt_.slowIOSampleInterval = 1;
+        opt_.slowIORecordNum = 4;
+    }
+
+    std::unique_ptr<FileMetric> metric_;
+    IOTraceOption_t opt_;
+};
+
+TEST_F(IOTracerTest, DisableTest) {
+    IOTracer tracer;
+    tracer.Init(IOTraceOption_t(), "io_trace_test", metric_.get());
+    ASSERT_FALSE(tracer.Enabled());
+
+    tracer.Record(MakeRecord(1, 1000000));
+    ASSERT_TRUE(tracer.GetSlowIO().empty());
+}
+
+TEST_F(IOTracerTest, RingBufferTest) {
+    IOTracer tracer;
+    tracer.Init(opt_, "io_trace_test", metric_.get());
+    ASSERT_TRUE(tracer.Enabled());
+
+    // 没有超过阈值的IO不记录
+    tracer.Record(MakeRecord(1, 9999));
+    ASSERT_TRUE(tracer.GetSlowIO().empty());
+
+    // 慢IO按从新到旧排列，写满后覆盖最早的记录
+    for (uint64_t id = 2; id <= 4; ++id) {
+        tracer.Record(MakeRecord(id, 10000));
+    }
+    std::vector<IOTraceRecord> slowIO = tracer.GetSlowIO();
+    ASSERT_EQ(3, slowIO.size());
+    ASSERT_EQ(4, slowIO[0].ioId);
+    ASSERT_EQ(2, slowIO[2].ioId);
+
+    for (uint64_t id = 5; id <= 10; ++id) {
+        tracer.Record(MakeRecord(id, 20000));
+    }
+    slowIO = tracer.GetSlowIO();
+    ASSERT_EQ(4, slowIO.size());
+    for (uint64_t i = 0; i < slowIO.size(); ++i) {
+        ASSERT_EQ(10 - i, slowIO[i].ioId);
+    }
+}
+
+TEST_F(IOTracerTest, SampleTest) {
+    opt_.slowIOSampleInterval = 3;
+    opt_.slowIORecordNum = 16;
+    IOTracer tracer;
+    tracer.Init(opt_, "io_trace_test", metric_.get());
+
+    // 每3个慢IO记录一个
+    for (uint64_t id = 1; id <= 7; ++id) {
+        tracer.Record(MakeRecord(id, 50000));
+    }
+    std::vector<IOTraceRecord> slowIO = tracer.GetSlowIO();
+    ASSERT_EQ(3, slowIO.size());
+    ASSERT_EQ(7, slowIO[0].ioId);
+    ASSERT_EQ(4, slowIO[1].ioId);
+    ASSERT_EQ(1, slowIO[2].ioId);
+}
+
+TEST_F(IOTracerTest, DumpTest) {
+    IOTracer tracer;
+    tracer.Init(opt_, "io_trace_test", metric_.get());
+
+    IOTraceRecord record = MakeRecord(42, 30000);
+    record.taskQueueUs = 1000;
+    record.metadataUs = 2000;
+    record.slowestRequest.rpcUs = 25000;
+    record.slowestRequest.retryNum = 2;
+    tracer.Record(record);
+    tracer.Record(MakeRecord(43, 30000));
+
+    std::ostringstream os;
+    tracer.Dump(os);
+    std::string dump = os.str();
+    ASSERT_NE(std::string::npos, dump.find("IO id = 42"));
+    ASSERT_NE(std::string::npos, dump.find("metadata(us) = 2000"));
+    ASSERT_NE(std::string::npos, dump.find("rpc(us) = 25000"));
+    ASSERT_NE(std::string::npos, dump.find("retry num = 2"));
+    // 每个IO一行，新的在前
+    ASSERT_LT(dump.find("IO id = 43"), dump.find("IO id = 42"));
+    ASSERT_EQ(2, std::count(dump.begin(), dump.end(), '\n'));
+}
+
+}   // namespace client
+}   // namespace curve
@@ -314,6 +314,41 @@ TEST_F(IOTrackerSplitorTest, AsyncStartRead) {
     delete[] data;
 }
 
+TEST_F(IOTrackerSplitorTest, AsyncStartReadIOBuf) {
+    MockRequestScheduler* mockschuler = new MockRequestScheduler;
+    mockschuler->DelegateToFake();
+
+    curve::client::IOManager4File* iomana = fileinstance_->GetIOManager4File();
+    iomana->SetRequestScheduler(mockschuler);
+
+    CurveAioContext aioctx;
+    aioctx.offset = 4 * 1024 * 1024 - 4 * 1024;
+    aioctx.length = 4 * 1024 * 1024 + 8 * 1024;
+    aioctx.ret = LIBCURVE_ERROR::OK;
+    aioctx.cb = readcallback;
+    aioctx.buf = nullptr;
+    aioctx.op = LIBCURVE_OP::LIBCURVE_OP_READ;
+
+    ioreadflag = false;
+    butil::IOBuf data;
+    iomana->AioReadIOBuf(&aioctx, &data, &mdsclient_);
+
+    {
+        std::unique_lock<std::mutex> lk(readmtx);
+        readcv.wait(lk, []()->bool{return ioreadflag;});
+    }
+
+    // 数据按offset顺序拼接在IOBuf中
+    std::string str = data.to_string();
+    ASSERT_EQ(aioctx.length, str.size());
+    ASSERT_EQ('a', str[0]);
+    ASSERT_EQ('a', str[4 * 1024 - 1]);
+    ASSERT_EQ('b', str[4 * 1024]);
+    ASSERT_EQ('e', str[4 * 1024 + chunk_size - 1]);
+    ASSERT_EQ('f', str[4 * 1024 + chunk_size]);
+    ASSERT_EQ('f', str[aioctx.length - 1]);
+}
+
 TEST_F(IOTrackerSplitorTest, AsyncStartWrite) {
     MockRequestScheduler* mockschuler = new MockRequestScheduler;
     mockschuler->DelegateToFake();
@@ -356,6 +391,70 @@ TEST_F(IOTrackerSplitorTest, AsyncStartWrite) {
     delete[] data;
 }
 
+TEST_F(IOTrackerSplitorTest, AsyncStartReadvWritev) {
+    MockRequestScheduler* mockschuler = new MockRequestScheduler;
+    mockschuler->DelegateToFake();
+
+    curve::client::IOManager4File* iomana = fileinstance_->GetIOManager4File();
+    iomana->SetRequestScheduler(mockschuler);
+
+    // 写请求跨越chunk，iov的分段与chunk的边界不对齐
+    CurveAioContext aioctx;
+    aioctx.offset = 4 * 1024 * 1024 - 4 * 1024;
+    aioctx.length = chunk_size + 8 * 1024;
+    aioctx.ret = LIBCURVE_ERROR::OK;
+    aioctx.cb = writecallback;
+    aioctx.buf = nullptr;
+    aioctx.op = LIBCURVE_OP::LIBCURVE_OP_WRITE;
+
+    std::vector<char> first(6 * 1024, 'a');
+    std::vector<char> second(chunk_size - 4 * 1024, 'b');
+    std::vector<char> third(6 * 1024, 'c');
+    std::vector<iovec> iov = {{first.data(), first.size()},
+                              {second.data(), second.size()},
+                              {third.data(), third.size()}};
+
+    iowriteflag = false;
+    iomana->AioWritev(&aioctx, iov, &mdsclient_);
+
+    {
+        std::unique_lock<std::mutex> lk(writemtx);
+        writecv.wait(lk, []()->bool{return iowriteflag;});
+    }
+
+    ASSERT_EQ('a', writebuffer[0]);
+    ASSERT_EQ('a', writebuffer[6 * 1024 - 1]);
+    ASSERT_EQ('b', writebuffer[6 * 1024]);
+    ASSERT_EQ('b', writebuffer[chunk_size + 2 * 1024 - 1]);
+    ASSERT_EQ('c', writebuffer[chunk_size + 2 * 1024]);
+    ASSERT_EQ('c', writebuffer[aioctx.length - 1]);
+
+    // 读到的数据按顺序填充到各段buffer中
+    aioctx.length = 4 * 1024 * 1024 + 8 * 1024;
+    aioctx.cb = readcallback;
+    aioctx.op = LIBCURVE_OP::LIBCURVE_OP_READ;
+
+    std::vector<char> head(2 * 1024);
+    std::vector<char> body(aioctx.length - 2 * 1024);
+    iov = {{head.data(), head.size()}, {body.data(), body.size()}};
+
+    ioreadflag = false;
+    iomana->AioReadv(&aioctx, iov, &mdsclient_);
+
+    {
+        std::unique_lock<std::mutex> lk(readmtx);
+        readcv.wait(lk, []()->bool{return ioreadflag;});
+    }
+
+    ASSERT_EQ('a', head[0]);
+    ASSERT_EQ('a', head[2 * 1024 - 1]);
+    ASSERT_EQ('a', body[2 * 1024 - 1]);
+    ASSERT_EQ('b', body[2 * 1024]);
+    ASSERT_EQ('e', body[2 * 1024 + chunk_size - 1]);
+    ASSERT_EQ('f', body[2 * 1024 + chunk_size]);
+    ASSERT_EQ('f', body.back());
+}
+
 TEST_F(IOTrackerSplitorTest, StartRead) {
     MockRequestScheduler* mockschuler = new MockRequestScheduler;
     mockschuler->DelegateToFake();
@@ -165,6 +165,55 @@ TEST_F(CurveClientTest, AioReadWriteTest) {
     ASSERT_EQ(0, client_.Close(fd));
 }
 
+TEST_F(CurveClientTest, AioFlushTest) {
+    CurveAioContext aioctx;
+    aioctx.op = LIBCURVE_OP_FLUSH;
+    aioctx.cb = LibcbdLibcurveTestCallback;
+    ASSERT_EQ(-LIBCURVE_ERROR::BAD_FD, client_.AioFlush(12345, &aioctx));
+
+    int fd = client_.Open(kFileName, nullptr);
+    ASSERT_NE(-1, fd);
+
+    // 未开启写缓存，flush直接返回
+    ASSERT_EQ(0, client_.AioFlush(fd, &aioctx));
+    while (aioctx.op != LIBCURVE_OP_MAX) {
+        usleep(10 * 1000);
+    }
+    ASSERT_EQ(0, aioctx.ret);
+
+    ASSERT_EQ(0, client_.Close(fd));
+}
+
+TEST_F(CurveClientTest, AioDiscardTest) {
+    CurveAioContext aioctx;
+    aioctx.offset = 0;
+    aioctx.length = 4096;
+    aioctx.op = LIBCURVE_OP_DISCARD;
+    aioctx.cb = LibcbdLibcurveTestCallback;
+    ASSERT_EQ(-LIBCURVE_ERROR::BAD_FD, client_.AioDiscard(12345, &aioctx));
+
+    int fd = client_.Open(kFileName, nullptr);
+    ASSERT_NE(-1, fd);
+
+    // 未开启discard，直接返回成功
+    ASSERT_EQ(0, client_.AioDiscard(fd, &aioctx));
+    while (aioctx.op != LIBCURVE_OP_MAX) {
+        usleep(10 * 1000);
+    }
+    ASSERT_EQ(4096, aioctx.ret);
+
+    ASSERT_EQ(0, client_.Close(fd));
+}
+
+TEST_F(CurveClientTest, InvalidCacheTest) {
+    ASSERT_EQ(-LIBCURVE_ERROR::BAD_FD, client_.InvalidCache(12345));
+
+    int fd = client_.Open(kFileName, nullptr);
+    ASSERT_NE(-1, fd);
+    ASSERT_EQ(LIBCURVE_ERROR::OK, client_.InvalidCache(fd));
+    ASSERT_EQ(0, client_.Close(fd));
+}
+
 }  // namespace client
 }  // namespace curve
 
@@ -0,0 +1,179 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>   // NOLINT
+#include <vector>
+
+#include "src/client/metacache_struct.h"
+
+namespace curve {
+namespace client {
+
+TEST(MetaCacheStructTest, CalcLogicPoolCopysetIDTest) {
+    ASSERT_EQ(0x0000000100000002ull, CalcLogicPoolCopysetID(1, 2));
+    ASSERT_NE(CalcLogicPoolCopysetID(1, 2), CalcLogicPoolCopysetID(2, 1));
+    ASSERT_EQ(0xffffffffffffffffull,
+              CalcLogicPoolCopysetID(0xffffffff, 0xffffffff));
+}
+
+TEST(MetaCacheStructTest, ChunkIndexInfoTableTest) {
+    ChunkIndexInfoTable table;
+    ChunkIDInfo info;
+    ASSERT_FALSE(table.Get(0, &info));
+    ASSERT_FALSE(table.Get(100000, &info));
+
+    // 跨越多个block，触发目录扩容
+    for (ChunkIndex idx = 0; idx < 100000; idx += 7) {
+        table.Set(idx, ChunkIDInfo(idx + 1, 1, idx % 100 + 1));
+    }
+
+    for (ChunkIndex idx = 0; idx < 100000; ++idx) {
+        bool exist = table.Get(idx, &info);
+        ASSERT_EQ(idx % 7 == 0, exist);
+        if (exist) {
+            ASSERT_EQ(idx + 1, info.cid_);
+            ASSERT_EQ(1, info.lpid_);
+            ASSERT_EQ(idx % 100 + 1, info.cpid_);
+        }
+    }
+
+    // 覆盖写
+    table.Set(7, ChunkIDInfo(1234, 2, 3));
+    ASSERT_TRUE(table.Get(7, &info));
+    ASSERT_EQ(1234, info.cid_);
+    ASSERT_EQ(2, info.lpid_);
+    ASSERT_EQ(3, info.cpid_);
+
+    // 删除后不存在，不影响其他槽位，可以重新写入
+    table.Erase(7);
+    table.Erase(8);
+    table.Erase(10000000);
+    ASSERT_FALSE(table.Get(7, &info));
+    ASSERT_TRUE(table.Get(14, &info));
+    table.Set(7, ChunkIDInfo(4321, 2, 3));
+    ASSERT_TRUE(table.Get(7, &info));
+    ASSERT_EQ(4321, info.cid_);
+}
+
+TEST(MetaCacheStructTest, ChunkIndexInfoTableConcurrentTest) {
+    ChunkIndexInfoTable table;
+    std::atomic<bool> stop(false);
+    const ChunkIndex maxIdx = 64 * 1024;
+
+    // 读者读到的数据要么不存在，要么是一个完整的写入
+    auto reader = [&]() {
+        ChunkIDInfo info;
+        while (!stop.load()) {
+            for (ChunkIndex idx = 0; idx < maxIdx; idx += 97) {
+                if (table.Get(idx, &info)) {
+                    ASSERT_EQ(info.cid_, info.lpid_ + info.cpid_);
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back(reader);
+    }
+
+    for (int round = 1; round <= 4; ++round) {
+        for (ChunkIndex idx = 0; idx < maxIdx; ++idx) {
+            table.Set(idx, ChunkIDInfo(idx + round, idx, round));
+        }
+    }
+
+    stop.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+}
+
+TEST(MetaCacheStructTest, CopysetInfoTableTest) {
+    CopysetInfoTable table;
+    ASSERT_EQ(nullptr, table.Find(CalcLogicPoolCopysetID(1, 1)));
+
+    bool inserted = false;
+    for (CopysetID cpid = 1; cpid <= 10000; ++cpid) {
+        CopysetInfo info;
+        info.cpid_ = cpid;
+        CopysetInfo* ptr = table.FindOrInsert(
+            CalcLogicPoolCopysetID(1, cpid), info, &inserted);
+        ASSERT_TRUE(inserted);
+        ASSERT_EQ(cpid, ptr->cpid_);
+    }
+
+    for (CopysetID cpid = 1; cpid <= 10000; ++cpid) {
+        CopysetInfo* ptr = table.Find(CalcLogicPoolCopysetID(1, cpid));
+        ASSERT_NE(nullptr, ptr);
+        ASSERT_EQ(cpid, ptr->cpid_);
+        ASSERT_EQ(nullptr, table.Find(CalcLogicPoolCopysetID(2, cpid)));
+    }
+
+    // 已存在的key不会重复插入，返回的指针不变
+    CopysetInfo* exist = table.Find(CalcLogicPoolCopysetID(1, 100));
+    CopysetInfo info;
+    ASSERT_EQ(exist, table.FindOrInsert(CalcLogicPoolCopysetID(1, 100),
+                                        info, &inserted));
+    ASSERT_FALSE(inserted);
+}
+
+TEST(MetaCacheStructTest, CopysetInfoTableConcurrentTest) {
+    CopysetInfoTable table;
+    std::atomic<bool> stop(false);
+    const CopysetID maxCopysetId = 20000;
+
+    // 扩容过程中，已插入的copyset一直可以被找到
+    std::atomic<CopysetID> inserted(0);
+    auto reader = [&]() {
+        while (!stop.load()) {
+            CopysetID max = inserted.load();
+            for (CopysetID cpid = 1; cpid <= max; cpid += 13) {
+                CopysetInfo* ptr = table.Find(CalcLogicPoolCopysetID(1, cpid));
+                ASSERT_NE(nullptr, ptr);
+                ASSERT_EQ(cpid, ptr->cpid_);
+            }
+        }
+    };
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back(reader);
+    }
+
+    bool isNew = false;
+    for (CopysetID cpid = 1; cpid <= maxCopysetId; ++cpid) {
+        CopysetInfo info;
+        info.cpid_ = cpid;
+        table.FindOrInsert(CalcLogicPoolCopysetID(1, cpid), info, &isNew);
+        inserted.store(cpid);
+    }
+
+    stop.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+}
+
+}   // namespace client
+}   // namespace curve
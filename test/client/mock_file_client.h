@@ -43,6 +43,9 @@ class MockFileClient : public FileClient {
     MOCK_METHOD4(Write, int(int, const char*, off_t, size_t));
     MOCK_METHOD2(AioRead, int(int, CurveAioContext*));
     MOCK_METHOD2(AioWrite, int(int, CurveAioContext*));
+    MOCK_METHOD2(AioFlush, int(int, CurveAioContext*));
+    MOCK_METHOD2(AioDiscard, int(int, CurveAioContext*));
+    MOCK_METHOD1(InvalidCache, int(int));
     MOCK_METHOD3(StatFile, int(const std::string&,
                                const UserInfo_t&,
                                FileStatInfo*));
@@ -0,0 +1,290 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/client/read_ahead.h"
+
+namespace curve {
+namespace client {
+
+const uint64_t kKB = 1024;
+const uint64_t kFileLength = 64 * 1024 * 1024;
+
+class ReadAheadTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        opt_.enable = true;
+        opt_.minWindowKB = 128;
+        opt_.maxWindowKB = 512;
+        opt_.maxBufferMB = 1;
+        metric_.reset(new FileMetric("read_ahead_test"));
+        // 文件中每个字节的内容由offset决定
+        data_.resize(32 * 1024 * 1024);
+        for (uint64_t i = 0; i < data_.size(); ++i) {
+            data_[i] = static_cast<char>(i / 4096);
+        }
+        async_ = false;
+        fail_ = false;
+    }
+
+    void TearDown() override {
+        CompletePending();
+    }
+
+    void InitReadAhead() {
+        readAhead_.Init(opt_, metric_.get(), [this](CurveAioContext* ctx) {
+            issued_.push_back({ctx->offset, ctx->length});
+            if (async_) {
+                pending_.push_back(ctx);
+                return;
+            }
+            Complete(ctx);
+        });
+    }
+
+    void Complete(CurveAioContext* ctx) {
+        if (fail_) {
+            ctx->ret = -1;
+        } else {
+            memcpy(ctx->buf, &data_[ctx->offset], ctx->length);
+            ctx->ret = ctx->length;
+        }
+        ctx->cb(ctx);
+    }
+
+    void CompletePending() {
+        for (auto ctx : pending_) {
+            Complete(ctx);
+        }
+        pending_.clear();
+    }
+
+    // 模拟用户读请求，先检测顺序读再读预读数据
+    bool UserRead(uint64_t offset, uint64_t length) {
+        readAhead_.Observe(offset, length, kFileLength);
+        std::string buf(length, 0);
+        if (readAhead_.Read(offset, length, &buf[0], nullptr) !=
+            ReadAhead::ReadStatus::HIT) {
+            return false;
+        }
+        EXPECT_EQ(data_.substr(offset, length), buf);
+        return true;
+    }
+
+    ReadAheadOption_t opt_;
+    std::unique_ptr<FileMetric> metric_;
+    ReadAhead readAhead_;
+    std::string data_;
+    std::vector<std::pair<off_t, size_t>> issued_;
+    std::vector<CurveAioContext*> pending_;
+    bool async_;
+    bool fail_;
+};
+
+TEST_F(ReadAheadTest, DisableTest) {
+    ReadAhead readAhead;
+    ReadAheadOption_t opt;
+    readAhead.Init(opt, nullptr, nullptr);
+    ASSERT_FALSE(readAhead.Enabled());
+
+    // 最小窗口大于最大窗口时不开启
+    opt.enable = true;
+    opt.minWindowKB = 1024;
+    opt.maxWindowKB = 512;
+    readAhead.Init(opt, nullptr, nullptr);
+    ASSERT_FALSE(readAhead.Enabled());
+
+    readAhead.Observe(0, 4096, kFileLength);
+    std::string buf(4096, 0);
+    ASSERT_EQ(ReadAhead::ReadStatus::MISS,
+              readAhead.Read(0, 4096, &buf[0], nullptr));
+}
+
+TEST_F(ReadAheadTest, SequentialTest) {
+    InitReadAhead();
+    ASSERT_TRUE(readAhead_.Enabled());
+
+    // 连续顺序读kTriggerCount次后才开始预读
+    ASSERT_FALSE(UserRead(0, 64 * kKB));
+    ASSERT_FALSE(UserRead(64 * kKB, 64 * kKB));
+    ASSERT_TRUE(issued_.empty());
+    ASSERT_FALSE(UserRead(128 * kKB, 64 * kKB));
+    ASSERT_EQ(1, issued_.size());
+    ASSERT_EQ(192 * kKB, issued_[0].first);
+    ASSERT_EQ(128 * kKB, issued_[0].second);
+
+    // 后续读命中预读数据，剩余不足半个窗口时按翻倍后的窗口继续预读
+    ASSERT_TRUE(UserRead(192 * kKB, 64 * kKB));
+    ASSERT_EQ(2, issued_.size());
+    ASSERT_EQ(320 * kKB, issued_[1].first);
+    ASSERT_EQ(192 * kKB, issued_[1].second);
+
+    for (uint64_t offset = 256 * kKB; offset < 2048 * kKB;
+         offset += 64 * kKB) {
+        ASSERT_TRUE(UserRead(offset, 64 * kKB));
+    }
+
+    // 窗口不超过上限
+    for (const auto& req : issued_) {
+        ASSERT_LE(req.second, opt_.maxWindowKB * kKB);
+    }
+    ASSERT_LE(readAhead_.GetBufferBytes(), opt_.maxBufferMB * 1024 * kKB);
+    ASSERT_EQ(29, metric_->readAhead.hit.count.get_value());
+}
+
+TEST_F(ReadAheadTest, RandomTest) {
+    InitReadAhead();
+
+    // 随机读不会触发预读
+    for (uint64_t offset : {10, 3, 70, 22, 45, 8, 91, 60}) {
+        ASSERT_FALSE(UserRead(offset * 64 * kKB, 64 * kKB));
+    }
+    ASSERT_TRUE(issued_.empty());
+    ASSERT_EQ(0, readAhead_.GetBufferBytes());
+}
+
+TEST_F(ReadAheadTest, MultiStreamTest) {
+    InitReadAhead();
+
+    // 交错的两个顺序读流都能被识别
+    uint64_t base = 8 * 1024 * kKB;
+    for (uint64_t i = 0; i < 3; ++i) {
+        UserRead(i * 64 * kKB, 64 * kKB);
+        UserRead(base + i * 64 * kKB, 64 * kKB);
+    }
+    ASSERT_EQ(2, issued_.size());
+    ASSERT_EQ(192 * kKB, issued_[0].first);
+    ASSERT_EQ(base + 192 * kKB, issued_[1].first);
+
+    ASSERT_TRUE(UserRead(192 * kKB, 64 * kKB));
+    ASSERT_TRUE(UserRead(base + 192 * kKB, 64 * kKB));
+}
+
+TEST_F(ReadAheadTest, InvalidateTest) {
+    InitReadAhead();
+    for (uint64_t i = 0; i < 3; ++i) {
+        UserRead(i * 64 * kKB, 64 * kKB);
+    }
+    ASSERT_EQ(128 * kKB, readAhead_.GetBufferBytes());
+
+    // 写请求失效覆盖到的预读数据
+    readAhead_.Invalidate(200 * kKB, 4 * kKB);
+    ASSERT_EQ(0, readAhead_.GetBufferBytes());
+    std::string buf(64 * kKB, 0);
+    ASSERT_EQ(ReadAhead::ReadStatus::MISS,
+              readAhead_.Read(192 * kKB, 64 * kKB, &buf[0], nullptr));
+
+    // 正在预读的数据被失效后，返回的数据直接丢弃
+    async_ = true;
+    readAhead_.Drop();
+    issued_.clear();
+    for (uint64_t i = 0; i < 3; ++i) {
+        UserRead(i * 64 * kKB, 64 * kKB);
+    }
+    ASSERT_EQ(1, pending_.size());
+    readAhead_.Invalidate(192 * kKB, 4 * kKB);
+    CompletePending();
+    ASSERT_EQ(0, readAhead_.GetBufferBytes());
+    ASSERT_EQ(ReadAhead::ReadStatus::MISS,
+              readAhead_.Read(192 * kKB, 64 * kKB, &buf[0], nullptr));
+}
+
+TEST_F(ReadAheadTest, WaitInflightTest) {
+    InitReadAhead();
+    async_ = true;
+    for (uint64_t i = 0; i < 3; ++i) {
+        UserRead(i * 64 * kKB, 64 * kKB);
+    }
+    ASSERT_EQ(1, pending_.size());
+
+    // 预读还未返回时读请求不阻塞，预读返回后由回调完成
+    int doneCount = 0;
+    bool hit = false;
+    auto done = [&](bool h) {
+        ++doneCount;
+        hit = h;
+    };
+    std::string buf(64 * kKB, 0);
+    ASSERT_EQ(ReadAhead::ReadStatus::PENDING,
+              readAhead_.Read(192 * kKB, 64 * kKB, &buf[0], done));
+    ASSERT_EQ(0, doneCount);
+    CompletePending();
+    ASSERT_EQ(1, doneCount);
+    ASSERT_TRUE(hit);
+    ASSERT_EQ(data_.substr(192 * kKB, 64 * kKB), buf);
+
+    // 预读失败时读请求未命中
+    fail_ = true;
+    UserRead(192 * kKB, 64 * kKB);
+    ASSERT_EQ(1, pending_.size());
+    ASSERT_EQ(ReadAhead::ReadStatus::PENDING,
+              readAhead_.Read(320 * kKB, 64 * kKB, &buf[0], done));
+    CompletePending();
+    ASSERT_EQ(2, doneCount);
+    ASSERT_FALSE(hit);
+    ASSERT_EQ(128 * kKB, readAhead_.GetBufferBytes());
+
+    // 等待的预读数据被写请求失效时读请求未命中
+    fail_ = false;
+    readAhead_.Drop();
+    for (uint64_t i = 0; i < 3; ++i) {
+        UserRead(i * 64 * kKB, 64 * kKB);
+    }
+    ASSERT_EQ(1, pending_.size());
+    ASSERT_EQ(ReadAhead::ReadStatus::PENDING,
+              readAhead_.Read(192 * kKB, 64 * kKB, &buf[0], done));
+    readAhead_.Invalidate(200 * kKB, 4 * kKB);
+    ASSERT_EQ(3, doneCount);
+    ASSERT_FALSE(hit);
+    CompletePending();
+    ASSERT_EQ(3, doneCount);
+}
+
+TEST_F(ReadAheadTest, EvictTest) {
+    InitReadAhead();
+
+    // 每个读流预读一个最小窗口后不再读取，1MB缓冲区最多容纳8个
+    for (uint64_t stream = 0; stream < 9; ++stream) {
+        uint64_t base = stream * 1024 * kKB;
+        for (uint64_t i = 0; i < 3; ++i) {
+            UserRead(base + i * 64 * kKB, 64 * kKB);
+        }
+    }
+    ASSERT_EQ(9, issued_.size());
+    ASSERT_EQ(opt_.maxBufferMB * 1024 * kKB, readAhead_.GetBufferBytes());
+    ASSERT_EQ(1, metric_->readAhead.evictCount.get_value());
+
+    // 淘汰的是最早预读的数据
+    std::string buf(64 * kKB, 0);
+    ASSERT_EQ(ReadAhead::ReadStatus::MISS,
+              readAhead_.Read(192 * kKB, 64 * kKB, &buf[0], nullptr));
+    ASSERT_EQ(ReadAhead::ReadStatus::HIT,
+              readAhead_.Read(1024 * kKB + 192 * kKB, 64 * kKB, &buf[0],
+                              nullptr));
+}
+
+}   // namespace client
+}   // namespace curve
@@ -0,0 +1,153 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "src/client/read_cache.h"
+
+namespace curve {
+namespace client {
+
+const uint32_t kPageSize = 4096;
+
+class ReadCacheTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        ReadCacheOption_t opt;
+        opt.enable = true;
+        opt.capacityMB = 1;
+        opt.pageSizeKB = kPageSize / 1024;
+        metric_.reset(new FileMetric("read_cache_test"));
+        cache_.Init(opt, metric_.get());
+    }
+
+    std::unique_ptr<FileMetric> metric_;
+    ReadCache cache_;
+};
+
+TEST_F(ReadCacheTest, DisableTest) {
+    ReadCache cache;
+    ReadCacheOption_t opt;
+    cache.Init(opt, nullptr);
+    ASSERT_FALSE(cache.Enabled());
+
+    // 容量小于一个page时不开启
+    opt.enable = true;
+    opt.capacityMB = 0;
+    cache.Init(opt, nullptr);
+    ASSERT_FALSE(cache.Enabled());
+
+    std::string data(kPageSize, 'a');
+    cache.Put(0, kPageSize, data.data(), cache.GetSequence());
+    ASSERT_EQ(0, cache.GetCachedPageNum());
+}
+
+TEST_F(ReadCacheTest, ReadPutTest) {
+    ASSERT_TRUE(cache_.Enabled());
+
+    std::string buf(4 * kPageSize, '\0');
+    ASSERT_FALSE(cache_.Read(0, kPageSize, &buf[0]));
+    ASSERT_EQ(1, metric_->readCache.miss.count.get_value());
+
+    // 只缓存被完整覆盖的page
+    std::string data(4 * kPageSize, 'a');
+    cache_.Put(kPageSize / 2, 2 * kPageSize, data.data(),
+               cache_.GetSequence());
+    ASSERT_EQ(1, cache_.GetCachedPageNum());
+    ASSERT_FALSE(cache_.Read(0, kPageSize, &buf[0]));
+    ASSERT_TRUE(cache_.Read(kPageSize, kPageSize, &buf[0]));
+    ASSERT_EQ(std::string(kPageSize, 'a'), buf.substr(0, kPageSize));
+
+    // 跨page读，全部命中才返回
+    for (int i = 0; i < 4; ++i) {
+        data.replace(i * kPageSize, kPageSize, kPageSize, 'a' + i);
+    }
+    cache_.Put(0, 4 * kPageSize, data.data(), cache_.GetSequence());
+    ASSERT_EQ(4, cache_.GetCachedPageNum());
+    ASSERT_TRUE(cache_.Read(kPageSize / 2, 3 * kPageSize, &buf[0]));
+    ASSERT_EQ(data.substr(kPageSize / 2, 3 * kPageSize),
+              buf.substr(0, 3 * kPageSize));
+    ASSERT_FALSE(cache_.Read(3 * kPageSize, 2 * kPageSize, &buf[0]));
+
+    ASSERT_EQ(2, metric_->readCache.hit.count.get_value());
+    ASSERT_EQ(3, metric_->readCache.miss.count.get_value());
+    ASSERT_EQ(4 * kPageSize, metric_->readCache.cachedBytes.get_value());
+}
+
+TEST_F(ReadCacheTest, InvalidateTest) {
+    std::string data(8 * kPageSize, 'a');
+    std::string buf(8 * kPageSize, '\0');
+    cache_.Put(0, 8 * kPageSize, data.data(), cache_.GetSequence());
+    ASSERT_EQ(8, cache_.GetCachedPageNum());
+
+    // 失效部分覆盖到的page也要被删除
+    cache_.Invalidate(kPageSize + 512, 512);
+    ASSERT_EQ(7, cache_.GetCachedPageNum());
+    ASSERT_FALSE(cache_.Read(kPageSize, kPageSize, &buf[0]));
+    ASSERT_TRUE(cache_.Read(0, kPageSize, &buf[0]));
+
+    // 失效范围远大于缓存
+    cache_.Invalidate(4 * kPageSize, 1ull << 40);
+    ASSERT_EQ(3, cache_.GetCachedPageNum());
+    ASSERT_TRUE(cache_.Read(2 * kPageSize, 2 * kPageSize, &buf[0]));
+    ASSERT_FALSE(cache_.Read(4 * kPageSize, kPageSize, &buf[0]));
+
+    // 读请求发起后发生过失效，返回的数据不能填充缓存
+    uint64_t seq = cache_.GetSequence();
+    cache_.Invalidate(6 * kPageSize, kPageSize);
+    cache_.Put(4 * kPageSize, 4 * kPageSize, data.data(), seq);
+    ASSERT_EQ(3, cache_.GetCachedPageNum());
+
+    cache_.Drop();
+    ASSERT_EQ(0, cache_.GetCachedPageNum());
+    ASSERT_EQ(0, metric_->readCache.cachedBytes.get_value());
+}
+
+TEST_F(ReadCacheTest, EvictTest) {
+    // 1MB容量，4KB page，最多缓存256个page
+    const uint64_t maxPageNum = 256;
+    std::string data(kPageSize, 'a');
+    std::string buf(kPageSize, '\0');
+
+    for (uint64_t i = 0; i < maxPageNum; ++i) {
+        cache_.Put(i * kPageSize, kPageSize, data.data(),
+                   cache_.GetSequence());
+    }
+    ASSERT_EQ(maxPageNum, cache_.GetCachedPageNum());
+
+    // 访问第0个page，使其变为最近访问
+    ASSERT_TRUE(cache_.Read(0, kPageSize, &buf[0]));
+
+    cache_.Put(maxPageNum * kPageSize, kPageSize, data.data(),
+               cache_.GetSequence());
+    ASSERT_EQ(maxPageNum, cache_.GetCachedPageNum());
+    ASSERT_EQ(1, metric_->readCache.evictCount.get_value());
+
+    // 淘汰的是最久未访问的第1个page
+    ASSERT_TRUE(cache_.Read(0, kPageSize, &buf[0]));
+    ASSERT_FALSE(cache_.Read(kPageSize, kPageSize, &buf[0]));
+    ASSERT_TRUE(cache_.Read(maxPageNum * kPageSize, kPageSize, &buf[0]));
+}
+
+}   // namespace client
+}   // namespace curve
@@ -0,0 +1,204 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>   // NOLINT
+#include <memory>
+#include <string>
+#include <thread>   // NOLINT
+
+#include "src/client/request_priority_queue.h"
+
+namespace curve {
+namespace client {
+
+namespace {
+// 只用指针值区分请求，不访问请求内容
+RequestContext* FakeRequest(uintptr_t id) {
+    return reinterpret_cast<RequestContext*>(id);
+}
+
+uintptr_t TakeID(RequestPriorityQueue* queue,
+                 RequestPriority* priority = nullptr) {
+    RequestPriority p;
+    RequestPriorityQueue::Item item = queue->TakeFront(&p);
+    if (priority != nullptr) {
+        *priority = p;
+    }
+    return reinterpret_cast<uintptr_t>(item.Item());
+}
+}   // namespace
+
+class RequestPriorityQueueTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        metric_.reset(new FileMetric("priority_queue_test"));
+        opt_.scheduleQueueCapacity = 16;
+        opt_.enablePriority = true;
+        opt_.foregroundWeight = 3;
+        opt_.retryWeight = 2;
+        opt_.backgroundWeight = 1;
+    }
+
+    void Put(RequestPriorityQueue* queue, uintptr_t id,
+             RequestPriority priority) {
+        queue->PutBack(RequestPriorityQueue::Item(FakeRequest(id)), priority);
+    }
+
+    std::unique_ptr<FileMetric> metric_;
+    RequestScheduleOption_t opt_;
+};
+
+TEST_F(RequestPriorityQueueTest, DisableTest) {
+    opt_.enablePriority = false;
+    RequestPriorityQueue queue;
+    ASSERT_EQ(0, queue.Init(opt_, metric_.get()));
+
+    // 未开启优先级时先进先出，重新入队的请求放在头部
+    Put(&queue, 1, RequestPriority::BACKGROUND);
+    Put(&queue, 2, RequestPriority::FOREGROUND);
+    queue.PutFront(RequestPriorityQueue::Item(FakeRequest(3)),
+                   RequestPriority::RETRY);
+    ASSERT_EQ(3, queue.Size(RequestPriority::FOREGROUND));
+    ASSERT_EQ(3, metric_->scheduleQueue.foregroundDepth.get_value());
+
+    RequestPriority priority;
+    ASSERT_EQ(3, TakeID(&queue, &priority));
+    ASSERT_EQ(RequestPriority::FOREGROUND, priority);
+    ASSERT_EQ(1, TakeID(&queue));
+    ASSERT_EQ(2, TakeID(&queue));
+    ASSERT_TRUE(queue.Empty());
+    ASSERT_EQ(0, metric_->scheduleQueue.foregroundDepth.get_value());
+
+    // 容量为0时初始化失败
+    opt_.scheduleQueueCapacity = 0;
+    RequestPriorityQueue invalid;
+    ASSERT_EQ(-1, invalid.Init(opt_, nullptr));
+}
+
+TEST_F(RequestPriorityQueueTest, WeightTest) {
+    RequestPriorityQueue queue;
+    ASSERT_EQ(0, queue.Init(opt_, metric_.get()));
+
+    for (uintptr_t i = 0; i < 6; ++i) {
+        Put(&queue, 100 + i, RequestPriority::FOREGROUND);
+        Put(&queue, 200 + i, RequestPriority::RETRY);
+        Put(&queue, 300 + i, RequestPriority::BACKGROUND);
+    }
+    ASSERT_EQ(18, queue.Size());
+    ASSERT_EQ(6, metric_->scheduleQueue.retryDepth.get_value());
+    ASSERT_EQ(6, metric_->scheduleQueue.backgroundDepth.get_value());
+
+    // 每一轮按3:2:1的比例出队，同一个队列内先进先出
+    uintptr_t expected[] = {100, 101, 102, 200, 201, 300,
+                            103, 104, 105, 202, 203, 301};
+    for (uintptr_t id : expected) {
+        ASSERT_EQ(id, TakeID(&queue));
+    }
+
+    // 用户读写取完后剩下的队列按各自的权重轮流出队
+    uintptr_t rest[] = {204, 205, 302, 303, 304, 305};
+    for (uintptr_t id : rest) {
+        ASSERT_EQ(id, TakeID(&queue));
+    }
+    ASSERT_TRUE(queue.Empty());
+    ASSERT_EQ(0, metric_->scheduleQueue.retryDepth.get_value());
+    ASSERT_EQ(0, metric_->scheduleQueue.backgroundDepth.get_value());
+}
+
+TEST_F(RequestPriorityQueueTest, TakeFrontIfTest) {
+    RequestPriorityQueue queue;
+    ASSERT_EQ(0, queue.Init(opt_, metric_.get()));
+
+    Put(&queue, 1, RequestPriority::FOREGROUND);
+    Put(&queue, 2, RequestPriority::BACKGROUND);
+
+    // 只从指定的队列中取
+    auto any = [](const RequestPriorityQueue::Item&) { return true; };
+    RequestPriorityQueue::Item item(nullptr);
+    ASSERT_FALSE(queue.TakeFrontIf(RequestPriority::RETRY, any, &item));
+    ASSERT_FALSE(queue.TakeFrontIf(RequestPriority::BACKGROUND,
+        [](const RequestPriorityQueue::Item&) { return false; }, &item));
+    ASSERT_TRUE(queue.TakeFrontIf(RequestPriority::BACKGROUND, any, &item));
+    ASSERT_EQ(FakeRequest(2), item.Item());
+    ASSERT_EQ(1, queue.Size());
+    ASSERT_EQ(0, metric_->scheduleQueue.backgroundDepth.get_value());
+}
+
+TEST_F(RequestPriorityQueueTest, StopTest) {
+    RequestPriorityQueue queue;
+    ASSERT_EQ(0, queue.Init(opt_, metric_.get()));
+
+    // stop item在所有请求之后出队，且不占用队列深度
+    Put(&queue, 1, RequestPriority::BACKGROUND);
+    queue.PutBack(RequestPriorityQueue::Item(nullptr, true),
+                  RequestPriority::FOREGROUND);
+    Put(&queue, 2, RequestPriority::FOREGROUND);
+    ASSERT_EQ(2, queue.Size());
+
+    ASSERT_EQ(2, TakeID(&queue));
+    ASSERT_EQ(1, TakeID(&queue));
+    ASSERT_FALSE(queue.Empty());
+    RequestPriority priority;
+    ASSERT_TRUE(queue.TakeFront(&priority).IsStop());
+    ASSERT_TRUE(queue.Empty());
+}
+
+TEST_F(RequestPriorityQueueTest, BlockTest) {
+    opt_.scheduleQueueCapacity = 2;
+    RequestPriorityQueue queue;
+    ASSERT_EQ(0, queue.Init(opt_, metric_.get()));
+
+    // 一个队列满了不影响其他队列入队
+    Put(&queue, 1, RequestPriority::BACKGROUND);
+    Put(&queue, 2, RequestPriority::BACKGROUND);
+    Put(&queue, 3, RequestPriority::FOREGROUND);
+
+    std::atomic<bool> put(false);
+    std::thread th([&]() {
+        Put(&queue, 4, RequestPriority::BACKGROUND);
+        put.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(put.load());
+
+    ASSERT_EQ(3, TakeID(&queue));
+    ASSERT_EQ(1, TakeID(&queue));
+    th.join();
+    ASSERT_TRUE(put.load());
+
+    // 队列为空时出队阻塞，直到有请求入队
+    ASSERT_EQ(2, TakeID(&queue));
+    ASSERT_EQ(4, TakeID(&queue));
+    std::atomic<uintptr_t> taken(0);
+    std::thread consumer([&]() {
+        taken.store(TakeID(&queue));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_EQ(0, taken.load());
+    Put(&queue, 5, RequestPriority::RETRY);
+    consumer.join();
+    ASSERT_EQ(5, taken.load());
+}
+
+}   // namespace client
+}   // namespace curve
@@ -22,7 +22,11 @@
 
 #include <gtest/gtest.h>
 
+#include <thread>   // NOLINT
+#include <vector>
+
 #include "src/client/request_sender_manager.h"
+#include "src/client/request_sender.h"
 #include "src/client/client_common.h"
 
 namespace curve {
@@ -66,5 +70,55 @@ TEST(RequestSenderManagerTest, fail_test) {
         leaderId, leaderAddr, ioSenderOpt));
 }
 
+TEST(RequestSenderManagerTest, multi_channel_test) {
+    IOSenderOption_t ioSenderOpt;
+    ioSenderOpt.failRequestOpt.chunkserverOPMaxRetry = 3;
+    ioSenderOpt.failRequestOpt.chunkserverOPRetryIntervalUS = 500;
+    ioSenderOpt.chunkserverEnableAppliedIndexRead = 1;
+    ioSenderOpt.channelOpt.channelNum = 4;
+    ioSenderOpt.channelOpt.connectionType = "pooled";
+
+    std::unique_ptr<RequestSenderManager> senderManager(
+        new RequestSenderManager());
+    butil::EndPoint leaderAddr;
+    butil::str2endpoint("127.0.0.1:9109", &leaderAddr);
+
+    // 多个线程并发获取，同一个chunkserver只创建一个sender
+    const int kThreadNum = 8;
+    const ChunkServerID kChunkServerNum = 16;
+    std::vector<RequestSenderManager::SenderPtr> senders[kThreadNum];
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreadNum; ++i) {
+        threads.emplace_back([&, i]() {
+            for (ChunkServerID id = 1; id <= kChunkServerNum; ++id) {
+                senders[i].push_back(senderManager->GetOrCreateSender(
+                    id, leaderAddr, ioSenderOpt));
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (int i = 0; i < kThreadNum; ++i) {
+        ASSERT_EQ(kChunkServerNum, senders[i].size());
+        for (ChunkServerID id = 0; id < kChunkServerNum; ++id) {
+            ASSERT_NE(nullptr, senders[i][id]);
+            ASSERT_EQ(senders[0][id], senders[i][id]);
+            ASSERT_EQ(4, senders[i][id]->GetChannelNum());
+        }
+    }
+
+    // channel数为0时至少建立一个channel
+    ioSenderOpt.channelOpt.channelNum = 0;
+    auto senderPtr = senderManager->GetOrCreateSender(
+        kChunkServerNum + 1, leaderAddr, ioSenderOpt);
+    ASSERT_NE(nullptr, senderPtr);
+    ASSERT_EQ(1, senderPtr->GetChannelNum());
+
+    // 不存在的chunkserver不需要重置
+    senderManager->ResetSenderIfNotHealth(kChunkServerNum + 2);
+}
+
 }   // namespace client
 }   // namespace curve
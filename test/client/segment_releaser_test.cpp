@@ -0,0 +1,160 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>   // NOLINT
+#include <condition_variable>   // NOLINT
+#include <functional>
+#include <mutex>    // NOLINT
+#include <thread>   // NOLINT
+#include <vector>
+
+#include "src/client/segment_releaser.h"
+
+namespace curve {
+namespace client {
+
+const uint64_t kSegmentSize = 1024 * 1024 * 1024;
+
+class SegmentReleaserTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        // 默认在调用线程中直接执行释放任务
+        releaser_.Init(
+            [this](uint64_t segoff) {
+                std::lock_guard<std::mutex> lk(mtx_);
+                released_.push_back(segoff);
+            },
+            [](const std::function<void()>& task) {
+                task();
+            });
+    }
+
+    std::vector<uint64_t> Released() {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return released_;
+    }
+
+    SegmentReleaser releaser_;
+    std::mutex mtx_;
+    std::vector<uint64_t> released_;
+};
+
+TEST_F(SegmentReleaserTest, ReleaseTest) {
+    // 只释放被discard完全覆盖的segment
+    releaser_.BeginDiscard(kSegmentSize / 2, 3 * kSegmentSize, kSegmentSize);
+    ASSERT_EQ(2, releaser_.GetSegmentNum());
+    releaser_.EndDiscard(kSegmentSize / 2, 3 * kSegmentSize, kSegmentSize,
+                         true);
+    ASSERT_EQ(std::vector<uint64_t>({kSegmentSize, 2 * kSegmentSize}),
+              Released());
+    ASSERT_EQ(0, releaser_.GetSegmentNum());
+
+    // discard失败时只取消登记
+    releaser_.BeginDiscard(0, kSegmentSize, kSegmentSize);
+    releaser_.EndDiscard(0, kSegmentSize, kSegmentSize, false);
+    ASSERT_EQ(2, Released().size());
+    ASSERT_EQ(0, releaser_.GetSegmentNum());
+}
+
+TEST_F(SegmentReleaserTest, WriteDuringDiscardTest) {
+    // discard期间写过的segment不释放
+    releaser_.BeginDiscard(0, 2 * kSegmentSize, kSegmentSize);
+    ASSERT_TRUE(releaser_.BeginWrite(4096, 4096, kSegmentSize, nullptr));
+    releaser_.EndWrite(4096, 4096, kSegmentSize);
+    releaser_.EndDiscard(0, 2 * kSegmentSize, kSegmentSize, true);
+    ASSERT_EQ(std::vector<uint64_t>({kSegmentSize}), Released());
+    ASSERT_EQ(0, releaser_.GetSegmentNum());
+
+    // discard开始时还未返回的写请求同样阻止释放
+    ASSERT_TRUE(releaser_.BeginWrite(4096, 4096, kSegmentSize, nullptr));
+    releaser_.BeginDiscard(0, kSegmentSize, kSegmentSize);
+    releaser_.EndDiscard(0, kSegmentSize, kSegmentSize, true);
+    releaser_.EndWrite(4096, 4096, kSegmentSize);
+    ASSERT_EQ(1, Released().size());
+    ASSERT_EQ(0, releaser_.GetSegmentNum());
+
+    // 写请求不影响之后的discard
+    releaser_.BeginDiscard(0, kSegmentSize, kSegmentSize);
+    releaser_.EndDiscard(0, kSegmentSize, kSegmentSize, true);
+    ASSERT_EQ(std::vector<uint64_t>({kSegmentSize, 0}), Released());
+}
+
+TEST_F(SegmentReleaserTest, WaitReleasingTest) {
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool releasing = false;
+    bool finish = false;
+    std::thread releaseThread;
+    std::thread::id mainThread = std::this_thread::get_id();
+    releaser_.Init(
+        [&](uint64_t segoff) {
+            std::unique_lock<std::mutex> lk(mtx);
+            releasing = true;
+            cv.notify_all();
+            cv.wait(lk, [&]() { return finish; });
+        },
+        [&](const std::function<void()>& task) {
+            // 释放任务在新线程中执行，挂起的写请求在释放线程中重新执行
+            if (std::this_thread::get_id() == mainThread) {
+                releaseThread = std::thread(task);
+            } else {
+                task();
+            }
+        });
+
+    releaser_.BeginDiscard(0, kSegmentSize, kSegmentSize);
+    releaser_.EndDiscard(0, kSegmentSize, kSegmentSize, true);
+    {
+        std::unique_lock<std::mutex> lk(mtx);
+        cv.wait(lk, [&]() { return releasing; });
+    }
+
+    // 其他segment的写请求不受影响
+    std::atomic<int> resumed(0);
+    auto resume = [&]() { ++resumed; };
+    ASSERT_TRUE(releaser_.BeginWrite(kSegmentSize, 4096, kSegmentSize,
+                                     resume));
+    releaser_.EndWrite(kSegmentSize, 4096, kSegmentSize);
+
+    // segment正在释放时写请求挂起，不阻塞调用线程
+    ASSERT_FALSE(releaser_.BeginWrite(4096, 4096, kSegmentSize, resume));
+    ASSERT_FALSE(releaser_.BeginWrite(kSegmentSize - 4096, 8192,
+                                      kSegmentSize, resume));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_EQ(0, resumed);
+
+    // 释放完成后在后台重新执行挂起的写请求
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        finish = true;
+        cv.notify_all();
+    }
+    releaseThread.join();
+    ASSERT_EQ(2, resumed);
+    ASSERT_TRUE(releaser_.BeginWrite(4096, 4096, kSegmentSize, resume));
+    releaser_.EndWrite(4096, 4096, kSegmentSize);
+    ASSERT_EQ(0, releaser_.GetSegmentNum());
+}
+
+}   // namespace client
+}   // namespace curve
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/client/split_size_estimator.h"
+
+namespace curve {
+namespace client {
+
+class SplitSizeEstimatorTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        opt_.fileIOSplitMaxSizeKB = 64;
+        opt_.enableAdaptiveSplit = true;
+        opt_.adaptiveSplitMinSizeKB = 16;
+        opt_.adaptiveSplitMaxSizeKB = 1024;
+    }
+
+    // 按 latency = overheadUs + length / bandwidth 生成一轮样本
+    void Feed(double overheadUs, double bytesPerUs) {
+        const uint64_t sizes[] = {4096, 16384, 65536, 131072};
+        for (uint32_t i = 0; i < SplitSizeEstimator::kUpdateInterval; ++i) {
+            uint64_t length = sizes[i % 4];
+            estimator_.Record(length, overheadUs + length / bytesPerUs);
+        }
+    }
+
+    IOSplitOPtion_t opt_;
+    SplitSizeEstimator estimator_;
+};
+
+TEST_F(SplitSizeEstimatorTest, DisableTest) {
+    opt_.enableAdaptiveSplit = false;
+    estimator_.Init(opt_);
+    ASSERT_EQ(64 * 1024, estimator_.GetSplitSize());
+
+    Feed(500, 100);
+    ASSERT_EQ(64 * 1024, estimator_.GetSplitSize());
+
+    // 上下限不合法时不开启
+    opt_.enableAdaptiveSplit = true;
+    opt_.adaptiveSplitMinSizeKB = 2048;
+    estimator_.Init(opt_);
+    Feed(500, 100);
+    ASSERT_EQ(64 * 1024, estimator_.GetSplitSize());
+}
+
+TEST_F(SplitSizeEstimatorTest, AdaptTest) {
+    estimator_.Init(opt_);
+    ASSERT_EQ(64 * 1024, estimator_.GetSplitSize());
+
+    // 固定开销100us，带宽1000B/us，传输时间为固定开销4倍时请求大小为400000B
+    Feed(100, 1000);
+    ASSERT_EQ(400000 / 4096 * 4096, estimator_.GetSplitSize());
+
+    // 固定开销很大时取上限
+    for (int i = 0; i < 8; ++i) {
+        Feed(10000, 1000);
+    }
+    ASSERT_EQ(1024 * 1024, estimator_.GetSplitSize());
+
+    // 固定开销很小时取下限，旧样本的权重每轮减半，需要多轮才能消除影响
+    for (int i = 0; i < 20; ++i) {
+        Feed(1, 1000);
+    }
+    ASSERT_EQ(16 * 1024, estimator_.GetSplitSize());
+}
+
+TEST_F(SplitSizeEstimatorTest, UniformSizeTest) {
+    estimator_.Init(opt_);
+
+    // 请求大小都相同时无法拟合，保持不变
+    for (uint32_t i = 0; i < 4 * SplitSizeEstimator::kUpdateInterval; ++i) {
+        estimator_.Record(65536, 200 + i % 7);
+    }
+    ASSERT_EQ(64 * 1024, estimator_.GetSplitSize());
+
+    // latency与请求大小无关时取上限
+    for (uint32_t i = 0; i < SplitSizeEstimator::kUpdateInterval; ++i) {
+        estimator_.Record(4096 << (i % 5), 300);
+    }
+    ASSERT_EQ(1024 * 1024, estimator_.GetSplitSize());
+}
+
+}   // namespace client
+}   // namespace curve
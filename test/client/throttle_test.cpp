@@ -0,0 +1,179 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>   // NOLINT
+#include <memory>
+#include <thread>   // NOLINT
+
+#include "src/client/throttle.h"
+#include "src/common/timeutility.h"
+
+using curve::common::TimeUtility;
+
+namespace curve {
+namespace client {
+
+TEST(TokenBucketTest, BucketTest) {
+    TokenBucket bucket;
+    uint64_t now = 1000000;
+
+    // 不限制时总是可以通过
+    ASSERT_FALSE(bucket.Enabled());
+    bucket.Consume(10000);
+    ASSERT_EQ(0, bucket.WaitUs(now));
+
+    ThrottleParams_t params;
+    params.limit = 100;
+    bucket.SetParams(params, now);
+    ASSERT_TRUE(bucket.Enabled());
+
+    // 初始时桶是满的，令牌可以被扣成负数，之后等待令牌补齐
+    ASSERT_EQ(0, bucket.WaitUs(now));
+    bucket.Consume(150);
+    ASSERT_EQ(500000, bucket.WaitUs(now));
+    ASSERT_EQ(100000, bucket.WaitUs(now + 400000));
+    ASSERT_EQ(0, bucket.WaitUs(now + 500000));
+
+    // 空闲时最多积累burst个令牌
+    params.burst = 1000;
+    now += 500000;
+    bucket.SetParams(params, now);
+    now += 100 * 1000000;
+    ASSERT_EQ(0, bucket.WaitUs(now));
+    bucket.Consume(1000);
+    ASSERT_EQ(0, bucket.WaitUs(now));
+    bucket.Consume(1);
+    ASSERT_EQ(10000, bucket.WaitUs(now));
+}
+
+class ThrottleTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        dispatched_ = 0;
+        metric_.reset(new FileMetric("throttle_test"));
+    }
+
+    void Init(const ThrottleOption_t& opt) {
+        throttle_.Init(opt, metric_.get(), [](const Throttle::Task& task) {
+            task();
+        });
+    }
+
+    void AddIO(OpType type, uint64_t length, int count) {
+        for (int i = 0; i < count; ++i) {
+            throttle_.Add(type, length, [this]() { ++dispatched_; });
+        }
+    }
+
+    bool WaitDispatched(int expected) {
+        for (int i = 0; i < 200; ++i) {
+            if (dispatched_.load() == expected) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+    std::atomic<int> dispatched_;
+    std::unique_ptr<FileMetric> metric_;
+    Throttle throttle_;
+};
+
+TEST_F(ThrottleTest, DisableTest) {
+    ThrottleOption_t opt;
+    opt.params.readIOPS.limit = 1;
+    Init(opt);
+    ASSERT_FALSE(throttle_.Enabled());
+
+    AddIO(OpType::READ, 4096, 100);
+    ASSERT_EQ(100, dispatched_.load());
+    ASSERT_EQ(0, throttle_.GetPendingNum());
+
+    // 未开启时忽略mds下发的参数
+    FileThrottleParams_t params;
+    params.readIOPS.limit = 1;
+    throttle_.UpdateParams(params);
+    AddIO(OpType::READ, 4096, 100);
+    ASSERT_EQ(200, dispatched_.load());
+}
+
+TEST_F(ThrottleTest, QueueTest) {
+    ThrottleOption_t opt;
+    opt.enable = true;
+    opt.params.readIOPS.limit = 10;
+    Init(opt);
+    ASSERT_TRUE(throttle_.Enabled());
+
+    // 令牌用完之后的读请求排队，不阻塞当前线程
+    AddIO(OpType::READ, 4096, 20);
+    ASSERT_EQ(11, dispatched_.load());
+    ASSERT_EQ(9, throttle_.GetPendingNum());
+
+    // 写请求不受读限流的影响
+    AddIO(OpType::WRITE, 4096, 10);
+    ASSERT_EQ(21, dispatched_.load());
+
+    // 放宽限制后排队的请求被后台线程下发
+    FileThrottleParams_t params;
+    params.readIOPS.limit = 1000000;
+    throttle_.UpdateParams(params);
+    ASSERT_TRUE(WaitDispatched(30));
+    ASSERT_EQ(0, throttle_.GetPendingNum());
+}
+
+TEST_F(ThrottleTest, StopTest) {
+    ThrottleOption_t opt;
+    opt.enable = true;
+    opt.params.writeBPS.limit = 4096;
+    Init(opt);
+
+    // 大于桶容量的请求也能通过，之后的请求等待欠下的令牌补齐
+    AddIO(OpType::WRITE, 8192, 10);
+    ASSERT_EQ(1, dispatched_.load());
+
+    // 停止时排队的请求全部立即下发，之后的请求不再限流
+    throttle_.Stop();
+    ASSERT_EQ(10, dispatched_.load());
+    AddIO(OpType::WRITE, 8192, 10);
+    ASSERT_EQ(20, dispatched_.load());
+}
+
+TEST_F(ThrottleTest, SyncWaitTest) {
+    ThrottleOption_t opt;
+    opt.enable = true;
+    opt.params.readBPS.limit = 1024 * 1024;
+    Init(opt);
+
+    uint64_t start = TimeUtility::GetTimeofDayUs();
+    throttle_.Wait(OpType::READ, 1024 * 1024);
+    throttle_.Wait(OpType::READ, 512 * 1024);
+    ASSERT_LT(TimeUtility::GetTimeofDayUs() - start, 200000);
+
+    // 欠下的512KB令牌需要500ms补齐
+    throttle_.Wait(OpType::READ, 4096);
+    ASSERT_GE(TimeUtility::GetTimeofDayUs() - start, 400000);
+}
+
+}   // namespace client
+}   // namespace curve
@@ -0,0 +1,371 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <gtest/gtest.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>    // NOLINT
+#include <string>
+#include <vector>
+
+#include "src/client/write_back_cache.h"
+
+namespace curve {
+namespace client {
+
+const char* kLogDir = "./runlog/writeback_test";
+const char* kFileName = "/write_back_cache_test";
+const uint64_t kBlockSize = 4096;
+
+// 模拟chunkserver一侧的文件
+class FakeBackend {
+ public:
+    FakeBackend() : data_(16 * 1024 * 1024, 0), fail_(false) {}
+
+    int Write(const char* buf, off_t offset, size_t length) {
+        if (fail_) {
+            return -1;
+        }
+        std::lock_guard<std::mutex> lk(mtx_);
+        memcpy(&data_[offset], buf, length);
+        requests_.push_back(length);
+        return length;
+    }
+
+    std::string Read(off_t offset, size_t length) {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return data_.substr(offset, length);
+    }
+
+    std::vector<size_t> Requests() {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return requests_;
+    }
+
+    void SetFail(bool fail) {
+        fail_ = fail;
+    }
+
+ private:
+    std::mutex mtx_;
+    std::string data_;
+    std::vector<size_t> requests_;
+    std::atomic<bool> fail_;
+};
+
+class WriteBackCacheTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        mkdir("./runlog", 0755);
+        opt_.enable = true;
+        opt_.logDir = kLogDir;
+        opt_.maxDirtyMB = 4;
+        opt_.flushThresholdMB = 4;
+        opt_.maxLogSizeMB = 64;
+        // 后台只在被请求时刷盘，保证测试结果确定
+        opt_.flushIntervalMS = 100000;
+        opt_.flushBatchSizeKB = 64;
+        metric_.reset(new FileMetric("write_back_cache_test"));
+    }
+
+    void TearDown() override {
+        cache_.reset();
+        unlink((std::string(kLogDir) + "/_write_back_cache_test.wblog").c_str());
+        rmdir(kLogDir);
+    }
+
+    void StartCache() {
+        cache_.reset(new WriteBackCache());
+        cache_->Init(opt_, kFileName, metric_.get(),
+            [this](const char* buf, off_t offset, size_t length) {
+                return backend_.Write(buf, offset, length);
+            });
+        ASSERT_EQ(0, cache_->Start());
+        ASSERT_TRUE(cache_->Running());
+    }
+
+    WriteBackOption_t opt_;
+    FakeBackend backend_;
+    std::unique_ptr<FileMetric> metric_;
+    std::unique_ptr<WriteBackCache> cache_;
+};
+
+TEST_F(WriteBackCacheTest, DisableTest) {
+    WriteBackCache cache;
+    WriteBackOption_t opt;
+    cache.Init(opt, kFileName, nullptr, nullptr);
+    ASSERT_EQ(0, cache.Start());
+    ASSERT_FALSE(cache.Running());
+    ASSERT_EQ(0, cache.Flush());
+}
+
+TEST_F(WriteBackCacheTest, OverlayTest) {
+    StartCache();
+
+    std::string a(2 * kBlockSize, 'a');
+    std::string b(kBlockSize, 'b');
+    ASSERT_EQ(a.size(), cache_->Write(a.data(), 0, a.size()));
+    ASSERT_EQ(b.size(), cache_->Write(b.data(), kBlockSize, b.size()));
+    ASSERT_EQ(2 * kBlockSize, cache_->GetDirtyBytes());
+
+    // 读范围全部是脏数据
+    std::vector<DirtyExtent> extents;
+    std::string buf(2 * kBlockSize, 'z');
+    ASSERT_TRUE(cache_->GetDirtyExtents(0, buf.size(), &extents));
+    WriteBackCache::ApplyDirtyExtents(extents, 0, buf.size(), &buf[0]);
+    ASSERT_EQ(std::string(kBlockSize, 'a') + b, buf);
+
+    // 读范围部分是脏数据
+    extents.clear();
+    buf.assign(2 * kBlockSize, 'z');
+    ASSERT_FALSE(cache_->GetDirtyExtents(kBlockSize, buf.size(), &extents));
+    WriteBackCache::ApplyDirtyExtents(extents, kBlockSize, buf.size(),
+                                      &buf[0]);
+    ASSERT_EQ(b + std::string(kBlockSize, 'z'), buf);
+
+    // 没有脏数据
+    extents.clear();
+    ASSERT_FALSE(cache_->GetDirtyExtents(4 * kBlockSize, kBlockSize,
+                                         &extents));
+    ASSERT_TRUE(extents.empty());
+}
+
+TEST_F(WriteBackCacheTest, FlushMergeTest) {
+    StartCache();
+
+    // 乱序写入连续的4个block，并覆盖写其中一个
+    std::string data(4 * kBlockSize, 0);
+    for (int i : {2, 0, 3, 1}) {
+        std::string block(kBlockSize, 'a' + i);
+        data.replace(i * kBlockSize, kBlockSize, block);
+        ASSERT_EQ(kBlockSize, cache_->Write(block.data(), i * kBlockSize,
+                                            kBlockSize));
+    }
+    std::string block(kBlockSize, 'x');
+    data.replace(kBlockSize, kBlockSize, block);
+    ASSERT_EQ(kBlockSize, cache_->Write(block.data(), kBlockSize, kBlockSize));
+    ASSERT_EQ(4 * kBlockSize, cache_->GetDirtyBytes());
+    ASSERT_TRUE(backend_.Requests().empty());
+
+    ASSERT_EQ(0, cache_->Flush());
+    ASSERT_EQ(0, cache_->GetDirtyBytes());
+    ASSERT_EQ(0, metric_->writeBack.dirtyBytes.get_value());
+    ASSERT_EQ(std::vector<size_t>{4 * kBlockSize}, backend_.Requests());
+    ASSERT_EQ(data, backend_.Read(0, data.size()));
+
+    // 没有脏数据时flush直接返回
+    ASSERT_EQ(0, cache_->Flush());
+    ASSERT_EQ(1, backend_.Requests().size());
+
+    // 刷盘后本地日志被截断
+    struct stat st;
+    ASSERT_EQ(0, stat(cache_->GetLogPath().c_str(), &st));
+    ASSERT_EQ(0, st.st_size);
+
+    // 正常停止后删除本地日志
+    cache_->Stop();
+    ASSERT_NE(0, stat(cache_->GetLogPath().c_str(), &st));
+}
+
+TEST_F(WriteBackCacheTest, FlushFailAndReplayTest) {
+    StartCache();
+    backend_.SetFail(true);
+
+    std::string a(kBlockSize, 'a');
+    std::string b(kBlockSize, 'b');
+    ASSERT_EQ(kBlockSize, cache_->Write(a.data(), 0, kBlockSize));
+    ASSERT_EQ(kBlockSize, cache_->Write(b.data(), 0, kBlockSize));
+    ASSERT_EQ(kBlockSize, cache_->Write(a.data(), 8 * kBlockSize, kBlockSize));
+
+    ASSERT_GT(0, cache_->Flush());
+    ASSERT_EQ(2 * kBlockSize, cache_->GetDirtyBytes());
+
+    // 停止时保留未刷盘的数据
+    cache_->Stop();
+    struct stat st;
+    ASSERT_EQ(0, stat(cache_->GetLogPath().c_str(), &st));
+    ASSERT_GT(st.st_size, 0);
+
+    // 重新启动后回放本地日志
+    backend_.SetFail(false);
+    StartCache();
+    ASSERT_EQ(2 * kBlockSize, cache_->GetDirtyBytes());
+    ASSERT_EQ(0, cache_->Flush());
+    ASSERT_EQ(b, backend_.Read(0, kBlockSize));
+    ASSERT_EQ(a, backend_.Read(8 * kBlockSize, kBlockSize));
+}
+
+TEST_F(WriteBackCacheTest, TornRecordTest) {
+    StartCache();
+    backend_.SetFail(true);
+
+    std::string a(kBlockSize, 'a');
+    ASSERT_EQ(kBlockSize, cache_->Write(a.data(), 0, kBlockSize));
+    ASSERT_EQ(kBlockSize, cache_->Write(a.data(), kBlockSize, kBlockSize));
+    cache_->Stop();
+
+    // 模拟最后一条记录只写了一半
+    struct stat st;
+    ASSERT_EQ(0, stat(cache_->GetLogPath().c_str(), &st));
+    ASSERT_EQ(0, truncate(cache_->GetLogPath().c_str(),
+                          st.st_size - kBlockSize / 2));
+
+    backend_.SetFail(false);
+    StartCache();
+    ASSERT_EQ(kBlockSize, cache_->GetDirtyBytes());
+    ASSERT_EQ(0, cache_->Flush());
+    ASSERT_EQ(a, backend_.Read(0, kBlockSize));
+    ASSERT_EQ(std::string(kBlockSize, 0), backend_.Read(kBlockSize, kBlockSize));
+}
+
+TEST_F(WriteBackCacheTest, FenceLogTest) {
+    StartCache();
+    backend_.SetFail(true);
+
+    std::string a(kBlockSize, 'a');
+    ASSERT_EQ(kBlockSize, cache_->Write(a.data(), 0, kBlockSize));
+    ASSERT_EQ(-LIBCURVE_ERROR::PARAM_ERROR,
+              cache_->Write(a.data(), kBlockSize,
+                            static_cast<size_t>(
+                                std::numeric_limits<int>::max()) + 1));
+
+    // 限制文件大小，记录和跳过标记都无法写入
+    struct stat st;
+    ASSERT_EQ(0, stat(cache_->GetLogPath().c_str(), &st));
+    struct rlimit old;
+    ASSERT_EQ(0, getrlimit(RLIMIT_FSIZE, &old));
+    struct rlimit limit = old;
+    limit.rlim_cur = st.st_size;
+    sighandler_t oldHandler = signal(SIGXFSZ, SIG_IGN);
+    ASSERT_EQ(0, setrlimit(RLIMIT_FSIZE, &limit));
+    ASSERT_EQ(-LIBCURVE_ERROR::FAILED,
+              cache_->Write(a.data(), kBlockSize, kBlockSize));
+    ASSERT_EQ(0, setrlimit(RLIMIT_FSIZE, &old));
+    signal(SIGXFSZ, oldHandler);
+
+    // 日志被隔离后不再追加新的记录
+    ASSERT_EQ(-LIBCURVE_ERROR::FAILED,
+              cache_->Write(a.data(), 2 * kBlockSize, kBlockSize));
+    ASSERT_EQ(kBlockSize, cache_->GetDirtyBytes());
+    cache_->Stop();
+
+    // 重新启动后只回放损坏记录之前的数据
+    backend_.SetFail(false);
+    StartCache();
+    ASSERT_EQ(kBlockSize, cache_->GetDirtyBytes());
+    ASSERT_EQ(kBlockSize, cache_->Write(a.data(), 2 * kBlockSize, kBlockSize));
+    ASSERT_EQ(0, cache_->Flush());
+    ASSERT_EQ(a, backend_.Read(0, kBlockSize));
+    ASSERT_EQ(std::string(kBlockSize, 0),
+              backend_.Read(kBlockSize, kBlockSize));
+    ASSERT_EQ(a, backend_.Read(2 * kBlockSize, kBlockSize));
+}
+
+TEST_F(WriteBackCacheTest, ReclaimLogSegmentTest) {
+    // 每个日志段128KB
+    opt_.maxLogSizeMB = 1;
+    cache_.reset(new WriteBackCache());
+    bool written = false;
+    std::string b(kBlockSize, 'b');
+    cache_->Init(opt_, kFileName, metric_.get(),
+        [&](const char* buf, off_t offset, size_t length) {
+            // 第一次刷盘期间写入新数据，本轮刷盘完成后缓存不为空
+            if (!written) {
+                written = true;
+                EXPECT_EQ(kBlockSize, cache_->Write(b.data(),
+                                                    128 * kBlockSize,
+                                                    kBlockSize));
+            }
+            return backend_.Write(buf, offset, length);
+        });
+    ASSERT_EQ(0, cache_->Start());
+
+    std::string a(64 * kBlockSize, 'a');
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_EQ(kBlockSize, cache_->Write(a.data(), i * kBlockSize,
+                                            kBlockSize));
+    }
+    struct stat st;
+    ASSERT_EQ(0, stat(cache_->GetLogPath().c_str(), &st));
+    ASSERT_GT(st.st_size, 0);
+
+    // 已经刷盘的日志段被删除，未刷盘的数据仍在日志中
+    ASSERT_EQ(0, cache_->Flush());
+    ASSERT_TRUE(written);
+    ASSERT_EQ(kBlockSize, cache_->GetDirtyBytes());
+    ASSERT_NE(0, stat(cache_->GetLogPath().c_str(), &st));
+    ASSERT_EQ(a, backend_.Read(0, a.size()));
+
+    // 重新启动后只回放剩余的日志段
+    cache_->Stop();
+    StartCache();
+    ASSERT_GE(cache_->GetDirtyBytes(), kBlockSize);
+    ASSERT_LT(cache_->GetDirtyBytes(), 32 * kBlockSize);
+    ASSERT_EQ(0, cache_->Flush());
+    ASSERT_EQ(b, backend_.Read(128 * kBlockSize, kBlockSize));
+    cache_->Stop();
+}
+
+TEST_F(WriteBackCacheTest, ThrottleTest) {
+    opt_.maxDirtyMB = 1;
+    StartCache();
+
+    std::string data(1024 * 1024, 'a');
+    ASSERT_EQ(data.size(), cache_->Write(data.data(), 0, data.size()));
+    ASSERT_EQ(0, metric_->writeBack.throttle.count.get_value());
+
+    // 超过脏数据上限，等待后台刷盘后写入
+    ASSERT_EQ(kBlockSize, cache_->Write(data.data(), data.size(), kBlockSize));
+    ASSERT_EQ(1, metric_->writeBack.throttle.count.get_value());
+    ASSERT_EQ(kBlockSize, cache_->GetDirtyBytes());
+    ASSERT_EQ(data, backend_.Read(0, data.size()));
+}
+
+TEST_F(WriteBackCacheTest, AioFlushTest) {
+    StartCache();
+
+    std::string a(kBlockSize, 'a');
+    ASSERT_EQ(kBlockSize, cache_->Write(a.data(), 0, kBlockSize));
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool finished = false;
+    int ret = -1;
+    cache_->AioFlush([&](int rc) {
+        std::lock_guard<std::mutex> lk(mtx);
+        ret = rc;
+        finished = true;
+        cv.notify_one();
+    });
+
+    std::unique_lock<std::mutex> lk(mtx);
+    cv.wait(lk, [&]() { return finished; });
+    ASSERT_EQ(0, ret);
+    ASSERT_EQ(a, backend_.Read(0, kBlockSize));
+}
+
+}   // namespace client
+}   // namespace curve
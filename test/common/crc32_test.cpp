@@ -22,6 +22,8 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+
 #include "src/common/crc32.h"
 
 namespace curve {
@@ -92,5 +94,26 @@ TEST(Crc32TEST, Extend) {
             CRC32(CRC32("hello ", 6), "world", 5));
 }
 
+TEST(Crc32TEST, IOBuf) {
+  butil::IOBuf empty;
+  ASSERT_EQ(CRC32("", 0), CRC32(empty));
+
+  // 多个block组成的IOBuf与连续内存的结果一致
+  std::string data(20000, 'a');
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>(i % 251);
+  }
+  butil::IOBuf buf;
+  buf.append(data.c_str(), 100);
+  butil::IOBuf tail;
+  tail.append(data.c_str() + 100, data.size() - 100);
+  buf.append(tail);
+  ASSERT_GT(buf.backing_block_num(), 1);
+  ASSERT_EQ(CRC32(data.c_str(), data.size()), CRC32(buf));
+
+  data[10000] = ~data[10000];
+  ASSERT_NE(CRC32(data.c_str(), data.size()), CRC32(buf));
+}
+
 }  // namespace common
 }  // namespace curve
@@ -33,6 +33,7 @@
 
 using ::testing::Return;
 using ::testing::SetArgPointee;
+using ::testing::SaveArg;
 using ::testing::DoAll;
 using ::testing::_;
 using ::curve::mds::topology::MockTopology;
@@ -915,6 +916,150 @@ TEST_F(TestHeartbeatManager, test_patrol_copySetInfo_return_order) {
     ASSERT_EQ(TRANSFER_LEADER, response.needupdatecopysets(0).type());
     ASSERT_EQ(3, response.needupdatecopysets(0).peers_size());
 }
+
+TEST_F(TestHeartbeatManager, test_delta_heartbeat) {
+    ::curve::mds::topology::ChunkServer chunkServer1(
+        1, "hello", "", 1, "192.168.10.1", 9000, "",
+        ::curve::mds::topology::ChunkServerStatus::READWRITE);
+    ::curve::mds::topology::ChunkServer chunkServer2(
+        2, "hello", "", 1, "192.168.10.2", 9000, "",
+        ::curve::mds::topology::ChunkServerStatus::READWRITE);
+    ::curve::mds::topology::ChunkServer chunkServer3(
+        3, "hello", "", 1, "192.168.10.3", 9000, "",
+        ::curve::mds::topology::ChunkServerStatus::READWRITE);
+    EXPECT_CALL(*topology_, GetChunkServer(1, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(chunkServer1), Return(true)));
+    ::curve::mds::topology::CopySetInfo copySetInfo(1, 1);
+    copySetInfo.SetEpoch(10);
+    copySetInfo.SetLeader(1);
+    copySetInfo.SetCopySetMembers(std::set<ChunkServerIdType>{1, 2, 3});
+    EXPECT_CALL(*topology_, GetCopySet(_, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copySetInfo), Return(true)));
+    ::curve::mds::topology::ChunkServerStat stat;
+    EXPECT_CALL(*topologyStat_, UpdateChunkServerStat(1, _))
+        .WillRepeatedly(SaveArg<1>(&stat));
+
+    // 1. 没有全量心跳时收到增量心跳，处理上报的copyset并要求全量心跳
+    auto request = GetChunkServerHeartbeatRequestForTest();
+    request.set_heartbeatseq(1);
+    request.set_isdelta(true);
+    ChunkServerHeartbeatResponse response;
+    EXPECT_CALL(*topology_, GetChunkServerNotRetired(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(chunkServer1), Return(true)))
+        .WillOnce(DoAll(SetArgPointee<2>(chunkServer2), Return(true)))
+        .WillOnce(DoAll(SetArgPointee<2>(chunkServer3), Return(true)));
+    EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
+        .WillOnce(Return(::curve::mds::topology::UNINTIALIZE_ID));
+    heartbeatManager_->ChunkServerHeartbeat(request, &response);
+    ASSERT_EQ(HeartbeatStatusCode::hbOK, response.statuscode());
+    ASSERT_TRUE(response.needfullheartbeat());
+    ASSERT_EQ(1, stat.copysetStats.size());
+
+    // 2. 全量心跳
+    request.set_heartbeatseq(2);
+    request.set_isdelta(false);
+    response.Clear();
+    EXPECT_CALL(*topology_, GetChunkServerNotRetired(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(chunkServer1), Return(true)))
+        .WillOnce(DoAll(SetArgPointee<2>(chunkServer2), Return(true)))
+        .WillOnce(DoAll(SetArgPointee<2>(chunkServer3), Return(true)));
+    EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
+        .WillOnce(Return(::curve::mds::topology::UNINTIALIZE_ID));
+    heartbeatManager_->ChunkServerHeartbeat(request, &response);
+    ASSERT_FALSE(response.needfullheartbeat());
+
+    // 3. 增量心跳中没有变化的copyset，不再解析和更新topology，
+    //    仍然使用上一次上报的信息检查配置下发和更新统计
+    request.set_heartbeatseq(3);
+    request.set_isdelta(true);
+    request.clear_copysetinfos();
+    response.Clear();
+    stat.copysetStats.clear();
+    EXPECT_CALL(*topology_, GetChunkServerNotRetired(_, _, _)).Times(0);
+    EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
+        .WillOnce(Return(::curve::mds::topology::UNINTIALIZE_ID));
+    heartbeatManager_->ChunkServerHeartbeat(request, &response);
+    ASSERT_EQ(HeartbeatStatusCode::hbOK, response.statuscode());
+    ASSERT_FALSE(response.needfullheartbeat());
+    ASSERT_EQ(1, stat.copysetStats.size());
+    ASSERT_EQ(1, stat.copysetStats[0].copysetId);
+
+    // 4. 心跳序号不连续，要求全量心跳
+    request.set_heartbeatseq(5);
+    response.Clear();
+    EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
+        .WillOnce(Return(::curve::mds::topology::UNINTIALIZE_ID));
+    heartbeatManager_->ChunkServerHeartbeat(request, &response);
+    ASSERT_TRUE(response.needfullheartbeat());
+}
+
+TEST_F(TestHeartbeatManager, test_shard_heartbeat) {
+    HeartbeatOption option;
+    option.cleanFollowerAfterMs = 0;
+    option.heartbeatMissTimeOutMs = 10000;
+    option.offLineTimeOutMs = 30000;
+    option.mdsStartTime = steady_clock::now();
+    option.shardNum = 4;
+    option.shardQueueCapacity = 1;
+    auto heartbeatManager = std::make_shared<HeartbeatManager>(
+        option, topology_, topologyStat_, coordinator_);
+
+    ::curve::mds::topology::ChunkServer chunkServer1(
+        1, "hello", "", 1, "192.168.10.1", 9000, "",
+        ::curve::mds::topology::ChunkServerStatus::READWRITE);
+    ::curve::mds::topology::ChunkServer chunkServer2(
+        2, "hello", "", 1, "192.168.10.2", 9000, "",
+        ::curve::mds::topology::ChunkServerStatus::READWRITE);
+    ::curve::mds::topology::ChunkServer chunkServer3(
+        3, "hello", "", 1, "192.168.10.3", 9000, "",
+        ::curve::mds::topology::ChunkServerStatus::READWRITE);
+    EXPECT_CALL(*topology_, GetChunkServer(1, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(chunkServer1), Return(true)));
+    EXPECT_CALL(*topology_, GetChunkServerNotRetired("192.168.10.1", _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<2>(chunkServer1), Return(true)));
+    EXPECT_CALL(*topology_, GetChunkServerNotRetired("192.168.10.2", _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<2>(chunkServer2), Return(true)));
+    EXPECT_CALL(*topology_, GetChunkServerNotRetired("192.168.10.3", _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<2>(chunkServer3), Return(true)));
+    ::curve::mds::topology::CopySetInfo copySetInfo(1, 1);
+    copySetInfo.SetEpoch(1);
+    EXPECT_CALL(*topology_, GetCopySet(_, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copySetInfo), Return(true)));
+
+    // 1. 分片线程未启动，拒绝处理copyset
+    auto request = GetChunkServerHeartbeatRequestForTest();
+    ChunkServerHeartbeatResponse response;
+    EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _)).Times(0);
+    heartbeatManager->ChunkServerHeartbeat(request, &response);
+    ASSERT_EQ(HeartbeatStatusCode::hbMdsBusy, response.statuscode());
+    ASSERT_EQ(0, response.needupdatecopysets_size());
+
+    // 2. 分片处理leader上报的copyset，epoch落后时更新topology
+    heartbeatManager->Run();
+    response.Clear();
+    EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
+        .WillOnce(Return(::curve::mds::topology::UNINTIALIZE_ID));
+    EXPECT_CALL(*topology_, UpdateCopySetTopo(_))
+        .WillOnce(Return(::curve::mds::topology::kTopoErrCodeSuccess));
+    heartbeatManager->ChunkServerHeartbeat(request, &response);
+    ASSERT_EQ(HeartbeatStatusCode::hbOK, response.statuscode());
+    ASSERT_EQ(0, response.needupdatecopysets_size());
+    heartbeatManager->Stop();
+
+    // 3. 分片队列放不下心跳中所有的copyset，拒绝处理
+    option.shardNum = 1;
+    heartbeatManager = std::make_shared<HeartbeatManager>(
+        option, topology_, topologyStat_, coordinator_);
+    heartbeatManager->Run();
+    auto info = request.add_copysetinfos();
+    *info = request.copysetinfos(0);
+    info->set_copysetid(2);
+    response.Clear();
+    heartbeatManager->ChunkServerHeartbeat(request, &response);
+    ASSERT_EQ(HeartbeatStatusCode::hbMdsBusy, response.statuscode());
+    ASSERT_EQ(0, response.needupdatecopysets_size());
+    heartbeatManager->Stop();
+}
 }  // namespace heartbeat
 }  // namespace mds
 }  // namespace curve
@@ -63,8 +63,8 @@ class MockEtcdClient : public EtcdClientImp {
 class MockLRUCache : public LRUCache {
  public:
     virtual ~MockLRUCache() {}
-    MOCK_METHOD2(Put, void(const std::string&, const std::string&));
-    MOCK_METHOD2(Get, bool(const std::string&, std::string*));
+    MOCK_METHOD2(Put, void(const std::string&, const CacheValue&));
+    MOCK_METHOD2(Get, bool(const std::string&, CacheValue*));
     MOCK_METHOD1(Remove, void(const std::string&));
 };
 }  // namespace mds
@@ -246,6 +246,7 @@ class MockTopology : public Topology {
     MOCK_CONST_METHOD2(GetCopySetsInChunkServer,
         std::vector<CopySetKey>(ChunkServerIdType id,
             CopySetFilter filter));
+    MOCK_METHOD0(GetSnapshot, std::shared_ptr<const TopologySnapshot>());
 };
 
 class MockTopologyStat : public TopologyStat {
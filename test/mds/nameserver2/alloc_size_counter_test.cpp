@@ -0,0 +1,235 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>  // NOLINT
+#include <map>
+#include <memory>
+#include <thread>  // NOLINT
+
+#include "src/mds/nameserver2/alloc_size_counter.h"
+#include "test/mds/nameserver2/fakes.h"
+#include "test/mds/nameserver2/mock/mock_namespace_storage.h"
+
+using ::testing::_;
+using ::testing::Return;
+using ::testing::DoAll;
+using ::testing::SetArgPointee;
+
+namespace curve {
+namespace mds {
+
+AllocatedSize MakeAllocSize(uint64_t alloc, uint64_t physical) {
+    AllocatedSize size;
+    size.allocatedSize = alloc;
+    size.physicalAllocatedSize = physical;
+    return size;
+}
+
+void Record(AllocSizeCounter *counter, InodeID id,
+            const AllocatedSize &size) {
+    uint64_t generation = counter->BeginBuild(id);
+    ASSERT_TRUE(counter->EndBuild(id, generation, size, true));
+}
+
+TEST(AllocSizeCounterTest, GetSetAddSub) {
+    auto storage = std::make_shared<FakeNameServerStorage>();
+    AllocSizeCounter counter(storage, 100000);
+    ASSERT_TRUE(counter.Init());
+    counter.Run();
+
+    AllocatedSize size;
+    ASSERT_FALSE(counter.Get(1, &size));
+
+    Record(&counter, 1, MakeAllocSize(10, 30));
+    Record(&counter, 2, MakeAllocSize(4, 12));
+
+    // 没有记录的inode 3跳过
+    counter.Add({1, 2, 3}, MakeAllocSize(1, 3));
+    ASSERT_TRUE(counter.Get(1, &size));
+    ASSERT_EQ(11, size.allocatedSize);
+    ASSERT_EQ(33, size.physicalAllocatedSize);
+    ASSERT_TRUE(counter.Get(2, &size));
+    ASSERT_EQ(5, size.allocatedSize);
+    ASSERT_EQ(15, size.physicalAllocatedSize);
+    ASSERT_FALSE(counter.Get(3, &size));
+
+    // 减到0为止
+    counter.Sub({1, 2}, MakeAllocSize(6, 18));
+    ASSERT_TRUE(counter.Get(1, &size));
+    ASSERT_EQ(5, size.allocatedSize);
+    ASSERT_EQ(15, size.physicalAllocatedSize);
+    ASSERT_TRUE(counter.Get(2, &size));
+    ASSERT_EQ(0, size.allocatedSize);
+    ASSERT_EQ(0, size.physicalAllocatedSize);
+
+    counter.Invalidate({2});
+    ASSERT_FALSE(counter.Get(2, &size));
+
+    // 更新只修改内存，退出时持久化
+    std::map<InodeID, AllocatedSize> sizes;
+    ASSERT_EQ(StoreStatus::OK, storage->LoadAllocSize(&sizes));
+    ASSERT_TRUE(sizes.empty());
+    counter.Stop();
+    bool clean = false;
+    ASSERT_EQ(StoreStatus::OK, storage->GetAllocSizeState(&clean));
+    ASSERT_TRUE(clean);
+
+    // 正常退出后重新加载计数不变
+    AllocSizeCounter counter2(storage, 100000);
+    ASSERT_TRUE(counter2.Init());
+    ASSERT_EQ(StoreStatus::OK, storage->GetAllocSizeState(&clean));
+    ASSERT_FALSE(clean);
+    ASSERT_TRUE(counter2.Get(1, &size));
+    ASSERT_EQ(5, size.allocatedSize);
+    ASSERT_EQ(15, size.physicalAllocatedSize);
+    ASSERT_FALSE(counter2.Get(2, &size));
+}
+
+TEST(AllocSizeCounterTest, BuildWithUpdate) {
+    auto storage = std::make_shared<FakeNameServerStorage>();
+    AllocSizeCounter counter(storage, 100000);
+    ASSERT_TRUE(counter.Init());
+    AllocatedSize size;
+
+    // 统计失败时不记录
+    uint64_t generation = counter.BeginBuild(1);
+    ASSERT_FALSE(counter.EndBuild(1, generation, MakeAllocSize(1, 3), false));
+    ASSERT_FALSE(counter.Get(1, &size));
+
+    // 统计期间开始的更新使统计结果无效，不影响其他inode的统计
+    generation = counter.BeginBuild(1);
+    uint64_t generation2 = counter.BeginBuild(2);
+    counter.BeginUpdate({1});
+    counter.EndUpdate({1});
+    ASSERT_FALSE(counter.EndBuild(1, generation, MakeAllocSize(1, 3), true));
+    ASSERT_FALSE(counter.Get(1, &size));
+    ASSERT_TRUE(counter.EndBuild(2, generation2, MakeAllocSize(2, 6), true));
+    ASSERT_TRUE(counter.Get(2, &size));
+    ASSERT_EQ(2, size.allocatedSize);
+
+    // 统计开始时还未结束的更新同样使统计结果无效
+    counter.BeginUpdate({1});
+    generation = counter.BeginBuild(1);
+    counter.EndUpdate({1});
+    ASSERT_FALSE(counter.EndBuild(1, generation, MakeAllocSize(1, 3), true));
+    ASSERT_FALSE(counter.Get(1, &size));
+
+    // 同一inode的多个统计，删除计数使进行中的统计全部无效
+    generation = counter.BeginBuild(1);
+    generation2 = counter.BeginBuild(1);
+    counter.Invalidate({1});
+    ASSERT_FALSE(counter.EndBuild(1, generation, MakeAllocSize(1, 3), true));
+    ASSERT_FALSE(counter.EndBuild(1, generation2, MakeAllocSize(1, 3), true));
+
+    // 更新结束后开始的统计正常记录
+    Record(&counter, 1, MakeAllocSize(1, 3));
+    ASSERT_TRUE(counter.Get(1, &size));
+    ASSERT_EQ(1, size.allocatedSize);
+    ASSERT_EQ(3, size.physicalAllocatedSize);
+}
+
+TEST(AllocSizeCounterTest, PeriodicPersistAndUncleanRestart) {
+    auto storage = std::make_shared<FakeNameServerStorage>();
+    AllocSizeCounter counter(storage, 10);
+    ASSERT_TRUE(counter.Init());
+    counter.Run();
+
+    // 后台线程定期持久化
+    Record(&counter, 1, MakeAllocSize(10, 30));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::map<InodeID, AllocatedSize> sizes;
+    ASSERT_EQ(StoreStatus::OK, storage->LoadAllocSize(&sizes));
+    ASSERT_EQ(1, sizes.size());
+    ASSERT_EQ(10, sizes[1].allocatedSize);
+
+    // 没有正常退出时重新加载，丢弃计数并从存储中删除
+    AllocSizeCounter counter2(storage, 100000);
+    ASSERT_TRUE(counter2.Init());
+    AllocatedSize size;
+    ASSERT_FALSE(counter2.Get(1, &size));
+    counter2.Run();
+    counter2.Stop();
+    sizes.clear();
+    ASSERT_EQ(StoreStatus::OK, storage->LoadAllocSize(&sizes));
+    ASSERT_TRUE(sizes.empty());
+}
+
+TEST(AllocSizeCounterTest, StorageFail) {
+    auto storage = std::make_shared<MockNameServerStorage>();
+    AllocSizeCounter counter(storage, 10);
+
+    // 加载失败
+    EXPECT_CALL(*storage, LoadAllocSize(_))
+        .WillOnce(Return(StoreStatus::InternalError));
+    ASSERT_FALSE(counter.Init());
+
+    EXPECT_CALL(*storage, LoadAllocSize(_))
+        .WillOnce(Return(StoreStatus::OK));
+    EXPECT_CALL(*storage, GetAllocSizeState(_))
+        .WillOnce(Return(StoreStatus::InternalError));
+    ASSERT_FALSE(counter.Init());
+
+    EXPECT_CALL(*storage, LoadAllocSize(_))
+        .WillOnce(Return(StoreStatus::OK));
+    EXPECT_CALL(*storage, GetAllocSizeState(_))
+        .WillOnce(Return(StoreStatus::KeyNotExist));
+    EXPECT_CALL(*storage, PutAllocSizeState(false))
+        .WillOnce(Return(StoreStatus::InternalError));
+    ASSERT_FALSE(counter.Init());
+
+    std::map<InodeID, AllocatedSize> sizes;
+    sizes[1] = MakeAllocSize(10, 30);
+    sizes[2] = MakeAllocSize(4, 12);
+    EXPECT_CALL(*storage, LoadAllocSize(_))
+        .WillOnce(DoAll(SetArgPointee<0>(sizes), Return(StoreStatus::OK)));
+    EXPECT_CALL(*storage, GetAllocSizeState(_))
+        .WillOnce(DoAll(SetArgPointee<0>(true), Return(StoreStatus::OK)));
+    EXPECT_CALL(*storage, PutAllocSizeState(false))
+        .WillOnce(Return(StoreStatus::OK));
+    ASSERT_TRUE(counter.Init());
+
+    // 持久化失败的计数下一轮重试
+    EXPECT_CALL(*storage, PutAllocSize(1, _))
+        .Times(2)
+        .WillOnce(Return(StoreStatus::InternalError))
+        .WillOnce(Return(StoreStatus::OK));
+    EXPECT_CALL(*storage, PutAllocSize(2, _))
+        .WillOnce(Return(StoreStatus::OK));
+    counter.Add({1, 2}, MakeAllocSize(1, 3));
+    counter.Run();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    AllocatedSize size;
+    ASSERT_TRUE(counter.Get(1, &size));
+    ASSERT_EQ(11, size.allocatedSize);
+    ASSERT_EQ(33, size.physicalAllocatedSize);
+
+    // 退出时持久化失败，不标记为正常退出
+    EXPECT_CALL(*storage, DeleteAllocSize(2))
+        .WillRepeatedly(Return(StoreStatus::InternalError));
+    EXPECT_CALL(*storage, PutAllocSizeState(true)).Times(0);
+    counter.Invalidate({2});
+    counter.Stop();
+}
+
+}  // namespace mds
+}  // namespace curve
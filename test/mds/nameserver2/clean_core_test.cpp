@@ -28,11 +28,17 @@
 #include "test/mds/mock/mock_topology.h"
 #include "src/mds/chunkserverclient/copyset_client.h"
 #include "test/mds/mock/mock_alloc_statistic.h"
+#include "test/mds/chunkserverclient/mock_chunkserverclient.h"
 
 using ::testing::_;
 using ::testing::Return;
+using ::testing::DoAll;
+using ::testing::SetArgPointee;
+using ::testing::Invoke;
+using ::testing::AtMost;
 using curve::mds::topology::MockTopology;
 using ::curve::mds::chunkserverclient::ChunkServerClientOption;
+using ::curve::mds::chunkserverclient::MockChunkServerClient;
 
 namespace curve {
 namespace mds {
@@ -264,5 +270,293 @@ TEST(CleanCore, testcleanfile) {
         ASSERT_EQ(progress.GetStatus(), TaskStatus::FAILED);
     }
 }
+
+TEST(CleanCore, testcleanfileconcurrently) {
+    auto storage = std::make_shared<MockNameServerStorage>();
+    auto topology = std::make_shared<MockTopology>();
+    ChunkServerClientOption option;
+    auto channelPool = std::make_shared<ChannelPool>();
+    auto client = std::make_shared<CopysetClient>(topology,
+                                                  option, channelPool);
+    auto csClient = std::make_shared<MockChunkServerClient>(topology,
+                                                  option, channelPool);
+    client->SetChunkServerClient(csClient);
+    auto allocStatistic = std::make_shared<MockAllocStatistic>();
+    CleanCoreOption cleanOption;
+    cleanOption.concurrency = 4;
+    cleanOption.chunkserverConcurrency = 2;
+    cleanOption.maxChunksPerSecond = 1000;
+    auto cleanCore = std::make_shared<CleanCore>(storage, client,
+        allocStatistic, cleanOption, topology);
+
+    // 第一个segment有16个chunk，都在leader为1的copyset上
+    uint32_t chunkNum = 16;
+    PageFileSegment segment;
+    segment.set_logicalpoolid(1);
+    segment.set_segmentsize(DefaultSegmentSize);
+    segment.set_chunksize(16 * kMB);
+    segment.set_startoffset(0);
+    for (uint32_t i = 0; i < chunkNum; i++) {
+        auto chunk = segment.add_chunks();
+        chunk->set_copysetid(1);
+        chunk->set_chunkid(i);
+    }
+    ::curve::mds::topology::CopySetInfo copyset(1, 1);
+    copyset.SetLeader(1);
+    EXPECT_CALL(*topology, GetCopySet(_, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copyset), Return(true)));
+
+    FileInfo cleanFile;
+    cleanFile.set_length(kMiniFileLength);
+    cleanFile.set_segmentsize(DefaultSegmentSize);
+    uint32_t segmentNum = kMiniFileLength / DefaultSegmentSize;
+
+    {
+        // 所有chunk删除成功之后删除segment，同一个chunkserver上并发不超过2
+        EXPECT_CALL(*storage, GetSegment(_, 0, _))
+            .WillOnce(DoAll(SetArgPointee<2>(segment),
+                Return(StoreStatus::OK)));
+        for (uint32_t i = 1; i < segmentNum; i++) {
+            EXPECT_CALL(*storage, GetSegment(_, i * DefaultSegmentSize, _))
+                .WillOnce(Return(StoreStatus::KeyNotExist));
+        }
+        std::atomic<uint32_t> inflight(0);
+        std::atomic<uint32_t> maxInflight(0);
+        EXPECT_CALL(*csClient, DeleteChunk(1, 1, 1, _, _))
+            .Times(chunkNum)
+            .WillRepeatedly(Invoke([&](ChunkServerIdType, LogicalPoolID,
+                                       CopysetID, ChunkID, uint64_t) {
+                uint32_t cur = ++inflight;
+                uint32_t max = maxInflight.load();
+                while (cur > max &&
+                    !maxInflight.compare_exchange_weak(max, cur)) {}
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                --inflight;
+                return kMdsSuccess;
+            }));
+        EXPECT_CALL(*storage, DeleteSegment(_, 0, _))
+            .WillOnce(Return(StoreStatus::OK));
+        EXPECT_CALL(*allocStatistic, DeAllocSpace(_, _, _)).Times(1);
+        EXPECT_CALL(*storage, DeleteFile(_, _))
+            .WillOnce(Return(StoreStatus::OK));
+
+        TaskProgress progress;
+        ASSERT_EQ(StatusCode::kOK,
+            cleanCore->CleanFile(cleanFile, &progress));
+        ASSERT_EQ(TaskStatus::SUCCESS, progress.GetStatus());
+        ASSERT_EQ(100, progress.GetProgress());
+        ASSERT_LE(maxInflight.load(), 2);
+    }
+
+    {
+        // 有chunk删除失败时不删除segment，重新执行时从该segment开始
+        EXPECT_CALL(*storage, GetSegment(_, 0, _))
+            .WillOnce(DoAll(SetArgPointee<2>(segment),
+                Return(StoreStatus::OK)));
+        EXPECT_CALL(*csClient, DeleteChunk(1, 1, 1, _, _))
+            .Times(AtMost(chunkNum))
+            .WillOnce(Return(kCsClientInternalError))
+            .WillRepeatedly(Return(kMdsSuccess));
+        EXPECT_CALL(*storage, DeleteSegment(_, _, _)).Times(0);
+        EXPECT_CALL(*storage, DeleteFile(_, _)).Times(0);
+
+        TaskProgress progress;
+        ASSERT_EQ(StatusCode::kCommonFileDeleteError,
+            cleanCore->CleanFile(cleanFile, &progress));
+        ASSERT_EQ(TaskStatus::FAILED, progress.GetStatus());
+    }
+}
+
+TEST(CleanCore, testcleanfileinbatch) {
+    auto storage = std::make_shared<MockNameServerStorage>();
+    auto topology = std::make_shared<MockTopology>();
+    ChunkServerClientOption option;
+    auto channelPool = std::make_shared<ChannelPool>();
+    auto client = std::make_shared<CopysetClient>(topology,
+                                                  option, channelPool);
+    auto csClient = std::make_shared<MockChunkServerClient>(topology,
+                                                  option, channelPool);
+    client->SetChunkServerClient(csClient);
+    auto allocStatistic = std::make_shared<MockAllocStatistic>();
+    CleanCoreOption cleanOption;
+    cleanOption.deleteBatchSize = 5;
+    auto cleanCore = std::make_shared<CleanCore>(storage, client,
+        allocStatistic, cleanOption, topology);
+
+    // segment有16个chunk，交替分布在copyset 1和copyset 2上
+    uint32_t chunkNum = 16;
+    PageFileSegment segment;
+    segment.set_logicalpoolid(1);
+    segment.set_segmentsize(DefaultSegmentSize);
+    segment.set_chunksize(16 * kMB);
+    segment.set_startoffset(0);
+    for (uint32_t i = 0; i < chunkNum; i++) {
+        auto chunk = segment.add_chunks();
+        chunk->set_copysetid(i % 2 + 1);
+        chunk->set_chunkid(i);
+    }
+    ::curve::mds::topology::CopySetInfo copyset(1, 1);
+    copyset.SetLeader(1);
+    EXPECT_CALL(*topology, GetCopySet(_, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copyset), Return(true)));
+
+    FileInfo cleanFile;
+    cleanFile.set_length(kMiniFileLength);
+    cleanFile.set_segmentsize(DefaultSegmentSize);
+    uint32_t segmentNum = kMiniFileLength / DefaultSegmentSize;
+
+    // 第二个segment的chunk同样交替分布在copyset 1和copyset 2上
+    PageFileSegment segment2 = segment;
+    segment2.set_startoffset(DefaultSegmentSize);
+    for (uint32_t i = 0; i < chunkNum; i++) {
+        segment2.mutable_chunks(i)->set_chunkid(chunkNum + i);
+    }
+
+    {
+        // 两个segment在同一个窗口中，每个copyset有16个chunk，
+        // 跨segment按5个一组批量删除
+        EXPECT_CALL(*storage, GetSegment(_, 0, _))
+            .WillOnce(DoAll(SetArgPointee<2>(segment),
+                Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage, GetSegment(_, DefaultSegmentSize, _))
+            .WillOnce(DoAll(SetArgPointee<2>(segment2),
+                Return(StoreStatus::OK)));
+        for (uint32_t i = 2; i < segmentNum; i++) {
+            EXPECT_CALL(*storage, GetSegment(_, i * DefaultSegmentSize, _))
+                .WillOnce(Return(StoreStatus::KeyNotExist));
+        }
+        EXPECT_CALL(*csClient, DeleteChunk(_, _, _, _, _)).Times(0);
+        EXPECT_CALL(*csClient, DeleteChunks(1, 1, 1,
+                std::vector<ChunkID>({0, 2, 4, 6, 8}), _))
+            .WillOnce(Return(kMdsSuccess));
+        EXPECT_CALL(*csClient, DeleteChunks(1, 1, 1,
+                std::vector<ChunkID>({10, 12, 14, 16, 18}), _))
+            .WillOnce(Return(kMdsSuccess));
+        EXPECT_CALL(*csClient, DeleteChunks(1, 1, 1,
+                std::vector<ChunkID>({20, 22, 24, 26, 28}), _))
+            .WillOnce(Return(kMdsSuccess));
+        EXPECT_CALL(*csClient, DeleteChunks(1, 1, 1,
+                std::vector<ChunkID>({30}), _))
+            .WillOnce(Return(kMdsSuccess));
+        EXPECT_CALL(*csClient, DeleteChunks(1, 1, 2,
+                std::vector<ChunkID>({1, 3, 5, 7, 9}), _))
+            .WillOnce(Return(kMdsSuccess));
+        EXPECT_CALL(*csClient, DeleteChunks(1, 1, 2,
+                std::vector<ChunkID>({11, 13, 15, 17, 19}), _))
+            .WillOnce(Return(kMdsSuccess));
+        EXPECT_CALL(*csClient, DeleteChunks(1, 1, 2,
+                std::vector<ChunkID>({21, 23, 25, 27, 29}), _))
+            .WillOnce(Return(kMdsSuccess));
+        EXPECT_CALL(*csClient, DeleteChunks(1, 1, 2,
+                std::vector<ChunkID>({31}), _))
+            .WillOnce(Return(kMdsSuccess));
+        EXPECT_CALL(*storage, DeleteSegment(_, 0, _))
+            .WillOnce(Return(StoreStatus::OK));
+        EXPECT_CALL(*storage, DeleteSegment(_, DefaultSegmentSize, _))
+            .WillOnce(Return(StoreStatus::OK));
+        EXPECT_CALL(*allocStatistic, DeAllocSpace(_, _, _)).Times(2);
+        EXPECT_CALL(*storage, DeleteFile(_, _))
+            .WillOnce(Return(StoreStatus::OK));
+
+        TaskProgress progress;
+        ASSERT_EQ(StatusCode::kOK,
+            cleanCore->CleanFile(cleanFile, &progress));
+        ASSERT_EQ(TaskStatus::SUCCESS, progress.GetStatus());
+    }
+
+    {
+        // 窗口中有chunk删除失败时不删除窗口中的任何segment
+        EXPECT_CALL(*storage, GetSegment(_, 0, _))
+            .WillOnce(DoAll(SetArgPointee<2>(segment),
+                Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage, GetSegment(_, DefaultSegmentSize, _))
+            .WillOnce(DoAll(SetArgPointee<2>(segment2),
+                Return(StoreStatus::OK)));
+        for (uint32_t i = 2; i < segmentNum; i++) {
+            EXPECT_CALL(*storage, GetSegment(_, i * DefaultSegmentSize, _))
+                .WillOnce(Return(StoreStatus::KeyNotExist));
+        }
+        EXPECT_CALL(*csClient, DeleteChunks(1, 1, 1, _, _))
+            .WillOnce(Return(kCsClientReturnFail));
+        EXPECT_CALL(*storage, DeleteSegment(_, _, _)).Times(0);
+        EXPECT_CALL(*storage, DeleteFile(_, _)).Times(0);
+
+        TaskProgress progress;
+        ASSERT_EQ(StatusCode::kCommonFileDeleteError,
+            cleanCore->CleanFile(cleanFile, &progress));
+        ASSERT_EQ(TaskStatus::FAILED, progress.GetStatus());
+    }
+}
+
+TEST(CleanCore, testcleansegment) {
+    auto storage = std::make_shared<MockNameServerStorage>();
+    auto topology = std::make_shared<MockTopology>();
+    ChunkServerClientOption option;
+    auto channelPool = std::make_shared<ChannelPool>();
+    auto client = std::make_shared<CopysetClient>(topology,
+                                                  option, channelPool);
+    auto csClient = std::make_shared<MockChunkServerClient>(topology,
+                                                  option, channelPool);
+    client->SetChunkServerClient(csClient);
+    auto allocStatistic = std::make_shared<MockAllocStatistic>();
+    auto cleanCore = std::make_shared<CleanCore>(storage,
+                                                 client, allocStatistic);
+
+    PageFileSegment segment;
+    segment.set_logicalpoolid(1);
+    segment.set_segmentsize(DefaultSegmentSize);
+    segment.set_chunksize(16 * kMB);
+    segment.set_startoffset(DefaultSegmentSize);
+    for (uint32_t i = 0; i < 2; i++) {
+        auto chunk = segment.add_chunks();
+        chunk->set_copysetid(1);
+        chunk->set_chunkid(i);
+    }
+    ::curve::mds::topology::CopySetInfo copyset(1, 1);
+    copyset.SetLeader(1);
+    EXPECT_CALL(*topology, GetCopySet(_, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copyset), Return(true)));
+
+    FileInfo cleanFile;
+    cleanFile.set_id(1);
+    cleanFile.set_length(kMiniFileLength);
+    cleanFile.set_segmentsize(DefaultSegmentSize);
+
+    {
+        // chunk全部删除之后再删除segment并释放空间
+        ::testing::InSequence s;
+        EXPECT_CALL(*csClient, DeleteChunk(1, 1, 1, 0, _))
+            .WillOnce(Return(kMdsSuccess));
+        EXPECT_CALL(*csClient, DeleteChunk(1, 1, 1, 1, _))
+            .WillOnce(Return(kMdsSuccess));
+        EXPECT_CALL(*storage, DeleteSegment(1, DefaultSegmentSize, _))
+            .WillOnce(Return(StoreStatus::OK));
+        EXPECT_CALL(*allocStatistic, DeAllocSpace(1, DefaultSegmentSize, _))
+            .Times(1);
+        ASSERT_EQ(StatusCode::kOK, cleanCore->CleanSegment(cleanFile, segment));
+    }
+
+    {
+        // chunk删除失败时不删除segment
+        EXPECT_CALL(*csClient, DeleteChunk(1, 1, 1, 0, _))
+            .WillOnce(Return(kCsClientReturnFail));
+        EXPECT_CALL(*storage, DeleteSegment(_, _, _)).Times(0);
+        EXPECT_CALL(*allocStatistic, DeAllocSpace(_, _, _)).Times(0);
+        ASSERT_EQ(StatusCode::kCommonFileDeleteError,
+                  cleanCore->CleanSegment(cleanFile, segment));
+    }
+
+    {
+        // 删除segment元数据失败时不释放空间
+        EXPECT_CALL(*csClient, DeleteChunk(1, 1, 1, _, _))
+            .Times(2)
+            .WillRepeatedly(Return(kMdsSuccess));
+        EXPECT_CALL(*storage, DeleteSegment(1, DefaultSegmentSize, _))
+            .WillOnce(Return(StoreStatus::InternalError));
+        EXPECT_CALL(*allocStatistic, DeAllocSpace(_, _, _)).Times(0);
+        ASSERT_EQ(StatusCode::kCommonFileDeleteError,
+                  cleanCore->CleanSegment(cleanFile, segment));
+    }
+}
 }  // namespace mds
 }  // namespace curve
@@ -275,6 +275,88 @@ TEST_F(CurveFSTest, testGetFileInfo) {
     }
 }
 
+TEST_F(CurveFSTest, testGetFileInfoWithDirPathCache) {
+    // 打开WalkPath的目录缓存重新初始化
+    curvefs_->Uninit();
+    curveFSOptions_.dirPathCacheCount = 100;
+    FileInfo recycleBin;
+    recycleBin.set_parentid(ROOTINODEID);
+    recycleBin.set_id(RECYCLEBININODEID);
+    recycleBin.set_filename(RECYCLEBINDIRNAME);
+    recycleBin.set_filetype(FileType::INODE_DIRECTORY);
+    recycleBin.set_owner(authOptions_.rootOwner);
+    EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(recycleBin),
+            Return(StoreStatus::OK)));
+    ASSERT_TRUE(curvefs_->Init(storage_, inodeIdGenerator_,
+                               mockChunkAllocator_, mockcleanManager_,
+                               fileRecordManager_, allocStatistic_,
+                               curveFSOptions_, topology_));
+
+    FileInfo dir1;
+    dir1.set_parentid(ROOTINODEID);
+    dir1.set_id(10);
+    dir1.set_filename("dir1");
+    dir1.set_filetype(FileType::INODE_DIRECTORY);
+    FileInfo dir2;
+    dir2.set_parentid(10);
+    dir2.set_id(11);
+    dir2.set_filename("dir2");
+    dir2.set_filetype(FileType::INODE_DIRECTORY);
+    FileInfo file1;
+    file1.set_parentid(11);
+    file1.set_id(12);
+    file1.set_filename("file1");
+    file1.set_filetype(FileType::INODE_PAGEFILE);
+
+    // 1. 第一次逐级查询存储，并缓存每一级目录
+    EXPECT_CALL(*storage_, GetFile(ROOTINODEID, StrEq("dir1"), _))
+        .WillOnce(DoAll(SetArgPointee<2>(dir1), Return(StoreStatus::OK)));
+    EXPECT_CALL(*storage_, GetFile(10, StrEq("dir2"), _))
+        .WillOnce(DoAll(SetArgPointee<2>(dir2), Return(StoreStatus::OK)));
+    EXPECT_CALL(*storage_, GetFile(11, StrEq("file1"), _))
+        .Times(3)
+        .WillRepeatedly(DoAll(SetArgPointee<2>(file1),
+            Return(StoreStatus::OK)));
+    FileInfo fileInfo;
+    ASSERT_EQ(StatusCode::kOK,
+        curvefs_->GetFileInfo("/dir1/dir2/file1", &fileInfo));
+    ASSERT_EQ(12, fileInfo.id());
+
+    // 2. 父目录命中缓存，只查询最后一级
+    ASSERT_EQ(StatusCode::kOK,
+        curvefs_->GetFileInfo("/dir1/dir2/file1", &fileInfo));
+    ASSERT_EQ(12, fileInfo.id());
+
+    // 3. 中间目录已经缓存，只查询不在缓存中的部分
+    EXPECT_CALL(*storage_, GetFile(10, StrEq("file2"), _))
+        .WillOnce(Return(StoreStatus::KeyNotExist));
+    ASSERT_EQ(StatusCode::kFileNotExists,
+        curvefs_->GetFileInfo("/dir1/file2", &fileInfo));
+
+    // 4. 删除目录之后缓存失效，重新查询存储
+    FileInfo dir3;
+    dir3.set_parentid(ROOTINODEID);
+    dir3.set_id(13);
+    dir3.set_filename("dir3");
+    dir3.set_filetype(FileType::INODE_DIRECTORY);
+    EXPECT_CALL(*storage_, GetFile(ROOTINODEID, StrEq("dir3"), _))
+        .WillOnce(DoAll(SetArgPointee<2>(dir3), Return(StoreStatus::OK)));
+    EXPECT_CALL(*storage_, ListFile(_, _, _))
+        .WillOnce(Return(StoreStatus::OK));
+    EXPECT_CALL(*storage_, DeleteFile(_, _))
+        .WillOnce(Return(StoreStatus::OK));
+    ASSERT_EQ(StatusCode::kOK, curvefs_->DeleteFile("/dir3", 0, false));
+
+    EXPECT_CALL(*storage_, GetFile(ROOTINODEID, StrEq("dir1"), _))
+        .WillOnce(DoAll(SetArgPointee<2>(dir1), Return(StoreStatus::OK)));
+    EXPECT_CALL(*storage_, GetFile(10, StrEq("dir2"), _))
+        .WillOnce(DoAll(SetArgPointee<2>(dir2), Return(StoreStatus::OK)));
+    ASSERT_EQ(StatusCode::kOK,
+        curvefs_->GetFileInfo("/dir1/dir2/file1", &fileInfo));
+    ASSERT_EQ(12, fileInfo.id());
+}
+
 TEST_F(CurveFSTest, testDeleteFile) {
     // test remove root
     ASSERT_EQ(curvefs_->DeleteFile("/", kUnitializedFileID, false),
@@ -716,6 +798,114 @@ TEST_F(CurveFSTest, testGetAllocatedSize) {
     }
 }
 
+TEST_F(CurveFSTest, testGetAllocatedSizeWithCounter) {
+    // 开启分配大小计数重新初始化
+    curvefs_->Uninit();
+    curveFSOptions_.enableAllocSizeCounter = true;
+    FileInfo recycleBin;
+    recycleBin.set_parentid(ROOTINODEID);
+    recycleBin.set_id(RECYCLEBININODEID);
+    recycleBin.set_filename(RECYCLEBINDIRNAME);
+    recycleBin.set_filetype(FileType::INODE_DIRECTORY);
+    recycleBin.set_owner(authOptions_.rootOwner);
+    EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(recycleBin),
+            Return(StoreStatus::OK)));
+    EXPECT_CALL(*storage_, LoadAllocSize(_))
+        .WillOnce(Return(StoreStatus::OK));
+    EXPECT_CALL(*storage_, GetAllocSizeState(_))
+        .WillOnce(DoAll(SetArgPointee<0>(true), Return(StoreStatus::OK)));
+    EXPECT_CALL(*storage_, PutAllocSizeState(false))
+        .WillOnce(Return(StoreStatus::OK));
+    ASSERT_TRUE(curvefs_->Init(storage_, inodeIdGenerator_,
+                               mockChunkAllocator_, mockcleanManager_,
+                               fileRecordManager_, allocStatistic_,
+                               curveFSOptions_, topology_));
+
+    uint64_t segmentSize = DefaultSegmentSize;
+    FileInfo dirInfo;
+    dirInfo.set_parentid(ROOTINODEID);
+    dirInfo.set_id(5);
+    dirInfo.set_filename("dir1");
+    dirInfo.set_filetype(FileType::INODE_DIRECTORY);
+    FileInfo fileInfo;
+    fileInfo.set_parentid(5);
+    fileInfo.set_id(10);
+    fileInfo.set_filename("file1");
+    fileInfo.set_filetype(FileType::INODE_PAGEFILE);
+    fileInfo.set_length(4 * segmentSize);
+    fileInfo.set_segmentsize(segmentSize);
+    fileInfo.set_filestatus(FileStatus::kFileCreated);
+    EXPECT_CALL(*storage_, GetFile(ROOTINODEID, "dir1", _))
+        .WillRepeatedly(DoAll(SetArgPointee<2>(dirInfo),
+            Return(StoreStatus::OK)));
+    EXPECT_CALL(*storage_, GetFile(5, "file1", _))
+        .WillRepeatedly(DoAll(SetArgPointee<2>(fileInfo),
+            Return(StoreStatus::OK)));
+
+    std::vector<PageFileSegment> segments;
+    for (int i = 0; i < 2; ++i) {
+        PageFileSegment segment;
+        segment.set_logicalpoolid(1);
+        segment.set_segmentsize(segmentSize);
+        segment.set_startoffset(i * segmentSize);
+        segments.emplace_back(segment);
+    }
+    LogicalPool lgPool;
+    LogicalPool::RedundanceAndPlaceMentPolicy rap;
+    rap.pageFileRAP.replicaNum = 3;
+    lgPool.SetRedundanceAndPlaceMentPolicy(rap);
+    EXPECT_CALL(*topology_, GetLogicalPool(_, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(lgPool), Return(true)));
+
+    // 第一次查询遍历目录统计，并记录目录和文件的分配大小
+    {
+        std::vector<FileInfo> files{fileInfo};
+        EXPECT_CALL(*storage_, ListFile(5, 6, _))
+            .WillOnce(DoAll(SetArgPointee<2>(files),
+                Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, ListSegment(10, _))
+            .WillOnce(DoAll(SetArgPointee<1>(segments),
+                Return(StoreStatus::OK)));
+        // 计数只更新内存，由后台线程定期持久化
+        EXPECT_CALL(*storage_, PutAllocSize(_, _)).Times(0);
+        AllocatedSize allocSize;
+        ASSERT_EQ(StatusCode::kOK,
+                  curvefs_->GetAllocatedSize("/dir1", &allocSize));
+        ASSERT_EQ(2 * segmentSize, allocSize.allocatedSize);
+        ASSERT_EQ(6 * segmentSize, allocSize.physicalAllocatedSize);
+    }
+
+    // 分配segment之后增量更新文件和目录的计数，根目录没有记录不更新
+    {
+        EXPECT_CALL(*storage_, GetSegment(10, 2 * segmentSize, _))
+            .WillOnce(Return(StoreStatus::KeyNotExist));
+        EXPECT_CALL(*mockChunkAllocator_,
+                    AllocateChunkSegment(_, _, _, _, _))
+            .WillOnce(DoAll(SetArgPointee<4>(segments[0]), Return(true)));
+        EXPECT_CALL(*storage_, PutSegment(10, 2 * segmentSize, _, _))
+            .WillOnce(Return(StoreStatus::OK));
+        PageFileSegment segment;
+        ASSERT_EQ(StatusCode::kOK, curvefs_->GetOrAllocateSegment(
+            "/dir1/file1", 2 * segmentSize, true, &segment));
+    }
+
+    // 再次查询直接返回计数，不再遍历目录和segment
+    {
+        EXPECT_CALL(*storage_, ListFile(_, _, _)).Times(0);
+        EXPECT_CALL(*storage_, ListSegment(_, _)).Times(0);
+        AllocatedSize allocSize;
+        ASSERT_EQ(StatusCode::kOK,
+                  curvefs_->GetAllocatedSize("/dir1", &allocSize));
+        ASSERT_EQ(3 * segmentSize, allocSize.allocatedSize);
+        ASSERT_EQ(9 * segmentSize, allocSize.physicalAllocatedSize);
+        ASSERT_EQ(StatusCode::kOK,
+                  curvefs_->GetAllocatedSize("/dir1/file1", &allocSize));
+        ASSERT_EQ(3 * segmentSize, allocSize.allocatedSize);
+        ASSERT_EQ(9 * segmentSize, allocSize.physicalAllocatedSize);
+    }
+}
+
 TEST_F(CurveFSTest, testReadDir) {
     FileInfo fileInfo;
     std::vector<FileInfo> items;
@@ -1621,6 +1811,150 @@ TEST_F(CurveFSTest, testGetOrAllocateSegment) {
     }
 }
 
+TEST_F(CurveFSTest, testDeAllocateSegment) {
+    FileInfo dirInfo;
+    dirInfo.set_filetype(FileType::INODE_DIRECTORY);
+
+    FileInfo fileInfo;
+    fileInfo.set_filetype(FileType::INODE_PAGEFILE);
+    fileInfo.set_length(kMiniFileLength);
+    fileInfo.set_segmentsize(DefaultSegmentSize);
+    fileInfo.set_filestatus(FileStatus::kFileCreated);
+
+    // test normal deallocate exist segment
+    {
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<2>(dirInfo),
+                        Return(StoreStatus::OK)))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo),
+                        Return(StoreStatus::OK)));
+
+        EXPECT_CALL(*storage_, ListSnapshotFile(_, _, _))
+        .Times(1)
+        .WillOnce(Return(StoreStatus::OK));
+
+        PageFileSegment segment;
+        segment.set_logicalpoolid(1);
+        segment.set_segmentsize(DefaultSegmentSize);
+        EXPECT_CALL(*storage_, GetSegment(_, _, _))
+        .Times(1)
+        .WillOnce(DoAll(SetArgPointee<2>(segment),
+                        Return(StoreStatus::OK)));
+
+        // chunk和segment元数据由cleanManager删除
+        EXPECT_CALL(*mockcleanManager_, CleanSegment(_, _))
+        .Times(1)
+        .WillOnce(Return(StatusCode::kOK));
+
+        EXPECT_CALL(*storage_, DeleteSegment(_, _, _))
+        .Times(0);
+
+        ASSERT_EQ(StatusCode::kOK,
+                  curvefs_->DeAllocateSegment("/user1/file2", 0));
+    }
+
+    // segment not exist
+    {
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<2>(dirInfo),
+                        Return(StoreStatus::OK)))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo),
+                        Return(StoreStatus::OK)));
+
+        EXPECT_CALL(*storage_, ListSnapshotFile(_, _, _))
+        .Times(1)
+        .WillOnce(Return(StoreStatus::OK));
+
+        EXPECT_CALL(*storage_, GetSegment(_, _, _))
+        .Times(1)
+        .WillOnce(Return(StoreStatus::KeyNotExist));
+
+        EXPECT_CALL(*mockcleanManager_, CleanSegment(_, _))
+        .Times(0);
+
+        ASSERT_EQ(StatusCode::kOK,
+                  curvefs_->DeAllocateSegment("/user1/file2", 0));
+    }
+
+    // offset not align with segment
+    {
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<2>(dirInfo),
+                        Return(StoreStatus::OK)))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo),
+                        Return(StoreStatus::OK)));
+
+        ASSERT_EQ(StatusCode::kParaError,
+                  curvefs_->DeAllocateSegment("/user1/file2", 1));
+    }
+
+    // file is being cloned
+    {
+        FileInfo cloneSource = fileInfo;
+        cloneSource.set_filestatus(FileStatus::kFileBeingCloned);
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<2>(dirInfo),
+                        Return(StoreStatus::OK)))
+        .WillOnce(DoAll(SetArgPointee<2>(cloneSource),
+                        Return(StoreStatus::OK)));
+
+        ASSERT_EQ(StatusCode::kNotSupported,
+                  curvefs_->DeAllocateSegment("/user1/file2", 0));
+    }
+
+    // file has snapshot
+    {
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<2>(dirInfo),
+                        Return(StoreStatus::OK)))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo),
+                        Return(StoreStatus::OK)));
+
+        std::vector<FileInfo> snapShotFiles;
+        snapShotFiles.push_back(fileInfo);
+        EXPECT_CALL(*storage_, ListSnapshotFile(_, _, _))
+        .Times(1)
+        .WillOnce(DoAll(SetArgPointee<2>(snapShotFiles),
+                        Return(StoreStatus::OK)));
+
+        EXPECT_CALL(*storage_, GetSegment(_, _, _))
+        .Times(0);
+
+        ASSERT_EQ(StatusCode::kFileUnderSnapShot,
+                  curvefs_->DeAllocateSegment("/user1/file2", 0));
+    }
+
+    // clean segment fail
+    {
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<2>(dirInfo),
+                        Return(StoreStatus::OK)))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo),
+                        Return(StoreStatus::OK)));
+
+        EXPECT_CALL(*storage_, ListSnapshotFile(_, _, _))
+        .Times(1)
+        .WillOnce(Return(StoreStatus::OK));
+
+        EXPECT_CALL(*storage_, GetSegment(_, _, _))
+        .Times(1)
+        .WillOnce(Return(StoreStatus::OK));
+
+        EXPECT_CALL(*mockcleanManager_, CleanSegment(_, _))
+        .Times(1)
+        .WillOnce(Return(StatusCode::kCommonFileDeleteError));
+
+        ASSERT_EQ(StatusCode::kCommonFileDeleteError,
+                  curvefs_->DeAllocateSegment("/user1/file2", 0));
+    }
+}
+
 TEST_F(CurveFSTest, testCreateSnapshotFile) {
     {
         // test client time not expired
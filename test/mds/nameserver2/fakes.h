@@ -38,6 +38,9 @@
 
 using ::curve::mds::topology::TopologyChunkAllocator;
 using ::curve::common::SNAPSHOTFILEINFOKEYPREFIX;
+using ::curve::common::ALLOCSIZEKEYPREFIX;
+using ::curve::common::ALLOCSIZEKEYEND;
+using ::curve::common::ALLOCSIZESTATEKEY;
 
 const uint64_t FACK_INODE_INITIALIZE = 0;
 const uint64_t FACK_CHUNKID_INITIALIZE = 0;
@@ -411,6 +414,58 @@ class FakeNameServerStorage : public NameServerStorage {
         return StoreStatus::OK;
     }
 
+    StoreStatus PutAllocSize(InodeID id,
+                             const AllocatedSize &allocSize) override {
+        std::lock_guard<std::mutex> guard(lock_);
+        std::string storeKey = NameSpaceStorageCodec::EncodeAllocSizeKey(id);
+        memKvMap_[storeKey] =
+            NameSpaceStorageCodec::EncodeAllocSizeValue(id, allocSize);
+        return StoreStatus::OK;
+    }
+
+    StoreStatus DeleteAllocSize(InodeID id) override {
+        std::lock_guard<std::mutex> guard(lock_);
+        memKvMap_.erase(NameSpaceStorageCodec::EncodeAllocSizeKey(id));
+        return StoreStatus::OK;
+    }
+
+    StoreStatus LoadAllocSize(
+        std::map<InodeID, AllocatedSize> *allocSizes) override {
+        std::lock_guard<std::mutex> guard(lock_);
+        auto iter = memKvMap_.lower_bound(ALLOCSIZEKEYPREFIX);
+        auto end = memKvMap_.lower_bound(ALLOCSIZEKEYEND);
+        for (; iter != end; iter++) {
+            InodeID id;
+            AllocatedSize allocSize;
+            if (!NameSpaceStorageCodec::DecodeAllocSizeValue(
+                    iter->second, &id, &allocSize)) {
+                return StoreStatus::InternalError;
+            }
+            (*allocSizes)[id] = allocSize;
+        }
+        return StoreStatus::OK;
+    }
+
+    StoreStatus PutAllocSizeState(bool clean) override {
+        std::lock_guard<std::mutex> guard(lock_);
+        memKvMap_[ALLOCSIZESTATEKEY] =
+            NameSpaceStorageCodec::EncodeAllocSizeStateValue(clean);
+        return StoreStatus::OK;
+    }
+
+    StoreStatus GetAllocSizeState(bool *clean) override {
+        std::lock_guard<std::mutex> guard(lock_);
+        auto iter = memKvMap_.find(ALLOCSIZESTATEKEY);
+        if (iter == memKvMap_.end()) {
+            return StoreStatus::KeyNotExist;
+        }
+        if (!NameSpaceStorageCodec::DecodeAllocSizeStateValue(
+                iter->second, clean)) {
+            return StoreStatus::InternalError;
+        }
+        return StoreStatus::OK;
+    }
+
  private:
     std::mutex lock_;
     std::map<std::string, std::string> memKvMap_;
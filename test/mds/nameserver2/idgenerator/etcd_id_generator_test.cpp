@@ -164,5 +164,93 @@ TEST_F(TestEtcdIdGenerator, test_multiclient) {
     ASSERT_TRUE(etcdIdGen_->GenID(&res));
     ASSERT_EQ(2501, res);
 }
+
+TEST_F(TestEtcdIdGenerator, test_prefetch) {
+    IdGeneratorOption option;
+    option.enablePrefetch = true;
+    option.maxBundleSize = bundle_;
+    etcdIdGen_ = std::make_shared<EtcdIdGenerator>(
+        client_, storeKey_, initial_, bundle_, option);
+
+    // bundle大小固定时，预取与同步申请的顺序一致
+    uint64_t alloc1 = initial_ + bundle_;
+    uint64_t alloc2 = alloc1 + bundle_;
+    uint64_t alloc3 = alloc2 + bundle_;
+    std::string strAlloc1 = NameSpaceStorageCodec::EncodeID(alloc1);
+    std::string strAlloc2 = NameSpaceStorageCodec::EncodeID(alloc2);
+    EXPECT_CALL(*client_, Get(storeKey_, _))
+        .WillOnce(Return(EtcdErrCode::EtcdKeyNotExist))
+        .WillOnce(
+            DoAll(SetArgPointee<1>(strAlloc1), Return(EtcdErrCode::EtcdOK)))
+        .WillOnce(
+            DoAll(SetArgPointee<1>(strAlloc2), Return(EtcdErrCode::EtcdOK)));
+    EXPECT_CALL(*client_, CompareAndSwap(
+        storeKey_, "", NameSpaceStorageCodec::EncodeID(alloc1)))
+        .WillOnce(Return(EtcdErrCode::EtcdOK));
+    EXPECT_CALL(*client_, CompareAndSwap(
+        storeKey_, strAlloc1, NameSpaceStorageCodec::EncodeID(alloc2)))
+        .WillOnce(Return(EtcdErrCode::EtcdOK));
+    EXPECT_CALL(*client_, CompareAndSwap(
+        storeKey_, strAlloc2, NameSpaceStorageCodec::EncodeID(alloc3)))
+        .WillOnce(Return(EtcdErrCode::EtcdOK));
+
+    common::Thread thread1 = common::Thread(
+        &TestEtcdIdGenerator::GenID1000Times, this);
+    common::Thread thread2 = common::Thread(
+        &TestEtcdIdGenerator::GenID500Times, this);
+    common::Thread thread3 = common::Thread(
+        &TestEtcdIdGenerator::GenID500Times, this);
+    thread1.join();
+    thread2.join();
+    thread3.join();
+
+    // 第三个bundle已经预取或者正在预取
+    uint64_t res;
+    ASSERT_TRUE(etcdIdGen_->GenID(&res));
+    ASSERT_EQ(2001, res);
+}
+
+TEST_F(TestEtcdIdGenerator, test_prefetch_adaptive_bundle) {
+    IdGeneratorOption option;
+    option.enablePrefetch = true;
+    option.maxBundleSize = 10 * bundle_;
+    option.bundleLifeMs = 1000 * 1000;
+    etcdIdGen_ = std::make_shared<EtcdIdGenerator>(
+        client_, storeKey_, initial_, bundle_, option);
+
+    // 第一个bundle很快用完，下一个bundle按分配速率扩大到上限
+    uint64_t alloc1 = initial_ + bundle_;
+    uint64_t alloc2 = alloc1 + 10 * bundle_;
+    std::string strAlloc1 = NameSpaceStorageCodec::EncodeID(alloc1);
+    EXPECT_CALL(*client_, Get(storeKey_, _))
+        .WillOnce(Return(EtcdErrCode::EtcdKeyNotExist))
+        .WillOnce(
+            DoAll(SetArgPointee<1>(strAlloc1), Return(EtcdErrCode::EtcdOK)));
+    EXPECT_CALL(*client_, CompareAndSwap(
+        storeKey_, "", NameSpaceStorageCodec::EncodeID(alloc1)))
+        .WillOnce(Return(EtcdErrCode::EtcdOK));
+    EXPECT_CALL(*client_, CompareAndSwap(
+        storeKey_, strAlloc1, NameSpaceStorageCodec::EncodeID(alloc2)))
+        .WillOnce(Return(EtcdErrCode::EtcdOK));
+
+    uint64_t res;
+    for (uint64_t i = initial_ + 1; i <= 2 * bundle_; i++) {
+        ASSERT_TRUE(etcdIdGen_->GenID(&res));
+        ASSERT_EQ(i, res);
+    }
+}
+
+TEST_F(TestEtcdIdGenerator, test_prefetch_fail) {
+    IdGeneratorOption option;
+    option.enablePrefetch = true;
+    option.maxBundleSize = bundle_;
+    etcdIdGen_ = std::make_shared<EtcdIdGenerator>(
+        client_, storeKey_, initial_, bundle_, option);
+
+    EXPECT_CALL(*client_, Get(storeKey_, _))
+        .WillOnce(Return(EtcdErrCode::EtcdPermissionDenied));
+    uint64_t res;
+    ASSERT_FALSE(etcdIdGen_->GenID(&res));
+}
 }  // namespace mds
 }  // namespace curve
@@ -39,6 +39,8 @@ class MockCleanManager: public CleanManagerInterface {
         std::shared_ptr<AsyncDeleteSnapShotEntity>));
     MOCK_METHOD1(GetTask, std::shared_ptr<Task>(TaskIDType id));
     MOCK_METHOD1(SubmitDeleteCommonFileJob, bool(const FileInfo&));
+    MOCK_METHOD2(CleanSegment, StatusCode(const FileInfo&,
+        const PageFileSegment&));
 };
 
 }  // namespace mds
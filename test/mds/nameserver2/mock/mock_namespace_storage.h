@@ -27,6 +27,7 @@
 #include <gtest/gtest.h>
 #include <vector>
 #include <string>
+#include <map>
 #include "src/mds/nameserver2/namespace_storage.h"
 
 namespace curve {
@@ -84,6 +85,12 @@ class MockNameServerStorage : public NameServerStorage {
         StoreStatus(std::vector<FileInfo> *snapShotFiles));
     MOCK_METHOD2(ListSegment,
         StoreStatus(InodeID, std::vector<PageFileSegment>*));
+    MOCK_METHOD2(PutAllocSize, StoreStatus(InodeID, const AllocatedSize &));
+    MOCK_METHOD1(DeleteAllocSize, StoreStatus(InodeID));
+    MOCK_METHOD1(LoadAllocSize,
+        StoreStatus(std::map<InodeID, AllocatedSize> *));
+    MOCK_METHOD1(PutAllocSizeState, StoreStatus(bool));
+    MOCK_METHOD1(GetAllocSizeState, StoreStatus(bool *));
 };
 
 }  // namespace mds
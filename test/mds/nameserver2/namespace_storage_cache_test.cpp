@@ -24,6 +24,8 @@
 #include <glog/logging.h>
 #include <memory>
 #include <string>
+#include <thread>  //NOLINT
+#include <vector>
 #include "src/mds/nameserver2/namespace_storage_cache.h"
 #include "src/mds/nameserver2/namespace_storage.h"
 #include "src/mds/nameserver2/helper/namespace_helper.h"
@@ -31,6 +33,18 @@
 
 namespace curve {
 namespace mds {
+namespace {
+CacheValue MakeValue(const std::string &name) {
+    auto fileInfo = std::make_shared<FileInfo>();
+    fileInfo->set_filename(name);
+    return fileInfo;
+}
+
+std::string ValueName(const CacheValue &value) {
+    return std::dynamic_pointer_cast<const FileInfo>(value)->filename();
+}
+}  // namespace
+
 TEST(CaCheTest, test_cache_with_capacity_limit) {
     int maxCount = 5;
     std::shared_ptr<LRUCache> cache = std::make_shared<LRUCache>(maxCount);
@@ -38,28 +52,29 @@ TEST(CaCheTest, test_cache_with_capacity_limit) {
     // 1. 测试 put/get
     uint64_t cacheSize = 0;
     for (int i = 1; i <= maxCount + 1; i++) {
-        cache->Put(std::to_string(i), std::to_string(i));
+        std::string key = std::to_string(i);
+        cache->Put(key, MakeValue(key));
+        cacheSize += key.size() + MakeValue(key)->ByteSizeLong();
         if (i <= maxCount) {
-            cacheSize += std::to_string(i).size() * 2;
             ASSERT_EQ(i, cache->GetCacheMetrics()->cacheCount.get_value());
         } else {
-            cacheSize +=
-                std::to_string(i).size() * 2 - std::to_string(1).size() * 2;
-            ASSERT_EQ(
-                cacheSize, cache->GetCacheMetrics()->cacheBytes.get_value());
+            cacheSize -= 1 + MakeValue("1")->ByteSizeLong();
+            ASSERT_EQ(maxCount,
+                cache->GetCacheMetrics()->cacheCount.get_value());
         }
+        ASSERT_EQ(cacheSize, cache->GetCacheMetrics()->cacheBytes.get_value());
 
-        std::string res;
-        ASSERT_TRUE(cache->Get(std::to_string(i), &res));
-        ASSERT_EQ(std::to_string(i), res);
+        CacheValue res;
+        ASSERT_TRUE(cache->Get(key, &res));
+        ASSERT_EQ(key, ValueName(res));
     }
 
     // 2. 第一个元素被剔出
-    std::string res;
+    CacheValue res;
     ASSERT_FALSE(cache->Get(std::to_string(1), &res));
     for (int i = 2; i <= maxCount + 1; i++) {
         ASSERT_TRUE(cache->Get(std::to_string(i), &res));
-        ASSERT_EQ(std::to_string(i), res);
+        ASSERT_EQ(std::to_string(i), ValueName(res));
     }
 
     // 3. 测试删除元素
@@ -68,34 +83,47 @@ TEST(CaCheTest, test_cache_with_capacity_limit) {
     // 删除list中存在的元素
     cache->Remove("2");
     ASSERT_FALSE(cache->Get("2", &res));
-    cacheSize -= std::to_string(2).size() * 2;
+    cacheSize -= 1 + MakeValue("2")->ByteSizeLong();
     ASSERT_EQ(maxCount - 1, cache->GetCacheMetrics()->cacheCount.get_value());
     ASSERT_EQ(cacheSize, cache->GetCacheMetrics()->cacheBytes.get_value());
 
     // 4. 重复put
-    cache->Put("4", "hello");
+    cache->Put("4", MakeValue("hello"));
     ASSERT_TRUE(cache->Get("4", &res));
-    ASSERT_EQ("hello", res);
+    ASSERT_EQ("hello", ValueName(res));
     ASSERT_EQ(maxCount - 1, cache->GetCacheMetrics()->cacheCount.get_value());
-    cacheSize -= std::to_string(4).size() * 2;
-    cacheSize += std::to_string(4).size() + std::string("hello").size();
+    cacheSize -= MakeValue("4")->ByteSizeLong();
+    cacheSize += MakeValue("hello")->ByteSizeLong();
     ASSERT_EQ(cacheSize, cache->GetCacheMetrics()->cacheBytes.get_value());
+
+    // 5. get之后的元素移到队首，put新元素时剔除最久未访问的元素
+    ASSERT_TRUE(cache->Get("3", &res));
+    cache->Put("7", MakeValue("7"));
+    cache->Put("8", MakeValue("8"));
+    ASSERT_TRUE(cache->Get("3", &res));
+    ASSERT_FALSE(cache->Get("5", &res));
+    ASSERT_EQ(maxCount, cache->GetCacheMetrics()->cacheCount.get_value());
 }
 
 TEST(CaCheTest, test_cache_with_capacity_no_limit) {
     std::shared_ptr<LRUCache> cache = std::make_shared<LRUCache>();
 
     // 1. 测试 put/get
-    std::string res;
+    CacheValue res;
     for (int i = 1; i <= 10; i++) {
-        cache->Put(std::to_string(i), std::to_string(i));
+        cache->Put(std::to_string(i), MakeValue(std::to_string(i)));
         ASSERT_TRUE(cache->Get(std::to_string(i), &res));
-        ASSERT_EQ(std::to_string(i), res);
+        ASSERT_EQ(std::to_string(i), ValueName(res));
     }
 
     // 2. 测试元素删除
     cache->Remove("1");
     ASSERT_FALSE(cache->Get("1", &res));
+
+    // 3. 已经取出的value在元素删除之后仍然有效
+    ASSERT_TRUE(cache->Get("2", &res));
+    cache->Remove("2");
+    ASSERT_EQ("2", ValueName(res));
 }
 TEST(CaCheTest, test_cache_with_large_data_capacity_no_limit) {
     uint64_t DefaultChunkSize = 16 * kMB;
@@ -112,25 +140,108 @@ TEST(CaCheTest, test_cache_with_large_data_capacity_no_limit) {
     fileinfo.set_length(10 << 20);
     fileinfo.set_ctime(::curve::common::TimeUtility::GetTimeofDayUs());
     fileinfo.set_seqnum(1);
-    std::string encodeFileInfo;
-    ASSERT_TRUE(fileinfo.SerializeToString(&encodeFileInfo));
     std::string encodeKey =
             NameSpaceStorageCodec::EncodeFileStoreKey(i << 8, filename);
 
     // 1. put/get
-    cache->Put(encodeKey, encodeFileInfo);
-    std::string out;
+    cache->Put(encodeKey, std::make_shared<const FileInfo>(fileinfo));
+    CacheValue out;
     ASSERT_TRUE(cache->Get(encodeKey, &out));
-    FileInfo fileinfoout;
-    ASSERT_TRUE(NameSpaceStorageCodec::DecodeFileInfo(out, &fileinfoout));
-    NameSpaceStorageCodec::DecodeFileInfo(out, &fileinfoout);
-    ASSERT_EQ(filename, fileinfoout.filename());
+    auto fileinfoout = std::dynamic_pointer_cast<const FileInfo>(out);
+    ASSERT_NE(nullptr, fileinfoout);
+    ASSERT_EQ(filename, fileinfoout->filename());
+    ASSERT_EQ(fileinfo.ByteSizeLong(),
+        cache->GetCacheMetrics()->cacheBytes.get_value() - encodeKey.size());
 
     // 2. remove
     cache->Remove(encodeKey);
     ASSERT_FALSE(cache->Get(encodeKey, &out));
 }
 
+TEST(CaCheTest, test_sharded_cache_with_capacity_limit) {
+    // 单个分片时淘汰顺序是确定的
+    int maxCount = 3;
+    ShardedLRUCache cache(maxCount, 1);
+    ASSERT_EQ(1, cache.GetShardNum());
+
+    // 1. 测试 put/get
+    CacheValue res;
+    for (int i = 1; i <= maxCount; i++) {
+        cache.Put(std::to_string(i), MakeValue(std::to_string(i)));
+    }
+    ASSERT_EQ(maxCount, cache.GetCacheMetrics()->cacheCount.get_value());
+    ASSERT_TRUE(cache.Get("1", &res));
+    ASSERT_EQ("1", ValueName(res));
+
+    // 2. 1被访问过，淘汰时移到队首，最早放入且未访问的2被淘汰
+    cache.Put("4", MakeValue("4"));
+    ASSERT_FALSE(cache.Get("2", &res));
+    ASSERT_TRUE(cache.Get("1", &res));
+    ASSERT_TRUE(cache.Get("3", &res));
+    ASSERT_TRUE(cache.Get("4", &res));
+    ASSERT_EQ(maxCount, cache.GetCacheMetrics()->cacheCount.get_value());
+
+    // 3. 全部被访问过时，清除访问标记之后淘汰队尾的元素，
+    //    新放入的元素不会被淘汰
+    cache.Put("5", MakeValue("5"));
+    ASSERT_FALSE(cache.Get("3", &res));
+    ASSERT_TRUE(cache.Get("5", &res));
+    ASSERT_EQ(maxCount, cache.GetCacheMetrics()->cacheCount.get_value());
+
+    // 4. 重复put和删除
+    cache.Put("1", MakeValue("hello"));
+    ASSERT_TRUE(cache.Get("1", &res));
+    ASSERT_EQ("hello", ValueName(res));
+    cache.Remove("1");
+    cache.Remove("1");
+    ASSERT_FALSE(cache.Get("1", &res));
+    ASSERT_EQ(maxCount - 1, cache.GetCacheMetrics()->cacheCount.get_value());
+    uint64_t cacheSize = 2 + MakeValue("4")->ByteSizeLong() +
+        MakeValue("5")->ByteSizeLong();
+    ASSERT_EQ(cacheSize, cache.GetCacheMetrics()->cacheBytes.get_value());
+    ASSERT_EQ(cacheSize, cache.GetShardMetrics(0)->cacheBytes.get_value());
+}
+
+TEST(CaCheTest, test_sharded_cache_concurrent) {
+    int maxCount = 1000;
+    uint32_t shardNum = 8;
+    ShardedLRUCache cache(maxCount, shardNum);
+
+    // 多个线程并发put/get/remove
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&cache, t] {
+            CacheValue res;
+            for (int i = 0; i < 10000; i++) {
+                std::string key = std::to_string((i * 7 + t) % 2000);
+                if (i % 3 == 0) {
+                    cache.Put(key, MakeValue(key));
+                } else if (i % 101 == 0) {
+                    cache.Remove(key);
+                } else if (cache.Get(key, &res)) {
+                    ASSERT_EQ(key, ValueName(res));
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    // 每个分片不超过上限，汇总的metric等于各分片之和
+    uint64_t shardMaxCount = (maxCount + shardNum - 1) / shardNum;
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < shardNum; i++) {
+        auto metrics = cache.GetShardMetrics(i);
+        ASSERT_LE(metrics->cacheCount.get_value(), shardMaxCount);
+        count += metrics->cacheCount.get_value();
+        bytes += metrics->cacheBytes.get_value();
+    }
+    ASSERT_EQ(count, cache.GetCacheMetrics()->cacheCount.get_value());
+    ASSERT_EQ(bytes, cache.GetCacheMetrics()->cacheBytes.get_value());
+}
+
 }  // namespace mds
 }  // namespace curve
 
@@ -187,8 +187,10 @@ TEST_F(TestNameServerStorageImp, test_GetFile) {
     ASSERT_EQ(fileinfo.parentid(), getInfo.parentid());
 
     // 3. get file from cache ok
+    CacheValue cacheFileInfo = std::make_shared<const FileInfo>(fileinfo);
     EXPECT_CALL(*cache_, Get(_, _))
-        .WillOnce(DoAll(SetArgPointee<1>(encodeFileinfo), Return(true)));
+        .WillOnce(DoAll(SetArgPointee<1>(cacheFileInfo), Return(true)));
+    EXPECT_CALL(*client_, Get(_, _)).Times(0);
     ASSERT_EQ(StoreStatus::OK, storage_->GetFile(fileinfo.parentid(),
                                                  fileinfo.filename(),
                                                  &getInfo));
@@ -386,8 +388,10 @@ TEST_F(TestNameServerStorageImp, test_getSegment) {
     ASSERT_EQ(segment.chunks_size(), getSegment.chunks_size());
 
     // 3. get file from cache ok
+    CacheValue cacheSegment = std::make_shared<const PageFileSegment>(segment);
     EXPECT_CALL(*cache_, Get(_, _))
-        .WillOnce(DoAll(SetArgPointee<1>(encodeSegment), Return(true)));
+        .WillOnce(DoAll(SetArgPointee<1>(cacheSegment), Return(true)));
+    EXPECT_CALL(*client_, Get(_, _)).Times(0);
     ASSERT_EQ(StoreStatus::OK, storage_->GetSegment(0, 0, &getSegment));
     ASSERT_EQ(segment.chunksize(), getSegment.chunksize());
     ASSERT_EQ(segment.chunks_size(), getSegment.chunks_size());
@@ -463,6 +463,93 @@ TEST_F(TestTopoAdapterImpl, test_other_functions) {
     }
 }
 
+TEST_F(TestTopoAdapterImpl, test_snapshot) {
+    using ::curve::mds::topology::LogicalPoolSnapshot;
+    auto topoAdapter = std::make_shared<TopoAdapterImpl>(
+        mockTopo_, mockTopoManager_, mockTopoStat_, true);
+
+    // 逻辑池1可用，逻辑池2不可用，chunkserver4已经retired，chunkserver5 offline
+    std::vector<LogicalPoolSnapshot> pools(2);
+    pools[0].id = 1;
+    pools[0].physicalPoolId = 1;
+    pools[0].available = true;
+    pools[1].id = 2;
+    pools[1].physicalPoolId = 2;
+    std::vector<ChunkServerSnapshot> chunkServers(5);
+    for (int i = 0; i < 5; i++) {
+        chunkServers[i].id = i + 1;
+        chunkServers[i].serverId = i + 1;
+        chunkServers[i].zoneId = i + 1;
+        chunkServers[i].physicalPoolId = i < 4 ? 1 : 2;
+        chunkServers[i].hostIp = "127.0.0.1";
+        chunkServers[i].port = 8200 + i;
+        chunkServers[i].onlineState = OnlineState::ONLINE;
+    }
+    chunkServers[3].status = ChunkServerStatus::RETIRED;
+    chunkServers[4].onlineState = OnlineState::OFFLINE;
+    std::vector<CopySetSnapshot> copySets(3);
+    copySets[0].key = CopySetKey(1, 1);
+    copySets[0].epoch = 2;
+    copySets[0].leader = 1;
+    copySets[0].members = {1, 2, 3};
+    copySets[0].candidate = 4;
+    copySets[1].key = CopySetKey(1, 2);
+    copySets[1].leader = 1;
+    copySets[1].members = {1, 2, 5};
+    copySets[2].key = CopySetKey(2, 1);
+    copySets[2].members = {1, 3, 5};
+    auto snapshot = std::make_shared<const TopologySnapshot>(1,
+        std::move(pools), std::move(chunkServers), std::move(copySets));
+    EXPECT_CALL(*mockTopo_, GetSnapshot()).WillRepeatedly(Return(snapshot));
+    EXPECT_CALL(*mockTopo_, GetCopySet(_, _)).Times(0);
+    EXPECT_CALL(*mockTopoStat_, GetChunkServerStat(_, _)).Times(0);
+    // 磁盘容量和使用量不在快照中，从topology中读取
+    ::curve::mds::topology::ChunkServer chunkServer;
+    ChunkServerState diskState;
+    diskState.SetDiskCapacity(2048);
+    diskState.SetDiskUsed(1024);
+    chunkServer.SetChunkServerState(diskState);
+    EXPECT_CALL(*mockTopo_, GetChunkServer(_, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(chunkServer), Return(true)));
+
+    CopySetInfo info;
+    ASSERT_TRUE(topoAdapter->GetCopySetInfo(CopySetKey(1, 1), &info));
+    ASSERT_EQ(2, info.epoch);
+    ASSERT_EQ(1, info.leader);
+    ASSERT_EQ(3, info.peers.size());
+    ASSERT_EQ(8201, info.peers[1].port);
+    ASSERT_EQ(4, info.candidatePeerInfo.id);
+    ASSERT_TRUE(info.logicalPoolWork);
+    ASSERT_FALSE(topoAdapter->GetCopySetInfo(CopySetKey(1, 3), &info));
+
+    // 不可用的逻辑池中的copyset不返回
+    ASSERT_EQ(2, topoAdapter->GetCopySetInfos().size());
+    ASSERT_EQ(2, topoAdapter->GetCopySetInfosInChunkServer(1).size());
+    ASSERT_EQ(1, topoAdapter->GetCopySetInfosInChunkServer(3).size());
+    ASSERT_EQ(0, topoAdapter->GetCopySetInfosInChunkServer(6).size());
+    ASSERT_EQ(2, topoAdapter->GetCopySetInfosInLogicalPool(1).size());
+    ASSERT_EQ(0, topoAdapter->GetCopySetInfosInLogicalPool(3).size());
+
+    // retired的chunkserver不返回，leader数量从快照中获取
+    ChunkServerInfo csInfo;
+    ASSERT_TRUE(topoAdapter->GetChunkServerInfo(1, &csInfo));
+    ASSERT_EQ(2, csInfo.leaderCount);
+    ASSERT_EQ(1, csInfo.info.zoneId);
+    ASSERT_EQ(2048, csInfo.diskCapacity);
+    ASSERT_EQ(1024, csInfo.diskUsed);
+    ASSERT_FALSE(topoAdapter->GetChunkServerInfo(6, &csInfo));
+    ASSERT_EQ(4, topoAdapter->GetChunkServerInfos().size());
+    ASSERT_EQ(3, topoAdapter->GetChunkServersInLogicalPool(1).size());
+    ASSERT_EQ(1, topoAdapter->GetChunkServersInLogicalPool(2).size());
+
+    // offline的chunkserver不计入scatter-width map
+    std::map<ChunkServerIdType, int> scatterMap;
+    topoAdapter->GetChunkServerScatterMap(1, &scatterMap);
+    ASSERT_EQ(2, scatterMap.size());
+    ASSERT_EQ(2, scatterMap[2]);
+    ASSERT_EQ(2, scatterMap[3]);
+}
+
 TEST(TestCopySetInfo, test_copySetInfo_function) {
     auto testcopySetInfo = GetCopySetInfoForTest();
 
@@ -22,6 +22,8 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>  // NOLINT
+
 #include "test/mds/topology/mock_topology.h"
 #include "src/mds/topology/topology.h"
 #include "src/mds/topology/topology_item.h"
@@ -1789,6 +1791,44 @@ TEST_F(TestTopology, FindChunkServerNotRetired_ChunkServerNotFound) {
               UNINTIALIZE_ID), ret);
 }
 
+TEST_F(TestTopology, FindChunkServerNotRetired_ByEndpointIndex) {
+    ServerIdType serverId = 0x31;
+    uint32_t port = 1024;
+
+    PrepareAddPhysicalPool();
+    PrepareAddZone();
+    PrepareAddServer(serverId, "host1", "ip1", 0, "ip2", 0);
+    PrepareAddChunkServer(0x41, "token", "ssd", serverId, "ip1", port);
+
+    ASSERT_EQ(0x41, topology_->FindChunkServerNotRetired("ip1", port));
+    // server的外部地址不在索引中，通过遍历server查找
+    ASSERT_EQ(0x41, topology_->FindChunkServerNotRetired("ip2", port));
+    ASSERT_EQ(static_cast<ChunkServerIdType>(UNINTIALIZE_ID),
+        topology_->FindChunkServerNotRetired("ip1", port + 1));
+
+    // 旧chunkserver退役后，在同一个地址上注册新的chunkserver
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->UpdateChunkServerRwState(
+        ChunkServerStatus::RETIRED, 0x41));
+    ASSERT_EQ(static_cast<ChunkServerIdType>(UNINTIALIZE_ID),
+        topology_->FindChunkServerNotRetired("ip1", port));
+    PrepareAddChunkServer(0x42, "token", "ssd", serverId, "ip1", port);
+    ASSERT_EQ(0x42, topology_->FindChunkServerNotRetired("ip1", port));
+
+    // chunkserver的地址变化
+    ChunkServer cs(0x42, "token", "ssd", serverId, "ip1", port + 1, "/");
+    EXPECT_CALL(*storage_, UpdateChunkServer(_))
+        .WillOnce(Return(true));
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->UpdateChunkServerTopo(cs));
+    ASSERT_EQ(0x42, topology_->FindChunkServerNotRetired("ip1", port + 1));
+    ASSERT_EQ(static_cast<ChunkServerIdType>(UNINTIALIZE_ID),
+        topology_->FindChunkServerNotRetired("ip1", port));
+
+    EXPECT_CALL(*storage_, DeleteChunkServer(_))
+        .WillOnce(Return(true));
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->RemoveChunkServer(0x41));
+    ASSERT_EQ(0x42, topology_->FindChunkServerNotRetired("ip1", port + 1));
+}
+
 TEST_F(TestTopology, GetLogicalPool_success) {
     PoolIdType physicalPoolId = 0x11;
     PrepareAddPhysicalPool(physicalPoolId);
@@ -2460,6 +2500,75 @@ TEST_F(TestTopology, UpdateCopySetTopo_success) {
     topology_->Stop();
 }
 
+TEST_F(TestTopology, BatchUpdateCopySetTopo_success) {
+    PoolIdType logicalPoolId = 0x01;
+    PoolIdType physicalPoolId = 0x11;
+
+    PrepareAddPhysicalPool(physicalPoolId);
+    PrepareAddZone(0x21, "zone1", physicalPoolId);
+    PrepareAddZone(0x22, "zone2", physicalPoolId);
+    PrepareAddZone(0x23, "zone3", physicalPoolId);
+    PrepareAddServer(
+        0x31, "server1", "127.0.0.1" , 0, "127.0.0.1" , 0, 0x21, 0x11);
+    PrepareAddServer(
+        0x32, "server2", "127.0.0.1" , 0, "127.0.0.1" , 0, 0x22, 0x11);
+    PrepareAddServer(
+        0x33, "server3", "127.0.0.1" , 0, "127.0.0.1" , 0, 0x23, 0x11);
+    PrepareAddChunkServer(0x41, "token1", "nvme", 0x31, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x42, "token2", "nvme", 0x32, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x43, "token3", "nvme", 0x33, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x44, "token4", "nvme", 0x33, "127.0.0.1", 8201);
+    PrepareAddLogicalPool(logicalPoolId, "logicalPool1", physicalPoolId);
+    std::set<ChunkServerIdType> replicas = {0x41, 0x42, 0x43};
+    PrepareAddCopySet(0x51, logicalPoolId, replicas);
+    PrepareAddCopySet(0x52, logicalPoolId, replicas);
+
+    std::vector<CopySetInfo> datas;
+    CopySetInfo csInfo1(logicalPoolId, 0x51);
+    csInfo1.SetEpoch(2);
+    csInfo1.SetLeader(0x42);
+    csInfo1.SetCopySetMembers({0x41, 0x42, 0x44});
+    datas.push_back(csInfo1);
+    CopySetInfo csInfo2(logicalPoolId, 0x52);
+    csInfo2.SetEpoch(3);
+    csInfo2.SetLeader(0x43);
+    csInfo2.SetCopySetMembers(replicas);
+    datas.push_back(csInfo2);
+    // 不存在的copyset不影响其他copyset的更新
+    datas.emplace_back(logicalPoolId, 0x53);
+
+    ASSERT_EQ(kTopoErrCodeCopySetNotFound,
+        topology_->BatchUpdateCopySetTopo(datas));
+
+    CopySetInfo out;
+    ASSERT_TRUE(topology_->GetCopySet(CopySetKey(logicalPoolId, 0x51), &out));
+    ASSERT_EQ(2, out.GetEpoch());
+    ASSERT_EQ(0x42, out.GetLeader());
+    ASSERT_EQ(csInfo1.GetCopySetMembers(), out.GetCopySetMembers());
+    ASSERT_TRUE(topology_->GetCopySet(CopySetKey(logicalPoolId, 0x52), &out));
+    ASSERT_EQ(3, out.GetEpoch());
+    ASSERT_EQ(0x43, out.GetLeader());
+
+    // chunkserver上的copyset索引同步更新
+    ASSERT_EQ(1, topology_->GetCopySetsInChunkServer(0x43).size());
+    ASSERT_EQ(1, topology_->GetCopySetsInChunkServer(0x44).size());
+
+    datas.pop_back();
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->BatchUpdateCopySetTopo(datas));
+
+    // epoch小于当前记录的数据不更新
+    CopySetInfo stale(logicalPoolId, 0x51);
+    stale.SetEpoch(1);
+    stale.SetLeader(0x41);
+    stale.SetCopySetMembers(replicas);
+    ASSERT_EQ(kTopoErrCodeSuccess,
+        topology_->BatchUpdateCopySetTopo({stale}));
+    ASSERT_TRUE(topology_->GetCopySet(CopySetKey(logicalPoolId, 0x51), &out));
+    ASSERT_EQ(2, out.GetEpoch());
+    ASSERT_EQ(0x42, out.GetLeader());
+    ASSERT_EQ(csInfo1.GetCopySetMembers(), out.GetCopySetMembers());
+}
+
 TEST_F(TestTopology, UpdateCopySetTopo_CopySetNotFound) {
     PoolIdType logicalPoolId = 0x01;
     PoolIdType physicalPoolId = 0x11;
@@ -2655,6 +2764,196 @@ TEST_F(TestTopology, GetCopySetsInChunkServer_success) {
     ASSERT_EQ(1, csList.size());
 }
 
+TEST_F(TestTopology, GetCopySetsInChunkServer_indexUpdate) {
+    PoolIdType logicalPoolId = 0x01;
+    PoolIdType physicalPoolId = 0x11;
+
+    PrepareAddPhysicalPool(physicalPoolId);
+    PrepareAddLogicalPool(logicalPoolId, "logicalPool1", physicalPoolId);
+    PrepareAddLogicalPool(0x02, "logicalPool2", physicalPoolId);
+    PrepareAddCopySet(0x51, logicalPoolId, {0x41, 0x42, 0x43});
+    PrepareAddCopySet(0x52, logicalPoolId, {0x41, 0x42, 0x44});
+    PrepareAddCopySet(0x51, 0x02, {0x42, 0x43, 0x44});
+
+    ASSERT_EQ(2, topology_->GetCopySetsInChunkServer(0x41).size());
+    ASSERT_EQ(3, topology_->GetCopySetsInChunkServer(0x42).size());
+    ASSERT_EQ(0, topology_->GetCopySetsInChunkServer(0x45).size());
+    ASSERT_EQ(2, topology_->GetCopySetsInLogicalPool(logicalPoolId).size());
+    ASSERT_EQ(1, topology_->GetCopySetInfosInLogicalPool(0x02).size());
+
+    // 成员变化后索引随之更新
+    CopySetInfo csInfo(logicalPoolId, 0x51);
+    csInfo.SetCopySetMembers({0x42, 0x43, 0x45});
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->UpdateCopySetTopo(csInfo));
+    std::vector<CopySetKey> csList =
+        topology_->GetCopySetsInChunkServer(0x41);
+    ASSERT_EQ(1, csList.size());
+    ASSERT_EQ(CopySetKey(logicalPoolId, 0x52), csList[0]);
+    csList = topology_->GetCopySetsInChunkServer(0x45);
+    ASSERT_EQ(1, csList.size());
+    ASSERT_EQ(CopySetKey(logicalPoolId, 0x51), csList[0]);
+
+    // filter对索引中的copyset生效
+    csList = topology_->GetCopySetsInChunkServer(0x42,
+        [](const CopySetInfo &info) {
+            return info.GetLogicalPoolId() == 0x02;
+        });
+    ASSERT_EQ(1, csList.size());
+    ASSERT_EQ(CopySetKey(0x02, 0x51), csList[0]);
+
+    // 删除copyset后从索引中移除
+    EXPECT_CALL(*storage_, DeleteCopySet(_))
+        .WillOnce(Return(true));
+    ASSERT_EQ(kTopoErrCodeSuccess,
+        topology_->RemoveCopySet(CopySetKey(logicalPoolId, 0x52)));
+    ASSERT_EQ(0, topology_->GetCopySetsInChunkServer(0x41).size());
+    ASSERT_EQ(2, topology_->GetCopySetsInChunkServer(0x42).size());
+    std::vector<CopySetIdType> idList =
+        topology_->GetCopySetsInLogicalPool(logicalPoolId);
+    ASSERT_EQ(1, idList.size());
+    ASSERT_EQ(0x51, idList[0]);
+}
+
+TEST_F(TestTopology, GetCopySetsInChunkServer_largeCluster) {
+    const uint32_t kChunkServerNum = 1000;
+    const uint32_t kCopySetNum = 100000;
+    const uint32_t kReplicaNum = 3;
+
+    std::vector<ClusterInformation> infos;
+    infos.push_back(ClusterInformation("uuid1"));
+    EXPECT_CALL(*storage_, LoadClusterInfo(_))
+        .WillOnce(DoAll(SetArgPointee<0>(infos),
+                Return(true)));
+
+    std::unordered_map<PoolIdType, LogicalPool> logicalPoolMap;
+    std::unordered_map<PoolIdType, PhysicalPool> physicalPoolMap;
+    std::unordered_map<ZoneIdType, Zone> zoneMap;
+    std::unordered_map<ServerIdType, Server> serverMap;
+    std::unordered_map<ChunkServerIdType, ChunkServer> chunkServerMap;
+    std::map<CopySetKey, CopySetInfo> copySetMap;
+
+    logicalPoolMap[0x01] = LogicalPool(0x01, "lpool1", 0x11, PAGEFILE,
+        LogicalPool::RedundanceAndPlaceMentPolicy(),
+        LogicalPool::UserPolicy(),
+        0, true);
+    for (CopySetIdType id = 1; id <= kCopySetNum; id++) {
+        std::set<ChunkServerIdType> members;
+        for (uint32_t i = 0; i < kReplicaNum; i++) {
+            members.insert((id * kReplicaNum + i) % kChunkServerNum + 1);
+        }
+        CopySetInfo info(0x01, id);
+        info.SetCopySetMembers(members);
+        copySetMap[CopySetKey(0x01, id)] = info;
+    }
+
+    EXPECT_CALL(*storage_, LoadLogicalPool(_, _))
+        .WillOnce(DoAll(SetArgPointee<0>(logicalPoolMap),
+                    Return(true)));
+    EXPECT_CALL(*storage_, LoadPhysicalPool(_, _))
+        .WillOnce(DoAll(SetArgPointee<0>(physicalPoolMap),
+                    Return(true)));
+    EXPECT_CALL(*storage_, LoadZone(_, _))
+        .WillOnce(DoAll(SetArgPointee<0>(zoneMap),
+                    Return(true)));
+    EXPECT_CALL(*storage_, LoadServer(_, _))
+        .WillOnce(DoAll(SetArgPointee<0>(serverMap),
+                    Return(true)));
+    EXPECT_CALL(*storage_, LoadChunkServer(_, _))
+        .WillOnce(DoAll(SetArgPointee<0>(chunkServerMap),
+                    Return(true)));
+    EXPECT_CALL(*storage_, LoadCopySet(_, _))
+        .WillOnce(DoAll(SetArgPointee<0>(copySetMap),
+                    Return(true)));
+
+    EXPECT_CALL(*idGenerator_, initLogicalPoolIdGenerator(_));
+    EXPECT_CALL(*idGenerator_, initPhysicalPoolIdGenerator(_));
+    EXPECT_CALL(*idGenerator_, initZoneIdGenerator(_));
+    EXPECT_CALL(*idGenerator_, initServerIdGenerator(_));
+    EXPECT_CALL(*idGenerator_, initChunkServerIdGenerator(_));
+    EXPECT_CALL(*idGenerator_, initCopySetIdGenerator(_));
+
+    TopologyOption option;
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->Init(option));
+
+    // 调度一轮中每个chunkserver查询一次
+    auto start = std::chrono::steady_clock::now();
+    uint64_t total = 0;
+    for (ChunkServerIdType csId = 1; csId <= kChunkServerNum; csId++) {
+        std::vector<CopySetKey> csList =
+            topology_->GetCopySetsInChunkServer(csId);
+        ASSERT_EQ(kCopySetNum * kReplicaNum / kChunkServerNum,
+                  csList.size());
+        total += csList.size();
+    }
+    auto end = std::chrono::steady_clock::now();
+    ASSERT_EQ(kCopySetNum * kReplicaNum, total);
+    LOG(INFO) << "GetCopySetsInChunkServer for " << kChunkServerNum
+              << " chunkservers with " << kCopySetNum << " copysets cost "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(
+                    end - start).count() << " ms";
+
+    start = std::chrono::steady_clock::now();
+    ASSERT_EQ(kCopySetNum,
+              topology_->GetCopySetInfosInLogicalPool(0x01).size());
+    end = std::chrono::steady_clock::now();
+    LOG(INFO) << "GetCopySetInfosInLogicalPool with " << kCopySetNum
+              << " copysets cost "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(
+                    end - start).count() << " ms";
+}
+
+TEST_F(TestTopology, GetSnapshot_success) {
+    PoolIdType logicalPoolId = 0x01;
+    PoolIdType physicalPoolId = 0x11;
+    PrepareAddPhysicalPool(physicalPoolId);
+    PrepareAddZone(0x21, "zone1", physicalPoolId);
+    PrepareAddServer(0x31, "server1", "127.0.0.1", 0, "127.0.0.1", 0,
+        0x21, physicalPoolId);
+    PrepareAddChunkServer(0x41, "token1", "nvme", 0x31, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x42, "token2", "nvme", 0x31, "127.0.0.1", 8201);
+    PrepareAddChunkServer(0x43, "token3", "nvme", 0x31, "127.0.0.1", 8202);
+    PrepareAddLogicalPool(logicalPoolId, "logicalPool1", physicalPoolId);
+    PrepareAddCopySet(0x51, logicalPoolId, {0x41, 0x42, 0x43});
+
+    auto snapshot = topology_->GetSnapshot();
+    ASSERT_EQ(3, snapshot->GetChunkServers().size());
+    ASSERT_EQ(1, snapshot->GetCopySets().size());
+    const ChunkServerSnapshot *cs = snapshot->FindChunkServer(0x42);
+    ASSERT_NE(nullptr, cs);
+    ASSERT_EQ(0x21, cs->zoneId);
+    ASSERT_EQ(physicalPoolId, cs->physicalPoolId);
+    ASSERT_EQ(8201, cs->port);
+    ASSERT_EQ(2, cs->scatterWidth);
+    ASSERT_TRUE(snapshot->GetCopySets()[0].logicalPoolAvailable);
+
+    // 没有变化时返回同一个快照
+    ASSERT_EQ(snapshot, topology_->GetSnapshot());
+
+    // 只有磁盘容量变化时不重建快照
+    ChunkServerState state;
+    state.SetDiskState(DISKNORMAL);
+    state.SetDiskCapacity(2048);
+    ASSERT_EQ(kTopoErrCodeSuccess,
+        topology_->UpdateChunkServerDiskStatus(state, 0x41));
+    ASSERT_EQ(snapshot, topology_->GetSnapshot());
+
+    // leader变化后重建快照，旧快照的内容不变
+    CopySetInfo csInfo(logicalPoolId, 0x51);
+    csInfo.SetLeader(0x42);
+    csInfo.SetCopySetMembers({0x41, 0x42, 0x43});
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->UpdateCopySetTopo(csInfo));
+    auto newSnapshot = topology_->GetSnapshot();
+    ASSERT_NE(snapshot, newSnapshot);
+    ASSERT_GT(newSnapshot->GetVersion(), snapshot->GetVersion());
+    ASSERT_EQ(1, newSnapshot->FindChunkServer(0x42)->leaderCount);
+    ASSERT_EQ(0, snapshot->FindChunkServer(0x42)->leaderCount);
+
+    ASSERT_EQ(kTopoErrCodeSuccess,
+        topology_->UpdateChunkServerOnlineState(OnlineState::ONLINE, 0x43));
+    ASSERT_EQ(OnlineState::ONLINE,
+        topology_->GetSnapshot()->FindChunkServer(0x43)->onlineState);
+}
+
 
 
 
@@ -401,6 +401,55 @@ TEST_F(TestTopologyMetric,  TestUpdateTopologyMetricsCleanRetired) {
     ASSERT_EQ(1, gLogicalPoolMetrics.size());
 }
 
+TEST_F(TestTopologyMetric,  TestUpdateTopologyMetricsWithSnapshot) {
+    PoolIdType logicalPoolId = 0x01;
+    PoolIdType physicalPoolId = 0x11;
+
+    PrepareAddPhysicalPool(physicalPoolId);
+    PrepareAddZone(0x21, "zone1", physicalPoolId);
+    PrepareAddServer(0x31, "server1", "127.0.0.1", "127.0.0.1", 0x21, 0x11);
+    PrepareAddChunkServer(0x41, "token1", "nvme", 0x31, "127.0.0.1", 8888);
+    PrepareAddChunkServer(0x42, "token2", "nvme", 0x31, "127.0.0.1", 8889);
+    PrepareAddChunkServer(0x43, "token3", "nvme", 0x31, "127.0.0.1", 8890);
+    PrepareAddChunkServer(0x44, "token4", "nvme", 0x31, "127.0.0.1", 8891);
+
+    LogicalPool::RedundanceAndPlaceMentPolicy rap;
+    rap.pageFileRAP.replicaNum = 3;
+    PrepareAddLogicalPool(logicalPoolId, "logicalPool1", physicalPoolId,
+        PAGEFILE, rap);
+    PrepareAddCopySet(0x51, logicalPoolId, {0x41, 0x42, 0x43});
+    PrepareAddCopySet(0x52, logicalPoolId, {0x41, 0x43, 0x44});
+    CopySetInfo cs(logicalPoolId, 0x52);
+    cs.SetLeader(0x41);
+    cs.SetCopySetMembers({0x41, 0x43, 0x44});
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->UpdateCopySetTopo(cs));
+
+    EXPECT_CALL(*topologyStat_, GetChunkServerStat(_, _))
+        .WillRepeatedly(Return(false));
+    EXPECT_CALL(*allocStatistic_, GetAllocByLogicalPool(_, _))
+        .WillOnce(Return(true));
+
+    // 使用快照计算的结果与按copyset计算的一致
+    TopologyOption option;
+    option.enableSnapshot = true;
+    ASSERT_EQ(0, testObj_->Init(option));
+    testObj_->UpdateTopologyMetrics();
+
+    ASSERT_EQ(4, gChunkServerMetrics.size());
+    ASSERT_EQ(3, gChunkServerMetrics[0x41]->scatterWidth.get_value());
+    ASSERT_EQ(2, gChunkServerMetrics[0x41]->copysetNum.get_value());
+    ASSERT_EQ(1, gChunkServerMetrics[0x41]->leaderNum.get_value());
+    ASSERT_EQ(2, gChunkServerMetrics[0x42]->scatterWidth.get_value());
+    ASSERT_EQ(1, gChunkServerMetrics[0x42]->copysetNum.get_value());
+    ASSERT_EQ(0, gChunkServerMetrics[0x42]->leaderNum.get_value());
+
+    ASSERT_EQ(1, gLogicalPoolMetrics.size());
+    ASSERT_EQ(4, gLogicalPoolMetrics[logicalPoolId]->chunkServerNum.get_value()); //NOLINT
+    ASSERT_EQ(2, gLogicalPoolMetrics[logicalPoolId]->copysetNum.get_value()); //NOLINT
+    ASSERT_EQ(2, gLogicalPoolMetrics[logicalPoolId]->copysetNumMax.get_value()); //NOLINT
+    ASSERT_EQ(1, gLogicalPoolMetrics[logicalPoolId]->leaderNumMax.get_value()); //NOLINT
+}
+
 
 }  // namespace topology
 }  // namespace mds
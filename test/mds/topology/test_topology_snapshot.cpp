@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "src/mds/topology/topology_snapshot.h"
+
+namespace curve {
+namespace mds {
+namespace topology {
+
+namespace {
+LogicalPoolSnapshot MakePool(PoolIdType id, PoolIdType physicalPoolId,
+    bool available) {
+    LogicalPoolSnapshot pool;
+    pool.id = id;
+    pool.physicalPoolId = physicalPoolId;
+    pool.available = available;
+    return pool;
+}
+
+ChunkServerSnapshot MakeChunkServer(ChunkServerIdType id,
+    PoolIdType physicalPoolId) {
+    ChunkServerSnapshot cs;
+    cs.id = id;
+    cs.serverId = id;
+    cs.zoneId = id;
+    cs.physicalPoolId = physicalPoolId;
+    return cs;
+}
+
+CopySetSnapshot MakeCopySet(PoolIdType pid, CopySetIdType id,
+    ChunkServerIdType leader,
+    const std::vector<ChunkServerIdType> &members) {
+    CopySetSnapshot copySet;
+    copySet.key = CopySetKey(pid, id);
+    copySet.leader = leader;
+    copySet.members = members;
+    return copySet;
+}
+}  // namespace
+
+TEST(TestTopologySnapshot, BuildIndex) {
+    // 逻辑池1在物理池1上，chunkserver 1~4；逻辑池2在物理池2上，chunkserver 5~6
+    // 输入乱序，构建后按id排序
+    TopologySnapshot snapshot(7,
+        {MakePool(2, 2, false), MakePool(1, 1, true)},
+        {MakeChunkServer(4, 1), MakeChunkServer(1, 1), MakeChunkServer(3, 1),
+         MakeChunkServer(6, 2), MakeChunkServer(2, 1), MakeChunkServer(5, 2)},
+        {MakeCopySet(2, 1, 5, {5, 6}), MakeCopySet(1, 3, 2, {2, 3, 4}),
+         MakeCopySet(1, 1, 1, {1, 2, 3}), MakeCopySet(1, 2, 1, {1, 3, 4}),
+         MakeCopySet(1, 4, 0, {1, 2, 10})});
+    ASSERT_EQ(7, snapshot.GetVersion());
+
+    const auto &copySets = snapshot.GetCopySets();
+    ASSERT_EQ(5, copySets.size());
+    for (uint32_t i = 0; i < 4; ++i) {
+        ASSERT_EQ(CopySetKey(1, i + 1), copySets[i].key);
+        ASSERT_TRUE(copySets[i].logicalPoolAvailable);
+    }
+    ASSERT_EQ(CopySetKey(2, 1), copySets[4].key);
+    ASSERT_FALSE(copySets[4].logicalPoolAvailable);
+
+    const LogicalPoolSnapshot *pool = snapshot.FindLogicalPool(1);
+    ASSERT_NE(nullptr, pool);
+    ASSERT_EQ(0, pool->copySetBegin);
+    ASSERT_EQ(4, pool->copySetEnd);
+    ASSERT_EQ(4, pool->chunkServers.size());
+    pool = snapshot.FindLogicalPool(2);
+    ASSERT_NE(nullptr, pool);
+    ASSERT_EQ(4, pool->copySetBegin);
+    ASSERT_EQ(5, pool->copySetEnd);
+    ASSERT_EQ(std::vector<uint32_t>({4, 5}), pool->chunkServers);
+    ASSERT_EQ(nullptr, snapshot.FindLogicalPool(3));
+
+    // chunkserver 1上有copyset (1,1) (1,2) (1,4)，其他副本在2、3、4上，
+    // 不在快照中的chunkserver 10也计入scatter-width
+    const ChunkServerSnapshot *cs = snapshot.FindChunkServer(1);
+    ASSERT_NE(nullptr, cs);
+    ASSERT_EQ(std::vector<uint32_t>({0, 1, 3}), cs->copySets);
+    ASSERT_EQ(2, cs->leaderCount);
+    ASSERT_EQ(4, cs->scatterWidth);
+
+    cs = snapshot.FindChunkServer(4);
+    ASSERT_NE(nullptr, cs);
+    ASSERT_EQ(std::vector<uint32_t>({1, 2}), cs->copySets);
+    ASSERT_EQ(0, cs->leaderCount);
+    ASSERT_EQ(3, cs->scatterWidth);
+
+    cs = snapshot.FindChunkServer(5);
+    ASSERT_NE(nullptr, cs);
+    ASSERT_EQ(1, cs->leaderCount);
+    ASSERT_EQ(1, cs->scatterWidth);
+    ASSERT_EQ(nullptr, snapshot.FindChunkServer(10));
+
+    ASSERT_EQ(nullptr, snapshot.FindCopySet(CopySetKey(1, 5)));
+    const CopySetSnapshot *copySet = snapshot.FindCopySet(CopySetKey(1, 3));
+    ASSERT_NE(nullptr, copySet);
+    ASSERT_EQ(2, copySet->leader);
+}
+
+TEST(TestTopologySnapshot, Empty) {
+    TopologySnapshot snapshot(0, {}, {}, {});
+    ASSERT_TRUE(snapshot.GetCopySets().empty());
+    ASSERT_EQ(nullptr, snapshot.FindLogicalPool(1));
+    ASSERT_EQ(nullptr, snapshot.FindChunkServer(1));
+    ASSERT_EQ(nullptr, snapshot.FindCopySet(CopySetKey(1, 1)));
+}
+
+}  // namespace topology
+}  // namespace mds
+}  // namespace curve